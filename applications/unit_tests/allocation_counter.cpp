@@ -0,0 +1,47 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<legion::core::size_type> allocationCount = { 0 };
+    std::atomic<legion::core::size_type> activeScopes = { 0 };
+}
+
+allocation_counting_scope::allocation_counting_scope()
+{
+    activeScopes.fetch_add(1, std::memory_order_relaxed);
+}
+
+allocation_counting_scope::~allocation_counting_scope()
+{
+    activeScopes.fetch_sub(1, std::memory_order_relaxed);
+}
+
+legion::core::size_type allocation_counting_scope::count() noexcept
+{
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+// the global allocation functions can only be replaced once per program, the array and nothrow versions call these
+void* operator new(std::size_t size)
+{
+    if (activeScopes.load(std::memory_order_relaxed) != 0)
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <core/types/primitives.hpp>
+
+// Counts the heap allocations of every thread for the benchmarks. This needs the global operator new to be replaced,
+// which is done once in allocation_counter.cpp. Allocations are only counted while an allocation_counting_scope exists,
+// outside of one the replacement only forwards to malloc.
+
+/**@class allocation_counting_scope
+ * @brief Counts the allocations made through operator new on any thread for as long as it lives.
+ */
+class allocation_counting_scope
+{
+public:
+    allocation_counting_scope();
+    ~allocation_counting_scope();
+
+    allocation_counting_scope(const allocation_counting_scope&) = delete;
+    allocation_counting_scope& operator=(const allocation_counting_scope&) = delete;
+
+    /**@brief Number of allocations counted so far, by this scope and the ones before it.
+     *        Take the difference of two calls to get the allocations in between.
+     */
+    static legion::core::size_type count() noexcept;
+};
@@ -0,0 +1,100 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/util/instance_batcher.hpp>
+
+#include <random>
+
+#include "allocation_counter.hpp"
+
+// Run the unit tests with --batching-benchmark[=<instances>] to time the instance batching of the renderer on synthetic
+// renderables instead of only running the tests. Uses 100000 instances when no count is given.
+
+class BatchingBenchmarkModule : public legion::core::Module {
+public:
+    BatchingBenchmarkModule(legion::core::size_type instanceCount) : m_instanceCount(instanceCount) {}
+
+    void setup() override
+    {
+        reportSystem<BatchingBenchmarkSystem>(m_instanceCount);
+    }
+
+    legion::core::priority_type priority() override { return PRIORITY_MAX; };
+
+    class BatchingBenchmarkSystem : public legion::core::System<BatchingBenchmarkSystem>
+    {
+        legion::core::size_type m_instanceCount;
+        bool m_hasRun = false;
+
+    public:
+        BatchingBenchmarkSystem(legion::core::size_type instanceCount) : m_instanceCount(instanceCount) {}
+
+        void setup() override
+        {
+            createProcess<&BatchingBenchmarkSystem::update>("Update");
+        }
+
+        void update(legion::core::time::time_span<legion::core::fast_time>)
+        {
+            using namespace legion;
+            if (m_hasRun)
+                return;
+            m_hasRun = true;
+
+            constexpr size_type frameCount = 100;
+            constexpr size_type materialCount = 32;
+            constexpr size_type modelCount = 256;
+
+            //renderables in random order with random materials and models, about a tenth of them culled
+            std::mt19937 generator(12345);
+            std::vector<math::mat4> worldMatrices(m_instanceCount);
+            std::vector<rendering::batch_instance> renderables(m_instanceCount);
+            for (size_type i = 0; i < m_instanceCount; i++)
+            {
+                worldMatrices[i] = math::translate(math::mat4(1.f), math::vec3(static_cast<float>(i), 0.f, 0.f));
+                renderables[i] = rendering::batch_instance{ generator() % 10 != 0, id_type(1 + generator() % materialCount),
+                    id_type(1 + materialCount + generator() % modelCount), static_cast<float>(generator() % 1000) / 1000.f };
+            }
+
+            auto runJobs = async::job_runner(*m_scheduler);
+
+            //stands in for the mapped instance buffer of the renderer
+            std::vector<math::mat4> instances(m_instanceCount);
+            auto allocate = [&](size_type, size_type& firstInstance)
+            {
+                firstInstance = 0;
+                return instances.data();
+            };
+
+            rendering::InstanceBatcher batcher;
+            rendering::instance_batches batches;
+
+            //the first frame grows all the buffers and is not counted
+            batcher.build(m_instanceCount, worldMatrices.data(), [&](size_type i) { return renderables[i]; }, allocate, runJobs, batches);
+
+            time64 totalTime = 0;
+            time64 worstTime = 0;
+            allocation_counting_scope countAllocations;
+            const size_type allocationsBefore = allocation_counting_scope::count();
+
+            time::timer timer;
+            for (size_type frame = 0; frame < frameCount; frame++)
+            {
+                timer.start();
+                batcher.build(m_instanceCount, worldMatrices.data(), [&](size_type i) { return renderables[i]; }, allocate, runJobs, batches);
+                const time64 frameTime = timer.end().milliseconds();
+
+                totalTime += frameTime;
+                worstTime = math::max(worstTime, frameTime);
+            }
+
+            const size_type allocations = allocation_counting_scope::count() - allocationsBefore;
+
+            log::info("Batching benchmark: {} instances, {} visible in {} batches, {}ms per frame, worst frame {}ms, {} allocations",
+                m_instanceCount, batches.instanceCount, batches.ranges.size(), totalTime / frameCount, worstTime, allocations);
+            raiseEvent<events::exit>();
+        }
+    };
+
+private:
+    legion::core::size_type m_instanceCount;
+};
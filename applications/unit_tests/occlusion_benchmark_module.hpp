@@ -0,0 +1,119 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/util/occlusion_buffer.hpp>
+
+#include <random>
+
+// Run the unit tests with --occlusion-benchmark[=<instances>] to time the software occlusion culling of the renderer on a synthetic
+// level of walls instead of only running the tests. Uses 100000 instances when no count is given.
+
+class OcclusionBenchmarkModule : public legion::core::Module {
+public:
+    OcclusionBenchmarkModule(legion::core::size_type instanceCount) : m_instanceCount(instanceCount) {}
+
+    void setup() override
+    {
+        reportSystem<OcclusionBenchmarkSystem>(m_instanceCount);
+    }
+
+    legion::core::priority_type priority() override { return PRIORITY_MAX; };
+
+    class OcclusionBenchmarkSystem : public legion::core::System<OcclusionBenchmarkSystem>
+    {
+        legion::core::size_type m_instanceCount;
+        bool m_hasRun = false;
+
+    public:
+        OcclusionBenchmarkSystem(legion::core::size_type instanceCount) : m_instanceCount(instanceCount) {}
+
+        void setup() override
+        {
+            createProcess<&OcclusionBenchmarkSystem::update>("Update");
+        }
+
+        void update(legion::core::time::time_span<legion::core::fast_time>)
+        {
+            using namespace legion;
+            if (m_hasRun)
+                return;
+            m_hasRun = true;
+
+            constexpr size_type frameCount = 100;
+            constexpr size_type wallCount = 64;
+            //every wall is a grid of quads, like an occluder mesh that wasn't simplified
+            constexpr uint wallResolution = 16;
+
+            std::vector<math::vec3> wallVertices;
+            std::vector<uint> wallIndices;
+            for (uint y = 0; y <= wallResolution; y++)
+                for (uint x = 0; x <= wallResolution; x++)
+                    wallVertices.emplace_back(static_cast<float>(x) / wallResolution * 2.f - 1.f, static_cast<float>(y) / wallResolution * 2.f - 1.f, 0.f);
+
+            for (uint y = 0; y < wallResolution; y++)
+                for (uint x = 0; x < wallResolution; x++)
+                {
+                    const uint first = y * (wallResolution + 1) + x;
+                    for (uint index : { first, first + 1, first + wallResolution + 2, first, first + wallResolution + 2, first + wallResolution + 1 })
+                        wallIndices.push_back(index);
+                }
+
+            //walls and boxes scattered through an interior in front of the camera
+            std::mt19937 generator(12345);
+            std::uniform_real_distribution<float> horizontal(-100.f, 100.f);
+            std::uniform_real_distribution<float> depth(-200.f, -5.f);
+            std::uniform_real_distribution<float> angle(0.f, math::pi<float>());
+
+            std::vector<rendering::occluder_mesh> walls(wallCount);
+            for (auto& wall : walls)
+            {
+                wall = rendering::occluder_mesh{ wallVertices.data(), wallVertices.size(), wallIndices.data(), wallIndices.size(),
+                    math::translate(math::mat4(1.f), math::vec3(horizontal(generator), 0.f, depth(generator)))
+                    * math::rotate(math::mat4(1.f), angle(generator), math::vec3(0.f, 1.f, 0.f))
+                    * math::scale(math::mat4(1.f), math::vec3(15.f, 10.f, 1.f)) };
+            }
+
+            std::vector<math::mat4> instances(m_instanceCount);
+            for (auto& instance : instances)
+                instance = math::translate(math::mat4(1.f), math::vec3(horizontal(generator), horizontal(generator) * 0.05f, depth(generator)));
+
+            const math::mat4 view = math::lookAt(math::vec3(0.f, 2.f, 0.f), math::vec3(0.f, 2.f, -1.f), math::vec3(0.f, 1.f, 0.f));
+            const math::mat4 proj = math::perspective(math::deg2rad(60.f), 16.f / 9.f, 1000.f, 0.1f);
+            const math::mat4 viewProjection = proj * view;
+
+            constexpr size_type instancesPerJob = 256;
+            auto runJobs = async::job_runner(*m_scheduler);
+
+            rendering::occlusion_buffer buffer(math::ivec2(256, 128));
+            std::vector<byte> visible(m_instanceCount);
+
+            time64 rasterizeTime = 0;
+            time64 testTime = 0;
+            time::timer timer;
+            for (size_type frame = 0; frame < frameCount; frame++)
+            {
+                timer.start();
+                buffer.rasterize(viewProjection, walls.data(), walls.size(), runJobs);
+                rasterizeTime += timer.end().milliseconds();
+
+                timer.start();
+                async::for_each_range(*m_scheduler, m_instanceCount, instancesPerJob, [&](size_type start, size_type end)
+                    {
+                        for (size_type i = start; i < end; i++)
+                            visible[i] = buffer.is_visible(viewProjection * instances[i], math::vec3(-0.5f), math::vec3(0.5f)) ? 1 : 0;
+                    });
+                testTime += timer.end().milliseconds();
+            }
+
+            size_type visibleCount = 0;
+            for (byte isVisible : visible)
+                visibleCount += isVisible;
+
+            log::info("Occlusion benchmark: {} triangles in {} occluders, {} of {} instances visible, {}ms rasterizing and {}ms testing per frame",
+                wallCount * wallIndices.size() / 3, wallCount, visibleCount, m_instanceCount, rasterizeTime / frameCount, testTime / frameCount);
+            raiseEvent<events::exit>();
+        }
+    };
+
+private:
+    legion::core::size_type m_instanceCount;
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/data/particle_pool.hpp>
+
+#include <random>
+
+// Run the unit tests with --particle-benchmark[=<particles>] to time the particle pools against simulating the same particles
+// as entities, the way the particle systems used to. Uses 1000000 particles when no count is given.
+
+// what the particle component of the entity based particle systems held
+struct benchmark_particle
+{
+    float lifeTime;
+    legion::core::math::vec3 particleVelocity;
+};
+
+class ParticleBenchmarkModule : public legion::core::Module {
+public:
+    ParticleBenchmarkModule(legion::core::size_type particleCount) : m_particleCount(particleCount) {}
+
+    void setup() override
+    {
+        reportComponentType<benchmark_particle>();
+        reportSystem<ParticleBenchmarkSystem>(m_particleCount);
+    }
+
+    legion::core::priority_type priority() override { return PRIORITY_MAX; };
+
+    class ParticleBenchmarkSystem : public legion::core::System<ParticleBenchmarkSystem>
+    {
+        legion::core::size_type m_particleCount;
+        bool m_hasRun = false;
+
+    public:
+        ParticleBenchmarkSystem(legion::core::size_type particleCount) : m_particleCount(particleCount) {}
+
+        void setup() override
+        {
+            createProcess<&ParticleBenchmarkSystem::update>("Update");
+        }
+
+        void update(legion::core::time::time_span<legion::core::fast_time>)
+        {
+            using namespace legion;
+            if (m_hasRun)
+                return;
+            m_hasRun = true;
+
+            constexpr size_type frameCount = 10;
+            constexpr float deltaTime = 1.f / 60.f;
+            const math::vec3 gravity(0.f, -9.81f, 0.f);
+
+            //particles with random velocities that all outlive the benchmark, so both paths simulate the same amount every frame
+            std::mt19937 generator(12345);
+            std::uniform_real_distribution<float> spread(-1.f, 1.f);
+            std::vector<math::vec3> velocities(m_particleCount);
+            for (auto& velocity : velocities)
+                velocity = math::vec3(spread(generator), spread(generator) + 2.f, spread(generator));
+
+            time::timer timer;
+
+            //entity per particle, spawned and updated through component handles
+            timer.start();
+            std::vector<ecs::entity_handle> entities;
+            entities.reserve(m_particleCount);
+            for (size_type i = 0; i < m_particleCount; i++)
+            {
+                auto entity = m_ecs->createEntity();
+                entity.add_components<transform>();
+                entity.add_component<benchmark_particle>(benchmark_particle{ 100.f, velocities[i] });
+                entities.push_back(entity);
+            }
+            const time64 entitySpawnTime = timer.end().milliseconds();
+
+            timer.start();
+            for (size_type frame = 0; frame < frameCount; frame++)
+            {
+                for (auto& entity : entities)
+                {
+                    auto particleHandle = entity.get_component_handle<benchmark_particle>();
+                    auto positionHandle = entity.get_component_handle<position>();
+
+                    benchmark_particle particle = particleHandle.read();
+                    particle.lifeTime -= deltaTime;
+                    positionHandle.write(positionHandle.read() + particle.particleVelocity * deltaTime);
+                    particle.particleVelocity += gravity * deltaTime;
+                    particleHandle.write(particle);
+                }
+            }
+            const time64 entityFrameTime = timer.end().milliseconds() / frameCount;
+
+            for (auto& entity : entities)
+                entity.destroy();
+            entities.clear();
+
+            auto runJobs = async::job_runner(*m_scheduler);
+
+            //structure of arrays pool, simulated in parallel
+            timer.start();
+            rendering::particle_pool pool(m_particleCount);
+            pool.set_acceleration(gravity);
+            for (size_type i = 0; i < m_particleCount; i++)
+                pool.spawn(math::vec3(0.f), velocities[i], math::colors::white, 100.f);
+            const time64 poolSpawnTime = timer.end().milliseconds();
+
+            rendering::particle_pool* pools[] = { &pool };
+            std::vector<size_type> firstJobs;
+            timer.start();
+            for (size_type frame = 0; frame < frameCount; frame++)
+                rendering::simulate_particles(pools, 1, deltaTime, firstJobs, runJobs);
+            const time64 poolFrameTime = timer.end().milliseconds() / frameCount;
+
+            //stands in for the mapped instance buffer of the renderer
+            std::vector<math::mat4> instances(m_particleCount);
+            timer.start();
+            const size_type written = pool.write_instances(instances.data(), nullptr, instances.size());
+            const time64 instanceTime = timer.end().milliseconds();
+
+            log::info("Particle benchmark: {} particles", m_particleCount);
+            log::info("  entities: spawn {}ms, {}ms per frame", entitySpawnTime, entityFrameTime);
+            log::info("  pool:     spawn {}ms, {}ms per frame, {} instances written in {}ms", poolSpawnTime, poolFrameTime, written, instanceTime);
+            raiseEvent<events::exit>();
+        }
+    };
+
+private:
+    legion::core::size_type m_particleCount;
+};
@@ -0,0 +1,63 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/physics.hpp>
+
+#include <fstream>
+
+#include "allocation_counter.hpp"
+
+// Run the unit tests with --physics-benchmark[=<path>] to run the physics benchmark scenarios instead of
+// only the tests. The scenarios are followed by the SAT queries between prism hulls of 8, 64 and 256 vertices.
+// The results are written as JSON to <path>, or to physics_benchmark.json when no path is given.
+
+class PhysicsBenchmarkModule : public legion::core::Module {
+public:
+    PhysicsBenchmarkModule(const std::string& outputPath) : m_outputPath(outputPath) {}
+
+    void setup() override
+    {
+        reportSystem<PhysicsBenchmarkSystem>(m_outputPath);
+    }
+
+    legion::core::priority_type priority() override { return PRIORITY_MAX; };
+
+    class PhysicsBenchmarkSystem : public legion::core::System<PhysicsBenchmarkSystem>
+    {
+        std::string m_outputPath;
+        bool m_hasRun = false;
+
+    public:
+        PhysicsBenchmarkSystem(const std::string& outputPath) : m_outputPath(outputPath) {}
+
+        void setup() override
+        {
+            createProcess<&PhysicsBenchmarkSystem::update>("Update");
+        }
+
+        void update(legion::core::time::time_span<legion::core::fast_time>)
+        {
+            using namespace legion;
+            if (m_hasRun)
+                return;
+            m_hasRun = true;
+
+            allocation_counting_scope countAllocations;
+            physics::PhysicsBenchmark::allocationCounter = &allocation_counting_scope::count;
+
+            physics::PhysicsBenchmark benchmark(m_ecs);
+            auto results = benchmark.runAll();
+            auto hullResults = physics::PhysicsBenchmark::runAllHulls();
+
+            {
+                std::ofstream file(m_outputPath);
+                physics::PhysicsBenchmark::writeJson(results, hullResults, file);
+            }
+
+            log::info("Physics benchmark results written to {}", m_outputPath);
+            raiseEvent<events::exit>();
+        }
+    };
+
+private:
+    std::string m_outputPath;
+};
@@ -7,6 +7,9 @@
 #include <application/application.hpp>
 #include <rendering/rendering.hpp>
 
+#include <optional>
+#include <string_view>
+
 
 #define DOCTEST_CONFIG_IMPLEMENT
 
@@ -14,6 +17,31 @@
 
 #include "doctest.h"
 #include "test_filesystem.hpp"
+#include "test_ring_allocator.hpp"
+#include "test_indirect_commands.hpp"
+#include "test_light_clustering.hpp"
+#include "test_std140.hpp"
+#include "test_particle_pool.hpp"
+#include "test_snapshot_buffer.hpp"
+#include "test_frame_graph.hpp"
+#include "test_debug_lines.hpp"
+#include "test_shader_source_hash.hpp"
+#include "test_lod_selection.hpp"
+#include "test_octree.hpp"
+#include "test_point_cloud_sampler.hpp"
+#include "test_compute.hpp"
+#include "test_occlusion_culling.hpp"
+#include "test_frustum.hpp"
+#include "test_parallel_radix_sort.hpp"
+#include "test_fracturer.hpp"
+#include "test_convex_sat.hpp"
+#include "test_collider_pair_cache.hpp"
+#include "test_primitive_colliders.hpp"
+#include "test_scene_queries.hpp"
+#include "physics_benchmark_module.hpp"
+#include "batching_benchmark_module.hpp"
+#include "particle_benchmark_module.hpp"
+#include "occlusion_benchmark_module.hpp"
 
 using namespace legion;
 
@@ -42,6 +70,23 @@ TEST_CASE("[core:ut] sanity-check")
 }
 
 
+// Finds --name or --name=value on the command line. Returns the value, the fallback when no value was given, or nothing when the argument isn't there.
+std::optional<std::string> findArgument(Engine* engine, std::string_view name, std::string_view fallback)
+{
+    for (auto arg : engine->getCliArgs())
+    {
+        std::string_view argView(arg);
+        if (argView.substr(0, name.size()) != name)
+            continue;
+
+        if (argView.size() == name.size())
+            return std::string(fallback);
+        if (argView[name.size()] == '=')
+            return std::string(argView.substr(name.size() + 1));
+    }
+    return std::nullopt;
+}
+
 void LEGION_CCONV reportModules(Engine* engine)
 {
     doctest::Context ctx;
@@ -49,6 +94,32 @@ void LEGION_CCONV reportModules(Engine* engine)
 
     const int res = ctx.run();
 
+    if (auto outputPath = findArgument(engine, "--physics-benchmark", "physics_benchmark.json"))
+    {
+        //the benchmark steps the physics itself, so the physics system is not run by the engine
+        engine->reportModule<physics::PhysicsModule>(false);
+        engine->reportModule<PhysicsBenchmarkModule>(*outputPath);
+        return;
+    }
+
+    if (auto instanceCount = findArgument(engine, "--batching-benchmark", "100000"))
+    {
+        engine->reportModule<BatchingBenchmarkModule>(std::stoull(*instanceCount));
+        return;
+    }
+
+    if (auto particleCount = findArgument(engine, "--particle-benchmark", "1000000"))
+    {
+        engine->reportModule<ParticleBenchmarkModule>(std::stoull(*particleCount));
+        return;
+    }
+
+    if (auto instanceCount = findArgument(engine, "--occlusion-benchmark", "100000"))
+    {
+        engine->reportModule<OcclusionBenchmarkModule>(std::stoull(*instanceCount));
+        return;
+    }
+
     if(ctx.shouldExit())
         engine->reportModule<Exitus>();
         //std::exit(res);
@@ -0,0 +1,227 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/colliders/convexcollider.hpp>
+#include <physics/data/collider_pair_cache.hpp>
+#include <physics/data/identifier.hpp>
+#include <physics/data/physics_manifold.hpp>
+
+#include <vector>
+
+#include "doctest.h"
+
+inline namespace {
+    //the narrowphase reads the identifier of both entities for debugging, the tests run before the PhysicsModule reports it
+    struct pair_cache_test_registry : ::legion::core::ecs::component_handle_base
+    {
+        static void reportPhysicsComponents()
+        {
+            m_registry->reportComponentType<::legion::physics::identifier>();
+        }
+    };
+
+    //the colliders and components of a pair of boxes, like the PhysicsSystem keeps them
+    struct pair_cache_test_boxes
+    {
+        ::legion::physics::ConvexCollider colliderA;
+        ::legion::physics::ConvexCollider colliderB;
+        ::legion::physics::physicsComponent physicsCompA;
+        ::legion::physics::physicsComponent physicsCompB;
+
+        pair_cache_test_boxes()
+        {
+            colliderA.CreateBox(::legion::physics::cube_collider_params(1.0f, 1.0f, 1.0f));
+            colliderB.CreateBox(::legion::physics::cube_collider_params(1.0f, 1.0f, 1.0f));
+        }
+
+        //runs the narrowphase of a single step for the pair and populates the contacts when they collide
+        void collide(const ::legion::core::math::mat4& transformA, const ::legion::core::math::mat4& transformB,
+            ::legion::physics::collider_pair_cache* pairCache, ::legion::physics::physics_manifold& manifold)
+        {
+            colliderA.UpdateTransformedTightBoundingVolume(transformA);
+            colliderB.UpdateTransformedTightBoundingVolume(transformB);
+
+            manifold.colliderA = &colliderA;
+            manifold.colliderB = &colliderB;
+            manifold.physicsCompA = &physicsCompA;
+            manifold.physicsCompB = &physicsCompB;
+            manifold.rigidbodyA = nullptr;
+            manifold.rigidbodyB = nullptr;
+            manifold.transformA = transformA;
+            manifold.transformB = transformB;
+            manifold.pairCache = pairCache;
+
+            colliderA.CheckCollision(&colliderB, manifold);
+
+            if (manifold.isColliding)
+                colliderA.PopulateContactPoints(&colliderB, manifold);
+        }
+    };
+}
+
+TEST_CASE("[physics:ut] collider pair cache")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    pair_cache_test_registry::reportPhysicsComponents();
+
+    SUBCASE("keys and relative transforms")
+    {
+        CHECK_EQ(collider_pair_cache::makeKey(3, 7), collider_pair_cache::makeKey(7, 3));
+        CHECK_NE(collider_pair_cache::makeKey(3, 7), collider_pair_cache::makeKey(3, 8));
+        CHECK_NE(collider_pair_cache::makeKey(0, 1), collider_pair_cache::makeKey(1, 1));
+
+        collider_pair_cache cache;
+        cache.relativeTransform = math::compose(math::vec3(1.f), math::angleAxis(0.3f, math::vec3(0.f, 1.f, 0.f)), math::vec3(1.f, 0.f, 0.f));
+
+        const float linearStep = constants::pairCacheLinearTolerance * 0.5f;
+        CHECK(cache.isRelativeTransformStable(cache.relativeTransform));
+        CHECK(cache.isRelativeTransformStable(math::compose(math::vec3(1.f), math::angleAxis(0.3f, math::vec3(0.f, 1.f, 0.f)),
+            math::vec3(1.f + linearStep, 0.f, 0.f))));
+        CHECK_FALSE(cache.isRelativeTransformStable(math::compose(math::vec3(1.f), math::angleAxis(0.3f, math::vec3(0.f, 1.f, 0.f)),
+            math::vec3(1.f + linearStep * 3.f, 0.f, 0.f))));
+        CHECK_FALSE(cache.isRelativeTransformStable(math::compose(math::vec3(1.f), math::angleAxis(0.35f, math::vec3(0.f, 1.f, 0.f)),
+            math::vec3(1.f, 0.f, 0.f))));
+    }
+
+    SUBCASE("cached features give the same manifolds as the full seperating axis test")
+    {
+        pair_cache_test_boxes boxes;
+        collider_pair_cache cache;
+
+        //box B comes in diagonally, where the bounding boxes overlap before the boxes do. Then it falls onto box A,
+        //rests on it while it jitters a little, turns, slides and is lifted off again
+        std::vector<math::mat4> transformsB;
+        for (size_type i = 0; i < 10; i++)
+            transformsB.push_back(math::compose(math::vec3(1.f), math::angleAxis(math::quarter_pi<float>(), math::vec3(0.f, 0.f, 1.f)),
+                math::vec3(0.95f - i * 0.01f, 0.95f - i * 0.01f, 0.f)));
+
+        const math::quat tilt = math::angleAxis(0.05f, math::normalize(math::vec3(1.f, 0.f, 1.f)));
+        for (size_type i = 0; i < 20; i++)
+            transformsB.push_back(math::compose(math::vec3(1.f), tilt, math::vec3(0.1f, 1.2f - i * 0.0125f, 0.f)));
+        for (size_type i = 0; i < 30; i++)
+            transformsB.push_back(math::compose(math::vec3(1.f), tilt, math::vec3(0.1f + (i % 3) * 0.001f, 0.95f, 0.f)));
+        for (size_type i = 0; i < 10; i++)
+            transformsB.push_back(math::compose(math::vec3(1.f), tilt * math::angleAxis(i * 0.05f, math::vec3(0.f, 1.f, 0.f)), math::vec3(0.1f, 0.95f, 0.f)));
+        for (size_type i = 0; i < 10; i++)
+            transformsB.push_back(math::compose(math::vec3(1.f), tilt, math::vec3(0.1f + i * 0.02f, 0.95f, 0.f)));
+        for (size_type i = 0; i < 20; i++)
+            transformsB.push_back(math::compose(math::vec3(1.f), tilt, math::vec3(0.3f, 0.95f + i * 0.02f, 0.f)));
+
+        const math::mat4 transformA = math::mat4(1.0f);
+
+        size_type collidingSteps = 0;
+        size_type seperatingFeatureSteps = 0;
+        size_type reusedFeatureSteps = 0;
+        size_type mismatches = 0;
+
+        for (const math::mat4& transformB : transformsB)
+        {
+            //the relative transform the way ConvexCollider::CheckCollisionWith computes it, 'this' is collider B there
+            const bool bIsLowest = boxes.colliderB.GetColliderID() < boxes.colliderA.GetColliderID();
+            const math::mat4 relative = bIsLowest ? math::inverse(transformB) * transformA : math::inverse(transformA) * transformB;
+
+            const bool hadSeperatingFeature = cache.seperatingFeature.isSet();
+            const bool canReuse = cache.penetrationFeature.isSet() && cache.isRelativeTransformStable(relative);
+
+            physics_manifold cached;
+            boxes.collide(transformA, transformB, &cache, cached);
+
+            physics_manifold fresh;
+            boxes.collide(transformA, transformB, nullptr, fresh);
+
+            if (cached.isColliding != fresh.isColliding)
+            {
+                mismatches++;
+                continue;
+            }
+
+            if (!cached.isColliding)
+            {
+                if (hadSeperatingFeature)
+                    seperatingFeatureSteps++;
+                continue;
+            }
+
+            collidingSteps++;
+            if (canReuse)
+                reusedFeatureSteps++;
+
+            const PenetrationQuery& cachedQuery = *cached.penetrationInformation;
+            const PenetrationQuery& freshQuery = *fresh.penetrationInformation;
+
+            bool equal = cachedQuery.isARef == freshQuery.isARef
+                && math::abs(cachedQuery.penetration - freshQuery.penetration) < 1e-4f
+                && math::dot(math::normalize(cachedQuery.normal), math::normalize(freshQuery.normal)) > 0.9999f
+                && cached.contacts.size() == fresh.contacts.size();
+
+            for (size_type i = 0; equal && i < cached.contacts.size(); i++)
+            {
+                equal = math::length(cached.contacts[i].RefWorldContact - fresh.contacts[i].RefWorldContact) < 1e-4f
+                    && math::length(cached.contacts[i].IncWorldContact - fresh.contacts[i].IncWorldContact) < 1e-4f
+                    && cached.contacts[i].label == fresh.contacts[i].label;
+            }
+
+            if (!equal)
+                mismatches++;
+        }
+
+        CHECK_EQ(mismatches, 0);
+
+        //every path of the cache was taken at least once
+        CHECK_GT(collidingSteps, 0);
+        CHECK_GT(seperatingFeatureSteps, 0);
+        CHECK_GT(reusedFeatureSteps, 0);
+        CHECK_LT(reusedFeatureSteps, collidingSteps);
+    }
+
+    SUBCASE("contacts are warm started with the impulses of the last step")
+    {
+        pair_cache_test_boxes boxes;
+        collider_pair_cache cache;
+
+        const math::mat4 transformA = math::mat4(1.0f);
+        const math::mat4 transformB = math::translate(math::vec3(0.1f, 0.95f, 0.f));
+
+        physics_manifold first;
+        boxes.collide(transformA, transformB, &cache, first);
+        REQUIRE(first.isColliding);
+        REQUIRE_FALSE(first.contacts.empty());
+
+        //the PhysicsSystem stores the resolved contacts in the cache at the end of a step
+        for (size_type i = 0; i < first.contacts.size(); i++)
+        {
+            physics_contact& contact = first.contacts[i];
+            contact.totalLambda = 1.0f + i;
+            contact.tangent1Lambda = 0.5f;
+            contact.refCollider->AddConverganceIdentifier(contact, cache);
+        }
+
+        //the same contacts a step later, barely moved
+        physics_manifold second;
+        boxes.collide(transformA, math::translate(math::vec3(0.101f, 0.95f, 0.f)), &cache, second);
+        REQUIRE_EQ(second.contacts.size(), first.contacts.size());
+
+        cache.matchContacts(second.contacts);
+
+        size_type mismatches = 0;
+        for (size_type i = 0; i < second.contacts.size(); i++)
+        {
+            if (second.contacts[i].totalLambda != first.contacts[i].totalLambda || second.contacts[i].tangent1Lambda != 0.5f)
+                mismatches++;
+        }
+        CHECK_EQ(mismatches, 0);
+
+        //contacts that are not close to the ones of the last step start without an impulse
+        physics_manifold turned;
+        boxes.collide(transformA, math::compose(math::vec3(1.f), math::angleAxis(math::quarter_pi<float>(), math::vec3(0.f, 1.f, 0.f)),
+            math::vec3(0.1f, 0.95f, 0.f)), nullptr, turned);
+        REQUIRE(turned.isColliding);
+        for (physics_contact& contact : turned.contacts)
+            contact.label = EdgeLabel();
+
+        cache.matchContacts(turned.contacts);
+        for (const physics_contact& contact : turned.contacts)
+            CHECK_EQ(contact.totalLambda, 0.0f);
+    }
+}
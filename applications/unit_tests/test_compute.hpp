@@ -0,0 +1,145 @@
+#pragma once
+#include <core/compute/context.hpp>
+#include <core/compute/high_level/function.hpp>
+
+#include <numeric>
+#include <string_view>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[core:ut] compute")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::core::compute;
+
+    //runs on any OpenCL device, including CPU runtimes like POCL on machines without a GPU
+    Context::init();
+    if (!Context::initialized())
+    {
+        MESSAGE("No OpenCL device available, skipping the compute tests.");
+        return;
+    }
+
+    constexpr std::string_view source = R"(
+        __kernel void add(__global const int* a, __global const int* b, __global int* result)
+        {
+            const int i = get_global_id(0);
+            result[i] = a[i] + b[i];
+        }
+
+        __kernel void scale(__global const int* values, const int factor, __global int* result)
+        {
+            const int i = get_global_id(0);
+            result[i] = values[i] * factor;
+        }
+    )";
+
+    const filesystem::basic_resource resource(source);
+
+    function add("add");
+    add.setProgram(resource.to<Program>());
+    function scale("scale");
+    scale.setProgram(resource.to<Program>());
+    REQUIRE(add.isValid());
+    REQUIRE(scale.isValid());
+    add.setLocalSize(1);
+    scale.setLocalSize(1);
+
+    std::vector<int> a(256);
+    std::vector<int> b(256);
+    std::iota(a.begin(), a.end(), 0);
+    std::iota(b.begin(), b.end(), 1000);
+
+    SUBCASE("blocking invocations reuse their buffers")
+    {
+        std::vector<int> result(a.size());
+        REQUIRE_FALSE(add(a.size(), a, b, out(result)).has_err());
+        for (size_type i = 0; i < a.size(); i++)
+            CHECK_EQ(result[i], a[i] + b[i]);
+
+        //fewer items fit in the buffers of the previous invocation, more items grow them
+        for (size_type count : { 100u, 256u, 1000u })
+        {
+            std::vector<int> first(count, 3);
+            std::vector<int> second(count, 4);
+            std::vector<int> sum(count, 0);
+            REQUIRE_FALSE(add(count, first, second, out(sum)).has_err());
+            CHECK_EQ(sum.front(), 7);
+            CHECK_EQ(sum.back(), 7);
+        }
+    }
+
+    SUBCASE("enqueued invocations run on their own queues and wait on events")
+    {
+        std::vector<int> sum(a.size());
+        std::vector<int> scaled(a.size());
+        int factor = 3;
+
+        //scale reads the sum that add reads back to the host, the event orders them without blocking the host
+        const Event added = add.enqueue({}, a.size(), a, b, out(sum));
+        REQUIRE(added.isValid());
+        const Event done = scale.enqueue({ added }, a.size(), in(sum, "values"), karg(factor, "factor"), out(scaled, "result"));
+        REQUIRE(done.isValid());
+
+        done.wait();
+        CHECK(added.isComplete());
+        CHECK(done.isComplete());
+        for (size_type i = 0; i < a.size(); i++)
+        {
+            CHECK_EQ(sum[i], a[i] + b[i]);
+            CHECK_EQ(scaled[i], (a[i] + b[i]) * 3);
+        }
+
+        Event::waitAll({ added, done, Event() });
+        CHECK(Event().isComplete());
+    }
+
+    SUBCASE("pinned memory")
+    {
+        const size_type bytes = a.size() * sizeof(int);
+        PinnedMemory pinnedA = Context::allocatePinned(bytes);
+        PinnedMemory pinnedB = Context::allocatePinned(bytes);
+        PinnedMemory pinnedResult = Context::allocatePinned(bytes);
+        REQUIRE(pinnedA.isValid());
+        REQUIRE_EQ(pinnedA.size(), bytes);
+
+        std::copy(a.begin(), a.end(), pinnedA.as<int>());
+        std::copy(b.begin(), b.end(), pinnedB.as<int>());
+
+        Buffer bufferA = Context::createBuffer(pinnedA.data(), bytes, buffer_type::READ_BUFFER);
+        Buffer bufferB = Context::createBuffer(pinnedB.data(), bytes, buffer_type::READ_BUFFER);
+        Buffer bufferResult = Context::createBuffer(pinnedResult.data(), bytes, buffer_type::WRITE_BUFFER);
+
+        add.enqueue({}, a.size(), bufferA, bufferB, bufferResult).wait();
+        for (size_type i = 0; i < a.size(); i++)
+            CHECK_EQ(pinnedResult.as<int>()[i], a[i] + b[i]);
+
+        //moving keeps the mapping alive
+        PinnedMemory moved = std::move(pinnedResult);
+        CHECK_FALSE(pinnedResult.isValid());
+        CHECK_EQ(moved.as<int>()[1], a[1] + b[1]);
+    }
+
+    SUBCASE("device buffers")
+    {
+        Buffer device = Context::createDeviceBuffer(64, buffer_type::READ_BUFFER, "a");
+        REQUIRE(device.isValid());
+        CHECK_FALSE(device.hasHostData());
+        CHECK_EQ(device.capacity(), 64);
+        CHECK(device.canHold(64, buffer_type::READ_BUFFER));
+        CHECK_FALSE(device.canHold(65, buffer_type::READ_BUFFER));
+        CHECK_FALSE(device.canHold(64, buffer_type::WRITE_BUFFER));
+
+        CHECK(device.setHostData(reinterpret_cast<byte*>(a.data()), 64));
+        CHECK_FALSE(device.setHostData(reinterpret_cast<byte*>(a.data()), 65));
+        CHECK_EQ(device.size(), 64);
+
+        //copies share the memory object
+        Buffer copy = device;
+        CHECK(copy.isValid());
+        Buffer moved = std::move(copy);
+        CHECK_FALSE(copy.isValid());
+        CHECK(moved.isValid());
+    }
+}
@@ -0,0 +1,330 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/physics_statics.hpp>
+#include <physics/data/vertex_soa.hpp>
+#include <physics/systems/physics_benchmark.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+
+inline namespace {
+    //the arc test of the gauss map, the arcs go from a1 to a2 and from b1 to b2
+    bool satTestArcsIntersect(const ::legion::core::math::vec3& a1, const ::legion::core::math::vec3& a2,
+        const ::legion::core::math::vec3& b1, const ::legion::core::math::vec3& b2)
+    {
+        using namespace ::legion::core;
+
+        const math::vec3 planeA = math::cross(a1, a2);
+        const math::vec3 planeB = math::cross(b1, b2);
+
+        const float planeADotB1 = math::dot(planeA, b1);
+        const float planeADotB2 = math::dot(planeA, b2);
+        const float planeBDotA1 = math::dot(planeB, a1);
+        const float planeBDotA2 = math::dot(planeB, a2);
+
+        return planeADotB1 * planeADotB2 <= 0.0f && planeBDotA1 * planeBDotA2 <= 0.0f && planeADotB1 * planeBDotA2 >= 0.0f;
+    }
+
+    //the edge check like it was done before the hulls had unique edges: every half edge of A against every half edge of B,
+    //with the gauss map transformed to world space for every pair
+    bool satTestReferenceEdgeCheck(::legion::physics::ConvexCollider* convexA, ::legion::physics::ConvexCollider* convexB,
+        const ::legion::core::math::mat4& transformA, const ::legion::core::math::mat4& transformB, float& seperation)
+    {
+        using namespace ::legion::core;
+        using namespace ::legion::physics;
+
+        const ConvexHull& hullA = convexA->GetConvexHull();
+        const ConvexHull& hullB = convexB->GetConvexHull();
+        seperation = std::numeric_limits<float>::max();
+
+        for (size_type edgeA = 0; edgeA < hullA.getEdges().size(); edgeA++)
+        {
+            const ConvexHull::half_edge& halfEdgeA = hullA.getEdges()[edgeA];
+            if (halfEdgeA.pairing == ConvexHull::invalid_index) { continue; }
+
+            const math::vec3 a1 = transformA * math::vec4(hullA.getFaces()[halfEdgeA.face].normal, 0);
+            const math::vec3 a2 = transformA * math::vec4(hullA.getEdgeFace(halfEdgeA.pairing).normal, 0);
+
+            for (size_type edgeB = 0; edgeB < hullB.getEdges().size(); edgeB++)
+            {
+                const ConvexHull::half_edge& halfEdgeB = hullB.getEdges()[edgeB];
+                if (halfEdgeB.pairing == ConvexHull::invalid_index) { continue; }
+
+                const math::vec3 b1 = -math::vec3(transformB * math::vec4(hullB.getFaces()[halfEdgeB.face].normal, 0));
+                const math::vec3 b2 = -math::vec3(transformB * math::vec4(hullB.getEdgeFace(halfEdgeB.pairing).normal, 0));
+
+                if (!satTestArcsIntersect(a1, a2, b1, b2)) { continue; }
+
+                math::vec3 axis;
+                float edgeSeperation;
+                if (PhysicsStatics::GetEdgeSeperation(convexA, static_cast<ConvexHull::feature_index>(edgeA), convexB,
+                    static_cast<ConvexHull::feature_index>(edgeB), transformA, transformB, axis, edgeSeperation))
+                {
+                    seperation = math::min(seperation, edgeSeperation);
+                }
+            }
+        }
+
+        return seperation > 0.0f;
+    }
+
+    //the face check like it was done before the vertex soa: the seperation of every face of B, with every vertex of A moved to world space
+    std::vector<float> satTestReferenceFaceSeperations(::legion::physics::ConvexCollider* convexA, ::legion::physics::ConvexCollider* convexB,
+        const ::legion::core::math::mat4& transformA, const ::legion::core::math::mat4& transformB)
+    {
+        using namespace ::legion::core;
+        using namespace ::legion::physics;
+
+        std::vector<math::vec3> worldVertices;
+        for (const math::vec3& vertex : convexA->GetConvexHull().getVertices())
+            worldVertices.push_back(transformA * math::vec4(vertex, 1));
+
+        std::vector<float> seperations;
+        for (const ConvexHull::hull_face& face : convexB->GetConvexHull().getFaces())
+        {
+            const math::vec3 axis = math::normalize(transformB * math::vec4(face.normal, 0));
+            const math::vec3 planePosition = transformB * math::vec4(face.centroid, 1);
+
+            math::vec3 supportPoint;
+            PhysicsStatics::GetSupportPoint(worldVertices, -axis, supportPoint);
+            seperations.push_back(math::dot(supportPoint - planePosition, axis));
+        }
+        return seperations;
+    }
+}
+
+TEST_CASE("[physics:ut] vertex soa support index")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    //the first vertex with the largest dot product, the way the vertex soa has to resolve ties
+    auto bruteForceSupport = [](const std::vector<math::vec3>& vertices, const math::vec3& direction, float& maxDistance)
+    {
+        size_type result = 0;
+        maxDistance = std::numeric_limits<float>::lowest();
+        for (size_type i = 0; i < vertices.size(); i++)
+        {
+            const float dot = vertices[i].x * direction.x + vertices[i].y * direction.y + vertices[i].z * direction.z;
+            if (dot > maxDistance)
+            {
+                maxDistance = dot;
+                result = i;
+            }
+        }
+        return result;
+    };
+
+    std::mt19937 generator(7);
+
+    SUBCASE("integer coordinates with many ties")
+    {
+        //small integers keep the dot products exact, so the index has to be the same as the brute force one
+        std::uniform_int_distribution<int> distribution(-2, 2);
+        size_type mismatches = 0;
+
+        for (size_type count = 1; count <= 17; count++)
+        {
+            for (size_type attempt = 0; attempt < 50; attempt++)
+            {
+                std::vector<math::vec3> vertices(count);
+                for (auto& vertex : vertices)
+                    vertex = math::vec3(distribution(generator), distribution(generator), distribution(generator));
+
+                const VertexSoA soa(vertices);
+                const math::vec3 direction(distribution(generator), distribution(generator), distribution(generator));
+
+                float expectedDistance;
+                const size_type expected = bruteForceSupport(vertices, direction, expectedDistance);
+                float maxDistance;
+                const size_type index = soa.getSupportIndex(direction, maxDistance);
+
+                if (index != expected || maxDistance != expectedDistance)
+                    mismatches++;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    SUBCASE("ties and padding")
+    {
+        const std::vector<math::vec3> same(6, math::vec3(1.f, 2.f, 3.f));
+        CHECK_EQ(VertexSoA(same).getSupportIndex(math::vec3(0.f, 1.f, 0.f)), 0);
+
+        //two vertices that are furthest in the direction, in different lanes and in different blocks of 4
+        std::vector<math::vec3> vertices(9, math::vec3(0.f));
+        vertices[2] = math::vec3(0.f, 5.f, 0.f);
+        vertices[7] = math::vec3(1.f, 5.f, 0.f);
+        CHECK_EQ(VertexSoA(vertices).getSupportIndex(math::vec3(0.f, 1.f, 0.f)), 2);
+
+        vertices[5] = math::vec3(0.f, 5.f, 1.f);
+        CHECK_EQ(VertexSoA(vertices).getSupportIndex(math::vec3(0.f, 1.f, 0.f)), 2);
+
+        //the padding copies the first vertex, which may never win from the first vertex itself
+        const std::vector<math::vec3> five{ { 0.f, 9.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 2.f, 0.f }, { 0.f, 3.f, 0.f }, { 0.f, 4.f, 0.f } };
+        const VertexSoA paddedSoA(five);
+        CHECK_EQ(paddedSoA.count, 5);
+        CHECK_EQ(paddedSoA.x.size(), 8);
+        CHECK_EQ(paddedSoA.getSupportIndex(math::vec3(0.f, 1.f, 0.f)), 0);
+        CHECK_EQ(paddedSoA.getSupportIndex(math::vec3(0.f, -1.f, 0.f)), 1);
+    }
+
+    SUBCASE("hull support points match the world space vertices")
+    {
+        //the support point searched in local space with the transposed matrix is the same as the one of the transformed vertices
+        ConvexCollider collider(PhysicsBenchmark::createPrismHull(32));
+        const ConvexHull& hull = collider.GetConvexHull();
+
+        std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+        size_type mismatches = 0;
+
+        for (size_type attempt = 0; attempt < 200; attempt++)
+        {
+            const math::vec3 axis = math::normalize(math::vec3(distribution(generator), distribution(generator), distribution(generator)));
+            const math::vec3 scale(1.3f, 0.8f, 1.1f);
+            const math::mat4 transform = math::compose(scale, math::angleAxis(distribution(generator) * 3.f, axis),
+                math::vec3(distribution(generator), distribution(generator), distribution(generator)) * 5.f);
+            const math::vec3 direction(distribution(generator), distribution(generator), distribution(generator));
+
+            std::vector<math::vec3> worldVertices;
+            for (const math::vec3& vertex : hull.getVertices())
+                worldVertices.push_back(transform * math::vec4(vertex, 1));
+
+            math::vec3 expected;
+            const float expectedDistance = PhysicsStatics::GetSupportPoint(worldVertices, direction, expected);
+
+            math::vec3 supportPoint;
+            PhysicsStatics::GetSupportPoint(direction, &collider, transform, math::transpose(math::mat3(transform)), supportPoint);
+
+            if (math::abs(math::dot(supportPoint, direction) - expectedDistance) > 1e-4f)
+                mismatches++;
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+}
+
+TEST_CASE("[physics:ut] convex SAT queries")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    auto randomRotation = [&]()
+    {
+        const math::vec3 axis = math::normalize(math::vec3(distribution(generator), distribution(generator), distribution(generator)));
+        return math::angleAxis(distribution(generator) * math::pi<float>(), axis);
+    };
+
+    //overlapping, touching and seperated prisms of every size the benchmark uses
+    for (size_type vertexCount : { 8u, 64u, 256u })
+    {
+        CAPTURE(vertexCount);
+        ConvexCollider colliderA(PhysicsBenchmark::createPrismHull(vertexCount / 2));
+        ConvexCollider colliderB(PhysicsBenchmark::createPrismHull(vertexCount / 2, 0.8f, 1.5f));
+        ConvexCollider* convexA = &colliderA;
+        ConvexCollider* convexB = &colliderB;
+
+        REQUIRE_EQ(convexA->GetConvexHull().getVertices().size(), vertexCount);
+        REQUIRE_EQ(convexA->GetConvexHull().getFaces().size(), vertexCount / 2 + 2);
+        REQUIRE_EQ(convexA->GetConvexHull().getUniqueEdges().size(), vertexCount / 2 * 3);
+
+        size_type faceMismatches = 0;
+        size_type edgeMismatches = 0;
+        size_type axisMismatches = 0;
+        size_type seperatedCount = 0;
+
+        for (float distance : { 0.8f, 1.4f, 1.7f, 2.1f, 3.f })
+        {
+            for (size_type attempt = 0; attempt < 20; attempt++)
+            {
+                const math::vec3 offset = math::normalize(math::vec3(distribution(generator), distribution(generator), distribution(generator))) * distance;
+                const math::mat4 transformA = math::compose(math::vec3(1.f), randomRotation(), math::vec3(0.f));
+                const math::mat4 transformB = math::compose(math::vec3(1.f), randomRotation(), offset);
+
+                //face checks of both hulls, compared to the support points of the world space vertices
+                for (bool bIsReference : { false, true })
+                {
+                    ConvexCollider* incident = bIsReference ? convexA : convexB;
+                    ConvexCollider* reference = bIsReference ? convexB : convexA;
+                    const math::mat4& incidentTransform = bIsReference ? transformA : transformB;
+                    const math::mat4& referenceTransform = bIsReference ? transformB : transformA;
+
+                    const std::vector<float> expected = satTestReferenceFaceSeperations(incident, reference, incidentTransform, referenceTransform);
+                    const float expectedMaximum = *std::max_element(expected.begin(), expected.end());
+
+                    ConvexHull::feature_index refFace;
+                    float seperation;
+                    const bool seperated = PhysicsStatics::FindSeperatingAxisByExtremePointProjection(incident, reference,
+                        incidentTransform, referenceTransform, refFace, seperation);
+
+                    //the face check stops at the first seperating face, otherwise it finds the face with the largest seperation
+                    if (seperated != (expectedMaximum > 0.0f) || refFace >= expected.size() || math::abs(expected[refFace] - seperation) > 1e-4f
+                        || (!seperated && math::abs(expectedMaximum - seperation) > 1e-4f))
+                    {
+                        faceMismatches++;
+                    }
+
+                    //the face plane supports the reference hull, so the seperation is also the gap between the projections on its normal
+                    if (refFace < expected.size())
+                    {
+                        const math::vec3 axis = math::normalize(referenceTransform * math::vec4(reference->GetConvexHull().getFaces()[refFace].normal, 0));
+                        const float gap = PhysicsStatics::GetSeperationOnAxis(reference, incident, referenceTransform, incidentTransform, axis);
+                        if (math::abs(gap - seperation) > 1e-4f)
+                            axisMismatches++;
+                    }
+
+                    if (seperated)
+                        seperatedCount++;
+                }
+
+                //the pruned edge check in local space finds the same minkowski faces as the world space check over every half edge
+                float expectedSeperation;
+                const bool expectedSeperated = satTestReferenceEdgeCheck(convexA, convexB, transformA, transformB, expectedSeperation);
+
+                ConvexHull::feature_index refEdge;
+                ConvexHull::feature_index incEdge;
+                math::vec3 edgeAxis;
+                float edgeSeperation;
+                const bool edgeSeperated = PhysicsStatics::FindSeperatingAxisByGaussMapEdgeCheck(convexA, convexB, transformA, transformB,
+                    refEdge, incEdge, edgeAxis, edgeSeperation);
+
+                if (edgeSeperated != expectedSeperated || math::abs(edgeSeperation - expectedSeperation) > 1e-4f)
+                {
+                    edgeMismatches++;
+                }
+                else if (refEdge != ConvexHull::invalid_index)
+                {
+                    //the edge pair that was found creates a minkowski face and gives the seperation it reported
+                    const ConvexHull& hullA = convexA->GetConvexHull();
+                    const ConvexHull& hullB = convexB->GetConvexHull();
+                    const math::vec3 a1 = transformA * math::vec4(hullA.getEdgeFace(refEdge).normal, 0);
+                    const math::vec3 a2 = transformA * math::vec4(hullA.getEdgeFace(hullA.getEdges()[refEdge].pairing).normal, 0);
+                    const math::vec3 b1 = -math::vec3(transformB * math::vec4(hullB.getEdgeFace(incEdge).normal, 0));
+                    const math::vec3 b2 = -math::vec3(transformB * math::vec4(hullB.getEdgeFace(hullB.getEdges()[incEdge].pairing).normal, 0));
+
+                    math::vec3 axis;
+                    float seperation;
+                    if (!satTestArcsIntersect(a1, a2, b1, b2)
+                        || !PhysicsStatics::GetEdgeSeperation(convexA, refEdge, convexB, incEdge, transformA, transformB, axis, seperation)
+                        || math::abs(seperation - edgeSeperation) > 1e-4f || math::abs(math::dot(axis, edgeAxis) - 1.f) > 1e-4f)
+                    {
+                        axisMismatches++;
+                    }
+                }
+            }
+        }
+
+        CHECK_EQ(faceMismatches, 0);
+        CHECK_EQ(edgeMismatches, 0);
+        CHECK_EQ(axisMismatches, 0);
+
+        //the distances are picked so both outcomes are tested
+        CHECK_GT(seperatedCount, 0);
+        CHECK_LT(seperatedCount, 200);
+    }
+}
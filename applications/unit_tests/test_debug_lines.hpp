@@ -0,0 +1,150 @@
+#pragma once
+#include <core/data/debug_lines.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[core:ut] debug line buffer")
+{
+    using namespace ::legion::core;
+
+    DebugLineBuffer::clear();
+    debug_line_frame frame;
+
+    SUBCASE("widths are rounded to buckets")
+    {
+        CHECK_EQ(DebugLineBuffer::width_bucket(1.f), 2);
+        CHECK_EQ(DebugLineBuffer::width_bucket(1.2f), 2);
+        CHECK_EQ(DebugLineBuffer::width_bucket(1.3f), 3);
+        CHECK_EQ(DebugLineBuffer::width_bucket(-1.f), 0);
+        CHECK_EQ(DebugLineBuffer::width_bucket(100.f), DebugLineBuffer::width_buckets - 1);
+        CHECK_EQ(DebugLineBuffer::bucket_width(DebugLineBuffer::width_bucket(1.2f)), 1.f);
+
+        DebugLineBuffer::add(math::vec3(0.f), math::vec3(1.f), math::colors::white, 1.f, 0.f, false);
+        DebugLineBuffer::add(math::vec3(0.f), math::vec3(2.f), math::colors::white, 3.f, 0.f, true);
+        DebugLineBuffer::add(math::vec3(0.f), math::vec3(3.f), math::colors::white, 1.1f, 0.f, false);
+        DebugLineBuffer::publish();
+        DebugLineBuffer::merge(time::span(0.f), frame);
+
+        // Lines of the same width end up next to each other, a batch per width.
+        REQUIRE_EQ(frame.batches.size(), 2);
+        CHECK_EQ(frame.batches[0].width, 1.f);
+        CHECK_EQ(frame.batches[0].first, 0);
+        CHECK_EQ(frame.batches[0].count, 4);
+        CHECK_EQ(frame.batches[1].width, 3.f);
+        CHECK_EQ(frame.batches[1].first, 4);
+        CHECK_EQ(frame.batches[1].count, 2);
+        CHECK_EQ(frame.vertices[5].position, math::vec3(2.f));
+        CHECK_EQ(frame.vertices[5].ignoreDepth, 1u);
+    }
+
+    SUBCASE("lines without lifetime last until the next frame of their thread")
+    {
+        DebugLineBuffer::add(math::vec3(0.f), math::vec3(1.f), math::colors::red, 1.f, 0.f, false);
+
+        // Not visible until the thread ends its frame.
+        DebugLineBuffer::merge(time::span(0.1f), frame);
+        CHECK(frame.vertices.empty());
+
+        DebugLineBuffer::publish();
+        DebugLineBuffer::merge(time::span(0.1f), frame);
+        CHECK_EQ(frame.vertices.size(), 2);
+
+        // Rendering faster than the thread draws keeps showing the same lines.
+        DebugLineBuffer::merge(time::span(0.1f), frame);
+        CHECK_EQ(frame.vertices.size(), 2);
+        CHECK_EQ(frame.vertices[0].color, math::colors::red);
+
+        // A frame in which nothing was drawn removes them.
+        DebugLineBuffer::publish();
+        DebugLineBuffer::merge(time::span(0.1f), frame);
+        CHECK(frame.vertices.empty());
+        CHECK(frame.batches.empty());
+    }
+
+    SUBCASE("lines with a lifetime expire after it")
+    {
+        DebugLineBuffer::add(math::vec3(0.f), math::vec3(1.f), math::colors::white, 1.f, 0.5f, false);
+        DebugLineBuffer::add(math::vec3(0.f), math::vec3(1.f), math::colors::white, 1.f, 2.f, false);
+
+        // Timed lines don't wait for the end of the frame and don't disappear with it.
+        DebugLineBuffer::merge(time::span(0.f), frame);
+        CHECK_EQ(frame.vertices.size(), 4);
+        DebugLineBuffer::publish();
+
+        DebugLineBuffer::merge(time::span(0.25f), frame);
+        CHECK_EQ(frame.vertices.size(), 4);
+
+        DebugLineBuffer::merge(time::span(0.5f), frame);
+        CHECK_EQ(frame.vertices.size(), 2);
+
+        DebugLineBuffer::merge(time::span(1.5f), frame);
+        CHECK(frame.vertices.empty());
+    }
+
+    SUBCASE("threads append without waiting on each other")
+    {
+        constexpr size_type threadCount = 4;
+        constexpr size_type linesPerThread = 1000;
+
+        std::vector<std::thread> threads;
+        for (size_type i = 0; i < threadCount; i++)
+            threads.emplace_back([i]()
+                {
+                    for (size_type j = 0; j < linesPerThread; j++)
+                        DebugLineBuffer::add(math::vec3(static_cast<float>(i)), math::vec3(static_cast<float>(j)), math::colors::white, static_cast<float>(i), 0.f, false);
+                    DebugLineBuffer::publish();
+                });
+
+        // A worker thread that never ends a frame itself gets published by the others.
+        std::thread worker([]()
+            {
+                DebugLineBuffer::add(math::vec3(0.f), math::vec3(1.f), math::colors::white, 1.f, 0.f, false);
+            });
+        worker.join();
+
+        for (auto& thread : threads)
+            thread.join();
+        DebugLineBuffer::publish();
+
+        DebugLineBuffer::merge(time::span(0.f), frame);
+        CHECK_EQ(frame.vertices.size(), (threadCount * linesPerThread + 1) * 2);
+        CHECK_EQ(frame.batches.size(), threadCount);
+
+        size_type expectedFirst = 0;
+        for (auto& batch : frame.batches)
+        {
+            CHECK_EQ(batch.first, expectedFirst);
+            expectedFirst += batch.count;
+        }
+    }
+
+    SUBCASE("threads that exited are removed once their lines are merged")
+    {
+        DebugLineBuffer::publish();
+        DebugLineBuffer::merge(time::span(0.f), frame);
+        const size_type threadsBefore = DebugLineBuffer::thread_count();
+
+        std::thread worker([]()
+            {
+                DebugLineBuffer::add(math::vec3(0.f), math::vec3(1.f), math::colors::white, 1.f, 0.f, false);
+            });
+        worker.join();
+        CHECK_EQ(DebugLineBuffer::thread_count(), threadsBefore + 1);
+
+        // The lines the thread drew before it exited are still shown once.
+        DebugLineBuffer::publish();
+        DebugLineBuffer::merge(time::span(0.f), frame);
+        CHECK_EQ(frame.vertices.size(), 2);
+        CHECK_EQ(DebugLineBuffer::thread_count(), threadsBefore);
+
+        DebugLineBuffer::publish();
+        DebugLineBuffer::merge(time::span(0.f), frame);
+        CHECK(frame.vertices.empty());
+    }
+
+    DebugLineBuffer::clear();
+    DebugLineBuffer::merge(time::span(0.f), frame);
+}
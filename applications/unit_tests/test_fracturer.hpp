@@ -0,0 +1,219 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/components/fracturer.hpp>
+
+#include <vector>
+
+#include "doctest.h"
+
+inline namespace {
+    //a cube of 1x1x1 with its own vertices for every face, like a cube that is loaded from an obj
+    ::legion::core::mesh createFractureTestCube()
+    {
+        using namespace ::legion::core;
+
+        mesh cube;
+        const math::vec3 normals[] = { { 1.f, 0.f, 0.f }, { -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, -1.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 0.f, -1.f } };
+        for (const math::vec3& normal : normals)
+        {
+            //two axes along the face, ordered so the corners go counter clockwise when looking at the face from outside
+            const math::vec3 u = math::vec3(normal.y, normal.z, normal.x) * 0.5f;
+            const math::vec3 v = math::cross(normal, u);
+            const uint first = static_cast<uint>(cube.vertices.size());
+
+            for (const math::vec3& corner : { -u - v, u - v, u + v, -u + v })
+            {
+                cube.vertices.push_back(normal * 0.5f + corner);
+                cube.normals.push_back(normal);
+                cube.uvs.emplace_back(0.f);
+            }
+
+            for (uint index : { 0u, 1u, 2u, 0u, 2u, 3u })
+                cube.indices.push_back(first + index);
+        }
+        return cube;
+    }
+
+    //the cube split with the given transform, the polygons are built with the same transform like MeshSplitter::InitializePolygons does
+    ::legion::physics::fracture_source createFractureTestSource(::legion::core::mesh& cube, const ::legion::core::math::vec3& position,
+        const ::legion::core::math::quat& rotation, const ::legion::core::math::vec3& scale)
+    {
+        using namespace ::legion::core;
+
+        ::legion::physics::fracture_source source;
+        source.position = position;
+        source.rotation = rotation;
+        source.scale = scale;
+        source.transform = math::compose(scale, rotation, position);
+        source.splitter.InitializePolygons(cube, source.transform);
+        return source;
+    }
+}
+
+TEST_CASE("[physics:ut] fracture patterns")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    mesh cube = createFractureTestCube();
+    const math::vec3 scale(1.5f);
+
+    //four cells that are cut by the planes x = 0.1 and y = -0.2, and reach past the scaled cube everywhere else
+    std::vector<std::vector<math::vec3>> localCells;
+    for (const auto& [min, max] : { std::pair{ math::vec3(-2.f, -2.f, -2.f), math::vec3(0.1f, -0.2f, 2.f) },
+        std::pair{ math::vec3(0.1f, -2.f, -2.f), math::vec3(2.f, -0.2f, 2.f) },
+        std::pair{ math::vec3(-2.f, -0.2f, -2.f), math::vec3(0.1f, 2.f, 2.f) },
+        std::pair{ math::vec3(0.1f, -0.2f, -2.f), math::vec3(2.f, 2.f, 2.f) } })
+    {
+        //the corners are in the same order as ConvexCollider::CreateBox, the quickhull does not find every face of a box in any order
+        std::vector<math::vec3>& cell = localCells.emplace_back();
+        for (size_type corner : { 4u, 5u, 0u, 1u, 6u, 7u, 2u, 3u })
+            cell.emplace_back(corner & 1 ? max.x : min.x, corner & 2 ? max.y : min.y, corner & 4 ? max.z : min.z);
+    }
+
+    //without a scheduler the pattern is built on the calling thread
+    Fracturer::scheduler = nullptr;
+
+    constexpr size_type cachedKey = 0x6672616374757265ull;
+    std::vector<fracture_source> localSources;
+    localSources.push_back(createFractureTestSource(cube, math::vec3(0.f), math::identity<math::quat>(), scale));
+    auto cached = Fracturer::BuildFracturePattern(cachedKey, std::move(localSources), localCells);
+
+    REQUIRE(cached);
+    REQUIRE(cached->isReady());
+    REQUIRE_EQ(cached->cellFragments.size(), localCells.size());
+
+    SUBCASE("the pattern is cached with its key")
+    {
+        CHECK_EQ(Fracturer::FindFracturePattern(cachedKey), cached);
+        CHECK_FALSE(Fracturer::FindFracturePattern(cachedKey + 1));
+
+        for (auto& fragments : cached->cellFragments)
+        {
+            REQUIRE_EQ(fragments.size(), 1);
+            CHECK_EQ(fragments[0].pairingIndex, 0);
+            CHECK_FALSE(fragments[0].convexHull->empty());
+            CHECK_FALSE(fragments[0].fragmentMesh.vertices.empty());
+        }
+    }
+
+    SUBCASE("a cached pattern gives the same fragments as a fresh one")
+    {
+        //the fresh pattern splits new polygons of the same cube, the cached one is shared by every entity with this cube
+        std::vector<fracture_source> freshSources;
+        freshSources.push_back(createFractureTestSource(cube, math::vec3(0.f), math::identity<math::quat>(), scale));
+        auto fresh = Fracturer::BuildFracturePattern(cachedKey + 2, std::move(freshSources), localCells);
+
+        REQUIRE(fresh->isReady());
+        REQUIRE_EQ(fresh->cellFragments.size(), cached->cellFragments.size());
+        CHECK_EQ(Fracturer::FindFracturePattern(cachedKey), cached);
+
+        for (size_type cellIndex = 0; cellIndex < cached->cellFragments.size(); cellIndex++)
+        {
+            auto& cachedFragments = cached->cellFragments[cellIndex];
+            auto& freshFragments = fresh->cellFragments[cellIndex];
+            REQUIRE_EQ(freshFragments.size(), cachedFragments.size());
+
+            for (size_type i = 0; i < cachedFragments.size(); i++)
+            {
+                const fracture_fragment& cachedFragment = cachedFragments[i];
+                const fracture_fragment& freshFragment = freshFragments[i];
+
+                CHECK_EQ(freshFragment.pairingIndex, cachedFragment.pairingIndex);
+                CHECK_EQ(freshFragment.localPosition, cachedFragment.localPosition);
+                CHECK_EQ(freshFragment.localRotation, cachedFragment.localRotation);
+                CHECK_EQ(freshFragment.fragmentMesh.vertices, cachedFragment.fragmentMesh.vertices);
+                CHECK_EQ(freshFragment.fragmentMesh.indices, cachedFragment.fragmentMesh.indices);
+                CHECK_EQ(freshFragment.convexHull->getFaces().size(), cachedFragment.convexHull->getFaces().size());
+            }
+        }
+    }
+
+    SUBCASE("the fragments are placed relative to the owner")
+    {
+        //every fragment stays inside of its cell and the scaled cube, wherever the owner is
+        for (size_type cellIndex = 0; cellIndex < cached->cellFragments.size(); cellIndex++)
+        {
+            math::vec3 min = localCells[cellIndex][0];
+            math::vec3 max = localCells[cellIndex][0];
+            for (const math::vec3& point : localCells[cellIndex])
+            {
+                min = math::min(min, point);
+                max = math::max(max, point);
+            }
+            min = math::max(min, -scale * 0.5f);
+            max = math::min(max, scale * 0.5f);
+
+            for (const fracture_fragment& fragment : cached->cellFragments[cellIndex])
+            {
+                size_type outside = 0;
+                for (const math::vec3& vertex : fragment.fragmentMesh.vertices)
+                {
+                    const math::vec3 position = fragment.localPosition + fragment.localRotation * vertex;
+                    if (math::any(math::lessThan(position, min - 0.001f)) || math::any(math::greaterThan(position, max + 0.001f)))
+                        outside++;
+                }
+                CHECK_EQ(outside, 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("[physics:ut] commit pending fractures")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    auto createPattern = [](size_type cellsRemaining)
+    {
+        auto pattern = std::make_shared<fracture_pattern>();
+        pattern->cellsRemaining.store(cellsRemaining);
+        return pattern;
+    };
+
+    //entities that were never created, like an entity that was destroyed while it waited for its pattern
+    const ecs::entity_handle first(0x7fffffff00000001ull);
+    const ecs::entity_handle second(0x7fffffff00000002ull);
+    const ecs::entity_handle third(0x7fffffff00000003ull);
+    REQUIRE_FALSE(first.valid());
+
+    REQUIRE_EQ(Fracturer::PendingFractureCount(), 0);
+
+    auto unfinished = createPattern(2);
+    CHECK(Fracturer::QueueFracture(fracture_request{ first, FractureParams(math::vec3(0.f), 1.f), unfinished }));
+    CHECK(Fracturer::QueueFracture(fracture_request{ second, FractureParams(math::vec3(0.f), 1.f), createPattern(0) }));
+    CHECK(Fracturer::QueueFracture(fracture_request{ third, FractureParams(math::vec3(0.f), 1.f), unfinished }));
+
+    //an entity is only fractured once, even when it is requested again before its pattern is done
+    CHECK_FALSE(Fracturer::QueueFracture(fracture_request{ first, FractureParams(math::vec3(0.f), 1.f), createPattern(0) }));
+    CHECK_EQ(Fracturer::PendingFractureCount(), 3);
+
+    SUBCASE("requests wait for their pattern")
+    {
+        //the ready request is taken out without creating fragments for its destroyed owner
+        Fracturer::CommitPendingFractures();
+        CHECK_EQ(Fracturer::PendingFractureCount(), 2);
+
+        Fracturer::CommitPendingFractures();
+        CHECK_EQ(Fracturer::PendingFractureCount(), 2);
+
+        unfinished->cellsRemaining.fetch_sub(1);
+        Fracturer::CommitPendingFractures();
+        CHECK_EQ(Fracturer::PendingFractureCount(), 2);
+
+        unfinished->cellsRemaining.fetch_sub(1);
+        Fracturer::CommitPendingFractures();
+        CHECK_EQ(Fracturer::PendingFractureCount(), 0);
+    }
+
+    SUBCASE("a committed entity can be requested again")
+    {
+        unfinished->cellsRemaining.store(0);
+        Fracturer::CommitPendingFractures();
+        REQUIRE_EQ(Fracturer::PendingFractureCount(), 0);
+
+        CHECK(Fracturer::QueueFracture(fracture_request{ first, FractureParams(math::vec3(0.f), 1.f), createPattern(0) }));
+        Fracturer::CommitPendingFractures();
+        CHECK_EQ(Fracturer::PendingFractureCount(), 0);
+    }
+}
@@ -0,0 +1,233 @@
+#pragma once
+#include <rendering/util/frame_graph.hpp>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] frame graph")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    const math::ivec2 framebufferSize(1920, 1080);
+
+    frame_resource_desc hdrTexture;
+    hdrTexture.texelSize = 16;
+    hdrTexture.mipmapped = true;
+    hdrTexture.format = 1;
+
+    frame_resource_desc halfHdrTexture = hdrTexture;
+    halfHdrTexture.scale = 0.5f;
+
+    frame_resource_desc depthTexture;
+    depthTexture.texelSize = 4;
+    depthTexture.format = 2;
+
+    FrameGraph graph;
+
+    SUBCASE("passes of which nothing is used are culled")
+    {
+        const size_type setup = graph.add_pass("setup");
+        graph.import_resource("color");
+        graph.write("color");
+
+        const size_type unused = graph.add_pass("unused");
+        graph.read("color");
+        graph.create("unused output", hdrTexture);
+
+        const size_type producer = graph.add_pass("producer");
+        graph.create("intermediate", hdrTexture);
+
+        const size_type consumer = graph.add_pass("consumer");
+        graph.read("intermediate");
+        graph.read("color");
+        graph.write("color");
+
+        const size_type history = graph.add_pass("history");
+        graph.read("color");
+        graph.import_resource("color history", true);
+        graph.write("color history");
+
+        const size_type unknown = graph.add_pass("unknown");
+
+        const size_type present = graph.add_pass("present");
+        graph.read("color");
+        graph.side_effect();
+
+        const size_type afterPresent = graph.add_pass("after present");
+        graph.import_resource("late");
+        graph.write("late");
+
+        const frame_graph_report& report = graph.compile(framebufferSize);
+
+        CHECK(graph.is_alive(setup));
+        CHECK_FALSE(graph.is_alive(unused));
+        CHECK(graph.is_alive(producer));
+        CHECK(graph.is_alive(consumer));
+        CHECK(graph.is_alive(history));
+        CHECK(graph.is_alive(unknown));
+        CHECK(graph.is_alive(present));
+        CHECK_FALSE(graph.is_alive(afterPresent));
+        CHECK_EQ(report.passes, 8);
+        CHECK_EQ(report.culledPasses, 2);
+
+        // Resources of culled passes get no memory, imported resources are never aliased.
+        CHECK_EQ(graph.physical_index("unused output"), FrameGraph::invalid_index);
+        CHECK_EQ(graph.physical_index("color"), FrameGraph::invalid_index);
+        CHECK_NE(graph.physical_index("intermediate"), FrameGraph::invalid_index);
+        CHECK_EQ(graph.lifetime("intermediate"), std::make_pair(producer, consumer));
+        CHECK_EQ(report.transientResources, 1);
+    }
+
+    SUBCASE("a pass is culled when its output is only read by earlier passes")
+    {
+        graph.add_pass("reader");
+        graph.read("feedback");
+        graph.side_effect();
+
+        const size_type writer = graph.add_pass("writer");
+        graph.create("feedback", hdrTexture);
+
+        graph.compile(framebufferSize);
+        CHECK_FALSE(graph.is_alive(writer));
+    }
+
+    SUBCASE("transient textures with disjoint lifetimes share memory")
+    {
+        graph.add_pass("a");
+        graph.create("a0", hdrTexture);
+        graph.create("a1", hdrTexture);
+        graph.create("a depth", depthTexture);
+        graph.side_effect();
+
+        graph.add_pass("b");
+        graph.create("b0", hdrTexture);
+        graph.create("b half", halfHdrTexture);
+        graph.read("a1");
+        graph.side_effect();
+
+        graph.add_pass("c");
+        graph.create("c0", hdrTexture);
+        graph.create("c depth", depthTexture);
+        graph.read("b half");
+        graph.side_effect();
+
+        const frame_graph_report& report = graph.compile(framebufferSize);
+
+        const size_type a0 = graph.physical_index("a0");
+        const size_type a1 = graph.physical_index("a1");
+        const size_type b0 = graph.physical_index("b0");
+        const size_type bHalf = graph.physical_index("b half");
+        const size_type c0 = graph.physical_index("c0");
+
+        // Overlapping lifetimes never share.
+        CHECK_NE(a0, a1);
+        CHECK_NE(b0, a1);
+        CHECK_NE(c0, bHalf);
+
+        // a0 is dead after the first pass, a1 after the second.
+        CHECK_EQ(b0, a0);
+        CHECK((c0 == a1 || c0 == a0));
+
+        // Different formats and scales never share.
+        CHECK_NE(graph.physical_index("c depth"), c0);
+        CHECK_EQ(graph.physical_index("c depth"), graph.physical_index("a depth"));
+        CHECK_NE(bHalf, a0);
+        CHECK_NE(bHalf, a1);
+
+        const size_type full = hdrTexture.bytes(framebufferSize);
+        const size_type half = halfHdrTexture.bytes(framebufferSize);
+        const size_type depth = depthTexture.bytes(framebufferSize);
+        CHECK_EQ(full, 1920 * 1080 * 16 + 1920 * 1080 * 16 / 3);
+        CHECK_EQ(report.transientResources, 7);
+        CHECK_EQ(report.physicalResources, 4);
+        CHECK_EQ(report.virtualBytes, full * 4 + half + depth * 2);
+        CHECK_EQ(report.physicalBytes, full * 2 + half + depth);
+        CHECK_EQ(report.savedBytes(), full * 2 + depth);
+    }
+
+    SUBCASE("buffers share with any buffer and grow to the largest")
+    {
+        frame_resource_desc small;
+        small.type = frame_resource_type::buffer;
+        small.bufferSize = 256;
+
+        frame_resource_desc large = small;
+        large.bufferSize = 1024;
+
+        graph.add_pass("a");
+        graph.create("small", small);
+        graph.side_effect();
+
+        graph.add_pass("b");
+        graph.create("large", large);
+        graph.side_effect();
+
+        graph.add_pass("c");
+        graph.create("small again", small);
+        graph.create("other small", small);
+        graph.side_effect();
+
+        const frame_graph_report& report = graph.compile(framebufferSize);
+
+        const size_type shared = graph.physical_index("small");
+        CHECK_EQ(graph.physical_index("large"), shared);
+        CHECK_EQ(graph.physical_desc(shared).bufferSize, 1024);
+        CHECK_EQ(report.physicalResources, 2);
+        CHECK_EQ(report.virtualBytes, 256 * 3 + 1024);
+        CHECK_EQ(report.physicalBytes, 1024 + 256);
+    }
+
+    SUBCASE("the default pipeline aliases the textures of bloom and depth of field")
+    {
+        // Mirrors what the stages and effects of the default pipeline declare.
+        const char* attachments[] = { "scene color", "scene normal", "scene position", "HDR overdraw", "scene depth" };
+
+        graph.add_pass("ClearStage");
+        for (auto* attachment : attachments)
+            graph.write(attachment);
+
+        graph.add_pass("FramebufferResizeStage");
+        for (auto* attachment : attachments)
+        {
+            graph.import_resource(attachment);
+            graph.write(attachment);
+        }
+        graph.import_resource("HDR overdraw history", true);
+        graph.write("HDR overdraw history");
+
+        graph.add_pass("MeshRenderStage");
+        graph.read("scene depth");
+        for (auto* attachment : attachments)
+            graph.write(attachment);
+
+        graph.add_pass("Bloom");
+        graph.read("scene color");
+        graph.read("HDR overdraw");
+        graph.read("HDR overdraw history");
+        graph.write("scene color");
+        graph.create("bloom blur 0", hdrTexture);
+        graph.create("bloom blur 1", hdrTexture);
+
+        graph.add_pass("DepthOfField");
+        graph.read("scene color");
+        graph.read("scene position");
+        graph.write("scene color");
+        graph.create("dof threshold", hdrTexture);
+        graph.create("dof destination", hdrTexture);
+        graph.create("dof bokeh 0", halfHdrTexture);
+        graph.create("dof bokeh 1", halfHdrTexture);
+
+        graph.add_pass("SubmitStage");
+        graph.read("scene color");
+        graph.side_effect();
+
+        const frame_graph_report& report = graph.compile(framebufferSize);
+
+        CHECK_EQ(report.culledPasses, 0);
+        CHECK_EQ(report.transientResources, 6);
+        CHECK_EQ(report.physicalResources, 4);
+        CHECK_EQ(report.savedBytes(), hdrTexture.bytes(framebufferSize) * 2);
+        CHECK_EQ(graph.physical_index("dof threshold"), graph.physical_index("bloom blur 0"));
+        CHECK_EQ(graph.physical_index("dof destination"), graph.physical_index("bloom blur 1"));
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <core/math/math.hpp>
+#include <core/math/frustum.hpp>
+
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[core:ut] view frustum")
+{
+    using namespace ::legion::core;
+
+    //90 degree fov looking down +z from the origin, glm is left handed with a 0 to 1 depth range
+    const math::mat4 proj = math::perspective(math::deg2rad(90.f), 1.f, 1.f, 10.f);
+    const math::view_frustum frustum = math::view_frustum::from_view_projection(proj);
+
+    auto checkPlane = [](const math::vec4& plane, const math::vec4& expected)
+    {
+        CHECK_EQ(plane.x, doctest::Approx(expected.x));
+        CHECK_EQ(plane.y, doctest::Approx(expected.y));
+        CHECK_EQ(plane.z, doctest::Approx(expected.z));
+        CHECK_EQ(plane.w, doctest::Approx(expected.w));
+    };
+
+    SUBCASE("plane extraction")
+    {
+        const float diagonal = 1.f / math::sqrt(2.f);
+        checkPlane(frustum.planes[0], math::vec4(diagonal, 0.f, diagonal, 0.f));  // Left
+        checkPlane(frustum.planes[1], math::vec4(-diagonal, 0.f, diagonal, 0.f)); // Right
+        checkPlane(frustum.planes[2], math::vec4(0.f, diagonal, diagonal, 0.f));  // Bottom
+        checkPlane(frustum.planes[3], math::vec4(0.f, -diagonal, diagonal, 0.f)); // Top
+        checkPlane(frustum.planes[4], math::vec4(0.f, 0.f, 1.f, -1.f));           // Near
+        checkPlane(frustum.planes[5], math::vec4(0.f, 0.f, -1.f, 10.f));          // Far
+
+        //reversed depth swaps the near and far plane
+        const math::view_frustum reversed = math::view_frustum::from_view_projection(math::perspective(math::deg2rad(90.f), 1.f, 10.f, 1.f));
+        checkPlane(reversed.planes[4], math::vec4(0.f, 0.f, -1.f, 10.f));
+        checkPlane(reversed.planes[5], math::vec4(0.f, 0.f, 1.f, -1.f));
+
+        //the planes move with the camera, a camera at z = 5 sees from z = 6 up to z = 15
+        const math::mat4 view = math::translate(math::mat4(1.f), math::vec3(0.f, 0.f, -5.f));
+        const math::view_frustum moved = math::view_frustum::from_view_projection(proj * view);
+        checkPlane(moved.planes[4], math::vec4(0.f, 0.f, 1.f, -6.f));
+        checkPlane(moved.planes[5], math::vec4(0.f, 0.f, -1.f, 15.f));
+    }
+
+    SUBCASE("spheres")
+    {
+        CHECK(frustum.intersects_sphere(math::vec3(0.f, 0.f, 5.f), 1.f));
+        CHECK(frustum.intersects_sphere(math::vec3(0.f, 0.f, 5.f), 0.f));
+
+        //outside of a single plane
+        CHECK_FALSE(frustum.intersects_sphere(math::vec3(0.f, 0.f, 20.f), 1.f));
+        CHECK_FALSE(frustum.intersects_sphere(math::vec3(0.f, 0.f, -2.f), 1.f));
+        CHECK_FALSE(frustum.intersects_sphere(math::vec3(-10.f, 0.f, 5.f), 1.f));
+        CHECK_FALSE(frustum.intersects_sphere(math::vec3(0.f, 10.f, 5.f), 1.f));
+
+        //straddling the far, near and left plane
+        CHECK(frustum.intersects_sphere(math::vec3(0.f, 0.f, 10.5f), 1.f));
+        CHECK(frustum.intersects_sphere(math::vec3(0.f, 0.f, 0.5f), 1.f));
+        CHECK(frustum.intersects_sphere(math::vec3(-5.5f, 0.f, 5.f), 1.f));
+    }
+
+    SUBCASE("boxes")
+    {
+        //inside
+        CHECK(frustum.intersects_aabb(math::vec3(-1.f, -1.f, 4.f), math::vec3(1.f, 1.f, 6.f)));
+        CHECK(frustum.contains_aabb(math::vec3(-1.f, -1.f, 4.f), math::vec3(1.f, 1.f, 6.f)));
+
+        //outside
+        CHECK_FALSE(frustum.intersects_aabb(math::vec3(20.f, -1.f, 4.f), math::vec3(22.f, 1.f, 6.f)));
+        CHECK_FALSE(frustum.contains_aabb(math::vec3(20.f, -1.f, 4.f), math::vec3(22.f, 1.f, 6.f)));
+        CHECK_FALSE(frustum.intersects_aabb(math::vec3(-1.f, -1.f, -3.f), math::vec3(1.f, 1.f, -2.f)));
+
+        //straddling the near plane, the right plane, and bigger than the whole frustum
+        CHECK(frustum.intersects_aabb(math::vec3(-0.5f, -0.5f, 0.5f), math::vec3(0.5f, 0.5f, 1.5f)));
+        CHECK_FALSE(frustum.contains_aabb(math::vec3(-0.5f, -0.5f, 0.5f), math::vec3(0.5f, 0.5f, 1.5f)));
+        CHECK(frustum.intersects_aabb(math::vec3(4.f, -1.f, 4.f), math::vec3(6.f, 1.f, 6.f)));
+        CHECK_FALSE(frustum.contains_aabb(math::vec3(4.f, -1.f, 4.f), math::vec3(6.f, 1.f, 6.f)));
+        CHECK(frustum.intersects_aabb(math::vec3(-100.f), math::vec3(100.f)));
+        CHECK_FALSE(frustum.contains_aabb(math::vec3(-100.f), math::vec3(100.f)));
+    }
+
+    SUBCASE("culling a batch of spheres matches testing them one by one")
+    {
+        std::mt19937 generator(99);
+        std::uniform_real_distribution<float> position(-12.f, 12.f);
+        std::uniform_real_distribution<float> radius(0.f, 3.f);
+
+        //counts that are not a multiple of 4 leave spheres for the scalar tail
+        for (size_type count : { 0u, 1u, 3u, 4u, 5u, 7u, 8u, 13u, 64u, 1001u })
+        {
+            std::vector<float> x(count), y(count), z(count), r(count);
+            for (size_type i = 0; i < count; i++)
+            {
+                x[i] = position(generator);
+                y[i] = position(generator);
+                z[i] = position(generator);
+                r[i] = radius(generator);
+            }
+
+            std::vector<byte> visible(count, 2);
+            frustum.cull_spheres(x.data(), y.data(), z.data(), r.data(), count, visible.data());
+
+            size_type mismatches = 0;
+            for (size_type i = 0; i < count; i++)
+                if (visible[i] != (frustum.intersects_sphere(math::vec3(x[i], y[i], z[i]), r[i]) ? 1 : 0))
+                    mismatches++;
+            CHECK_EQ(mismatches, 0);
+        }
+    }
+}
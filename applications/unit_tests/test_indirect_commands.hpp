@@ -0,0 +1,164 @@
+#pragma once
+#include <rendering/util/indirect_commands.hpp>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] indirect commands from instance batches")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    // Two packed models, one with two sub-meshes, and a model that isn't packed.
+    constexpr id_type materialA = 10;
+    constexpr id_type materialB = 20;
+    constexpr id_type cube = 100;
+    constexpr id_type character = 200;
+    constexpr id_type particles = 300;
+
+    mesh_pack_layout layout;
+    layout.add(cube, 24, 36, { sub_mesh{ "cube", 36, 0 } });
+    layout.add(character, 1000, 3000, { sub_mesh{ "body", 2400, 0 }, sub_mesh{ "head", 600, 2400 } });
+
+    const packed_model* packedCharacter = layout.get(character);
+    REQUIRE(packedCharacter != nullptr);
+    CHECK_EQ(packedCharacter->baseVertex, 24);
+    CHECK_EQ(packedCharacter->firstIndex, 36);
+    CHECK_EQ(packedCharacter->submeshes[1].firstIndex, 36 + 2400);
+    CHECK_EQ(layout.get(particles), nullptr);
+
+    // Batch renderables serially, like the renderer does on the job system.
+    std::vector<batch_instance> renderables = {
+        { true, materialB, cube, 0.5f },
+        { true, materialA, character, 0.2f },
+        { false, materialA, cube, 0.1f },
+        { true, materialA, cube, 0.3f },
+        { true, materialB, particles, 0.1f },
+        { true, materialA, character, 0.1f },
+        { true, materialA, cube, 0.9f },
+    };
+    std::vector<math::mat4> worldMatrices(renderables.size(), math::mat4(1.f));
+    std::vector<math::mat4> instances(renderables.size());
+
+    InstanceBatcher batcher;
+    instance_batches batches;
+    batcher.build(renderables.size(), worldMatrices.data(), [&](size_type i) { return renderables[i]; },
+        [&](size_type, size_type& firstInstance) { firstInstance = 16; return instances.data(); },
+        [](size_type jobCount, auto&& func) { for (size_type job = 0; job < jobCount; job++) func(job); }, batches);
+
+    REQUIRE_EQ(batches.instanceCount, 6);
+
+    indirect_draw_list drawList;
+    build_indirect_commands(batches, [&](id_type model) { return layout.get(model); }, [](id_type material) { return material + 1; }, drawList);
+
+    // Every range of a packed model becomes a command per sub-mesh, grouped per material.
+    REQUIRE_EQ(drawList.groups.size(), 2);
+    REQUIRE_EQ(drawList.unpacked.size(), 1);
+    CHECK_EQ(drawList.unpacked[0].model, particles);
+
+    size_type commandCount = 0;
+    for (auto& group : drawList.groups)
+    {
+        CHECK_EQ(group.variant, group.material + 1);
+        CHECK_EQ(group.firstCommand, commandCount);
+        commandCount += group.commandCount;
+
+        for (size_type i = group.firstCommand; i < group.firstCommand + group.commandCount; i++)
+        {
+            auto& command = drawList.commands[i];
+            CHECK_GE(command.baseInstance, 16);
+            CHECK_LE(command.baseInstance + command.instanceCount, 16 + batches.instanceCount);
+        }
+    }
+    CHECK_EQ(commandCount, drawList.commands.size());
+
+    // Material A draws the cube once and both sub-meshes of the character, material B only draws the cube.
+    size_type groupA = drawList.groups[0].material == materialA ? 0 : 1;
+    CHECK_EQ(drawList.groups[groupA].commandCount, 3);
+    CHECK_EQ(drawList.groups[1 - groupA].commandCount, 1);
+
+    for (size_type i = drawList.groups[groupA].firstCommand; i < drawList.groups[groupA].firstCommand + 3; i++)
+    {
+        auto& command = drawList.commands[i];
+        if (command.baseVertex == 0)
+        {
+            CHECK_EQ(command.count, 36);
+            CHECK_EQ(command.instanceCount, 2);
+        }
+        else
+        {
+            CHECK_EQ(command.baseVertex, 24);
+            CHECK_EQ(command.instanceCount, 2);
+        }
+    }
+}
+
+TEST_CASE("[rendering:ut] mesh pack layout reuses the space of removed models")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    mesh_pack_layout layout;
+    layout.add(1, 100, 300, { sub_mesh{ "a", 300, 0 } });
+    layout.add(2, 50, 150, { sub_mesh{ "b", 150, 0 } });
+    layout.add(3, 100, 300, { sub_mesh{ "c", 300, 0 } });
+    layout.add(4, 10, 30, { sub_mesh{ "d", 30, 0 } });
+    REQUIRE_EQ(layout.vertex_count(), 260);
+    REQUIRE_EQ(layout.index_count(), 780);
+
+    SUBCASE("removed models leave gaps that later models fill")
+    {
+        layout.remove(2);
+        CHECK_EQ(layout.get(2), nullptr);
+        CHECK_EQ(layout.vertex_count(), 260);
+        CHECK_EQ(layout.free_vertex_count(), 50);
+        CHECK_EQ(layout.free_index_count(), 150);
+
+        // Fits in the gap, and the sub-meshes move along with the model.
+        const packed_model& fits = layout.add(5, 40, 120, { sub_mesh{ "e", 20, 0 }, sub_mesh{ "f", 100, 20 } });
+        CHECK_EQ(fits.baseVertex, 100);
+        CHECK_EQ(fits.firstIndex, 300);
+        CHECK_EQ(fits.submeshes[1].firstIndex, 320);
+        CHECK_EQ(layout.free_vertex_count(), 10);
+        CHECK_EQ(layout.vertex_count(), 260);
+
+        // Too large for what is left of the gap.
+        const packed_model& tooLarge = layout.add(6, 20, 60, { sub_mesh{ "g", 60, 0 } });
+        CHECK_EQ(tooLarge.baseVertex, 260);
+        CHECK_EQ(tooLarge.firstIndex, 780);
+        CHECK_EQ(layout.vertex_count(), 280);
+    }
+
+    SUBCASE("neighbouring gaps are merged and gaps at the end shrink the buffers")
+    {
+        layout.remove(1);
+        layout.remove(3);
+        layout.remove(2);
+        CHECK_EQ(layout.free_vertex_count(), 250);
+
+        const packed_model& merged = layout.add(5, 250, 750, { sub_mesh{ "e", 750, 0 } });
+        CHECK_EQ(merged.baseVertex, 0);
+        CHECK_EQ(merged.firstIndex, 0);
+        CHECK_EQ(layout.free_vertex_count(), 0);
+
+        layout.remove(4);
+        CHECK_EQ(layout.vertex_count(), 250);
+        CHECK_EQ(layout.index_count(), 750);
+        layout.remove(5);
+        CHECK_EQ(layout.vertex_count(), 0);
+        CHECK_EQ(layout.index_count(), 0);
+        CHECK_EQ(layout.free_vertex_count(), 0);
+        CHECK_EQ(layout.free_index_count(), 0);
+    }
+
+    SUBCASE("adding a model again moves it instead of leaking its old space")
+    {
+        layout.add(4, 20, 60, { sub_mesh{ "d", 60, 0 } });
+        CHECK_EQ(layout.get(4)->baseVertex, 250);
+        CHECK_EQ(layout.vertex_count(), 270);
+        CHECK_EQ(layout.free_vertex_count(), 0);
+
+        layout.add(1, 80, 240, { sub_mesh{ "a", 240, 0 } });
+        CHECK_EQ(layout.get(1)->baseVertex, 0);
+        CHECK_EQ(layout.free_vertex_count(), 20);
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include <rendering/util/light_clustering.hpp>
+
+#include <algorithm>
+#include <random>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] light clustering")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    constexpr float nearz = 0.1f;
+    constexpr float farz = 500.f;
+    const math::mat4 proj = math::perspective(math::radians(60.f), 16.f / 9.f, farz, nearz);
+    const math::mat4 view = math::lookAt(math::vec3(10.f, 5.f, -20.f), math::vec3(10.f, 0.f, 50.f), math::vec3(0.f, 1.f, 0.f));
+
+    auto serialJobs = [](size_type jobCount, auto&& func) { for (size_type job = 0; job < jobCount; job++) func(job); };
+
+    LightClusterer clusterer;
+    light_clusters output;
+
+    SUBCASE("every cluster gets exactly the lights that touch its bounds")
+    {
+        // Thousands of small point lights spread through and around the frustum, and a directional light.
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<float> spread(-150.f, 150.f);
+        std::uniform_real_distribution<float> size(0.5f, 8.f);
+
+        std::vector<light_sphere> lights;
+        for (size_type i = 0; i < 4000; i++)
+            lights.push_back({ math::vec3(spread(rng) + 10.f, spread(rng) * 0.2f, spread(rng) + 130.f), size(rng) });
+        lights.push_back({ math::vec3(0.f), std::numeric_limits<float>::max() });
+
+        clusterer.build(lights.data(), lights.size(), view, proj, nearz, farz, serialJobs, output);
+
+        REQUIRE_EQ(output.clusters.size(), clusterer.cluster_count());
+        REQUIRE_EQ(output.params.grid.w, 1);
+        CHECK_EQ(output.indices[0], lights.size() - 1);
+
+        // Compare against testing every light against every cluster one at a time.
+        size_type mismatches = 0;
+        size_type assigned = 0;
+        std::vector<uint32> expected;
+        for (size_type cluster = 0; cluster < output.clusters.size(); cluster++)
+        {
+            math::vec3 min, max;
+            clusterer.cluster_bounds(cluster, min, max);
+
+            expected.clear();
+            for (size_type i = 0; i + 1 < lights.size(); i++)
+            {
+                const math::vec3 center = math::vec3(view * math::vec4(lights[i].position, 1.f));
+                if (center.z + lights[i].radius < nearz || center.z - lights[i].radius > farz)
+                    continue;
+
+                const math::vec3 closest = math::clamp(center, min, max);
+                if (math::length2(center - closest) <= lights[i].radius * lights[i].radius)
+                    expected.push_back(static_cast<uint32>(i));
+            }
+
+            auto& range = output.clusters[cluster];
+            REQUIRE_LE(range.offset + range.count, output.indices.size());
+            std::vector<uint32> actual(output.indices.begin() + range.offset, output.indices.begin() + range.offset + range.count);
+            std::sort(actual.begin(), actual.end());
+
+            if (actual != expected)
+                mismatches++;
+            assigned += actual.size();
+        }
+
+        CHECK_EQ(mismatches, 0);
+        CHECK_GT(assigned, 0);
+
+        // The cluster a light's center falls in, found the way the shaders do it, always holds that light.
+        for (size_type i = 0; i + 1 < lights.size(); i++)
+        {
+            const math::vec3 center = math::vec3(view * math::vec4(lights[i].position, 1.f));
+            const math::vec4 clip = proj * math::vec4(center, 1.f);
+            if (center.z < nearz || center.z > farz || math::abs(clip.x) > clip.w || math::abs(clip.y) > clip.w)
+                continue;
+
+            auto& range = output.clusters[clusterer.find_cluster(center)];
+            auto first = output.indices.begin() + range.offset;
+            CHECK(std::find(first, first + range.count, static_cast<uint32>(i)) != first + range.count);
+        }
+    }
+
+    SUBCASE("lights outside of the depth range are never assigned")
+    {
+        std::vector<light_sphere> lights = {
+            { math::vec3(10.f, 0.f, -40.f), 5.f },
+            { math::vec3(10.f, 0.f, 1000.f), 5.f },
+            { math::vec3(10.f, 0.f, 0.f), 0.f },
+        };
+
+        clusterer.build(lights.data(), lights.size(), view, proj, nearz, farz, serialJobs, output);
+        CHECK_EQ(output.params.grid.w, 0);
+        CHECK(output.indices.empty());
+        for (auto& range : output.clusters)
+            CHECK_EQ(range.count, 0);
+    }
+
+    SUBCASE("slices grow exponentially and cover the whole depth range")
+    {
+        std::vector<light_sphere> lights;
+        clusterer.build(lights.data(), lights.size(), view, proj, nearz, farz, serialJobs, output);
+
+        CHECK_EQ(clusterer.find_slice(nearz), 0);
+        CHECK_EQ(clusterer.find_slice(farz * 2.f), LightClusterer::default_slices - 1);
+
+        float lastDepth = 0.f;
+        for (uint32 slice = 1; slice < LightClusterer::default_slices; slice++)
+        {
+            const size_type cluster = slice * LightClusterer::default_tiles_x * LightClusterer::default_tiles_y;
+            math::vec3 min, max;
+            clusterer.cluster_bounds(cluster, min, max);
+            CHECK_EQ(clusterer.find_slice(min.z * 1.001f), slice);
+            CHECK_GT(max.z - min.z, lastDepth);
+            lastDepth = max.z - min.z;
+        }
+    }
+
+    SUBCASE("flat output puts every light in front of a single cluster")
+    {
+        clusterer.build_flat(5, output);
+        CHECK_EQ(output.params.grid, math::uvec4(1, 1, 1, 5));
+        REQUIRE_EQ(output.clusters.size(), 1);
+        CHECK_EQ(output.clusters[0].count, 0);
+        CHECK_EQ(output.indices, std::vector<uint32>{ 0, 1, 2, 3, 4 });
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <rendering/util/lod_selection.hpp>
+#include <rendering/components/lod.hpp>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] lod selection")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    const lod_view view = lod_view::from_fov(math::vec3(0.f), lod::reference_fov);
+
+    SUBCASE("screen size")
+    {
+        // A sphere covering the whole height of a 90 degree fov, its radius covers half of it.
+        const lod_view wide = lod_view::from_fov(math::vec3(0.f), 90.f);
+        CHECK(lod_screen_size(math::vec3(0.f, 0.f, math::sqrt(2.f)), 1.f, wide) == doctest::Approx(1.f));
+
+        // The same fraction of the height as the sphere covers after projecting it, clip space is 2 high.
+        const math::mat4 proj = math::perspective(math::deg2rad(lod::reference_fov), 16.f / 9.f, 0.1f, 1000.f);
+        const math::vec4 top = proj * math::vec4(0.f, 1.f, 50.f, 1.f);
+        const math::vec4 bottom = proj * math::vec4(0.f, -1.f, 50.f, 1.f);
+        const float projectedHeight = (top.y / top.w - bottom.y / bottom.w) * 0.5f;
+        CHECK(lod_screen_size(math::vec3(0.f, 0.f, 50.f), 1.f, view) == doctest::Approx(projectedHeight).epsilon(0.001));
+
+        // The least detailed level starts at the screen size of the bounds at maxDistance.
+        const lod lodComponent(8, 40.f, 2.f);
+        CHECK(lod_screen_size(math::vec3(0.f, 0.f, 40.f), 2.f, view) == doctest::Approx(lodComponent.minScreenSize).epsilon(0.002));
+
+        // Twice as far away is half as large, zooming in makes it larger.
+        const float near = lod_screen_size(math::vec3(0.f, 0.f, 100.f), 1.f, view);
+        CHECK(lod_screen_size(math::vec3(0.f, 0.f, 200.f), 1.f, view) == doctest::Approx(near * 0.5f).epsilon(0.001));
+        CHECK_GT(lod_screen_size(math::vec3(0.f, 0.f, 100.f), 1.f, lod_view::from_fov(math::vec3(0.f), 30.f)), near);
+
+        // The camera inside of the bounds.
+        CHECK_EQ(lod_screen_size(math::vec3(0.f, 0.f, 0.5f), 1.f, view), std::numeric_limits<float>::max());
+    }
+
+    SUBCASE("levels are spread linearly over the distance at the reference fov")
+    {
+        const lod lodComponent(8, 80.f);
+
+        // Without hysteresis the level is the distance divided by 10.
+        for (int distance = 2; distance < 80; distance += 5)
+        {
+            const float size = lod_screen_size(math::vec3(static_cast<float>(distance), 0.f, 0.f), lodComponent.radius, view);
+            CHECK_EQ(select_lod_level(-1, lodComponent.MaxLod, size, lodComponent.minScreenSize, 0.f), distance / 10);
+        }
+
+        // Past the max distance the least detailed level is used.
+        const float farSize = lod_screen_size(math::vec3(1000.f, 0.f, 0.f), lodComponent.radius, view);
+        CHECK_EQ(select_lod_level(0, lodComponent.MaxLod, farSize, lodComponent.minScreenSize, 0.f), 7);
+        CHECK_EQ(select_lod_level(0, lodComponent.MaxLod, 0.f, lodComponent.minScreenSize, 0.f), 7);
+
+        // Larger objects keep their detail for longer.
+        const lod large(8, 80.f, 2.f);
+        const float largeSize = lod_screen_size(math::vec3(45.f, 0.f, 0.f), 4.f, view);
+        CHECK_EQ(select_lod_level(-1, large.MaxLod, largeSize, large.minScreenSize, 0.f), 2);
+
+        CHECK_EQ(select_lod_level(3, 1, farSize, lodComponent.minScreenSize, 0.f), 0);
+    }
+
+    SUBCASE("hysteresis keeps the level near a boundary")
+    {
+        const lod lodComponent(8, 80.f);
+        auto select = [&](int current, float distance)
+        {
+            const float size = lod_screen_size(math::vec3(0.f, distance, 0.f), lodComponent.radius, view);
+            return select_lod_level(current, lodComponent.MaxLod, size, lodComponent.minScreenSize, 0.2f);
+        };
+
+        // Moving back and forth over the boundary between level 2 and 3 at 30 units.
+        CHECK_EQ(select(2, 29.f), 2);
+        CHECK_EQ(select(2, 31.f), 2);
+        CHECK_EQ(select(2, 31.5f), 2);
+        CHECK_EQ(select(2, 32.5f), 3);
+        CHECK_EQ(select(3, 31.f), 3);
+        CHECK_EQ(select(3, 29.f), 3);
+        CHECK_EQ(select(3, 27.5f), 2);
+
+        // Large jumps go straight to the right level.
+        CHECK_EQ(select(2, 65.f), 6);
+        CHECK_EQ(select(6, 5.f), 0);
+    }
+}
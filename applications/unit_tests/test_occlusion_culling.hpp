@@ -0,0 +1,215 @@
+#pragma once
+#include <rendering/util/occlusion_buffer.hpp>
+
+#include <cmath>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] occlusion culling")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    //same reversed depth projection as the camera component, looking down -z from the origin
+    const math::mat4 view = math::lookAt(math::vec3(0.f), math::vec3(0.f, 0.f, -1.f), math::vec3(0.f, 1.f, 0.f));
+    const math::mat4 proj = math::perspective(math::deg2rad(60.f), 2.f, 1000.f, 0.1f);
+    const math::mat4 viewProjection = proj * view;
+
+    //a wall of 20x20 at a distance of 10, as a quad of 2 triangles
+    const std::vector<math::vec3> quadVertices{ { -1.f, -1.f, 0.f }, { 1.f, -1.f, 0.f }, { 1.f, 1.f, 0.f }, { -1.f, 1.f, 0.f } };
+    const std::vector<uint> quadIndices{ 0, 1, 2, 0, 2, 3 };
+    const math::mat4 wallMatrix = math::translate(math::mat4(1.f), math::vec3(0.f, 0.f, -10.f)) * math::scale(math::mat4(1.f), math::vec3(10.f));
+
+    occlusion_buffer buffer(math::ivec2(100, 50));
+    const occluder_mesh wall{ quadVertices.data(), quadVertices.size(), quadIndices.data(), quadIndices.size(), wallMatrix };
+    buffer.rasterize(viewProjection, &wall, 1);
+
+    auto boxVisible = [&](const math::vec3& center, float halfSize)
+    {
+        return buffer.is_visible(viewProjection, center - halfSize, center + halfSize);
+    };
+
+    SUBCASE("hierarchical-Z")
+    {
+        REQUIRE_EQ(buffer.size(), math::ivec2(100, 50));
+        REQUIRE_EQ(buffer.level_count(), 8);
+        CHECK_EQ(buffer.level_size(1), math::ivec2(50, 25));
+        CHECK_EQ(buffer.level_size(2), math::ivec2(25, 13));
+        CHECK_EQ(buffer.level_size(7), math::ivec2(1, 1));
+
+        //the wall is in front of the camera, so the center is covered with the depth of the wall
+        const math::vec4 wallClip = viewProjection * math::vec4(0.f, 0.f, -10.f, 1.f);
+        CHECK_EQ(buffer.depth(0, 50, 25), doctest::Approx(wallClip.z / wallClip.w));
+        CHECK_EQ(buffer.depth(0, 0, 0), 0.f);
+
+        //every texel holds the farthest depth of the pixels below it
+        for (size_type level = 1; level < buffer.level_count(); level++)
+        {
+            const math::ivec2 size = buffer.level_size(level);
+            for (int y = 0; y < size.y; y++)
+                for (int x = 0; x < size.x; x++)
+                {
+                    float farthest = 1.f;
+                    for (int pixelY = y << level; pixelY < math::min((y + 1) << level, 50); pixelY++)
+                        for (int pixelX = x << level; pixelX < math::min((x + 1) << level, 100); pixelX++)
+                            farthest = math::min(farthest, buffer.depth(0, pixelX, pixelY));
+                    CHECK_EQ(buffer.depth(level, x, y), farthest);
+                }
+        }
+    }
+
+    SUBCASE("boxes behind the wall are occluded")
+    {
+        CHECK_FALSE(boxVisible(math::vec3(0.f, 0.f, -20.f), 1.f));
+        CHECK_FALSE(boxVisible(math::vec3(3.f, -2.f, -50.f), 5.f));
+
+        //in front of the wall, peeking out past its side, partially in front of it, or bigger than it
+        CHECK(boxVisible(math::vec3(0.f, 0.f, -5.f), 1.f));
+        CHECK(boxVisible(math::vec3(25.f, 0.f, -20.f), 3.f));
+        CHECK(boxVisible(math::vec3(0.f, 0.f, -10.f), 1.f));
+        CHECK(boxVisible(math::vec3(0.f, 0.f, -40.f), 30.f));
+
+        //around the camera, and behind it
+        CHECK(boxVisible(math::vec3(0.f), 1.f));
+        CHECK(boxVisible(math::vec3(0.f, 0.f, 20.f), 1.f));
+
+        //nothing is occluded without occluders
+        buffer.rasterize(viewProjection, nullptr, 0);
+        CHECK(boxVisible(math::vec3(0.f, 0.f, -20.f), 1.f));
+    }
+
+    SUBCASE("occluders through the near plane")
+    {
+        //a floor that starts behind the camera, only the part in front of the camera is rasterized
+        const math::mat4 floorMatrix = math::translate(math::mat4(1.f), math::vec3(0.f, -1.f, 0.f)) * math::rotate(math::mat4(1.f), math::deg2rad(-90.f), math::vec3(1.f, 0.f, 0.f)) * math::scale(math::mat4(1.f), math::vec3(50.f));
+        const occluder_mesh floor{ quadVertices.data(), quadVertices.size(), quadIndices.data(), quadIndices.size(), floorMatrix };
+        buffer.rasterize(viewProjection, &floor, 1);
+
+        CHECK_FALSE(boxVisible(math::vec3(0.f, -5.f, -20.f), 1.f));
+        CHECK(boxVisible(math::vec3(0.f, 2.f, -20.f), 1.f));
+
+        //the bottom row sees the floor close to the camera
+        const float distance = 1.f / ((1.f - 1.f / 50.f) * std::tan(math::deg2rad(30.f)));
+        const math::vec4 floorClip = viewProjection * math::vec4(0.f, -1.f, -distance, 1.f);
+        CHECK_EQ(buffer.depth(0, 50, 0), doctest::Approx(floorClip.z / floorClip.w).epsilon(0.01));
+    }
+
+    SUBCASE("matches rasterizing pixel by pixel")
+    {
+        std::mt19937 generator(7);
+        std::uniform_real_distribution<float> distribution(-15.f, 15.f);
+        std::uniform_real_distribution<float> depthDistribution(-40.f, -2.f);
+
+        std::vector<math::vec3> vertices;
+        std::vector<uint> indices;
+        for (uint i = 0; i < 300; i++)
+        {
+            vertices.emplace_back(distribution(generator), distribution(generator), depthDistribution(generator));
+            indices.push_back(i);
+            if (i % 3 == 2)
+            {
+                //keep the triangles small enough that they don't cover everything
+                vertices[i - 1] = vertices[i - 2] + (vertices[i - 1] - vertices[i - 2]) * 0.2f;
+                vertices[i] = vertices[i - 2] + (vertices[i] - vertices[i - 2]) * 0.2f;
+            }
+        }
+
+        const occluder_mesh mesh{ vertices.data(), vertices.size(), indices.data(), indices.size(), math::mat4(1.f) };
+        occlusion_buffer serial(math::ivec2(123, 61));
+        serial.rasterize(viewProjection, &mesh, 1);
+
+        //closest depth of the triangles that cover the center of every pixel
+        size_type mismatches = 0;
+        size_type covered = 0;
+        for (int y = 0; y < 61; y++)
+            for (int x = 0; x < 123; x++)
+            {
+                const math::vec2 center(x + 0.5f, y + 0.5f);
+                float expected = 0.f;
+                for (size_type triangle = 0; triangle < indices.size(); triangle += 3)
+                {
+                    math::vec3 screen[3];
+                    for (int i = 0; i < 3; i++)
+                    {
+                        const math::vec4 clip = viewProjection * math::vec4(vertices[indices[triangle + i]], 1.f);
+                        screen[i] = math::vec3((math::vec2(clip) / clip.w * 0.5f + 0.5f) * math::vec2(123.f, 61.f), clip.z / clip.w);
+                    }
+
+                    const math::vec2 ab = math::vec2(screen[1] - screen[0]);
+                    const math::vec2 ac = math::vec2(screen[2] - screen[0]);
+                    const math::vec2 ap = center - math::vec2(screen[0]);
+                    const float area = ab.x * ac.y - ab.y * ac.x;
+                    const float v = (ap.x * ac.y - ap.y * ac.x) / area;
+                    const float w = (ab.x * ap.y - ab.y * ap.x) / area;
+                    if (v >= 0.f && w >= 0.f && v + w <= 1.f)
+                        expected = math::max(expected, screen[0].z + v * (screen[1].z - screen[0].z) + w * (screen[2].z - screen[0].z));
+                }
+
+                if (expected > 0.f)
+                    covered++;
+                if (math::abs(serial.depth(0, x, y) - expected) > 1e-4f)
+                    mismatches++;
+            }
+
+        //pixel centers right on an edge can go either way
+        CHECK_GT(covered, 1000);
+        CHECK_LT(mismatches, 20);
+
+        //bands on other threads give exactly the same buffer
+        occlusion_buffer parallel(math::ivec2(123, 61));
+        parallel.rasterize(viewProjection, &mesh, 1, [](size_type jobCount, auto&& func)
+            {
+                std::vector<std::thread> threads;
+                for (size_type i = 0; i < jobCount; i++)
+                    threads.emplace_back([&func, i]() { func(i); });
+                for (auto& thread : threads)
+                    thread.join();
+            });
+
+        for (size_type level = 0; level < serial.level_count(); level++)
+        {
+            const math::ivec2 size = serial.level_size(level);
+            size_type different = 0;
+            for (int y = 0; y < size.y; y++)
+                for (int x = 0; x < size.x; x++)
+                    if (serial.depth(level, x, y) != parallel.depth(level, x, y))
+                        different++;
+            CHECK_EQ(different, 0);
+        }
+
+        //boxes that are culled are behind every pixel they could cover
+        std::uniform_real_distribution<float> sizeDistribution(0.1f, 3.f);
+        size_type culled = 0;
+        for (int i = 0; i < 2000; i++)
+        {
+            const math::vec3 center(distribution(generator), distribution(generator), depthDistribution(generator) - 5.f);
+            const math::vec3 halfSize(sizeDistribution(generator), sizeDistribution(generator), sizeDistribution(generator));
+            if (serial.is_visible(viewProjection, center - halfSize, center + halfSize))
+                continue;
+
+            culled++;
+            math::vec2 screenMin(1e9f);
+            math::vec2 screenMax(-1e9f);
+            float nearest = 0.f;
+            for (int corner = 0; corner < 8; corner++)
+            {
+                const math::vec3 offset(corner & 1 ? 1.f : -1.f, corner & 2 ? 1.f : -1.f, corner & 4 ? 1.f : -1.f);
+                const math::vec4 clip = viewProjection * math::vec4(center + offset * halfSize, 1.f);
+                const math::vec2 screen = (math::vec2(clip) / clip.w * 0.5f + 0.5f) * math::vec2(123.f, 61.f);
+                screenMin = math::min(screenMin, screen);
+                screenMax = math::max(screenMax, screen);
+                nearest = math::max(nearest, clip.z / clip.w);
+            }
+
+            bool hidden = true;
+            for (int y = math::max(0, static_cast<int>(screenMin.y)); y <= math::min(60, static_cast<int>(screenMax.y)); y++)
+                for (int x = math::max(0, static_cast<int>(screenMin.x)); x <= math::min(122, static_cast<int>(screenMax.x)); x++)
+                    hidden = hidden && serial.depth(0, x, y) > nearest;
+            CHECK(hidden);
+        }
+        CHECK_GT(culled, 0);
+    }
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include <core/data/octree.hpp>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[core:ut] octree")
+{
+    using namespace ::legion::core;
+
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> distribution(-50.f, 50.f);
+
+    constexpr size_type count = 10000;
+    std::vector<math::vec3> positions(count);
+    std::vector<uint32> values(count);
+    for (size_type i = 0; i < count; i++)
+    {
+        positions[i] = math::vec3(distribution(generator), distribution(generator) * 0.5f, distribution(generator));
+        values[i] = static_cast<uint32>(i);
+    }
+
+    // A few points on top of each other, more than fit in a leaf.
+    for (size_type i = 0; i < 20; i++)
+        positions[i] = math::vec3(1.f, 2.f, 3.f);
+
+    octree<uint32> tree(8);
+    tree.build(positions.data(), values.data(), count);
+
+    // Sorted items of a query, mapped back to the input indices.
+    auto toSource = [&](const std::vector<uint32>& items)
+    {
+        std::vector<uint32> result;
+        for (uint32 item : items)
+            result.push_back(tree.source_index(item));
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    auto bruteForce = [&](auto&& predicate)
+    {
+        std::vector<uint32> result;
+        for (size_type i = 0; i < count; i++)
+            if (predicate(positions[i]))
+                result.push_back(static_cast<uint32>(i));
+        return result;
+    };
+
+    SUBCASE("build")
+    {
+        REQUIRE_EQ(tree.size(), count);
+
+        // Every item is in the tree once, with its own value.
+        std::vector<uint32> sources;
+        for (uint32 i = 0; i < count; i++)
+        {
+            CHECK_EQ(tree.value(i), tree.source_index(i));
+            CHECK_EQ(tree.position(i), positions[tree.source_index(i)]);
+            sources.push_back(tree.source_index(i));
+        }
+        std::sort(sources.begin(), sources.end());
+        CHECK(std::adjacent_find(sources.begin(), sources.end()) == sources.end());
+
+        // Children are contiguous, cover the range of their parent and lie inside its bounds.
+        auto& nodes = tree.nodes();
+        for (auto& node : nodes)
+        {
+            if (node.is_leaf())
+            {
+                CHECK((node.itemCount <= 8 || node.depth == octree<uint32>::max_depth));
+                continue;
+            }
+
+            uint32 expectedFirst = node.firstItem;
+            for (uint32 child = node.firstChild; child < node.firstChild + node.childCount; child++)
+            {
+                CHECK_EQ(nodes[child].firstItem, expectedFirst);
+                CHECK_EQ(nodes[child].depth, node.depth + 1);
+                CHECK(math::all(math::greaterThanEqual(nodes[child].min, node.min)));
+                CHECK(math::all(math::lessThanEqual(nodes[child].max, node.max)));
+                expectedFirst += nodes[child].itemCount;
+            }
+            CHECK_EQ(expectedFirst, node.firstItem + node.itemCount);
+        }
+
+        // Building with jobs on other threads gives the same tree.
+        octree<uint32> parallelTree(8);
+        parallelTree.build(positions.data(), values.data(), count, [](size_type jobCount, auto&& func)
+            {
+                std::vector<std::thread> threads;
+                for (size_type i = 0; i < jobCount; i++)
+                    threads.emplace_back([&func, i]() { func(i); });
+                for (auto& thread : threads)
+                    thread.join();
+            });
+
+        REQUIRE_EQ(parallelTree.nodes().size(), nodes.size());
+        for (uint32 i = 0; i < count; i++)
+            CHECK_EQ(parallelTree.source_index(i), tree.source_index(i));
+    }
+
+    SUBCASE("detail levels")
+    {
+        REQUIRE_EQ(tree.detail_level_count(), tree.depth());
+
+        // The levels together hold every item once.
+        std::vector<uint32> all;
+        tree.detail_levels(0, tree.detail_level_count(), all);
+        CHECK_EQ(toSource(all).size(), count);
+        CHECK_EQ(toSource(all), bruteForce([](const math::vec3&) { return true; }));
+
+        // The root picks a sample spread over the whole set, every level adds more.
+        std::vector<uint32> root;
+        tree.detail_levels(0, 1, root);
+        CHECK_EQ(root.size(), 8);
+
+        // Levels only run out at the end, the nodes below the last level with items only hold the stacked points that were all picked already.
+        size_type previous = 0;
+        bool ranOut = false;
+        for (size_type level = 1; level <= tree.detail_level_count(); level++)
+        {
+            std::vector<uint32> upToLevel;
+            tree.detail_levels(0, level, upToLevel);
+            if (upToLevel.size() == previous)
+                ranOut = true;
+            else
+                CHECK_FALSE(ranOut);
+            previous = upToLevel.size();
+        }
+        CHECK_EQ(previous, count);
+
+        std::vector<uint32> none;
+        tree.detail_levels(3, 2, none);
+        tree.detail_levels(100, 200, none);
+        CHECK(none.empty());
+    }
+
+    SUBCASE("radius and box queries")
+    {
+        std::vector<uint32> result;
+        const math::vec3 center(10.f, 0.f, -5.f);
+        tree.query_radius(center, 12.f, result);
+        CHECK_FALSE(result.empty());
+        CHECK_EQ(toSource(result), bruteForce([&](const math::vec3& p) { return math::length2(p - center) <= 144.f; }));
+
+        // A box around everything adds whole nodes without testing their items.
+        result.clear();
+        tree.query_aabb(math::vec3(-100.f), math::vec3(100.f), result);
+        CHECK_EQ(result.size(), count);
+
+        result.clear();
+        const math::vec3 min(-20.f, -5.f, 0.f);
+        const math::vec3 max(5.f, 10.f, 30.f);
+        tree.query_aabb(min, max, result);
+        CHECK_EQ(toSource(result), bruteForce([&](const math::vec3& p)
+            {
+                return math::all(math::greaterThanEqual(p, min)) && math::all(math::lessThanEqual(p, max));
+            }));
+    }
+
+    SUBCASE("k nearest")
+    {
+        const math::vec3 point(1.f, 2.f, 3.5f);
+        std::vector<uint32> result;
+        tree.k_nearest(point, 30, result);
+        REQUIRE_EQ(result.size(), 30);
+
+        // Closest first, and nothing outside of the result is closer than the furthest in it.
+        for (size_type i = 1; i < result.size(); i++)
+            CHECK_LE(math::length2(tree.position(result[i - 1]) - point), math::length2(tree.position(result[i]) - point));
+
+        const float furthest = math::length2(tree.position(result.back()) - point);
+        const auto inside = bruteForce([&](const math::vec3& p) { return math::length2(p - point) < furthest; });
+        CHECK_LT(inside.size(), 30);
+
+        // The stacked points come first.
+        for (size_type i = 0; i < 20; i++)
+            CHECK_LT(tree.source_index(result[i]), 20);
+
+        result.clear();
+        tree.k_nearest(point, count * 2, result);
+        CHECK_EQ(result.size(), count);
+    }
+
+    SUBCASE("frustum query")
+    {
+        const math::mat4 view = math::lookAt(math::vec3(0.f, 0.f, -60.f), math::vec3(0.f), math::vec3(0.f, 1.f, 0.f));
+        const math::mat4 proj = math::perspective(math::deg2rad(60.f), 1.f, 0.1f, 80.f);
+        const math::view_frustum frustum = math::view_frustum::from_view_projection(proj * view);
+
+        std::vector<uint32> result;
+        tree.query_frustum(frustum, result);
+        CHECK_FALSE(result.empty());
+        CHECK_LT(result.size(), count);
+        CHECK_EQ(toSource(result), bruteForce([&](const math::vec3& p) { return frustum.intersects_sphere(p, 0.f); }));
+    }
+
+    SUBCASE("ray query")
+    {
+        const math::vec3 origin(-60.f, 2.f, 3.f);
+        const math::vec3 direction(1.f, 0.f, 0.f);
+
+        std::vector<octree_ray_hit> hits;
+        tree.query_ray(origin, direction, 200.f, 1.5f, hits);
+        REQUIRE_FALSE(hits.empty());
+
+        // Sorted front to back, the first hit is the closest point near the ray.
+        std::vector<uint32> items;
+        for (size_type i = 0; i < hits.size(); i++)
+        {
+            items.push_back(hits[i].item);
+            if (i > 0)
+                CHECK_LE(hits[i - 1].distance, hits[i].distance);
+        }
+
+        const auto expected = bruteForce([&](const math::vec3& p)
+            {
+                const float along = math::clamp(math::dot(p - origin, direction), 0.f, 200.f);
+                return math::length2(origin + direction * along - p) <= 1.5f * 1.5f;
+            });
+        CHECK_EQ(toSource(items), expected);
+
+        // A ray that is too short doesn't reach the points.
+        hits.clear();
+        tree.query_ray(origin, direction, 5.f, 1.5f, hits);
+        CHECK(hits.empty());
+    }
+
+    SUBCASE("empty and degenerate trees")
+    {
+        octree<uint32> empty;
+        empty.build(positions.data(), values.data(), 0);
+        std::vector<uint32> result;
+        empty.k_nearest(math::vec3(0.f), 4, result);
+        empty.query_radius(math::vec3(0.f), 10.f, result);
+        CHECK(result.empty());
+        CHECK_EQ(empty.depth(), 0);
+
+        // Only identical points, the tree can't split them so it stops at the max depth.
+        std::vector<math::vec3> same(100, math::vec3(4.f));
+        octree<uint32> stacked;
+        stacked.build(same.data(), values.data(), same.size());
+        stacked.query_radius(math::vec3(4.f), 0.1f, result);
+        CHECK_EQ(result.size(), 100);
+    }
+}
@@ -0,0 +1,144 @@
+#pragma once
+#include <core/async/parallel_radix_sort.hpp>
+#include <core/async/parallel_jobs.hpp>
+
+#include <algorithm>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "doctest.h"
+
+inline namespace {
+    //runs the jobs one after the other on the calling thread, like the physics does when it is single threaded
+    struct serial_scheduler
+    {
+        struct operation
+        {
+            void wait() const {}
+        };
+
+        template<typename Func>
+        operation queueJobs(::legion::core::size_type count, const Func& func)
+        {
+            ::legion::core::async::job_pool<Func> jobPool(count, func);
+            while (auto* job = jobPool.pop_job())
+            {
+                job->execute();
+                jobPool.complete_job();
+            }
+            return {};
+        }
+    };
+}
+
+TEST_CASE("[core:ut] parallel radix sort")
+{
+    using namespace ::legion::core;
+
+    auto runSerial = [](size_type jobCount, auto&& func)
+    {
+        for (size_type i = 0; i < jobCount; i++)
+            func(i);
+    };
+
+    auto runThreaded = [](size_type jobCount, auto&& func)
+    {
+        std::vector<std::thread> threads;
+        for (size_type i = 0; i < jobCount; i++)
+            threads.emplace_back([&func, i]() { func(i); });
+        for (auto& thread : threads)
+            thread.join();
+    };
+
+    //sorts the keys with both job runners and compares them to a stable sort of the pairs
+    auto checkSort = [&](std::vector<uint64> keys, size_type jobCount)
+    {
+        std::vector<std::pair<uint64, uint32>> expected(keys.size());
+        std::vector<uint32> values(keys.size());
+        for (size_type i = 0; i < keys.size(); i++)
+        {
+            values[i] = static_cast<uint32>(i);
+            expected[i] = { keys[i], values[i] };
+        }
+        std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        async::radix_sort_buffers buffers;
+        std::vector<uint64> threadedKeys = keys;
+        std::vector<uint32> threadedValues = values;
+        async::parallel_radix_sort(keys, values, buffers, jobCount, runSerial);
+        async::parallel_radix_sort(threadedKeys, threadedValues, buffers, jobCount, runThreaded);
+
+        size_type mismatches = 0;
+        for (size_type i = 0; i < expected.size(); i++)
+            if (keys[i] != expected[i].first || values[i] != expected[i].second || threadedKeys[i] != keys[i] || threadedValues[i] != values[i])
+                mismatches++;
+        CHECK_EQ(mismatches, 0);
+    };
+
+    std::mt19937_64 generator(42);
+
+    SUBCASE("random keys")
+    {
+        std::vector<uint64> keys(10000);
+        for (auto& key : keys)
+            key = generator();
+        checkSort(keys, 8);
+    }
+
+    SUBCASE("duplicate keys keep the order of their values")
+    {
+        //few distinct keys that differ in the low and the high bytes, so some passes are skipped and others are not
+        std::vector<uint64> keys(5000);
+        for (auto& key : keys)
+            key = (generator() % 4) << 56 | (generator() % 3);
+        checkSort(keys, 7);
+
+        //every key the same, all passes are skipped
+        checkSort(std::vector<uint64>(1000, 0xdeadbeefull), 4);
+    }
+
+    SUBCASE("counts around the job split")
+    {
+        for (size_type jobCount : { 1u, 3u, 4u, 16u })
+            for (size_type count : { 0u, 1u, 2u, 3u, 4u, 5u, 15u, 16u, 17u, 63u, 64u, 65u, 255u, 256u, 257u })
+            {
+                std::vector<uint64> keys(count);
+                for (auto& key : keys)
+                    key = generator() % 100;
+                checkSort(keys, jobCount);
+            }
+    }
+
+    SUBCASE("job adapters")
+    {
+        serial_scheduler scheduler;
+
+        std::vector<size_type> jobs;
+        async::run_jobs(scheduler, 5, [&](size_type job) { jobs.push_back(job); });
+        async::run_jobs(scheduler, 0, [&](size_type job) { jobs.push_back(job); });
+        CHECK_EQ(jobs, std::vector<size_type>{ 0, 1, 2, 3, 4 });
+
+        //ranges cover every index exactly once, the last range is cut off at the count
+        for (size_type count : { 0u, 1u, 7u, 8u, 9u })
+        {
+            std::vector<int> visits(count, 0);
+            async::for_each_range(scheduler, count, 4, [&](size_type start, size_type end)
+                {
+                    CHECK_LT(start, end);
+                    CHECK_LE(end - start, 4);
+                    for (size_type i = start; i < end; i++)
+                        visits[i]++;
+                });
+            CHECK_EQ(static_cast<size_type>(std::count(visits.begin(), visits.end(), 1)), count);
+        }
+
+        std::vector<uint64> keys{ 5, 3, 9, 3, 1 };
+        std::vector<uint32> values{ 0, 1, 2, 3, 4 };
+        async::radix_sort_buffers buffers;
+        async::parallel_radix_sort(keys, values, buffers, 2, async::job_runner(scheduler));
+        CHECK_EQ(keys, std::vector<uint64>{ 1, 3, 3, 5, 9 });
+        CHECK_EQ(values, std::vector<uint32>{ 4, 1, 3, 0, 2 });
+    }
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <rendering/data/particle_pool.hpp>
+
+#include <algorithm>
+#include <thread>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] particle pool")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    constexpr float infinite = std::numeric_limits<float>::infinity();
+    auto serialJobs = [](size_type jobCount, auto&& func) { for (size_type job = 0; job < jobCount; job++) func(job); };
+
+    SUBCASE("slots are handed out in order and recycled")
+    {
+        particle_pool pool(4);
+        for (uint32 i = 0; i < 4; i++)
+            CHECK_EQ(pool.spawn(math::vec3(0.f), math::vec3(0.f), math::colors::white, infinite), i);
+
+        // The pool is full.
+        CHECK_EQ(pool.spawn(math::vec3(0.f), math::vec3(0.f), math::colors::white, infinite), particle_pool::invalid_index);
+        CHECK_EQ(pool.alive_count(), 4);
+
+        CHECK(pool.kill(1));
+        CHECK(pool.kill(3));
+        CHECK_FALSE(pool.kill(3));
+        CHECK_FALSE(pool.alive(3));
+        CHECK_EQ(pool.alive_count(), 2);
+
+        // Freed slots are reused last in first out.
+        CHECK_EQ(pool.spawn(math::vec3(1.f), math::vec3(0.f), math::colors::red, infinite), 3);
+        CHECK_EQ(pool.spawn(math::vec3(2.f), math::vec3(0.f), math::colors::red, infinite), 1);
+        CHECK_EQ(pool.position(1), math::vec3(2.f));
+        CHECK_EQ(pool.age(1), 0.f);
+        CHECK_EQ(pool.high_water(), 4);
+
+        pool.clear();
+        CHECK_EQ(pool.alive_count(), 0);
+        CHECK_EQ(pool.high_water(), 0);
+        CHECK_EQ(pool.spawn(math::vec3(0.f), math::vec3(0.f), math::colors::white, infinite), 0);
+    }
+
+    SUBCASE("spawning and killing from multiple threads never hands out a slot twice")
+    {
+        constexpr size_type threadCount = 4;
+        constexpr size_type perThread = 2000;
+        particle_pool pool(threadCount * perThread / 2);
+
+        std::vector<std::vector<uint32>> owned(threadCount);
+        std::vector<std::thread> threads;
+        for (size_type t = 0; t < threadCount; t++)
+        {
+            threads.emplace_back([&, t]()
+                {
+                    //every thread keeps at most a quarter of the pool alive, and kills a particle for every other spawn
+                    for (size_type i = 0; i < perThread; i++)
+                    {
+                        const uint32 index = pool.spawn(math::vec3(static_cast<float>(t)), math::vec3(0.f), math::colors::white, infinite);
+                        if (index != particle_pool::invalid_index)
+                            owned[t].push_back(index);
+
+                        if (i % 2 == 1 && !owned[t].empty())
+                        {
+                            pool.kill(owned[t].front());
+                            owned[t].erase(owned[t].begin());
+                        }
+                    }
+                });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        std::vector<uint32> all;
+        for (size_type t = 0; t < threadCount; t++)
+        {
+            for (uint32 index : owned[t])
+            {
+                CHECK(pool.alive(index));
+                CHECK_EQ(pool.position(index), math::vec3(static_cast<float>(t)));
+                all.push_back(index);
+            }
+        }
+
+        std::sort(all.begin(), all.end());
+        CHECK(std::adjacent_find(all.begin(), all.end()) == all.end());
+        CHECK_EQ(pool.alive_count(), all.size());
+    }
+
+    SUBCASE("integrate moves and accelerates living particles only")
+    {
+        particle_pool pool(11);
+        pool.set_acceleration(math::vec3(0.f, -10.f, 0.f));
+        for (size_type i = 0; i < 11; i++)
+            pool.spawn(math::vec3(static_cast<float>(i), 0.f, 0.f), math::vec3(1.f, 2.f, 3.f), math::colors::white, infinite);
+        pool.kill(5);
+
+        pool.integrate(0, pool.high_water(), 0.5f);
+        pool.integrate(0, pool.high_water(), 0.5f);
+
+        for (uint32 i = 0; i < 11; i++)
+        {
+            if (i == 5)
+            {
+                CHECK_EQ(pool.position(i), math::vec3(5.f, 0.f, 0.f));
+                CHECK_EQ(pool.velocity(i), math::vec3(0.f));
+                continue;
+            }
+
+            // The first step moves with the starting velocity, the second with the accelerated one.
+            CHECK_EQ(pool.position(i), math::vec3(static_cast<float>(i) + 1.f, 2.f - 2.5f, 3.f));
+            CHECK_EQ(pool.velocity(i), math::vec3(1.f, -8.f, 3.f));
+        }
+    }
+
+    SUBCASE("age kills particles that outlived their lifetime")
+    {
+        particle_pool pool(10);
+        for (size_type i = 0; i < 10; i++)
+            pool.spawn(math::vec3(0.f), math::vec3(0.f), math::colors::white, i % 3 == 0 ? infinite : static_cast<float>(i));
+
+        CHECK_EQ(pool.age(0, pool.high_water(), 4.f), 3);
+        CHECK_EQ(pool.alive_count(), 7);
+        CHECK_FALSE(pool.alive(2));
+        CHECK_FALSE(pool.alive(4));
+        CHECK(pool.alive(5));
+        CHECK_EQ(pool.age(5), 4.f);
+
+        CHECK_EQ(pool.age(0, pool.high_water(), 100.f), 3);
+        CHECK_EQ(pool.alive_count(), 4);
+        for (uint32 i = 0; i < 10; i++)
+            CHECK_EQ(pool.alive(i), i % 3 == 0);
+    }
+
+    SUBCASE("instances are written for living particles in slot order")
+    {
+        particle_pool pool(8);
+        pool.set_appearance(1, 2, math::vec3(0.5f));
+        for (size_type i = 0; i < 8; i++)
+            pool.spawn(math::vec3(static_cast<float>(i)), math::vec3(0.f), math::color(static_cast<float>(i), 0.f, 0.f, 1.f), infinite);
+        pool.kill(0);
+        pool.kill(6);
+
+        std::vector<math::mat4> instances(8);
+        std::vector<math::color> colors(8);
+        REQUIRE_EQ(pool.write_instances(instances.data(), colors.data(), instances.size()), 6);
+
+        const uint32 expected[] = { 1, 2, 3, 4, 5, 7 };
+        for (size_type i = 0; i < 6; i++)
+        {
+            const float value = static_cast<float>(expected[i]);
+            CHECK_EQ(instances[i][3], math::vec4(value, value, value, 1.f));
+            CHECK_EQ(instances[i][0], math::vec4(0.5f, 0.f, 0.f, 0.f));
+            CHECK_EQ(colors[i].r, value);
+        }
+
+        // Never writes more than there is room for.
+        CHECK_EQ(pool.write_instances(instances.data(), nullptr, 2), 2);
+    }
+
+    SUBCASE("pools are simulated in ranges across jobs")
+    {
+        particle_pool big(particles_per_job * 2 + 7);
+        particle_pool small(3);
+        particle_pool empty(16);
+        for (size_type i = 0; i < big.capacity(); i++)
+            big.spawn(math::vec3(0.f), math::vec3(1.f, 0.f, 0.f), math::colors::white, i % 2 == 0 ? 0.5f : infinite);
+        for (size_type i = 0; i < small.capacity(); i++)
+            small.spawn(math::vec3(0.f), math::vec3(0.f, 2.f, 0.f), math::colors::white, infinite);
+
+        size_type jobCount = 0;
+        particle_pool* pools[] = { &empty, &big, &empty, &small };
+        std::vector<size_type> firstJobs;
+        simulate_particles(pools, 4, 1.f, firstJobs, [&](size_type count, auto&& func) { jobCount = count; serialJobs(count, func); });
+
+        CHECK_EQ(jobCount, 4);
+        CHECK_EQ(big.alive_count(), big.capacity() / 2);
+        CHECK_EQ(big.position(static_cast<uint32>(big.capacity() - 2)), math::vec3(1.f, 0.f, 0.f));
+        CHECK_EQ(small.position(2), math::vec3(0.f, 2.f, 0.f));
+        CHECK_EQ(empty.alive_count(), 0);
+    }
+}
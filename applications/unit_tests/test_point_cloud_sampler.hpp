@@ -0,0 +1,201 @@
+#pragma once
+#include <rendering/util/point_cloud_sampler.hpp>
+#include <rendering/util/point_cloud_cache.hpp>
+
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] point cloud sampler")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-2.f, 2.f);
+    std::uniform_real_distribution<float> uvDistribution(-0.1f, 1.1f);
+
+    //a strip of random triangles, some sharing vertices
+    std::vector<math::vec3> vertices;
+    std::vector<math::vec2> uvs;
+    for (int i = 0; i < 600; i++)
+    {
+        vertices.emplace_back(distribution(generator), distribution(generator), distribution(generator));
+        uvs.emplace_back(uvDistribution(generator), uvDistribution(generator));
+    }
+
+    std::vector<uint> indices;
+    for (uint i = 0; i + 2 < vertices.size(); i++)
+    {
+        indices.push_back(i);
+        indices.push_back(i + 1);
+        indices.push_back(i + 2);
+    }
+
+    const math::ivec2 textureSize(16, 8);
+    std::vector<math::color> albedoColors;
+    std::vector<math::color> heightColors;
+    for (int y = 0; y < textureSize.y; y++)
+        for (int x = 0; x < textureSize.x; x++)
+        {
+            albedoColors.emplace_back(x / 16.f, y / 8.f, 0.5f, 1.f);
+            heightColors.emplace_back((x + y) / 24.f, 0.f, 0.f, 1.f);
+        }
+
+    const point_cloud_texture albedo{ albedoColors.data(), textureSize };
+    const point_cloud_texture height{ heightColors.data(), textureSize };
+    const point_cloud_sample_settings settings{ 3, 0.2f, 16 };
+
+    point_cloud_samples samples;
+    sample_point_cloud(vertices, indices, uvs, albedo, height, settings, samples);
+
+    SUBCASE("sample width")
+    {
+        CHECK_EQ(point_cloud_sample_width(0), 0);
+        CHECK_EQ(point_cloud_sample_width(1), 1);
+        CHECK_EQ(point_cloud_sample_width(3), 2);
+        CHECK_EQ(point_cloud_sample_width(4), 3);
+        CHECK_EQ(point_cloud_sample_width(6), 3);
+        CHECK_EQ(point_cloud_sample_width(7), 4);
+        for (uint count = 1; count < 5000; count++)
+        {
+            const uint width = point_cloud_sample_width(count);
+            CHECK_GE(width * (width + 1) / 2, count);
+            CHECK_LT((width - 1) * width / 2, count);
+        }
+    }
+
+    SUBCASE("matches the kernels")
+    {
+        //straightforward version of what the kernels do, one sample at a time
+        size_type expectedCount = 0;
+        size_type mismatches = 0;
+        for (size_type triangle = 0; triangle < indices.size() / 3; triangle++)
+        {
+            const math::vec3 a = vertices[indices[triangle * 3]];
+            const math::vec3 b = vertices[indices[triangle * 3 + 1]];
+            const math::vec3 c = vertices[indices[triangle * 3 + 2]];
+            const math::vec2 uvA = uvs[indices[triangle * 3]];
+            const math::vec2 uvB = uvs[indices[triangle * 3 + 1]];
+            const math::vec2 uvC = uvs[indices[triangle * 3 + 2]];
+
+            const uint count = point_cloud_triangle_samples(a, b, c, settings.samplesPerTriangle);
+            const uint width = point_cloud_sample_width(count);
+            const float step = 1.f / static_cast<float>(width + 1);
+            const math::vec3 normal = math::normalize(math::cross(b - a, c - a)) * settings.heightStrength;
+
+            uint index = 0;
+            for (uint x = 0; x < width; x++)
+                for (uint y = 0; y < width - x; y++, index++)
+                {
+                    if (index >= count)
+                        continue;
+
+                    const float u = step * x;
+                    const float v = step * y;
+                    const math::vec2 uv = uvA + u * (uvB - uvA) + v * (uvC - uvA);
+                    const int texelX = static_cast<int>(uv.x * settings.textureSize);
+                    const int texelY = static_cast<int>(uv.y * settings.textureSize);
+
+                    const math::vec3 point = a + u * (b - a) + v * (c - a) + normal * height.fetch(texelX, texelY).r;
+                    const math::vec4 color = albedo.fetch(texelX, texelY);
+
+                    const size_type sample = expectedCount + index;
+                    if (sample >= samples.points.size()
+                        || math::length(math::vec3(samples.points[sample]) - point) > 1e-4f
+                        || samples.points[sample].w != 1.f
+                        || samples.colors[sample] != color)
+                        mismatches++;
+                }
+
+            expectedCount += count;
+        }
+
+        CHECK_EQ(samples.points.size(), expectedCount);
+        CHECK_EQ(samples.colors.size(), expectedCount);
+        CHECK_EQ(mismatches, 0);
+    }
+
+    SUBCASE("parallel sampling gives the same points")
+    {
+        point_cloud_samples parallel;
+        sample_point_cloud(vertices, indices, uvs, albedo, height, settings, parallel, [](size_type jobCount, auto&& func)
+            {
+                std::vector<std::thread> threads;
+                for (size_type i = 0; i < jobCount; i++)
+                    threads.emplace_back([&func, i]() { func(i); });
+                for (auto& thread : threads)
+                    thread.join();
+            });
+
+        CHECK(parallel.points == samples.points);
+        CHECK(parallel.colors == samples.colors);
+    }
+
+    SUBCASE("empty input")
+    {
+        point_cloud_samples empty;
+        sample_point_cloud(vertices, std::vector<uint>{}, uvs, albedo, height, settings, empty);
+        CHECK(empty.points.empty());
+
+        //no textures read as black
+        sample_point_cloud(vertices, indices, uvs, point_cloud_texture{}, point_cloud_texture{}, settings, empty);
+        CHECK_EQ(empty.points.size(), samples.points.size());
+        CHECK_EQ(empty.colors[0], math::vec4(0.f));
+    }
+
+    SUBCASE("cache")
+    {
+        const std::string previousPath = PointCloudCache::getCachePath();
+        const std::string cachePath = (std::filesystem::temp_directory_path() / "legion_point_cloud_cache_test").string();
+        std::error_code error;
+        std::filesystem::remove_all(cachePath, error);
+        PointCloudCache::setCachePath(cachePath);
+
+        image albedoImage{};
+        albedoImage.size = textureSize;
+        image heightImage{};
+        heightImage.size = textureSize;
+
+        const uint64 key = PointCloudCache::key(vertices, indices, uvs, albedoImage, heightImage, settings);
+        CHECK_EQ(key, PointCloudCache::key(vertices, indices, uvs, albedoImage, heightImage, settings));
+
+        //anything the samples depend on changes the key
+        point_cloud_sample_settings denser = settings;
+        denser.samplesPerTriangle++;
+        CHECK_NE(key, PointCloudCache::key(vertices, indices, uvs, albedoImage, heightImage, denser));
+
+        std::vector<math::vec3> moved = vertices;
+        moved[0].x += 1.f;
+        CHECK_NE(key, PointCloudCache::key(moved, indices, uvs, albedoImage, heightImage, settings));
+
+        heightImage.size.y++;
+        CHECK_NE(key, PointCloudCache::key(vertices, indices, uvs, albedoImage, heightImage, settings));
+
+        point_cloud_samples loaded;
+        CHECK_FALSE(PointCloudCache::load(key, loaded));
+
+        PointCloudCache::store(key, samples);
+        REQUIRE(PointCloudCache::load(key, loaded));
+        CHECK(loaded.points == samples.points);
+        CHECK(loaded.colors == samples.colors);
+
+        //a truncated file is a miss
+        std::filesystem::path file;
+        for (auto& entry : std::filesystem::directory_iterator(cachePath))
+            file = entry.path();
+        std::filesystem::resize_file(file, std::filesystem::file_size(file) - 4);
+        CHECK_FALSE(PointCloudCache::load(key, loaded));
+        CHECK(loaded.points.empty());
+
+        PointCloudCache::setCachePath("");
+        PointCloudCache::store(key, samples);
+        CHECK_FALSE(PointCloudCache::load(key, loaded));
+
+        PointCloudCache::setCachePath(previousPath);
+        std::filesystem::remove_all(cachePath, error);
+    }
+}
@@ -0,0 +1,359 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/physics_statics.hpp>
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/colliders/convexcollider.hpp>
+#include <physics/data/physics_manifold.hpp>
+
+#include <limits>
+#include <random>
+
+#include "doctest.h"
+#include "test_collider_pair_cache.hpp"
+
+inline namespace {
+    ::legion::core::math::vec3 primitiveTestClosestPointOnSegment(const ::legion::core::math::vec3& point,
+        const ::legion::core::math::vec3& start, const ::legion::core::math::vec3& end)
+    {
+        using namespace ::legion::core;
+
+        const math::vec3 segment = end - start;
+        const float lengthSquared = math::dot(segment, segment);
+        if (lengthSquared < 1e-12f)
+            return start;
+
+        return start + segment * math::clamp(math::dot(point - start, segment) / lengthSquared, 0.f, 1.f);
+    }
+
+    //the distance of a point to the surface of a box, negative when the point is inside of it
+    float primitiveTestBoxDistance(const ::legion::core::math::vec3& point, const ::legion::physics::world_box& box)
+    {
+        using namespace ::legion::core;
+
+        math::vec3 outside = math::vec3(0.f);
+        float deepest = std::numeric_limits<float>::lowest();
+        for (int i = 0; i < 3; i++)
+        {
+            const float distance = math::abs(math::dot(point - box.center, box.axes[i])) - box.halfExtents[i];
+            outside[i] = math::max(distance, 0.f);
+            deepest = math::max(deepest, distance);
+        }
+
+        return deepest > 0.f ? math::length(outside) : deepest;
+    }
+
+    //the distance between a segment and a box or a second segment, found by walking along the segment in small steps
+    template<typename distance_func>
+    float primitiveTestSegmentDistance(const ::legion::core::math::vec3& start, const ::legion::core::math::vec3& end, distance_func&& distanceToPoint)
+    {
+        constexpr int stepCount = 2000;
+
+        float minimum = std::numeric_limits<float>::max();
+        for (int i = 0; i <= stepCount; i++)
+            minimum = ::legion::core::math::min(minimum, distanceToPoint(start + (end - start) * (static_cast<float>(i) / stepCount)));
+        return minimum;
+    }
+
+    //runs the narrowphase of a single step for a pair of colliders, the same way the PhysicsSystem does it
+    void primitiveTestCollide(::legion::physics::PhysicsCollider* colliderA, ::legion::physics::PhysicsCollider* colliderB,
+        const ::legion::core::math::mat4& transformA, const ::legion::core::math::mat4& transformB, ::legion::physics::physics_manifold& manifold)
+    {
+        colliderA->UpdateTransformedTightBoundingVolume(transformA);
+        colliderB->UpdateTransformedTightBoundingVolume(transformB);
+
+        manifold.colliderA = colliderA;
+        manifold.colliderB = colliderB;
+        manifold.transformA = transformA;
+        manifold.transformB = transformB;
+
+        colliderA->CheckCollision(colliderB, manifold);
+    }
+}
+
+TEST_CASE("[physics:ut] primitive collision kernels")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    pair_cache_test_registry::reportPhysicsComponents();
+
+    std::mt19937 generator(29);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    auto randomVector = [&]()
+    {
+        return math::vec3(distribution(generator), distribution(generator), distribution(generator));
+    };
+
+    auto randomRotation = [&]()
+    {
+        return math::angleAxis(distribution(generator) * math::pi<float>(), math::normalize(randomVector()));
+    };
+
+    auto randomBox = [&](const math::vec3& center)
+    {
+        const math::mat3 rotation = math::toMat3(randomRotation());
+        return world_box{ center, { rotation[0], rotation[1], rotation[2] }, math::vec3(0.6f) + math::abs(randomVector()) * 0.4f };
+    };
+
+    SUBCASE("spheres are compared with the distance between their centers")
+    {
+        size_type mismatches = 0;
+        for (size_type attempt = 0; attempt < 200; attempt++)
+        {
+            const world_sphere sphereA{ randomVector(), 0.3f + math::abs(distribution(generator)) * 0.5f };
+            const world_sphere sphereB{ randomVector() * 1.5f, 0.3f + math::abs(distribution(generator)) * 0.5f };
+
+            const float expected = math::length(sphereB.center - sphereA.center) - sphereA.radius - sphereB.radius;
+            if (math::abs(expected) < 1e-3f)
+                continue;
+
+            primitive_collision_info info;
+            const bool colliding = PhysicsStatics::DetectSphereSphereCollision(sphereA, sphereB, info);
+
+            if (colliding != (expected < 0.f))
+            {
+                mismatches++;
+                continue;
+            }
+
+            if (colliding && (math::abs(info.seperation - expected) > 1e-4f || info.contactCount != 1
+                || math::dot(info.normal, math::normalize(sphereB.center - sphereA.center)) < 0.9999f
+                || math::abs(math::length(info.contacts[0].first - sphereA.center) - sphereA.radius) > 1e-4f
+                || math::abs(math::length(info.contacts[0].second - sphereB.center) - sphereB.radius) > 1e-4f))
+            {
+                mismatches++;
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    SUBCASE("spheres and boxes are compared with the distance to the closest point of the box")
+    {
+        size_type mismatches = 0;
+        size_type hullMismatches = 0;
+        size_type collidingCount = 0;
+
+        for (size_type attempt = 0; attempt < 200; attempt++)
+        {
+            const world_box box = randomBox(math::vec3(0.f));
+            const world_sphere sphere{ randomVector() * 1.8f, 0.2f + math::abs(distribution(generator)) * 0.4f };
+
+            const float expected = primitiveTestBoxDistance(sphere.center, box) - sphere.radius;
+            if (math::abs(expected) < 1e-3f)
+                continue;
+
+            primitive_collision_info info;
+            const bool colliding = PhysicsStatics::DetectSphereBoxCollision(sphere, box, info);
+
+            if (colliding != (expected < 0.f) || (colliding && (math::abs(info.seperation - expected) > 1e-4f || info.contactCount == 0)))
+                mismatches++;
+
+            //the same box as a hull, the sphere is then tested like a capsule without a segment
+            ConvexCollider hull;
+            hull.CreateBox(cube_collider_params(box.halfExtents.x * 2.f, box.halfExtents.z * 2.f, box.halfExtents.y * 2.f));
+            const math::mat4 hullTransform = math::mat4(math::vec4(box.axes[0], 0.f), math::vec4(box.axes[1], 0.f),
+                math::vec4(box.axes[2], 0.f), math::vec4(box.center, 1.f));
+
+            primitive_collision_info hullInfo;
+            const bool hullColliding = PhysicsStatics::DetectSphereConvexCollision(sphere, &hull, hullTransform, hullInfo);
+
+            if (hullColliding != colliding || (colliding && math::abs(hullInfo.seperation - info.seperation) > 1e-4f))
+                hullMismatches++;
+
+            if (colliding)
+                collidingCount++;
+        }
+
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(hullMismatches, 0);
+        CHECK_GT(collidingCount, 0);
+    }
+
+    SUBCASE("capsules are compared with the distance between their segments")
+    {
+        size_type mismatches = 0;
+        size_type sphereMismatches = 0;
+
+        for (size_type attempt = 0; attempt < 200; attempt++)
+        {
+            const world_capsule capsuleA{ randomVector(), randomVector(), 0.1f + math::abs(distribution(generator)) * 0.3f };
+            //every tenth capsule is parallel to the first, those get a contact at both ends of the overlap
+            const math::vec3 startB = randomVector() * 1.5f;
+            const world_capsule capsuleB{ startB, attempt % 10 ? randomVector() * 1.5f : startB + (capsuleA.end - capsuleA.start) * 0.7f,
+                0.1f + math::abs(distribution(generator)) * 0.3f };
+
+            const float expected = primitiveTestSegmentDistance(capsuleA.start, capsuleA.end, [&](const math::vec3& point)
+                {
+                    return math::length(point - primitiveTestClosestPointOnSegment(point, capsuleB.start, capsuleB.end));
+                }) - capsuleA.radius - capsuleB.radius;
+
+            if (math::abs(expected) < 1e-3f)
+                continue;
+
+            primitive_collision_info info;
+            const bool colliding = PhysicsStatics::DetectCapsuleCapsuleCollision(capsuleA, capsuleB, info);
+
+            if (colliding != (expected < 0.f) || (colliding && (math::abs(info.seperation - expected) > 1e-3f || info.contactCount == 0)))
+                mismatches++;
+
+            //a sphere at the start of the second capsule
+            const world_sphere sphere{ capsuleB.start, capsuleB.radius };
+            const float sphereExpected = math::length(sphere.center - primitiveTestClosestPointOnSegment(sphere.center, capsuleA.start, capsuleA.end))
+                - sphere.radius - capsuleA.radius;
+
+            if (math::abs(sphereExpected) < 1e-3f)
+                continue;
+
+            primitive_collision_info sphereInfo;
+            const bool sphereColliding = PhysicsStatics::DetectSphereCapsuleCollision(sphere, capsuleA, sphereInfo);
+
+            if (sphereColliding != (sphereExpected < 0.f) || (sphereColliding && math::abs(sphereInfo.seperation - sphereExpected) > 1e-4f))
+                sphereMismatches++;
+        }
+
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(sphereMismatches, 0);
+    }
+
+    SUBCASE("capsules and hulls are compared with the distance between the segment and the hull")
+    {
+        size_type mismatches = 0;
+
+        for (size_type attempt = 0; attempt < 200; attempt++)
+        {
+            const world_box box = randomBox(math::vec3(0.f));
+            const world_capsule capsule{ randomVector() * 1.8f, randomVector() * 1.8f, 0.1f + math::abs(distribution(generator)) * 0.3f };
+
+            ConvexCollider hull;
+            hull.CreateBox(cube_collider_params(box.halfExtents.x * 2.f, box.halfExtents.z * 2.f, box.halfExtents.y * 2.f));
+            const math::mat4 hullTransform = math::mat4(math::vec4(box.axes[0], 0.f), math::vec4(box.axes[1], 0.f),
+                math::vec4(box.axes[2], 0.f), math::vec4(box.center, 1.f));
+
+            const float distance = primitiveTestSegmentDistance(capsule.start, capsule.end, [&](const math::vec3& point)
+                {
+                    return primitiveTestBoxDistance(point, box);
+                });
+
+            const float expected = distance - capsule.radius;
+            if (math::abs(expected) < 1e-3f)
+                continue;
+
+            primitive_collision_info info;
+            const bool colliding = PhysicsStatics::DetectCapsuleConvexCollision(capsule, &hull, hullTransform, info);
+
+            //when the segment enters the hull the seperation is the one of the least penetrated face, not the depth of the segment
+            if (colliding != (expected < 0.f) || (colliding && distance > 0.f && math::abs(info.seperation - expected) > 1e-3f))
+                mismatches++;
+        }
+
+        CHECK_EQ(mismatches, 0);
+    }
+
+    SUBCASE("axis aligned boxes are compared with the overlap on every axis")
+    {
+        size_type mismatches = 0;
+        for (size_type attempt = 0; attempt < 200; attempt++)
+        {
+            const world_box boxA{ math::vec3(0.f), { math::vec3(1.f, 0.f, 0.f), math::vec3(0.f, 1.f, 0.f), math::vec3(0.f, 0.f, 1.f) },
+                math::vec3(0.3f) + math::abs(randomVector()) * 0.5f };
+            world_box boxB = boxA;
+            boxB.center = randomVector() * 1.5f;
+            boxB.halfExtents = math::vec3(0.3f) + math::abs(randomVector()) * 0.5f;
+
+            const math::vec3 overlap = boxA.halfExtents + boxB.halfExtents - math::abs(boxB.center - boxA.center);
+            const float expected = -math::min(overlap.x, math::min(overlap.y, overlap.z));
+            if (math::abs(expected) < 1e-3f)
+                continue;
+
+            primitive_collision_info info;
+            const bool colliding = PhysicsStatics::DetectBoxBoxCollision(boxA, boxB, info);
+
+            if (colliding != (expected < 0.f) || (colliding && (math::abs(info.seperation - expected) > 1e-4f || info.contactCount == 0)))
+                mismatches++;
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    SUBCASE("box colliders give the same manifolds as box hulls")
+    {
+        const cube_collider_params paramsA(1.f, 1.f, 1.f);
+        const cube_collider_params paramsB(0.8f, 0.6f, 1.2f);
+
+        BoxCollider boxA(paramsA);
+        BoxCollider boxB(paramsB);
+        ConvexCollider hullA;
+        ConvexCollider hullB;
+        hullA.CreateBox(paramsA);
+        hullB.CreateBox(paramsB);
+
+        size_type mismatches = 0;
+        size_type faceCount = 0;
+        size_type edgeCount = 0;
+        size_type seperatedCount = 0;
+
+        //box B lies tilted on top of box A or hovers above it, after that it is turned in any direction
+        for (size_type attempt = 0; attempt < 400; attempt++)
+        {
+            const bool isTilted = attempt < 200;
+            const math::quat rotation = isTilted ? math::angleAxis(distribution(generator) * 0.3f, math::normalize(randomVector())) : randomRotation();
+            const math::vec3 position = isTilted ? math::vec3(distribution(generator) * 0.6f, 1.f + distribution(generator) * 0.3f, distribution(generator) * 0.6f)
+                : math::normalize(randomVector()) * (0.8f + math::abs(distribution(generator)) * 0.6f);
+
+            const math::mat4 transformA = math::mat4(1.f);
+            const math::mat4 transformB = math::compose(math::vec3(1.f), rotation, position);
+
+            physics_manifold boxManifold;
+            primitiveTestCollide(&boxA, &boxB, transformA, transformB, boxManifold);
+
+            physics_manifold hullManifold;
+            primitiveTestCollide(&hullA, &hullB, transformA, transformB, hullManifold);
+
+            //the edge check of the hulls keeps the smallest seperation of the edges, so only the box test finds the edge axes
+            //that seperate the boxes or that they penetrate less deep than their faces
+            if (boxManifold.isColliding != hullManifold.isColliding)
+            {
+                if (isTilted || boxManifold.isColliding)
+                    mismatches++;
+                else
+                    edgeCount++;
+                continue;
+            }
+
+            if (!boxManifold.isColliding)
+            {
+                seperatedCount++;
+                continue;
+            }
+
+            //the normal of the penetration points away from the reference collider
+            const PenetrationQuery& boxQuery = *boxManifold.penetrationInformation;
+            const PenetrationQuery& hullQuery = *hullManifold.penetrationInformation;
+            const math::vec3 boxNormal = math::normalize(boxQuery.isARef ? boxQuery.normal : -boxQuery.normal);
+            const math::vec3 hullNormal = math::normalize(hullQuery.isARef ? hullQuery.normal : -hullQuery.normal);
+
+            bool isFaceAxis = false;
+            for (const math::mat4& transform : { transformA, transformB })
+                for (int i = 0; i < 3; i++)
+                    isFaceAxis |= math::abs(math::dot(boxNormal, math::normalize(math::vec3(transform[i])))) > 0.9999f;
+
+            if (isFaceAxis)
+            {
+                faceCount++;
+                if (math::abs(boxQuery.penetration - hullQuery.penetration) > 1e-4f || math::dot(boxNormal, hullNormal) < 0.9999f)
+                    mismatches++;
+            }
+            else
+            {
+                edgeCount++;
+                if (boxQuery.penetration < hullQuery.penetration - 1e-4f)
+                    mismatches++;
+            }
+        }
+
+        CHECK_EQ(mismatches, 0);
+        CHECK_GT(faceCount, 0);
+        CHECK_GT(edgeCount, 0);
+        CHECK_GT(seperatedCount, 0);
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include <rendering/data/ring_allocator.hpp>
+
+#include <unordered_set>
+
+#include "doctest.h"
+
+inline namespace {
+
+    using namespace ::legion::core;
+    using ::legion::rendering::ring_allocator;
+    using ::legion::rendering::ring_fence_backend;
+
+    // Fences are numbers that the test signals by hand, to act as a GPU that is behind by a number of frames.
+    class fake_fence_backend final : public ring_fence_backend
+    {
+    public:
+        size_type lastFence = 0;
+        size_type signaledUpTo = 0;
+        size_type blockingWaits = 0;
+        std::unordered_set<size_type> liveFences;
+
+        fence_type insert_fence() override
+        {
+            lastFence++;
+            liveFences.insert(lastFence);
+            return reinterpret_cast<fence_type>(lastFence);
+        }
+
+        bool wait_fence(fence_type fence, bool block) override
+        {
+            const size_type value = reinterpret_cast<size_type>(fence);
+            if (block)
+            {
+                // A blocking wait is the GPU catching up.
+                blockingWaits++;
+                signaledUpTo = value > signaledUpTo ? value : signaledUpTo;
+            }
+            return value <= signaledUpTo;
+        }
+
+        void delete_fence(fence_type fence) override
+        {
+            liveFences.erase(reinterpret_cast<size_type>(fence));
+        }
+    };
+
+}
+
+TEST_CASE("[rendering:ut] ring_allocator")
+{
+    fake_fence_backend backend;
+
+    SUBCASE("allocations stay within the current region")
+    {
+        ring_allocator allocator(&backend, 256, 3);
+
+        auto first = allocator.allocate(100);
+        REQUIRE(first.has_value());
+        CHECK_EQ(*first, 0);
+
+        auto second = allocator.allocate(100, 64);
+        REQUIRE(second.has_value());
+        CHECK_EQ(*second, 128);
+
+        CHECK_FALSE(allocator.allocate(100).has_value());
+
+        allocator.end_region();
+        allocator.begin_region();
+        CHECK_EQ(allocator.current_region(), 1);
+
+        auto third = allocator.allocate(256);
+        REQUIRE(third.has_value());
+        CHECK_EQ(*third, 256);
+    }
+
+    SUBCASE("regions are reused only after their fence is signaled")
+    {
+        ring_allocator allocator(&backend, 64, 3);
+
+        // The GPU finishes every frame in time, so the CPU never has to wait.
+        for (size_type frame = 0; frame < 9; frame++)
+        {
+            allocator.end_region();
+            backend.signaledUpTo = backend.lastFence;
+            allocator.begin_region();
+            CHECK(allocator.allocate(64).has_value());
+        }
+        CHECK_EQ(allocator.stall_count(), 0);
+        CHECK_EQ(backend.blockingWaits, 0);
+
+        // The GPU stops, once the ring comes around the CPU has to wait for the region it wants to write.
+        allocator.end_region();
+        allocator.begin_region();
+        allocator.end_region();
+        allocator.begin_region();
+        CHECK_EQ(allocator.stall_count(), 0);
+
+        allocator.end_region();
+        allocator.begin_region();
+        CHECK_EQ(allocator.stall_count(), 1);
+        CHECK_EQ(backend.blockingWaits, 1);
+    }
+
+    SUBCASE("resizing waits for every region and deletes all fences")
+    {
+        {
+            ring_allocator allocator(&backend, 64, 3);
+            allocator.end_region();
+            allocator.begin_region();
+            allocator.end_region();
+            allocator.begin_region();
+
+            allocator.resize(128);
+            CHECK(backend.liveFences.empty());
+            CHECK_EQ(allocator.total_size(), 384);
+
+            auto allocation = allocator.allocate(128);
+            REQUIRE(allocation.has_value());
+            CHECK_EQ(*allocation, allocator.current_region() * 128);
+
+            allocator.end_region();
+        }
+
+        // The allocator deletes its remaining fences when it is destroyed.
+        CHECK(backend.liveFences.empty());
+    }
+}
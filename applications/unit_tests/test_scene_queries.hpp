@@ -0,0 +1,400 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/physics_statics.hpp>
+#include <physics/broadphasecollisionalgorithms/broadphaseuniformgridnocaching.hpp>
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/colliders/capsulecollider.hpp>
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/components/physics_component.hpp>
+#include <physics/data/aabb_soa.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "doctest.h"
+#include "test_primitive_colliders.hpp"
+
+inline namespace {
+    //moves a point along a ray in small steps until the distance function is no longer positive. The march goes on until the
+    //point is clearly inside, so that the smallest distance on the way tells if the ray only grazes the shape
+    template<typename distance_func>
+    float sceneQueryTestMarch(const ::legion::core::math::vec3& origin, const ::legion::core::math::vec3& direction, float maxDistance,
+        distance_func&& distanceToPoint, float& outSmallestDistance)
+    {
+        constexpr float stepSize = 0.0005f;
+
+        float firstHit = std::numeric_limits<float>::max();
+        outSmallestDistance = std::numeric_limits<float>::max();
+        for (float distance = 0.f; distance <= maxDistance && outSmallestDistance > -1e-2f; distance += stepSize)
+        {
+            const float pointDistance = distanceToPoint(origin + direction * distance);
+            outSmallestDistance = ::legion::core::math::min(outSmallestDistance, pointDistance);
+            if (pointDistance <= 0.f && firstHit == std::numeric_limits<float>::max())
+                firstHit = distance;
+        }
+        return firstHit;
+    }
+
+    //a collider of every type with the distance of a point to its surface
+    struct scene_query_test_shape
+    {
+        std::shared_ptr<::legion::physics::PhysicsCollider> collider;
+        std::function<float(const ::legion::core::math::vec3&)> distanceToPoint;
+        //the distance of a box to the surface, only set for the sphere
+        std::function<float(const ::legion::physics::world_box&)> distanceToBox;
+    };
+
+    std::vector<scene_query_test_shape> createSceneQueryTestShapes(const ::legion::core::math::mat4& transform)
+    {
+        using namespace ::legion::core;
+        using namespace ::legion::physics;
+
+        std::vector<scene_query_test_shape> shapes;
+
+        auto sphere = std::make_shared<SphereCollider>(0.6f, math::vec3(0.1f, 0.f, 0.f));
+        const world_sphere worldSphere = sphere->GetWorldSphere(transform);
+        shapes.push_back({ sphere,
+            [=](const math::vec3& point) { return math::length(point - worldSphere.center) - worldSphere.radius; },
+            [=](const world_box& box) { return primitiveTestBoxDistance(worldSphere.center, box) - worldSphere.radius; } });
+
+        auto capsule = std::make_shared<CapsuleCollider>(0.3f, 1.2f);
+        const world_capsule worldCapsule = capsule->GetWorldCapsule(transform);
+        shapes.push_back({ capsule,
+            [=](const math::vec3& point)
+            {
+                return math::length(point - primitiveTestClosestPointOnSegment(point, worldCapsule.start, worldCapsule.end)) - worldCapsule.radius;
+            }, nullptr });
+
+        const cube_collider_params boxParams(1.2f, 0.8f, 0.6f);
+        auto box = std::make_shared<BoxCollider>(boxParams);
+        const world_box worldBox = box->GetWorldBox(transform);
+        shapes.push_back({ box, [=](const math::vec3& point) { return primitiveTestBoxDistance(point, worldBox); }, nullptr });
+
+        //the same box as a hull, so the ray is clipped against the face planes instead of the slabs of the box
+        auto hull = std::make_shared<ConvexCollider>();
+        hull->CreateBox(boxParams);
+        shapes.push_back({ hull, [=](const math::vec3& point) { return primitiveTestBoxDistance(point, worldBox); }, nullptr });
+
+        for (auto& shape : shapes)
+            shape.collider->UpdateTransformedTightBoundingVolume(transform);
+
+        return shapes;
+    }
+}
+
+TEST_CASE("[physics:ut] scene query kernels")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    std::mt19937 generator(31);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    auto randomVector = [&]()
+    {
+        return math::vec3(distribution(generator), distribution(generator), distribution(generator));
+    };
+
+    auto randomRotation = [&]()
+    {
+        return math::angleAxis(distribution(generator) * math::pi<float>(), math::normalize(randomVector()));
+    };
+
+    constexpr float maxDistance = 4.f;
+
+    //the queries start around the shape and are aimed at a point close to it, so that about half of them hit
+    auto randomQuery = [&](math::vec3& origin, math::vec3& direction)
+    {
+        origin = math::normalize(randomVector()) * 2.5f;
+        direction = math::normalize(randomVector() * 0.8f - origin);
+    };
+
+    SUBCASE("rays are compared with a march along the ray")
+    {
+        size_type mismatches = 0;
+        size_type hullMismatches = 0;
+        size_type hitCount = 0;
+
+        for (size_type attempt = 0; attempt < 50; attempt++)
+        {
+            const math::mat4 transform = math::compose(math::vec3(1.f), randomRotation(), randomVector() * 0.2f);
+            const std::vector<scene_query_test_shape> shapes = createSceneQueryTestShapes(transform);
+
+            for (size_type rayIndex = 0; rayIndex < 4; rayIndex++)
+            {
+                math::vec3 origin, direction;
+                randomQuery(origin, direction);
+
+                //every tenth ray starts inside of the shapes
+                if (rayIndex == 0 && attempt % 10 == 0)
+                    origin = math::vec3(transform[3]);
+
+                std::array<float, 4> distances;
+                std::array<math::vec3, 4> normals;
+                std::array<bool, 4> hits;
+
+                for (size_type i = 0; i < shapes.size(); i++)
+                {
+                    const scene_query_test_shape& shape = shapes[i];
+
+                    float smallestDistance;
+                    const float expected = sceneQueryTestMarch(origin, direction, maxDistance, shape.distanceToPoint, smallestDistance);
+
+                    hits[i] = shape.collider->Raycast(transform, origin, direction, maxDistance, distances[i], normals[i]);
+                    if (math::abs(smallestDistance) < 1e-3f)
+                        continue;
+
+                    const bool expectedHit = expected != std::numeric_limits<float>::max();
+                    if (hits[i] != expectedHit || (hits[i] && math::abs(distances[i] - expected) > 1e-3f))
+                    {
+                        mismatches++;
+                        continue;
+                    }
+
+                    //the normal points out of the surface, or against the ray when it starts inside
+                    if (hits[i] && expected > 0.f && math::dot(normals[i], direction) >= 0.f)
+                        mismatches++;
+                    if (hits[i] && expected == 0.f && math::dot(normals[i], -direction) < 0.9999f)
+                        mismatches++;
+
+                    if (hits[i])
+                        hitCount++;
+                }
+
+                //the box and the hull of the same box give the same hit
+                if (hits[2] != hits[3] || (hits[2] && (math::abs(distances[2] - distances[3]) > 1e-4f || math::dot(normals[2], normals[3]) < 0.9999f)))
+                    hullMismatches++;
+            }
+        }
+
+        CHECK_EQ(mismatches, 0);
+        CHECK_EQ(hullMismatches, 0);
+        CHECK_GT(hitCount, 0);
+    }
+
+    SUBCASE("sweeps are compared with a march along the sweep")
+    {
+        size_type sphereMismatches = 0;
+        size_type boxMismatches = 0;
+        size_type colliderMismatches = 0;
+        size_type hitCount = 0;
+
+        for (size_type attempt = 0; attempt < 50; attempt++)
+        {
+            const math::mat4 transform = math::compose(math::vec3(1.f), randomRotation(), randomVector() * 0.2f);
+            const std::vector<scene_query_test_shape> shapes = createSceneQueryTestShapes(transform);
+
+            math::vec3 origin, direction;
+            randomQuery(origin, direction);
+
+            const world_sphere sphere{ origin, 0.25f };
+            const math::mat3 boxRotation = math::toMat3(randomRotation());
+            const world_box box{ origin, { boxRotation[0], boxRotation[1], boxRotation[2] }, math::vec3(0.3f, 0.2f, 0.1f) };
+
+            //the sphere as a collider that is cast with ColliderCast, like the continuous collision detection does
+            SphereCollider movingSphere(sphere.radius);
+            const math::mat4 movingTransform = math::translate(origin);
+
+            for (const scene_query_test_shape& shape : shapes)
+            {
+                float smallestDistance;
+                const float expected = sceneQueryTestMarch(origin, direction, maxDistance,
+                    [&](const math::vec3& point) { return shape.distanceToPoint(point) - sphere.radius; }, smallestDistance);
+
+                float distance;
+                math::vec3 normal, point;
+                const bool hit = PhysicsStatics::SphereCast(sphere, direction, maxDistance, shape.collider.get(), transform, distance, normal, point);
+
+                if (math::abs(smallestDistance) >= 1e-3f)
+                {
+                    const bool expectedHit = expected != std::numeric_limits<float>::max();
+                    if (hit != expectedHit || (hit && math::abs(distance - expected) > 2e-3f))
+                        sphereMismatches++;
+                    else if (hit)
+                        hitCount++;
+                }
+
+                float colliderDistance;
+                math::vec3 colliderNormal, colliderPoint;
+                const bool colliderHit = PhysicsStatics::ColliderCast(&movingSphere, movingTransform, direction, maxDistance,
+                    shape.collider.get(), transform, colliderDistance, colliderNormal, colliderPoint);
+
+                if (colliderHit != hit || (hit && math::abs(colliderDistance - distance) > 1e-4f))
+                    colliderMismatches++;
+
+                //boxes are only swept against the sphere, its distance to a box is known exactly
+                if (!shape.distanceToBox)
+                    continue;
+
+                float boxSmallestDistance;
+                const float boxExpected = sceneQueryTestMarch(origin, direction, maxDistance, [&](const math::vec3& center)
+                    {
+                        world_box movedBox = box;
+                        movedBox.center = center;
+                        return shape.distanceToBox(movedBox);
+                    }, boxSmallestDistance);
+
+                float boxDistance;
+                const bool boxHit = PhysicsStatics::BoxCast(box, direction, maxDistance, shape.collider.get(), transform, boxDistance, normal, point);
+
+                if (math::abs(boxSmallestDistance) < 1e-3f)
+                    continue;
+
+                const bool boxExpectedHit = boxExpected != std::numeric_limits<float>::max();
+                if (boxHit != boxExpectedHit || (boxHit && math::abs(boxDistance - boxExpected) > 2e-3f))
+                    boxMismatches++;
+            }
+        }
+
+        CHECK_EQ(sphereMismatches, 0);
+        CHECK_EQ(boxMismatches, 0);
+        CHECK_EQ(colliderMismatches, 0);
+        CHECK_GT(hitCount, 0);
+    }
+}
+
+TEST_CASE("[physics:ut] scene query candidates")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::physics;
+
+    std::mt19937 generator(37);
+    std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+
+    auto randomVector = [&]()
+    {
+        return math::vec3(distribution(generator), distribution(generator), distribution(generator));
+    };
+
+    //a scene of components with one or two colliders of every type, spread over a few cells of the grid
+    constexpr size_type componentCount = 62;
+    std::vector<physicsComponent> components(componentCount);
+    std::vector<math::mat4> transforms(componentCount);
+    std::vector<physics_manifold_precursor> precursors;
+
+    for (size_type i = 0; i < componentCount; i++)
+    {
+        physicsComponent& component = components[i];
+        switch (i % 4)
+        {
+        case 0: component.AddSphere(0.3f + math::abs(distribution(generator)) * 0.4f); break;
+        case 1: component.AddCapsule(0.2f, 0.5f + math::abs(distribution(generator))); break;
+        case 2: component.AddBox(cube_collider_params(0.5f, 0.8f, 0.3f)); break;
+        default:
+            component.AddBox(cube_collider_params(0.4f, 0.4f, 0.4f));
+            component.AddSphere(0.3f, math::vec3(0.f, 0.5f, 0.f));
+            break;
+        }
+
+        transforms[i] = math::compose(math::vec3(1.f), math::angleAxis(distribution(generator) * math::pi<float>(), math::normalize(randomVector())),
+            randomVector() * 6.f);
+        for (auto& collider : component.colliders)
+            collider->UpdateTransformedTightBoundingVolume(transforms[i]);
+
+        precursors.emplace_back(transforms[i], &component, i, ecs::entity_handle());
+    }
+
+    //the bounds of every component, the way the PhysicsSystem stores them for the queries
+    AABBSoA bounds;
+    bounds.resize(componentCount);
+    for (size_type i = 0; i < componentCount; i++)
+    {
+        std::pair<math::vec3, math::vec3> componentBounds = components[i].colliders[0]->GetMinMaxWorldAABB();
+        for (size_type j = 1; j < components[i].colliders.size(); j++)
+            componentBounds = PhysicsStatics::CombineAABB(components[i].colliders[j]->GetMinMaxWorldAABB(), componentBounds);
+        bounds.set(i, componentBounds);
+    }
+
+    BroadphaseUniformGridNoCaching broadPhase(math::ivec3(2, 2, 2));
+    broadPhase.collectPairs(std::vector<physics_manifold_precursor>(precursors));
+
+    SUBCASE("every collider that is hit by a ray or a sweep is a candidate")
+    {
+        size_type missedCandidates = 0;
+        size_type lateEntries = 0;
+        size_type hitCount = 0;
+
+        std::vector<id_type> candidates;
+        std::vector<float> entries;
+        std::vector<id_type> everyComponent(componentCount);
+        for (size_type i = 0; i < componentCount; i++)
+            everyComponent[i] = static_cast<id_type>(i);
+
+        for (size_type queryIndex = 0; queryIndex < 200; queryIndex++)
+        {
+            const math::vec3 origin = randomVector() * 8.f;
+            const math::vec3 direction = math::normalize(randomVector() * 4.f - origin);
+            const float radius = queryIndex % 2 ? 0.3f : 0.f;
+            const math::vec3 expansion = math::vec3(radius);
+            constexpr float maxDistance = 20.f;
+
+            candidates.clear();
+            broadPhase.collectRayCandidates(origin, direction, maxDistance, expansion, candidates);
+
+            //the slab test of every component, in batches of 4 with a remainder like the queries use it
+            entries.resize(componentCount);
+            bounds.intersectRay(origin, direction, maxDistance, expansion, everyComponent.data(), componentCount, entries.data());
+
+            for (size_type i = 0; i < componentCount; i++)
+            {
+                for (auto& collider : components[i].colliders)
+                {
+                    float distance;
+                    math::vec3 normal, point;
+                    const bool hit = radius > 0.f
+                        ? PhysicsStatics::SphereCast(world_sphere{ origin, radius }, direction, maxDistance, collider.get(), transforms[i], distance, normal, point)
+                        : collider->Raycast(transforms[i], origin, direction, maxDistance, distance, normal);
+
+                    if (!hit)
+                        continue;
+
+                    hitCount++;
+                    if (std::find(candidates.begin(), candidates.end(), static_cast<id_type>(i)) == candidates.end())
+                        missedCandidates++;
+                    if (entries[i] > distance + 1e-4f)
+                        lateEntries++;
+                }
+            }
+        }
+
+        CHECK_EQ(missedCandidates, 0);
+        CHECK_EQ(lateEntries, 0);
+        CHECK_GT(hitCount, 0);
+    }
+
+    SUBCASE("every component that overlaps a box is a candidate")
+    {
+        size_type missedCandidates = 0;
+        size_type overlapCount = 0;
+
+        std::vector<id_type> candidates;
+        for (size_type queryIndex = 0; queryIndex < 200; queryIndex++)
+        {
+            const math::vec3 center = randomVector() * 7.f;
+            const math::vec3 halfExtents = math::abs(randomVector()) * 2.f;
+            const math::vec3 min = center - halfExtents;
+            const math::vec3 max = center + halfExtents;
+
+            candidates.clear();
+            broadPhase.collectCandidates(min, max, candidates);
+
+            for (size_type i = 0; i < componentCount; i++)
+            {
+                if (!bounds.overlaps(i, min, max))
+                    continue;
+
+                overlapCount++;
+                if (std::find(candidates.begin(), candidates.end(), static_cast<id_type>(i)) == candidates.end())
+                    missedCandidates++;
+            }
+        }
+
+        CHECK_EQ(missedCandidates, 0);
+        CHECK_GT(overlapCount, 0);
+    }
+}
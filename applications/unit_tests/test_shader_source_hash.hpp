@@ -0,0 +1,107 @@
+#pragma once
+#include <rendering/shadercompiler/shader_source_hash.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] shader source hash")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    std::unordered_map<std::string, std::string> files{
+        { "shaders/lit.shs", "#version 450\n#include <lighting.shinc>\n    #include \"local.shinc\"\nvoid main(){}\n" },
+        { "shaders/local.shinc", "float local;\n" },
+        { "lib/lighting.shinc", "#include <math.shinc>\nfloat light;\n" },
+        { "lib/math.shinc", "#include <lighting.shinc>\nfloat pi;\n" },
+        { "lib/local.shinc", "float shadowed;\n" }
+    };
+
+    auto reader = [&](const std::string& path, std::string& contents)
+    {
+        auto iter = files.find(path);
+        if (iter == files.end())
+            return false;
+        contents = iter->second;
+        return true;
+    };
+
+    const std::vector<std::string> includeDirectories{ "shaders", "lib" };
+    const std::vector<std::string> defines{ "LEGION_SHADER", "DEBUG" };
+
+    auto hash = [&](std::vector<std::string>* dependencies = nullptr)
+    {
+        return shader_source_hash("shaders/lit.shs", includeDirectories, defines, 1, reader, dependencies);
+    };
+
+    const uint64 original = hash();
+
+    SUBCASE("include directives are found")
+    {
+        auto includes = find_shader_includes(files["shaders/lit.shs"]);
+        REQUIRE_EQ(includes.size(), 2);
+        CHECK_EQ(includes[0].name, "lighting.shinc");
+        CHECK_FALSE(includes[0].quoted);
+        CHECK_EQ(includes[1].name, "local.shinc");
+        CHECK(includes[1].quoted);
+
+        CHECK(find_shader_includes("// #include <commented.shinc>\n#include\n").empty());
+    }
+
+    SUBCASE("the same inputs give the same hash")
+    {
+        CHECK_NE(original, 0);
+        CHECK_EQ(hash(), original);
+    }
+
+    SUBCASE("every file that is included is part of the hash")
+    {
+        std::vector<std::string> dependencies;
+        hash(&dependencies);
+
+        // The include cycle between lighting and math is only visited once.
+        REQUIRE_EQ(dependencies.size(), 4);
+        CHECK_EQ(dependencies[0], "shaders/lit.shs");
+        CHECK_EQ(dependencies[1], "lib/lighting.shinc");
+        CHECK_EQ(dependencies[2], "lib/math.shinc");
+        CHECK_EQ(dependencies[3], "shaders/local.shinc");
+
+        files["lib/math.shinc"] += "float tau;\n";
+        CHECK_NE(hash(), original);
+    }
+
+    SUBCASE("quoted includes prefer the folder of the including file")
+    {
+        // The shadowed copy in lib isn't used, so changing it doesn't matter.
+        files["lib/local.shinc"] = "float changed;\n";
+        CHECK_EQ(hash(), original);
+
+        // Until the local copy disappears and the include resolves to it instead.
+        files.erase("shaders/local.shinc");
+        CHECK_NE(hash(), original);
+    }
+
+    SUBCASE("defines and settings are part of the hash")
+    {
+        CHECK_NE(shader_source_hash("shaders/lit.shs", includeDirectories, { "LEGION_SHADER" }, 1, reader), original);
+        CHECK_NE(shader_source_hash("shaders/lit.shs", includeDirectories, { "LEGION_SHADERDEBUG" }, 1, reader), original);
+        CHECK_NE(shader_source_hash("shaders/lit.shs", includeDirectories, defines, 2, reader), original);
+    }
+
+    SUBCASE("missing files")
+    {
+        CHECK_EQ(shader_source_hash("shaders/missing.shs", includeDirectories, defines, 1, reader), 0);
+
+        files["shaders/lit.shs"] += "#include <missing.shinc>\n";
+        const uint64 missingInclude = hash();
+        CHECK_NE(missingInclude, 0);
+        CHECK_NE(missingInclude, original);
+
+        // Adding the missing include changes the hash again.
+        files["lib/missing.shinc"] = "";
+        CHECK_NE(hash(), missingInclude);
+    }
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <core/async/snapshot_buffer.hpp>
+
+#include <thread>
+#include <vector>
+
+#include "doctest.h"
+
+TEST_CASE("[core:ut] snapshot buffer")
+{
+    using namespace ::legion::core;
+
+    struct snapshot
+    {
+        size_type frame = 0;
+        std::vector<size_type> values;
+    };
+
+    async::snapshot_buffer<snapshot> buffer;
+
+    SUBCASE("nothing is acquired before the first publish")
+    {
+        CHECK_FALSE(buffer.acquire());
+        CHECK_EQ(buffer.read_buffer().frame, 0);
+    }
+
+    SUBCASE("the consumer gets the newest snapshot once")
+    {
+        for (size_type frame = 1; frame <= 3; frame++)
+        {
+            snapshot& write = buffer.write_buffer();
+            write.frame = frame;
+            buffer.publish();
+        }
+
+        REQUIRE(buffer.acquire());
+        CHECK_EQ(buffer.read_buffer().frame, 3);
+        CHECK_FALSE(buffer.acquire());
+        CHECK_EQ(buffer.read_buffer().frame, 3);
+
+        // The slot the consumer reads is never handed to the producer.
+        buffer.write_buffer().frame = 4;
+        CHECK_NE(&buffer.write_buffer(), &buffer.read_buffer());
+        CHECK_EQ(buffer.read_buffer().frame, 3);
+    }
+
+    SUBCASE("snapshots are consistent and in order while both threads run")
+    {
+        constexpr size_type frames = 20000;
+        constexpr size_type valueCount = 64;
+
+        std::thread producer([&]()
+            {
+                for (size_type frame = 1; frame <= frames; frame++)
+                {
+                    snapshot& write = buffer.write_buffer();
+                    write.frame = frame;
+                    write.values.assign(valueCount, frame);
+                    buffer.publish();
+                }
+            });
+
+        size_type lastFrame = 0;
+        size_type acquired = 0;
+        size_type torn = 0;
+        size_type outOfOrder = 0;
+        while (lastFrame < frames)
+        {
+            if (!buffer.acquire())
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const snapshot& read = buffer.read_buffer();
+            if (read.frame <= lastFrame)
+                outOfOrder++;
+            for (size_type value : read.values)
+                if (value != read.frame)
+                {
+                    torn++;
+                    break;
+                }
+
+            lastFrame = read.frame;
+            acquired++;
+        }
+
+        producer.join();
+
+        CHECK_EQ(torn, 0);
+        CHECK_EQ(outOfOrder, 0);
+        CHECK_GT(acquired, 0);
+        CHECK_EQ(lastFrame, frames);
+    }
+}
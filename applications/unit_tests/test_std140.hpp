@@ -0,0 +1,85 @@
+#pragma once
+#include <rendering/util/std140.hpp>
+
+#include "doctest.h"
+
+TEST_CASE("[rendering:ut] std140 uniform blocks")
+{
+    using namespace ::legion::core;
+    using namespace ::legion::rendering;
+
+    SUBCASE("layout follows the std140 alignment rules")
+    {
+        // layout(std140) uniform Params { float a; vec3 b; float c; vec2 d; mat3 e; bool f; vec4 g; };
+        std140_layout layout;
+        CHECK_EQ(layout.add<float>(), 0);
+        CHECK_EQ(layout.add<math::vec3>(), 16);
+        CHECK_EQ(layout.add<float>(), 28);
+        CHECK_EQ(layout.add<math::vec2>(), 32);
+        CHECK_EQ(layout.add<math::mat3>(), 48);
+        CHECK_EQ(layout.add<bool>(), 96);
+        CHECK_EQ(layout.add<math::vec4>(), 112);
+        CHECK_EQ(layout.size(), 128);
+    }
+
+    SUBCASE("values are packed and read back")
+    {
+        std140_block block(128);
+
+        const math::mat3 rotation(1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f);
+        block.write(0, 0.5f);
+        block.write(16, math::vec3(1.f, 2.f, 3.f));
+        block.write(28, 4.f);
+        block.write(48, rotation);
+        block.write(96, true);
+        block.write(112, math::bvec4(true, false, true, false));
+
+        CHECK_EQ(block.read<float>(0), 0.5f);
+        CHECK_EQ(block.read<math::vec3>(16), math::vec3(1.f, 2.f, 3.f));
+        CHECK_EQ(block.read<float>(28), 4.f);
+        CHECK_EQ(block.read<math::mat3>(48), rotation);
+        CHECK(block.read<bool>(96));
+        CHECK_EQ(block.read<math::bvec4>(112), math::bvec4(true, false, true, false));
+
+        // Matrix columns start every 16 bytes, bools are 4 byte integers.
+        const float* floats = reinterpret_cast<const float*>(block.data());
+        CHECK_EQ(floats[48 / 4 + 4], 4.f);
+        CHECK_EQ(floats[48 / 4 + 8], 7.f);
+        const uint32* integers = reinterpret_cast<const uint32*>(block.data());
+        CHECK_EQ(integers[96 / 4], 1u);
+        CHECK_EQ(integers[112 / 4 + 2], 1u);
+
+        // Writes outside of the block are refused.
+        CHECK_FALSE(block.write(120, math::vec4(1.f)));
+    }
+
+    SUBCASE("only changed bytes are marked dirty")
+    {
+        std140_block block(64);
+
+        // A new block needs to be uploaded completely.
+        CHECK(block.dirty());
+        CHECK_EQ(block.dirty_begin(), 0);
+        CHECK_EQ(block.dirty_end(), 64);
+        block.clear_dirty();
+        CHECK_FALSE(block.dirty());
+
+        // Writing the value that is already there changes nothing.
+        CHECK_FALSE(block.write(16, 0.f));
+        CHECK_FALSE(block.dirty());
+
+        CHECK(block.write(16, math::vec2(1.f, 2.f)));
+        CHECK(block.write(40, 3.f));
+        CHECK(block.dirty());
+        CHECK_EQ(block.dirty_begin(), 16);
+        CHECK_EQ(block.dirty_end(), 44);
+
+        block.clear_dirty();
+        CHECK_FALSE(block.write(16, math::vec2(1.f, 2.f)));
+        CHECK_FALSE(block.dirty());
+
+        block.mark_all_dirty();
+        CHECK_EQ(block.dirty_begin(), 0);
+        CHECK_EQ(block.dirty_end(), 64);
+    }
+}
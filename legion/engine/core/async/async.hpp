@@ -9,3 +9,6 @@
 #include <core/async/spinlock.hpp>
 #include <core/async/transferable_atomic.hpp>
 #include <core/async/ring_sync_lock.hpp>
+#include <core/async/parallel_radix_sort.hpp>
+#include <core/async/parallel_jobs.hpp>
+#include <core/async/snapshot_buffer.hpp>
@@ -0,0 +1,49 @@
+#pragma once
+#include <core/async/job_pool.hpp>
+#include <core/types/primitives.hpp>
+
+#include <algorithm>
+
+/**
+ * @file parallel_jobs.hpp
+ * @brief Helpers that run a function as jobs on the scheduler and wait for them, in the shape the parallel algorithms of the engine expect.
+ */
+
+namespace legion::core::async
+{
+    /**@brief Queues jobCount jobs on the scheduler that call func(jobIndex) and waits for all of them to finish.
+     * @param scheduler Anything with a queueJobs(count, func) that returns an operation with wait(), usually the scheduler of a system.
+     */
+    template<typename Scheduler, typename Func>
+    void run_jobs(Scheduler& scheduler, size_type jobCount, Func&& func)
+    {
+        if (jobCount == 0)
+            return;
+
+        scheduler.queueJobs(jobCount, [&]() {
+            func(static_cast<size_type>(this_job::get_id()));
+            }).wait();
+    }
+
+    /**@brief Splits [0, count) into ranges of rangeSize, calls func(start, end) for every range as a job and waits for all of them to finish.
+     */
+    template<typename Scheduler, typename Func>
+    void for_each_range(Scheduler& scheduler, size_type count, size_type rangeSize, Func&& func)
+    {
+        run_jobs(scheduler, (count + rangeSize - 1) / rangeSize, [&](size_type job)
+            {
+                const size_type start = job * rangeSize;
+                func(start, std::min(start + rangeSize, count));
+            });
+    }
+
+    /**@brief Returns a function with the signature void(size_type jobCount, func) that runs the jobs on the scheduler and waits for them.
+     *        This is what parallel_radix_sort and the other algorithms that take a runJobs parameter expect.
+     * @note The scheduler is captured by reference and has to outlive the returned function.
+     */
+    template<typename Scheduler>
+    auto job_runner(Scheduler& scheduler)
+    {
+        return [&scheduler](size_type jobCount, auto&& func) { run_jobs(scheduler, jobCount, func); };
+    }
+}
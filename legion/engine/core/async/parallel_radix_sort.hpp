@@ -0,0 +1,95 @@
+#pragma once
+#include <core/types/primitives.hpp>
+#include <core/platform/platform.hpp>
+
+#include <vector>
+#include <algorithm>
+
+/**
+ * @file parallel_radix_sort.hpp
+ */
+
+namespace legion::core::async
+{
+    /**@struct radix_sort_buffers
+     * @brief Scratch memory of parallel_radix_sort. Keep it around between sorts so that sorting doesn't allocate once it has grown.
+     */
+    struct radix_sort_buffers
+    {
+        std::vector<uint64> keyScratch;
+        std::vector<uint32> valueScratch;
+        std::vector<size_type> histograms;
+    };
+
+    /**@brief Stable least significant digit radix sort of 64 bit keys with a 32 bit value each, 8 bits per pass.
+     *        Every pass histograms and scatters fixed chunks of the keys in parallel, passes in which all keys have the same digit are skipped.
+     * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+     *                Calling them one after the other on a single thread gives the same result.
+     */
+    template<typename RunJobs>
+    void parallel_radix_sort(std::vector<uint64>& keys, std::vector<uint32>& values, radix_sort_buffers& buffers, size_type jobCount, RunJobs&& runJobs)
+    {
+        constexpr size_type radix = 256;
+        const size_type count = keys.size();
+        if (count < 2)
+            return;
+
+        jobCount = std::max<size_type>(1, std::min(jobCount, count));
+        const size_type chunkSize = (count + jobCount - 1) / jobCount;
+
+        buffers.keyScratch.resize(count);
+        buffers.valueScratch.resize(count);
+        buffers.histograms.resize(jobCount * radix);
+
+        for (size_type shift = 0; shift < 64; shift += 8)
+        {
+            // Count the digits of every chunk.
+            runJobs(jobCount, [&](size_type job)
+                {
+                    size_type* histogram = buffers.histograms.data() + job * radix;
+                    std::fill(histogram, histogram + radix, size_type(0));
+
+                    const size_type end = std::min(count, (job + 1) * chunkSize);
+                    for (size_type i = job * chunkSize; i < end; i++)
+                        histogram[(keys[i] >> shift) & 0xff]++;
+                });
+
+            // Turn the counts into the offset every chunk writes each digit to, chunks write their keys after the keys of earlier chunks.
+            bool isUniform = false;
+            size_type offset = 0;
+            for (size_type digit = 0; digit < radix; digit++)
+            {
+                const size_type digitStart = offset;
+                for (size_type job = 0; job < jobCount; job++)
+                {
+                    size_type& entry = buffers.histograms[job * radix + digit];
+                    const size_type digitCount = entry;
+                    entry = offset;
+                    offset += digitCount;
+                }
+
+                if (offset - digitStart == count)
+                    isUniform = true;
+            }
+
+            if (isUniform)
+                continue;
+
+            runJobs(jobCount, [&](size_type job)
+                {
+                    size_type* offsets = buffers.histograms.data() + job * radix;
+
+                    const size_type end = std::min(count, (job + 1) * chunkSize);
+                    for (size_type i = job * chunkSize; i < end; i++)
+                    {
+                        const size_type destination = offsets[(keys[i] >> shift) & 0xff]++;
+                        buffers.keyScratch[destination] = keys[i];
+                        buffers.valueScratch[destination] = values[i];
+                    }
+                });
+
+            keys.swap(buffers.keyScratch);
+            values.swap(buffers.valueScratch);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <core/types/primitives.hpp>
+#include <core/platform/platform.hpp>
+
+#include <atomic>
+
+/**
+ * @file snapshot_buffer.hpp
+ */
+
+namespace legion::core::async
+{
+    /**@class snapshot_buffer
+     * @brief Hands snapshots from a single producer thread to a single consumer thread without either of them waiting.
+     *        The producer fills its own snapshot while the consumer reads its own, finished snapshots are exchanged through a third slot with one atomic swap.
+     *        The consumer always gets the newest published snapshot, older ones it didn't pick up in time are overwritten.
+     *        The slots are reused, so snapshots that keep their capacity (eg: vectors) stop allocating once they have grown.
+     */
+    template<typename T>
+    class snapshot_buffer
+    {
+    public:
+        /**@brief Snapshot the producer can fill, only call from the producer thread.
+         */
+        L_NODISCARD T& write_buffer() noexcept { return m_slots[m_write]; }
+
+        /**@brief Hands the write buffer to the consumer and takes another slot to write the next snapshot in. Only call from the producer thread.
+         */
+        void publish() noexcept
+        {
+            const uint8 previous = m_shared.exchange(static_cast<uint8>(m_write | fresh_bit), std::memory_order_acq_rel);
+            m_write = previous & index_mask;
+        }
+
+        /**@brief Makes the newest published snapshot the read buffer, only call from the consumer thread.
+         * @return False if nothing was published since the last acquire, the read buffer stays the same in that case.
+         */
+        bool acquire() noexcept
+        {
+            if (!(m_shared.load(std::memory_order_relaxed) & fresh_bit))
+                return false;
+
+            const uint8 previous = m_shared.exchange(m_read, std::memory_order_acq_rel);
+            m_read = previous & index_mask;
+            return true;
+        }
+
+        /**@brief Snapshot the consumer got with the last acquire, only call from the consumer thread.
+         */
+        L_NODISCARD const T& read_buffer() const noexcept { return m_slots[m_read]; }
+
+    private:
+        static constexpr uint8 index_mask = 3;
+        static constexpr uint8 fresh_bit = 4;
+
+        T m_slots[3];
+        uint8 m_write = 0;
+        uint8 m_read = 1;
+        //index of the slot that is in between the producer and the consumer, with the fresh bit set when it holds a snapshot the consumer didn't see yet
+        std::atomic<uint8> m_shared = 2;
+    };
+}
@@ -2,6 +2,8 @@
 #include <core/logging/logging.hpp>
 #include <CL/cl_gl.h>
 
+#include <utility>
+
 namespace legion::core::compute
 {
     bool operator&(const buffer_type& lhs, const buffer_type& rhs)
@@ -9,6 +11,19 @@ namespace legion::core::compute
         return static_cast<int>(lhs) & static_cast<int>(rhs);
     }
 
+    namespace
+    {
+        //convert buffer_type to cl_mem_flags
+        cl_mem_flags memFlags(buffer_type type)
+        {
+            if (type == buffer_type::READ_BUFFER)
+                return CL_MEM_READ_ONLY;
+            if (type == buffer_type::WRITE_BUFFER)
+                return CL_MEM_WRITE_ONLY;
+            return CL_MEM_READ_WRITE;
+        }
+    }
+
     Buffer::Buffer(cl_context ctx, void* data, size_type width, size_type height, size_type depth, cl_mem_object_type object_type, cl_image_format* format, buffer_type type, std::string name)
         : m_name(std::move(name))
         , m_data((byte*)data)
@@ -48,7 +63,7 @@ namespace legion::core::compute
         }
 
         m_size = width * height * channelSize;
-        m_ref_count = new size_type(1);
+        m_capacity = m_size;
         //convert buffer_type to cl_mem_flags
         if (type == buffer_type::READ_BUFFER)
             m_type = CL_MEM_READ_ONLY;
@@ -101,7 +116,6 @@ namespace legion::core::compute
         , m_size(0)
     {
         OPTICK_EVENT();
-        m_ref_count = new size_type(1);
         //convert buffer_type to cl_mem_flags
         if (type == buffer_type::READ_BUFFER)
             m_type = CL_MEM_READ_ONLY;
@@ -124,12 +138,10 @@ namespace legion::core::compute
             log::error("clCreateFromGL(X?+)Buffer failed for Buffer: {}", m_name);
         }
     }
-    Buffer::Buffer(cl_context ctx, byte* data, size_t len, buffer_type type, std::string name) :m_size(len), m_data(data), m_name(std::move(name))
+    Buffer::Buffer(cl_context ctx, byte* data, size_t len, buffer_type type, std::string name) : m_name(std::move(name)), m_data(data), m_size(len), m_capacity(len)
     {
         OPTICK_EVENT();
         if (!ctx) return;
-        //initialize new ref-counter
-        m_ref_count = new size_t(1);
 
 
         //convert buffer_type to cl_mem_flags
@@ -158,7 +170,6 @@ namespace legion::core::compute
         , m_size(0)
     {
         OPTICK_EVENT();
-        m_ref_count = new size_type(1);
         //convert buffer_type to cl_mem_flags
         if (type == buffer_type::READ_BUFFER)
             m_type = CL_MEM_READ_ONLY;
@@ -176,52 +187,175 @@ namespace legion::core::compute
         }
     }
 
+    Buffer::Buffer(cl_context ctx, size_type capacity, buffer_type type, std::string name)
+        : m_name(std::move(name))
+        , m_type(memFlags(type))
+        , m_capacity(capacity)
+    {
+        OPTICK_EVENT();
+        if (!ctx) return;
+
+        cl_int ret;
+        m_memory_object = clCreateBuffer(ctx, m_type, m_capacity, nullptr, &ret);
+        if (ret != CL_SUCCESS)
+        {
+            log::error("clCreateBuffer failed for Buffer: {}", m_name);
+            m_memory_object = nullptr;
+            m_capacity = 0;
+        }
+    }
+
     void Buffer::rename(const std::string& name)
     {
         m_name = name;
     }
 
+    bool Buffer::canHold(size_type size, buffer_type type) const
+    {
+        return m_memory_object && size <= m_capacity && m_type == memFlags(type);
+    }
+
+    bool Buffer::setHostData(byte* data, size_type size)
+    {
+        if (size > m_capacity)
+            return false;
+
+        m_data = data;
+        m_size = size;
+        return true;
+    }
+
     Buffer::Buffer(Buffer&& b) noexcept :
         m_name(std::move(b.m_name)),
-        m_memory_object(b.m_memory_object),
-        m_ref_count(b.m_ref_count),
+        m_memory_object(std::exchange(b.m_memory_object, nullptr)),
         m_type(b.m_type),
         m_data(b.m_data),
-        m_size(b.m_size)
+        m_size(b.m_size),
+        m_capacity(b.m_capacity)
     {
-
-        //Move Ctor needs to be explicitly defined
-        //to increase Reference Counter
-     //   ++* m_ref_count;
     }
 
     Buffer::Buffer(const Buffer& b) :
         m_name(b.m_name),
         m_memory_object(b.m_memory_object),
-        //    m_ref_count(b.m_ref_count),
         m_type(b.m_type),
         m_data(b.m_data),
-        m_size(b.m_size)
+        m_size(b.m_size),
+        m_capacity(b.m_capacity)
     {
-        //Copy Ctor needs to be explicitly defined
-        //to increase Reference Counter
-       // if(m_ref_count)
-      //  ++* m_ref_count;
+        //copies share the memory object, OpenCL keeps the reference count
+        if (m_memory_object)
+            clRetainMemObject(m_memory_object);
     }
 
+    Buffer& Buffer::operator=(Buffer&& b) noexcept
+    {
+        if (this != &b)
+        {
+            if (m_memory_object)
+                clReleaseMemObject(m_memory_object);
+            m_name = std::move(b.m_name);
+            m_memory_object = std::exchange(b.m_memory_object, nullptr);
+            m_type = b.m_type;
+            m_data = b.m_data;
+            m_size = b.m_size;
+            m_capacity = b.m_capacity;
+        }
+        return *this;
+    }
 
-
+    Buffer& Buffer::operator=(const Buffer& b)
+    {
+        if (this != &b)
+        {
+            if (b.m_memory_object)
+                clRetainMemObject(b.m_memory_object);
+            if (m_memory_object)
+                clReleaseMemObject(m_memory_object);
+            m_name = b.m_name;
+            m_memory_object = b.m_memory_object;
+            m_type = b.m_type;
+            m_data = b.m_data;
+            m_size = b.m_size;
+            m_capacity = b.m_capacity;
+        }
+        return *this;
+    }
 
     Buffer::~Buffer()
     {
+        //OpenCL defers the release until the commands that use the memory object finished
+        if (m_memory_object)
+            clReleaseMemObject(m_memory_object);
+    }
+
+    PinnedMemory::PinnedMemory(cl_context ctx, cl_command_queue queue, size_type size)
+    {
+        OPTICK_EVENT();
+        if (!ctx || !queue || size == 0) return;
+
+        //the driver allocates page-locked memory for buffers it allocates host memory for, mapping it gives access to that memory
+        cl_int ret;
+        m_memory_object = clCreateBuffer(ctx, CL_MEM_READ_WRITE | CL_MEM_ALLOC_HOST_PTR, size, nullptr, &ret);
+        if (ret != CL_SUCCESS)
+        {
+            log::error("clCreateBuffer failed for pinned memory of {} bytes", size);
+            m_memory_object = nullptr;
+            return;
+        }
+
+        m_data = static_cast<byte*>(clEnqueueMapBuffer(queue, m_memory_object, CL_TRUE, CL_MAP_READ | CL_MAP_WRITE, 0, size, 0, nullptr, nullptr, &ret));
+        if (ret != CL_SUCCESS)
+        {
+            log::error("clEnqueueMapBuffer failed for pinned memory of {} bytes", size);
+            clReleaseMemObject(m_memory_object);
+            m_memory_object = nullptr;
+            m_data = nullptr;
+            return;
+        }
+
+        clRetainCommandQueue(queue);
+        m_queue = queue;
+        m_size = size;
+    }
+
+    PinnedMemory::PinnedMemory(PinnedMemory&& other) noexcept :
+        m_memory_object(std::exchange(other.m_memory_object, nullptr)),
+        m_queue(std::exchange(other.m_queue, nullptr)),
+        m_data(std::exchange(other.m_data, nullptr)),
+        m_size(std::exchange(other.m_size, 0))
+    {
+    }
+
+    PinnedMemory& PinnedMemory::operator=(PinnedMemory&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            m_memory_object = std::exchange(other.m_memory_object, nullptr);
+            m_queue = std::exchange(other.m_queue, nullptr);
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    PinnedMemory::~PinnedMemory()
+    {
+        release();
+    }
 
-        //check if this is the last element
-        //TODO(algo-ryth-mix): make this thread-safe
-        //if (m_ref_count && --*m_ref_count == 0)
-        //{
-        //    //free ref-counter & memory_object
-        //    /*delete m_ref_count;
-        //    clReleaseMemObject(m_memory_object);*/
-        //}
+    void PinnedMemory::release()
+    {
+        if (!m_memory_object)
+            return;
+
+        clEnqueueUnmapMemObject(m_queue, m_memory_object, m_data, 0, nullptr, nullptr);
+        clReleaseMemObject(m_memory_object);
+        clReleaseCommandQueue(m_queue);
+        m_memory_object = nullptr;
+        m_queue = nullptr;
+        m_data = nullptr;
+        m_size = 0;
     }
 }
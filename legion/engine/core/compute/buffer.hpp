@@ -47,25 +47,31 @@ namespace legion::core::compute {
      * @brief Wraps an OpenCL buffer in a more "User-Friendly Interface"
      *        You would normally obtain these via
      *        @ref Context::createBuffer()
+     *        Copies share the same device memory, which is released
+     *        when the last copy is destroyed.
      */
     class Buffer
     {
     public:
 
+        Buffer() = default;
         Buffer(cl_context, void*, size_type, size_type, size_type, cl_mem_object_type, cl_image_format*, buffer_type, std::string);
         Buffer(cl_context, cl_uint, buffer_type, bool, std::string);
         Buffer(cl_context, cl_uint, cl_uint, cl_uint, buffer_type, std::string);
     
         Buffer(cl_context, byte*, size_type, buffer_type, std::string);
 
+        /**
+         * @brief Creates device memory without host data, bind host data with @ref setHostData()
+         *        or keep the contents on the device between kernels.
+         */
+        Buffer(cl_context, size_type capacity, buffer_type, std::string);
+
         Buffer(Buffer&& b) noexcept;
         Buffer(const Buffer& b);
 
-        //copy assign & move assign operator
-        //are deleted since the Buffer
-        //refcounts
-        Buffer& operator=(Buffer&&) noexcept = delete;
-        Buffer& operator=(const Buffer&) = delete;
+        Buffer& operator=(Buffer&&) noexcept;
+        Buffer& operator=(const Buffer&);
 
         void rename(const std::string& name);
 
@@ -89,17 +95,83 @@ namespace legion::core::compute {
          * @brief Checks if OpenCL can write to this buffer.
          */
         bool isWriteBuffer()const { return m_type == CL_MEM_WRITE_ONLY || m_type == CL_MEM_READ_WRITE; }
-        bool isValid() const { return m_data != nullptr; };
+
+        /**
+         * @brief Checks if the buffer has device memory.
+         */
+        bool isValid() const { return m_memory_object != nullptr; }
+
+        /**
+         * @brief Checks if the buffer is bound to host data that gets transferred when it is enqueued.
+         */
+        bool hasHostData() const { return m_data != nullptr; }
+
+        /**
+         * @brief Size of the host data that gets transferred.
+         */
+        size_type size() const { return m_size; }
+
+        /**
+         * @brief Size of the device memory, host data up to this size can be bound without reallocating.
+         */
+        size_type capacity() const { return m_capacity; }
+
+        /**
+         * @brief Checks if the device memory can be reused for host data of a size and direction.
+         */
+        bool canHold(size_type size, buffer_type type) const;
+
+        /**
+         * @brief Binds different host data to the same device memory, so buffers can be reused across kernel invocations.
+         * @return False if the data doesn't fit in the capacity, the buffer is unchanged in that case.
+         */
+        bool setHostData(byte* data, size_type size);
+
     private:
         friend class Program;
         friend class Kernel;
 
         std::string m_name;
-        cl_mem m_memory_object;
-        size_type* m_ref_count;
-        cl_mem_flags m_type;
-        byte* m_data;
-        size_type m_size;
+        cl_mem m_memory_object = nullptr;
+        cl_mem_flags m_type = 0;
+        byte* m_data = nullptr;
+        size_type m_size = 0;
+        size_type m_capacity = 0;
     };
-}
 
+    /**
+     * @class PinnedMemory
+     * @brief Page-locked host memory, obtained via @ref Context::allocatePinned().
+     *        Create a Buffer over data() to feed it to a kernel, transfers from and to
+     *        pinned memory don't need a staging copy by the driver and can overlap
+     *        with kernels when they are enqueued without blocking.
+     */
+    class PinnedMemory
+    {
+    public:
+        PinnedMemory() = default;
+        PinnedMemory(cl_context, cl_command_queue, size_type size);
+
+        PinnedMemory(PinnedMemory&& other) noexcept;
+        PinnedMemory& operator=(PinnedMemory&& other) noexcept;
+        PinnedMemory(const PinnedMemory&) = delete;
+        PinnedMemory& operator=(const PinnedMemory&) = delete;
+
+        ~PinnedMemory();
+
+        bool isValid() const { return m_data != nullptr; }
+        byte* data() const { return m_data; }
+        size_type size() const { return m_size; }
+
+        template <class T>
+        T* as() const { return reinterpret_cast<T*>(m_data); }
+
+    private:
+        void release();
+
+        cl_mem m_memory_object = nullptr;
+        cl_command_queue m_queue = nullptr;
+        byte* m_data = nullptr;
+        size_type m_size = 0;
+    };
+}
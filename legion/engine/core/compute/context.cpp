@@ -2,6 +2,7 @@
 #include <core/logging/logging.hpp>
 
 #include <string>
+#include <vector>
 
 namespace legion::core::compute {
 
@@ -10,6 +11,7 @@ namespace legion::core::compute {
     cl_context Context::m_context = nullptr;
     cl_platform_id Context::m_platform_id = nullptr;
     cl_device_id Context::m_device_id = nullptr;
+    cl_command_queue Context::m_queue = nullptr;
 
 
     void Context::init()
@@ -17,22 +19,37 @@ namespace legion::core::compute {
         OPTICK_EVENT();
         if(m_initialized) return; // if the context already exists do not initialize
 
-        cl_uint ret_num_devices;
         cl_uint ret_num_platforms;
 
-        //get a suitable computing platform
-        cl_int ret = clGetPlatformIDs(1, &m_platform_id, &ret_num_platforms);
+        //get the computing platforms
+        cl_int ret = clGetPlatformIDs(0, nullptr, &ret_num_platforms);
+        if (ret == CL_SUCCESS && ret_num_platforms == 0)
+            ret = CL_DEVICE_NOT_FOUND;
+
+        std::vector<cl_platform_id> platforms(ret_num_platforms);
+        if (ret == CL_SUCCESS)
+            ret = clGetPlatformIDs(ret_num_platforms, platforms.data(), nullptr);
 
     	//error checking for clGetPlatformIDs
         if (ret != CL_SUCCESS)
         {
-            log::error("clGetPlatformIDs failed: {}", ret == CL_INVALID_VALUE ? "CL_INVALID_VALUE (params are bad)" : "CL_OUT_OF_HOST_MEMORY");
+            log::error("clGetPlatformIDs failed: {}", ret == CL_INVALID_VALUE ? "CL_INVALID_VALUE (params are bad)" : ret == CL_DEVICE_NOT_FOUND ? "no platforms installed" : "CL_OUT_OF_HOST_MEMORY");
             return;
         }
 
 
         //get a suitable computing device (this should find the best device in the average pc)
-        ret = clGetDeviceIDs(m_platform_id, CL_DEVICE_TYPE_DEFAULT, 1, &m_device_id, &ret_num_devices);
+        //platforms without devices are skipped, eg: a GPU runtime that is installed without a GPU next to a CPU runtime
+        for (cl_platform_id platform : platforms)
+        {
+            cl_uint ret_num_devices;
+            ret = clGetDeviceIDs(platform, CL_DEVICE_TYPE_DEFAULT, 1, &m_device_id, &ret_num_devices);
+            if (ret == CL_SUCCESS)
+            {
+                m_platform_id = platform;
+                break;
+            }
+        }
 
     	//error checking for clGetDeviceIDs
         if (ret != CL_SUCCESS)
@@ -77,6 +94,16 @@ namespace legion::core::compute {
             return;
         }
 
+        //create the queue of the context
+        m_queue = clCreateCommandQueueWithProperties(m_context, m_device_id, nullptr, &ret);
+        if (ret != CL_SUCCESS)
+        {
+            log::error("clCreateCommandQueueWithProperties failed: {}", ret);
+            clReleaseContext(m_context);
+            m_context = nullptr;
+            return;
+        }
+
     	//if everything works out, we can now assume that the context is initialized
         m_initialized = true;
     }
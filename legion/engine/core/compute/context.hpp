@@ -71,6 +71,29 @@ public:
         return Buffer(m_context,data,size,type,std::forward<std::string>(name));
     }
 
+    /**
+     * @brief Creates an OpenCL Native Buffer without host data, that can be
+     *         kept around and bound to different host data of up to capacity
+     *         bytes with @ref Buffer::setHostData() or used to keep data on
+     *         the device between kernels.
+     */
+    static Buffer createDeviceBuffer(size_type capacity, buffer_type type, std::string name = "")
+    {
+        OPTICK_EVENT();
+        return Buffer(m_context,capacity,type,std::move(name));
+    }
+
+    /**
+     * @brief Allocates page-locked host memory, create a Buffer over its data
+     *         to transfer it. Stays valid until it is destroyed, so transfers
+     *         from it can be enqueued without blocking.
+     */
+    static PinnedMemory allocatePinned(size_type size)
+    {
+        OPTICK_EVENT();
+        return PinnedMemory(m_context,m_queue,size);
+    }
+
     static Buffer createImage(image& img,buffer_type type, std::string name ="")
     {
         OPTICK_EVENT();
@@ -133,11 +156,21 @@ public:
         return m_device_id;
     }
 
+    /**
+     * @brief Returns a command queue owned by the context, used for work
+     *         that doesn't belong to a kernel, eg: mapping pinned memory
+     */
+    static cl_command_queue getQueue()
+    {
+        return m_queue;
+    }
+
 private:
 
     static bool m_initialized;
     static cl_context m_context;
     static cl_platform_id m_platform_id;
     static cl_device_id m_device_id;
+    static cl_command_queue m_queue;
 };
 }
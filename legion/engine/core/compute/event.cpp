@@ -0,0 +1,95 @@
+#include <core/compute/event.hpp>
+#include <core/logging/logging.hpp>
+
+#include <Optick/optick.h>
+
+#include <utility>
+
+namespace legion::core::compute
+{
+    Event::Event(const Event& other) noexcept : m_event(other.m_event)
+    {
+        if (m_event)
+            clRetainEvent(m_event);
+    }
+
+    Event::Event(Event&& other) noexcept : m_event(std::exchange(other.m_event, nullptr))
+    {
+    }
+
+    Event& Event::operator=(const Event& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (other.m_event)
+                clRetainEvent(other.m_event);
+            if (m_event)
+                clReleaseEvent(m_event);
+            m_event = other.m_event;
+        }
+        return *this;
+    }
+
+    Event& Event::operator=(Event&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_event)
+                clReleaseEvent(m_event);
+            m_event = std::exchange(other.m_event, nullptr);
+        }
+        return *this;
+    }
+
+    Event::~Event()
+    {
+        if (m_event)
+            clReleaseEvent(m_event);
+    }
+
+    void Event::wait() const
+    {
+        OPTICK_EVENT();
+        if (!m_event)
+            return;
+
+        const cl_int ret = clWaitForEvents(1, &m_event);
+        if (ret != CL_SUCCESS)
+            log::error("clWaitForEvents failed: {}", ret);
+    }
+
+    bool Event::isComplete() const
+    {
+        if (!m_event)
+            return true;
+
+        cl_int status = CL_COMPLETE;
+        if (clGetEventInfo(m_event, CL_EVENT_COMMAND_EXECUTION_STATUS, sizeof(status), &status, nullptr) != CL_SUCCESS)
+            return true;
+
+        //negative values are errors, the command won't run anymore
+        return status == CL_COMPLETE || status < 0;
+    }
+
+    void Event::waitAll(const std::vector<Event>& events)
+    {
+        OPTICK_EVENT();
+        const std::vector<cl_event> raw = handles(events);
+        if (raw.empty())
+            return;
+
+        const cl_int ret = clWaitForEvents(static_cast<cl_uint>(raw.size()), raw.data());
+        if (ret != CL_SUCCESS)
+            log::error("clWaitForEvents failed: {}", ret);
+    }
+
+    std::vector<cl_event> Event::handles(const std::vector<Event>& events)
+    {
+        std::vector<cl_event> raw;
+        raw.reserve(events.size());
+        for (auto& event : events)
+            if (event.isValid())
+                raw.push_back(event.get());
+        return raw;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include "detail/cl_include.hpp"
+
+#include <core/types/primitives.hpp>
+
+#include <vector>
+
+/**
+ * @file event.hpp
+ */
+
+namespace legion::core::compute {
+
+    /**
+     * @class Event
+     * @brief Wraps a cl_event, marks the completion of a command that was enqueued
+     *        without blocking. Events can be handed to commands on other queues,
+     *        those then wait on the device instead of on the host.
+     */
+    class Event
+    {
+    public:
+        Event() = default;
+
+        /**
+         * @brief Takes ownership of an event returned by an OpenCL enqueue call.
+         */
+        explicit Event(cl_event event) noexcept : m_event(event) {}
+
+        Event(const Event& other) noexcept;
+        Event(Event&& other) noexcept;
+        Event& operator=(const Event& other) noexcept;
+        Event& operator=(Event&& other) noexcept;
+        ~Event();
+
+        /**
+         * @brief Checks if the event belongs to a command, commands that failed to enqueue have no event.
+         */
+        bool isValid() const { return m_event != nullptr; }
+
+        /**
+         * @brief Blocks until the command finished, returns immediately for invalid events.
+         */
+        void wait() const;
+
+        /**
+         * @brief Checks if the command finished without blocking, invalid events count as finished.
+         */
+        bool isComplete() const;
+
+        cl_event get() const { return m_event; }
+
+        /**
+         * @brief Blocks until all commands finished.
+         */
+        static void waitAll(const std::vector<Event>& events);
+
+        /**
+         * @brief Raw handles of the valid events, in the form the wait lists of OpenCL calls take them.
+         */
+        static std::vector<cl_event> handles(const std::vector<Event>& events);
+
+    private:
+        cl_event m_event = nullptr;
+    };
+}
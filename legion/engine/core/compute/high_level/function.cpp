@@ -1,30 +1,73 @@
 #include <core/compute/high_level/function.hpp>
 #include <core/compute/context.hpp>
 
+#include <algorithm>
+
 
 namespace legion::core::compute
 {
-    common::result<void, void> function_base::invoke(dvar global, invoke_buffer_container& parameters, std::vector<karg> kargs) const
+    std::vector<Buffer> function_base::bind_persistent_buffers(invoke_buffer_container& parameters) const
     {
         OPTICK_EVENT();
+        if (m_persistentBuffers.size() < parameters.size())
+            m_persistentBuffers.resize(parameters.size());
+
         std::vector<Buffer> buffers;
         buffers.reserve(parameters.size());
 
-        for (auto& [base, type] : parameters)
+        for (size_type i = 0; i < parameters.size(); i++)
         {
-            if (base && base->container.first != nullptr)
-                buffers.emplace_back(Context::createBuffer(base->container.first, base->container.second, type, base->name));
+            auto& [base, type] = parameters[i];
+            if (!base || base->container.first == nullptr)
+                continue;
+
+            auto& [data, size] = base->container;
+            Buffer& persistent = m_persistentBuffers[i];
+            if (!persistent.canHold(size, type))
+            {
+                //grows by half so parameters that grow a little every invocation don't reallocate every time
+                const size_type capacity = (std::max)(size, persistent.capacity() + persistent.capacity() / 2);
+                persistent = Context::createDeviceBuffer(capacity, type);
+            }
+
+            persistent.rename(base->name);
+            persistent.setHostData(data, size);
+            buffers.push_back(persistent);
         }
-        return invoke2(std::move(global), buffers, std::move(kargs));
+        return buffers;
     }
 
     common::result<void, void> function_base::invoke2(dvar global, std::vector<Buffer> buffers, std::vector<karg> kargs) const
+    {
+        OPTICK_EVENT();
+        //the host data outlives the call, so the transfers don't need to block, finish waits for all of them at once
+        if (!enqueue_commands(std::move(global), buffers, kargs, {}, block_mode::NON_BLOCKING))
+            return common::Err();
+
+        m_kernel->finish();
+
+        return common::Ok();
+    }
+
+    Event function_base::enqueue2(dvar global, std::vector<Buffer> buffers, std::vector<karg> kargs, const std::vector<Event>& waitFor) const
+    {
+        OPTICK_EVENT();
+        if (!enqueue_commands(std::move(global), buffers, kargs, waitFor, block_mode::NON_BLOCKING))
+            return Event();
+
+        //submit the commands so the device starts on them while the host goes on
+        m_kernel->flush();
+
+        return m_kernel->lastEvent();
+    }
+
+    bool function_base::enqueue_commands(dvar global, std::vector<Buffer>& buffers, std::vector<karg>& kargs, const std::vector<Event>& waitFor, block_mode mode) const
     {
         OPTICK_EVENT();
         if(!m_kernel)
         {
             log::error("something went wrong your openCL kernel is null");
-            return common::Err();
+            return false;
         }
         if (std::holds_alternative<std::tuple<size_type, size_type, size_type>>(global))
         {
@@ -44,6 +87,7 @@ namespace legion::core::compute
         }
 
         m_kernel->readWriteMode(buffer_type::READ_BUFFER);
+        m_kernel->waitFor(waitFor);
 
         cl_uint i = 0;
         for (Buffer& buffer : buffers)
@@ -60,7 +104,7 @@ namespace legion::core::compute
 
             if (buffer.isReadBuffer())
             {
-                m_kernel->enqueueBuffer(buffer);
+                m_kernel->enqueueBuffer(buffer, mode);
             }
 
         }
@@ -82,12 +126,11 @@ namespace legion::core::compute
             if (!buffer.isValid()) continue;
             if (buffer.isWriteBuffer())
             {
-                m_kernel->enqueueBuffer(buffer);
+                m_kernel->enqueueBuffer(buffer, mode);
             }
 
         }
-        m_kernel->finish();
 
-        return common::Ok();
+        return true;
     }
 }
@@ -8,6 +8,7 @@
 #include <core/types/primitives.hpp>
 #include <core/types/meta.hpp>
 #include <core/compute/buffer.hpp>
+#include <core/compute/event.hpp>
 #include <core/compute/kernel.hpp>
 #include <core/compute/program.hpp>
 #include <core/detail/internals.hpp>
@@ -130,14 +131,26 @@ namespace legion::core::compute {
             std::tuple<size_type, size_type, size_type>
         >;
 
-        //invokes the NdRangeKernel
-        [[nodiscard]] common::result<void, void> invoke(dvar global, invoke_buffer_container& parameters, std::vector<karg> kernelArgs) const;
+        //invokes the NdRangeKernel and waits for it and the transfers to finish
         [[nodiscard]] common::result<void, void> invoke2(dvar global, std::vector<Buffer> buffers, std::vector<karg> kernelArgs) const;
 
+        //enqueues the NdRangeKernel and the transfers without blocking, returns the event of the last command
+        [[nodiscard]] Event enqueue2(dvar global, std::vector<Buffer> buffers, std::vector<karg> kernelArgs, const std::vector<Event>& waitFor) const;
+
+        //binds the vector parameters to the persistent device buffers
+        std::vector<Buffer> bind_persistent_buffers(invoke_buffer_container& parameters) const;
+
 
         std::shared_ptr<Kernel> m_kernel;
         std::shared_ptr<Program> m_program;
         size_t m_locals = 512;
+
+        //device buffers of the vector parameters by position, reused by the next invocation
+        //and only reallocated when a parameter outgrows its buffer or changes direction
+        mutable std::vector<Buffer> m_persistentBuffers;
+
+    private:
+        bool enqueue_commands(dvar global, std::vector<Buffer>& buffers, std::vector<karg>& kernelArgs, const std::vector<Event>& waitFor, block_mode mode) const;
     public:
 
 
@@ -174,6 +187,7 @@ namespace legion::core::compute {
             m_program = std::move(other.m_program);
             m_kernel = std::move(other.m_kernel);
             m_locals = std::move(other.m_locals);
+            m_persistentBuffers = std::move(other.m_persistentBuffers);
         }
         function(const function& other)
         {
@@ -194,6 +208,7 @@ namespace legion::core::compute {
             m_program = std::move(other.m_program);
             m_kernel = std::move(other.m_kernel);
             m_locals = std::move(other.m_locals);
+            m_persistentBuffers = std::move(other.m_persistentBuffers);
             return *this;
         }
         /**
@@ -216,36 +231,27 @@ namespace legion::core::compute {
         common::result<void, void> operator()(std::variant<size_type, math::ivec2, math::ivec3> dispatch_size, Args&&... args)
         {
             OPTICK_EVENT();
-            dvar dim;
-
-            if (std::holds_alternative<size_type>(dispatch_size))
-            {
-                dim = std::make_tuple(std::get<0>(dispatch_size));
-            }
-            else if (std::holds_alternative<math::ivec2>(dispatch_size))
-            {
-                dim = std::make_tuple(static_cast<size_type>(std::get<1>(dispatch_size)[0]),
-                    static_cast<size_type>(std::get<1>(dispatch_size)[1]));
-            }
-            else if (std::holds_alternative<math::ivec3>(dispatch_size))
-            {
-                dim = std::make_tuple(static_cast<size_type>(std::get<2>(dispatch_size)[0]),
-                    static_cast<size_type>(std::get<2>(dispatch_size)[1]),
-                    static_cast<size_type>(std::get<2>(dispatch_size)[2]));
-            }
+            auto [buffers, kargs] = prepare(std::forward<Args>(args)...);
+            return invoke2(to_dimensions(dispatch_size), std::move(buffers), std::move(kargs));
+        }
 
-            //check if we are dealing with a list of buffers or a list of vectors
-            //TODO(algo-ryth-mix) Update the cppcheck version of the CI once this bug is resolved!
-            //cppcheck has an issue with if contexpr and the || in here
-            //cppcheck-suppress internalAstError
-            if constexpr (((std::is_same_v<compute::Buffer, std::remove_reference_t<Args>> || std::is_same_v<karg, Args>) && ...))
-            {
-                return invoke_helper_buffers(dim, std::forward<Args>(args)...);
-            }
-            else
-            {
-                return invoke_helper_raw(dim, std::forward<Args>(args)...);
-            }
+        /**
+         * @brief Enqueues the wrapped kernel and the transfers of the passed buffers without blocking,
+         *        the kernel has a queue of its own so enqueues of different functions run at the same time.
+         * @param waitFor Events that need to complete before the transfers and the kernel start, eg: of the
+         *         function that produces the input.
+         * @param dispatch_size How many items to process.
+         * @param args a collection of either vectors and wrapped vectors or compute::Buffers
+         * @note The device reads from and writes to the passed vectors until the returned event completes,
+         *        they need to stay alive and keep their size until then.
+         * @return Event of the last command, invalid if the kernel couldn't be enqueued.
+         */
+        template <typename... Args>
+        Event enqueue(const std::vector<Event>& waitFor, std::variant<size_type, math::ivec2, math::ivec3> dispatch_size, Args&&... args)
+        {
+            OPTICK_EVENT();
+            auto [buffers, kargs] = prepare(std::forward<Args>(args)...);
+            return enqueue2(to_dimensions(dispatch_size), std::move(buffers), std::move(kargs), waitFor);
         }
 
 
@@ -309,8 +315,41 @@ namespace legion::core::compute {
 
 
     private:
+        static dvar to_dimensions(std::variant<size_type, math::ivec2, math::ivec3> dispatch_size)
+        {
+            if (std::holds_alternative<math::ivec2>(dispatch_size))
+            {
+                return std::make_tuple(static_cast<size_type>(std::get<1>(dispatch_size)[0]),
+                    static_cast<size_type>(std::get<1>(dispatch_size)[1]));
+            }
+            else if (std::holds_alternative<math::ivec3>(dispatch_size))
+            {
+                return std::make_tuple(static_cast<size_type>(std::get<2>(dispatch_size)[0]),
+                    static_cast<size_type>(std::get<2>(dispatch_size)[1]),
+                    static_cast<size_type>(std::get<2>(dispatch_size)[2]));
+            }
+            return std::make_tuple(std::get<0>(dispatch_size));
+        }
+
+        template <typename... Args>
+        std::pair<std::vector<Buffer>, std::vector<karg>> prepare(Args&&... args)
+        {
+            //check if we are dealing with a list of buffers or a list of vectors
+            //TODO(algo-ryth-mix) Update the cppcheck version of the CI once this bug is resolved!
+            //cppcheck has an issue with if contexpr and the || in here
+            //cppcheck-suppress internalAstError
+            if constexpr (((std::is_same_v<compute::Buffer, std::remove_reference_t<Args>> || std::is_same_v<karg, Args>) && ...))
+            {
+                return prepare_buffers(std::forward<Args>(args)...);
+            }
+            else
+            {
+                return prepare_raw(std::forward<Args>(args)...);
+            }
+        }
+
         template <typename... Args>
-        common::result<void, void> invoke_helper_raw(dvar dispatch_size, Args&& ... args)
+        std::pair<std::vector<Buffer>, std::vector<karg>> prepare_raw(Args&& ... args)
         {
             OPTICK_EVENT();
             //do some sanity checking args either need to be in(vector) out(vector) inout(vector) vector or karg
@@ -338,11 +377,11 @@ namespace legion::core::compute {
 
 
             //we finally transformed it into a way that the non-templated function can use
-            return invoke(dispatch_size, vector, kargs);
+            return { bind_persistent_buffers(vector), std::move(kargs) };
         }
 
         template <typename... Args>
-        common::result<void, void> invoke_helper_buffers(dvar dispatch_size, Args&&... args)
+        std::pair<std::vector<Buffer>, std::vector<karg>> prepare_buffers(Args&&... args)
         {
             OPTICK_EVENT();
             static_assert(((std::is_same_v<compute::Buffer, std::remove_reference_t<Args>> || std::is_same_v<karg, std::remove_reference_t<Args>> ) && ...),
@@ -361,7 +400,7 @@ namespace legion::core::compute {
                     return std::vector<Buffer>{ function::transform_to_buffer(x)... };
                 }, tpl);
 
-            return invoke2(dispatch_size, buffers, kargs);
+            return { std::move(buffers), std::move(kargs) };
         }
     };
 }
@@ -112,6 +112,14 @@ namespace legion::core::compute
         if (!buffer.m_data)
             return *this;
 
+        //block_mode::BLOCKING is the false value of the enum, so it can't be cast to cl_bool
+        const cl_bool blockingTransfer = blocking == block_mode::BLOCKING ? CL_TRUE : CL_FALSE;
+
+        const std::vector<cl_event> waitHandles = Event::handles(m_waitList);
+        const cl_uint waitCount = static_cast<cl_uint>(waitHandles.size());
+        const cl_event* waitList = waitHandles.empty() ? nullptr : waitHandles.data();
+        cl_event event = nullptr;
+
         cl_int ret;
         switch (buffer.m_type)
         {
@@ -119,13 +127,13 @@ namespace legion::core::compute
             //buffer was read only
         case CL_MEM_READ_ONLY:
             //we "write" to a read only buffer because it is readonly for the kernel
-            ret = clEnqueueWriteBuffer(m_queue, buffer.m_memory_object, static_cast<cl_bool>(blocking), 0, buffer.m_size, buffer.m_data, 0, nullptr, nullptr);
+            ret = clEnqueueWriteBuffer(m_queue, buffer.m_memory_object, blockingTransfer, 0, buffer.m_size, buffer.m_data, waitCount, waitList, &event);
             break;
 
             //buffer was write only
         case CL_MEM_WRITE_ONLY:
             //similarly we read from a buffer that was write-only for the kernel 
-            ret = clEnqueueReadBuffer(m_queue, buffer.m_memory_object, static_cast<cl_bool>(blocking), 0, buffer.m_size, buffer.m_data, 0, nullptr, nullptr);
+            ret = clEnqueueReadBuffer(m_queue, buffer.m_memory_object, blockingTransfer, 0, buffer.m_size, buffer.m_data, waitCount, waitList, &event);
             break;
 
             //buffer is read and write the default read/write mode needs to decide
@@ -134,12 +142,12 @@ namespace legion::core::compute
             {
             case buffer_type::READ_BUFFER:
                 //the mode was read on the host so we write to the kernel
-                ret = clEnqueueWriteBuffer(m_queue, buffer.m_memory_object, static_cast<cl_bool>(blocking), 0, buffer.m_size, buffer.m_data, 0, nullptr, nullptr);
+                ret = clEnqueueWriteBuffer(m_queue, buffer.m_memory_object, blockingTransfer, 0, buffer.m_size, buffer.m_data, waitCount, waitList, &event);
                 break;
 
             case buffer_type::WRITE_BUFFER:
                 //again the mode was write on the host so we read from it
-                ret = clEnqueueReadBuffer(m_queue, buffer.m_memory_object, static_cast<cl_bool>(blocking), 0, buffer.m_size, buffer.m_data, 0, nullptr, nullptr);
+                ret = clEnqueueReadBuffer(m_queue, buffer.m_memory_object, blockingTransfer, 0, buffer.m_size, buffer.m_data, waitCount, waitList, &event);
                 break;
 
             default:
@@ -149,6 +157,7 @@ namespace legion::core::compute
         default: throw std::logic_error("Buffer was neither read nor write nor readwrite");
         }
 
+        m_lastEvent = Event(ret == CL_SUCCESS ? event : nullptr);
         if (ret != CL_SUCCESS)
             log::error("clEnqueueXXXXBuffer {}", ret);
 
@@ -190,6 +199,9 @@ namespace legion::core::compute
     {
         OPTICK_EVENT();
         auto [globals, locals, size] = parse_dimensions();
+        const std::vector<cl_event> waitList = Event::handles(m_waitList);
+        cl_event event = nullptr;
+
         //enqueue the Kernel in the command queue
         cl_int ret = clEnqueueNDRangeKernel(
             m_queue,
@@ -198,11 +210,15 @@ namespace legion::core::compute
             nullptr,
             globals.data(),
             locals.data(),
-            0,
-            nullptr,
-            nullptr
+            static_cast<cl_uint>(waitList.size()),
+            waitList.empty() ? nullptr : waitList.data(),
+            &event
         );
 
+        //the commands after the dispatch are ordered after it by the queue
+        m_waitList.clear();
+        m_lastEvent = Event(ret == CL_SUCCESS ? event : nullptr);
+
         //check if the enqueue was successful
         if (ret != CL_SUCCESS)
         {
@@ -211,6 +227,19 @@ namespace legion::core::compute
         return *this;
     }
 
+    Kernel& Kernel::waitFor(const std::vector<Event>& events)
+    {
+        OPTICK_EVENT();
+        m_waitList.insert(m_waitList.end(), events.begin(), events.end());
+        return *this;
+    }
+
+    void Kernel::flush() const
+    {
+        OPTICK_EVENT();
+        clFlush(m_queue);
+    }
+
     void Kernel::finish() const
     {
         OPTICK_EVENT();
@@ -2,6 +2,7 @@
 #include "detail/cl_include.hpp"
 
 #include <core/compute/buffer.hpp>
+#include <core/compute/event.hpp>
 #include <core/logging/logging.hpp>
 #include <variant>
 #include <map>
@@ -21,6 +22,8 @@ namespace legion::core::compute
      * @class Kernel
      * @brief Wraps a cl_kernel, allows you to parametrize an
      *         OpenCL kernel without worrying about the CommandQueue
+     *         Every kernel has a queue of its own, so kernels can be in
+     *         flight at the same time, use events to order them.
      */
     class Kernel
     {
@@ -49,6 +52,8 @@ namespace legion::core::compute
               m_prog(other.m_prog),
               m_func(other.m_func),
               m_queue(other.m_queue),
+              m_waitList(other.m_waitList),
+              m_lastEvent(other.m_lastEvent),
               m_global_size(other.m_global_size),
               m_local_size(other.m_local_size)
         {
@@ -62,6 +67,8 @@ namespace legion::core::compute
               m_prog(other.m_prog),
               m_func(other.m_func),
               m_queue(other.m_queue),
+              m_waitList(std::move(other.m_waitList)),
+              m_lastEvent(std::move(other.m_lastEvent)),
               m_global_size(std::move(other.m_global_size)),
               m_local_size(std::move(other.m_local_size))
         {
@@ -79,6 +86,8 @@ namespace legion::core::compute
             m_prog = other.m_prog;
             m_func = other.m_func;
             m_queue = other.m_queue;
+            m_waitList = other.m_waitList;
+            m_lastEvent = other.m_lastEvent;
             m_global_size = other.m_global_size;
             m_local_size = other.m_local_size;
             if(m_refcounter) ++*m_refcounter;
@@ -96,6 +105,8 @@ namespace legion::core::compute
             m_prog = other.m_prog;
             m_func = other.m_func;
             m_queue = other.m_queue;
+            m_waitList = std::move(other.m_waitList);
+            m_lastEvent = std::move(other.m_lastEvent);
             m_global_size = std::move(other.m_global_size);
             m_local_size = std::move(other.m_local_size);
             if(m_refcounter)++*m_refcounter;
@@ -252,6 +263,23 @@ namespace legion::core::compute
          */
         Kernel& dispatch();
 
+        /**
+         * @brief Makes the commands enqueued up to and including the next dispatch wait for events,
+         *         eg: of a kernel on another queue that produces the input, without blocking the host.
+         */
+        Kernel& waitFor(const std::vector<Event>& events);
+
+        /**
+         * @brief Event of the last command enqueued on the queue of this kernel,
+         *         in-order queues finish the commands before it first.
+         */
+        Event lastEvent() const { return m_lastEvent; }
+
+        /**
+         * @brief Submits the enqueued commands to the device without waiting for them.
+         */
+        void flush() const;
+
         /**
          * @brief Ensures that the command-queue is committed and finished executing
          * @pre dispatch
@@ -273,6 +301,9 @@ namespace legion::core::compute
         Program* m_prog;
         cl_kernel m_func;
         cl_command_queue m_queue;
+        //events the commands up to the next dispatch wait for
+        std::vector<Event> m_waitList;
+        Event m_lastEvent;
 
         std::tuple<std::vector<size_type>,std::vector<size_type>,size_type> parse_dimensions()
         {
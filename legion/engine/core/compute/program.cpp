@@ -4,6 +4,9 @@
 #include <core/filesystem/resource.hpp>
 #include <core/compute/context.hpp>
 
+#include <string>
+#include <string_view>
+
 namespace legion::core::compute {
 
 
@@ -51,7 +54,7 @@ namespace legion::core::compute {
 
         // clBuildProgram parameters guide:
         //
-        // -cl-std=2.0: We want OpenCL Standard 2.0 the driver reports 1.2 but it actually is 2.0 on most devices
+        // -cl-std=2.0: We want OpenCL Standard 2.0 the driver reports 1.2 but it actually is 2.0 on most devices, devices that only report OpenCL C 1.x get that version
         // -cl-kernel-arg-info: We want kernel informations built into the binary so that we can query the kernel args by name instead of index
         // -DLEGION_LIBRARY this is indicates to your kernel that it was built for use with the ARGS-Engine, it defines the macor LEGION_LIBRARY
         // -DDEBUG if the Engine is built in debug mode, the kernel  will also receive the DEBUG define
@@ -59,14 +62,28 @@ namespace legion::core::compute {
 
         /*if (!source_is_il) {*/
 
+        //devices that only support OpenCL C 1.x, eg: some CPU runtimes, get the newest standard they do support
+        std::string options = "-cl-std=CL2.0 -cl-kernel-arg-info -DLEGION_LIBRARY";
+        {
+            char version[128] = {};
+            if (clGetDeviceInfo(device, CL_DEVICE_OPENCL_C_VERSION, sizeof(version) - 1, version, nullptr) == CL_SUCCESS)
+            {
+                //formatted as "OpenCL C <major>.<minor> <vendor info>"
+                const std::string_view versionView(version);
+                if (versionView.size() > 11 && versionView[9] == '1')
+                    options = std::string("-cl-std=CL1.") + versionView[11] + " -cl-kernel-arg-info -DLEGION_LIBRARY";
+            }
+        }
+
         //check if we are running in debug and adjust build command accordingly
         if constexpr (LEGION_CONFIGURATION == LEGION_DEBUG_VALUE) {
             //DEBUG
-            ret = clBuildProgram(m_program, 1, &device, "-cl-std=CL2.0 -cl-kernel-arg-info -DLEGION_LIBRARY -DDEBUG ", nullptr, nullptr);
+            options += " -DDEBUG ";
         } else {
             //NDEBUG
-            ret = clBuildProgram(m_program, 1, &device, "-cl-std=CL2.0 -cl-kernel-arg-info -DLEGION_LIBRARY -DNDEBUG", nullptr, nullptr);
+            options += " -DNDEBUG";
         }
+        ret = clBuildProgram(m_program, 1, &device, options.c_str(), nullptr, nullptr);
 
         //check if building was successful
         if (ret != CL_SUCCESS)
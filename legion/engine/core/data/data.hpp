@@ -1,2 +1,4 @@
 #pragma once
 #include<core/data/mesh.hpp>
+#include<core/data/debug_lines.hpp>
+#include<core/data/octree.hpp>
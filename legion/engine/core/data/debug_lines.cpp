@@ -0,0 +1,270 @@
+#include <core/data/debug_lines.hpp>
+
+#include <algorithm>
+#include <thread>
+
+namespace legion::core
+{
+    std::atomic_bool DebugLineBuffer::m_registryLocked = { false };
+    std::vector<std::unique_ptr<DebugLineBuffer::thread_lines>> DebugLineBuffer::m_threads;
+    thread_local DebugLineBuffer::thread_owner DebugLineBuffer::m_localLines;
+    double DebugLineBuffer::m_time = 0.0;
+    std::map<uint64, DebugLineBuffer::vertex_buckets> DebugLineBuffer::m_timedLines;
+    DebugLineBuffer::vertex_buckets DebugLineBuffer::m_merged;
+    std::vector<DebugLineBuffer::thread_lines*> DebugLineBuffer::m_exited;
+
+    void DebugLineBuffer::thread_lines::lock() noexcept
+    {
+        while (locked.exchange(true, std::memory_order_acquire))
+            while (locked.load(std::memory_order_relaxed))
+                L_PAUSE_INSTRUCTION();
+    }
+
+    void DebugLineBuffer::thread_lines::unlock() noexcept
+    {
+        locked.store(false, std::memory_order_release);
+    }
+
+    void DebugLineBuffer::thread_lines::swap() noexcept
+    {
+        for (size_type i = 0; i < width_buckets; i++)
+        {
+            std::swap(writing[i], published[i]);
+            writing[i].clear();
+        }
+    }
+
+    void DebugLineBuffer::thread_lines::append() noexcept
+    {
+        for (size_type i = 0; i < width_buckets; i++)
+        {
+            published[i].insert(published[i].end(), writing[i].begin(), writing[i].end());
+            writing[i].clear();
+        }
+    }
+
+    bool DebugLineBuffer::thread_lines::drew() const noexcept
+    {
+        for (auto& bucketVertices : writing)
+            if (!bucketVertices.empty())
+                return true;
+        return false;
+    }
+
+    DebugLineBuffer::thread_owner::~thread_owner()
+    {
+        if (!lines)
+            return;
+
+        //the entry is only removed after it was marked, so it still exists here
+        lines->lock();
+        lines->append();
+        lines->exited = true;
+        lines->unlock();
+    }
+
+    size_type DebugLineBuffer::width_bucket(float width) noexcept
+    {
+        const int bucket = static_cast<int>(width / width_step + 0.5f);
+        if (bucket < 0)
+            return 0;
+        if (bucket >= static_cast<int>(width_buckets))
+            return width_buckets - 1;
+        return static_cast<size_type>(bucket);
+    }
+
+    float DebugLineBuffer::bucket_width(size_type bucket) noexcept
+    {
+        return static_cast<float>(bucket) * width_step;
+    }
+
+    void DebugLineBuffer::add(const math::vec3& start, const math::vec3& end, const math::color& color, float width, float time, bool ignoreDepth)
+    {
+        const math::vec3 vertices[] = { start, end };
+        add(vertices, 2, color, width, time, ignoreDepth);
+    }
+
+    void DebugLineBuffer::add(const math::vec3* vertices, size_type vertexCount, const math::color& color, float width, float time, bool ignoreDepth)
+    {
+        thread_lines& lines = localLines();
+        const size_type bucket = width_bucket(width);
+        const uint32 depth = ignoreDepth ? 1u : 0u;
+
+        lines.lock();
+        if (time > 0.f)
+        {
+            for (size_type i = 0; i + 1 < vertexCount; i += 2)
+                lines.timed.push_back({ { vertices[i], color, depth }, { vertices[i + 1], color, depth }, time, bucket });
+        }
+        else
+        {
+            auto& bucketVertices = lines.writing[bucket];
+            for (size_type i = 0; i + 1 < vertexCount; i += 2)
+            {
+                bucketVertices.push_back({ vertices[i], color, depth });
+                bucketVertices.push_back({ vertices[i + 1], color, depth });
+            }
+        }
+        lines.unlock();
+    }
+
+    void DebugLineBuffer::publish()
+    {
+        thread_lines& local = localLines();
+
+        lockRegistry();
+        local.publishes = true;
+        local.lock();
+        //another thread published part of this frame before this thread ended its first frame, the rest belongs to the same frame
+        if (local.publisher)
+            local.append();
+        else
+            local.swap();
+        local.publisher = nullptr;
+        local.unlock();
+
+        for (auto& lines : m_threads)
+        {
+            if (lines.get() == &local || lines->publishes)
+                continue;
+
+            lines->lock();
+            //the last lines of a thread that exited were already published by the thread itself
+            if (lines->exited)
+            {
+                lines->unlock();
+                continue;
+            }
+
+            //lines another thread published are still part of the current frame of that thread, so they are added to instead of replaced
+            const bool drew = lines->drew();
+            if (drew && lines->publisher && lines->publisher != &local)
+                lines->append();
+            else if (drew || lines->publisher == &local)
+                lines->swap();
+
+            if (drew)
+                lines->publisher = &local;
+            else if (lines->publisher == &local)
+                lines->publisher = nullptr;
+            lines->unlock();
+        }
+        unlockRegistry();
+    }
+
+    void DebugLineBuffer::merge(time::span deltaTime, debug_line_frame& output)
+    {
+        OPTICK_EVENT();
+        output.clear();
+        for (auto& bucketVertices : m_merged)
+            bucketVertices.clear();
+
+        m_time += static_cast<double>(deltaTime.seconds());
+
+        //lines live until the end of the step they expire in, so whole groups can be dropped at once
+        const uint64 currentStep = static_cast<uint64>(m_time / lifetime_step);
+        while (!m_timedLines.empty() && m_timedLines.begin()->first < currentStep)
+            m_timedLines.erase(m_timedLines.begin());
+
+        lockRegistry();
+        m_exited.clear();
+        for (auto& lines : m_threads)
+        {
+            lines->lock();
+            //threads that exit after this are removed by the next merge, so none of their lines are lost
+            if (lines->exited)
+                m_exited.push_back(lines.get());
+            for (size_type i = 0; i < width_buckets; i++)
+                m_merged[i].insert(m_merged[i].end(), lines->published[i].begin(), lines->published[i].end());
+
+            for (auto& line : lines->timed)
+            {
+                auto& bucketVertices = m_timedLines[static_cast<uint64>((m_time + line.time) / lifetime_step)][line.bucket];
+                bucketVertices.push_back(line.start);
+                bucketVertices.push_back(line.end);
+            }
+            lines->timed.clear();
+            lines->unlock();
+        }
+
+        //the lines of threads that exited are merged now, so their buffers can go
+        if (!m_exited.empty())
+        {
+            auto wasMerged = [](const thread_lines* lines) { return std::find(m_exited.begin(), m_exited.end(), lines) != m_exited.end(); };
+            m_threads.erase(std::remove_if(m_threads.begin(), m_threads.end(), [&](const std::unique_ptr<thread_lines>& lines) { return wasMerged(lines.get()); }), m_threads.end());
+
+            //a thread that publishes could be allocated at the address of a removed one, so no thread may still refer to it
+            for (auto& lines : m_threads)
+            {
+                lines->lock();
+                if (wasMerged(lines->publisher))
+                    lines->publisher = nullptr;
+                lines->unlock();
+            }
+        }
+        unlockRegistry();
+
+        for (size_type i = 0; i < width_buckets; i++)
+        {
+            const size_type first = output.vertices.size();
+            output.vertices.insert(output.vertices.end(), m_merged[i].begin(), m_merged[i].end());
+            for (auto& [step, group] : m_timedLines)
+                output.vertices.insert(output.vertices.end(), group[i].begin(), group[i].end());
+
+            const size_type count = output.vertices.size() - first;
+            if (count)
+                output.batches.push_back({ bucket_width(i), first, count });
+        }
+    }
+
+    void DebugLineBuffer::clear()
+    {
+        lockRegistry();
+        for (auto& lines : m_threads)
+        {
+            lines->lock();
+            for (size_type i = 0; i < width_buckets; i++)
+            {
+                lines->writing[i].clear();
+                lines->published[i].clear();
+            }
+            lines->timed.clear();
+            lines->unlock();
+        }
+        m_timedLines.clear();
+        unlockRegistry();
+    }
+
+    size_type DebugLineBuffer::thread_count()
+    {
+        lockRegistry();
+        const size_type count = m_threads.size();
+        unlockRegistry();
+        return count;
+    }
+
+    DebugLineBuffer::thread_lines& DebugLineBuffer::localLines()
+    {
+        if (!m_localLines.lines)
+        {
+            auto lines = std::make_unique<thread_lines>();
+            m_localLines.lines = lines.get();
+
+            lockRegistry();
+            m_threads.push_back(std::move(lines));
+            unlockRegistry();
+        }
+        return *m_localLines.lines;
+    }
+
+    void DebugLineBuffer::lockRegistry() noexcept
+    {
+        while (m_registryLocked.exchange(true, std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    void DebugLineBuffer::unlockRegistry() noexcept
+    {
+        m_registryLocked.store(false, std::memory_order_release);
+    }
+}
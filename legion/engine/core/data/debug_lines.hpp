@@ -0,0 +1,156 @@
+#pragma once
+#include <core/types/primitives.hpp>
+#include <core/platform/platform.hpp>
+#include <core/math/math.hpp>
+#include <core/time/time.hpp>
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * @file debug_lines.hpp
+ */
+
+namespace legion::core
+{
+    /**@struct debug_vertex
+     * @brief Vertex of a debug line, laid out the way the debug shader reads it so the lines can be uploaded as they are.
+     */
+    struct debug_vertex
+    {
+        math::vec3 position;
+        math::color color;
+        uint32 ignoreDepth;
+    };
+
+    /**@struct debug_line_batch
+     * @brief Range of vertices that are drawn with the same line width.
+     */
+    struct debug_line_batch
+    {
+        float width;
+        size_type first;
+        size_type count;
+    };
+
+    /**@struct debug_line_frame
+     * @brief All the debug lines of a frame, the vertices of a batch are contiguous so each batch is a single draw.
+     */
+    struct debug_line_frame
+    {
+        std::vector<debug_vertex> vertices;
+        std::vector<debug_line_batch> batches;
+
+        void clear() noexcept
+        {
+            vertices.clear();
+            batches.clear();
+        }
+    };
+
+    /**@class DebugLineBuffer
+     * @brief Immediate mode storage of debug lines. Every thread appends to its own buffers, so drawing a line never allocates an event or waits on other threads.
+     *        Lines without a lifetime are replaced each time the thread that drew them ends a frame, lines with a lifetime are kept in groups that expire together.
+     *        Widths are rounded to a small set of buckets and the lines of a bucket end up next to each other, so a frame needs one draw per width in use.
+     */
+    class DebugLineBuffer
+    {
+    public:
+        static constexpr size_type width_buckets = 16;
+        static constexpr float width_step = 0.5f;
+        static constexpr float lifetime_step = 1.f / 16.f;
+
+        /**@brief Bucket a line width ends up in, widths are rounded to multiples of width_step.
+         */
+        L_NODISCARD static size_type width_bucket(float width) noexcept;
+
+        /**@brief Width the lines in a bucket are drawn with.
+         */
+        L_NODISCARD static float bucket_width(size_type bucket) noexcept;
+
+        /**@brief Adds a line to the buffers of the calling thread.
+         * @param time Seconds the line stays visible, 0 keeps it until the thread ends its next frame.
+         */
+        static void add(const math::vec3& start, const math::vec3& end, const math::color& color, float width, float time, bool ignoreDepth);
+
+        /**@brief Adds a list of lines that share their properties, each pair of vertices is a line.
+         */
+        static void add(const math::vec3* vertices, size_type vertexCount, const math::color& color, float width, float time, bool ignoreDepth);
+
+        /**@brief Ends the frame of the calling thread, the lines without lifetime it drew since the last call replace the ones it drew before.
+         *        Threads that never end a frame themselves, eg: job workers, have their lines published by the first thread that ends a frame after they drew them,
+         *        and removed when that thread ends its next frame without them having drawn anything new.
+         *        Lines a thread drew after its last frame when it exits are shown by the next merge, after which the buffers of the thread are removed.
+         */
+        static void publish();
+
+        /**@brief Ages the lines with a lifetime and collects all lines that are alive into the output. Only call from a single thread, once per frame.
+         * @param deltaTime Time since the last merge.
+         * @param output Cleared and filled with the lines, keeps its capacity between frames.
+         */
+        static void merge(time::span deltaTime, debug_line_frame& output);
+
+        /**@brief Removes all lines, only call from the thread that merges.
+         */
+        static void clear();
+
+        /**@brief Number of threads that have buffers, threads that exited are removed by the next merge.
+         */
+        L_NODISCARD static size_type thread_count();
+
+    private:
+        using vertex_buckets = std::array<std::vector<debug_vertex>, width_buckets>;
+
+        struct timed_line
+        {
+            debug_vertex start;
+            debug_vertex end;
+            float time;
+            size_type bucket;
+        };
+
+        //only contended while the thread gets merged or published by another thread
+        struct thread_lines
+        {
+            std::atomic_bool locked = { false };
+            bool publishes = false;
+            //set when the thread exits, the lines are removed after they were merged
+            bool exited = false;
+            //thread that published the lines of a thread that doesn't publish itself
+            thread_lines* publisher = nullptr;
+            vertex_buckets writing;
+            vertex_buckets published;
+            std::vector<timed_line> timed;
+
+            void lock() noexcept;
+            void unlock() noexcept;
+            void swap() noexcept;
+            void append() noexcept;
+            L_NODISCARD bool drew() const noexcept;
+        };
+
+        //marks the buffers of the thread for removal when the thread exits
+        struct thread_owner
+        {
+            thread_lines* lines = nullptr;
+            ~thread_owner();
+        };
+
+        static std::atomic_bool m_registryLocked;
+        static std::vector<std::unique_ptr<thread_lines>> m_threads;
+        static thread_local thread_owner m_localLines;
+
+        //only used by the merging thread, timed lines grouped by the lifetime_step they expire in
+        static double m_time;
+        static std::map<uint64, vertex_buckets> m_timedLines;
+        static vertex_buckets m_merged;
+        static std::vector<thread_lines*> m_exited;
+
+        static thread_lines& localLines();
+        static void lockRegistry() noexcept;
+        static void unlockRegistry() noexcept;
+    };
+}
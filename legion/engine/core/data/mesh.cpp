@@ -5,6 +5,8 @@ namespace legion::core
 {
     std::unordered_map<id_type, std::unique_ptr<std::pair<async::rw_spinlock, mesh>>> MeshCache::m_meshes;
     async::rw_spinlock MeshCache::m_meshesLock;
+    std::unordered_map<id_type, uint64> MeshCache::m_versions;
+    std::atomic<uint64> MeshCache::m_generation = { 0 };
     id_type MeshCache::debugId;
 
     void mesh::to_resource(filesystem::basic_resource* resource, const mesh& value)
@@ -134,6 +136,35 @@ namespace legion::core
                 data->tangents[i] = math::normalize(data->tangents[i]);
     }
 
+    void mesh::calculate_bounds(mesh* data)
+    {
+        OPTICK_EVENT();
+        if (data->vertices.empty())
+        {
+            data->bounds = mesh_bounds{};
+            return;
+        }
+
+        mesh_bounds& bounds = data->bounds;
+        bounds.min = data->vertices[0];
+        bounds.max = data->vertices[0];
+
+        for (auto& vertex : data->vertices)
+        {
+            bounds.min = math::min(bounds.min, vertex);
+            bounds.max = math::max(bounds.max, vertex);
+        }
+
+        // The sphere is centered on the box, but only as large as the furthest vertex which is tighter than the corners of the box.
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+
+        float radiusSq = 0.f;
+        for (auto& vertex : data->vertices)
+            radiusSq = math::max(radiusSq, math::dot(vertex - bounds.center, vertex - bounds.center));
+
+        bounds.radius = math::sqrt(radiusSq);
+    }
+
     std::pair<async::rw_spinlock&, mesh&> mesh_handle::get()
     {
         OPTICK_EVENT();
@@ -168,12 +199,14 @@ namespace legion::core
 
         mesh data = result;
         data.filePath = file.get_virtual_path(); // Set the filename.
+        mesh::calculate_bounds(&data);
 
         { // Insert the mesh into the mesh list.
             async::readwrite_guard guard(m_meshesLock);
             auto* pair_ptr = new std::pair<async::rw_spinlock, mesh>();
             pair_ptr->second = std::move(data);
-            m_meshes.emplace(id, std::unique_ptr<std::pair<async::rw_spinlock, mesh>>(pair_ptr));
+            if (m_meshes.emplace(id, std::unique_ptr<std::pair<async::rw_spinlock, mesh>>(pair_ptr)).second)
+                m_versions[id] = ++m_generation;
         }
 
         return { id };
@@ -186,7 +219,9 @@ namespace legion::core
         async::readwrite_guard guard(m_meshesLock);
         auto* pair_ptr = new std::pair<async::rw_spinlock, mesh>();
         pair_ptr->second = std::move(meshData);
-        m_meshes.emplace(newId, std::unique_ptr<std::pair<async::rw_spinlock, mesh>>(pair_ptr));
+        mesh::calculate_bounds(&pair_ptr->second);
+        if (m_meshes.emplace(newId, std::unique_ptr<std::pair<async::rw_spinlock, mesh>>(pair_ptr)).second)
+            m_versions[newId] = ++m_generation;
 
         return { newId };
     }
@@ -198,7 +233,7 @@ namespace legion::core
         id_type newId = nameHash(newName); // Get the new id.
 
         {
-            async::readonly_guard guard(m_meshesLock);
+            async::readwrite_guard guard(m_meshesLock);
             mesh data = m_meshes[id]->second; // Get a copy of the original mesh.
 
             if (m_meshes.count(newId))
@@ -213,6 +248,7 @@ namespace legion::core
                 pair_ptr->second = data;
                 m_meshes.emplace(std::make_pair(newId, pair_ptr));
             }
+            m_versions[newId] = ++m_generation;
         }
         return { newId }; // Return a handle to the new mesh.
     }
@@ -223,7 +259,7 @@ namespace legion::core
         id_type newId = nameHash(newName); // Get the new id.
 
         {
-            async::readonly_guard guard(m_meshesLock);
+            async::readwrite_guard guard(m_meshesLock);
             mesh data = m_meshes[id]->second; // Get a copy of the original mesh.
 
             if (m_meshes.count(newId))
@@ -238,6 +274,7 @@ namespace legion::core
                 pair_ptr->second = data;
                 m_meshes.emplace(std::make_pair(newId, pair_ptr));
             }
+            m_versions[newId] = ++m_generation;
         }
         return { newId }; // Return a handle to the new mesh.
     }
@@ -272,9 +309,23 @@ namespace legion::core
                 return;
 
             erased = m_meshes.erase(id);
+            m_versions.erase(id);
+            ++m_generation;
         }
 
         if (erased)
             log::debug("Destroyed mesh {}", id);
     }
+
+    uint64 MeshCache::get_version(id_type id)
+    {
+        async::readonly_guard guard(m_meshesLock);
+        auto iter = m_versions.find(id);
+        return iter == m_versions.end() ? 0 : iter->second;
+    }
+
+    uint64 MeshCache::generation() noexcept
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
 }
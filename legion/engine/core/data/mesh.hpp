@@ -6,11 +6,13 @@
 #include <core/async/rw_spinlock.hpp>
 #include <core/data/image.hpp>
 
+#include <atomic>
 #include <utility>
 #include <vector>
 #include <unordered_map>
 #include <memory>
 #include <functional>
+#include <limits>
 
 /**
  * @file mesh.hpp
@@ -28,6 +30,25 @@ namespace legion::core
         size_type indexOffset;
     };
 
+    /**@class mesh_bounds
+     * @brief Local space bounding volumes of a mesh, used for culling.
+     */
+    struct mesh_bounds
+    {
+        math::vec3 min = math::vec3(0.f);
+        math::vec3 max = math::vec3(0.f);
+        math::vec3 center = math::vec3(0.f);
+        float radius = 0.f;
+
+        /**@brief Bounds that contain everything, for meshes of which the bounds are not known.
+         */
+        static mesh_bounds infinite()
+        {
+            const float huge = std::numeric_limits<float>::max();
+            return mesh_bounds{ math::vec3(-huge), math::vec3(huge), math::vec3(0.f), huge };
+        }
+    };
+
     /**@class mesh
      * @brief Raw mesh representation.
      */
@@ -43,6 +64,8 @@ namespace legion::core
 
         std::vector<sub_mesh> submeshes;
 
+        mesh_bounds bounds;
+
         /**@brief Standard to resource conversion.
          */
         static void to_resource(filesystem::basic_resource* resource, const mesh& value);
@@ -54,6 +77,10 @@ namespace legion::core
         /**@brief Calculate the tangents from the triangles, vertices and normals of a certain mesh.
          */
         static void calculate_tangents(mesh* data);
+
+        /**@brief Calculate the bounding box and bounding sphere around the vertices of a certain mesh.
+         */
+        static void calculate_bounds(mesh* data);
     };
 
     /**@class mesh_handle
@@ -125,6 +152,9 @@ namespace legion::core
         static std::unordered_map<id_type, std::unique_ptr<std::pair<async::rw_spinlock, mesh>>> m_meshes;
         static std::unordered_map<id_type, filesystem::view> m_materialsToDigest;
         static async::rw_spinlock m_meshesLock;
+        //generation at which every mesh was last created or overwritten, guarded by m_meshesLock
+        static std::unordered_map<id_type, uint64> m_versions;
+        static std::atomic<uint64> m_generation;
     public:
         static id_type debugId;
 
@@ -162,5 +192,15 @@ namespace legion::core
         static mesh_handle get_handle(id_type id);
 
         static void destroy_mesh(id_type id);
+
+        /**@brief Returns a number that changes every time the mesh is created, overwritten or destroyed, 0 if the mesh doesn't exist.
+         *        Caches of data derived from a mesh can store it to find out when they went stale.
+         */
+        static uint64 get_version(id_type id);
+
+        /**@brief Returns a number that changes every time any mesh is created, overwritten or destroyed.
+         *        Caches of many meshes only need to check the versions of their meshes when this changed.
+         */
+        static uint64 generation() noexcept;
     };
 }
@@ -0,0 +1,548 @@
+#pragma once
+#include <core/types/primitives.hpp>
+#include <core/platform/platform.hpp>
+#include <core/math/math.hpp>
+#include <core/math/frustum.hpp>
+#include <core/async/parallel_radix_sort.hpp>
+#include <Optick/optick.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+/**
+ * @file octree.hpp
+ */
+
+namespace legion::core
+{
+    /**@struct octree_node
+     * @brief Node of an octree. The items are sorted by Morton code, so the items of a node and all of its descendants are one contiguous range.
+     */
+    struct octree_node
+    {
+        //tight bounds of the items in the node
+        math::vec3 min;
+        uint32 firstItem;
+        math::vec3 max;
+        uint32 itemCount;
+        //the children of a node are next to each other in Morton order, leaves have no children
+        uint32 firstChild;
+        uint8 childCount;
+        uint8 depth;
+
+        L_NODISCARD bool is_leaf() const noexcept { return childCount == 0; }
+    };
+
+    /**@struct octree_ray_hit
+     * @brief Item close enough to a ray, with how far along the ray it is.
+     */
+    struct octree_ray_hit
+    {
+        uint32 item;
+        float distance;
+    };
+
+    /**@class octree
+     * @brief Spatial index of points, built in bulk. The points are sorted by their 63 bit Morton code with the parallel radix sort,
+     *        after which the tree is built top down by splitting the sorted ranges, so all nodes live in one flat pool and the children of a node are contiguous.
+     *        Queries return the sorted index of the items, source_index maps those back to the index they had in the input.
+     *        Every item is also assigned a detail level: each node picks up to leafCapacity items spread over its range that no ancestor picked yet,
+     *        so the items up to a level are an even subsample of the whole set. Point clouds use this to add and remove detail.
+     * @note Only uses core, so it can be used for anything that needs to find points in space, eg: rendering, audio and gameplay.
+     * @tparam ValueType Data stored with every point.
+     */
+    template<typename ValueType>
+    class octree
+    {
+    public:
+        static constexpr uint32 invalid_index = std::numeric_limits<uint32>::max();
+        //bits of the Morton code per axis, which also limits the depth of the tree
+        static constexpr uint8 max_depth = 21;
+        static constexpr size_type items_per_job = 4096;
+
+        explicit octree(size_type leafCapacity = 8) : m_leafCapacity(std::max<size_type>(1, leafCapacity)) {}
+
+        /**@brief Replaces the contents of the tree.
+         * @param positions Array with the position of every item.
+         * @param values Array with the value of every item.
+         * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+         */
+        template<typename RunJobs>
+        void build(const math::vec3* positions, const ValueType* values, size_type count, RunJobs&& runJobs)
+        {
+            OPTICK_EVENT();
+            clear();
+            if (count == 0)
+                return;
+
+            //the tree is a cube around the points, so every octant splits the grid of the Morton codes in half on each axis
+            math::vec3 min = positions[0];
+            math::vec3 max = positions[0];
+            for (size_type i = 1; i < count; i++)
+            {
+                min = math::min(min, positions[i]);
+                max = math::max(max, positions[i]);
+            }
+
+            const float extent = math::max(max.x - min.x, math::max(max.y - min.y, max.z - min.z));
+            const float cellScale = extent > 0.f ? static_cast<float>((1u << max_depth) - 1u) / extent : 0.f;
+
+            const size_type jobCount = (count + items_per_job - 1) / items_per_job;
+            m_codes.resize(count);
+            m_sourceIndices.resize(count);
+
+            runJobs(jobCount, [&](size_type job)
+                {
+                    const size_type end = std::min(count, (job + 1) * items_per_job);
+                    for (size_type i = job * items_per_job; i < end; i++)
+                    {
+                        const math::vec3 cell = (positions[i] - min) * cellScale;
+                        m_codes[i] = morton_code(cell);
+                        m_sourceIndices[i] = static_cast<uint32>(i);
+                    }
+                });
+
+            async::parallel_radix_sort(m_codes, m_sourceIndices, m_sortBuffers, jobCount, runJobs);
+
+            m_positions.resize(count);
+            m_values.resize(count);
+            runJobs(jobCount, [&](size_type job)
+                {
+                    const size_type end = std::min(count, (job + 1) * items_per_job);
+                    for (size_type i = job * items_per_job; i < end; i++)
+                    {
+                        m_positions[i] = positions[m_sourceIndices[i]];
+                        m_values[i] = values[m_sourceIndices[i]];
+                    }
+                });
+
+            buildNodes(count);
+            calculateBounds();
+            assignDetailLevels();
+        }
+
+        /**@brief Builds the tree on the calling thread.
+         */
+        void build(const math::vec3* positions, const ValueType* values, size_type count)
+        {
+            build(positions, values, count, [](size_type jobCount, auto&& func)
+                {
+                    for (size_type i = 0; i < jobCount; i++)
+                        func(i);
+                });
+        }
+
+        void clear() noexcept
+        {
+            m_nodes.clear();
+            m_codes.clear();
+            m_sourceIndices.clear();
+            m_positions.clear();
+            m_values.clear();
+            m_detailItems.clear();
+            m_detailOffsets.clear();
+        }
+
+        L_NODISCARD size_type size() const noexcept { return m_positions.size(); }
+        L_NODISCARD bool empty() const noexcept { return m_positions.empty(); }
+
+        /**@brief All nodes, the root is the first one and nodes are ordered by depth.
+         */
+        L_NODISCARD const std::vector<octree_node>& nodes() const noexcept { return m_nodes; }
+
+        /**@brief Number of levels of nodes, 0 when the tree is empty.
+         */
+        L_NODISCARD size_type depth() const noexcept { return m_nodes.empty() ? 0 : static_cast<size_type>(m_nodes.back().depth) + 1; }
+
+        L_NODISCARD const math::vec3& position(uint32 item) const { return m_positions[item]; }
+        L_NODISCARD const ValueType& value(uint32 item) const { return m_values[item]; }
+        L_NODISCARD ValueType& value(uint32 item) { return m_values[item]; }
+
+        /**@brief Index the item had in the arrays the tree was built from.
+         */
+        L_NODISCARD uint32 source_index(uint32 item) const { return m_sourceIndices[item]; }
+
+        /**@brief Number of detail levels, the same as the depth of the tree.
+         */
+        L_NODISCARD size_type detail_level_count() const noexcept { return m_detailOffsets.empty() ? 0 : m_detailOffsets.size() - 1; }
+
+        /**@brief Appends the items of the detail levels [firstLevel, endLevel) to output.
+         */
+        void detail_levels(size_type firstLevel, size_type endLevel, std::vector<uint32>& output) const
+        {
+            endLevel = std::min(endLevel, detail_level_count());
+            if (firstLevel >= endLevel)
+                return;
+
+            output.insert(output.end(), m_detailItems.begin() + m_detailOffsets[firstLevel], m_detailItems.begin() + m_detailOffsets[endLevel]);
+        }
+
+        /**@brief Appends the k items closest to the point to output, closest first.
+         */
+        void k_nearest(const math::vec3& point, size_type k, std::vector<uint32>& output) const
+        {
+            OPTICK_EVENT();
+            if (k == 0 || m_nodes.empty())
+                return;
+
+            using entry = std::pair<float, uint32>;
+            //nodes closest first, best items so far with the furthest on top
+            std::priority_queue<entry, std::vector<entry>, std::greater<entry>> nodes;
+            std::priority_queue<entry> best;
+
+            nodes.push({ distance2(point, m_nodes[0].min, m_nodes[0].max), 0u });
+            while (!nodes.empty())
+            {
+                const auto [nodeDistance, nodeIndex] = nodes.top();
+                nodes.pop();
+                if (best.size() == k && nodeDistance > best.top().first)
+                    break;
+
+                const octree_node& node = m_nodes[nodeIndex];
+                if (node.is_leaf())
+                {
+                    for (uint32 i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+                    {
+                        const float itemDistance = math::length2(m_positions[i] - point);
+                        if (best.size() < k)
+                            best.push({ itemDistance, i });
+                        else if (itemDistance < best.top().first)
+                        {
+                            best.pop();
+                            best.push({ itemDistance, i });
+                        }
+                    }
+                    continue;
+                }
+
+                for (uint32 child = node.firstChild; child < node.firstChild + node.childCount; child++)
+                    nodes.push({ distance2(point, m_nodes[child].min, m_nodes[child].max), child });
+            }
+
+            const size_type start = output.size();
+            output.resize(start + best.size());
+            for (size_type i = output.size(); i > start; i--)
+            {
+                output[i - 1] = best.top().second;
+                best.pop();
+            }
+        }
+
+        /**@brief Appends the items within radius of the center to output.
+         */
+        void query_radius(const math::vec3& center, float radius, std::vector<uint32>& output) const
+        {
+            OPTICK_EVENT();
+            const float radius2 = radius * radius;
+            traverse(output,
+                [&](const octree_node& node)
+                {
+                    if (distance2(center, node.min, node.max) > radius2)
+                        return overlap::outside;
+                    //the corner furthest from the center
+                    const math::vec3 furthest = math::max(math::abs(node.min - center), math::abs(node.max - center));
+                    return math::length2(furthest) <= radius2 ? overlap::inside : overlap::intersects;
+                },
+                [&](const math::vec3& position) { return math::length2(position - center) <= radius2; });
+        }
+
+        /**@brief Appends the items inside the box to output.
+         */
+        void query_aabb(const math::vec3& min, const math::vec3& max, std::vector<uint32>& output) const
+        {
+            OPTICK_EVENT();
+            traverse(output,
+                [&](const octree_node& node)
+                {
+                    if (math::any(math::lessThan(node.max, min)) || math::any(math::greaterThan(node.min, max)))
+                        return overlap::outside;
+                    return math::all(math::greaterThanEqual(node.min, min)) && math::all(math::lessThanEqual(node.max, max)) ? overlap::inside : overlap::intersects;
+                },
+                [&](const math::vec3& position) { return math::all(math::greaterThanEqual(position, min)) && math::all(math::lessThanEqual(position, max)); });
+        }
+
+        /**@brief Appends the items inside the frustum to output, nodes completely inside it are added without testing their items.
+         */
+        void query_frustum(const math::view_frustum& frustum, std::vector<uint32>& output) const
+        {
+            OPTICK_EVENT();
+            traverse(output,
+                [&](const octree_node& node)
+                {
+                    if (!frustum.intersects_aabb(node.min, node.max))
+                        return overlap::outside;
+                    return frustum.contains_aabb(node.min, node.max) ? overlap::inside : overlap::intersects;
+                },
+                [&](const math::vec3& position) { return frustum.intersects_sphere(position, 0.f); });
+        }
+
+        /**@brief Appends the items within thickness of a ray to output, sorted by their distance along the ray.
+         *        Nodes are visited front to back.
+         * @param direction Normalized direction of the ray.
+         */
+        void query_ray(const math::vec3& origin, const math::vec3& direction, float maxDistance, float thickness, std::vector<octree_ray_hit>& output) const
+        {
+            OPTICK_EVENT();
+            if (m_nodes.empty())
+                return;
+
+            const size_type start = output.size();
+            const math::vec3 inverseDirection(1.f / direction.x, 1.f / direction.y, 1.f / direction.z);
+            const math::vec3 margin(thickness);
+            const float thickness2 = thickness * thickness;
+
+            //entry distance along the ray and node, the stack keeps the closest node on top
+            std::vector<std::pair<float, uint32>> stack;
+            std::pair<float, uint32> children[8];
+
+            float entry;
+            if (!intersect_ray(origin, inverseDirection, m_nodes[0].min - margin, m_nodes[0].max + margin, maxDistance, entry))
+                return;
+            stack.push_back({ entry, 0u });
+
+            while (!stack.empty())
+            {
+                const octree_node& node = m_nodes[stack.back().second];
+                stack.pop_back();
+
+                if (node.is_leaf())
+                {
+                    for (uint32 i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+                    {
+                        const float along = math::clamp(math::dot(m_positions[i] - origin, direction), 0.f, maxDistance);
+                        if (math::length2(origin + direction * along - m_positions[i]) <= thickness2)
+                            output.push_back({ i, along });
+                    }
+                    continue;
+                }
+
+                size_type hitCount = 0;
+                for (uint32 child = node.firstChild; child < node.firstChild + node.childCount; child++)
+                    if (intersect_ray(origin, inverseDirection, m_nodes[child].min - margin, m_nodes[child].max + margin, maxDistance, entry))
+                        children[hitCount++] = { entry, child };
+
+                //furthest pushed first so the closest is visited next
+                std::sort(children, children + hitCount, [](auto& lhs, auto& rhs) { return lhs.first > rhs.first; });
+                stack.insert(stack.end(), children, children + hitCount);
+            }
+
+            std::sort(output.begin() + start, output.end(), [](const octree_ray_hit& lhs, const octree_ray_hit& rhs) { return lhs.distance < rhs.distance; });
+        }
+
+    private:
+        enum struct overlap
+        {
+            outside,
+            intersects,
+            inside
+        };
+
+        size_type m_leafCapacity;
+
+        std::vector<octree_node> m_nodes;
+        std::vector<uint64> m_codes;
+        std::vector<uint32> m_sourceIndices;
+        std::vector<math::vec3> m_positions;
+        std::vector<ValueType> m_values;
+        async::radix_sort_buffers m_sortBuffers;
+
+        //items grouped by detail level, the items of level i are [m_detailOffsets[i], m_detailOffsets[i + 1])
+        std::vector<uint32> m_detailItems;
+        std::vector<size_type> m_detailOffsets;
+
+        //spreads the lowest 21 bits so there are 2 zero bits between each of them
+        L_NODISCARD static uint64 spread_bits(uint64 value) noexcept
+        {
+            value &= 0x1fffff;
+            value = (value | (value << 32)) & 0x001f00000000ffff;
+            value = (value | (value << 16)) & 0x001f0000ff0000ff;
+            value = (value | (value << 8)) & 0x100f00f00f00f00f;
+            value = (value | (value << 4)) & 0x10c30c30c30c30c3;
+            value = (value | (value << 2)) & 0x1249249249249249;
+            return value;
+        }
+
+        //x in the lowest bit, so the octant of a child is x | y << 1 | z << 2
+        L_NODISCARD static uint64 morton_code(const math::vec3& cell) noexcept
+        {
+            constexpr float maxCell = static_cast<float>((1u << max_depth) - 1u);
+            const uint64 x = static_cast<uint64>(math::clamp(cell.x, 0.f, maxCell));
+            const uint64 y = static_cast<uint64>(math::clamp(cell.y, 0.f, maxCell));
+            const uint64 z = static_cast<uint64>(math::clamp(cell.z, 0.f, maxCell));
+            return spread_bits(x) | (spread_bits(y) << 1) | (spread_bits(z) << 2);
+        }
+
+        L_NODISCARD static float distance2(const math::vec3& point, const math::vec3& min, const math::vec3& max) noexcept
+        {
+            const math::vec3 closest = math::clamp(point, min, max);
+            return math::length2(closest - point);
+        }
+
+        //slab test, entry is where the ray enters the box, 0 when it starts inside
+        L_NODISCARD static bool intersect_ray(const math::vec3& origin, const math::vec3& inverseDirection, const math::vec3& min, const math::vec3& max, float maxDistance, float& entry) noexcept
+        {
+            const math::vec3 t0 = (min - origin) * inverseDirection;
+            const math::vec3 t1 = (max - origin) * inverseDirection;
+            const math::vec3 tMin = math::min(t0, t1);
+            const math::vec3 tMax = math::max(t0, t1);
+
+            entry = math::max(0.f, math::max(tMin.x, math::max(tMin.y, tMin.z)));
+            const float exit = math::min(maxDistance, math::min(tMax.x, math::min(tMax.y, tMax.z)));
+            return entry <= exit;
+        }
+
+        //breadth first, so the nodes end up ordered by depth and the children of a node are pushed next to each other
+        void buildNodes(size_type count)
+        {
+            OPTICK_EVENT();
+            m_nodes.push_back({ math::vec3(0.f), 0u, math::vec3(0.f), static_cast<uint32>(count), invalid_index, 0u, 0u });
+
+            for (size_type nodeIndex = 0; nodeIndex < m_nodes.size(); nodeIndex++)
+            {
+                const octree_node node = m_nodes[nodeIndex];
+                if (node.itemCount <= m_leafCapacity || node.depth >= max_depth)
+                    continue;
+
+                //within a node the octant of the next level only goes up, so each octant is a sub range
+                const uint32 shift = 3u * (max_depth - 1u - node.depth);
+                auto first = m_codes.begin() + node.firstItem;
+                const auto last = first + node.itemCount;
+
+                const uint32 firstChild = static_cast<uint32>(m_nodes.size());
+                uint8 childCount = 0;
+                for (uint64 octant = 0; octant < 8 && first != last; octant++)
+                {
+                    const auto octantEnd = std::partition_point(first, last, [&](uint64 code) { return ((code >> shift) & 7u) <= octant; });
+                    if (octantEnd == first)
+                        continue;
+
+                    m_nodes.push_back({ math::vec3(0.f), static_cast<uint32>(first - m_codes.begin()), math::vec3(0.f), static_cast<uint32>(octantEnd - first),
+                        invalid_index, 0u, static_cast<uint8>(node.depth + 1u) });
+                    childCount++;
+                    first = octantEnd;
+                }
+
+                m_nodes[nodeIndex].firstChild = firstChild;
+                m_nodes[nodeIndex].childCount = childCount;
+            }
+        }
+
+        //leaves get the bounds of their items and parents the bounds of their children, children always come after their parent
+        void calculateBounds()
+        {
+            OPTICK_EVENT();
+            for (size_type nodeIndex = m_nodes.size(); nodeIndex-- > 0;)
+            {
+                octree_node& node = m_nodes[nodeIndex];
+                if (node.is_leaf())
+                {
+                    node.min = node.max = m_positions[node.firstItem];
+                    for (uint32 i = node.firstItem + 1; i < node.firstItem + node.itemCount; i++)
+                    {
+                        node.min = math::min(node.min, m_positions[i]);
+                        node.max = math::max(node.max, m_positions[i]);
+                    }
+                    continue;
+                }
+
+                node.min = m_nodes[node.firstChild].min;
+                node.max = m_nodes[node.firstChild].max;
+                for (uint32 child = node.firstChild + 1; child < node.firstChild + node.childCount; child++)
+                {
+                    node.min = math::min(node.min, m_nodes[child].min);
+                    node.max = math::max(node.max, m_nodes[child].max);
+                }
+            }
+        }
+
+        //nodes are ordered by depth, so the ancestors of a node have picked their items before it
+        void assignDetailLevels()
+        {
+            OPTICK_EVENT();
+            const size_type count = m_positions.size();
+            const size_type levelCount = depth();
+            constexpr uint8 unassigned = std::numeric_limits<uint8>::max();
+            std::vector<uint8> levels(count, unassigned);
+
+            for (auto& node : m_nodes)
+            {
+                if (node.is_leaf())
+                {
+                    for (uint32 i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+                        if (levels[i] == unassigned)
+                            levels[i] = node.depth;
+                    continue;
+                }
+
+                //evenly spaced over the range, taking the next free item when an ancestor already picked one
+                const size_type picks = std::min<size_type>(m_leafCapacity, node.itemCount);
+                for (size_type pick = 0; pick < picks; pick++)
+                {
+                    const size_type offset = (pick * node.itemCount + node.itemCount / 2) / picks;
+                    for (size_type probe = 0; probe < node.itemCount; probe++)
+                    {
+                        const uint32 i = node.firstItem + static_cast<uint32>((offset + probe) % node.itemCount);
+                        if (levels[i] == unassigned)
+                        {
+                            levels[i] = node.depth;
+                            break;
+                        }
+                    }
+                }
+            }
+
+            //counting sort of the items by level
+            m_detailOffsets.assign(levelCount + 1, 0);
+            for (uint8 level : levels)
+                m_detailOffsets[level + 1]++;
+            for (size_type level = 0; level < levelCount; level++)
+                m_detailOffsets[level + 1] += m_detailOffsets[level];
+
+            m_detailItems.resize(count);
+            std::vector<size_type> cursors(m_detailOffsets.begin(), m_detailOffsets.end() - 1);
+            for (size_type i = 0; i < count; i++)
+                m_detailItems[cursors[levels[i]]++] = static_cast<uint32>(i);
+        }
+
+        /**@brief Depth first walk that adds whole ranges for nodes inside the query and only tests the items of leaves that intersect it.
+         */
+        template<typename NodeTest, typename ItemTest>
+        void traverse(std::vector<uint32>& output, NodeTest&& nodeTest, ItemTest&& itemTest) const
+        {
+            if (m_nodes.empty())
+                return;
+
+            std::vector<uint32> stack{ 0u };
+            while (!stack.empty())
+            {
+                const octree_node& node = m_nodes[stack.back()];
+                stack.pop_back();
+
+                const overlap result = nodeTest(node);
+                if (result == overlap::outside)
+                    continue;
+
+                if (result == overlap::inside)
+                {
+                    for (uint32 i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+                        output.push_back(i);
+                    continue;
+                }
+
+                if (node.is_leaf())
+                {
+                    for (uint32 i = node.firstItem; i < node.firstItem + node.itemCount; i++)
+                        if (itemTest(m_positions[i]))
+                            output.push_back(i);
+                    continue;
+                }
+
+                for (uint32 child = node.firstChild + node.childCount; child-- > node.firstChild;)
+                    stack.push_back(child);
+            }
+        }
+    };
+}
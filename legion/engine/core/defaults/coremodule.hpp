@@ -37,6 +37,7 @@ namespace legion::core
             reportComponentType<rotation>();
             reportComponentType<scale>();
             reportComponentType<velocity>();
+            reportComponentType<transform_interpolation>();
             reportComponentType<mesh_filter>();
             reportComponentType<use_embedded_material>();
             reportComponentType<scenemanagement::scene>();
@@ -12,6 +12,8 @@
 
 #include <core/filesystem/assetimporter.hpp>
 
+#include <chrono>
+
 namespace legion::core
 {
     struct position : public math::vec3
@@ -185,6 +187,46 @@ namespace legion::core
         }
     };
 
+    /**@struct transform_interpolation
+     * @brief The position and rotation of an entity before the last fixed step that moved it.
+     *        The renderer blends from this pose to the current pose of the entity over the length of the step,
+     *        so entities that are moved in fixed steps move smoothly at any frame rate.
+     */
+    struct transform_interpolation
+    {
+        math::vec3 previousPosition;
+        math::quat previousRotation;
+
+        //time at which the step ended and the length of the step, both in seconds
+        time64 stepEnd = 0;
+        time64 stepLength = 0;
+
+        /**@brief Gets the current time in seconds, in the same time frame as stepEnd.
+         */
+        L_NODISCARD static time64 currentTime() noexcept
+        {
+            return std::chrono::duration<time64>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        /**@brief Gets how far the pose at the given time is from the previous pose to the current pose, from 0 to 1.
+         */
+        L_NODISCARD float getBlendFactor(time64 time) const noexcept
+        {
+            if (stepLength <= 0)
+                return 1.f;
+
+            return static_cast<float>(math::clamp((time - stepEnd) / stepLength, 0.0, 1.0));
+        }
+
+        /**@brief Gets the transform of the entity at the given time.
+         */
+        L_NODISCARD math::mat4 interpolate(time64 time, const math::vec3& currentPosition, const math::quat& currentRotation, const math::vec3& currentScale) const
+        {
+            const float blend = getBlendFactor(time);
+            return math::compose(currentScale, math::slerp(previousRotation, currentRotation, blend), math::mix(previousPosition, currentPosition, blend));
+        }
+    };
+
     struct mesh_filter : public mesh_handle
     {
         mesh_filter() = default;
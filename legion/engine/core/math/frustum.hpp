@@ -0,0 +1,127 @@
+#pragma once
+#include <core/math/glm/glm_include.hpp>
+#include <core/platform/platform.hpp>
+#include <core/types/primitives.hpp>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file frustum.hpp
+ */
+
+namespace legion::core::math
+{
+    /**@struct view_frustum
+     * @brief The 6 planes of a view frustum in world space, the normals of the planes point into the frustum.
+     *        Only needs the view-projection matrix, so culling can be done and tested without a graphics context.
+     */
+    struct view_frustum
+    {
+        //xyz is the normal of the plane and w the distance, a point p is inside a plane when dot(xyz, p) + w >= 0
+        vec4 planes[6];
+
+        /**@brief Extracts the planes from a view-projection matrix (Gribb & Hartmann).
+         *        Assumes the 0 to 1 depth range that glm is configured with, near and far may be swapped for reversed depth.
+         */
+        L_NODISCARD static view_frustum from_view_projection(const mat4& viewProjection) noexcept
+        {
+            view_frustum result;
+            const mat4 transposed = transpose(viewProjection);
+
+            result.planes[0] = transposed[3] + transposed[0]; // Left
+            result.planes[1] = transposed[3] - transposed[0]; // Right
+            result.planes[2] = transposed[3] + transposed[1]; // Bottom
+            result.planes[3] = transposed[3] - transposed[1]; // Top
+            result.planes[4] = transposed[2];                 // Near
+            result.planes[5] = transposed[3] - transposed[2]; // Far
+
+            // Normalize the planes so the distances are in world units and can be compared to radii.
+            for (auto& plane : result.planes)
+            {
+                const float len = length(vec3(plane));
+                if (len > 0.f)
+                    plane /= len;
+            }
+
+            return result;
+        }
+
+        /**@brief Checks if a sphere is at least partially inside the frustum.
+         */
+        L_NODISCARD bool intersects_sphere(const vec3& center, float radius) const noexcept
+        {
+            for (auto& plane : planes)
+                if (dot(vec3(plane), center) + plane.w < -radius)
+                    return false;
+            return true;
+        }
+
+        /**@brief Checks if an axis aligned box is at least partially inside the frustum.
+         *        Conservative, boxes near the corners of the frustum can be reported as visible.
+         */
+        L_NODISCARD bool intersects_aabb(const vec3& min, const vec3& max) const noexcept
+        {
+            for (auto& plane : planes)
+            {
+                // The corner of the box that is furthest along the normal of the plane.
+                const vec3 positive(plane.x >= 0.f ? max.x : min.x, plane.y >= 0.f ? max.y : min.y, plane.z >= 0.f ? max.z : min.z);
+                if (dot(vec3(plane), positive) + plane.w < 0.f)
+                    return false;
+            }
+            return true;
+        }
+
+        /**@brief Checks if an axis aligned box is completely inside the frustum.
+         */
+        L_NODISCARD bool contains_aabb(const vec3& min, const vec3& max) const noexcept
+        {
+            for (auto& plane : planes)
+            {
+                // The corner of the box that is furthest against the normal of the plane.
+                const vec3 negative(plane.x >= 0.f ? min.x : max.x, plane.y >= 0.f ? min.y : max.y, plane.z >= 0.f ? min.z : max.z);
+                if (dot(vec3(plane), negative) + plane.w < 0.f)
+                    return false;
+            }
+            return true;
+        }
+
+        /**@brief Checks a batch of spheres stored as a structure of arrays, 4 at a time when SSE is available.
+         * @param visible [out] For every sphere 1 if it is at least partially inside the frustum, otherwise 0.
+         */
+        void cull_spheres(const float* centerX, const float* centerY, const float* centerZ, const float* radius, size_type count, byte* visible) const noexcept
+        {
+            size_type i = 0;
+
+#if defined(LEGION_SSE)
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(centerX + i);
+                const __m128 y = _mm_loadu_ps(centerY + i);
+                const __m128 z = _mm_loadu_ps(centerZ + i);
+                const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (auto& plane : planes)
+                {
+                    __m128 distance = _mm_mul_ps(x, _mm_set1_ps(plane.x));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(plane.y)));
+                    distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(plane.z)));
+                    distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+                }
+
+                const int mask = _mm_movemask_ps(inside);
+                visible[i] = static_cast<byte>(mask & 1);
+                visible[i + 1] = static_cast<byte>((mask >> 1) & 1);
+                visible[i + 2] = static_cast<byte>((mask >> 2) & 1);
+                visible[i + 3] = static_cast<byte>((mask >> 3) & 1);
+            }
+#endif
+
+            for (; i < count; i++)
+                visible[i] = intersects_sphere(vec3(centerX[i], centerY[i], centerZ[i]), radius[i]) ? 1 : 0;
+        }
+    };
+}
@@ -114,6 +114,27 @@
 #define L_PAUSE_INSTRUCTION _mm_pause
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(DOXY_INCLUDE)
+    /**@def LEGION_SSE
+     * @brief Defined when SSE2 intrinsics are available. (always the case on x86_64)
+     */
+    #define LEGION_SSE
+#endif
+
+#if defined(__AVX__) || defined(DOXY_INCLUDE)
+    /**@def LEGION_AVX
+     * @brief Defined when compiling with AVX enabled. (/arch:AVX or -mavx)
+     */
+    #define LEGION_AVX
+#endif
+
+#if defined(__AVX2__) || defined(DOXY_INCLUDE)
+    /**@def LEGION_AVX2
+     * @brief Defined when compiling with AVX2 enabled. (/arch:AVX2 or -mavx2)
+     */
+    #define LEGION_AVX2
+#endif
+
 #if (defined(LEGION_WINDOWS) && !defined(LEGION_WINDOWS_USE_CDECL)) || defined (DOXY_INCLUDE)
     /**@def LEGION_CCONV
      * @brief the calling convention exported functions will use in the args engine
@@ -11,6 +11,7 @@ namespace legion::core::scheduling
     async::rw_spinlock ProcessChain::m_callbackLock;
     multicast_delegate<void()> ProcessChain::m_onFrameStart;
     multicast_delegate<void()> ProcessChain::m_onFrameEnd;
+    thread_local ProcessChain* ProcessChain::m_currentChain = nullptr;
 
     void ProcessChain::threadedRun(ProcessChain* chain)
     {
@@ -93,6 +94,7 @@ namespace legion::core::scheduling
     {
         OPTICK_EVENT("Run process chain");
         OPTICK_TAG("Process chain", m_name.c_str());
+        m_currentChain = this;
 
         {
             async::readonly_guard guard(m_callbackLock);
@@ -114,6 +116,8 @@ namespace legion::core::scheduling
             async::readonly_guard guard(m_callbackLock);
             m_onFrameEnd();
         }
+
+        m_currentChain = nullptr;
     }
 
     void ProcessChain::addProcess(Process* process)
@@ -34,10 +34,16 @@ namespace legion::core::scheduling
         static async::rw_spinlock m_callbackLock;
         static multicast_delegate<void()> m_onFrameStart;
         static multicast_delegate<void()> m_onFrameEnd;
+        static thread_local ProcessChain* m_currentChain;
 
 	public:
         static void threadedRun(ProcessChain* chain);
 
+        /**@brief Returns the process-chain that is running an iteration on the calling thread, or nullptr outside of an iteration.
+         * @note The chain start and end callbacks are called for every chain, this tells them which chain they were called for.
+         */
+        static ProcessChain* current() { return m_currentChain; }
+
         template<void(*func)()>
         static void subscribeToChainStart()
         {
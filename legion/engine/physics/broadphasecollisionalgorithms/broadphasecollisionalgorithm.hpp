@@ -24,6 +24,33 @@ namespace legion::physics
 
         }
 
+        /**@brief Collects the ids of the manifold precursors of the last collectPairs call that might overlap the box min-max.
+         * The default implementation collects every precursor.
+         * @param candidates [out] The ids of the precursors, may contain duplicates.
+         */
+        virtual void collectCandidates(const math::vec3& min, const math::vec3& max, std::vector<id_type>& candidates) const
+        {
+            for (auto& grouping : m_groupings)
+            {
+                for (auto& precursor : grouping)
+                {
+                    candidates.push_back(precursor.id);
+                }
+            }
+        }
+
+        /**@brief Collects the ids of the manifold precursors of the last collectPairs call that might be hit by a ray.
+         * The default implementation collects every precursor.
+         * @param direction The normalized direction of the ray.
+         * @param expansion The amount the precursors are grown by on each side, used for shape casts.
+         * @param candidates [out] The ids of the precursors, may contain duplicates.
+         */
+        virtual void collectRayCandidates(const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            const math::vec3& expansion, std::vector<id_type>& candidates) const
+        {
+            collectCandidates(math::vec3(std::numeric_limits<float>::lowest()), math::vec3(std::numeric_limits<float>::max()), candidates);
+        }
+
     protected:
         std::vector<std::vector<physics_manifold_precursor>> m_groupings;
     };
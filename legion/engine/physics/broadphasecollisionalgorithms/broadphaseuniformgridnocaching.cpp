@@ -7,9 +7,9 @@ namespace legion::physics
     {
       
         manifoldPrecursorGrouping.clear();
+        m_cellIndices.clear();
+        m_bounds = std::make_pair(math::vec3(std::numeric_limits<float>::max()), math::vec3(std::numeric_limits<float>::lowest()));
 
-        // TODO: insert return statement here
-        std::unordered_map<math::ivec3, int> cellIndices;
         for (auto& precursor : manifoldPrecursors)
         {
             std::vector<legion::physics::PhysicsColliderPtr> colliders = precursor.physicsComp->colliders;
@@ -23,6 +23,8 @@ namespace legion::physics
             {
                 aabb = PhysicsStatics::CombineAABB(colliders.at(i)->GetMinMaxWorldAABB(), aabb);
             }
+            m_bounds = PhysicsStatics::CombineAABB(aabb, m_bounds);
+
             math::ivec3 startCellIndex = calculateCellIndex(std::get<0>(aabb));
             math::ivec3 endCellIndex = calculateCellIndex(std::get<1>(aabb));
             for (int x = startCellIndex.x; x <= endCellIndex.x; ++x)
@@ -32,13 +34,13 @@ namespace legion::physics
                     for (int z = startCellIndex.z; z <= endCellIndex.z; ++z)
                     {
                         math::ivec3 currentCellIndex = math::ivec3(x, y, z);
-                        if (cellIndices.find(currentCellIndex) != cellIndices.end())
+                        if (m_cellIndices.find(currentCellIndex) != m_cellIndices.end())
                         {
-                            manifoldPrecursorGrouping.at(cellIndices.at(currentCellIndex)).push_back(precursor);
+                            manifoldPrecursorGrouping.at(m_cellIndices.at(currentCellIndex)).push_back(precursor);
                         }
                         else
                         {
-                            cellIndices.emplace(currentCellIndex, manifoldPrecursorGrouping.size());
+                            m_cellIndices.emplace(currentCellIndex, manifoldPrecursorGrouping.size());
                             manifoldPrecursorGrouping.push_back(std::vector<physics_manifold_precursor>());
                             manifoldPrecursorGrouping.at(manifoldPrecursorGrouping.size() - 1).push_back(precursor);
                         }
@@ -51,7 +53,7 @@ namespace legion::physics
 
     }
 
-    math::ivec3 BroadphaseUniformGridNoCaching::calculateCellIndex(const math::vec3 point)
+    math::ivec3 BroadphaseUniformGridNoCaching::calculateCellIndex(const math::vec3 point) const
     {
         // A point below 0 needs an extra 'push' since -0.5 will be cast to int as 0
         math::vec3 temp = point;
@@ -64,6 +66,93 @@ namespace legion::physics
         return cellIndex;
     }
 
+    void BroadphaseUniformGridNoCaching::collectCandidates(const math::vec3& min, const math::vec3& max, std::vector<id_type>& candidates) const
+    {
+        const math::ivec3 startCellIndex = calculateCellIndex(math::max(min, m_bounds.first));
+        const math::ivec3 endCellIndex = calculateCellIndex(math::min(max, m_bounds.second));
+        if (math::any(math::lessThan(endCellIndex, startCellIndex))) return;
+
+        auto addCell = [&](int grouping)
+        {
+            for (auto& precursor : manifoldPrecursorGrouping[grouping])
+            {
+                candidates.push_back(precursor.id);
+            }
+        };
+
+        // When the box covers more cells than there are filled cells it is cheaper to go through the filled cells
+        const math::ivec3 cellCount = endCellIndex - startCellIndex + math::ivec3(1);
+        if (static_cast<size_type>(cellCount.x) * cellCount.y * cellCount.z > m_cellIndices.size())
+        {
+            for (auto& [cellIndex, grouping] : m_cellIndices)
+            {
+                if (math::all(math::greaterThanEqual(cellIndex, startCellIndex)) && math::all(math::lessThanEqual(cellIndex, endCellIndex)))
+                {
+                    addCell(grouping);
+                }
+            }
+            return;
+        }
+
+        for (int x = startCellIndex.x; x <= endCellIndex.x; ++x)
+        {
+            for (int y = startCellIndex.y; y <= endCellIndex.y; ++y)
+            {
+                for (int z = startCellIndex.z; z <= endCellIndex.z; ++z)
+                {
+                    auto found = m_cellIndices.find(math::ivec3(x, y, z));
+                    if (found != m_cellIndices.end())
+                    {
+                        addCell(found->second);
+                    }
+                }
+            }
+        }
+    }
+
+    void BroadphaseUniformGridNoCaching::collectRayCandidates(const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        const math::vec3& expansion, std::vector<id_type>& candidates) const
+    {
+        if (m_cellIndices.empty()) return;
+
+        // Clip the ray against the bounds so that infinite rays only march through the part of the grid that is filled
+        float entry = 0.0f;
+        float exit = maxDistance;
+        const math::vec3 boundsMin = m_bounds.first - expansion;
+        const math::vec3 boundsMax = m_bounds.second + expansion;
+
+        for (int i = 0; i < 3; i++)
+        {
+            if (math::abs(direction[i]) <= math::epsilon<float>())
+            {
+                if (origin[i] < boundsMin[i] || origin[i] > boundsMax[i]) return;
+                continue;
+            }
+
+            float near = (boundsMin[i] - origin[i]) / direction[i];
+            float far = (boundsMax[i] - origin[i]) / direction[i];
+            if (near > far) std::swap(near, far);
+
+            entry = math::max(entry, near);
+            exit = math::min(exit, far);
+            if (entry > exit) return;
+        }
+
+        // March in steps of at most one cell, every step collects the cells around its part of the ray
+        const float stepSize = static_cast<float>(math::max(1, math::min(m_cellSize.x, math::min(m_cellSize.y, m_cellSize.z))));
+
+        for (float stepStart = entry; stepStart <= exit; stepStart += stepSize)
+        {
+            const float stepEnd = math::min(stepStart + stepSize, exit);
+            const math::vec3 start = origin + direction * stepStart;
+            const math::vec3 end = origin + direction * stepEnd;
+
+            collectCandidates(math::min(start, end) - expansion, math::max(start, end) + expansion, candidates);
+
+            if (stepEnd >= exit) break;
+        }
+    }
+
 
 }
 
@@ -23,6 +23,16 @@ namespace legion::physics
         const std::vector<std::vector<physics_manifold_precursor>>& collectPairs(
             std::vector<physics_manifold_precursor>&& manifoldPrecursors) override;
 
+        /**@brief Collects the precursors in the cells that the box min-max touches.
+         */
+        void collectCandidates(const math::vec3& min, const math::vec3& max, std::vector<id_type>& candidates) const override;
+
+        /**@brief Collects the precursors in the cells that the ray touches by marching the ray through the grid
+         * in steps of at most one cell, the ray is first clipped to the bounds of all the precursors.
+         */
+        void collectRayCandidates(const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            const math::vec3& expansion, std::vector<id_type>& candidates) const override;
+
         /**@brief Sets the cell size which will be used for the virtual grid
          */
         void setCellSize(math::ivec3 cellSize)
@@ -35,8 +45,13 @@ namespace legion::physics
 
         /**@brief Calculates a cell index from a point. i.e. calculates in which cell in the uniform grid a point will be.
          */
-        math::ivec3 calculateCellIndex(const math::vec3 point);
+        math::ivec3 calculateCellIndex(const math::vec3 point) const;
 
         std::vector<std::vector<physics_manifold_precursor>> manifoldPrecursorGrouping;
+
+        // Stores the cell index (ivec3) to the index in the manifoldPrecursorGrouping list.
+        std::unordered_map<math::ivec3, int> m_cellIndices;
+        // The box around all the precursors of the last collectPairs call
+        std::pair<math::vec3, math::vec3> m_bounds;
     };
 }
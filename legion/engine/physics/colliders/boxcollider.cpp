@@ -0,0 +1,79 @@
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/physics_statics.hpp>
+
+namespace legion::physics
+{
+    void BoxCollider::CheckCollisionWith(BoxCollider* boxCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'boxCollider' is colliderA
+        if (!PhysicsStatics::CollideAABB(GetMinMaxWorldAABB(), boxCollider->GetMinMaxWorldAABB()))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectBoxBoxCollision(boxCollider->GetWorldBox(manifold.transformA),
+            GetWorldBox(manifold.transformB), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    void BoxCollider::CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'sphereCollider' is colliderA
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereBoxCollision(sphereCollider->GetWorldSphere(manifold.transformA),
+            GetWorldBox(manifold.transformB), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    void BoxCollider::UpdateTransformedTightBoundingVolume(const math::mat4& transform)
+    {
+        const world_box box = GetWorldBox(transform);
+
+        //the extent of an oriented box on a world axis is the sum of its half extents projected on that axis
+        math::vec3 extents = math::vec3(0.0f);
+        for (int i = 0; i < 3; i++)
+        {
+            extents += math::abs(box.axes[i]) * box.halfExtents[i];
+        }
+
+        minMaxWorldAABB = std::make_pair(box.center - extents, box.center + extents);
+    }
+
+    bool BoxCollider::Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal) const
+    {
+        return PhysicsStatics::RaycastBox(GetWorldBox(transform), origin, direction, maxDistance, outDistance, outNormal);
+    }
+
+    world_box BoxCollider::GetWorldBox(const math::mat4& transform) const
+    {
+        world_box box;
+        box.center = transform * math::vec4(localCenter, 1);
+
+        for (int i = 0; i < 3; i++)
+        {
+            const math::vec3 axis = transform[i];
+            const float axisScale = math::length(axis);
+
+            box.axes[i] = axis / axisScale;
+            box.halfExtents[i] = halfExtents[i] * axisScale;
+        }
+
+        return box;
+    }
+}
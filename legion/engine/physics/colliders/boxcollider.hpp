@@ -0,0 +1,64 @@
+#pragma once
+
+#include <physics/colliders/convexcollider.hpp>
+#include <physics/data/primitive_shapes.hpp>
+
+namespace legion::physics
+{
+    /**@class BoxCollider
+     * @brief A ConvexCollider that knows it is a box. Collisions with other boxes and spheres are detected with closed form
+     * tests instead of the general seperating axis test. The ConvexHull is still built so that every other collider
+     * and the fracturer can treat the box as a ConvexCollider.
+     */
+    class BoxCollider : public ConvexCollider
+    {
+    public:
+
+        BoxCollider(const cube_collider_params& cubeParams)
+        {
+            CreateBox(cubeParams);
+
+            halfExtents = math::vec3(cubeParams.width, cubeParams.height, cubeParams.breadth) * 0.5f;
+            localCenter = cubeParams.offset;
+        }
+
+        void CheckCollision(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
+        {
+            physicsCollider->CheckCollisionWith(this, manifold);
+        }
+
+        /** @brief Given a BoxCollider and a physics_manifold, uses the seperating axis test on the 15 axes of the boxes
+        */
+        void CheckCollisionWith(BoxCollider* boxCollider, physics_manifold& manifold) override;
+
+        /** @brief Given a SphereCollider and a physics_manifold, clamps the center of the sphere to the box
+        */
+        void CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold) override;
+
+        void UpdateTransformedTightBoundingVolume(const math::mat4& transform) override;
+
+        /** @brief Casts a ray against the box with the slab test in the local space of the box.
+        */
+        bool Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal) const override;
+
+        math::vec3 GetWorldSupportPoint(const math::mat4& transform, const math::vec3& direction) const override
+        {
+            return GetWorldBox(transform).getSupportPoint(direction);
+        }
+
+        /**@brief Gets the box in world space, the scale of the transform is moved into the half extents.
+         */
+        L_NODISCARD world_box GetWorldBox(const math::mat4& transform) const;
+
+        L_NODISCARD const math::vec3& GetHalfExtents() const noexcept
+        {
+            return halfExtents;
+        }
+
+    private:
+
+        math::vec3 halfExtents;
+        math::vec3 localCenter;
+    };
+}
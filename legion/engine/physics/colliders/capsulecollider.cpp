@@ -0,0 +1,91 @@
+#include <physics/colliders/capsulecollider.hpp>
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/colliders/convexcollider.hpp>
+#include <physics/physics_statics.hpp>
+
+namespace legion::physics
+{
+    void CapsuleCollider::CheckCollisionWith(ConvexCollider* convexCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'convexCollider' is colliderA
+        if (!PhysicsStatics::CollideAABB(GetMinMaxWorldAABB(), convexCollider->GetMinMaxWorldAABB()))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectCapsuleConvexCollision(GetWorldCapsule(manifold.transformB),
+            convexCollider, manifold.transformA, collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, false, manifold);
+    }
+
+    void CapsuleCollider::CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'sphereCollider' is colliderA
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereCapsuleCollision(sphereCollider->GetWorldSphere(manifold.transformA),
+            GetWorldCapsule(manifold.transformB), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    void CapsuleCollider::CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'capsuleCollider' is colliderA
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectCapsuleCapsuleCollision(capsuleCollider->GetWorldCapsule(manifold.transformA),
+            GetWorldCapsule(manifold.transformB), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    void CapsuleCollider::UpdateTransformedTightBoundingVolume(const math::mat4& transform)
+    {
+        const world_capsule capsule = GetWorldCapsule(transform);
+        const math::vec3 extents = math::vec3(capsule.radius);
+
+        minMaxWorldAABB = std::make_pair(math::min(capsule.start, capsule.end) - extents,
+            math::max(capsule.start, capsule.end) + extents);
+    }
+
+    bool CapsuleCollider::Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal) const
+    {
+        return PhysicsStatics::RaycastCapsule(GetWorldCapsule(transform), origin, direction, maxDistance, outDistance, outNormal);
+    }
+
+    void CapsuleCollider::DrawColliderRepresentation(const math::mat4& transform, math::color usedColor, float width, float time, bool ignoreDepth)
+    {
+        if (!shouldBeDrawn) { return; }
+
+        const world_capsule capsule = GetWorldCapsule(transform);
+        const math::vec3 right = math::normalize(math::vec3(transform[0]));
+        const math::vec3 forward = math::normalize(math::vec3(transform[2]));
+
+        DrawCircle(capsule.start, right, forward, capsule.radius, usedColor, width, time, ignoreDepth);
+        DrawCircle(capsule.end, right, forward, capsule.radius, usedColor, width, time, ignoreDepth);
+
+        for (const math::vec3& side : { right, -right, forward, -forward })
+        {
+            debug::user_projectDrawLine(capsule.start + side * capsule.radius, capsule.end + side * capsule.radius,
+                usedColor, width, time, ignoreDepth);
+        }
+    }
+}
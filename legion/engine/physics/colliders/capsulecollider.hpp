@@ -0,0 +1,108 @@
+#pragma once
+
+#include <core/core.hpp>
+#include <physics/colliders/physicscollider.hpp>
+#include <physics/data/convex_convergance_identifier.hpp>
+#include <physics/data/collider_pair_cache.hpp>
+#include <physics/data/primitive_shapes.hpp>
+
+namespace legion::physics
+{
+    /**@class CapsuleCollider
+     * @brief A capsule along the local y axis. The capsule is every point within radius of a segment
+     * of the given height around a local offset, the total height of the capsule is height + 2 * radius.
+     * @note The radius is scaled by the largest scale of the transform of the entity.
+     */
+    class CapsuleCollider : public PhysicsCollider
+    {
+    public:
+
+        CapsuleCollider(float pRadius = 0.5f, float pHeight = 1.0f, const math::vec3& offset = math::vec3(0.0f))
+            : radius(pRadius), halfHeight(pHeight * 0.5f)
+        {
+            localColliderCentroid = offset;
+            UpdateLocalAABB();
+        }
+
+        /** @brief Given a physics_contact that has been resolved, stores its lambdas so they can be matched by position
+        */
+        void AddConverganceIdentifier(const physics_contact& contact, collider_pair_cache& pairCache) override
+        {
+            math::vec3 localRefContact = math::inverse(contact.refTransform) * math::vec4(contact.RefWorldContact, 1);
+
+            pairCache.converganceIdentifiers.push_back(
+                std::make_unique<ConvexConverganceIdentifier>(contact.label, contact.totalLambda,
+                    contact.tangent1Lambda, contact.tangent2Lambda, GetColliderID(), localRefContact));
+        }
+
+        void CheckCollision(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
+        {
+            physicsCollider->CheckCollisionWith(this, manifold);
+        }
+
+        void CheckCollisionWith(ConvexCollider* convexCollider, physics_manifold& manifold) override;
+
+        void CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold) override;
+
+        void CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold) override;
+
+        void PopulateContactPoints(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
+        {
+            PopulateContactPointsFromPenetrationQuery(manifold);
+        }
+
+        void PopulateContactPointsWith(ConvexCollider* convexCollider, physics_manifold& manifold) override
+        {
+            PopulateContactPointsFromPenetrationQuery(manifold);
+        }
+
+        void UpdateTransformedTightBoundingVolume(const math::mat4& transform) override;
+
+        bool Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal) const override;
+
+        math::vec3 GetWorldSupportPoint(const math::mat4& transform, const math::vec3& direction) const override
+        {
+            const world_capsule capsule = GetWorldCapsule(transform);
+            return math::dot(direction, capsule.end - capsule.start) >= 0.0f ? capsule.end : capsule.start;
+        }
+
+        float GetWorldRadius(const math::mat4& transform) const override
+        {
+            return radius * getMaximumScale(transform);
+        }
+
+        void UpdateLocalAABB() override
+        {
+            const math::vec3 extents = math::vec3(radius, halfHeight + radius, radius);
+            minMaxLocalAABB = std::make_pair(localColliderCentroid - extents, localColliderCentroid + extents);
+        }
+
+        void DrawColliderRepresentation(const math::mat4& transform, math::color usedColor, float width, float time, bool ignoreDepth = false) override;
+
+        /**@brief Gets the capsule in world space.
+         */
+        L_NODISCARD world_capsule GetWorldCapsule(const math::mat4& transform) const
+        {
+            const math::vec3 localUp = math::vec3(0.0f, halfHeight, 0.0f);
+
+            return world_capsule{ transform * math::vec4(localColliderCentroid - localUp, 1),
+                transform * math::vec4(localColliderCentroid + localUp, 1), radius * getMaximumScale(transform) };
+        }
+
+        L_NODISCARD float GetRadius() const noexcept
+        {
+            return radius;
+        }
+
+        L_NODISCARD float GetHeight() const noexcept
+        {
+            return halfHeight * 2.0f;
+        }
+
+    private:
+
+        float radius;
+        float halfHeight;
+    };
+}
@@ -1,9 +1,10 @@
 #include <physics/colliders/convexcollider.hpp>
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/colliders/capsulecollider.hpp>
 #include <physics/physics_statics.hpp>
 #include <physics/data/identifier.hpp>
 #include <physics/data/convexconvexpenetrationquery.hpp>
 #include <physics/data/edgepenetrationquery.hpp>
-#include <physics/data/pointer_encapsulator.hpp>
 #include <physics/systems/physicssystem.hpp>
 #include <rendering/debugrendering.hpp>
 
@@ -28,59 +29,97 @@ namespace legion::physics
         //auto compIDA = manifold.entityA.get_component_handle<identifier>();
         //auto compIDB = manifold.entityB.get_component_handle<identifier>();
 
-        //--------------------- Check for a collision by going through the edges and faces of both polyhedrons  --------------//
+        //--------------------- Check the features that were found by the seperating axis test of the last step first ------------//
         //'this' is colliderB and 'convexCollider' is colliderA
-        
+
+        collider_pair_cache* pairCache = manifold.pairCache;
+
+        //the transform of the collider with the highest id in the space of the collider with the lowest id
+        const math::mat4 relativeTransform = GetColliderID() < convexCollider->GetColliderID() ?
+            math::inverse(manifold.transformB) * manifold.transformA : math::inverse(manifold.transformA) * manifold.transformB;
+
+        if (pairCache)
+        {
+            if (TestCachedSeperatingFeature(convexCollider, manifold))
+            {
+                manifold.isColliding = false;
+                return;
+            }
+
+            if (pairCache->penetrationFeature.isSet() && pairCache->isRelativeTransformStable(relativeTransform)
+                && ReuseCachedPenetrationFeature(convexCollider, manifold))
+            {
+                return;
+            }
+        }
+
+        //--------------------- Check for a collision by going through the edges and faces of both polyhedrons  --------------//
 
         ////log::debug("-------------------- SAT CHECK -----------------");
-        PointerEncapsulator < HalfEdgeFace> ARefFace;
+        const ConvexHull& hullA = convexCollider->GetConvexHull();
+        const ConvexHull& hullB = GetConvexHull();
+
+        ConvexHull::feature_index ARefFace;
 
         ////log::debug("Face Check A");
         float ARefSeperation;
         if (PhysicsStatics::FindSeperatingAxisByExtremePointProjection(
-            this, convexCollider, manifold.transformB,manifold.transformA,  ARefFace, ARefSeperation) || !ARefFace.ptr)
+            this, convexCollider, manifold.transformB,manifold.transformA,  ARefFace, ARefSeperation)
+            || ARefFace == ConvexHull::invalid_index)
         {
             //log::debug("Not Found on A ");
+            if (pairCache)
+            {
+                pairCache->penetrationFeature.reset();
+                CacheFaceFeature(pairCache->seperatingFeature, convexCollider, ARefFace);
+            }
+
             manifold.isColliding = false;
             return;
         }
 
-        PointerEncapsulator < HalfEdgeFace> BRefFace;
+        ConvexHull::feature_index BRefFace;
         //log::debug("Face Check B");
         float BRefSeperation;
         if (PhysicsStatics::FindSeperatingAxisByExtremePointProjection(convexCollider,
-            this, manifold.transformA, manifold.transformB, BRefFace, BRefSeperation, shouldDebug) || !BRefFace.ptr)
+            this, manifold.transformA, manifold.transformB, BRefFace, BRefSeperation, shouldDebug)
+            || BRefFace == ConvexHull::invalid_index)
         {
             //log::debug("Not Found on B ");
+            if (pairCache)
+            {
+                pairCache->penetrationFeature.reset();
+                CacheFaceFeature(pairCache->seperatingFeature, this, BRefFace);
+            }
+
             manifold.isColliding = false;
             return;
         }
 
-        PointerEncapsulator< HalfEdgeEdge> edgeRef;
-        PointerEncapsulator< HalfEdgeEdge> edgeInc;
+        ConvexHull::feature_index edgeRef;
+        ConvexHull::feature_index edgeInc;
 
         math::vec3 edgeNormal;
         float aToBEdgeSeperation;
         //log::debug("Edge Check");
         if (PhysicsStatics::FindSeperatingAxisByGaussMapEdgeCheck(this, convexCollider, manifold.transformB, manifold.transformA,
-            edgeRef, edgeInc, edgeNormal, aToBEdgeSeperation, shouldDebug) || !edgeRef.ptr)
+            edgeRef, edgeInc, edgeNormal, aToBEdgeSeperation, shouldDebug) || edgeRef == ConvexHull::invalid_index)
         {
             //
             manifold.isColliding = false;
 
-            if (shouldDebug)
+            if (pairCache)
             {
-                edgeRef.ptr->DEBUG_drawEdge(manifold.transformB, math::colors::blue, 10.0f);
-                edgeInc.ptr->DEBUG_drawEdge(manifold.transformA, math::colors::red, 10.0f);
+                pairCache->penetrationFeature.reset();
+                CacheEdgeFeature(pairCache->seperatingFeature, this, edgeRef, edgeInc);
             }
+
             return;
         }
 
         if (shouldDebug)
         {
             log::debug("-> collision detected for debug ");
-            ARefFace.ptr->DEBUG_DrawFace(manifold.transformA, math::colors::blue, 5.0f);
-            BRefFace.ptr->DEBUG_DrawFace(manifold.transformB, math::colors::red, 5.0f);
         }
 
       
@@ -99,38 +138,44 @@ namespace legion::physics
 
         //TODO all penetration querys should supply a constructor that takes in a  ConvexConvexCollisionInfo
         
-        math::vec3 worldFaceCentroidA = manifold.transformA * math::vec4(ARefFace.ptr->centroid, 1);
-        math::vec3 worldFaceNormalA = manifold.transformA * math::vec4(ARefFace.ptr->normal, 0);
+        const ConvexHull::hull_face& faceA = hullA.getFaces()[ARefFace];
+        math::vec3 worldFaceCentroidA = manifold.transformA * math::vec4(faceA.centroid, 1);
+        math::vec3 worldFaceNormalA = manifold.transformA * math::vec4(faceA.normal, 0);
         
-        math::vec3 worldFaceCentroidB = manifold.transformB * math::vec4(BRefFace.ptr->centroid, 1);
-        math::vec3 worldFaceNormalB = manifold.transformB * math::vec4(BRefFace.ptr->normal, 0);
+        const ConvexHull::hull_face& faceB = hullB.getFaces()[BRefFace];
+        math::vec3 worldFaceCentroidB = manifold.transformB * math::vec4(faceB.centroid, 1);
+        math::vec3 worldFaceNormalB = manifold.transformB * math::vec4(faceB.normal, 0);
 
     
-        math::vec3 worldEdgeAPosition = edgeRef.ptr? manifold.transformB * math::vec4(edgeRef.ptr->edgePosition, 1) : math::vec3();
+        math::vec3 worldEdgeAPosition = manifold.transformB * math::vec4(hullB.getEdgeStart(edgeRef), 1);
         math::vec3 worldEdgeNormal = edgeNormal;
 
         auto abPenetrationQuery =
-            std::make_unique< ConvexConvexPenetrationQuery>(ARefFace.ptr
-                , BRefFace.ptr, worldFaceCentroidA,worldFaceNormalA, ARefSeperation,true);
+            std::make_unique< ConvexConvexPenetrationQuery>(&hullA, ARefFace
+                , &hullB, BRefFace, worldFaceCentroidA,worldFaceNormalA, ARefSeperation,true);
 
         auto baPenetrationQuery =
-            std::make_unique < ConvexConvexPenetrationQuery>(BRefFace.ptr, ARefFace.ptr,
+            std::make_unique < ConvexConvexPenetrationQuery>(&hullB, BRefFace, &hullA, ARefFace,
                 worldFaceCentroidB, worldFaceNormalB, BRefSeperation, false);
 
         auto abEdgePenetrationQuery = 
-            std::make_unique < EdgePenetrationQuery>(edgeRef.ptr, edgeInc.ptr,worldEdgeAPosition,worldEdgeNormal,
+            std::make_unique < EdgePenetrationQuery>(&hullB, edgeRef, &hullA, edgeInc,worldEdgeAPosition,worldEdgeNormal,
                 aToBEdgeSeperation, false);
 
         //-------------------------------------- Choose which PenetrationQuery to use for contact population --------------------------------------------------//
 
+        cached_feature chosenFeature;
+
         if (abPenetrationQuery->penetration + physics::constants::faceToFacePenetrationBias >
             baPenetrationQuery->penetration)
         {
             manifold.penetrationInformation = std::move(abPenetrationQuery);
+            if (pairCache) { CacheFaceFeature(chosenFeature, convexCollider, ARefFace); }
         }
         else
         {
             manifold.penetrationInformation = std::move(baPenetrationQuery);
+            if (pairCache) { CacheFaceFeature(chosenFeature, this, BRefFace); }
         }
 
 
@@ -138,6 +183,14 @@ namespace legion::physics
             manifold.penetrationInformation->penetration + physics::constants::faceToEdgePenetrationBias)
         {
             manifold.penetrationInformation = std::move(abEdgePenetrationQuery);
+            if (pairCache) { CacheEdgeFeature(chosenFeature, this, edgeRef, edgeInc); }
+        }
+
+        if (pairCache)
+        {
+            pairCache->seperatingFeature.reset();
+            pairCache->penetrationFeature = chosenFeature;
+            pairCache->relativeTransform = relativeTransform;
         }
 
         if (shouldDebug)
@@ -183,51 +236,259 @@ namespace legion::physics
    
     }
 
-    void ConvexCollider::PopulateContactPointsWith(ConvexCollider* convexCollider, physics_manifold& manifold)
+    bool ConvexCollider::TestCachedSeperatingFeature(ConvexCollider* convexCollider, physics_manifold& manifold)
     {
         OPTICK_EVENT();
-        math::mat4& refTransform = manifold.penetrationInformation->isARef ? manifold.transformA : manifold.transformB;
-        math::mat4& incTransform = manifold.penetrationInformation->isARef ? manifold.transformB : manifold.transformA;
+        const cached_feature& feature = manifold.pairCache->seperatingFeature;
+        if (!feature.isSet()) { return false; }
 
-        physicsComponent* refPhysicsComp = manifold.penetrationInformation->isARef ? manifold.physicsCompA : manifold.physicsCompB;
-        physicsComponent* incPhysicsComp = manifold.penetrationInformation->isARef ? manifold.physicsCompB : manifold.physicsCompA;
+        const bool ownedByThis = feature.colliderID == GetColliderID();
+        ConvexCollider* owner = ownedByThis ? this : convexCollider;
+        ConvexCollider* other = ownedByThis ? convexCollider : this;
+        const math::mat4& ownerTransform = ownedByThis ? manifold.transformB : manifold.transformA;
+        const math::mat4& otherTransform = ownedByThis ? manifold.transformA : manifold.transformB;
 
-        PhysicsCollider* refCollider = manifold.penetrationInformation->isARef ? manifold.colliderA : manifold.colliderB;
-        PhysicsCollider* incCollider = manifold.penetrationInformation->isARef ? manifold.colliderB : manifold.colliderA;
+        if (feature.type == CachedFeatureType::Face)
+        {
+            auto& faces = owner->GetConvexHull().getFaces();
+            if (feature.index >= faces.size()) { return false; }
 
-        manifold.penetrationInformation->populateContactList(manifold, refTransform, incTransform, refCollider);
+            return PhysicsStatics::GetFaceSeperation(faces[feature.index], ownerTransform, other, otherTransform) > 0.0f;
+        }
 
-        rigidbody* refRB = manifold.penetrationInformation->isARef ? manifold.rigidbodyA : manifold.rigidbodyB;
-        rigidbody* incRB = manifold.penetrationInformation->isARef ? manifold.rigidbodyB : manifold.rigidbodyA;
+        if (feature.index >= owner->GetConvexHull().getEdges().size()
+            || feature.incidentIndex >= other->GetConvexHull().getEdges().size())
+        {
+            return false;
+        }
 
-        math::vec3 refWorldCentroid = refTransform * math::vec4(refPhysicsComp->localCenterOfMass,1);
-        math::vec3 incWorldCentroid = incTransform * math::vec4(incPhysicsComp->localCenterOfMass,1);
+        //the edge pair only gives the direction of the axis, both hulls are projected on it
+        //so the result is valid even if the edges no longer create a minkowski face
+        math::vec3 seperatingAxis;
+        float edgeSeperation;
+        if (!PhysicsStatics::GetEdgeSeperation(owner, static_cast<ConvexHull::feature_index>(feature.index),
+            other, static_cast<ConvexHull::feature_index>(feature.incidentIndex),
+            ownerTransform, otherTransform, seperatingAxis, edgeSeperation))
+        {
+            return false;
+        }
 
-        for ( auto& contact : manifold.contacts)
+        return PhysicsStatics::GetSeperationOnAxis(owner, other, ownerTransform, otherTransform, seperatingAxis) > 0.0f;
+    }
+
+    bool ConvexCollider::ReuseCachedPenetrationFeature(ConvexCollider* convexCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        const cached_feature& feature = manifold.pairCache->penetrationFeature;
+
+        const bool ownedByThis = feature.colliderID == GetColliderID();
+        ConvexCollider* owner = ownedByThis ? this : convexCollider;
+        ConvexCollider* other = ownedByThis ? convexCollider : this;
+        const math::mat4& ownerTransform = ownedByThis ? manifold.transformB : manifold.transformA;
+        const math::mat4& otherTransform = ownedByThis ? manifold.transformA : manifold.transformB;
+
+        //'this' is colliderB, so the owner of the feature is the reference of colliderA when it is not 'this'
+        const bool isARef = !ownedByThis;
+
+        const ConvexHull& refHull = owner->GetConvexHull();
+        const ConvexHull& incHull = other->GetConvexHull();
+
+        if (feature.type == CachedFeatureType::Face)
         {
-            contact.incTransform = incTransform;
-            contact.refTransform = refTransform;
+            if (feature.index >= refHull.getFaces().size()) { return false; }
+
+            const auto refFace = static_cast<ConvexHull::feature_index>(feature.index);
+            const ConvexHull::hull_face& face = refHull.getFaces()[refFace];
+
+            float seperation = PhysicsStatics::GetFaceSeperation(face, ownerTransform, other, otherTransform);
+            if (seperation > 0.0f) { return false; }
+
+            math::vec3 worldFaceCentroid = ownerTransform * math::vec4(face.centroid, 1);
+            math::vec3 worldFaceNormal = ownerTransform * math::vec4(face.normal, 0);
+
+            //the incident face is searched for while populating the contacts
+            manifold.penetrationInformation = std::make_unique<ConvexConvexPenetrationQuery>(
+                &refHull, refFace, &incHull, ConvexHull::invalid_index, worldFaceCentroid, worldFaceNormal, seperation, isARef);
+        }
+        else
+        {
+            if (feature.index >= refHull.getEdges().size() || feature.incidentIndex >= incHull.getEdges().size()) { return false; }
+
+            const auto refEdge = static_cast<ConvexHull::feature_index>(feature.index);
+            const auto incEdge = static_cast<ConvexHull::feature_index>(feature.incidentIndex);
+
+            math::vec3 seperatingAxis;
+            float seperation;
+            if (!PhysicsStatics::GetEdgeSeperation(owner, refEdge, other, incEdge, ownerTransform, otherTransform, seperatingAxis, seperation)
+                || seperation > 0.0f)
+            {
+                return false;
+            }
+
+            math::vec3 worldEdgePosition = ownerTransform * math::vec4(refHull.getEdgeStart(refEdge), 1);
 
-            contact.rbInc = incRB;
-            contact.rbRef = refRB;
-           
-            contact.collisionNormal = manifold.penetrationInformation->normal;
+            manifold.penetrationInformation = std::make_unique<EdgePenetrationQuery>(
+                &refHull, refEdge, &incHull, incEdge, worldEdgePosition, seperatingAxis, seperation, isARef);
+        }
 
-            contact.refRBCentroid = refWorldCentroid;
-            contact.incRBCentroid = incWorldCentroid;
+        manifold.isColliding = true;
+        return true;
+    }
 
+    void ConvexCollider::CacheFaceFeature(cached_feature& feature, ConvexCollider* owner, ConvexHull::feature_index face)
+    {
+        if (face == ConvexHull::invalid_index)
+        {
+            feature.reset();
+            return;
         }
+
+        feature.type = CachedFeatureType::Face;
+        feature.colliderID = owner->GetColliderID();
+        feature.index = face;
+    }
+
+    void ConvexCollider::CacheEdgeFeature(cached_feature& feature, ConvexCollider* refCollider,
+        ConvexHull::feature_index refEdge, ConvexHull::feature_index incEdge)
+    {
+        if (refEdge == ConvexHull::invalid_index || incEdge == ConvexHull::invalid_index)
+        {
+            feature.reset();
+            return;
+        }
+
+        feature.type = CachedFeatureType::Edge;
+        feature.colliderID = refCollider->GetColliderID();
+        feature.index = refEdge;
+        feature.incidentIndex = incEdge;
+    }
+
+    void ConvexCollider::PopulateContactPointsWith(ConvexCollider* convexCollider, physics_manifold& manifold)
+    {
+        PopulateContactPointsFromPenetrationQuery(manifold);
+    }
+
+    void ConvexCollider::CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'sphereCollider' is colliderA
+        if (!physics::PhysicsStatics::CollideAABB(GetMinMaxWorldAABB(), sphereCollider->GetMinMaxWorldAABB()))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereConvexCollision(sphereCollider->GetWorldSphere(manifold.transformA),
+            this, manifold.transformB, collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    void ConvexCollider::CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'capsuleCollider' is colliderA
+        if (!physics::PhysicsStatics::CollideAABB(GetMinMaxWorldAABB(), capsuleCollider->GetMinMaxWorldAABB()))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectCapsuleConvexCollision(capsuleCollider->GetWorldCapsule(manifold.transformA),
+            this, manifold.transformB, collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    bool ConvexCollider::Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal) const
+    {
+        return PhysicsStatics::RaycastConvex(this, transform, origin, direction, maxDistance, outDistance, outNormal);
+    }
+
+    math::vec3 ConvexCollider::GetWorldSupportPoint(const math::mat4& transform, const math::vec3& direction) const
+    {
+        const VertexSoA& verticesSoA = convexHull->getVerticesSoA();
+        if (verticesSoA.empty())
+        {
+            return transform * math::vec4(localColliderCentroid, 1);
+        }
+
+        //the support point of a transformed hull is the transformed support point in the direction transformed by the transpose
+        const math::vec3 localDirection = math::transpose(math::mat3(transform)) * direction;
+        return transform * math::vec4(convexHull->getVertices()[verticesSoA.getSupportIndex(localDirection)], 1);
     }
 
     void ConvexCollider::UpdateTightAABB(const math::mat4& transform)
     {
-        minMaxWorldAABB = PhysicsStatics::ConstructAABBFromTransformedVertices
-        (vertices, transform);
+        OPTICK_EVENT();
+        const VertexSoA& verticesSoA = convexHull->getVerticesSoA();
+        if (verticesSoA.empty()) { return; }
+
+        //the extent of the transformed hull on a world axis is the support point in the direction of
+        //the matching row of the transform, this way the search can stay in local space
+        const math::mat3 directionToLocal = math::transpose(math::mat3(transform));
+        math::vec3 min, max;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            math::vec3 worldAxis = math::vec3(0.0f);
+            worldAxis[axis] = 1.0f;
+
+            const math::vec3 localAxis = directionToLocal * worldAxis;
+
+            float maxDistance, minDistance;
+            verticesSoA.getSupportIndex(localAxis, maxDistance);
+            verticesSoA.getSupportIndex(-localAxis, minDistance);
+
+            max[axis] = maxDistance + transform[3][axis];
+            min[axis] = -minDistance + transform[3][axis];
+        }
+
+        minMaxWorldAABB = std::make_pair(min, max);
+    }
+
+    void ConvexCollider::PrecomputeCollisionData()
+    {
+        OPTICK_EVENT();
+        if (halfEdgeFaces.empty()) { return; }
+
+        UpdateLocalAABB();
+        convexHull = ConvexHull::build(halfEdgeFaces);
+        ReleaseHalfEdgeData();
+    }
+
+    void ConvexCollider::ReleaseHalfEdgeData()
+    {
+        for (auto face : halfEdgeFaces)
+        {
+            delete face;
+        }
+
+        halfEdgeFaces.clear();
+        halfEdgeFaces.shrink_to_fit();
+        faceIndexMap.clear();
+        faceVertMap.clear();
+        faceVertMap.shrink_to_fit();
+        toBeSorted.clear();
+        toBeSorted.shrink_to_fit();
+        vertices.clear();
+        vertices.shrink_to_fit();
     }
 
     void ConvexCollider::UpdateLocalAABB()
     {
-        minMaxLocalAABB = PhysicsStatics::ConstructAABBFromVertices(vertices);
+        minMaxLocalAABB = PhysicsStatics::ConstructAABBFromVertices(vertices.empty() ? convexHull->getVertices() : vertices);
     }
 
     void ConvexCollider::DrawColliderRepresentation(const math::mat4& transform,math::color usedColor, float width, float time,bool ignoreDepth)
@@ -236,30 +497,23 @@ namespace legion::physics
         //math::vec3 colliderCentroid = pos + math::vec3(localTransform * math::vec4(physCollider->GetLocalCentroid(), 0));
         //debug::user_projectDrawLine(colliderCentroid, colliderCentroid + math::vec3(0.0f,0.2f,0.0f), math::colors::cyan, 6.0f,0.0f,true);
 
-        for (auto face : GetHalfEdgeFaces())
-        {
-            //face->forEachEdge(drawFunc);
-            physics::HalfEdgeEdge* initialEdge = face->startEdge;
-            physics::HalfEdgeEdge* currentEdge = face->startEdge;
+        const ConvexHull& hull = GetConvexHull();
 
-            math::vec3 faceStart = transform * math::vec4(face->centroid, 1);
-            math::vec3 faceEnd = faceStart + math::vec3((transform * math::vec4(face->normal, 0))) * 0.5f;
+        for (const auto& face : hull.getFaces())
+        {
+            math::vec3 faceStart = transform * math::vec4(face.centroid, 1);
+            math::vec3 faceEnd = faceStart + math::vec3((transform * math::vec4(face.normal, 0))) * 0.5f;
 
             debug::user_projectDrawLine(faceStart, faceEnd, math::colors::green, 2.0f);
+        }
 
-            if (!currentEdge) { return; }
-
-            do
-            {
-                physics::HalfEdgeEdge* edgeToExecuteOn = currentEdge;
-                currentEdge = currentEdge->nextEdge;
-
-                math::vec3 worldStart = transform * math::vec4(edgeToExecuteOn->edgePosition, 1);
-                math::vec3 worldEnd = transform * math::vec4(edgeToExecuteOn->nextEdge->edgePosition, 1);
-
-                debug::user_projectDrawLine(worldStart, worldEnd, usedColor, width, time,ignoreDepth);
+        //every edge is drawn once, the pairing half edges would draw the same line
+        for (ConvexHull::feature_index edge : hull.getUniqueEdges())
+        {
+            math::vec3 worldStart = transform * math::vec4(hull.getEdgeStart(edge), 1);
+            math::vec3 worldEnd = transform * math::vec4(hull.getEdgeEnd(edge), 1);
 
-            } while (initialEdge != currentEdge && currentEdge != nullptr);
+            debug::user_projectDrawLine(worldStart, worldEnd, usedColor, width, time,ignoreDepth);
         }
 
 
@@ -683,6 +937,7 @@ namespace legion::physics
         //}
         ////convexHullMergeFaces(halfEdgeFaces,true);
         AssertEdgeValidity();
+        PrecomputeCollisionData();
         //log::debug("-> Finish ConstructConvexHullWithMesh ----------------------------------");
     }
     
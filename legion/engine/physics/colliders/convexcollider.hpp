@@ -8,6 +8,7 @@
 #include <physics/halfedgeface.hpp>
 #include <physics/data/convex_convergance_identifier.hpp>
 #include <physics/data/physics_manifold.hpp>
+#include <physics/data/convex_hull.hpp>
 #include <rendering/debugrendering.hpp>
 
 namespace legion::physics
@@ -19,21 +20,31 @@ namespace legion::physics
         int step = 0;
         ConvexCollider() = default;
 
+        /**@brief Creates a collider that uses a hull that was already built, the hull is shared and not copied.
+         * The centroid of the collider is the average of the vertices of the hull.
+         */
+        explicit ConvexCollider(std::shared_ptr<const ConvexHull> sharedHull) : convexHull(std::move(sharedHull))
+        {
+            vertices = convexHull->getVertices();
+            CalculateLocalColliderCentroid();
+            UpdateLocalAABB();
+            vertices.clear();
+        }
+
         ~ConvexCollider()
         {
-            for (auto face : halfEdgeFaces)
-            {
-                delete face;
-            }
+            ReleaseHalfEdgeData();
         }
 
         /** @brief Given a physics_contact that has been resolved, use its label and lambdas in order to create a ConvexConverganceIdentifier
        */
-        void AddConverganceIdentifier(const physics_contact& contact) override
+        void AddConverganceIdentifier(const physics_contact& contact, collider_pair_cache& pairCache) override
         {
-            converganceIdentifiers.push_back(
+            math::vec3 localRefContact = math::inverse(contact.refTransform) * math::vec4(contact.RefWorldContact, 1);
+
+            pairCache.converganceIdentifiers.push_back(
                 std::make_unique<ConvexConverganceIdentifier>(contact.label, contact.totalLambda,
-                    contact.tangent1Lambda, contact.tangent2Lambda, GetColliderID()));
+                    contact.tangent1Lambda, contact.tangent2Lambda, GetColliderID(), localRefContact));
         }
 
         void CheckCollision(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
@@ -46,6 +57,14 @@ namespace legion::physics
         */
         void CheckCollisionWith(ConvexCollider* convexCollider, physics_manifold& manifold) override;
 
+        /** @brief Given a SphereCollider and a physics_manifold, finds the closest point on the hull to the center of the sphere
+        */
+        void CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold) override;
+
+        /** @brief Given a CapsuleCollider and a physics_manifold, finds the closest points between the hull and the segment of the capsule
+        */
+        void CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold) override;
+
         void PopulateContactPoints(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
         {
             physicsCollider->PopulateContactPointsWith(this, manifold);
@@ -58,6 +77,13 @@ namespace legion::physics
             UpdateTightAABB(transform);
         }
 
+        /**@brief Casts a ray against the faces of the hull by clipping it against every face plane.
+         */
+        bool Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal) const override;
+
+        math::vec3 GetWorldSupportPoint(const math::mat4& transform, const math::vec3& direction) const override;
+
         /**@brief Given the current transform of the entity, creates a tight AABB of the collider;
         */
         void UpdateTightAABB(const math::mat4& transform);
@@ -334,16 +360,27 @@ namespace legion::physics
             //check if halfEdge data structure was initialized correctly. this will be commented when I know it always works
             AssertEdgeValidity();
             CalculateLocalColliderCentroid();
+            PrecomputeCollisionData();
         }
 
-        std::vector<HalfEdgeFace*>& GetHalfEdgeFaces() override
+        /**@brief Builds the ConvexHull that is used for collision detection from the finished half edge data structure,
+         * after which the half edge data structure is released.
+         * @note Needs to be called at the end of every function that constructs the half edge data structure.
+         */
+        void PrecomputeCollisionData();
+
+        /**@brief Gets the hull that is used for collision detection, it is empty until the hull has been constructed.
+         */
+        const ConvexHull& GetConvexHull() const
         {
-            return halfEdgeFaces;
+            return *convexHull;
         }
 
-        const std::vector<math::vec3>& GetVertices() const
+        /**@brief Gets the hull so that it can be shared with other colliders.
+         */
+        const std::shared_ptr<const ConvexHull>& GetSharedConvexHull() const
         {
-            return vertices;
+            return convexHull;
         }
 
         void AssertEdgeValidity()
@@ -367,7 +404,28 @@ namespace legion::physics
     private:
 
 
+        //the vertices and half edge faces only exist while the hull is constructed
         std::vector<math::vec3> vertices;
+        std::shared_ptr<const ConvexHull> convexHull = ConvexHull::getEmpty();
+
+        /**@brief Deletes the half edge data structure that was used to construct the hull.
+         */
+        void ReleaseHalfEdgeData();
+
+        /**@brief Checks if the seperating feature that was cached for this collider pair still seperates the colliders.
+         * @note 'this' is colliderB of the manifold and convexCollider is colliderA.
+         */
+        bool TestCachedSeperatingFeature(ConvexCollider* convexCollider, physics_manifold& manifold);
+
+        /**@brief Creates the penetration information of the manifold using the penetration feature that was cached for this collider pair.
+         * @return false if the cached feature could not be used and the full seperating axis test needs to run.
+         */
+        bool ReuseCachedPenetrationFeature(ConvexCollider* convexCollider, physics_manifold& manifold);
+
+        static void CacheFaceFeature(cached_feature& feature, ConvexCollider* owner, ConvexHull::feature_index face);
+
+        static void CacheEdgeFeature(cached_feature& feature, ConvexCollider* refCollider,
+            ConvexHull::feature_index refEdge, ConvexHull::feature_index incEdge);
 
         HalfEdgeFace* instantiateMeshFace(const std::vector<math::vec3*>& vertices, const math::vec3& faceNormal)
         {
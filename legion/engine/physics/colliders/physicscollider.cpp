@@ -0,0 +1,69 @@
+#include <physics/colliders/physicscollider.hpp>
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/data/physics_manifold.hpp>
+#include <physics/data/primitivepenetrationquery.hpp>
+#include <rendering/debugrendering.hpp>
+
+namespace legion::physics
+{
+    void PhysicsCollider::CheckCollisionWith(BoxCollider* boxCollider, physics_manifold& manifold)
+    {
+        CheckCollisionWith(static_cast<ConvexCollider*>(boxCollider), manifold);
+    }
+
+    void PhysicsCollider::PopulateContactPointsFromPenetrationQuery(physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        math::mat4& refTransform = manifold.penetrationInformation->isARef ? manifold.transformA : manifold.transformB;
+        math::mat4& incTransform = manifold.penetrationInformation->isARef ? manifold.transformB : manifold.transformA;
+
+        physicsComponent* refPhysicsComp = manifold.penetrationInformation->isARef ? manifold.physicsCompA : manifold.physicsCompB;
+        physicsComponent* incPhysicsComp = manifold.penetrationInformation->isARef ? manifold.physicsCompB : manifold.physicsCompA;
+
+        PhysicsCollider* refCollider = manifold.penetrationInformation->isARef ? manifold.colliderA : manifold.colliderB;
+
+        manifold.penetrationInformation->populateContactList(manifold, refTransform, incTransform, refCollider);
+
+        rigidbody* refRB = manifold.penetrationInformation->isARef ? manifold.rigidbodyA : manifold.rigidbodyB;
+        rigidbody* incRB = manifold.penetrationInformation->isARef ? manifold.rigidbodyB : manifold.rigidbodyA;
+
+        math::vec3 refWorldCentroid = refTransform * math::vec4(refPhysicsComp->localCenterOfMass, 1);
+        math::vec3 incWorldCentroid = incTransform * math::vec4(incPhysicsComp->localCenterOfMass, 1);
+
+        for (auto& contact : manifold.contacts)
+        {
+            contact.incTransform = incTransform;
+            contact.refTransform = refTransform;
+
+            contact.rbInc = incRB;
+            contact.rbRef = refRB;
+
+            contact.collisionNormal = manifold.penetrationInformation->normal;
+
+            contact.refRBCentroid = refWorldCentroid;
+            contact.incRBCentroid = incWorldCentroid;
+        }
+    }
+
+    void PhysicsCollider::SetPrimitiveCollisionResult(const primitive_collision_info& collisionInfo, bool isShapeAColliderA, physics_manifold& manifold)
+    {
+        manifold.penetrationInformation = std::make_unique<PrimitivePenetrationQuery>(collisionInfo, isShapeAColliderA);
+        manifold.isColliding = true;
+    }
+
+    void PhysicsCollider::DrawCircle(const math::vec3& center, const math::vec3& axisA, const math::vec3& axisB, float radius,
+        math::color usedColor, float width, float time, bool ignoreDepth)
+    {
+        static constexpr int segmentCount = 16;
+
+        math::vec3 previous = center + axisA * radius;
+        for (int i = 1; i <= segmentCount; i++)
+        {
+            const float angle = math::two_pi<float>() * static_cast<float>(i) / static_cast<float>(segmentCount);
+            const math::vec3 current = center + (axisA * math::cos(angle) + axisB * math::sin(angle)) * radius;
+
+            debug::user_projectDrawLine(previous, current, usedColor, width, time, ignoreDepth);
+            previous = current;
+        }
+    }
+}
@@ -9,14 +9,18 @@
 namespace legion::physics
 {
     struct physics_manifold;
+    struct collider_pair_cache;
+    struct primitive_collision_info;
     class ConvexCollider;
+    class BoxCollider;
+    class SphereCollider;
+    class CapsuleCollider;
 
 
     class PhysicsCollider
     {
     public:
         bool shouldBeDrawn = true;
-        std::vector<std::unique_ptr<ConverganceIdentifier>> converganceIdentifiers;
 
         PhysicsCollider()
         {
@@ -24,24 +28,12 @@ namespace legion::physics
             id = colliderID++;
         }
 
-        virtual void AddConverganceIdentifier(const  physics_contact& contact) = 0;
+        virtual ~PhysicsCollider() = default;
 
-        void AttemptFindAndCopyConverganceID(physics_contact& contact)
-        {
-            if (!constants::applyWarmStarting) { return; }
-
-            for (auto&& converganceId : converganceIdentifiers)
-            {
-                if (converganceId->refColliderID == contact.refCollider->GetColliderID())
-                {
-                    if (converganceId->IsEqual(contact))
-                    {
-                        converganceId->CopyLambdasToContact(contact);
-                        return;
-                    }
-                }
-            }
-        }
+        /** @brief Given a physics_contact that has been resolved, stores its lambdas in the cache of the collider pair
+        * so that the contact can be warm started in the next physics step.
+        */
+        virtual void AddConverganceIdentifier(const physics_contact& contact, collider_pair_cache& pairCache) = 0;
             
         /** @brief given a PhysicsCollider, CheckCollision calls "CheckCollisionWith". Both colliders are then passed through
         * to the correct "CheckCollisionWith" function with double dispatch.
@@ -56,6 +48,21 @@ namespace legion::physics
         */
         virtual void CheckCollisionWith(ConvexCollider* convexCollider, physics_manifold& manifold) {};
 
+        /** @brief given a BoxCollider checks if this collider collides the BoxCollider. Colliders that have no
+        * specialised test against boxes treat the box as a ConvexCollider.
+        */
+        virtual void CheckCollisionWith(BoxCollider* boxCollider, physics_manifold& manifold);
+
+        /** @brief given a SphereCollider checks if this collider collides the SphereCollider. The information
+        * is then passed to the manifold.
+        */
+        virtual void CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold) {};
+
+        /** @brief given a CapsuleCollider checks if this collider collides the CapsuleCollider. The information
+        * is then passed to the manifold.
+        */
+        virtual void CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold) {};
+
         /** @brief Gets the unique id of this collider
         */
         int GetColliderID() const
@@ -82,15 +89,39 @@ namespace legion::physics
         */
         virtual void DrawColliderRepresentation(const math::mat4& transform, math::color usedColor, float width, float time, bool ignoreDepth = false) {};
 
-        virtual void UpdateTransformedTightBoundingVolume(const math::mat4& transform) {};
+        /** @brief Casts a ray against this collider.
+        * @param transform The world transform of the entity that the collider is attached to.
+        * @param direction The normalized direction of the ray.
+        * @param outDistance [out] The distance along the ray to the hit, 0 when the origin is inside the collider.
+        * @param outNormal [out] The world space normal of the collider at the hit, -direction when the origin is inside the collider.
+        * @return true if the ray hits the collider within maxDistance.
+        */
+        virtual bool Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal) const
+        {
+            return false;
+        }
 
-        virtual void UpdateLocalAABB() {};
+        /** @brief Gets the point on the core of this collider in world space that is furthest in the given world space direction.
+        * Round colliders are a core shape grown by GetWorldRadius, a point for spheres and a segment for capsules.
+        * Used by the shape casts of the scene queries.
+        */
+        virtual math::vec3 GetWorldSupportPoint(const math::mat4& transform, const math::vec3& direction) const
+        {
+            return transform * math::vec4(localColliderCentroid, 1);
+        }
 
-        inline virtual std::vector<HalfEdgeFace*>& GetHalfEdgeFaces()
+        /** @brief Gets the radius that the core of this collider is grown by in world space, see GetWorldSupportPoint.
+        */
+        virtual float GetWorldRadius(const math::mat4& transform) const
         {
-            return dummyHalfEdges;
+            return 0.0f;
         }
 
+        virtual void UpdateTransformedTightBoundingVolume(const math::mat4& transform) {};
+
+        virtual void UpdateLocalAABB() {};
+
         L_NODISCARD math::vec3 GetLocalCentroid() const noexcept
         {
             return localColliderCentroid;
@@ -109,14 +140,28 @@ namespace legion::physics
 
     protected:
 
+        /** @brief Creates the contact points of the manifold using its penetrationInformation and fills in
+        * the rigidbody information of each contact. Shared by all collider types.
+        */
+        static void PopulateContactPointsFromPenetrationQuery(physics_manifold& manifold);
+
+        /** @brief Stores the result of a closed form primitive collision test in the manifold.
+        * @param collisionInfo The result of the test, shape A of the result is used as the reference.
+        * @param isShapeAColliderA true if shape A of the collision info is colliderA of the manifold.
+        */
+        static void SetPrimitiveCollisionResult(const primitive_collision_info& collisionInfo, bool isShapeAColliderA, physics_manifold& manifold);
+
+        /** @brief Draws a circle in the plane spanned by the normalized and perpendicular axisA and axisB.
+        */
+        static void DrawCircle(const math::vec3& center, const math::vec3& axisA, const math::vec3& axisB, float radius,
+            math::color usedColor, float width, float time, bool ignoreDepth);
+
         math::vec3 localColliderCentroid = math::vec3(0, 0, 0);
         std::pair<math::vec3, math::vec3> minMaxLocalAABB;
         std::pair<math::vec3, math::vec3> minMaxWorldAABB;
     private:
 
         int id = -1;
-       //this is not used, its mostly for debug reasons
-        std::vector<HalfEdgeFace*> dummyHalfEdges;
 
     };
 }
@@ -0,0 +1,99 @@
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/colliders/capsulecollider.hpp>
+#include <physics/physics_statics.hpp>
+
+namespace legion::physics
+{
+    void SphereCollider::CheckCollisionWith(ConvexCollider* convexCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'convexCollider' is colliderA
+        if (!PhysicsStatics::CollideAABB(GetMinMaxWorldAABB(), convexCollider->GetMinMaxWorldAABB()))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereConvexCollision(GetWorldSphere(manifold.transformB),
+            convexCollider, manifold.transformA, collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, false, manifold);
+    }
+
+    void SphereCollider::CheckCollisionWith(BoxCollider* boxCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'boxCollider' is colliderA
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereBoxCollision(GetWorldSphere(manifold.transformB),
+            boxCollider->GetWorldBox(manifold.transformA), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, false, manifold);
+    }
+
+    void SphereCollider::CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'sphereCollider' is colliderA
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereSphereCollision(sphereCollider->GetWorldSphere(manifold.transformA),
+            GetWorldSphere(manifold.transformB), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, true, manifold);
+    }
+
+    void SphereCollider::CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold)
+    {
+        OPTICK_EVENT();
+        //'this' is colliderB and 'capsuleCollider' is colliderA
+        primitive_collision_info collisionInfo;
+        if (!PhysicsStatics::DetectSphereCapsuleCollision(GetWorldSphere(manifold.transformB),
+            capsuleCollider->GetWorldCapsule(manifold.transformA), collisionInfo))
+        {
+            manifold.isColliding = false;
+            return;
+        }
+
+        SetPrimitiveCollisionResult(collisionInfo, false, manifold);
+    }
+
+    void SphereCollider::UpdateTransformedTightBoundingVolume(const math::mat4& transform)
+    {
+        const world_sphere sphere = GetWorldSphere(transform);
+        minMaxWorldAABB = std::make_pair(sphere.center - math::vec3(sphere.radius), sphere.center + math::vec3(sphere.radius));
+    }
+
+    bool SphereCollider::Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal) const
+    {
+        return PhysicsStatics::RaycastSphere(GetWorldSphere(transform), origin, direction, maxDistance, outDistance, outNormal);
+    }
+
+    void SphereCollider::DrawColliderRepresentation(const math::mat4& transform, math::color usedColor, float width, float time, bool ignoreDepth)
+    {
+        if (!shouldBeDrawn) { return; }
+
+        const world_sphere sphere = GetWorldSphere(transform);
+        const math::vec3 right = math::normalize(math::vec3(transform[0]));
+        const math::vec3 up = math::normalize(math::vec3(transform[1]));
+        const math::vec3 forward = math::normalize(math::vec3(transform[2]));
+
+        DrawCircle(sphere.center, right, up, sphere.radius, usedColor, width, time, ignoreDepth);
+        DrawCircle(sphere.center, up, forward, sphere.radius, usedColor, width, time, ignoreDepth);
+        DrawCircle(sphere.center, forward, right, sphere.radius, usedColor, width, time, ignoreDepth);
+    }
+}
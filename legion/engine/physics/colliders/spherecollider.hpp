@@ -0,0 +1,97 @@
+#pragma once
+
+#include <core/core.hpp>
+#include <physics/colliders/physicscollider.hpp>
+#include <physics/data/convex_convergance_identifier.hpp>
+#include <physics/data/collider_pair_cache.hpp>
+#include <physics/data/primitive_shapes.hpp>
+
+namespace legion::physics
+{
+    /**@class SphereCollider
+     * @brief A sphere with a radius around a local offset. Collisions are detected with closed form tests.
+     * @note The radius is scaled by the largest scale of the transform of the entity.
+     */
+    class SphereCollider : public PhysicsCollider
+    {
+    public:
+
+        SphereCollider(float pRadius = 1.0f, const math::vec3& offset = math::vec3(0.0f)) : radius(pRadius)
+        {
+            localColliderCentroid = offset;
+            UpdateLocalAABB();
+        }
+
+        /** @brief Given a physics_contact that has been resolved, stores its lambdas so they can be matched by position
+        */
+        void AddConverganceIdentifier(const physics_contact& contact, collider_pair_cache& pairCache) override
+        {
+            math::vec3 localRefContact = math::inverse(contact.refTransform) * math::vec4(contact.RefWorldContact, 1);
+
+            pairCache.converganceIdentifiers.push_back(
+                std::make_unique<ConvexConverganceIdentifier>(contact.label, contact.totalLambda,
+                    contact.tangent1Lambda, contact.tangent2Lambda, GetColliderID(), localRefContact));
+        }
+
+        void CheckCollision(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
+        {
+            physicsCollider->CheckCollisionWith(this, manifold);
+        }
+
+        void CheckCollisionWith(ConvexCollider* convexCollider, physics_manifold& manifold) override;
+
+        void CheckCollisionWith(BoxCollider* boxCollider, physics_manifold& manifold) override;
+
+        void CheckCollisionWith(SphereCollider* sphereCollider, physics_manifold& manifold) override;
+
+        void CheckCollisionWith(CapsuleCollider* capsuleCollider, physics_manifold& manifold) override;
+
+        void PopulateContactPoints(PhysicsCollider* physicsCollider, physics_manifold& manifold) override
+        {
+            PopulateContactPointsFromPenetrationQuery(manifold);
+        }
+
+        void PopulateContactPointsWith(ConvexCollider* convexCollider, physics_manifold& manifold) override
+        {
+            PopulateContactPointsFromPenetrationQuery(manifold);
+        }
+
+        void UpdateTransformedTightBoundingVolume(const math::mat4& transform) override;
+
+        bool Raycast(const math::mat4& transform, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal) const override;
+
+        math::vec3 GetWorldSupportPoint(const math::mat4& transform, const math::vec3& direction) const override
+        {
+            return transform * math::vec4(localColliderCentroid, 1);
+        }
+
+        float GetWorldRadius(const math::mat4& transform) const override
+        {
+            return radius * getMaximumScale(transform);
+        }
+
+        void UpdateLocalAABB() override
+        {
+            minMaxLocalAABB = std::make_pair(localColliderCentroid - math::vec3(radius), localColliderCentroid + math::vec3(radius));
+        }
+
+        void DrawColliderRepresentation(const math::mat4& transform, math::color usedColor, float width, float time, bool ignoreDepth = false) override;
+
+        /**@brief Gets the sphere in world space.
+         */
+        L_NODISCARD world_sphere GetWorldSphere(const math::mat4& transform) const
+        {
+            return world_sphere{ transform * math::vec4(localColliderCentroid, 1), radius * getMaximumScale(transform) };
+        }
+
+        L_NODISCARD float GetRadius() const noexcept
+        {
+            return radius;
+        }
+
+    private:
+
+        float radius;
+    };
+}
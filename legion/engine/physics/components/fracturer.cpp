@@ -8,6 +8,85 @@
 namespace legion::physics
 {
     ecs::EcsRegistry* Fracturer::registry = nullptr;
+    scheduling::Scheduler* Fracturer::scheduler = nullptr;
+
+    async::spinlock Fracturer::fractureLock;
+    std::unordered_map<id_type, std::shared_ptr<fracture_pattern>> Fracturer::fracturePatterns;
+    std::vector<fracture_request> Fracturer::pendingFractures;
+    size_type Fracturer::fragmentMeshCount = 0;
+
+    namespace
+    {
+        //everything the jobs that build a pattern need, copied out of the ECS before the jobs are queued
+        struct fracture_build
+        {
+            std::vector<fracture_source> sources;
+            std::vector<std::vector<math::vec3>> cellPoints;
+
+            //copying the polygons of a MeshSplitter marks the polygons it copies from, so only one job can copy at a time
+            async::spinlock copyLock;
+        };
+
+        void buildFractureCell(fracture_pattern& pattern, fracture_build& build, size_type cellIndex)
+        {
+            OPTICK_EVENT();
+
+            //the faces of the voronoi cell are the splitting planes
+            ConvexCollider cellCollider;
+            cellCollider.ConstructConvexHullWithVertices(build.cellPoints[cellIndex]);
+
+            std::vector<MeshSplitParams> splittingParams;
+            for (const auto& face : cellCollider.GetConvexHull().getFaces())
+            {
+                splittingParams.emplace_back(face.centroid, face.normal);
+            }
+
+            std::vector<fracture_fragment>& fragments = pattern.cellFragments[cellIndex];
+
+            for (size_type sourceIndex = 0; sourceIndex < build.sources.size(); sourceIndex++)
+            {
+                fracture_source& source = build.sources[sourceIndex];
+
+                std::vector<SplittablePolygonPtr> polygons;
+                {
+                    std::lock_guard guard(build.copyLock);
+                    source.splitter.CopyPolygons(source.splitter.meshPolygons, polygons);
+                }
+
+                std::vector<std::vector<SplittablePolygonPtr>> islands;
+                source.splitter.SplitMeshIntoIslands(polygons, splittingParams, source.transform, islands);
+
+                for (auto& island : islands)
+                {
+                    fracture_fragment fragment;
+                    fragment.pairingIndex = sourceIndex;
+
+                    math::vec3 offset;
+                    PrimitiveMesh primitiveMesh(island);
+                    fragment.fragmentMesh = primitiveMesh.CreateMesh(source.transform, source.scale, offset);
+
+                    //the offset is already rotated by the transform of the source
+                    fragment.localPosition = source.position + offset;
+                    fragment.localRotation = source.rotation;
+
+                    ConvexCollider fragmentCollider;
+                    std::vector<math::vec3> hullVertices = fragment.fragmentMesh.vertices;
+                    fragmentCollider.ConstructConvexHullWithVertices(hullVertices);
+                    fragment.convexHull = fragmentCollider.GetSharedConvexHull();
+
+                    if (fragment.convexHull->empty())
+                    {
+                        log::warn("Skipped a fracture fragment without a hull");
+                        continue;
+                    }
+
+                    fragments.push_back(std::move(fragment));
+                }
+            }
+
+            pattern.cellsRemaining.fetch_sub(1, std::memory_order_release);
+        }
+    }
 
     void Fracturer::HandleFracture(physics_manifold& manifold, bool& manifoldValid,bool isfracturingA)
     {
@@ -30,271 +109,338 @@ namespace legion::physics
 
     void Fracturer::ExplodeEntity(ecs::entity_handle ownerEntity, const FractureParams& fractureParams, PhysicsCollider* entityCollider)
     {
+        OPTICK_EVENT();
         log::debug("------------------------------------- ExplodeEntity ---------------------------------------");
 
-        if (!entityCollider)
-        {
-            log::debug("colliders size {} "
-                , ownerEntity.read_component<physicsComponent>().colliders.size());
+        auto pattern = PrecomputeFracture(ownerEntity, entityCollider);
 
-            auto physicsComp = ownerEntity.get_component_handle<physicsComponent>().read();
-            entityCollider = physicsComp.colliders.at(0).get();
+        if (!pattern) { return; }
 
-        }
-        
-        //ownerEntity.read_component<physicsComponent>().colliders.at(0)
-        auto [min, max] = entityCollider->GetMinMaxWorldAABB();
+        fracture_request request{ ownerEntity, fractureParams, pattern };
 
-        //-----------------------------------------------------------------------------------------------------------------------------//
-                                //Generate a Voronoi Diagram, for now, the points are manually generated //
-        //-----------------------------------------------------------------------------------------------------------------------------//
+        std::vector<FracturerColliderToMeshPairing> colliderToMeshPairings;
+        CollectColliderMeshPairings(ownerEntity, colliderToMeshPairings);
 
-        std::vector<math::vec3> voronoiPoints;
+        for (auto& pairing : colliderToMeshPairings)
+        {
+            request.materials.push_back(pairing.meshSplitterPairing.read().ownerMaterialH);
+        }
 
-        QuadrantVoronoi(min, max, voronoiPoints);
+        if (QueueFracture(std::move(request)))
+        {
+            fractureCount++;
+        }
+    }
 
-        //math::vec3 six = third + math::vec3(-0.2f, 0.0f, -0.0f);
-        //voronoiPoints.push_back(six);
+    bool Fracturer::QueueFracture(fracture_request request)
+    {
+        std::lock_guard guard(fractureLock);
 
-        for (auto point : voronoiPoints)
-        {/*
-            debug::drawLine(point,
-                point + math::vec3(0, 0.1f, 0), math::colors::magenta, 8.0f, FLT_MAX, true);*/
+        //the entity stays alive until its pattern is done, so it can be requested more than once
+        for (auto& pendingRequest : pendingFractures)
+        {
+            if (pendingRequest.ownerEntity == request.ownerEntity) { return false; }
         }
 
-        std::vector<std::vector<math::vec3>> groupedPoints(voronoiPoints.size());
+        pendingFractures.push_back(std::move(request));
+        return true;
+    }
 
-        GetVoronoiPoints(groupedPoints,
-            voronoiPoints, min, max);
+    size_type Fracturer::PendingFractureCount()
+    {
+        std::lock_guard guard(fractureLock);
+        return pendingFractures.size();
+    }
 
-        //-----------------------------------------------------------------------------------------------------------------------------//
-                                //Using the voronoi points, generate a set of colliders  //
-        //-----------------------------------------------------------------------------------------------------------------------------//
+    std::shared_ptr<fracture_pattern> Fracturer::PrecomputeFracture(ecs::entity_handle ownerEntity, PhysicsCollider* entityCollider)
+    {
+        OPTICK_EVENT();
 
-        std::vector<std::shared_ptr<ConvexCollider>> voronoiColliders;
+        std::vector<FracturerColliderToMeshPairing> colliderToMeshPairings;
+        CollectColliderMeshPairings(ownerEntity, colliderToMeshPairings);
 
-        InstantiateVoronoiColliders(voronoiColliders, groupedPoints);
+        if (colliderToMeshPairings.empty())
+        {
+            log::warn("Entity {} has no MeshSplitter to fracture", ownerEntity.get_id());
+            return nullptr;
+        }
 
-        std::vector< FracturerColliderToMeshPairing> colliderToMeshPairings;
+        if (!entityCollider)
+        {
+            auto physicsComp = ownerEntity.get_component_handle<physicsComponent>().read();
+            entityCollider = physicsComp.colliders.at(0).get();
+        }
 
         //-----------------------------------------------------------------------------------------------------------------------------//
-                                //From the mesh about to be fractured, get the pairs of colliders to Mesh  //
+                    //The pattern is relative to the position and rotation of the owner, so it can be reused wherever the owner is //
         //-----------------------------------------------------------------------------------------------------------------------------//
 
-        InstantiateColliderMeshPairingWithEntity(ownerEntity,
-            colliderToMeshPairings);
+        auto [ownerPosH, ownerRotH, ownerScaleH] = ownerEntity.get_component_handles<transform>();
+        const math::vec3 ownerPosition = ownerPosH.read();
+        const math::quat inverseOwnerRotation = math::inverse(static_cast<math::quat>(ownerRotH.read()));
+        const math::vec3 ownerScale = ownerScaleH.read();
 
-        for (size_t i = 0; i < ownerEntity.child_count(); i++)
+        std::vector<fracture_source> sources;
+        size_type patternKey = 0;
+        std::hash<float> floatHasher;
+
+        for (auto& pairing : colliderToMeshPairings)
         {
-            auto child = ownerEntity.get_child(i);
+            auto ent = pairing.meshSplitterPairing.entity;
+            auto [posH, rotH, scaleH] = ent.get_component_handles<transform>();
 
-            InstantiateColliderMeshPairingWithEntity(child,
-                colliderToMeshPairings);
-        }
+            fracture_source& source = sources.emplace_back();
 
-        std::vector<ecs::entity_handle> entitiesGenerated;
+            if (ent != ownerEntity)
+            {
+                source.position = inverseOwnerRotation * (posH.read() - ownerPosition);
+                source.rotation = inverseOwnerRotation * static_cast<math::quat>(rotH.read());
+            }
 
-        //-----------------------------------------------------------------------------------------------------------------------------//
-                                //From the mesh about to be fractured, get the pairs of colliders to Mesh  //
-        //-----------------------------------------------------------------------------------------------------------------------------//
+            source.scale = scaleH.read();
+            source.transform = math::compose(source.scale, source.rotation, source.position);
 
-        GenerateFractureFragments(entitiesGenerated, colliderToMeshPairings,
-            voronoiColliders, ownerEntity);
+            //entities with the same meshes at the same relative transforms share a pattern
+            auto meshFilterH = ent.get_component_handle<mesh_filter>();
+            math::detail::hash_combine(patternKey, std::hash<id_type>{}(meshFilterH ? meshFilterH.read().id : invalid_id));
 
+            const float* transformValues = math::value_ptr(source.transform);
+            for (size_type i = 0; i < 16; i++)
+            {
+                math::detail::hash_combine(patternKey, floatHasher(transformValues[i]));
+            }
+        }
 
-        auto originalRB = ownerEntity.get_component_handle<rigidbody>().read();
-        float fragmentMass = 1.0f / originalRB.inverseMass;
-        fragmentMass /= entitiesGenerated.size();
+        //the voronoi cells are generated in the bounds of the collider, scaled like the owner but not moved or rotated
+        auto [localMin, localMax] = entityCollider->GetMinMaxLocalAABB();
+        math::vec3 min = math::min(localMin * ownerScale, localMax * ownerScale);
+        math::vec3 max = math::max(localMin * ownerScale, localMax * ownerScale);
 
-        int colliderIter = 0;
-        for (auto ent : entitiesGenerated)
+        for (size_type i = 0; i < 3; i++)
         {
-            auto [posH, rotH, scaleH] = ent.get_component_handles<transform>();
-            math::mat4 trans = math::compose(scaleH.read(), rotH.read(), posH.read());
-            //generate hull
-            auto physicsCompHandle = ent.add_component<physicsComponent>();
-            auto physicsComp = physicsCompHandle.read();
-            auto meshFilter = ent.read_component<mesh_filter>();
-            auto convexCollider = physicsComp.ConstructConvexHull(meshFilter);
-            physicsCompHandle.write(physicsComp);
-
-            //add rigidbody 
-            auto posHandle = ent.get_component_handle<position>();
-            auto rbH = ent.add_component<rigidbody>();
-            auto fragmentRB = rbH.read();
-            fragmentRB.globalCentreOfMass = posH.read();
-
-            //add force based on distance from explosion point
-            math::vec3 distanceFromCentroid = posH.read() - fractureParams.explosionCentroid ;
-            math::vec3 forceDir = math::normalize(distanceFromCentroid);
-            float forceAmount = (1.0f / (math::length(distanceFromCentroid))) * fractureParams.strength;
-
-            //crude estimation of explosion point
-            float smallestDot = std::numeric_limits<float>::max();
-            HalfEdgeFace* chosenFace = nullptr;
-
-            for (auto face : convexCollider->GetHalfEdgeFaces())
-            {
-                float currentDot = math::dot(forceDir, face->normal);
-
-                if (currentDot < smallestDot)
-                {
-                    smallestDot = currentDot;
-                    chosenFace = face;
-                }
-            }
+            math::detail::hash_combine(patternKey, floatHasher(min[i]));
+            math::detail::hash_combine(patternKey, floatHasher(max[i]));
+        }
 
-            math::vec3 explosionPoint = trans * math::vec4(chosenFace->centroid, 1);
+        if (auto pattern = FindFracturePattern(patternKey))
+        {
+            return pattern;
+        }
 
-            fragmentRB.addForceAt(explosionPoint,forceDir * forceAmount);
-            rbH.write(fragmentRB);
-           
-            colliderIter++;
+        for (size_type i = 0; i < sources.size(); i++)
+        {
+            //the jobs split a copy of the polygons, so the MeshSplitter can still be used while the pattern is built
+            auto splitter = colliderToMeshPairings[i].meshSplitterPairing.read();
+            splitter.CopyPolygons(splitter.meshPolygons, sources[i].splitter.meshPolygons);
         }
 
-        registry->destroyEntity(ownerEntity );
+        //-----------------------------------------------------------------------------------------------------------------------------//
+                                //Generate a Voronoi Diagram, for now, the points are manually generated //
+        //-----------------------------------------------------------------------------------------------------------------------------//
+
+        std::vector<math::vec3> voronoiPoints;
+        QuadrantVoronoi(min, max, voronoiPoints);
 
+        std::vector<std::vector<math::vec3>> cellPoints(voronoiPoints.size());
+        GetVoronoiPoints(cellPoints, voronoiPoints, min, max);
 
-        fractureCount++;
+        return BuildFracturePattern(patternKey, std::move(sources), std::move(cellPoints));
     }
 
+    std::shared_ptr<fracture_pattern> Fracturer::FindFracturePattern(size_type patternKey)
+    {
+        std::lock_guard guard(fractureLock);
 
-    void Fracturer::GetVoronoiPoints(std::vector<std::vector<math::vec3>>& groupedPoints,
-        std::vector<math::vec3>& voronoiPoints,math::vec3 min,math::vec3 max)
+        auto found = fracturePatterns.find(patternKey);
+        return found != fracturePatterns.end() ? found->second : nullptr;
+    }
+
+    std::shared_ptr<fracture_pattern> Fracturer::BuildFracturePattern(size_type patternKey,
+        std::vector<fracture_source> sources, std::vector<std::vector<math::vec3>> cellPoints)
     {
-        time::timer tick;
+        OPTICK_EVENT();
 
-        auto vectorList = PhysicsStatics::GenerateVoronoi(voronoiPoints, min.x, max.x, min.y, max.y, min.z, max.z, 1, 1, 1);
+        //-----------------------------------------------------------------------------------------------------------------------------//
+                                //Split the meshes with every voronoi cell in the background //
+        //-----------------------------------------------------------------------------------------------------------------------------//
 
-        vectorList.pop_back();
+        auto build = std::make_shared<fracture_build>();
+        build->sources = std::move(sources);
+        build->cellPoints = std::move(cellPoints);
 
-        //groupedPoints.reserve( voronoiPoints.size() );
+        const size_type cellCount = build->cellPoints.size();
+
+        auto pattern = std::make_shared<fracture_pattern>();
+        pattern->cellFragments.resize(cellCount);
+        pattern->cellsRemaining.store(cellCount, std::memory_order_release);
 
-        for (std::vector<math::vec4>& vector : vectorList)
         {
-            for (const math::vec4& position : vector)
+            //another thread can have built the same pattern in the meantime, its pattern is used instead
+            std::lock_guard guard(fractureLock);
+            auto [iter, inserted] = fracturePatterns.emplace(patternKey, pattern);
+            if (!inserted)
             {
-                int id = position.w;
-
-                //log::debug("position {} id {} ",math::to_string(math::vec3(position)), id);
-                groupedPoints.at(id).push_back(position);
+                return iter->second;
+            }
+        }
 
+        for (size_type cellIndex = 0; cellIndex < cellCount; cellIndex++)
+        {
+            if (scheduler)
+            {
+                //every cell gets its own job pool, a worker thread holds on to the job queue until its pool is done,
+                //so one pool for the whole pattern would keep the physics jobs waiting for the entire split
+                scheduler->queueJobs(1, [pattern, build, cellIndex]()
+                    {
+                        buildFractureCell(*pattern, *build, cellIndex);
+                    });
+            }
+            else
+            {
+                buildFractureCell(*pattern, *build, cellIndex);
             }
         }
 
+        return pattern;
     }
 
-    void Fracturer::InstantiateVoronoiColliders(std::vector<std::shared_ptr<ConvexCollider>>& voronoiColliders
-        ,std::vector<std::vector<math::vec3>>& groupedPoints)
+    void Fracturer::CommitPendingFractures()
     {
-        time::timer tick;
-        int i = 1;
+        OPTICK_EVENT();
 
-        for (std::vector<math::vec3>& vector : groupedPoints)
-        {
-            //// if (i != 1) { continue; }
-            //math::color debugColor =
-            //    math::color(math::linearRand(0.0f, 0.3f), math::linearRand(0.0f, 0.3f), math::linearRand(0.0f, 0.3f));
-            //// i * 2.0f, 0, 0
-            math::vec3 debugOffset = math::vec3();
-            //math::mat4 transform =
-            //    math::compose(math::vec3(1.0f), math::identity<math::quat>(), debugOffset);
-
-            for (math::vec3 vertex : vector)
-            {
-                //
-                math::vec3 vertPos = vertex + debugOffset;
-                //debug::user_projectDrawLine(vertPos, vertPos + math::vec3(0,0.5,0), debugColor,10.0f,FLT_MAX);
-            }
+        std::vector<fracture_request> readyFractures;
 
-            auto newCollider = std::make_shared<ConvexCollider>();
+        {
+            std::lock_guard guard(fractureLock);
 
-            debugVectorcolliders.push_back(newCollider);
-            voronoiColliders.push_back(newCollider);
+            if (pendingFractures.empty()) { return; }
 
-            verticesList.push_back(vector);
+            auto firstReady = std::stable_partition(pendingFractures.begin(), pendingFractures.end(),
+                [](const fracture_request& request) { return !request.pattern->isReady(); });
 
-            newCollider->ConstructConvexHullWithVertices(vector);
+            readyFractures.assign(std::make_move_iterator(firstReady), std::make_move_iterator(pendingFractures.end()));
+            pendingFractures.erase(firstReady, pendingFractures.end());
+        }
 
+        for (auto& request : readyFractures)
+        {
+            //the entity can be destroyed while it waits for its pattern
+            if (!request.ownerEntity.valid()) { continue; }
 
-            //transforms.push_back(transform);
-            //newCollider->DrawColliderRepresentation(transform,math::colors::green,6.0f,FLT_MAX);
-            i++;
+            InstantiateFragments(request);
         }
     }
 
-    void Fracturer::GenerateFractureFragments(std::vector<ecs::entity_handle>& entitiesGenerated
-        , std::vector< FracturerColliderToMeshPairing>& colliderToMeshPairings
-        ,std::vector< std::shared_ptr<ConvexCollider>>& voronoiColliders
-        ,ecs::entity_handle fracturedEnt)
+    void Fracturer::InstantiateFragments(fracture_request& request)
     {
-        
-        fast_time totalMeshSplitting = 0;
+        OPTICK_EVENT();
 
-        fast_time totalCollisionDetection = 0;
+        fracture_pattern& pattern = *request.pattern;
+        const FractureParams& fractureParams = request.fractureParams;
 
-        int fractureID = 0;
-        //for each instantiated convex collider
-        for (std::shared_ptr<ConvexCollider> instantiatedVoronoiCollider : voronoiColliders)
+        //jobs can not write to the MeshCache, so the meshes are added when the pattern is first used
+        if (!pattern.isRegistered)
         {
-            for (auto& meshToColliderPairing : colliderToMeshPairings)
+            for (auto& fragments : pattern.cellFragments)
             {
-                //check if it collides with one of the colliders in the original physics component
-                physics_manifold manifold;
-                ConvexConvexCollisionInfo collisionInfo;
+                for (auto& fragment : fragments)
+                {
+                    fragment.meshHandle = core::MeshCache::create_mesh("fractureMesh" + std::to_string(fragmentMeshCount++), fragment.fragmentMesh);
+                    rendering::ModelCache::create_model(fragment.meshHandle);
+                    fragment.fragmentMesh = mesh();
+                }
+            }
 
+            pattern.isRegistered = true;
+        }
 
-                auto ownerEntity = meshToColliderPairing.meshSplitterPairing.
-                    entity;
-                auto [posH, rotH, scaleH] = ownerEntity.get_component_handles<transform>();
+        auto [ownerPosH, ownerRotH, ownerScaleH] = request.ownerEntity.get_component_handles<transform>();
+        const math::vec3 ownerPosition = ownerPosH.read();
+        const math::quat ownerRotation = ownerRotH.read();
 
-                auto transformB = math::compose(scaleH.read(), rotH.read(), posH.read());
+        for (auto& fragments : pattern.cellFragments)
+        {
+            for (auto& fragment : fragments)
+            {
+                auto ent = registry->createEntity();
 
-                time::timer convexConvexCollision;
- /*               PhysicsStatics::DetectConvexConvexCollision(instantiatedVoronoiCollider.get()
-                    , meshToColliderPairing.colliderPair.get(), math::mat4(1.0f), transformB, collisionInfo, manifold);*/
-                manifold.isColliding = true;
-                totalCollisionDetection += convexConvexCollision.elapsedTime().milliseconds();
+                const rendering::material_handle material = fragment.pairingIndex < request.materials.size() ?
+                    request.materials[fragment.pairingIndex] : request.materials.front();
 
-                if (manifold.isColliding)
-                {
-                    if (fractureID < 999) //2
-                    {
-                        //log::debug("-> Collision Found");
+                ent.add_components<rendering::mesh_renderable>(mesh_filter(fragment.meshHandle), rendering::mesh_renderer(material));
 
-                        std::vector<MeshSplitParams> splittingParams;
-                        meshToColliderPairing.GenerateSplittingParamsFromCollider(instantiatedVoronoiCollider, splittingParams);
-                        //log::debug("splittingParams {} ", splittingParams.size());
+                const math::vec3 fragmentPosition = ownerPosition + ownerRotation * fragment.localPosition;
+                const math::quat fragmentRotation = ownerRotation * fragment.localRotation;
 
-                        for (size_t i = 0; i < splittingParams.size(); i++)
-                        {
-                            float interpolant = (float)i / splittingParams.size();
+                auto [posH, rotH, scaleH] = registry->createComponents<transform>(ent);
+                posH.write(fragmentPosition);
+                rotH.write(fragmentRotation);
 
-                            math::vec3 color = math::color(1, 0, 0) * interpolant;
+                //the hull is shared by every fragment created from this pattern
+                auto physicsCompHandle = ent.add_component<physicsComponent>();
+                auto physicsComp = physicsCompHandle.read();
+                physicsComp.AddConvexHull(fragment.convexHull);
+                physicsCompHandle.write(physicsComp);
 
-                            /*debug::user_projectDrawLine(splittingParams.at(i).planePostion
-                                , splittingParams.at(i).planePostion + splittingParams.at(i).planeNormal,
-                                math::color(color.x, color.y, color.z, 1), 15.0f, FLT_MAX, true);*/
-                        }
+                //add rigidbody 
+                auto rbH = ent.add_component<rigidbody>();
+                auto fragmentRB = rbH.read();
+                fragmentRB.globalCentreOfMass = fragmentPosition;
 
-                        auto splitter = meshToColliderPairing.meshSplitterPairing.read();
-                        time::timer meshSplitting;
-                        splitter.MultipleSplitMesh(splittingParams, entitiesGenerated, true, -1);
-                        totalMeshSplitting += meshSplitting.elapsedTime().milliseconds();
+                //add force based on distance from explosion point
+                math::vec3 distanceFromCentroid = fragmentPosition - fractureParams.explosionCentroid;
+                math::vec3 forceDir = math::normalize(distanceFromCentroid);
+                float forceAmount = (1.0f / (math::length(distanceFromCentroid))) * fractureParams.strength;
 
-                        meshToColliderPairing.meshSplitterPairing.write(splitter);
+                //crude estimation of explosion point
+                float smallestDot = std::numeric_limits<float>::max();
+                const ConvexHull::hull_face* chosenFace = nullptr;
 
-                    }
+                for (const auto& face : fragment.convexHull->getFaces())
+                {
+                    float currentDot = math::dot(forceDir, face.normal);
 
+                    if (currentDot < smallestDot)
+                    {
+                        smallestDot = currentDot;
+                        chosenFace = &face;
+                    }
                 }
-                fractureID++;
 
+                const math::mat4 trans = math::compose(math::vec3(1.0f), fragmentRotation, fragmentPosition);
+                math::vec3 explosionPoint = trans * math::vec4(chosenFace->centroid, 1);
+
+                fragmentRB.addForceAt(explosionPoint, forceDir * forceAmount);
+                rbH.write(fragmentRB);
             }
         }
 
-        registry->destroyEntity(fracturedEnt);
+        registry->destroyEntity(request.ownerEntity);
+    }
+
+    void Fracturer::GetVoronoiPoints(std::vector<std::vector<math::vec3>>& groupedPoints,
+        std::vector<math::vec3>& voronoiPoints,math::vec3 min,math::vec3 max)
+    {
+        time::timer tick;
+
+        auto vectorList = PhysicsStatics::GenerateVoronoi(voronoiPoints, min.x, max.x, min.y, max.y, min.z, max.z, 1, 1, 1);
+
+        vectorList.pop_back();
+
+        //groupedPoints.reserve( voronoiPoints.size() );
+
+        for (std::vector<math::vec4>& vector : vectorList)
+        {
+            for (const math::vec4& position : vector)
+            {
+                int id = position.w;
+
+                //log::debug("position {} id {} ",math::to_string(math::vec3(position)), id);
+                groupedPoints.at(id).push_back(position);
+
+            }
+        }
 
-       
     }
 
     void Fracturer::QuadrantVoronoi(math::vec3& min,math::vec3& max, std::vector<math::vec3>& voronoiPoints)
@@ -378,6 +524,17 @@ namespace legion::physics
         if (!meshFilterHandle || !physicsComponentHandle) { return; }
     }
 
+    void Fracturer::CollectColliderMeshPairings(ecs::entity_handle ownerEntity,
+        std::vector<FracturerColliderToMeshPairing>& colliderToMeshPairings)
+    {
+        InstantiateColliderMeshPairingWithEntity(ownerEntity, colliderToMeshPairings);
+
+        for (size_t i = 0; i < ownerEntity.child_count(); i++)
+        {
+            InstantiateColliderMeshPairingWithEntity(ownerEntity.get_child(i), colliderToMeshPairings);
+        }
+    }
+
     void Fracturer::InstantiateColliderMeshPairingWithEntity(ecs::entity_handle ent,
         std::vector<FracturerColliderToMeshPairing>& colliderToMeshPairings)
     {
@@ -421,19 +578,4 @@ namespace legion::physics
         impactPoint *= mult;
         return impactPoint;
     }
-
-    void FracturerColliderToMeshPairing::GenerateSplittingParamsFromCollider(std::shared_ptr<ConvexCollider> instantiatedCollider, std::vector<physics::MeshSplitParams>& meshSplitParams)
-    {
-        int until = 5;//convex bug at 3
-        int count = 0;
-        for (auto face : instantiatedCollider->GetHalfEdgeFaces())
-        {
-            //if (count > until) { continue; }
-            MeshSplitParams splitParam(face->centroid, face->normal);
-            meshSplitParams.push_back(splitParam);
-            count++;
-        }
-
-    }
-
 }
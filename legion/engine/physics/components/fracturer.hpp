@@ -3,10 +3,36 @@
 #include <physics/components/physics_component.hpp>
 #include <physics/mesh_splitter_utils/mesh_splitter.hpp>
 #include <physics/data/fractureparams.hpp>
+#include <physics/data/fracture_pattern.hpp>
 namespace legion::physics
 {
     struct physics_manifold;
 
+    /**@struct fracture_request
+    * @brief An entity that is replaced by its fragments once its fracture pattern is done.
+    */
+    struct fracture_request
+    {
+        ecs::entity_handle ownerEntity;
+        FractureParams fractureParams;
+        std::shared_ptr<fracture_pattern> pattern;
+
+        //the material of every MeshSplitter in the pattern, entities that share a pattern can have different materials
+        std::vector<rendering::material_handle> materials;
+    };
+
+    /**@struct fracture_source
+    * @brief The polygons of a MeshSplitter and the transform they are split with, relative to the fractured entity.
+    */
+    struct fracture_source
+    {
+        MeshSplitter splitter;
+        math::mat4 transform;
+        math::vec3 position = math::vec3(0.0f);
+        math::quat rotation = math::identity<math::quat>();
+        math::vec3 scale = math::vec3(1.0f);
+    };
+
     struct FracturerColliderToMeshPairing
     {
         FracturerColliderToMeshPairing(
@@ -19,11 +45,6 @@ namespace legion::physics
 
         std::shared_ptr<ConvexCollider> colliderPair;
         ecs::component_handle<MeshSplitter> meshSplitterPairing;
-
-        void GenerateSplittingParamsFromCollider(std::shared_ptr<ConvexCollider> instantiatedCollider
-            , std::vector<physics::MeshSplitParams>& meshSplitParams);
-        
-
     };
 
 	struct Fracturer
@@ -32,8 +53,41 @@ namespace legion::physics
 
 		void HandleFracture(physics_manifold& manifold,bool& manifoldValid, bool isfracturingA);
 
+        /**@brief Requests the entity to be fractured. The entity is replaced by its fragments
+        * in the first CommitPendingFractures after its fracture pattern is done.
+        */
         void ExplodeEntity(ecs::entity_handle ownerEntity,
-            const FractureParams& fractureParams, PhysicsCollider* entityCollider = nullptr);;
+            const FractureParams& fractureParams, PhysicsCollider* entityCollider = nullptr);
+
+        /**@brief Gets the fracture pattern of the entity, if the entity has no pattern yet the meshes of the entity and its children
+        * are split in the background. Call this when the entity is created so that ExplodeEntity does not have to wait for the split.
+        * @param entityCollider The collider whose bounds are divided into voronoi cells, the first collider of the entity if nullptr.
+        */
+        std::shared_ptr<fracture_pattern> PrecomputeFracture(ecs::entity_handle ownerEntity, PhysicsCollider* entityCollider = nullptr);
+
+        /**@brief Replaces every requested entity whose fracture pattern is done by its fragments.
+        * @note Called at the start of the physics step, this is the only place where a fracture writes to the ECS.
+        */
+        static void CommitPendingFractures();
+
+        /**@brief Gets the fracture pattern that was built with the key, nullptr if there is none.
+        */
+        static std::shared_ptr<fracture_pattern> FindFracturePattern(size_type patternKey);
+
+        /**@brief Splits the sources with every voronoi cell in the background and caches the pattern with the key.
+        * If a pattern with the key was already built, that pattern is returned and nothing is split.
+        * @param sources The polygons to split, relative to the fractured entity.
+        * @param cellPoints The points of every voronoi cell, relative to the fractured entity.
+        */
+        static std::shared_ptr<fracture_pattern> BuildFracturePattern(size_type patternKey,
+            std::vector<fracture_source> sources, std::vector<std::vector<math::vec3>> cellPoints);
+
+        /**@brief Adds the request to the fractures that are committed once their pattern is done.
+        * @return False if the owner of the request is already waiting for its pattern.
+        */
+        static bool QueueFracture(fracture_request request);
+
+        L_NODISCARD static size_type PendingFractureCount();
 
         bool IsFractureConditionMet(physics_manifold& manifold, bool isfracturingA);
 
@@ -48,14 +102,6 @@ namespace legion::physics
         void GetVoronoiPoints(std::vector<std::vector<math::vec3>>& groupedPoints,
             std::vector<math::vec3>& voronoiPoints, math::vec3 min, math::vec3 max);
 
-        void InstantiateVoronoiColliders(std::vector<std::shared_ptr<ConvexCollider>>& voronoiColliders
-            , std::vector<std::vector<math::vec3>>& groupedPoints);
-
-        void GenerateFractureFragments(std::vector<ecs::entity_handle>& entitiesGenerated
-            , std::vector< FracturerColliderToMeshPairing>& colliderToMeshPairings
-            , std::vector< std::shared_ptr<ConvexCollider>>& voronoiColliders
-            , ecs::entity_handle fracturedEnt);
-
         void QuadrantVoronoi(math::vec3& min, math::vec3& max, std::vector<math::vec3>& voronoiPoints);
 
         void BalancedVoronoi(math::vec3& min, math::vec3& max, std::vector<math::vec3>& voronoiPoints);
@@ -64,10 +110,24 @@ namespace legion::physics
 
         int fractureCount = 0;
 
-        std::vector<std::vector<math::vec3>> verticesList;
-        std::vector<std::shared_ptr<ConvexCollider>> debugVectorcolliders;
-        std::vector<math::mat4> transforms;
         static ecs::EcsRegistry* registry;
+
+        //when no scheduler is set the fracture patterns are built on the calling thread
+        static scheduling::Scheduler* scheduler;
+
+    private:
+
+        /**@brief Gets the pairs of colliders to meshes of the entity and its children.
+        */
+        void CollectColliderMeshPairings(ecs::entity_handle ownerEntity,
+            std::vector<FracturerColliderToMeshPairing>& colliderToMeshPairings);
+
+        static void InstantiateFragments(fracture_request& request);
+
+        static async::spinlock fractureLock;
+        static std::unordered_map<id_type, std::shared_ptr<fracture_pattern>> fracturePatterns;
+        static std::vector<fracture_request> pendingFractures;
+        static size_type fragmentMeshCount;
 	};
 
    
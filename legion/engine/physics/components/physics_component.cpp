@@ -1,6 +1,9 @@
 
 #include <physics/components/physics_component.hpp>
 #include <physics/colliders/convexcollider.hpp>
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/colliders/capsulecollider.hpp>
 
 namespace legion::physics
 {
@@ -44,18 +47,36 @@ namespace legion::physics
 
     void physicsComponent::AddBox(const cube_collider_params& cubeParams)
     {
-        auto cuboidCollider = std::make_shared<ConvexCollider>();
-
-        cuboidCollider->CreateBox(cubeParams);
+        auto cuboidCollider = std::make_shared<BoxCollider>(cubeParams);
 
         colliders.push_back(cuboidCollider);
 
         calculateNewLocalCenterOfMass();
     }
 
-    void physicsComponent::AddSphere()
+    void physicsComponent::AddSphere(float radius, const math::vec3& offset)
+    {
+        colliders.push_back(std::make_shared<SphereCollider>(radius, offset));
+
+        calculateNewLocalCenterOfMass();
+    }
+
+    void physicsComponent::AddCapsule(float radius, float height, const math::vec3& offset)
+    {
+        colliders.push_back(std::make_shared<CapsuleCollider>(radius, height, offset));
+
+        calculateNewLocalCenterOfMass();
+    }
+
+    std::shared_ptr<ConvexCollider> physicsComponent::AddConvexHull(std::shared_ptr<const ConvexHull> sharedHull)
     {
+        auto collider = std::make_shared<ConvexCollider>(std::move(sharedHull));
+
+        colliders.push_back(collider);
+
         calculateNewLocalCenterOfMass();
+
+        return collider;
     }
 }
 
@@ -6,6 +6,8 @@
 
 namespace legion::physics
 {
+    class ConvexHull;
+
 	struct physicsComponent
 	{
 		//physics material
@@ -36,15 +38,25 @@ namespace legion::physics
         */
 		void ConstructBox(/*mesh*/);
 
-        /** @brief Instantiates a ConvexCollider and calls CreateBox on it and passes the given mesh. This 
-         * ConvexCollider is then added to the list of PhysicsColliders
+        /** @brief Instantiates a BoxCollider with the given parameters. This
+         * BoxCollider is then added to the list of PhysicsColliders
         */
 		void AddBox(const cube_collider_params& cubeParams);
 
-        /** @brief Instantiates a SphereCollider and creates a sphere that encompasses the given mesh. This
-         * ConvexCollider is then added to the list of PhysicsColliders
+        /** @brief Instantiates a SphereCollider with the given radius and local offset. This
+         * SphereCollider is then added to the list of PhysicsColliders
+        */
+		void AddSphere(float radius, const math::vec3& offset = math::vec3(0.0f));
+
+        /** @brief Instantiates a CapsuleCollider along the local y axis with the given radius, segment height and local offset. This
+         * CapsuleCollider is then added to the list of PhysicsColliders
+        */
+		void AddCapsule(float radius, float height, const math::vec3& offset = math::vec3(0.0f));
+
+        /** @brief Instantiates a ConvexCollider that uses the given hull. The hull is shared with every other collider
+         * that uses it instead of being copied. This ConvexCollider is then added to the list of PhysicsColliders
         */
-		void AddSphere(/*mesh*/);
+		std::shared_ptr<ConvexCollider> AddConvexHull(std::shared_ptr<const ConvexHull> sharedHull);
 
 	};
 }
@@ -33,6 +33,10 @@ namespace legion::physics
 
         bool isAsleep;
 
+        //continuous collision detection is done for this body when it moves further than this fraction of its
+        //smallest extent in one physics step, set to std::numeric_limits<float>::max() to disable it
+        float ccdMotionThreshold = 0.5f;
+
         template<typename Archive>
         void serialize(Archive& archive)
         {
@@ -42,7 +46,7 @@ namespace legion::physics
                         cereal::make_nvp("Inverse Intertia Tensor",localInverseInertiaTensor),cereal::make_nvp("Angular Acceleration",angularAcc),
                         cereal::make_nvp("Angular Velocity",angularVelocity),cereal::make_nvp("Angular Drag",angularDrag),cereal::make_nvp("Global Centre of Mass",globalCentreOfMass),
                         cereal::make_nvp("Force Accumulator",forceAccumulator),cereal::make_nvp("Torque Accumulator",torqueAccumulator),cereal::make_nvp("Restitution",restitution),
-                        cereal::make_nvp("Friction",friction),cereal::make_nvp("Is Asleep?",isAsleep));
+                        cereal::make_nvp("Friction",friction),cereal::make_nvp("Is Asleep?",isAsleep),cereal::make_nvp("CCD Motion Threshold",ccdMotionThreshold));
         }
 
         static float calculateRestitution(float restitutionA, float restitutionB)
@@ -0,0 +1,137 @@
+#pragma once
+#include <core/core.hpp>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+namespace legion::physics
+{
+    /**@struct AABBSoA
+     * @brief Structure of arrays list of axis aligned bounding boxes, so that rays can be tested against 4 boxes at a time.
+     */
+    struct AABBSoA
+    {
+        static constexpr size_type width = 4;
+
+        std::vector<float> minX;
+        std::vector<float> minY;
+        std::vector<float> minZ;
+        std::vector<float> maxX;
+        std::vector<float> maxY;
+        std::vector<float> maxZ;
+
+        void resize(size_type count)
+        {
+            minX.resize(count);
+            minY.resize(count);
+            minZ.resize(count);
+            maxX.resize(count);
+            maxY.resize(count);
+            maxZ.resize(count);
+        }
+
+        L_NODISCARD size_type size() const noexcept
+        {
+            return minX.size();
+        }
+
+        void set(size_type index, const std::pair<math::vec3, math::vec3>& aabb)
+        {
+            minX[index] = aabb.first.x;
+            minY[index] = aabb.first.y;
+            minZ[index] = aabb.first.z;
+            maxX[index] = aabb.second.x;
+            maxY[index] = aabb.second.y;
+            maxZ[index] = aabb.second.z;
+        }
+
+        L_NODISCARD std::pair<math::vec3, math::vec3> get(size_type index) const
+        {
+            return std::make_pair(math::vec3(minX[index], minY[index], minZ[index]), math::vec3(maxX[index], maxY[index], maxZ[index]));
+        }
+
+        /**@brief Intersects a ray with the boxes at the given indices using the slab test.
+         * @param direction The normalized direction of the ray.
+         * @param expansion The amount every box is grown by on each side before the test, used for shape casts.
+         * @param outEntries [out] For every index the distance at which the ray enters the box,
+         * or std::numeric_limits<float>::max() if the ray misses the box within maxDistance.
+         */
+        void intersectRay(const math::vec3& origin, const math::vec3& direction, float maxDistance, const math::vec3& expansion,
+            const id_type* indices, size_type count, float* outEntries) const
+        {
+            //axis parallel rays get a huge but finite inverse so that the slabs never produce 0 * inf
+            math::vec3 inverseDirection;
+            for (int i = 0; i < 3; i++)
+            {
+                const float component = math::abs(direction[i]) > 1e-20f ? direction[i] : (direction[i] < 0.0f ? -1e-20f : 1e-20f);
+                inverseDirection[i] = 1.0f / component;
+            }
+
+            const math::vec3 lowOrigin = origin + expansion;
+            const math::vec3 highOrigin = origin - expansion;
+
+            size_type i = 0;
+
+#if defined(LEGION_SSE)
+            const __m128 invX = _mm_set1_ps(inverseDirection.x);
+            const __m128 invY = _mm_set1_ps(inverseDirection.y);
+            const __m128 invZ = _mm_set1_ps(inverseDirection.z);
+            const __m128 lowX = _mm_set1_ps(lowOrigin.x);
+            const __m128 lowY = _mm_set1_ps(lowOrigin.y);
+            const __m128 lowZ = _mm_set1_ps(lowOrigin.z);
+            const __m128 highX = _mm_set1_ps(highOrigin.x);
+            const __m128 highY = _mm_set1_ps(highOrigin.y);
+            const __m128 highZ = _mm_set1_ps(highOrigin.z);
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 maxT = _mm_set1_ps(maxDistance);
+            const __m128 miss = _mm_set1_ps(std::numeric_limits<float>::max());
+
+            for (; i + width <= count; i += width)
+            {
+                const id_type a = indices[i];
+                const id_type b = indices[i + 1];
+                const id_type c = indices[i + 2];
+                const id_type d = indices[i + 3];
+
+                //the candidates are not contiguous, so the lanes are gathered
+                const __m128 x0 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(minX[a], minX[b], minX[c], minX[d]), lowX), invX);
+                const __m128 x1 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(maxX[a], maxX[b], maxX[c], maxX[d]), highX), invX);
+                const __m128 y0 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(minY[a], minY[b], minY[c], minY[d]), lowY), invY);
+                const __m128 y1 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(maxY[a], maxY[b], maxY[c], maxY[d]), highY), invY);
+                const __m128 z0 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(minZ[a], minZ[b], minZ[c], minZ[d]), lowZ), invZ);
+                const __m128 z1 = _mm_mul_ps(_mm_sub_ps(_mm_setr_ps(maxZ[a], maxZ[b], maxZ[c], maxZ[d]), highZ), invZ);
+
+                __m128 entry = _mm_max_ps(_mm_max_ps(_mm_min_ps(x0, x1), _mm_min_ps(y0, y1)), _mm_max_ps(_mm_min_ps(z0, z1), zero));
+                __m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(x0, x1), _mm_max_ps(y0, y1)), _mm_min_ps(_mm_max_ps(z0, z1), maxT));
+
+                const __m128 hit = _mm_cmple_ps(entry, exit);
+                _mm_storeu_ps(outEntries + i, _mm_or_ps(_mm_and_ps(hit, entry), _mm_andnot_ps(hit, miss)));
+            }
+#endif
+            for (; i < count; i++)
+            {
+                const id_type index = indices[i];
+
+                const math::vec3 t0 = (math::vec3(minX[index], minY[index], minZ[index]) - lowOrigin) * inverseDirection;
+                const math::vec3 t1 = (math::vec3(maxX[index], maxY[index], maxZ[index]) - highOrigin) * inverseDirection;
+                const math::vec3 near = math::min(t0, t1);
+                const math::vec3 far = math::max(t0, t1);
+
+                const float entry = math::max(math::max(near.x, near.y), math::max(near.z, 0.0f));
+                const float exit = math::min(math::min(far.x, far.y), math::min(far.z, maxDistance));
+
+                outEntries[i] = entry <= exit ? entry : std::numeric_limits<float>::max();
+            }
+        }
+
+        /**@brief Checks if the box at the given index overlaps the box min-max.
+         */
+        L_NODISCARD bool overlaps(size_type index, const math::vec3& min, const math::vec3& max) const
+        {
+            return minX[index] <= max.x && maxX[index] >= min.x
+                && minY[index] <= max.y && maxY[index] >= min.y
+                && minZ[index] <= max.z && maxZ[index] >= min.z;
+        }
+    };
+}
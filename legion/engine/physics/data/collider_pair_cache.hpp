@@ -0,0 +1,162 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/data/convergance_identifier.hpp>
+#include <physics/physics_contact.hpp>
+#include <physics/colliders/physicscollider.hpp>
+#include <physics/physicsconstants.hpp>
+
+namespace legion::physics
+{
+    /**@brief The kind of feature that defined the result of the seperating axis test of a collider pair.
+     */
+    enum class CachedFeatureType
+    {
+        None,
+        Face,
+        Edge
+    };
+
+    /**@struct cached_feature
+     * @brief Stores a face or an edge pair found by the seperating axis test.
+     * Indices are used instead of pointers so that a rebuilt collider can never leave a dangling feature behind.
+     */
+    struct cached_feature
+    {
+        CachedFeatureType type = CachedFeatureType::None;
+        //the id of the collider that owns the face or the reference edge
+        int colliderID = -1;
+        //index into the faces or the unique edges of the collider with colliderID
+        size_type index = 0;
+        //index into the unique edges of the other collider, only used by edge features
+        size_type incidentIndex = 0;
+
+        L_NODISCARD bool isSet() const noexcept
+        {
+            return type != CachedFeatureType::None;
+        }
+
+        void reset() noexcept
+        {
+            type = CachedFeatureType::None;
+        }
+    };
+
+    /**@struct collider_pair_cache
+     * @brief Narrowphase data of a pair of colliders that persists between physics steps.
+     * @note Created and owned by the PhysicsSystem, a manifold only holds a pointer to the cache of its collider pair.
+     */
+    struct collider_pair_cache
+    {
+        //the feature that seperated the pair in the last step, tested first before running the full seperating axis test
+        cached_feature seperatingFeature;
+
+        //the feature that was used for contact generation in the last step
+        cached_feature penetrationFeature;
+
+        //transform of the collider with the highest id in the space of the collider with the lowest id,
+        //when it barely changed the penetration feature of the last step can be reused
+        math::mat4 relativeTransform = math::mat4(1.0f);
+
+        //the accumulated impulses of the contacts of the last step
+        std::vector<std::unique_ptr<ConverganceIdentifier>> converganceIdentifiers;
+
+        //the physics step this cache was last used in, unused caches are removed at the end of a step
+        size_type lastStep = 0;
+
+        /**@brief Creates the key of the pair of the given colliders, the order of the ids does not matter.
+         */
+        static uint64 makeKey(int colliderIDA, int colliderIDB)
+        {
+            const uint64 low = static_cast<uint32>(math::min(colliderIDA, colliderIDB));
+            const uint64 high = static_cast<uint32>(math::max(colliderIDA, colliderIDB));
+            return (low << 32) | high;
+        }
+
+        /**@brief Checks if the relative transform between the 2 colliders is close enough to the one of the last step
+         * for the penetration feature to still be valid.
+         * @param relative The current transform of the collider with the highest id in the space of the collider with the lowest id.
+         */
+        L_NODISCARD bool isRelativeTransformStable(const math::mat4& relative) const
+        {
+            if (math::length2(math::vec3(relative[3] - relativeTransform[3])) >
+                constants::pairCacheLinearTolerance * constants::pairCacheLinearTolerance)
+            {
+                return false;
+            }
+
+            for (int i = 0; i < 3; i++)
+            {
+                if (math::dot(math::vec3(relative[i]), math::vec3(relativeTransform[i])) < 1.0f - constants::pairCacheAngularTolerance)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**@brief Copies the accumulated impulses of the last step to the given contact if a matching contact is found.
+         * Contacts are matched by their label first, then by their position on the reference collider.
+         * @param contact The contact to warm start, its refTransform and RefWorldContact must be set.
+         * @param used [in/out] Flags of the identifiers that were already matched this step, so that one impulse is never applied twice.
+         */
+        void matchContact(physics_contact& contact, std::vector<byte>& used) const
+        {
+            if (!constants::applyWarmStarting) { return; }
+
+            const int refColliderID = contact.refCollider->GetColliderID();
+            size_type closest = converganceIdentifiers.size();
+
+            //contacts of the primitive collision kernels have no label and can only be matched by position
+            for (size_type i = 0; contact.label.IsSet() && i < converganceIdentifiers.size(); i++)
+            {
+                auto& converganceId = converganceIdentifiers[i];
+                if (used[i] || converganceId->refColliderID != refColliderID) { continue; }
+
+                if (converganceId->IsEqual(contact))
+                {
+                    closest = i;
+                    break;
+                }
+            }
+
+            if (closest == converganceIdentifiers.size())
+            {
+                const math::vec3 localContact = math::inverse(contact.refTransform) * math::vec4(contact.RefWorldContact, 1);
+                float closestDistance2 = constants::contactMatchingTolerance * constants::contactMatchingTolerance;
+
+                for (size_type i = 0; i < converganceIdentifiers.size(); i++)
+                {
+                    auto& converganceId = converganceIdentifiers[i];
+                    if (used[i] || converganceId->refColliderID != refColliderID) { continue; }
+
+                    float distance2 = math::length2(converganceId->localRefContact - localContact);
+                    if (distance2 < closestDistance2)
+                    {
+                        closestDistance2 = distance2;
+                        closest = i;
+                    }
+                }
+            }
+
+            if (closest != converganceIdentifiers.size())
+            {
+                used[closest] = true;
+                converganceIdentifiers[closest]->CopyLambdasToContact(contact);
+            }
+        }
+
+        /**@brief Warm starts all the contacts of a newly created manifold.
+         */
+        void matchContacts(std::vector<physics_contact>& contacts) const
+        {
+            if (!constants::applyWarmStarting || converganceIdentifiers.empty()) { return; }
+
+            std::vector<byte> used(converganceIdentifiers.size(), false);
+            for (auto& contact : contacts)
+            {
+                matchContact(contact, used);
+            }
+        }
+    };
+}
@@ -12,18 +12,22 @@ namespace legion::physics
     public:
 
         ConverganceIdentifier(const EdgeLabel& plabel,float pTotalLambda,
-            float pTangent1Lambda, float pTangent2Lambda,int pRefColliderId)
+            float pTangent1Lambda, float pTangent2Lambda,int pRefColliderId, const math::vec3& pLocalRefContact = math::vec3(0.0f))
             :  totalLambda(pTotalLambda),tangent1Lambda(pTangent1Lambda),
-            tangent2Lambda(pTangent2Lambda),refColliderID(pRefColliderId)
+            tangent2Lambda(pTangent2Lambda),refColliderID(pRefColliderId),localRefContact(pLocalRefContact)
         {
             this->label = plabel;
         }
 
+        virtual ~ConverganceIdentifier() = default;
+
         float totalLambda = 0.0f;
         float tangent1Lambda = 0.0f;
         float tangent2Lambda = 0.0f;
         EdgeLabel label;
         int refColliderID = -1;
+        //the contact point in the local space of the reference collider, used when the labels no longer match
+        math::vec3 localRefContact;
 
         void CopyLambdasToContact(physics_contact& contact)
         {
@@ -9,8 +9,8 @@ namespace legion::physics
     public:
 
         ConvexConverganceIdentifier(const EdgeLabel& label, float pTotalLambda,
-            float pTangent1Lambda, float pTangent2Lambda, int pRefColliderId)
-            : ConverganceIdentifier(label,pTotalLambda, pTangent1Lambda, pTangent2Lambda, pRefColliderId)
+            float pTangent1Lambda, float pTangent2Lambda, int pRefColliderId, const math::vec3& pLocalRefContact)
+            : ConverganceIdentifier(label,pTotalLambda, pTangent1Lambda, pTangent2Lambda, pRefColliderId, pLocalRefContact)
         {
 
         }
@@ -1,8 +1,6 @@
 #pragma once
 #include <core/core.hpp>
-#include <physics/data/pointer_encapsulator.hpp>
-#include <physics/halfedgeedge.hpp>
-#include <physics/halfedgeface.hpp>
+#include <physics/data/convex_hull.hpp>
 
 namespace legion::physics
 {
@@ -12,11 +10,11 @@ namespace legion::physics
 
         float ARefSeperation, BRefSeperation, aToBEdgeSeperation;
 
-        PointerEncapsulator < HalfEdgeFace> ARefFace;
-        PointerEncapsulator < HalfEdgeFace> BRefFace;
+        ConvexHull::feature_index ARefFace = ConvexHull::invalid_index;
+        ConvexHull::feature_index BRefFace = ConvexHull::invalid_index;
 
-        PointerEncapsulator< HalfEdgeEdge> edgeRef;
-        PointerEncapsulator< HalfEdgeEdge> edgeInc;
+        ConvexHull::feature_index edgeRef = ConvexHull::invalid_index;
+        ConvexHull::feature_index edgeInc = ConvexHull::invalid_index;
     };
 
 
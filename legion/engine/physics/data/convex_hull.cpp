@@ -0,0 +1,106 @@
+#include <physics/data/convex_hull.hpp>
+#include <physics/halfedgeedge.hpp>
+#include <physics/halfedgeface.hpp>
+
+namespace legion::physics
+{
+    std::shared_ptr<const ConvexHull> ConvexHull::build(const std::vector<HalfEdgeFace*>& halfEdgeFaces)
+    {
+        OPTICK_EVENT();
+
+        //------------------------ give every half edge an index, the edges of a face get consecutive indices ------------------------//
+
+        std::unordered_map<HalfEdgeEdge*, size_type> edgeIndices;
+        size_type edgeCount = 0;
+
+        for (auto face : halfEdgeFaces)
+        {
+            face->forEachEdge([&edgeIndices, &edgeCount](HalfEdgeEdge* edge)
+                {
+                    edgeIndices.emplace(edge, edgeCount++);
+                });
+        }
+
+        if (edgeCount >= invalid_index)
+        {
+            log::error("ConvexHull has {} half edges, only {} are supported", edgeCount, invalid_index - 1);
+            return getEmpty();
+        }
+
+        //------------------------------------------------ copy the faces and edges ------------------------------------------------//
+
+        auto hull = std::make_shared<ConvexHull>();
+        hull->faces.reserve(halfEdgeFaces.size());
+        hull->edges.resize(edgeCount);
+
+        //the edges only store the position of their vertex, vertices with the same position are merged.
+        //hulls are small enough that a linear search is faster than hashing the positions
+        auto findVertex = [&hull](const math::vec3& position)
+        {
+            for (size_type i = 0; i < hull->vertices.size(); i++)
+            {
+                if (hull->vertices[i] == position) { return static_cast<feature_index>(i); }
+            }
+
+            hull->vertices.push_back(position);
+            return static_cast<feature_index>(hull->vertices.size() - 1);
+        };
+
+        for (size_type faceIndex = 0; faceIndex < halfEdgeFaces.size(); faceIndex++)
+        {
+            HalfEdgeFace* face = halfEdgeFaces[faceIndex];
+
+            hull_face hullFace;
+            hullFace.normal = face->normal;
+            hullFace.centroid = face->centroid;
+            hullFace.firstEdge = static_cast<feature_index>(face->startEdge ? edgeIndices.at(face->startEdge) : 0);
+            hullFace.edgeCount = 0;
+
+            face->forEachEdge([&](HalfEdgeEdge* edge)
+                {
+                    half_edge& hullEdge = hull->edges[edgeIndices.at(edge)];
+                    hullEdge.vertex = findVertex(edge->edgePosition);
+                    hullEdge.next = static_cast<feature_index>(edgeIndices.at(edge->nextEdge));
+                    hullEdge.face = static_cast<feature_index>(faceIndex);
+
+                    auto pairing = edge->pairingEdge ? edgeIndices.find(edge->pairingEdge) : edgeIndices.end();
+                    hullEdge.pairing = pairing != edgeIndices.end() ? static_cast<feature_index>(pairing->second) : invalid_index;
+
+                    hullFace.edgeCount++;
+                });
+
+            hull->faces.push_back(hullFace);
+        }
+
+        //every edge of the hull is made up of 2 half edges, only the one that was found first is needed for the edge check
+        hull->uniqueEdges.reserve(edgeCount / 2);
+        for (size_type i = 0; i < hull->edges.size(); i++)
+        {
+            if (hull->edges[i].pairing == invalid_index || i < hull->edges[i].pairing)
+            {
+                hull->uniqueEdges.push_back(static_cast<feature_index>(i));
+            }
+        }
+
+        hull->vertices.shrink_to_fit();
+        hull->verticesSoA.assign(hull->vertices);
+
+        return hull;
+    }
+
+    const std::shared_ptr<const ConvexHull>& ConvexHull::getEmpty()
+    {
+        static const std::shared_ptr<const ConvexHull> emptyHull = std::make_shared<ConvexHull>();
+        return emptyHull;
+    }
+
+    size_type ConvexHull::getMemoryUsage() const noexcept
+    {
+        return sizeof(ConvexHull)
+            + vertices.capacity() * sizeof(math::vec3)
+            + (verticesSoA.x.capacity() + verticesSoA.y.capacity() + verticesSoA.z.capacity()) * sizeof(float)
+            + faces.capacity() * sizeof(hull_face)
+            + edges.capacity() * sizeof(half_edge)
+            + uniqueEdges.capacity() * sizeof(feature_index);
+    }
+}
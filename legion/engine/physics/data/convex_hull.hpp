@@ -0,0 +1,128 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/data/vertex_soa.hpp>
+#include <physics/data/edge_label.hpp>
+
+namespace legion::physics
+{
+    struct HalfEdgeFace;
+
+    /**@class ConvexHull
+     * @brief An immutable, index based copy of the half edge data structure of a convex hull. It is built once from
+     * the HalfEdgeFaces created by the quickhull of ConvexCollider and only holds flat arrays, so the seperating axis test and
+     * the contact clipping never chase pointers. A hull can be shared by any number of colliders with a std::shared_ptr<const ConvexHull>.
+     * @note The edges of a face are stored next to each other. Faces, edges and vertices are referenced with 16 bit indices,
+     * so a hull can have at most 65535 half edges.
+     */
+    class ConvexHull
+    {
+    public:
+        using feature_index = uint16;
+        static constexpr feature_index invalid_index = std::numeric_limits<feature_index>::max();
+
+        /**@struct hull_face
+         * @brief A face of the hull, its edges are the edges firstEdge up to firstEdge + edgeCount.
+         */
+        struct hull_face
+        {
+            math::vec3 normal;
+            math::vec3 centroid;
+            feature_index firstEdge;
+            feature_index edgeCount;
+        };
+
+        /**@struct half_edge
+         * @brief An edge of a face that goes from its vertex to the vertex of next.
+         * pairing is the half edge of the neighbouring face that goes the other way.
+         */
+        struct half_edge
+        {
+            feature_index vertex;
+            feature_index next;
+            feature_index pairing;
+            feature_index face;
+        };
+
+        /**@brief Builds a hull from the faces of a finished half edge data structure.
+         * The faces of the hull have the same order as the given faces.
+         * @return The hull, or an empty hull if the half edge data structure has too many edges.
+         */
+        static std::shared_ptr<const ConvexHull> build(const std::vector<HalfEdgeFace*>& halfEdgeFaces);
+
+        /**@brief Gets a hull without any faces, used by colliders that have not created a hull yet.
+         */
+        static const std::shared_ptr<const ConvexHull>& getEmpty();
+
+        L_NODISCARD bool empty() const noexcept
+        {
+            return faces.empty();
+        }
+
+        L_NODISCARD const std::vector<math::vec3>& getVertices() const noexcept
+        {
+            return vertices;
+        }
+
+        L_NODISCARD const VertexSoA& getVerticesSoA() const noexcept
+        {
+            return verticesSoA;
+        }
+
+        L_NODISCARD const std::vector<hull_face>& getFaces() const noexcept
+        {
+            return faces;
+        }
+
+        L_NODISCARD const std::vector<half_edge>& getEdges() const noexcept
+        {
+            return edges;
+        }
+
+        /**@brief Gets one half edge of every edge pair in the hull. Its pairing edge is not in the list.
+         */
+        L_NODISCARD const std::vector<feature_index>& getUniqueEdges() const noexcept
+        {
+            return uniqueEdges;
+        }
+
+        L_NODISCARD const math::vec3& getEdgeStart(feature_index edge) const
+        {
+            return vertices[edges[edge].vertex];
+        }
+
+        L_NODISCARD const math::vec3& getEdgeEnd(feature_index edge) const
+        {
+            return vertices[edges[edges[edge].next].vertex];
+        }
+
+        L_NODISCARD math::vec3 getEdgeDirection(feature_index edge) const
+        {
+            return getEdgeEnd(edge) - getEdgeStart(edge);
+        }
+
+        L_NODISCARD const hull_face& getEdgeFace(feature_index edge) const
+        {
+            return faces[edges[edge].face];
+        }
+
+        /**@brief Gets the label of the contacts created on an edge. The label holds the id of the collider
+         * so that the labels of 2 colliders that share a hull are never equal.
+         */
+        L_NODISCARD EdgeLabel getEdgeLabel(feature_index edge, int colliderID) const
+        {
+            return EdgeLabel(std::make_pair(colliderID, static_cast<int>(edge)),
+                std::make_pair(colliderID, static_cast<int>(edges[edge].next)));
+        }
+
+        /**@brief Gets the number of bytes that the hull uses, including its arrays.
+         */
+        L_NODISCARD size_type getMemoryUsage() const noexcept;
+
+    private:
+        std::vector<math::vec3> vertices;
+        VertexSoA verticesSoA;
+        std::vector<hull_face> faces;
+        std::vector<half_edge> edges;
+        std::vector<feature_index> uniqueEdges;
+    };
+}
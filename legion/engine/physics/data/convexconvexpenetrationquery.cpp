@@ -6,9 +6,11 @@
 
 namespace legion::physics
 {
-    ConvexConvexPenetrationQuery::ConvexConvexPenetrationQuery(HalfEdgeFace* pRefFace, HalfEdgeFace* pIncFace,
+    ConvexConvexPenetrationQuery::ConvexConvexPenetrationQuery(const ConvexHull* pRefHull, ConvexHull::feature_index pRefFace,
+        const ConvexHull* pIncHull, ConvexHull::feature_index pIncFace,
         math::vec3& pFaceCentroid, math::vec3& pNormal, float pPenetration, bool pIsARef)
-        :  PenetrationQuery(pFaceCentroid,pNormal,pPenetration,pIsARef),refFace(pRefFace), incFace(pIncFace)
+        :  PenetrationQuery(pFaceCentroid,pNormal,pPenetration,pIsARef),refHull(pRefHull), incHull(pIncHull),
+        refFace(pRefFace), incFace(pIncFace)
     {
         debugID = "ConvexConvexPenetrationQuery";
     }
@@ -17,56 +19,64 @@ namespace legion::physics
         , math::mat4 incTransform, PhysicsCollider* refCollider)
     {
         
+        OPTICK_EVENT();
         auto incCollider = isARef ? manifold.colliderB : manifold.colliderA;
         float largestDotResult = std::numeric_limits<float>::lowest();
 
+        if (!refHull || !incHull || refFace >= refHull->getFaces().size()) { return; }
+
         //------------------------------- find face that is touching refFace -------------------------------------------------//
 
-        for (auto face : incCollider->GetHalfEdgeFaces())
+        const auto& incFaces = incHull->getFaces();
+        for (size_type faceIndex = 0; faceIndex < incFaces.size(); faceIndex++)
         {
-            math::vec3 worldFaceNormal = incTransform * math::vec4(face->normal, 0);
+            math::vec3 worldFaceNormal = incTransform * math::vec4(incFaces[faceIndex].normal, 0);
 
             float currentDotResult = math::dot(-normal, worldFaceNormal);
             if (currentDotResult > largestDotResult)
             {
                 largestDotResult = currentDotResult;
-                incFace = face;
+                incFace = static_cast<ConvexHull::feature_index>(faceIndex);
             }
         }
 
+        if (incFace == ConvexHull::invalid_index) { return; }
+
         //------------------------------- get all world vertex positions in incFace -------------------------------------------------//
         std::vector<ContactVertex> outputContactPoints;
 
-        bool facePartiallyBelowPlane = false;
+        const ConvexHull::hull_face& incidentFace = incFaces[incFace];
+        const int incColliderID = incCollider->GetColliderID();
 
-        auto sendToInitialOutput = [&outputContactPoints,&incTransform](HalfEdgeEdge* edge)
+        for (size_type edge = incidentFace.firstEdge; edge < incidentFace.firstEdge + incidentFace.edgeCount; edge++)
         {
-            math::vec3 localVertexPosition = edge->edgePosition;
-            math::vec3 worldVertex = incTransform * math::vec4(localVertexPosition, 1);
-
-            outputContactPoints.push_back(ContactVertex(worldVertex,edge->label));
-        };
+            const auto edgeIndex = static_cast<ConvexHull::feature_index>(edge);
+            math::vec3 worldVertex = incTransform * math::vec4(incHull->getEdgeStart(edgeIndex), 1);
 
-        incFace->forEachEdge(sendToInitialOutput);
+            outputContactPoints.push_back(ContactVertex(worldVertex, incHull->getEdgeLabel(edgeIndex, incColliderID)));
+        }
 
+        //------------------------------- clip vertices with faces that are the neighbors of refFace  ---------------------------------//
 
+        const ConvexHull::hull_face& referenceFace = refHull->getFaces()[refFace];
+        const int refColliderID = refCollider->GetColliderID();
 
-        //------------------------------- clip vertices with faces that are the neighbors of refFace  ---------------------------------//
-        auto clipNeigboringFaceWithOutput = [&refTransform,&outputContactPoints](HalfEdgeEdge* edge)
+        for (size_type edge = referenceFace.firstEdge; edge < referenceFace.firstEdge + referenceFace.edgeCount; edge++)
         {
-            HalfEdgeFace* neighborFace = edge->pairingEdge->face;
-            math::vec3 planePosition = refTransform * math::vec4(neighborFace->centroid, 1);
-            math::vec3 planeNormal = refTransform * math::vec4(neighborFace->normal, 0);
+            const auto edgeIndex = static_cast<ConvexHull::feature_index>(edge);
+            const ConvexHull::feature_index pairing = refHull->getEdges()[edgeIndex].pairing;
+            if (pairing == ConvexHull::invalid_index) { continue; }
+
+            const ConvexHull::hull_face& neighborFace = refHull->getEdgeFace(pairing);
+            math::vec3 planePosition = refTransform * math::vec4(neighborFace.centroid, 1);
+            math::vec3 planeNormal = refTransform * math::vec4(neighborFace.normal, 0);
 
             auto inputContactList = outputContactPoints;
             outputContactPoints.clear();
 
-
-            PhysicsStatics::SutherlandHodgmanFaceClip(planeNormal, planePosition, inputContactList, outputContactPoints,edge);
-
-        };
-
-        refFace->forEachEdge(clipNeigboringFaceWithOutput);
+            PhysicsStatics::SutherlandHodgmanFaceClip(planeNormal, planePosition, inputContactList, outputContactPoints,
+                refHull->getEdgeLabel(edgeIndex, refColliderID));
+        }
 
 
         for (const auto& incidentContact : outputContactPoints)
@@ -83,8 +93,6 @@ namespace legion::physics
                 contact.RefWorldContact = referenceContact;
                 contact.label = incidentContact.label;
 
-                refCollider->AttemptFindAndCopyConverganceID(contact);
-
                 manifold.contacts.push_back(contact);
              
             }
@@ -1,6 +1,6 @@
 #pragma once
 #include <physics/data/penetrationquery.hpp>
-#include <physics/halfedgeedge.hpp>
+#include <physics/data/convex_hull.hpp>
 
 namespace legion::physics
 {
@@ -8,10 +8,14 @@ namespace legion::physics
 	{
 	public:
 
-		HalfEdgeFace* refFace = nullptr;
-		HalfEdgeFace* incFace = nullptr;
+		const ConvexHull* refHull = nullptr;
+		const ConvexHull* incHull = nullptr;
+		ConvexHull::feature_index refFace = ConvexHull::invalid_index;
+		ConvexHull::feature_index incFace = ConvexHull::invalid_index;
 
-		ConvexConvexPenetrationQuery(HalfEdgeFace* pRefFace, HalfEdgeFace* pIncFace, math::vec3& pFaceCentroid, math::vec3& pNormal, float pPenetration, bool pIsARef);
+		ConvexConvexPenetrationQuery(const ConvexHull* pRefHull, ConvexHull::feature_index pRefFace,
+			const ConvexHull* pIncHull, ConvexHull::feature_index pIncFace,
+			math::vec3& pFaceCentroid, math::vec3& pNormal, float pPenetration, bool pIsARef);
 
 		virtual void populateContactList(physics_manifold& manifold,  math::mat4& refTransform,
             math::mat4 incTransform , PhysicsCollider* refCollider) override;
@@ -20,3 +24,4 @@ namespace legion::physics
 }
 
 
+
@@ -6,9 +6,11 @@
 
 namespace legion::physics
 {
-    EdgePenetrationQuery::EdgePenetrationQuery(HalfEdgeEdge* pRefEdge, HalfEdgeEdge* pIncEdge,
+    EdgePenetrationQuery::EdgePenetrationQuery(const ConvexHull* pRefHull, ConvexHull::feature_index pRefEdge,
+        const ConvexHull* pIncHull, ConvexHull::feature_index pIncEdge,
         math::vec3& pFaceCentroid, math::vec3& pNormal, float& pPenetration, bool pIsARef) :
-        PenetrationQuery(pFaceCentroid,pNormal,pPenetration,pIsARef),refEdge(pRefEdge),incEdge(pIncEdge)
+        PenetrationQuery(pFaceCentroid,pNormal,pPenetration,pIsARef),refHull(pRefHull),incHull(pIncHull),
+        refEdge(pRefEdge),incEdge(pIncEdge)
     {
         debugID = "EdgePenetrationQuery";
     }
@@ -21,11 +23,13 @@ namespace legion::physics
         //------------------- The contact points between 2 edges are the closest points between the 2 edges --------------------//
         //log::debug("EdgePenetrationQuery::populateContactList");
 
-        math::vec3 p1 = refTransform * math::vec4(refEdge->edgePosition, 1);
-        math::vec3 p2 = refTransform * math::vec4(refEdge->nextEdge->edgePosition, 1);
+        if (!refHull || !incHull || refEdge >= refHull->getEdges().size() || incEdge >= incHull->getEdges().size()) { return; }
 
-        math::vec3 p3 = incTransform * math::vec4(incEdge->edgePosition, 1);
-        math::vec3 p4 = incTransform * math::vec4(incEdge->nextEdge->edgePosition, 1);
+        math::vec3 p1 = refTransform * math::vec4(refHull->getEdgeStart(refEdge), 1);
+        math::vec3 p2 = refTransform * math::vec4(refHull->getEdgeEnd(refEdge), 1);
+
+        math::vec3 p3 = incTransform * math::vec4(incHull->getEdgeStart(incEdge), 1);
+        math::vec3 p4 = incTransform * math::vec4(incHull->getEdgeEnd(incEdge), 1);
 
         math::vec3 refContactPoint;
         math::vec3 incContactPoint;
@@ -38,8 +42,10 @@ namespace legion::physics
 
         physics_contact contact;
 
-        auto refLabel = refEdge->label;
-        auto incLabel = incEdge->label;
+        auto incCollider = isARef ? manifold.colliderB : manifold.colliderA;
+
+        auto refLabel = refHull->getEdgeLabel(refEdge, refCollider->GetColliderID());
+        auto incLabel = incHull->getEdgeLabel(incEdge, incCollider->GetColliderID());
 
         contact.label = EdgeLabel(std::make_pair(refLabel.firstEdge.first, refLabel.firstEdge.second),
             std::make_pair(incLabel.nextEdge.first, incLabel.nextEdge.second));
@@ -48,8 +54,6 @@ namespace legion::physics
         contact.IncWorldContact = incContactPoint;
         contact.RefWorldContact = refContactPoint;
 
-        refCollider->AttemptFindAndCopyConverganceID(contact);
-
         manifold.contacts.push_back(contact);
 
     }
@@ -1,17 +1,20 @@
 #pragma once
 #include <core/core.hpp>
 #include <physics/data/penetrationquery.hpp>
-#include <physics/halfedgeedge.hpp>
+#include <physics/data/convex_hull.hpp>
 
 namespace legion::physics
 {
 	class EdgePenetrationQuery : public PenetrationQuery
 	{
 	public:
-		HalfEdgeEdge* refEdge = nullptr;
-		HalfEdgeEdge* incEdge = nullptr;
+		const ConvexHull* refHull = nullptr;
+		const ConvexHull* incHull = nullptr;
+		ConvexHull::feature_index refEdge = ConvexHull::invalid_index;
+		ConvexHull::feature_index incEdge = ConvexHull::invalid_index;
 
-		EdgePenetrationQuery(HalfEdgeEdge* pRefEdge, HalfEdgeEdge* pIncEdge,
+		EdgePenetrationQuery(const ConvexHull* pRefHull, ConvexHull::feature_index pRefEdge,
+			const ConvexHull* pIncHull, ConvexHull::feature_index pIncEdge,
 			math::vec3& pFaceCentroid, math::vec3& pNormal, float& pPenetration, bool pIsARef);
 
 		virtual void populateContactList(physics_manifold& manifold,
@@ -19,3 +22,4 @@ namespace legion::physics
 	};
 }
 
+
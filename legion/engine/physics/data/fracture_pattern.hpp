@@ -0,0 +1,44 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/data/convex_hull.hpp>
+
+namespace legion::physics
+{
+    /** @struct fracture_fragment
+    * @brief A piece of a precomputed fracture. The vertices of the mesh and the hull are relative to the fragment,
+    * the fragment itself is placed relative to the position and rotation of the fractured entity.
+    */
+    struct fracture_fragment
+    {
+        //index of the MeshSplitter the fragment was cut from, the owner comes first and its children follow
+        size_type pairingIndex = 0;
+
+        //only used until the pattern is first committed, after that the mesh lives in the MeshCache
+        mesh fragmentMesh;
+        mesh_handle meshHandle = invalid_mesh_handle;
+
+        std::shared_ptr<const ConvexHull> convexHull;
+
+        math::vec3 localPosition;
+        math::quat localRotation;
+    };
+
+    /** @struct fracture_pattern
+    * @brief The fragments of an asset. A pattern is built once by jobs in the background and is shared by every entity
+    * that fractures the same meshes at the same scale.
+    */
+    struct fracture_pattern
+    {
+        //every voronoi cell is split by its own job, so every cell gets its own list of fragments
+        std::vector<std::vector<fracture_fragment>> cellFragments;
+        std::atomic<size_type> cellsRemaining = { 0 };
+
+        //set once the meshes of the fragments are added to the MeshCache
+        bool isRegistered = false;
+
+        L_NODISCARD bool isReady() const noexcept
+        {
+            return cellsRemaining.load(std::memory_order_acquire) == 0;
+        }
+    };
+}
@@ -6,6 +6,7 @@
 #include <core/core.hpp>
 #include <physics/components/physics_component.hpp>
 #include <physics/data/penetrationquery.hpp>
+#include <physics/data/collider_pair_cache.hpp>
 
 namespace legion::physics
 {
@@ -35,7 +36,10 @@ namespace legion::physics
 
         std::unique_ptr<PenetrationQuery> penetrationInformation;
 
-        bool isColliding;
+        //the data of this collider pair that persists between physics steps, owned by the PhysicsSystem
+        collider_pair_cache* pairCache = nullptr;
+
+        bool isColliding = false;
 
         /*void DEBUG_checkIDAndBreak(std::string firstID,std::string secondID) const
         {
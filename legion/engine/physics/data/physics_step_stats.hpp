@@ -0,0 +1,50 @@
+#pragma once
+#include <core/core.hpp>
+
+namespace legion::physics
+{
+    /** @struct physics_step_stats
+    * @brief The time spent in each stage of a physics step in milliseconds, and how much work the step had to do.
+    * The stages of all substeps of a step are added together.
+    */
+    struct physics_step_stats
+    {
+        time64 fetchTime = 0;
+        time64 broadphaseTime = 0;
+        time64 narrowphaseTime = 0;
+        time64 solveTime = 0;
+        time64 integrateTime = 0;
+        time64 submitTime = 0;
+
+        //the number of precursor pairs the narrowphase looked at and the number of colliding manifolds it found
+        size_type pairChecks = 0;
+        size_type manifolds = 0;
+
+        L_NODISCARD time64 totalTime() const noexcept
+        {
+            return fetchTime + broadphaseTime + narrowphaseTime + solveTime + integrateTime + submitTime;
+        }
+
+        physics_step_stats& operator+=(const physics_step_stats& other) noexcept
+        {
+            fetchTime += other.fetchTime;
+            broadphaseTime += other.broadphaseTime;
+            narrowphaseTime += other.narrowphaseTime;
+            solveTime += other.solveTime;
+            integrateTime += other.integrateTime;
+            submitTime += other.submitTime;
+            pairChecks += other.pairChecks;
+            manifolds += other.manifolds;
+            return *this;
+        }
+
+        template<typename Archive>
+        void serialize(Archive& archive)
+        {
+            archive(cereal::make_nvp("fetch_ms", fetchTime), cereal::make_nvp("broadphase_ms", broadphaseTime),
+                cereal::make_nvp("narrowphase_ms", narrowphaseTime), cereal::make_nvp("solve_ms", solveTime),
+                cereal::make_nvp("integrate_ms", integrateTime), cereal::make_nvp("submit_ms", submitTime),
+                cereal::make_nvp("pair_checks", pairChecks), cereal::make_nvp("manifolds", manifolds));
+        }
+    };
+}
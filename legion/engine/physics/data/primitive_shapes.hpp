@@ -0,0 +1,81 @@
+#pragma once
+#include <core/core.hpp>
+#include <array>
+
+namespace legion::physics
+{
+    /**@struct world_sphere
+     * @brief A sphere collider transformed into world space.
+     */
+    struct world_sphere
+    {
+        math::vec3 center;
+        float radius;
+    };
+
+    /**@struct world_capsule
+     * @brief A capsule collider transformed into world space, the capsule is every point within radius of the segment start-end.
+     */
+    struct world_capsule
+    {
+        math::vec3 start;
+        math::vec3 end;
+        float radius;
+    };
+
+    /**@struct world_box
+     * @brief A box collider transformed into world space.
+     */
+    struct world_box
+    {
+        math::vec3 center;
+        //normalized local axes of the box
+        std::array<math::vec3, 3> axes;
+        math::vec3 halfExtents;
+
+        /**@brief Gets the corner of the box furthest in the given direction.
+         */
+        L_NODISCARD math::vec3 getSupportPoint(const math::vec3& direction) const
+        {
+            math::vec3 result = center;
+            for (int i = 0; i < 3; i++)
+            {
+                result += axes[i] * (math::dot(direction, axes[i]) >= 0.0f ? halfExtents[i] : -halfExtents[i]);
+            }
+            return result;
+        }
+    };
+
+    /**@struct primitive_collision_info
+     * @brief The result of a closed form collision test between 2 primitive shapes, shape A and shape B.
+     */
+    struct primitive_collision_info
+    {
+        static constexpr size_type maxContacts = 8;
+
+        //normal of the collision, points from shape A towards shape B
+        math::vec3 normal = math::vec3(0.0f, 1.0f, 0.0f);
+        //seperation of the shapes along the normal, negative when they overlap
+        float seperation = 0.0f;
+
+        //the contact points as pairs of a point on shape A and a point on shape B
+        std::array<std::pair<math::vec3, math::vec3>, maxContacts> contacts;
+        size_type contactCount = 0;
+
+        void addContact(const math::vec3& pointOnA, const math::vec3& pointOnB)
+        {
+            if (contactCount < maxContacts)
+            {
+                contacts[contactCount++] = std::make_pair(pointOnA, pointOnB);
+            }
+        }
+    };
+
+    /**@brief Gets the largest scale of a transform, used to scale the radius of round shapes.
+     */
+    inline float getMaximumScale(const math::mat4& transform)
+    {
+        return math::max(math::length(math::vec3(transform[0])),
+            math::max(math::length(math::vec3(transform[1])), math::length(math::vec3(transform[2]))));
+    }
+}
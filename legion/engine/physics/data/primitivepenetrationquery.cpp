@@ -0,0 +1,30 @@
+#include <physics/data/primitivepenetrationquery.hpp>
+#include <physics/data/physics_manifold.hpp>
+#include <physics/physics_contact.hpp>
+
+namespace legion::physics
+{
+    PrimitivePenetrationQuery::PrimitivePenetrationQuery(const primitive_collision_info& pCollisionInfo, bool pIsARef)
+        : PenetrationQuery(pCollisionInfo.contacts[0].first, pCollisionInfo.normal,
+            pCollisionInfo.seperation, pIsARef), collisionInfo(pCollisionInfo)
+    {
+        debugID = "PrimitivePenetrationQuery";
+    }
+
+    void PrimitivePenetrationQuery::populateContactList(physics_manifold& manifold,
+        math::mat4& refTransform, math::mat4 incTransform, PhysicsCollider* refCollider)
+    {
+        OPTICK_EVENT();
+        for (size_type i = 0; i < collisionInfo.contactCount; i++)
+        {
+            auto& [refContact, incContact] = collisionInfo.contacts[i];
+
+            physics_contact contact;
+            contact.refCollider = refCollider;
+            contact.RefWorldContact = refContact;
+            contact.IncWorldContact = incContact;
+
+            manifold.contacts.push_back(contact);
+        }
+    }
+}
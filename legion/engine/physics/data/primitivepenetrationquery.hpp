@@ -0,0 +1,25 @@
+#pragma once
+
+#include <physics/data/penetrationquery.hpp>
+#include <physics/data/primitive_shapes.hpp>
+
+namespace legion::physics
+{
+    /**@brief PenetrationQuery of a closed form primitive collision test, the contact points are already known
+     * when the query is created.
+     * @note The first shape of the primitive_collision_info is always the reference.
+     */
+    class PrimitivePenetrationQuery : public PenetrationQuery
+    {
+    public:
+
+        PrimitivePenetrationQuery(const primitive_collision_info& pCollisionInfo, bool pIsARef);
+
+        virtual void populateContactList(physics_manifold& manifold
+            , math::mat4& refTransform, math::mat4 incTransform, PhysicsCollider* refCollider) override;
+
+    private:
+
+        primitive_collision_info collisionInfo;
+    };
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/colliders/physicscollider.hpp>
+#include <limits>
+
+namespace legion::physics
+{
+    /**@struct raycast_query
+     * @brief A ray that is cast into the physics world, only the closest hit is reported.
+     */
+    struct raycast_query
+    {
+        math::vec3 origin;
+        //does not need to be normalized
+        math::vec3 direction;
+        float maxDistance = std::numeric_limits<float>::max();
+        bool ignoreTriggers = true;
+    };
+
+    /**@struct sphere_sweep_query
+     * @brief A sphere that is swept through the physics world, only the closest hit is reported.
+     */
+    struct sphere_sweep_query
+    {
+        math::vec3 origin;
+        //does not need to be normalized
+        math::vec3 direction;
+        float maxDistance = std::numeric_limits<float>::max();
+        float radius = 0.5f;
+        bool ignoreTriggers = true;
+    };
+
+    /**@struct box_sweep_query
+     * @brief An oriented box that is swept through the physics world, only the closest hit is reported.
+     */
+    struct box_sweep_query
+    {
+        math::vec3 origin;
+        //does not need to be normalized
+        math::vec3 direction;
+        float maxDistance = std::numeric_limits<float>::max();
+        math::vec3 halfExtents = math::vec3(0.5f);
+        math::quat rotation = math::quat(1, 0, 0, 0);
+        bool ignoreTriggers = true;
+    };
+
+    /**@struct aabb_overlap_query
+     * @brief An axis aligned box, every collider whose bounding box overlaps it is reported.
+     */
+    struct aabb_overlap_query
+    {
+        math::vec3 min;
+        math::vec3 max;
+        bool ignoreTriggers = true;
+    };
+
+    /**@struct query_hit
+     * @brief The closest hit of a raycast or a sweep.
+     */
+    struct query_hit
+    {
+        ecs::entity_handle entity;
+        int colliderID = -1;
+        //the point on the collider that was hit
+        math::vec3 point;
+        //the normal of the collider at the hit, -direction when the query started inside the collider
+        math::vec3 normal;
+        float distance = std::numeric_limits<float>::max();
+        bool isHit = false;
+    };
+
+    /**@struct overlap_hit
+     * @brief A collider that overlaps an overlap query.
+     */
+    struct overlap_hit
+    {
+        ecs::entity_handle entity;
+        int colliderID = -1;
+    };
+
+    /**@struct query_results
+     * @brief The hits of a batch of queries that can each have any number of hits, stored in one flat buffer.
+     * The hits of query i are hits[offsets[i]] up to hits[offsets[i + 1]].
+     */
+    template<typename hit_type>
+    struct query_results
+    {
+        std::vector<hit_type> hits;
+        std::vector<size_type> offsets;
+
+        L_NODISCARD size_type count(size_type queryIndex) const
+        {
+            return offsets[queryIndex + 1] - offsets[queryIndex];
+        }
+
+        L_NODISCARD const hit_type* begin(size_type queryIndex) const
+        {
+            return hits.data() + offsets[queryIndex];
+        }
+
+        L_NODISCARD const hit_type* end(size_type queryIndex) const
+        {
+            return hits.data() + offsets[queryIndex + 1];
+        }
+    };
+
+    /**@struct query_proxy
+     * @brief A copy of the data of a physicsComponent at the last physics step, used by the scene queries
+     * so that queries do not read the components while the physics step runs.
+     * @note The index of a proxy is the id of the physics_manifold_precursor that it was created from.
+     */
+    struct query_proxy
+    {
+        math::mat4 worldTransform;
+        std::vector<std::shared_ptr<PhysicsCollider>> colliders;
+        //the world space bounding box of every collider
+        std::vector<std::pair<math::vec3, math::vec3>> colliderBounds;
+        ecs::entity_handle entity;
+        bool isTrigger = false;
+    };
+}
@@ -0,0 +1,126 @@
+#pragma once
+#include <core/core.hpp>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+namespace legion::physics
+{
+    /**@struct VertexSoA
+     * @brief Structure of arrays copy of a vertex list, padded to a multiple of 4 so that
+     * support point searches can be done 4 vertices at a time.
+     * @note The padding is filled with copies of the first vertex so it can never produce a better support point.
+     */
+    struct VertexSoA
+    {
+        static constexpr size_type width = 4;
+
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        size_type count = 0;
+
+        VertexSoA() = default;
+
+        explicit VertexSoA(const std::vector<math::vec3>& vertices)
+        {
+            assign(vertices);
+        }
+
+        void assign(const std::vector<math::vec3>& vertices)
+        {
+            count = vertices.size();
+            size_type paddedCount = ((count + width - 1) / width) * width;
+
+            x.resize(paddedCount);
+            y.resize(paddedCount);
+            z.resize(paddedCount);
+
+            for (size_type i = 0; i < paddedCount; i++)
+            {
+                const math::vec3& vert = i < count ? vertices[i] : vertices[0];
+                x[i] = vert.x;
+                y[i] = vert.y;
+                z[i] = vert.z;
+            }
+        }
+
+        L_NODISCARD bool empty() const noexcept
+        {
+            return count == 0;
+        }
+
+        /**@brief Gets the index of the vertex furthest in the given direction.
+         * @param direction The direction to search in, does not need to be normalized.
+         * @param maxDistance [out] The dot product between the found vertex and the direction.
+         * @return The index of the support vertex, ties are resolved to the lowest index.
+         */
+        size_type getSupportIndex(const math::vec3& direction, float& maxDistance) const
+        {
+            assert(count > 0);
+            const size_type paddedCount = x.size();
+
+#if defined(LEGION_SSE)
+            const __m128 dirX = _mm_set1_ps(direction.x);
+            const __m128 dirY = _mm_set1_ps(direction.y);
+            const __m128 dirZ = _mm_set1_ps(direction.z);
+
+            __m128 best = _mm_set1_ps(std::numeric_limits<float>::lowest());
+            __m128i bestIndex = _mm_setzero_si128();
+            __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+            const __m128i step = _mm_set1_epi32(static_cast<int>(width));
+
+            for (size_type i = 0; i < paddedCount; i += width)
+            {
+                __m128 dot = _mm_mul_ps(_mm_loadu_ps(&x[i]), dirX);
+                dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(&y[i]), dirY));
+                dot = _mm_add_ps(dot, _mm_mul_ps(_mm_loadu_ps(&z[i]), dirZ));
+
+                //keep the index of every lane that improved, strictly greater so the first occurence wins
+                __m128i improved = _mm_castps_si128(_mm_cmpgt_ps(dot, best));
+                bestIndex = _mm_or_si128(_mm_and_si128(improved, index), _mm_andnot_si128(improved, bestIndex));
+                best = _mm_max_ps(best, dot);
+                index = _mm_add_epi32(index, step);
+            }
+
+            alignas(16) float lanes[width];
+            alignas(16) int32 laneIndices[width];
+            _mm_store_ps(lanes, best);
+            _mm_store_si128(reinterpret_cast<__m128i*>(laneIndices), bestIndex);
+
+            size_type result = static_cast<size_type>(laneIndices[0]);
+            maxDistance = lanes[0];
+            for (size_type lane = 1; lane < width; lane++)
+            {
+                size_type laneIndex = static_cast<size_type>(laneIndices[lane]);
+                if (lanes[lane] > maxDistance || (lanes[lane] == maxDistance && laneIndex < result))
+                {
+                    maxDistance = lanes[lane];
+                    result = laneIndex;
+                }
+            }
+#else
+            size_type result = 0;
+            maxDistance = std::numeric_limits<float>::lowest();
+            for (size_type i = 0; i < paddedCount; i++)
+            {
+                float dot = x[i] * direction.x + y[i] * direction.y + z[i] * direction.z;
+                if (dot > maxDistance)
+                {
+                    maxDistance = dot;
+                    result = i;
+                }
+            }
+#endif
+            //padding lanes are copies of the first vertex
+            return result < count ? result : 0;
+        }
+
+        size_type getSupportIndex(const math::vec3& direction) const
+        {
+            float maxDistance;
+            return getSupportIndex(direction, maxDistance);
+        }
+    };
+}
@@ -15,26 +15,31 @@ namespace legion::physics
         if (meshFilter && posH && rotH && scaleH)
         {
             log::debug("Mesh and Transform found");
-            std::queue<meshHalfEdgePtr> meshHalfEdges;
 
             //auto renderable = renderable.read();
             mesh& mesh = meshFilter.read().get().second;
 
             const math::mat4 transform = math::compose(scaleH.read(), rotH.read(), posH.read());
             //debugHelper.DEBUG_transform = transform;
-          
-            HalfEdgeFinder edgeFinder;
-            edgeFinder.FindHalfEdge(mesh, transform, meshHalfEdges);
-
-            BFSPolygonize(meshHalfEdges, transform);
-
-            log::debug("Mesh vertices {}, Mesh indices {}", mesh.vertices.size(), mesh.indices.size());
 
+            InitializePolygons(mesh, transform);
         }
         else
         {
             log::warn("The given entity does not have a meshHandle!");
         }
+    }
+
+    void MeshSplitter::InitializePolygons(mesh& mesh, const math::mat4& transform)
+    {
+        std::queue<meshHalfEdgePtr> meshHalfEdges;
+
+        HalfEdgeFinder edgeFinder;
+        edgeFinder.FindHalfEdge(mesh, transform, meshHalfEdges);
+
+        BFSPolygonize(meshHalfEdges, transform);
+
+        log::debug("Mesh vertices {}, Mesh indices {}", mesh.vertices.size(), mesh.indices.size());
 
         for (auto face : meshPolygons)
         {
@@ -52,19 +57,36 @@ namespace legion::physics
     void MeshSplitter::MultipleSplitMesh(const std::vector<MeshSplitParams>& splittingPlanes,
         std::vector<ecs::entity_handle>& entitiesGenerated, bool keepBelow, int debugAt)
     {
-        int currentDebug = 0;
-
         auto [posH, rotH, scaleH] = owner.get_component_handles<transform>();
         const math::mat4& transform = math::compose(scaleH.read(), rotH.read(), posH.read());
 
-        //-------------------------------- copy polygons of original mesh and add it to the output list -----------------------------------------//
-
-        std::vector< std::vector<SplittablePolygonPtr>> outputPolygonIslandsGenerated;
+        //-------------------------------- copy polygons of original mesh and split them -----------------------------------------//
 
         std::vector<SplittablePolygonPtr> copiedPolygons;
         CopyPolygons(meshPolygons, copiedPolygons);
 
-        outputPolygonIslandsGenerated.push_back(std::move(copiedPolygons));
+        std::vector< std::vector<SplittablePolygonPtr>> outputPolygonIslandsGenerated;
+        SplitMeshIntoIslands(copiedPolygons, splittingPlanes, transform, outputPolygonIslandsGenerated, keepBelow, debugAt);
+
+        //-------------------------------- use each polygon list to create a new object -----------------------------------------//
+
+        for (auto& polygonIsland : outputPolygonIslandsGenerated)
+        {
+            PrimitiveMesh newMesh(owner, polygonIsland, ownerMaterialH);
+            auto newEnt = newMesh.InstantiateNewGameObject();
+
+            entitiesGenerated.push_back(newEnt);
+        }
+    }
+
+    void MeshSplitter::SplitMeshIntoIslands(std::vector<SplittablePolygonPtr>& polygonsToSplit,
+        const std::vector<MeshSplitParams>& splittingPlanes, const math::mat4& transform,
+        std::vector<std::vector<SplittablePolygonPtr>>& resultingIslands, bool keepBelow, int debugAt)
+    {
+        int currentDebug = 0;
+
+        std::vector< std::vector<SplittablePolygonPtr>> outputPolygonIslandsGenerated;
+        outputPolygonIslandsGenerated.push_back(std::move(polygonsToSplit));
 
         //-------------------------------- spllit mesh based on list of splitting planes -----------------------------------------//
         for (const MeshSplitParams& splitParam : splittingPlanes)
@@ -89,14 +111,9 @@ namespace legion::physics
             currentDebug++;
         }
 
-        //-------------------------------- use each polygon list to create a new object -----------------------------------------//
-
         for (auto& polygonIsland : outputPolygonIslandsGenerated)
         {
-            PrimitiveMesh newMesh(owner, polygonIsland, ownerMaterialH);
-            auto newEnt = newMesh.InstantiateNewGameObject();
-
-            entitiesGenerated.push_back(newEnt);
+            resultingIslands.push_back(std::move(polygonIsland));
         }
     }
 
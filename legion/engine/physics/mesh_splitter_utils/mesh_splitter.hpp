@@ -35,6 +35,11 @@ namespace legion::physics
        * @param entity the entity that this MeshSplitter is attached to
        */
         void InitializePolygons(ecs::entity_handle entity);
+
+        /** @brief Creates a Half-Edge Data structure around the mesh without an entity
+       * @param transform the transform the mesh is placed with
+       */
+        void InitializePolygons(mesh& mesh, const math::mat4& transform);
        
 
         /** @brief Given a queue of edges and a transform,
@@ -147,6 +152,15 @@ namespace legion::physics
         */
         void MultipleSplitMesh(const std::vector<MeshSplitParams>& splittingPlanes, std::vector<ecs::entity_handle>& entitiesGenerated,
             bool keepBelow = true,int debugAt = -1);
+
+        /** @brief Given a list of splitting planes, splits 'polygonsToSplit' and places the resulting islands in 'resultingIslands'.
+        * Does not read or write the ECS, so it can be called from a job.
+        * @param polygonsToSplit A copy of the polygons of the mesh made with CopyPolygons, the copy is consumed by the split.
+        * @param transform The transform the splitting planes are relative to.
+        */
+        void SplitMeshIntoIslands(std::vector<SplittablePolygonPtr>& polygonsToSplit,
+            const std::vector<MeshSplitParams>& splittingPlanes, const math::mat4& transform,
+            std::vector<std::vector<SplittablePolygonPtr>>& resultingIslands, bool keepBelow = true, int debugAt = -1);
        
         /** @brief Given a list of polygons to split in 'polygonsToSplit', splits them based on a splitting plane defined by
         * 'planePosition' and 'planeNormal'. The result is then placed in 'resultingIslands.
@@ -13,6 +13,12 @@ namespace legion::physics
 
     }
 
+    PrimitiveMesh::PrimitiveMesh(std::vector<std::shared_ptr<SplittablePolygon>>& pPolygons)
+        : polygons(std::move(pPolygons))
+    {
+
+    }
+
     ecs::entity_handle PrimitiveMesh::InstantiateNewGameObject()
     {
         auto [originalPosH, originalRotH, originalScaleH] = originalEntity.get_component_handles<transform>();
@@ -21,18 +27,7 @@ namespace legion::physics
         auto ent = m_ecs->createEntity();
         math::vec3 offset;
 
-        mesh newMesh;
-
-        math::vec3 scale = originalScaleH.read();
-        populateMesh(newMesh, trans, offset, scale);
-      
-        newMesh.calculate_tangents(&newMesh);
-
-        sub_mesh newSubMesh;
-        newSubMesh.indexCount = newMesh.indices.size();
-        newSubMesh.indexOffset = 0;
-
-        newMesh.submeshes.push_back(newSubMesh);
+        mesh newMesh = CreateMesh(trans, originalScaleH.read(), offset);
 
         //creaate modelH
         mesh_handle meshH = core::MeshCache::create_mesh("newMesh" + std::to_string(count), newMesh);
@@ -60,6 +55,23 @@ namespace legion::physics
         return ent;
     }
 
+    mesh PrimitiveMesh::CreateMesh(const math::mat4& originalTransform, math::vec3 scale, math::vec3& outOffset)
+    {
+        mesh newMesh;
+
+        populateMesh(newMesh, originalTransform, outOffset, scale);
+
+        newMesh.calculate_tangents(&newMesh);
+
+        sub_mesh newSubMesh;
+        newSubMesh.indexCount = newMesh.indices.size();
+        newSubMesh.indexOffset = 0;
+
+        newMesh.submeshes.push_back(newSubMesh);
+
+        return newMesh;
+    }
+
     void PrimitiveMesh::SetECSRegistry(ecs::EcsRegistry* ecs)
     {
         m_ecs = ecs;
@@ -14,10 +14,20 @@ namespace legion::physics
 		PrimitiveMesh(ecs::entity_handle pOriginalEntity, 
 			std::vector<std::shared_ptr<SplittablePolygon>>& pPolygons,
 			rendering::material_handle pOriginalMaterial);
-			
+
+		/**@brief Creates a PrimitiveMesh that is only used to build a mesh with CreateMesh.
+		 */
+		PrimitiveMesh(std::vector<std::shared_ptr<SplittablePolygon>>& pPolygons);
 
 		ecs::entity_handle InstantiateNewGameObject();
 
+		/**@brief Builds the mesh of the polygons without creating an entity, so it can be called from a job.
+		 * @param originalTransform The transform the polygons were split with.
+		 * @param scale The scale that is baked into the vertices of the mesh.
+		 * @param outOffset The centroid of the mesh relative to the position of 'originalTransform'.
+		 */
+		mesh CreateMesh(const math::mat4& originalTransform, math::vec3 scale, math::vec3& outOffset);
+
 		static void SetECSRegistry(ecs::EcsRegistry* ecs);
 
 	private:
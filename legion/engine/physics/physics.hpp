@@ -3,6 +3,9 @@
 #include <physics/components/physics_component.hpp>
 #include <physics/components/rigidbody.hpp>
 #include <physics/colliders/convexcollider.hpp>
+#include <physics/colliders/boxcollider.hpp>
+#include <physics/colliders/spherecollider.hpp>
+#include <physics/colliders/capsulecollider.hpp>
 #include <physics/colliders/physicscollider.hpp>
 #include <physics/cube_collider_params.hpp>
 #include <physics/physicsconstants.hpp>
@@ -14,3 +17,5 @@
 #include <physics/data/physics_manifold_precursor.hpp>
 #include <physics/data/pointer_encapsulator.hpp>
 #include <physics/systems/physicssystem.hpp>
+#include <physics/systems/physics_replay.hpp>
+#include <physics/systems/physics_benchmark.hpp>
@@ -10,7 +10,8 @@ namespace legion::physics
 
         outCollisionInfo.ARefSeperation = 0.0f;
         if (PhysicsStatics::FindSeperatingAxisByExtremePointProjection(
-            convexB, convexA, transformB, transformA, outCollisionInfo.ARefFace, outCollisionInfo.ARefSeperation) || !outCollisionInfo.ARefFace.ptr)
+            convexB, convexA, transformB, transformA, outCollisionInfo.ARefFace, outCollisionInfo.ARefSeperation)
+            || outCollisionInfo.ARefFace == ConvexHull::invalid_index)
         {
             //log::debug("Not Found on A ");
             return;
@@ -20,20 +21,17 @@ namespace legion::physics
         //log::debug("Face Check B");
         outCollisionInfo.BRefSeperation = 0.0f;
         if (PhysicsStatics::FindSeperatingAxisByExtremePointProjection(convexA,
-            convexB, transformA,transformB, outCollisionInfo.BRefFace, outCollisionInfo.BRefSeperation) || !outCollisionInfo.BRefFace.ptr)
+            convexB, transformA,transformB, outCollisionInfo.BRefFace, outCollisionInfo.BRefSeperation)
+            || outCollisionInfo.BRefFace == ConvexHull::invalid_index)
         {
             //log::debug("Not Found on B ");
             return;
         }
 
-        PointerEncapsulator< HalfEdgeEdge> edgeRef;
-        PointerEncapsulator< HalfEdgeEdge> edgeInc;
-
-
         outCollisionInfo.aToBEdgeSeperation =0.0f;
         //log::debug("Edge Check");
         if (PhysicsStatics::FindSeperatingAxisByGaussMapEdgeCheck(convexB, convexA, transformB,transformA,
-            edgeRef, edgeInc, outCollisionInfo.edgeNormal, outCollisionInfo.aToBEdgeSeperation))
+            outCollisionInfo.edgeRef, outCollisionInfo.edgeInc, outCollisionInfo.edgeNormal, outCollisionInfo.aToBEdgeSeperation))
         {
             //log::debug("aToBEdgeSeperation {} " );
             return;
@@ -60,101 +58,180 @@ namespace legion::physics
         return currentMaximumSupportPoint;
     }
 
+    namespace
+    {
+        /**@brief The data of a single edge that the gauss map edge check needs.
+         * The normals and arc normal are in the local space of the reference collider,
+         * the direction and position are in world space.
+         */
+        struct GaussMapEdge
+        {
+            ConvexHull::feature_index edge;
+            math::vec3 normal;
+            math::vec3 pairingNormal;
+            math::vec3 arcNormal;
+            math::vec3 worldDirection;
+            math::vec3 worldPosition;
+        };
+    }
+
     bool PhysicsStatics::FindSeperatingAxisByGaussMapEdgeCheck(ConvexCollider* convexA, ConvexCollider* convexB, const math::mat4& transformA,
-        const math::mat4& transformB, PointerEncapsulator<HalfEdgeEdge>& refEdge, PointerEncapsulator<HalfEdgeEdge>& incEdge,
+        const math::mat4& transformB, ConvexHull::feature_index& refEdge, ConvexHull::feature_index& incEdge,
         math::vec3& seperatingAxisFound, float& maximumSeperation, bool shouldDebug)
     {
+        OPTICK_EVENT();
         float currentMinimumSeperation = std::numeric_limits<float>::max();
+        refEdge = ConvexHull::invalid_index;
+        incEdge = ConvexHull::invalid_index;
+
+        const ConvexHull& hullA = convexA->GetConvexHull();
+        const ConvexHull& hullB = convexB->GetConvexHull();
 
         math::vec3 centroidDir = transformA * math::vec4(convexA->GetLocalCentroid(), 0);
         math::vec3 positionA = math::vec3(transformA[3]) + centroidDir;
 
-        int facei = 0;
-        int facej = 0;
+        //these are reused between calls so the edge check does not allocate
+        thread_local std::vector<GaussMapEdge> gaussMapA;
+        thread_local std::vector<GaussMapEdge> gaussMapB;
 
-        for (const auto faceA : convexA->GetHalfEdgeFaces())
+        //----------------- Get the gauss map of A in its own local space ------------//
+        gaussMapA.clear();
+        for (ConvexHull::feature_index edge : hullA.getUniqueEdges())
         {
-            //----------------- Get all edges of faceA ------------//
-            std::vector<HalfEdgeEdge*> convexAHalfEdges;
+            const ConvexHull::half_edge& halfEdge = hullA.getEdges()[edge];
+            if (halfEdge.pairing == ConvexHull::invalid_index) { continue; }
 
-            auto lambda = [&convexAHalfEdges](HalfEdgeEdge* edge)
-            {
-                convexAHalfEdges.push_back(edge);
-            };
+            const math::vec3 normal = hullA.getFaces()[halfEdge.face].normal;
+            const math::vec3 pairingNormal = hullA.getEdgeFace(halfEdge.pairing).normal;
 
-            faceA->forEachEdge(lambda);
-            facej = 0;
+            gaussMapA.push_back({ edge, normal, pairingNormal, math::cross(normal, pairingNormal),
+                math::normalize(math::vec3(transformA * math::vec4(hullA.getEdgeDirection(edge), 0))),
+                transformA * math::vec4(hullA.getEdgeStart(edge), 1) });
+        }
+
+        //----------------- Move the negated gauss map of B into the local space of A ------------//
+        const math::mat4 bToA = math::inverse(transformA) * transformB;
+
+        gaussMapB.clear();
+        for (ConvexHull::feature_index edge : hullB.getUniqueEdges())
+        {
+            const ConvexHull::half_edge& halfEdge = hullB.getEdges()[edge];
+            if (halfEdge.pairing == ConvexHull::invalid_index) { continue; }
 
-            for (const auto faceB : convexB->GetHalfEdgeFaces())
+            const math::vec3 normal = -math::vec3(bToA * math::vec4(hullB.getFaces()[halfEdge.face].normal, 0));
+            const math::vec3 pairingNormal = -math::vec3(bToA * math::vec4(hullB.getEdgeFace(halfEdge.pairing).normal, 0));
+
+            gaussMapB.push_back({ edge, normal, pairingNormal, math::cross(normal, pairingNormal),
+                math::normalize(math::vec3(transformB * math::vec4(hullB.getEdgeDirection(edge), 0))),
+                transformB * math::vec4(hullB.getEdgeStart(edge), 1) });
+        }
+
+        for (const GaussMapEdge& edgeA : gaussMapA)
+        {
+            for (const GaussMapEdge& edgeB : gaussMapB)
             {
-                //----------------- Get all edges of faceB ------------//
-                std::vector<HalfEdgeEdge*> convexBHalfEdges;
+                //only edges whose arcs intersect on the gauss map create a minkowski face
+                if (!isMinkowskiFace(edgeA.normal, edgeA.pairingNormal, edgeB.normal, edgeB.pairingNormal,
+                    edgeA.arcNormal, edgeB.arcNormal))
+                {
+                    continue;
+                }
 
-                auto lambda = [&convexBHalfEdges](HalfEdgeEdge* edge)
+                //get the seperating axis
+                math::vec3 seperatingAxis = math::cross(edgeA.worldDirection, edgeB.worldDirection);
+
+                if (math::epsilonEqual(math::length(seperatingAxis), 0.0f, math::epsilon<float>()))
                 {
-                    convexBHalfEdges.push_back(edge);
-                };
+                    continue;
+                }
 
-                faceB->forEachEdge(lambda);
+                seperatingAxis = math::normalize(seperatingAxis);
 
-                for (HalfEdgeEdge* edgeA : convexAHalfEdges)
+                //check if its pointing in the right direction 
+                if (math::dot(seperatingAxis, edgeA.worldPosition - positionA) < 0)
                 {
-                    for (HalfEdgeEdge* edgeB : convexBHalfEdges)
-                    {
-                        //if the given edges creates a minkowski face
-                        if (attemptBuildMinkowskiFace(edgeA, edgeB, transformA, transformB))
-                        {
-                            //get world edge direction
-                            math::vec3 edgeADirection = transformA * math::vec4(edgeA->getLocalEdgeDirection(), 0);
-
-                            math::vec3 edgeBDirection = transformB * math::vec4(edgeB->getLocalEdgeDirection(), 0);
-
-                            edgeADirection = math::normalize(edgeADirection);
-                            edgeBDirection = math::normalize(edgeBDirection);
-
-                            //get the seperating axis
-                            math::vec3 seperatingAxis = math::cross(edgeADirection, edgeBDirection);
-
-                            if (math::epsilonEqual(math::length(seperatingAxis), 0.0f, math::epsilon<float>()))
-                            {
-                                continue;
-                            }
-
-                            seperatingAxis = math::normalize(seperatingAxis);
-
-                            //get world edge position
-                            math::vec3 edgeAtransformedPosition = transformA * math::vec4(edgeA->edgePosition, 1);
-                            math::vec3 edgeBtransformedPosition = transformB * math::vec4(edgeB->edgePosition, 1);
-
-                            //check if its pointing in the right direction 
-                            if (math::dot(seperatingAxis, edgeAtransformedPosition - positionA) < 0)
-                            {
-                                seperatingAxis = -seperatingAxis;
-                            }
-
-                            //check if given edges create a seperating axis
-                            float distance = math::dot(seperatingAxis, edgeBtransformedPosition - edgeAtransformedPosition);
-                            //log::debug("distance {} , currentMinimumSeperation {}", distance, currentMinimumSeperation);
-                            if (distance < currentMinimumSeperation)
-                            {
-                                refEdge.ptr = edgeA;
-                                incEdge.ptr = edgeB;
-
-                                seperatingAxisFound = seperatingAxis;
-                                currentMinimumSeperation = distance;
-                            }
-                        }
-                    }
+                    seperatingAxis = -seperatingAxis;
+                }
+
+                //check if given edges create a seperating axis
+                float distance = math::dot(seperatingAxis, edgeB.worldPosition - edgeA.worldPosition);
+                //log::debug("distance {} , currentMinimumSeperation {}", distance, currentMinimumSeperation);
+                if (distance < currentMinimumSeperation)
+                {
+                    refEdge = edgeA.edge;
+                    incEdge = edgeB.edge;
+
+                    seperatingAxisFound = seperatingAxis;
+                    currentMinimumSeperation = distance;
                 }
-                facej++;
             }
-            facei++;
         }
 
         maximumSeperation = currentMinimumSeperation;
         return currentMinimumSeperation > 0.0f;
     }
 
+    float PhysicsStatics::GetFaceSeperation(const ConvexHull::hull_face& face, const math::mat4& faceTransform, ConvexCollider* other, const math::mat4& otherTransform)
+    {
+        if (other->GetConvexHull().getVerticesSoA().empty()) { return std::numeric_limits<float>::lowest(); }
+
+        math::vec3 seperatingAxis = math::normalize(faceTransform * math::vec4(face.normal, 0));
+        math::vec3 planePosition = faceTransform * math::vec4(face.centroid, 1);
+
+        math::vec3 worldSupportPoint;
+        GetSupportPoint(-seperatingAxis, other, otherTransform, math::transpose(math::mat3(otherTransform)), worldSupportPoint);
+
+        return math::dot(worldSupportPoint - planePosition, seperatingAxis);
+    }
+
+    bool PhysicsStatics::GetEdgeSeperation(ConvexCollider* refCollider, ConvexHull::feature_index refEdge,
+        ConvexCollider* incCollider, ConvexHull::feature_index incEdge,
+        const math::mat4& refTransform, const math::mat4& incTransform, math::vec3& seperatingAxis, float& seperation)
+    {
+        const ConvexHull& refHull = refCollider->GetConvexHull();
+        const ConvexHull& incHull = incCollider->GetConvexHull();
+
+        math::vec3 refDirection = math::normalize(math::vec3(refTransform * math::vec4(refHull.getEdgeDirection(refEdge), 0)));
+        math::vec3 incDirection = math::normalize(math::vec3(incTransform * math::vec4(incHull.getEdgeDirection(incEdge), 0)));
+
+        seperatingAxis = math::cross(refDirection, incDirection);
+
+        if (math::epsilonEqual(math::length(seperatingAxis), 0.0f, math::epsilon<float>()))
+        {
+            return false;
+        }
+
+        seperatingAxis = math::normalize(seperatingAxis);
+
+        math::vec3 refPosition = refTransform * math::vec4(refHull.getEdgeStart(refEdge), 1);
+        math::vec3 incPosition = incTransform * math::vec4(incHull.getEdgeStart(incEdge), 1);
+        math::vec3 refCentroid = refTransform * math::vec4(refCollider->GetLocalCentroid(), 1);
+
+        //make sure the axis points away from the reference collider
+        if (math::dot(seperatingAxis, refPosition - refCentroid) < 0)
+        {
+            seperatingAxis = -seperatingAxis;
+        }
+
+        seperation = math::dot(seperatingAxis, incPosition - refPosition);
+        return true;
+    }
+
+    float PhysicsStatics::GetSeperationOnAxis(ConvexCollider* convexA, ConvexCollider* convexB,
+        const math::mat4& transformA, const math::mat4& transformB, const math::vec3& axis)
+    {
+        if (convexA->GetConvexHull().getVerticesSoA().empty() || convexB->GetConvexHull().getVerticesSoA().empty())
+        {
+            return std::numeric_limits<float>::lowest();
+        }
+
+        math::vec3 supportA, supportB;
+        GetSupportPoint(axis, convexA, transformA, math::transpose(math::mat3(transformA)), supportA);
+        GetSupportPoint(-axis, convexB, transformB, math::transpose(math::mat3(transformB)), supportB);
+
+        return math::dot(supportB - supportA, axis);
+    }
+
     bool PhysicsStatics::DetectConvexSphereCollision(ConvexCollider* convexA, const math::mat4& transformA, math::vec3 sphereWorldPosition, float sphereRadius,
         float& maximumSeperation)
     {
@@ -180,10 +257,10 @@ namespace legion::physics
 
         //--------------------------------- check if the seperating axis one of the faces of the convex hull ----------------------------------------------//
 
-        for (auto faceA : convexA->GetHalfEdgeFaces())
+        for (const auto& faceA : convexA->GetConvexHull().getFaces())
         {
-            math::vec3 worldFaceCentroid = transformA * math::vec4(faceA->centroid, 1);
-            math::vec3 worldFaceNormal = math::normalize(transformA * math::vec4(faceA->normal, 0));
+            math::vec3 worldFaceCentroid = transformA * math::vec4(faceA.centroid, 1);
+            math::vec3 worldFaceNormal = math::normalize(transformA * math::vec4(faceA.normal, 0));
 
             float seperation = PointDistanceToPlane(worldFaceNormal, worldFaceCentroid, seperatingPlanePosition );
 
@@ -203,6 +280,1322 @@ namespace legion::physics
         return true;
     }
 
+    bool PhysicsStatics::DetectSphereSphereCollision(const world_sphere& sphereA, const world_sphere& sphereB,
+        primitive_collision_info& outCollisionInfo)
+    {
+        const math::vec3 aToB = sphereB.center - sphereA.center;
+        const float radiusSum = sphereA.radius + sphereB.radius;
+        const float distance2 = math::length2(aToB);
+
+        if (distance2 > radiusSum * radiusSum) { return false; }
+
+        const float distance = math::sqrt(distance2);
+
+        //spheres with the same center can be pushed apart in any direction
+        const math::vec3 normal = distance > math::epsilon<float>() ? aToB / distance : math::vec3(0.0f, 1.0f, 0.0f);
+
+        outCollisionInfo.normal = normal;
+        outCollisionInfo.seperation = distance - radiusSum;
+        outCollisionInfo.addContact(sphereA.center + normal * sphereA.radius, sphereB.center - normal * sphereB.radius);
+
+        return true;
+    }
+
+    bool PhysicsStatics::DetectSphereCapsuleCollision(const world_sphere& sphere, const world_capsule& capsule,
+        primitive_collision_info& outCollisionInfo)
+    {
+        const math::vec3 segment = capsule.end - capsule.start;
+        const float segmentLength2 = math::length2(segment);
+
+        const float interpolant = segmentLength2 > math::epsilon<float>() ?
+            math::clamp(math::dot(sphere.center - capsule.start, segment) / segmentLength2, 0.0f, 1.0f) : 0.0f;
+
+        //the capsule is the sphere around the point on its segment that is the closest to the center of the sphere
+        return DetectSphereSphereCollision(sphere, world_sphere{ capsule.start + segment * interpolant, capsule.radius }, outCollisionInfo);
+    }
+
+    bool PhysicsStatics::DetectSphereBoxCollision(const world_sphere& sphere, const world_box& box,
+        primitive_collision_info& outCollisionInfo)
+    {
+        const math::vec3 boxToSphere = sphere.center - box.center;
+
+        math::vec3 localCenter;
+        bool isCenterInside = true;
+
+        for (int i = 0; i < 3; i++)
+        {
+            localCenter[i] = math::dot(boxToSphere, box.axes[i]);
+            isCenterInside &= math::abs(localCenter[i]) <= box.halfExtents[i];
+        }
+
+        if (!isCenterInside)
+        {
+            //------------------------ the closest point on the box is the center of the sphere clamped to the box ------------------------//
+
+            math::vec3 closestOnBox = box.center;
+            for (int i = 0; i < 3; i++)
+            {
+                closestOnBox += box.axes[i] * math::clamp(localCenter[i], -box.halfExtents[i], box.halfExtents[i]);
+            }
+
+            const math::vec3 sphereToBox = closestOnBox - sphere.center;
+            const float distance2 = math::length2(sphereToBox);
+
+            if (distance2 > sphere.radius * sphere.radius) { return false; }
+
+            const float distance = math::sqrt(distance2);
+
+            if (distance > math::epsilon<float>())
+            {
+                const math::vec3 normal = sphereToBox / distance;
+
+                outCollisionInfo.normal = normal;
+                outCollisionInfo.seperation = distance - sphere.radius;
+                outCollisionInfo.addContact(sphere.center + normal * sphere.radius, closestOnBox);
+
+                return true;
+            }
+        }
+
+        //------------------------ the center is inside the box, push the sphere out through the closest face ------------------------//
+
+        int closestAxis = 0;
+        float closestFaceDistance = box.halfExtents[0] - math::abs(localCenter[0]);
+
+        for (int i = 1; i < 3; i++)
+        {
+            const float faceDistance = box.halfExtents[i] - math::abs(localCenter[i]);
+            if (faceDistance < closestFaceDistance)
+            {
+                closestFaceDistance = faceDistance;
+                closestAxis = i;
+            }
+        }
+
+        const math::vec3 faceNormal = localCenter[closestAxis] < 0.0f ? -box.axes[closestAxis] : box.axes[closestAxis];
+
+        outCollisionInfo.normal = -faceNormal;
+        outCollisionInfo.seperation = -closestFaceDistance - sphere.radius;
+        outCollisionInfo.addContact(sphere.center - faceNormal * sphere.radius, sphere.center + faceNormal * closestFaceDistance);
+
+        return true;
+    }
+
+    bool PhysicsStatics::DetectCapsuleCapsuleCollision(const world_capsule& capsuleA, const world_capsule& capsuleB,
+        primitive_collision_info& outCollisionInfo)
+    {
+        float interpolantA, interpolantB;
+        math::vec3 closestA, closestB;
+        FindClosestPointsBetweenSegments(capsuleA.start, capsuleA.end, capsuleB.start, capsuleB.end,
+            interpolantA, interpolantB, closestA, closestB);
+
+        const math::vec3 aToB = closestB - closestA;
+        const float radiusSum = capsuleA.radius + capsuleB.radius;
+        const float distance2 = math::length2(aToB);
+
+        if (distance2 > radiusSum * radiusSum) { return false; }
+
+        const float distance = math::sqrt(distance2);
+
+        const math::vec3 segmentA = capsuleA.end - capsuleA.start;
+        const math::vec3 segmentB = capsuleB.end - capsuleB.start;
+        const float segmentLengthA2 = math::length2(segmentA);
+        const float segmentLengthB2 = math::length2(segmentB);
+        const math::vec3 segmentCross = math::cross(segmentA, segmentB);
+
+        math::vec3 normal;
+        if (distance > math::epsilon<float>())
+        {
+            normal = aToB / distance;
+        }
+        else
+        {
+            //the segments intersect, push the capsules apart perpendicular to both segments
+            if (math::length2(segmentCross) > math::epsilon<float>())
+            {
+                normal = math::normalize(segmentCross);
+            }
+            else
+            {
+                normal = math::cross(segmentA, math::vec3(1.0f, 0.0f, 0.0f));
+                if (math::length2(normal) < math::epsilon<float>())
+                {
+                    normal = math::cross(segmentA, math::vec3(0.0f, 1.0f, 0.0f));
+                }
+
+                normal = math::length2(normal) > math::epsilon<float>() ? math::normalize(normal) : math::vec3(0.0f, 1.0f, 0.0f);
+            }
+
+            const math::vec3 centerA = (capsuleA.start + capsuleA.end) * 0.5f;
+            const math::vec3 centerB = (capsuleB.start + capsuleB.end) * 0.5f;
+            if (math::dot(normal, centerB - centerA) < 0.0f) { normal = -normal; }
+        }
+
+        outCollisionInfo.normal = normal;
+        outCollisionInfo.seperation = distance - radiusSum;
+
+        //---------------- parallel capsules only touch at a single point when they do not overlap along their segments ----------------//
+
+        static constexpr float parallelTolerance = 0.0001f;
+
+        if (segmentLengthA2 > math::epsilon<float>() && segmentLengthB2 > math::epsilon<float>()
+            && math::length2(segmentCross) < parallelTolerance * segmentLengthA2 * segmentLengthB2)
+        {
+            //project the segment of B on the segment of A to find their overlap
+            const float startInterpolant = math::dot(capsuleB.start - capsuleA.start, segmentA) / segmentLengthA2;
+            const float endInterpolant = math::dot(capsuleB.end - capsuleA.start, segmentA) / segmentLengthA2;
+
+            const float overlapStart = math::clamp(math::min(startInterpolant, endInterpolant), 0.0f, 1.0f);
+            const float overlapEnd = math::clamp(math::max(startInterpolant, endInterpolant), 0.0f, 1.0f);
+
+            if ((overlapEnd - overlapStart) * (overlapEnd - overlapStart) * segmentLengthA2 > constants::contactOffset * constants::contactOffset)
+            {
+                for (float overlapInterpolant : { overlapStart, overlapEnd })
+                {
+                    const math::vec3 pointOnA = capsuleA.start + segmentA * overlapInterpolant;
+                    const float interpolantOnB = math::clamp(math::dot(pointOnA - capsuleB.start, segmentB) / segmentLengthB2, 0.0f, 1.0f);
+                    const math::vec3 pointOnB = capsuleB.start + segmentB * interpolantOnB;
+
+                    outCollisionInfo.addContact(pointOnA + normal * capsuleA.radius, pointOnB - normal * capsuleB.radius);
+                }
+
+                return true;
+            }
+        }
+
+        outCollisionInfo.addContact(closestA + normal * capsuleA.radius, closestB - normal * capsuleB.radius);
+
+        return true;
+    }
+
+    bool PhysicsStatics::DetectBoxBoxCollision(const world_box& boxA, const world_box& boxB,
+        primitive_collision_info& outCollisionInfo)
+    {
+        OPTICK_EVENT();
+        //the epsilon keeps the cross products of nearly parallel edges from creating a false seperating axis
+        static constexpr float parallelEpsilon = 0.000001f;
+
+        const math::vec3 aToB = boxB.center - boxA.center;
+
+        //the axes of B in the space of A
+        float absRotation[3][3];
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                absRotation[i][j] = math::abs(math::dot(boxA.axes[i], boxB.axes[j])) + parallelEpsilon;
+            }
+        }
+
+        //------------------------------------------------ Check the face normals of A ------------------------------------------------//
+
+        float faceSeperationA = std::numeric_limits<float>::lowest();
+        int faceAxisA = 0;
+
+        for (int i = 0; i < 3; i++)
+        {
+            const float projectedB = boxB.halfExtents.x * absRotation[i][0]
+                + boxB.halfExtents.y * absRotation[i][1] + boxB.halfExtents.z * absRotation[i][2];
+
+            const float seperation = math::abs(math::dot(aToB, boxA.axes[i])) - (boxA.halfExtents[i] + projectedB);
+            if (seperation > 0.0f) { return false; }
+
+            if (seperation > faceSeperationA)
+            {
+                faceSeperationA = seperation;
+                faceAxisA = i;
+            }
+        }
+
+        //------------------------------------------------ Check the face normals of B ------------------------------------------------//
+
+        float faceSeperationB = std::numeric_limits<float>::lowest();
+        int faceAxisB = 0;
+
+        for (int j = 0; j < 3; j++)
+        {
+            const float projectedA = boxA.halfExtents.x * absRotation[0][j]
+                + boxA.halfExtents.y * absRotation[1][j] + boxA.halfExtents.z * absRotation[2][j];
+
+            const float seperation = math::abs(math::dot(aToB, boxB.axes[j])) - (boxB.halfExtents[j] + projectedA);
+            if (seperation > 0.0f) { return false; }
+
+            if (seperation > faceSeperationB)
+            {
+                faceSeperationB = seperation;
+                faceAxisB = j;
+            }
+        }
+
+        //---------------------------------------- Check the cross products of the edges of A and B ----------------------------------------//
+
+        float edgeSeperation = std::numeric_limits<float>::lowest();
+        int edgeAxisA = -1;
+        int edgeAxisB = -1;
+        math::vec3 edgeNormal;
+
+        for (int i = 0; i < 3; i++)
+        {
+            for (int j = 0; j < 3; j++)
+            {
+                math::vec3 axis = math::cross(boxA.axes[i], boxB.axes[j]);
+                const float axisLength = math::length(axis);
+
+                //parallel edges are already covered by the face normals
+                if (axisLength < 0.001f) { continue; }
+                axis /= axisLength;
+
+                float projectedA = 0.0f;
+                float projectedB = 0.0f;
+                for (int k = 0; k < 3; k++)
+                {
+                    projectedA += boxA.halfExtents[k] * math::abs(math::dot(boxA.axes[k], axis));
+                    projectedB += boxB.halfExtents[k] * math::abs(math::dot(boxB.axes[k], axis));
+                }
+
+                const float seperation = math::abs(math::dot(aToB, axis)) - (projectedA + projectedB);
+                if (seperation > 0.0f) { return false; }
+
+                if (seperation > edgeSeperation)
+                {
+                    edgeSeperation = seperation;
+                    edgeAxisA = i;
+                    edgeAxisB = j;
+                    edgeNormal = axis;
+                }
+            }
+        }
+
+        //------------------------------- Choose the axis of least penetration, face contacts are preferred -------------------------------//
+
+        const bool isARef = faceSeperationA + constants::faceToFacePenetrationBias > faceSeperationB;
+        const float faceSeperation = isARef ? faceSeperationA : faceSeperationB;
+
+        if (edgeAxisA != -1 && edgeSeperation > faceSeperation + constants::faceToEdgePenetrationBias)
+        {
+            //--------------------------- the closest points between the 2 edges that create the axis are the contact -----------------------//
+
+            if (math::dot(edgeNormal, aToB) < 0.0f) { edgeNormal = -edgeNormal; }
+
+            //the edge of A that is the furthest along the normal and the edge of B that is the furthest against it
+            math::vec3 edgeCenterA = boxA.center;
+            math::vec3 edgeCenterB = boxB.center;
+
+            for (int k = 0; k < 3; k++)
+            {
+                if (k != edgeAxisA)
+                {
+                    edgeCenterA += boxA.axes[k] * (math::dot(boxA.axes[k], edgeNormal) > 0.0f ? boxA.halfExtents[k] : -boxA.halfExtents[k]);
+                }
+
+                if (k != edgeAxisB)
+                {
+                    edgeCenterB += boxB.axes[k] * (math::dot(boxB.axes[k], edgeNormal) > 0.0f ? -boxB.halfExtents[k] : boxB.halfExtents[k]);
+                }
+            }
+
+            const math::vec3 edgeExtentA = boxA.axes[edgeAxisA] * boxA.halfExtents[edgeAxisA];
+            const math::vec3 edgeExtentB = boxB.axes[edgeAxisB] * boxB.halfExtents[edgeAxisB];
+
+            float interpolantA, interpolantB;
+            math::vec3 closestA, closestB;
+            FindClosestPointsBetweenSegments(edgeCenterA - edgeExtentA, edgeCenterA + edgeExtentA,
+                edgeCenterB - edgeExtentB, edgeCenterB + edgeExtentB, interpolantA, interpolantB, closestA, closestB);
+
+            outCollisionInfo.normal = edgeNormal;
+            outCollisionInfo.seperation = edgeSeperation;
+            outCollisionInfo.addContact(closestA, closestB);
+
+            return true;
+        }
+
+        //---------------------------- clip the incident face against the side planes of the reference face ----------------------------//
+
+        const world_box& refBox = isARef ? boxA : boxB;
+        const world_box& incBox = isARef ? boxB : boxA;
+        const int refAxis = isARef ? faceAxisA : faceAxisB;
+
+        math::vec3 refNormal = refBox.axes[refAxis];
+        if (math::dot(refNormal, incBox.center - refBox.center) < 0.0f) { refNormal = -refNormal; }
+
+        //the incident face is the face of the incident box that is the most anti-parallel to the reference face
+        int incAxis = 0;
+        float incAlignment = 0.0f;
+        for (int k = 0; k < 3; k++)
+        {
+            const float alignment = math::abs(math::dot(incBox.axes[k], refNormal));
+            if (alignment > incAlignment)
+            {
+                incAlignment = alignment;
+                incAxis = k;
+            }
+        }
+
+        const math::vec3 incNormal = math::dot(incBox.axes[incAxis], refNormal) > 0.0f ? -incBox.axes[incAxis] : incBox.axes[incAxis];
+        const math::vec3 incFaceCenter = incBox.center + incNormal * incBox.halfExtents[incAxis];
+        const math::vec3 incExtentU = incBox.axes[(incAxis + 1) % 3] * incBox.halfExtents[(incAxis + 1) % 3];
+        const math::vec3 incExtentV = incBox.axes[(incAxis + 2) % 3] * incBox.halfExtents[(incAxis + 2) % 3];
+
+        //clipping a quad against 4 planes adds at most 1 vertex per plane
+        std::array<math::vec3, primitive_collision_info::maxContacts> polygon{
+            incFaceCenter + incExtentU + incExtentV, incFaceCenter - incExtentU + incExtentV,
+            incFaceCenter - incExtentU - incExtentV, incFaceCenter + incExtentU - incExtentV };
+        size_type polygonSize = 4;
+
+        std::array<math::vec3, primitive_collision_info::maxContacts> clipped;
+
+        for (int sideIndex = 1; sideIndex < 3; sideIndex++)
+        {
+            const int sideAxis = (refAxis + sideIndex) % 3;
+
+            for (float sideSign : { 1.0f, -1.0f })
+            {
+                const math::vec3 planeNormal = refBox.axes[sideAxis] * sideSign;
+                const float planeOffset = math::dot(refBox.center, planeNormal) + refBox.halfExtents[sideAxis];
+
+                size_type clippedSize = 0;
+                for (size_type i = 0; i < polygonSize; i++)
+                {
+                    const math::vec3& current = polygon[i];
+                    const math::vec3& next = polygon[(i + 1) % polygonSize];
+
+                    const float currentDistance = math::dot(current, planeNormal) - planeOffset;
+                    const float nextDistance = math::dot(next, planeNormal) - planeOffset;
+
+                    if (currentDistance <= 0.0f)
+                    {
+                        clipped[clippedSize++] = current;
+                    }
+
+                    if ((currentDistance <= 0.0f) != (nextDistance <= 0.0f) && clippedSize < clipped.size())
+                    {
+                        clipped[clippedSize++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+                    }
+                }
+
+                polygon = clipped;
+                polygonSize = clippedSize;
+            }
+        }
+
+        //------------------------------ every clipped vertex below the reference face is a contact ------------------------------//
+
+        const math::vec3 refFaceCenter = refBox.center + refNormal * refBox.halfExtents[refAxis];
+
+        outCollisionInfo.normal = isARef ? refNormal : -refNormal;
+        outCollisionInfo.seperation = faceSeperation;
+
+        for (size_type i = 0; i < polygonSize; i++)
+        {
+            const float depth = math::dot(polygon[i] - refFaceCenter, refNormal);
+            if (depth > 0.0f) { continue; }
+
+            const math::vec3 pointOnRef = polygon[i] - refNormal * depth;
+
+            if (isARef)
+            {
+                outCollisionInfo.addContact(pointOnRef, polygon[i]);
+            }
+            else
+            {
+                outCollisionInfo.addContact(polygon[i], pointOnRef);
+            }
+        }
+
+        return outCollisionInfo.contactCount > 0;
+    }
+
+    bool PhysicsStatics::DetectCapsuleConvexCollision(const world_capsule& capsule, ConvexCollider* convex, const math::mat4& convexTransform,
+        primitive_collision_info& outCollisionInfo)
+    {
+        OPTICK_EVENT();
+        const ConvexHull& hull = convex->GetConvexHull();
+        auto& faces = hull.getFaces();
+        if (faces.empty()) { return false; }
+
+        //normals are transformed with the inverse transpose so that they stay perpendicular to the faces of non uniformly scaled hulls
+        const math::mat3 normalTransform = math::transpose(math::inverse(math::mat3(convexTransform)));
+
+        auto getWorldFace = [&](const ConvexHull::hull_face& face, math::vec3& worldNormal, math::vec3& worldCentroid)
+        {
+            worldNormal = math::normalize(normalTransform * face.normal);
+            worldCentroid = convexTransform * math::vec4(face.centroid, 1);
+        };
+
+        auto getWorldEdge = [&](ConvexHull::feature_index edge, math::vec3& edgeStart, math::vec3& edgeEnd)
+        {
+            edgeStart = convexTransform * math::vec4(hull.getEdgeStart(edge), 1);
+            edgeEnd = convexTransform * math::vec4(hull.getEdgeEnd(edge), 1);
+        };
+
+        const math::vec3 segment = capsule.end - capsule.start;
+
+        //------------------ clip the segment against the planes of all faces to find the part of the segment inside the hull ------------------//
+        //the face with the largest distance to the deepest endpoint of the segment is the face that is penetrated the least
+
+        float enterInterpolant = 0.0f;
+        float exitInterpolant = 1.0f;
+        bool isSegmentOutside = false;
+
+        const ConvexHull::hull_face* leastPenetratedFace = nullptr;
+        math::vec3 leastPenetratedNormal;
+        float maxFaceDistance = std::numeric_limits<float>::lowest();
+
+        for (const auto& face : faces)
+        {
+            math::vec3 worldNormal, worldCentroid;
+            getWorldFace(face, worldNormal, worldCentroid);
+
+            const float startDistance = math::dot(capsule.start - worldCentroid, worldNormal);
+            const float endDistance = math::dot(capsule.end - worldCentroid, worldNormal);
+
+            const float faceDistance = math::min(startDistance, endDistance);
+            if (faceDistance > maxFaceDistance)
+            {
+                maxFaceDistance = faceDistance;
+                leastPenetratedFace = &face;
+                leastPenetratedNormal = worldNormal;
+            }
+
+            if (startDistance > 0.0f && endDistance > 0.0f)
+            {
+                isSegmentOutside = true;
+            }
+            else if (startDistance > 0.0f)
+            {
+                enterInterpolant = math::max(enterInterpolant, startDistance / (startDistance - endDistance));
+            }
+            else if (endDistance > 0.0f)
+            {
+                exitInterpolant = math::min(exitInterpolant, startDistance / (startDistance - endDistance));
+            }
+        }
+
+        //the whole capsule is in front of a face, so the face seperates the shapes
+        if (maxFaceDistance > capsule.radius) { return false; }
+
+        isSegmentOutside |= enterInterpolant > exitInterpolant;
+
+        math::vec3 normal;
+
+        if (isSegmentOutside)
+        {
+            //------------------- the segment is outside the hull, find the closest points between the segment and the hull -------------------//
+
+            float closestDistance2 = std::numeric_limits<float>::max();
+            math::vec3 closestOnSegment, closestOnHull;
+
+            for (ConvexHull::feature_index edge : hull.getUniqueEdges())
+            {
+                math::vec3 edgeStart, edgeEnd;
+                getWorldEdge(edge, edgeStart, edgeEnd);
+
+                float segmentInterpolant, edgeInterpolant;
+                math::vec3 onSegment, onEdge;
+                FindClosestPointsBetweenSegments(capsule.start, capsule.end, edgeStart, edgeEnd,
+                    segmentInterpolant, edgeInterpolant, onSegment, onEdge);
+
+                const float distance2 = math::length2(onEdge - onSegment);
+                if (distance2 < closestDistance2)
+                {
+                    closestDistance2 = distance2;
+                    closestOnSegment = onSegment;
+                    closestOnHull = onEdge;
+                }
+            }
+
+            //the closest point can also be the projection of an endpoint of the segment on the inside of a face
+            for (const auto& face : faces)
+            {
+                math::vec3 worldNormal, worldCentroid;
+                getWorldFace(face, worldNormal, worldCentroid);
+
+                for (const math::vec3& endpoint : { capsule.start, capsule.end })
+                {
+                    const float distance = math::dot(endpoint - worldCentroid, worldNormal);
+                    if (distance <= 0.0f || distance * distance >= closestDistance2) { continue; }
+
+                    const math::vec3 projected = endpoint - worldNormal * distance;
+
+                    //the projection is inside the face when it is on the same side of every edge
+                    bool hasPositiveSide = false;
+                    bool hasNegativeSide = false;
+                    for (size_type edge = face.firstEdge; edge < face.firstEdge + face.edgeCount; edge++)
+                    {
+                        math::vec3 edgeStart, edgeEnd;
+                        getWorldEdge(static_cast<ConvexHull::feature_index>(edge), edgeStart, edgeEnd);
+
+                        const float side = math::dot(math::cross(edgeEnd - edgeStart, worldNormal), projected - edgeStart);
+                        hasPositiveSide |= side > math::epsilon<float>();
+                        hasNegativeSide |= side < -math::epsilon<float>();
+                    }
+
+                    if (hasPositiveSide && hasNegativeSide) { continue; }
+
+                    closestDistance2 = distance * distance;
+                    closestOnSegment = endpoint;
+                    closestOnHull = projected;
+                }
+            }
+
+            if (closestDistance2 > capsule.radius * capsule.radius) { return false; }
+
+            const float distance = math::sqrt(closestDistance2);
+
+            if (distance > math::epsilon<float>())
+            {
+                normal = (closestOnHull - closestOnSegment) / distance;
+
+                outCollisionInfo.seperation = distance - capsule.radius;
+                outCollisionInfo.addContact(closestOnSegment + normal * capsule.radius, closestOnHull);
+            }
+            else
+            {
+                //the segment touches the surface of the hull
+                normal = -leastPenetratedNormal;
+
+                outCollisionInfo.seperation = -capsule.radius;
+                outCollisionInfo.addContact(closestOnSegment + normal * capsule.radius, closestOnSegment);
+            }
+        }
+        else
+        {
+            //-------------- the segment is inside the hull, push it out through the face that it penetrates the least --------------//
+
+            normal = -leastPenetratedNormal;
+
+            math::vec3 worldNormal, worldCentroid;
+            getWorldFace(*leastPenetratedFace, worldNormal, worldCentroid);
+
+            const math::vec3 enterPoint = capsule.start + segment * enterInterpolant;
+            const math::vec3 exitPoint = capsule.start + segment * exitInterpolant;
+            const float enterDistance = math::dot(enterPoint - worldCentroid, worldNormal);
+            const float exitDistance = math::dot(exitPoint - worldCentroid, worldNormal);
+
+            const math::vec3& deepestPoint = enterDistance < exitDistance ? enterPoint : exitPoint;
+            const float deepestDistance = math::min(enterDistance, exitDistance);
+
+            outCollisionInfo.seperation = deepestDistance - capsule.radius;
+            outCollisionInfo.addContact(deepestPoint + normal * capsule.radius, deepestPoint - worldNormal * deepestDistance);
+        }
+
+        outCollisionInfo.normal = normal;
+
+        //--------------------- a capsule lying on a face needs a contact at both ends of the part of the segment above the face ---------------------//
+
+        static constexpr float faceAlignmentTolerance = 0.01f;
+
+        if (math::length2(segment) < math::epsilon<float>()) { return true; }
+
+        const ConvexHull::hull_face* alignedFace = nullptr;
+        math::vec3 alignedNormal, alignedCentroid;
+
+        for (const auto& face : faces)
+        {
+            math::vec3 worldNormal, worldCentroid;
+            getWorldFace(face, worldNormal, worldCentroid);
+
+            if (math::dot(worldNormal, -normal) > 1.0f - faceAlignmentTolerance)
+            {
+                alignedFace = &face;
+                alignedNormal = worldNormal;
+                alignedCentroid = worldCentroid;
+                break;
+            }
+        }
+
+        if (!alignedFace) { return true; }
+
+        float sideEnterInterpolant = 0.0f;
+        float sideExitInterpolant = 1.0f;
+
+        for (size_type edge = alignedFace->firstEdge; edge < alignedFace->firstEdge + alignedFace->edgeCount; edge++)
+        {
+            math::vec3 edgeStart, edgeEnd;
+            getWorldEdge(static_cast<ConvexHull::feature_index>(edge), edgeStart, edgeEnd);
+
+            math::vec3 sideNormal = math::cross(edgeEnd - edgeStart, alignedNormal);
+            if (math::dot(sideNormal, alignedCentroid - edgeStart) > 0.0f) { sideNormal = -sideNormal; }
+
+            const float startDistance = math::dot(capsule.start - edgeStart, sideNormal);
+            const float endDistance = math::dot(capsule.end - edgeStart, sideNormal);
+
+            if (startDistance > 0.0f && endDistance > 0.0f)
+            {
+                sideEnterInterpolant = 1.0f;
+                sideExitInterpolant = 0.0f;
+            }
+            else if (startDistance > 0.0f)
+            {
+                sideEnterInterpolant = math::max(sideEnterInterpolant, startDistance / (startDistance - endDistance));
+            }
+            else if (endDistance > 0.0f)
+            {
+                sideExitInterpolant = math::min(sideExitInterpolant, startDistance / (startDistance - endDistance));
+            }
+        }
+
+        if ((sideExitInterpolant - sideEnterInterpolant) * (sideExitInterpolant - sideEnterInterpolant) * math::length2(segment)
+            < constants::contactOffset * constants::contactOffset)
+        {
+            return true;
+        }
+
+        primitive_collision_info faceCollisionInfo;
+        faceCollisionInfo.normal = -alignedNormal;
+        //the closest points can be just past the sides of the face, so the contacts never make the seperation less deep
+        faceCollisionInfo.seperation = outCollisionInfo.seperation;
+
+        for (float interpolant : { sideEnterInterpolant, sideExitInterpolant })
+        {
+            const math::vec3 pointOnSegment = capsule.start + segment * interpolant;
+            const float distance = math::dot(pointOnSegment - alignedCentroid, alignedNormal);
+            if (distance > capsule.radius) { continue; }
+
+            faceCollisionInfo.seperation = math::min(faceCollisionInfo.seperation, distance - capsule.radius);
+            faceCollisionInfo.addContact(pointOnSegment - alignedNormal * capsule.radius, pointOnSegment - alignedNormal * distance);
+        }
+
+        if (faceCollisionInfo.contactCount > 0)
+        {
+            outCollisionInfo = faceCollisionInfo;
+        }
+
+        return true;
+    }
+
+    void PhysicsStatics::FindClosestPointsBetweenSegments(const math::vec3& p1, const math::vec3& q1,
+        const math::vec3& p2, const math::vec3& q2, float& outInterpolant1, float& outInterpolant2,
+        math::vec3& outClosest1, math::vec3& outClosest2)
+    {
+        //The closest points are L1(s) = p1 + s * d1 and L2(t) = p2 + t * d2, where L1(s) - L2(t) is perpendicular to both segments.
+        //This gives a linear system in s and t, when the solution is outside the segments the interpolants are clamped
+        //one at a time and the other interpolant is recalculated
+
+        const math::vec3 d1 = q1 - p1;
+        const math::vec3 d2 = q2 - p2;
+        const math::vec3 r = p1 - p2;
+
+        const float a = math::dot(d1, d1);
+        const float e = math::dot(d2, d2);
+        const float f = math::dot(d2, r);
+
+        float s = 0.0f;
+        float t = 0.0f;
+
+        if (a <= math::epsilon<float>() && e <= math::epsilon<float>())
+        {
+            //both segments are points
+        }
+        else if (a <= math::epsilon<float>())
+        {
+            t = math::clamp(f / e, 0.0f, 1.0f);
+        }
+        else
+        {
+            const float c = math::dot(d1, r);
+
+            if (e <= math::epsilon<float>())
+            {
+                s = math::clamp(-c / a, 0.0f, 1.0f);
+            }
+            else
+            {
+                const float b = math::dot(d1, d2);
+                const float denominator = a * e - b * b;
+
+                //parallel segments have infinite solutions, any s is valid
+                s = denominator > math::epsilon<float>() ? math::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+                t = (b * s + f) / e;
+
+                if (t < 0.0f)
+                {
+                    t = 0.0f;
+                    s = math::clamp(-c / a, 0.0f, 1.0f);
+                }
+                else if (t > 1.0f)
+                {
+                    t = 1.0f;
+                    s = math::clamp((b - c) / a, 0.0f, 1.0f);
+                }
+            }
+        }
+
+        outInterpolant1 = s;
+        outInterpolant2 = t;
+        outClosest1 = p1 + d1 * s;
+        outClosest2 = p2 + d2 * t;
+    }
+
+    bool PhysicsStatics::RaycastSphere(const world_sphere& sphere, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal)
+    {
+        //solves |origin + t * direction - center|^2 = radius^2 for t
+        const math::vec3 m = origin - sphere.center;
+        const float b = math::dot(m, direction);
+        const float c = math::dot(m, m) - sphere.radius * sphere.radius;
+
+        if (c <= 0.0f)
+        {
+            outDistance = 0.0f;
+            outNormal = -direction;
+            return true;
+        }
+
+        //the origin is outside the sphere and the ray points away from it
+        if (b > 0.0f) { return false; }
+
+        const float discriminant = b * b - c;
+        if (discriminant < 0.0f) { return false; }
+
+        const float t = -b - math::sqrt(discriminant);
+        if (t > maxDistance) { return false; }
+
+        outDistance = t;
+        outNormal = math::normalize(m + direction * t);
+        return true;
+    }
+
+    bool PhysicsStatics::RaycastCapsule(const world_capsule& capsule, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal)
+    {
+        const math::vec3 segment = capsule.end - capsule.start;
+        const float segmentLength2 = math::dot(segment, segment);
+
+        if (segmentLength2 <= math::epsilon<float>())
+        {
+            return RaycastSphere(world_sphere{ capsule.start, capsule.radius }, origin, direction, maxDistance, outDistance, outNormal);
+        }
+
+        const math::vec3 startToOrigin = origin - capsule.start;
+        const float originInterpolant = math::clamp(math::dot(startToOrigin, segment) / segmentLength2, 0.0f, 1.0f);
+        const math::vec3 originToSegment = startToOrigin - segment * originInterpolant;
+
+        if (math::dot(originToSegment, originToSegment) <= capsule.radius * capsule.radius)
+        {
+            outDistance = 0.0f;
+            outNormal = -direction;
+            return true;
+        }
+
+        //intersect the infinite cylinder around the segment, the hit is only valid when it lies between the ends of the segment
+        const float segmentDotDirection = math::dot(segment, direction);
+        const float segmentDotOrigin = math::dot(segment, startToOrigin);
+        const float directionDotOrigin = math::dot(direction, startToOrigin);
+
+        const float a = segmentLength2 - segmentDotDirection * segmentDotDirection;
+        const float b = segmentLength2 * directionDotOrigin - segmentDotOrigin * segmentDotDirection;
+        const float c = segmentLength2 * math::dot(startToOrigin, startToOrigin) - segmentDotOrigin * segmentDotOrigin
+            - capsule.radius * capsule.radius * segmentLength2;
+
+        const float discriminant = b * b - a * c;
+
+        if (a > math::epsilon<float>() && discriminant >= 0.0f)
+        {
+            const float t = (-b - math::sqrt(discriminant)) / a;
+            const float y = segmentDotOrigin + t * segmentDotDirection;
+
+            if (t >= 0.0f && y > 0.0f && y < segmentLength2)
+            {
+                if (t > maxDistance) { return false; }
+
+                outDistance = t;
+                outNormal = math::normalize(startToOrigin + direction * t - segment * (y / segmentLength2));
+                return true;
+            }
+        }
+
+        //the cylinder was missed, so the ray can only hit the spheres at the ends
+        float startDistance, endDistance;
+        math::vec3 startNormal, endNormal;
+        const bool hitStart = RaycastSphere(world_sphere{ capsule.start, capsule.radius }, origin, direction, maxDistance, startDistance, startNormal);
+        const bool hitEnd = RaycastSphere(world_sphere{ capsule.end, capsule.radius }, origin, direction, maxDistance, endDistance, endNormal);
+
+        if (hitStart && (!hitEnd || startDistance <= endDistance))
+        {
+            outDistance = startDistance;
+            outNormal = startNormal;
+            return true;
+        }
+
+        if (hitEnd)
+        {
+            outDistance = endDistance;
+            outNormal = endNormal;
+            return true;
+        }
+
+        return false;
+    }
+
+    bool PhysicsStatics::RaycastBox(const world_box& box, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+        float& outDistance, math::vec3& outNormal)
+    {
+        const math::vec3 centerToOrigin = origin - box.center;
+
+        float entry = 0.0f;
+        float exit = maxDistance;
+        int entryAxis = -1;
+        float entrySign = 1.0f;
+
+        for (int i = 0; i < 3; i++)
+        {
+            const float localOrigin = math::dot(centerToOrigin, box.axes[i]);
+            const float localDirection = math::dot(direction, box.axes[i]);
+
+            if (math::abs(localDirection) <= math::epsilon<float>())
+            {
+                //the ray is parallel to the slab, so it has to start within it
+                if (math::abs(localOrigin) > box.halfExtents[i]) { return false; }
+                continue;
+            }
+
+            const float inverseDirection = 1.0f / localDirection;
+            float near = (-box.halfExtents[i] - localOrigin) * inverseDirection;
+            float far = (box.halfExtents[i] - localOrigin) * inverseDirection;
+            //the ray enters the slab through the negative side when it moves in the positive direction
+            float sign = -1.0f;
+
+            if (near > far)
+            {
+                std::swap(near, far);
+                sign = 1.0f;
+            }
+
+            if (near > entry)
+            {
+                entry = near;
+                entryAxis = i;
+                entrySign = sign;
+            }
+
+            exit = math::min(exit, far);
+
+            if (entry > exit) { return false; }
+        }
+
+        outDistance = entry;
+        outNormal = entryAxis == -1 ? -direction : box.axes[entryAxis] * entrySign;
+        return true;
+    }
+
+    bool PhysicsStatics::RaycastConvex(const ConvexCollider* convex, const math::mat4& convexTransform, const math::vec3& origin,
+        const math::vec3& direction, float maxDistance, float& outDistance, math::vec3& outNormal)
+    {
+        OPTICK_EVENT();
+        const auto& faces = convex->GetConvexHull().getFaces();
+        if (faces.empty()) { return false; }
+
+        //the ray is moved into the local space of the hull, the interpolant along the ray is the same in both spaces
+        //because the direction is transformed without being normalized
+        const math::mat4 inverseTransform = math::inverse(convexTransform);
+        const math::vec3 localOrigin = inverseTransform * math::vec4(origin, 1);
+        const math::vec3 localDirection = inverseTransform * math::vec4(direction, 0);
+
+        float entry = 0.0f;
+        float exit = maxDistance;
+        const ConvexHull::hull_face* entryFace = nullptr;
+
+        for (const auto& face : faces)
+        {
+            const float distance = math::dot(face.normal, localOrigin - face.centroid);
+            const float denominator = math::dot(face.normal, localDirection);
+
+            if (math::abs(denominator) <= math::epsilon<float>())
+            {
+                //the ray is parallel to the face, so it misses the hull when it starts above the face
+                if (distance > 0.0f) { return false; }
+                continue;
+            }
+
+            const float t = -distance / denominator;
+
+            if (denominator < 0.0f)
+            {
+                if (t > entry)
+                {
+                    entry = t;
+                    entryFace = &face;
+                }
+            }
+            else
+            {
+                exit = math::min(exit, t);
+            }
+
+            if (entry > exit) { return false; }
+        }
+
+        outDistance = entry;
+
+        if (!entryFace)
+        {
+            outNormal = -direction;
+            return true;
+        }
+
+        //normals are transformed with the inverse transpose so that they stay perpendicular to non uniformly scaled faces
+        outNormal = math::normalize(math::transpose(math::mat3(inverseTransform)) * entryFace->normal);
+        return true;
+    }
+
+    namespace
+    {
+        /**@brief A simplex of the minkowski difference B - A that is used by the shape casts.
+         * Every vertex stores the support points on both shapes so that the point of the hit can be found.
+         */
+        struct cast_simplex
+        {
+            std::array<math::vec3, 4> pointsOnA;
+            std::array<math::vec3, 4> pointsOnB;
+            std::array<float, 4> weights;
+            int count = 0;
+
+            void remove(int index)
+            {
+                --count;
+                pointsOnA[index] = pointsOnA[count];
+                pointsOnB[index] = pointsOnB[count];
+                weights[index] = weights[count];
+            }
+        };
+
+        /**@brief Finds the barycentric coordinates of the point on the triangle abc that is closest to the origin.
+         */
+        math::vec3 closestBarycentricOnTriangle(const math::vec3& a, const math::vec3& b, const math::vec3& c)
+        {
+            //voronoi region tests of Ericson, Real-Time Collision Detection 5.1.5 with p at the origin
+            const math::vec3 ab = b - a;
+            const math::vec3 ac = c - a;
+
+            const float d1 = math::dot(ab, -a);
+            const float d2 = math::dot(ac, -a);
+            if (d1 <= 0.0f && d2 <= 0.0f) { return math::vec3(1.0f, 0.0f, 0.0f); }
+
+            const float d3 = math::dot(ab, -b);
+            const float d4 = math::dot(ac, -b);
+            if (d3 >= 0.0f && d4 <= d3) { return math::vec3(0.0f, 1.0f, 0.0f); }
+
+            const float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+            {
+                const float v = d1 / (d1 - d3);
+                return math::vec3(1.0f - v, v, 0.0f);
+            }
+
+            const float d5 = math::dot(ab, -c);
+            const float d6 = math::dot(ac, -c);
+            if (d6 >= 0.0f && d5 <= d6) { return math::vec3(0.0f, 0.0f, 1.0f); }
+
+            const float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+            {
+                const float w = d2 / (d2 - d6);
+                return math::vec3(1.0f - w, 0.0f, w);
+            }
+
+            const float va = d3 * d6 - d5 * d4;
+            if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+            {
+                const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                return math::vec3(0.0f, 1.0f - w, w);
+            }
+
+            const float sum = va + vb + vc;
+            if (sum <= math::epsilon<float>())
+            {
+                //degenerate triangle, the closest point lies on one of the edges which were all tested above
+                return math::vec3(1.0f, 0.0f, 0.0f);
+            }
+
+            const float v = vb / sum;
+            const float w = vc / sum;
+            return math::vec3(1.0f - v - w, v, w);
+        }
+
+        /**@brief Finds the point of the simplex that is closest to the origin and removes the vertices that are not needed
+         * to express it. The vertices of the simplex are given relative to the current point on the ray.
+         */
+        math::vec3 reduceSimplex(cast_simplex& simplex, const math::vec3& rayPoint)
+        {
+            std::array<math::vec3, 4> vertices;
+            for (int i = 0; i < simplex.count; i++)
+            {
+                vertices[i] = rayPoint - (simplex.pointsOnB[i] - simplex.pointsOnA[i]);
+            }
+
+            switch (simplex.count)
+            {
+            case 1:
+                simplex.weights[0] = 1.0f;
+                break;
+            case 2:
+            {
+                const math::vec3 edge = vertices[1] - vertices[0];
+                const float length2 = math::dot(edge, edge);
+                const float t = length2 > math::epsilon<float>() ? math::clamp(-math::dot(vertices[0], edge) / length2, 0.0f, 1.0f) : 0.0f;
+                simplex.weights[0] = 1.0f - t;
+                simplex.weights[1] = t;
+                break;
+            }
+            case 3:
+            {
+                const math::vec3 barycentric = closestBarycentricOnTriangle(vertices[0], vertices[1], vertices[2]);
+                for (int i = 0; i < 3; i++) { simplex.weights[i] = barycentric[i]; }
+                break;
+            }
+            case 4:
+            {
+                //the origin is either inside the tetrahedron or closest to one of the faces that it is in front of
+                static constexpr int faces[4][4] = { { 0, 1, 2, 3 }, { 0, 1, 3, 2 }, { 0, 2, 3, 1 }, { 1, 2, 3, 0 } };
+
+                float closestDistance2 = std::numeric_limits<float>::max();
+                bool isInside = true;
+
+                for (const auto& face : faces)
+                {
+                    const math::vec3& a = vertices[face[0]];
+                    const math::vec3& b = vertices[face[1]];
+                    const math::vec3& c = vertices[face[2]];
+                    const math::vec3 normal = math::cross(b - a, c - a);
+
+                    const float originSide = math::dot(-a, normal);
+                    const float oppositeSide = math::dot(vertices[face[3]] - a, normal);
+
+                    //a flat tetrahedron has no inside, so every face of it is tested
+                    const float normalLength = math::length(normal);
+                    const bool isFlat = normalLength <= math::epsilon<float>()
+                        || math::abs(oppositeSide) <= 1e-5f * normalLength * math::length(vertices[face[3]] - a);
+
+                    if (!isFlat && originSide * oppositeSide >= 0.0f) { continue; }
+
+                    isInside = false;
+                    const math::vec3 barycentric = closestBarycentricOnTriangle(a, b, c);
+                    const math::vec3 closest = a * barycentric.x + b * barycentric.y + c * barycentric.z;
+                    const float distance2 = math::dot(closest, closest);
+
+                    if (distance2 < closestDistance2)
+                    {
+                        closestDistance2 = distance2;
+                        simplex.weights[face[0]] = barycentric.x;
+                        simplex.weights[face[1]] = barycentric.y;
+                        simplex.weights[face[2]] = barycentric.z;
+                        simplex.weights[face[3]] = 0.0f;
+                    }
+                }
+
+                if (isInside)
+                {
+                    const math::mat3 edges(vertices[1] - vertices[0], vertices[2] - vertices[0], vertices[3] - vertices[0]);
+                    const math::vec3 barycentric = math::inverse(edges) * -vertices[0];
+                    simplex.weights[0] = 1.0f - barycentric.x - barycentric.y - barycentric.z;
+                    simplex.weights[1] = barycentric.x;
+                    simplex.weights[2] = barycentric.y;
+                    simplex.weights[3] = barycentric.z;
+                    return math::vec3(0.0f);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+
+            math::vec3 closest = math::vec3(0.0f);
+            for (int i = simplex.count - 1; i >= 0; i--)
+            {
+                if (simplex.weights[i] <= 0.0f)
+                {
+                    simplex.remove(i);
+                    continue;
+                }
+
+                closest += vertices[i] * simplex.weights[i];
+            }
+
+            return closest;
+        }
+
+        //cast shapes are split into a core and a radius, like round colliders, so that the distance between the cores
+        //can be found exactly with GJK
+
+        math::vec3 getCoreSupportPoint(const world_sphere& sphere, const math::vec3& direction)
+        {
+            return sphere.center;
+        }
+
+        float getCoreRadius(const world_sphere& sphere)
+        {
+            return sphere.radius;
+        }
+
+        math::vec3 getCoreSupportPoint(const world_box& box, const math::vec3& direction)
+        {
+            return box.getSupportPoint(direction);
+        }
+
+        float getCoreRadius(const world_box& box)
+        {
+            return 0.0f;
+        }
+
+        /**@brief A collider at a transform, so that colliders can be cast like the other shapes.
+         */
+        struct collider_shape
+        {
+            const PhysicsCollider* collider;
+            const math::mat4& transform;
+        };
+
+        math::vec3 getCoreSupportPoint(const collider_shape& shape, const math::vec3& direction)
+        {
+            return shape.collider->GetWorldSupportPoint(shape.transform, direction);
+        }
+
+        float getCoreRadius(const collider_shape& shape)
+        {
+            return shape.collider->GetWorldRadius(shape.transform);
+        }
+
+        /**@brief Finds the vector from the closest point of the minkowski difference of the cores of the collider and shape A
+         * to the given point with GJK. The simplex holds the features that the closest point lies on afterwards.
+         */
+        template<typename shape_type>
+        math::vec3 findMinkowskiDistance(const shape_type& shape, const PhysicsCollider* collider, const math::mat4& colliderTransform,
+            const math::vec3& point, const math::vec3& initialDirection, cast_simplex& simplex)
+        {
+            static constexpr int maxIterations = 32;
+            static constexpr float tolerance = 1e-6f;
+
+            simplex.count = 0;
+            math::vec3 v = initialDirection;
+
+            for (int iteration = 0; iteration < maxIterations; iteration++)
+            {
+                const math::vec3 pointOnB = collider->GetWorldSupportPoint(colliderTransform, v);
+                const math::vec3 pointOnA = getCoreSupportPoint(shape, -v);
+                const math::vec3 w = point - (pointOnB - pointOnA);
+
+                //the new support point does not get us any closer to the point
+                if (simplex.count > 0 && math::dot(v, v) - math::dot(v, w) <= tolerance * math::dot(v, v)) { break; }
+
+                bool isDuplicate = false;
+                for (int i = 0; i < simplex.count; i++)
+                {
+                    isDuplicate |= simplex.pointsOnA[i] == pointOnA && simplex.pointsOnB[i] == pointOnB;
+                }
+                if (isDuplicate) { break; }
+
+                simplex.pointsOnA[simplex.count] = pointOnA;
+                simplex.pointsOnB[simplex.count] = pointOnB;
+                simplex.count++;
+
+                v = reduceSimplex(simplex, point);
+
+                //the point is inside the minkowski difference
+                if (simplex.count == 4 || math::dot(v, v) <= tolerance * tolerance) { return math::vec3(0.0f); }
+            }
+
+            return v;
+        }
+
+        /**@brief Casts shape A along a direction against a collider with conservative advancement. The ray is cast from the origin
+         * against the minkowski difference of the collider and shape A, every step finds the distance between the cores of the
+         * shapes with GJK and moves along the ray up to the plane that seperates them.
+         */
+        template<typename shape_type>
+        bool castShape(const shape_type& shape, const math::vec3& shapeCenter, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint)
+        {
+            static constexpr int maxIterations = 32;
+            static constexpr float tolerance = 1e-4f;
+
+            const float colliderRadius = collider->GetWorldRadius(colliderTransform);
+            const float radius = getCoreRadius(shape) + colliderRadius;
+            const math::vec3 colliderCenter = colliderTransform * math::vec4(collider->GetLocalCentroid(), 1);
+
+            cast_simplex simplex;
+            float distance = 0.0f;
+            math::vec3 normal = -direction;
+            math::vec3 searchDirection = shapeCenter - colliderCenter;
+
+            if (math::dot(searchDirection, searchDirection) <= math::epsilon<float>())
+            {
+                searchDirection = -direction;
+            }
+
+            for (int iteration = 0; iteration <= maxIterations; iteration++)
+            {
+                if (iteration == maxIterations) { return false; }
+
+                const math::vec3 rayPoint = direction * distance;
+                const math::vec3 v = findMinkowskiDistance(shape, collider, colliderTransform, rayPoint, searchDirection, simplex);
+                const float gap = math::length(v);
+
+                if (gap > math::epsilon<float>())
+                {
+                    normal = v / gap;
+                    searchDirection = v;
+                }
+
+                //the shapes touch, when they already touched at the start the hit is at distance 0 with a normal of -direction
+                if (gap - radius <= tolerance)
+                {
+                    if (iteration == 0) { normal = -direction; }
+                    break;
+                }
+
+                //the shapes move away from each other along the seperating plane so they will never touch
+                const float approachSpeed = -math::dot(normal, direction);
+                if (approachSpeed <= 0.0f) { return false; }
+
+                distance += (gap - radius) / approachSpeed;
+                if (distance > maxDistance) { return false; }
+            }
+
+            outDistance = distance;
+            outNormal = normal;
+
+            //the point on the core of the collider is moved outwards by the radius of the collider
+            math::vec3 pointOnCore = math::vec3(0.0f);
+            float totalWeight = 0.0f;
+            for (int i = 0; i < simplex.count; i++)
+            {
+                pointOnCore += simplex.pointsOnB[i] * simplex.weights[i];
+                totalWeight += simplex.weights[i];
+            }
+
+            pointOnCore = totalWeight > math::epsilon<float>() ? pointOnCore / totalWeight
+                : collider->GetWorldSupportPoint(colliderTransform, direction);
+            outPoint = pointOnCore + outNormal * colliderRadius;
+
+            return true;
+        }
+    }
+
+    bool PhysicsStatics::SphereCast(const world_sphere& sphere, const math::vec3& direction, float maxDistance,
+        const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint)
+    {
+        OPTICK_EVENT();
+        return castShape(sphere, sphere.center, direction, maxDistance, collider, colliderTransform, outDistance, outNormal, outPoint);
+    }
+
+    bool PhysicsStatics::BoxCast(const world_box& box, const math::vec3& direction, float maxDistance,
+        const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint)
+    {
+        OPTICK_EVENT();
+        return castShape(box, box.center, direction, maxDistance, collider, colliderTransform, outDistance, outNormal, outPoint);
+    }
+
+    bool PhysicsStatics::ColliderCast(const PhysicsCollider* movingCollider, const math::mat4& movingTransform, const math::vec3& direction, float maxDistance,
+        const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint)
+    {
+        OPTICK_EVENT();
+        const math::vec3 movingCenter = movingTransform * math::vec4(movingCollider->GetLocalCentroid(), 1);
+
+        return castShape(collider_shape{ movingCollider, movingTransform }, movingCenter, direction, maxDistance,
+            collider, colliderTransform, outDistance, outNormal, outPoint);
+    }
+
     std::pair< math::vec3, math::vec3> PhysicsStatics::ConstructAABBFromPhysicsComponentWithTransform
     (ecs::component_handle<physicsComponent> physicsComponentToUse,const math::mat4& transform)
     {
@@ -1,18 +1,17 @@
 #pragma once
 #include <core/core.hpp>
 #include <physics/colliders/convexcollider.hpp>
-#include <physics/data/pointer_encapsulator.hpp>
 #include <physics/data/contact_vertex.hpp>
 #include <Voro++/voro++.hh>
 #include <rendering/debugrendering.hpp>
 #include <physics/data/convex_convex_collision_info.hpp>
+#include <physics/data/convex_hull.hpp>
+#include <physics/data/primitive_shapes.hpp>
 
 namespace legion::physics
 {
     typedef std::shared_ptr<PhysicsCollider> PhysicsColliderPtr;
 
-    struct HalfEdgeFace;
-
     class PhysicsStatics
     {
     public:
@@ -28,30 +27,35 @@ namespace legion::physics
             ConvexConvexCollisionInfo& outCollisionInfo,  physics_manifold& manifold);
 
         /** @brief Given a transformed ConvexCollider and a direction, Gets the vertex furthest in the given direction
+         * The search is done in the local space of the collider, only the direction and the resulting vertex are transformed.
          * @param planePosition The position of the support plane in world space
          * @param direction The direction we would like to know the support point of
          * @param collider The ConvexCollider in question
          * @param colliderTransform A mat4 describing the transform of the collider
          * @param worldSupportPoint [out] the resulting support point
-         * @return returns true if a seperating axis was found
          */
         static void GetSupportPoint(const math::vec3& planePosition, const math::vec3& direction, ConvexCollider* collider, const math::mat4& colliderTransform
             , math::vec3& worldSupportPoint)
         {
-            float largestDistanceInDirection = std::numeric_limits<float>::lowest();
-
-            for (const auto& vert : collider->GetVertices())
-            {
-                math::vec3 transformedVert = colliderTransform * math::vec4(vert, 1);
+            GetSupportPoint(direction, collider, colliderTransform, math::transpose(math::mat3(colliderTransform)), worldSupportPoint);
+        }
 
-                float dotResult = math::dot(transformedVert - planePosition, direction);
+        /** @brief Given a transformed ConvexCollider and a direction, Gets the vertex furthest in the given direction
+         * @param direction The world space direction we would like to know the support point of
+         * @param collider The ConvexCollider in question
+         * @param colliderTransform A mat4 describing the transform of the collider
+         * @param directionToLocal The transpose of the upper 3x3 of colliderTransform, the support point of a transformed hull
+         * is the transformed support point of the hull in the direction transformed by this matrix.
+         * @param worldSupportPoint [out] the resulting support point
+         */
+        static void GetSupportPoint(const math::vec3& direction, ConvexCollider* collider, const math::mat4& colliderTransform,
+            const math::mat3& directionToLocal, math::vec3& worldSupportPoint)
+        {
+            const ConvexHull& hull = collider->GetConvexHull();
+            if (hull.getVerticesSoA().empty()) { return; }
 
-                if (dotResult > largestDistanceInDirection)
-                {
-                    largestDistanceInDirection = dotResult;
-                    worldSupportPoint = transformedVert;
-                }
-            }
+            size_type supportIndex = hull.getVerticesSoA().getSupportIndex(directionToLocal * direction);
+            worldSupportPoint = colliderTransform * math::vec4(hull.getVertices()[supportIndex], 1);
         }
 
         /** @brief Given a ConvexCollider and a direction, Gets the vertex furthest in the given direction.
@@ -61,29 +65,11 @@ namespace legion::physics
         * @param collider The ConvexCollider in question
         * @param colliderTransform A mat4 describing the transform of the collider
         * @param worldSupportPoint [out] the resulting support point
-        * @return returns true if a seperating axis was found
         */
         static void GetSupportPointNoTransform( math::vec3 planePosition,  math::vec3 direction, ConvexCollider* collider, const math::mat4& colliderTransform
             , math::vec3& worldSupportPoint)
         {
-            float largestDistanceInDirection = std::numeric_limits<float>::lowest();
-            planePosition = math::inverse(colliderTransform) * math::vec4(planePosition, 1);
-            direction = math::inverse(colliderTransform) * math::vec4(direction, 0);
-
-            for (const auto& vert : collider->GetVertices())
-            {
-                math::vec3 transformedVert = math::vec4(vert, 1);
-
-                float dotResult = math::dot(transformedVert - planePosition, direction);
-
-                if (dotResult > largestDistanceInDirection)
-                {
-                    largestDistanceInDirection = dotResult;
-                    worldSupportPoint = transformedVert;
-                }
-            }
-
-            worldSupportPoint = colliderTransform * math::vec4(worldSupportPoint, 1);
+            GetSupportPoint(planePosition, direction, collider, colliderTransform, worldSupportPoint);
         }
 
 
@@ -97,37 +83,49 @@ namespace legion::physics
          * @param convexB the collider that will create the seperating axes
          * @param transformA the transform of convexA
          * @param transformB the transform of convexB
-         * @param refFace [out] a HalfEdgeEdge* that has a normal parallel to the seperating axis
+         * @param refFace [out] the index of the face of convexB that has a normal parallel to the seperating axis
          * @param maximumSeperation [out] the seperation on the given seperating axis
          * @return returns true if a seperating axis was found
          */
         static bool FindSeperatingAxisByExtremePointProjection(ConvexCollider* convexA
-            , ConvexCollider* convexB, const math::mat4& transformA, const math::mat4& transformB, PointerEncapsulator<HalfEdgeFace>&refFace, float& maximumSeperation,bool shouldDebug = false)
+            , ConvexCollider* convexB, const math::mat4& transformA, const math::mat4& transformB, ConvexHull::feature_index& refFace, float& maximumSeperation,bool shouldDebug = false)
         {
             //shouldDebug = false;
+            OPTICK_EVENT();
 
             float currentMaximumSeperation = std::numeric_limits<float>::lowest();
+            refFace = ConvexHull::invalid_index;
+
+            if (convexA->GetConvexHull().getVerticesSoA().empty())
+            {
+                maximumSeperation = currentMaximumSeperation;
+                return false;
+            }
 
-            for (auto face : convexB->GetHalfEdgeFaces())
+            //the support points of convexA are searched in its local space
+            const math::mat3 directionToLocalA = math::transpose(math::mat3(transformA));
+            const auto& faces = convexB->GetConvexHull().getFaces();
+
+            for (size_type faceIndex = 0; faceIndex < faces.size(); faceIndex++)
             {
+                const ConvexHull::hull_face& face = faces[faceIndex];
 
                 //log::debug("face->normal {} ", math::to_string( face->normal));
                 //get inverse normal
-                math::vec3 seperatingAxis = math::normalize(transformB * math::vec4((face->normal), 0));
+                math::vec3 seperatingAxis = math::normalize(transformB * math::vec4((face.normal), 0));
 
-                math::vec3 transformedPositionB = transformB * math::vec4(face->centroid, 1);
+                math::vec3 transformedPositionB = transformB * math::vec4(face.centroid, 1);
 
                 //get extreme point of other face in normal direction
                 math::vec3 worldSupportPoint;
-                GetSupportPoint(transformedPositionB, -seperatingAxis,
-                    convexA, transformA, worldSupportPoint);
+                GetSupportPoint(-seperatingAxis, convexA, transformA, directionToLocalA, worldSupportPoint);
 
                 float seperation = math::dot(worldSupportPoint - transformedPositionB, seperatingAxis);
 
                 if (seperation > currentMaximumSeperation)
                 {
                     currentMaximumSeperation = seperation;
-                    refFace.ptr = face;
+                    refFace = static_cast<ConvexHull::feature_index>(faceIndex);
                 }
 
                 if (seperation > 0)
@@ -143,27 +141,180 @@ namespace legion::physics
             return false;
         }
 
-        /** @brief Given 2 ConvexColliders, Goes through every single possible edge combination in order to check for a valid seperating axis. This is done
-         * by creating a minkowski face with each edge combination.
+        /** @brief Given 2 ConvexColliders, Goes through every unique edge combination in order to check for a valid seperating axis.
+         * Edge combinations that do not create a minkowski face (their arcs on the gauss map do not intersect) are skipped.
+         * The gauss map of convexB is moved into the local space of convexA, so the arc test needs no transformations per edge pair.
          * @param convexA the reference collider
          * @param convexB the incident collider
          * @param transformA the transform of convexA
          * @param transformB the transform of convexB
-         * @param refEdge [out] the resulting reference Edge
-         * @param incEdge [out] the resulting incident Edge
+         * @param refEdge [out] the index of the resulting reference half edge in the hull of convexA
+         * @param incEdge [out] the index of the resulting incident half edge in the hull of convexB
          * @param seperatingAxisFound [out] the resulting seperating axis found
          * @param seperation [out] the amount of seperation
          * @return returns true if a seperating axis was found
          */
         static bool FindSeperatingAxisByGaussMapEdgeCheck(ConvexCollider* convexA, ConvexCollider* convexB,
-            const math::mat4& transformA, const math::mat4& transformB, PointerEncapsulator<HalfEdgeEdge>& refEdge, PointerEncapsulator<HalfEdgeEdge>& incEdge,
+            const math::mat4& transformA, const math::mat4& transformB, ConvexHull::feature_index& refEdge, ConvexHull::feature_index& incEdge,
             math::vec3& seperatingAxisFound, float& maximumSeperation, bool shouldDebug = false);
+
+        /** @brief Gets the seperation between the plane of a face of a ConvexCollider and another ConvexCollider.
+         * @param face the face that creates the seperating axis
+         * @param faceTransform the transform of the collider that owns the face
+         * @param other the collider that is projected on the normal of the face
+         * @param otherTransform the transform of other
+         * @return the distance of the deepest point of other to the plane of the face, a positive value means that the face is a seperating axis
+         */
+        static float GetFaceSeperation(const ConvexHull::hull_face& face, const math::mat4& faceTransform, ConvexCollider* other, const math::mat4& otherTransform);
+
+        /** @brief Gets the seperating axis created by a single edge pair and the seperation on that axis,
+         * calculated the same way FindSeperatingAxisByGaussMapEdgeCheck does.
+         * @param refCollider the collider that owns refEdge
+         * @param refEdge the index of the reference half edge in the hull of refCollider
+         * @param incCollider the collider that owns incEdge
+         * @param incEdge the index of the incident half edge in the hull of incCollider
+         * @param refTransform the transform of refCollider
+         * @param incTransform the transform of incCollider
+         * @param seperatingAxis [out] the seperating axis, pointing away from refCollider
+         * @param seperation [out] the seperation between the edges on the seperating axis
+         * @return returns false if the edges are parallel and do not create a seperating axis
+         */
+        static bool GetEdgeSeperation(ConvexCollider* refCollider, ConvexHull::feature_index refEdge,
+            ConvexCollider* incCollider, ConvexHull::feature_index incEdge,
+            const math::mat4& refTransform, const math::mat4& incTransform, math::vec3& seperatingAxis, float& seperation);
+
+        /** @brief Projects 2 ConvexColliders on an axis and gets the gap between their projections.
+         * @param axis a normalized axis that points from convexA towards convexB
+         * @return the seperation on the axis, a positive value means that the axis seperates the colliders
+         */
+        static float GetSeperationOnAxis(ConvexCollider* convexA, ConvexCollider* convexB,
+            const math::mat4& transformA, const math::mat4& transformB, const math::vec3& axis);
       
         /** @brief Given a ConvexCollider and sphere with a position and a readius, checks if these 2 shapes are colliding
         */
         static bool DetectConvexSphereCollision(ConvexCollider* convexA, const math::mat4& transformA, math::vec3 sphereWorldPosition, float sphereRadius,
              float& maximumSeperation);
 
+        //---------------------------------------------------------- Primitive Collision Detection ----------------------------------------------------------------------------//
+
+        //The following functions are closed form tests between primitive shapes in world space. Shape A of the
+        //resulting primitive_collision_info is always the first shape that is passed to the function.
+
+        /** @brief Checks if 2 spheres are colliding by comparing the distance between their centers with the sum of their radii.
+         * @return true if the spheres collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectSphereSphereCollision(const world_sphere& sphereA, const world_sphere& sphereB,
+            primitive_collision_info& outCollisionInfo);
+
+        /** @brief Checks if a sphere and a capsule are colliding by finding the closest point on the segment of the capsule.
+         * @return true if the shapes collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectSphereCapsuleCollision(const world_sphere& sphere, const world_capsule& capsule,
+            primitive_collision_info& outCollisionInfo);
+
+        /** @brief Checks if a sphere and an oriented box are colliding by clamping the center of the sphere to the box.
+         * @return true if the shapes collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectSphereBoxCollision(const world_sphere& sphere, const world_box& box,
+            primitive_collision_info& outCollisionInfo);
+
+        /** @brief Checks if 2 capsules are colliding by finding the closest points between their segments.
+         * Parallel capsules get a contact at both ends of the overlap of their segments.
+         * @return true if the capsules collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectCapsuleCapsuleCollision(const world_capsule& capsuleA, const world_capsule& capsuleB,
+            primitive_collision_info& outCollisionInfo);
+
+        /** @brief Checks if 2 oriented boxes are colliding with the seperating axis test on the 3 face normals of both boxes
+         * and the 9 cross products of their edges. Face contacts are created by clipping the incident face against the
+         * sides of the reference face, edge contacts by finding the closest points between the 2 edges.
+         * @return true if the boxes collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectBoxBoxCollision(const world_box& boxA, const world_box& boxB,
+            primitive_collision_info& outCollisionInfo);
+
+        /** @brief Checks if a capsule and a ConvexCollider are colliding. When the segment of the capsule is outside the hull,
+         * the closest points between the segment and the faces and edges of the hull are used. Otherwise the face of the
+         * hull that the segment penetrates the least is used.
+         * @return true if the shapes collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectCapsuleConvexCollision(const world_capsule& capsule, ConvexCollider* convex, const math::mat4& convexTransform,
+            primitive_collision_info& outCollisionInfo);
+
+        /** @brief Checks if a sphere and a ConvexCollider are colliding, the sphere is treated as a capsule with a segment of length 0.
+         * @return true if the shapes collide, the result is then stored in outCollisionInfo
+         */
+        static bool DetectSphereConvexCollision(const world_sphere& sphere, ConvexCollider* convex, const math::mat4& convexTransform,
+            primitive_collision_info& outCollisionInfo)
+        {
+            return DetectCapsuleConvexCollision(world_capsule{ sphere.center, sphere.center, sphere.radius },
+                convex, convexTransform, outCollisionInfo);
+        }
+
+        /** @brief Finds the closest points between the segments p1-q1 and p2-q2, also handles segments of length 0.
+         * @param outInterpolant1 [out] The interpolant of the closest point on p1-q1
+         * @param outInterpolant2 [out] The interpolant of the closest point on p2-q2
+         * @param outClosest1 [out] The closest point on p1-q1
+         * @param outClosest2 [out] The closest point on p2-q2
+         */
+        static void FindClosestPointsBetweenSegments(const math::vec3& p1, const math::vec3& q1,
+            const math::vec3& p2, const math::vec3& q2, float& outInterpolant1, float& outInterpolant2,
+            math::vec3& outClosest1, math::vec3& outClosest2);
+
+        //---------------------------------------------------------------- Scene Queries ----------------------------------------------------------------------------//
+
+        //The following functions cast a ray or a shape against a single collider in world space. The direction is always
+        //normalized. When the ray or shape starts inside the collider the hit is at distance 0 with a normal of -direction.
+
+        /** @brief Casts a ray against a sphere.
+         * @return true if the ray hits the sphere within maxDistance, the distance and normal of the hit are then stored in the out parameters
+         */
+        static bool RaycastSphere(const world_sphere& sphere, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal);
+
+        /** @brief Casts a ray against the cylinder of a capsule, when the cylinder is missed the spheres at the ends are used.
+         * @return true if the ray hits the capsule within maxDistance, the distance and normal of the hit are then stored in the out parameters
+         */
+        static bool RaycastCapsule(const world_capsule& capsule, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal);
+
+        /** @brief Casts a ray against an oriented box with the slab test on the axes of the box.
+         * @return true if the ray hits the box within maxDistance, the distance and normal of the hit are then stored in the out parameters
+         */
+        static bool RaycastBox(const world_box& box, const math::vec3& origin, const math::vec3& direction, float maxDistance,
+            float& outDistance, math::vec3& outNormal);
+
+        /** @brief Casts a ray against a ConvexCollider by clipping the ray against the plane of every face in the local space of the hull.
+         * The face that the ray enters last is the face that was hit.
+         * @return true if the ray hits the hull within maxDistance, the distance and normal of the hit are then stored in the out parameters
+         */
+        static bool RaycastConvex(const ConvexCollider* convex, const math::mat4& convexTransform, const math::vec3& origin,
+            const math::vec3& direction, float maxDistance, float& outDistance, math::vec3& outNormal);
+
+        /** @brief Sweeps a sphere along a direction against a collider with conservative advancement, the distance between
+         * the shapes is found with GJK on the minkowski difference of the shapes.
+         * @param outPoint [out] The point on the collider that the sphere touches at the hit
+         * @return true if the sphere hits the collider within maxDistance
+         */
+        static bool SphereCast(const world_sphere& sphere, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint);
+
+        /** @brief Sweeps an oriented box along a direction against a collider with conservative advancement, the distance between
+         * the shapes is found with GJK on the minkowski difference of the shapes.
+         * @param outPoint [out] The point on the collider that the box touches at the hit
+         * @return true if the box hits the collider within maxDistance
+         */
+        static bool BoxCast(const world_box& box, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint);
+
+        /** @brief Sweeps a collider along a direction against another collider with conservative advancement, used to find the
+         * time of impact of fast moving rigidbodies. Only the translation of the moving collider is taken into account.
+         * @param outPoint [out] The point on the other collider that the moving collider touches at the hit
+         * @return true if the moving collider hits the other collider within maxDistance
+         */
+        static bool ColliderCast(const PhysicsCollider* movingCollider, const math::mat4& movingTransform, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& colliderTransform, float& outDistance, math::vec3& outNormal, math::vec3& outPoint);
+
 
         static std::pair< math::vec3,math::vec3> ConstructAABBFromPhysicsComponentWithTransform
         (ecs::component_handle<physicsComponent> physicsComponentToUse, const math::mat4& transform);
@@ -184,10 +335,10 @@ namespace legion::physics
         //---------------------------------------------------------- Polyhedron Clipping ----------------------------------------------------------------------------//
 
         /** @brief Given a 3D plane, clips the vertices in the inputList and places the results in the output list
-         *
+         * @param clippingLabel the label of the edge that the plane was created from, vertices created by the clip get a label that contains it
          */
         static void SutherlandHodgmanFaceClip( math::vec3& planeNormal, math::vec3& planePosition,
-            std::vector<ContactVertex>& inputList, std::vector<ContactVertex>& outputList, HalfEdgeEdge* clippingEdge)
+            std::vector<ContactVertex>& inputList, std::vector<ContactVertex>& outputList, const EdgeLabel& clippingLabel)
         {
             for (size_t i = 0; i < inputList.size(); i++)
             {
@@ -228,10 +379,7 @@ namespace legion::physics
                     if (FindLineToPlaneIntersectionPoint(planeNormal, planePosition,
                         pointBelowPlane, pointAbovePlane, intersectionPoint))
                     {
-                        auto currentVertexLabel = currentVertex.label;
-                        auto nextVertexLabel = clippingEdge->label;
-
-                        EdgeLabel label(currentVertexLabel.firstEdge, nextVertexLabel.nextEdge);
+                        EdgeLabel label(currentVertex.label.firstEdge, clippingLabel.nextEdge);
                         outputList.push_back(ContactVertex(intersectionPoint, label));
                     }
 
@@ -247,10 +395,7 @@ namespace legion::physics
                     if (FindLineToPlaneIntersectionPoint(planeNormal, planePosition,
                         pointBelowPlane, pointAbovePlane, intersectionPoint))
                     {
-                        auto currentVertexLabel = currentVertex.label;
-                        auto nextVertexLabel = clippingEdge->label;
-
-                        EdgeLabel label(currentVertexLabel.firstEdge, nextVertexLabel.nextEdge);
+                        EdgeLabel label(currentVertex.label.firstEdge, clippingLabel.nextEdge);
                         outputList.push_back(ContactVertex(intersectionPoint, label));
                     }
                 }
@@ -517,39 +662,6 @@ namespace legion::physics
 
     private:
 
-        /** @brief Given 2 HalfEdgeEdges and their respective transforms, transforms their normals and checks if they create a minkowski face
-         * @return returns true if a minkowski face was succesfully constructed
-         */
-        static bool attemptBuildMinkowskiFace(HalfEdgeEdge* edgeA, HalfEdgeEdge* edgeB, const math::mat4& transformA,
-            const math::mat4& transformB)
-        {
-            //TODO the commmented parts are technically more robust and should work but somehow dont, figure out why.
-
-            const math::vec3 transformedA1 = transformA *
-                math::vec4(edgeA->getLocalNormal(), 0);
-
-            const math::vec3 transformedA2 = transformA *
-                math::vec4(edgeA->pairingEdge->getLocalNormal(), 0);
-
-            const math::vec3 transformedEdgeDirectionA = math::cross(transformedA1, transformedA2);
-            //transformA * math::vec4(edgeA->getLocalEdgeDirection(), 0);
-           
-            const math::vec3 transformedB1 = transformB *
-                math::vec4(edgeB->getLocalNormal(), 0);
-
-            const math::vec3 transformedB2 = transformB *
-                math::vec4(edgeB->pairingEdge->getLocalNormal(), 0);
-
-            const math::vec3 transformedEdgeDirectionB = math::cross(-transformedB1, -transformedB2);
-            //transformB *math::vec4(edgeB->getLocalEdgeDirection(), 0);
-                
-
-            math::vec3 positionA = transformA * math::vec4(edgeA->edgePosition, 1);
-
-            return isMinkowskiFace(transformedA1, transformedA2, -transformedB1, -transformedB2
-                , transformedEdgeDirectionA, transformedEdgeDirectionB);
-        }
-
         /** @brief Given 2 arcs, one that starts from transformedA1 and ends at transformedA2 and another arc
          * that starts at transformedB1 and ends at transformedB2, checks if the given arcs collider each other
          * @return returns true if the given arcs intersect
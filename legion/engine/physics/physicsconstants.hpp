@@ -22,10 +22,18 @@ namespace legion::physics::constants
 
     static constexpr float contactOffset = 0.01f;
 
+    static constexpr float ccdAllowedPenetration = 0.02f;
+
     static constexpr float sutherlandHodgmanClippingThreshold = 0.01f;
 
     static constexpr bool applyWarmStarting = true;
 
+    static constexpr float contactMatchingTolerance = 0.02f;
+
+    static constexpr float pairCacheLinearTolerance = 0.005f;
+
+    static constexpr float pairCacheAngularTolerance = 0.0001f;
+
     static constexpr float polygonItersectionEpsilon = 0.01f;
 
     static constexpr float polygonSplitterEpsilon = 0.01f;
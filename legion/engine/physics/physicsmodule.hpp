@@ -13,12 +13,18 @@ namespace legion::physics
     class PhysicsModule : public Module
     {
 
+        bool m_runPhysicsSystem;
+
     public:
+        /**@param runPhysicsSystem Set to false when the physics is stepped by hand, for example by a PhysicsReplay.
+         */
+        PhysicsModule(bool runPhysicsSystem = true) : m_runPhysicsSystem(runPhysicsSystem) {}
 
         virtual void setup() override
         {
             addProcessChain("Physics");
-            reportSystem<PhysicsSystem>();
+            if (m_runPhysicsSystem)
+                reportSystem<PhysicsSystem>();
             reportComponentType<physicsComponent>();
             reportComponentType<rigidbody>();
             reportComponentType<identifier>();
@@ -0,0 +1,433 @@
+#include <physics/systems/physics_benchmark.hpp>
+#include <physics/components/fracturer.hpp>
+#include <physics/components/fracturecountdown.hpp>
+#include <physics/mesh_splitter_utils/mesh_splitter.hpp>
+#include <physics/physics_statics.hpp>
+#include <physics/halfedgeedge.hpp>
+#include <physics/halfedgeface.hpp>
+#include <rendering/components/renderable.hpp>
+
+#include <random>
+
+namespace legion::physics
+{
+    size_type(*PhysicsBenchmark::allocationCounter)() = nullptr;
+
+    benchmark_result PhysicsBenchmark::run(const benchmark_settings& settings)
+    {
+        OPTICK_EVENT();
+        m_bodyCount = 0;
+
+        //the replay sets up the statics of the fracturer, which the fracture storm needs while it is built
+        PhysicsReplay replay;
+
+        switch (settings.scenario)
+        {
+        case benchmark_scenario::box_pyramid:
+            buildBoxPyramid(settings.scale);
+            break;
+        case benchmark_scenario::sphere_rain:
+            buildSphereRain(settings.scale);
+            break;
+        case benchmark_scenario::debris_pile:
+            buildDebrisPile(settings.scale);
+            break;
+        case benchmark_scenario::fracture_storm:
+            buildFractureStorm(settings.scale, settings.timeStep);
+            break;
+        case benchmark_scenario::mixed_static_world:
+            buildMixedStaticWorld(settings.scale);
+            break;
+        }
+
+        replay.recordInitialState();
+
+        const size_type allocationsBefore = allocationCounter ? allocationCounter() : 0;
+        replay_result replayResult = replay.run(settings.tickCount, settings.timeStep);
+        const size_type allocationsAfter = allocationCounter ? allocationCounter() : 0;
+
+        benchmark_result result;
+        result.scenario = getName(settings.scenario);
+        result.bodyCount = m_bodyCount;
+        result.tickCount = settings.tickCount;
+        result.totalTime = replayResult.totalTime;
+        result.averageTickTime = replayResult.averageStepTime();
+        result.worstTickTime = replayResult.worstStepTime;
+        result.allocations = allocationsAfter - allocationsBefore;
+        result.stages = replayResult.stageTotals;
+
+        if (replayResult.totalTime > 0)
+            result.pairsPerSecond = replayResult.stageTotals.pairChecks / (replayResult.totalTime / 1000.0);
+
+        log::info("Physics benchmark {}: {} bodies, {}ms per tick, worst tick {}ms",
+            result.scenario, result.bodyCount, result.averageTickTime, result.worstTickTime);
+
+        destroyScenario();
+        return result;
+    }
+
+    std::vector<benchmark_result> PhysicsBenchmark::runAll(size_type tickCount)
+    {
+        OPTICK_EVENT();
+        std::vector<benchmark_result> results;
+        results.push_back(run({ benchmark_scenario::box_pyramid, 20, tickCount }));
+        results.push_back(run({ benchmark_scenario::sphere_rain, 1000, tickCount }));
+        results.push_back(run({ benchmark_scenario::debris_pile, 10000, tickCount }));
+        results.push_back(run({ benchmark_scenario::fracture_storm, 25, tickCount }));
+        results.push_back(run({ benchmark_scenario::mixed_static_world, 2500, tickCount }));
+        return results;
+    }
+
+    hull_benchmark_result PhysicsBenchmark::runHull(size_type vertexCount, size_type queryCount)
+    {
+        OPTICK_EVENT();
+        ConvexCollider colliderA(createPrismHull(vertexCount / 2));
+        ConvexCollider colliderB(createPrismHull(vertexCount / 2));
+        ConvexCollider* convexA = &colliderA;
+        ConvexCollider* convexB = &colliderB;
+        const ConvexHull& hullA = convexA->GetConvexHull();
+        const ConvexHull& hullB = convexB->GetConvexHull();
+
+        hull_benchmark_result result;
+        result.vertexCount = hullA.getVertices().size();
+        result.faceCount = hullA.getFaces().size();
+        result.uniqueEdgeCount = hullA.getUniqueEdges().size();
+        result.memoryUsage = hullA.getMemoryUsage();
+        result.queryCount = queryCount;
+        result.edgePairCount = hullA.getUniqueEdges().size() * hullB.getUniqueEdges().size();
+
+        //the hulls overlap a little so none of the queries stop early, B is turned a bit differently every query
+        constexpr size_type transformCount = 64;
+        const math::mat4 transformA = math::compose(math::vec3(1.f), math::angleAxis(0.3f, math::normalize(math::vec3(1.f, 1.f, 0.f))), math::vec3(0.f));
+        std::vector<math::mat4> transformsB;
+        std::vector<math::vec3> directions;
+
+        std::mt19937 generator(3);
+        std::uniform_real_distribution<float> distribution(-1.f, 1.f);
+        for (size_type i = 0; i < transformCount; i++)
+        {
+            transformsB.push_back(math::compose(math::vec3(1.f), math::angleAxis(i * 0.1f, math::normalize(math::vec3(0.f, 1.f, 1.f))), math::vec3(0.8f, 0.2f, 0.1f)));
+            directions.emplace_back(distribution(generator), distribution(generator), distribution(generator) + 2.f);
+        }
+
+        //the results are added together so the queries can not be optimized away
+        volatile float sink = 0.f;
+        ConvexHull::feature_index refFeature;
+        ConvexHull::feature_index incFeature;
+        math::vec3 axis;
+        float seperation;
+
+        time::timer faceTimer;
+        for (size_type query = 0; query < queryCount; query++)
+        {
+            const math::mat4& transformB = transformsB[query % transformCount];
+            PhysicsStatics::FindSeperatingAxisByExtremePointProjection(convexB, convexA, transformB, transformA, refFeature, seperation);
+            sink = sink + seperation;
+            PhysicsStatics::FindSeperatingAxisByExtremePointProjection(convexA, convexB, transformA, transformB, refFeature, seperation);
+            sink = sink + seperation;
+        }
+        result.faceQueryTime = faceTimer.end().milliseconds();
+
+        time::timer edgeTimer;
+        for (size_type query = 0; query < queryCount; query++)
+        {
+            PhysicsStatics::FindSeperatingAxisByGaussMapEdgeCheck(convexB, convexA, transformsB[query % transformCount], transformA,
+                refFeature, incFeature, axis, seperation);
+            sink = sink + seperation;
+        }
+        result.edgeQueryTime = edgeTimer.end().milliseconds();
+
+        time::timer unprunedTimer;
+        for (size_type query = 0; query < queryCount; query++)
+        {
+            const math::mat4& transformB = transformsB[query % transformCount];
+            for (ConvexHull::feature_index edgeB : hullB.getUniqueEdges())
+            {
+                for (ConvexHull::feature_index edgeA : hullA.getUniqueEdges())
+                {
+                    if (PhysicsStatics::GetEdgeSeperation(convexB, edgeB, convexA, edgeA, transformB, transformA, axis, seperation))
+                        sink = sink + seperation;
+                }
+            }
+        }
+        result.unprunedEdgeQueryTime = unprunedTimer.end().milliseconds();
+
+        const math::mat3 directionToLocalA = math::transpose(math::mat3(transformA));
+        math::vec3 supportPoint;
+
+        time::timer supportTimer;
+        for (size_type query = 0; query < queryCount; query++)
+        {
+            PhysicsStatics::GetSupportPoint(directions[query % transformCount], convexA, transformA, directionToLocalA, supportPoint);
+            sink = sink + supportPoint.x;
+        }
+        result.supportTime = supportTimer.end().milliseconds();
+
+        std::vector<math::vec3> worldVertices(hullA.getVertices().size());
+        time::timer worldSupportTimer;
+        for (size_type query = 0; query < queryCount; query++)
+        {
+            for (size_type i = 0; i < worldVertices.size(); i++)
+                worldVertices[i] = transformA * math::vec4(hullA.getVertices()[i], 1);
+
+            PhysicsStatics::GetSupportPoint(worldVertices, directions[query % transformCount], supportPoint);
+            sink = sink + supportPoint.x;
+        }
+        result.worldSupportTime = worldSupportTimer.end().milliseconds();
+
+        log::info("Hull benchmark {} vertices: {} faces, {} unique edges, face queries {}ms, edge queries {}ms, unpruned edge queries {}ms",
+            result.vertexCount, result.faceCount, result.uniqueEdgeCount, result.faceQueryTime, result.edgeQueryTime, result.unprunedEdgeQueryTime);
+
+        return result;
+    }
+
+    std::vector<hull_benchmark_result> PhysicsBenchmark::runAllHulls(size_type queryCount)
+    {
+        OPTICK_EVENT();
+        std::vector<hull_benchmark_result> results;
+        for (size_type vertexCount : { 8u, 64u, 256u })
+            results.push_back(runHull(vertexCount, queryCount));
+        return results;
+    }
+
+    void PhysicsBenchmark::writeJson(const std::vector<benchmark_result>& results, std::ostream& stream)
+    {
+        cereal::JSONOutputArchive archive(stream);
+        archive(cereal::make_nvp("physics_benchmark", results));
+    }
+
+    void PhysicsBenchmark::writeJson(const std::vector<benchmark_result>& results, const std::vector<hull_benchmark_result>& hullResults, std::ostream& stream)
+    {
+        cereal::JSONOutputArchive archive(stream);
+        archive(cereal::make_nvp("physics_benchmark", results), cereal::make_nvp("hull_benchmark", hullResults));
+    }
+
+    std::string PhysicsBenchmark::getName(benchmark_scenario scenario)
+    {
+        switch (scenario)
+        {
+        case benchmark_scenario::box_pyramid: return "box_pyramid";
+        case benchmark_scenario::sphere_rain: return "sphere_rain";
+        case benchmark_scenario::debris_pile: return "debris_pile";
+        case benchmark_scenario::fracture_storm: return "fracture_storm";
+        case benchmark_scenario::mixed_static_world: return "mixed_static_world";
+        }
+        return "unknown";
+    }
+
+    std::shared_ptr<const ConvexHull> PhysicsBenchmark::createPrismHull(size_type sideCount, float radius, float height)
+    {
+        std::vector<math::vec3> bottom;
+        std::vector<math::vec3> top;
+        for (size_type i = 0; i < sideCount; i++)
+        {
+            const float angle = math::two_pi<float>() * i / sideCount;
+            bottom.emplace_back(math::cos(angle) * radius, -height * 0.5f, math::sin(angle) * radius);
+            top.emplace_back(math::cos(angle) * radius, height * 0.5f, math::sin(angle) * radius);
+        }
+
+        std::vector<HalfEdgeFace*> faces;
+        std::vector<HalfEdgeEdge*> edges;
+
+        //the edges of a face go clockwise when seen from outside, like the faces of ConvexCollider::CreateBox
+        auto createFace = [&faces, &edges](const std::vector<math::vec3>& corners, const math::vec3& normal)
+        {
+            const size_type firstEdge = edges.size();
+            for (const math::vec3& corner : corners)
+                edges.push_back(new HalfEdgeEdge(corner));
+
+            const size_type count = corners.size();
+            for (size_type i = 0; i < count; i++)
+                edges[firstEdge + i]->setNextAndPrevEdge(edges[firstEdge + (i + count - 1) % count], edges[firstEdge + (i + 1) % count]);
+
+            faces.push_back(new HalfEdgeFace(edges[firstEdge], normal));
+        };
+
+        createFace(top, math::vec3(0, 1, 0));
+        createFace(std::vector<math::vec3>(bottom.rbegin(), bottom.rend()), math::vec3(0, -1, 0));
+
+        for (size_type i = 0; i < sideCount; i++)
+        {
+            const size_type next = (i + 1) % sideCount;
+            const float angle = math::two_pi<float>() * (i + 0.5f) / sideCount;
+            createFace({ bottom[i], bottom[next], top[next], top[i] }, math::vec3(math::cos(angle), 0, math::sin(angle)));
+        }
+
+        //every edge is paired with the edge that goes the other way between the same vertices
+        for (HalfEdgeEdge* edge : edges)
+        {
+            for (HalfEdgeEdge* other : edges)
+            {
+                if (other->edgePosition == edge->nextEdge->edgePosition && other->nextEdge->edgePosition == edge->edgePosition)
+                {
+                    edge->pairingEdge = other;
+                    break;
+                }
+            }
+        }
+
+        auto hull = ConvexHull::build(faces);
+
+        //the faces own their edges
+        for (HalfEdgeFace* face : faces)
+            delete face;
+
+        return hull;
+    }
+
+    ecs::entity_handle PhysicsBenchmark::createBody(const math::vec3& position, bool isDynamic)
+    {
+        auto ent = m_registry->createEntity();
+
+        auto [positionH, rotationH, scaleH] = m_registry->createComponents<transform>(ent);
+        positionH.write(position);
+
+        if (isDynamic)
+            ent.add_component<rigidbody>();
+
+        m_bodyCount++;
+        return ent;
+    }
+
+    void PhysicsBenchmark::addBox(ecs::entity_handle entity, const cube_collider_params& params)
+    {
+        physicsComponent physicsComp;
+        physicsComp.AddBox(params);
+        entity.add_component(physicsComp);
+    }
+
+    void PhysicsBenchmark::addSphere(ecs::entity_handle entity, float radius)
+    {
+        physicsComponent physicsComp;
+        physicsComp.AddSphere(radius);
+        entity.add_component(physicsComp);
+    }
+
+    void PhysicsBenchmark::buildFloor(float size)
+    {
+        addBox(createBody(math::vec3(0, -0.5f, 0), false), cube_collider_params(size, size, 1.0f));
+    }
+
+    void PhysicsBenchmark::buildBoxPyramid(size_type baseWidth)
+    {
+        buildFloor(baseWidth * 4.0f);
+
+        for (size_type layer = 0; layer < baseWidth; layer++)
+        {
+            const size_type layerWidth = baseWidth - layer;
+            const float start = (1.0f - layerWidth) * 0.5f;
+
+            for (size_type i = 0; i < layerWidth; i++)
+            {
+                addBox(createBody(math::vec3(start + i, 0.5f + layer, 0), true), cube_collider_params(1.0f, 1.0f, 1.0f));
+            }
+        }
+    }
+
+    void PhysicsBenchmark::buildSphereRain(size_type sphereCount)
+    {
+        const size_type width = static_cast<size_type>(math::ceil(math::sqrt(static_cast<float>(sphereCount))));
+        buildFloor(width * 3.0f);
+
+        for (size_type i = 0; i < sphereCount; i++)
+        {
+            //every other row is offset and raised so the spheres don't land in neat columns
+            const size_type row = i / width;
+            const size_type column = i % width;
+            const float offset = (row % 2) * 0.75f;
+
+            math::vec3 position((column - width * 0.5f) * 1.5f + offset, 5.0f + (i % 7) * 1.5f, (row - width * 0.5f) * 1.5f);
+            addSphere(createBody(position, true), 0.5f);
+        }
+    }
+
+    void PhysicsBenchmark::buildDebrisPile(size_type boxCount)
+    {
+        const size_type width = static_cast<size_type>(math::ceil(math::pow(static_cast<float>(boxCount), 1.0f / 3.0f)));
+        buildFloor(width * 4.0f);
+
+        const float boxSize = 0.5f;
+        for (size_type i = 0; i < boxCount; i++)
+        {
+            const size_type x = i % width;
+            const size_type z = (i / width) % width;
+            const size_type y = i / (width * width);
+
+            //the layers are shifted a little so the pile does not stay standing as one block
+            const float shift = (y % 2) * boxSize * 0.3f;
+
+            math::vec3 position((x - width * 0.5f) * boxSize + shift, boxSize * 0.5f + y * boxSize, (z - width * 0.5f) * boxSize + shift);
+            addBox(createBody(position, true), cube_collider_params(boxSize, boxSize, boxSize));
+        }
+    }
+
+    void PhysicsBenchmark::buildFractureStorm(size_type boxCount, float timeStep)
+    {
+        const size_type width = static_cast<size_type>(math::ceil(math::sqrt(static_cast<float>(boxCount))));
+        buildFloor(width * 8.0f);
+
+        mesh_handle cubeMesh = MeshCache::create_mesh("cube", filesystem::view("assets://models/cube.obj"));
+        cube_collider_params cubeParams;
+
+        for (size_type i = 0; i < boxCount; i++)
+        {
+            math::vec3 position(((i % width) - width * 0.5f) * 4.0f, 1.0f, ((i / width) - width * 0.5f) * 4.0f);
+            auto ent = createBody(position, true);
+            ent.add_components<rendering::mesh_renderable>(mesh_filter(cubeMesh), rendering::mesh_renderer());
+            addBox(ent, cubeParams);
+
+            //the boxes explode one after the other, a few steps apart
+            ent.add_component<Fracturer>();
+            FractureCountdown countdown;
+            countdown.explosionPoint = position;
+            countdown.fractureStrength = 5.0f;
+            countdown.fractureTime = (i + 1) * timeStep * 5;
+            ent.add_component(countdown);
+
+            auto splitterH = ent.add_component<MeshSplitter>();
+            auto splitter = splitterH.read();
+            splitter.InitializePolygons(ent);
+            splitterH.write(splitter);
+
+            auto fracturerH = ent.get_component_handle<Fracturer>();
+            auto fracturer = fracturerH.read();
+            fracturer.PrecomputeFracture(ent);
+            fracturerH.write(fracturer);
+        }
+    }
+
+    void PhysicsBenchmark::buildMixedStaticWorld(size_type staticCount)
+    {
+        const size_type width = static_cast<size_type>(math::ceil(math::sqrt(static_cast<float>(staticCount))));
+        buildFloor(width * 4.0f);
+
+        //pillars that never move, most pairs the broadphase finds are between two of these
+        for (size_type i = 0; i < staticCount; i++)
+        {
+            math::vec3 position(((i % width) - width * 0.5f) * 2.0f, 1.0f, ((i / width) - width * 0.5f) * 2.0f);
+            addBox(createBody(position, false), cube_collider_params(1.0f, 1.0f, 2.0f));
+        }
+
+        //one dynamic box for every ten static ones, dropped in between the pillars
+        for (size_type i = 0; i < staticCount; i += 10)
+        {
+            math::vec3 position(((i % width) - width * 0.5f) * 2.0f + 1.0f, 6.0f, ((i / width) - width * 0.5f) * 2.0f + 1.0f);
+            addBox(createBody(position, true), cube_collider_params(0.8f, 0.8f, 0.8f));
+        }
+    }
+
+    void PhysicsBenchmark::destroyScenario()
+    {
+        OPTICK_EVENT();
+        //fragments of the fracture storm are not known to the benchmark, so every physics entity is destroyed
+        auto query = m_registry->createQuery<physicsComponent>();
+        query.queryEntities();
+
+        std::vector<ecs::entity_handle> entities(query.begin(), query.end());
+        for (auto entity : entities)
+        {
+            if (entity.valid())
+                entity.destroy();
+        }
+    }
+}
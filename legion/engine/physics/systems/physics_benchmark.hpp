@@ -0,0 +1,155 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/systems/physics_replay.hpp>
+#include <physics/cube_collider_params.hpp>
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+namespace legion::physics
+{
+    enum struct benchmark_scenario
+    {
+        box_pyramid,        //a single pyramid of boxes on a static floor, scale is the width of the base
+        sphere_rain,        //a grid of spheres dropped onto a static floor, scale is the number of spheres
+        debris_pile,        //a tightly packed block of small boxes that collapses, scale is the number of boxes
+        fracture_storm,     //fracturable boxes that explode one after the other, scale is the number of boxes
+        mixed_static_world  //a field of static boxes with dynamic boxes falling through it, scale is the number of static boxes
+    };
+
+    struct benchmark_settings
+    {
+        benchmark_scenario scenario;
+        size_type scale;
+        size_type tickCount = 600;
+        float timeStep = 0.02f;
+    };
+
+    /**@struct benchmark_result
+     * @brief The results of a single scenario, all times are in milliseconds.
+     */
+    struct benchmark_result
+    {
+        std::string scenario;
+        size_type bodyCount = 0;
+        size_type tickCount = 0;
+
+        time64 totalTime = 0;
+        time64 averageTickTime = 0;
+        time64 worstTickTime = 0;
+
+        //heap allocations made while the scenario ran, 0 when no allocation counter is set
+        size_type allocations = 0;
+        time64 pairsPerSecond = 0;
+
+        physics_step_stats stages;
+
+        template<typename Archive>
+        void serialize(Archive& archive)
+        {
+            archive(cereal::make_nvp("scenario", scenario), cereal::make_nvp("bodies", bodyCount), cereal::make_nvp("ticks", tickCount),
+                cereal::make_nvp("total_ms", totalTime), cereal::make_nvp("average_tick_ms", averageTickTime),
+                cereal::make_nvp("worst_tick_ms", worstTickTime), cereal::make_nvp("allocations", allocations),
+                cereal::make_nvp("pairs_per_second", pairsPerSecond), cereal::make_nvp("stages", stages));
+        }
+    };
+
+    /**@struct hull_benchmark_result
+     * @brief The timings of the convex hull queries on a pair of prism hulls of a single size, all times are in milliseconds
+     * and are the total of every query.
+     */
+    struct hull_benchmark_result
+    {
+        size_type vertexCount = 0;
+        size_type faceCount = 0;
+        size_type uniqueEdgeCount = 0;
+        size_type memoryUsage = 0;
+
+        size_type queryCount = 0;
+
+        //the face checks of both hulls and the gauss map edge check, like ConvexCollider::CheckCollisionWith does them
+        time64 faceQueryTime = 0;
+        time64 edgeQueryTime = 0;
+
+        //every unique edge pair without the gauss map pruning, the edge check does this many pairs without it
+        time64 unprunedEdgeQueryTime = 0;
+        size_type edgePairCount = 0;
+
+        //support points through the VertexSoA of the hull, and by transforming every vertex to world space
+        time64 supportTime = 0;
+        time64 worldSupportTime = 0;
+
+        template<typename Archive>
+        void serialize(Archive& archive)
+        {
+            archive(cereal::make_nvp("vertices", vertexCount), cereal::make_nvp("faces", faceCount),
+                cereal::make_nvp("unique_edges", uniqueEdgeCount), cereal::make_nvp("memory_bytes", memoryUsage),
+                cereal::make_nvp("queries", queryCount), cereal::make_nvp("face_query_ms", faceQueryTime),
+                cereal::make_nvp("edge_query_ms", edgeQueryTime), cereal::make_nvp("unpruned_edge_query_ms", unprunedEdgeQueryTime),
+                cereal::make_nvp("edge_pairs", edgePairCount), cereal::make_nvp("support_ms", supportTime),
+                cereal::make_nvp("world_support_ms", worldSupportTime));
+        }
+    };
+
+    /**@class PhysicsBenchmark
+     * @brief Builds standard scenarios through the ECS and times the physics on them with a PhysicsReplay.
+     * Nothing is rendered, so the benchmark can run in any application that reports the PhysicsModule without its system.
+     * @note Every scenario destroys all physics entities when it is done, so run it in an otherwise empty world.
+     */
+    class PhysicsBenchmark
+    {
+    public:
+        /**@brief Returns the number of heap allocations made so far. Only the application can count these,
+         * by replacing the global operator new, so it is left to the application to set this.
+         */
+        static size_type(*allocationCounter)();
+
+        PhysicsBenchmark(ecs::EcsRegistry* registry) : m_registry(registry) {}
+
+        /**@brief Builds the scenario, runs it and destroys it again.
+         */
+        benchmark_result run(const benchmark_settings& settings);
+
+        /**@brief Runs every scenario at a scale that is meant to take a few seconds each.
+         */
+        std::vector<benchmark_result> runAll(size_type tickCount = 600);
+
+        /**@brief Times the SAT queries between two overlapping prism hulls with vertexCount vertices each.
+         * This does not need the ECS.
+         */
+        static hull_benchmark_result runHull(size_type vertexCount, size_type queryCount = 1000);
+
+        /**@brief Runs the hull benchmark with hulls of 8, 64 and 256 vertices.
+         */
+        static std::vector<hull_benchmark_result> runAllHulls(size_type queryCount = 1000);
+
+        /**@brief Writes the results as a JSON document, so they can be compared across commits.
+         */
+        static void writeJson(const std::vector<benchmark_result>& results, std::ostream& stream);
+        static void writeJson(const std::vector<benchmark_result>& results, const std::vector<hull_benchmark_result>& hullResults, std::ostream& stream);
+
+        L_NODISCARD static std::string getName(benchmark_scenario scenario);
+
+        /**@brief Builds a prism with a regular polygon of sideCount corners as its caps, centered on the origin.
+         * The hull is built from half edge faces directly, so the shape is exact and does not depend on the quickhull.
+         */
+        static std::shared_ptr<const ConvexHull> createPrismHull(size_type sideCount, float radius = 1.0f, float height = 1.0f);
+
+    private:
+        ecs::EcsRegistry* m_registry;
+        size_type m_bodyCount = 0;
+
+        ecs::entity_handle createBody(const math::vec3& position, bool isDynamic);
+        void addBox(ecs::entity_handle entity, const cube_collider_params& params);
+        void addSphere(ecs::entity_handle entity, float radius);
+
+        void buildFloor(float size);
+        void buildBoxPyramid(size_type baseWidth);
+        void buildSphereRain(size_type sphereCount);
+        void buildDebrisPile(size_type boxCount);
+        void buildFractureStorm(size_type boxCount, float timeStep);
+        void buildMixedStaticWorld(size_type staticCount);
+
+        void destroyScenario();
+    };
+}
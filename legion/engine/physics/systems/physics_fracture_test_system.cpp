@@ -1431,6 +1431,15 @@ namespace legion::physics
             auto splitter = splitterH.read();
             splitter.InitializePolygons(ent);
             splitterH.write(splitter);
+
+            //split the box while the scene loads, so the explosion only has to swap in the fragments
+            if (hasCollider)
+            {
+                auto fracturerH = ent.get_component_handle<physics::Fracturer>();
+                auto fracturer = fracturerH.read();
+                fracturer.PrecomputeFracture(ent);
+                fracturerH.write(fracturer);
+            }
         }
 
         return  ent;
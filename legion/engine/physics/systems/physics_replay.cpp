@@ -0,0 +1,169 @@
+#include <physics/systems/physics_replay.hpp>
+
+namespace legion::physics
+{
+    namespace
+    {
+        constexpr uint64 fnvOffsetBasis = 14695981039346656037ull;
+        constexpr uint64 fnvPrime = 1099511628211ull;
+
+        template<typename T>
+        void hashBytes(uint64& hash, const T& value)
+        {
+            const byte* bytes = reinterpret_cast<const byte*>(&value);
+            for (size_type i = 0; i < sizeof(T); i++)
+            {
+                hash ^= bytes[i];
+                hash *= fnvPrime;
+            }
+        }
+    }
+
+    PhysicsReplay::PhysicsReplay() : m_physicsSystem(std::make_unique<PhysicsSystem>())
+    {
+        m_physicsSystem->initialize();
+    }
+
+    void PhysicsReplay::recordInitialState()
+    {
+        OPTICK_EVENT();
+        m_initialState.clear();
+
+        auto& query = m_physicsSystem->manifoldPrecursorQuery;
+        query.queryEntities();
+
+        for (auto entity : query)
+        {
+            entity_state state;
+            state.entity = entity;
+            state.pos = entity.read_component<position>();
+            state.rot = entity.read_component<rotation>();
+            state.scal = entity.read_component<scale>();
+            state.hasRigidbody = entity.has_component<rigidbody>();
+            if (state.hasRigidbody)
+                state.body = entity.read_component<rigidbody>();
+
+            m_initialState.push_back(state);
+        }
+
+        //the hash should not depend on the order in which the query found the entities
+        std::sort(m_initialState.begin(), m_initialState.end(), [](const entity_state& lhs, const entity_state& rhs)
+            {
+                return lhs.entity.get_id() < rhs.entity.get_id();
+            });
+    }
+
+    void PhysicsReplay::recordForce(size_type step, ecs::entity_handle entity, const math::vec3& force, const math::vec3& worldPosition)
+    {
+        m_forces.push_back({ step, entity, force, worldPosition });
+    }
+
+    replay_result PhysicsReplay::run(size_type stepCount, float timeStep, bool singleThreaded)
+    {
+        OPTICK_EVENT();
+        restoreInitialState();
+        m_physicsSystem->reset();
+
+        const bool wasDeterministic = PhysicsSystem::isDeterministic;
+        const bool wasSingleThreaded = PhysicsSystem::isSingleThreaded;
+        const bool wasInterpolating = PhysicsSystem::interpolateTransforms;
+
+        PhysicsSystem::isDeterministic = true;
+        PhysicsSystem::isSingleThreaded = singleThreaded;
+        //adding the interpolation component would move the entities to other archetypes in the middle of the first step
+        PhysicsSystem::interpolateTransforms = false;
+
+        replay_result result;
+        result.stateHashes.reserve(stepCount);
+
+        time::timer stepTimer;
+        for (size_type step = 0; step < stepCount; step++)
+        {
+            for (auto& recorded : m_forces)
+            {
+                if (recorded.step != step || !recorded.entity.valid() || !recorded.entity.has_component<rigidbody>())
+                    continue;
+
+                auto body = recorded.entity.read_component<rigidbody>();
+                body.addForceAt(recorded.worldPosition, recorded.force);
+                recorded.entity.write_component(body);
+            }
+
+            stepTimer.start();
+            m_physicsSystem->step(timeStep);
+            const time64 stepTime = stepTimer.end().milliseconds();
+
+            result.totalTime += stepTime;
+            result.worstStepTime = math::max(result.worstStepTime, stepTime);
+            result.stageTotals += m_physicsSystem->getStepStats();
+            result.stateHashes.push_back(hashState());
+        }
+
+        PhysicsSystem::isDeterministic = wasDeterministic;
+        PhysicsSystem::isSingleThreaded = wasSingleThreaded;
+        PhysicsSystem::interpolateTransforms = wasInterpolating;
+
+        return result;
+    }
+
+    bool PhysicsReplay::verify(size_type stepCount, float timeStep)
+    {
+        OPTICK_EVENT();
+        replay_result first = run(stepCount, timeStep);
+        replay_result second = run(stepCount, timeStep);
+        replay_result single = run(stepCount, timeStep, true);
+
+        for (size_type step = 0; step < stepCount; step++)
+        {
+            if (first.stateHashes[step] != second.stateHashes[step] || first.stateHashes[step] != single.stateHashes[step])
+            {
+                log::error("Physics replay diverged at step {}: {:x} {:x} {:x}", step,
+                    first.stateHashes[step], second.stateHashes[step], single.stateHashes[step]);
+                return false;
+            }
+        }
+
+        log::info("Physics replay of {} steps is deterministic, {}ms per step on the job workers, {}ms on a single thread",
+            stepCount, first.averageStepTime(), single.averageStepTime());
+        return true;
+    }
+
+    void PhysicsReplay::restoreInitialState()
+    {
+        OPTICK_EVENT();
+        for (auto& state : m_initialState)
+        {
+            if (!state.entity.valid())
+                continue;
+
+            state.entity.write_component(state.pos);
+            state.entity.write_component(state.rot);
+            state.entity.write_component(state.scal);
+            if (state.hasRigidbody)
+                state.entity.write_component(state.body);
+        }
+    }
+
+    uint64 PhysicsReplay::hashState() const
+    {
+        OPTICK_EVENT();
+        uint64 hash = fnvOffsetBasis;
+        for (auto& state : m_initialState)
+        {
+            if (!state.entity.valid())
+                continue;
+
+            hashBytes(hash, state.entity.get_id());
+            hashBytes(hash, static_cast<math::vec3>(state.entity.read_component<position>()));
+            hashBytes(hash, static_cast<math::quat>(state.entity.read_component<rotation>()));
+
+            if (state.hasRigidbody)
+            {
+                auto body = state.entity.read_component<rigidbody>();
+                hashBytes(hash, body.velocity);
+                hashBytes(hash, body.angularVelocity);
+            }
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <core/core.hpp>
+#include <physics/systems/physicssystem.hpp>
+
+namespace legion::physics
+{
+    /**@struct replay_result
+     * @brief The outcome of a single PhysicsReplay::run.
+     */
+    struct replay_result
+    {
+        //hash of the state of every physics entity after each step
+        std::vector<uint64> stateHashes;
+
+        //timings of the steps in milliseconds
+        time64 totalTime = 0;
+        time64 worstStepTime = 0;
+
+        //the stage timings and pair counts of all steps added together
+        physics_step_stats stageTotals;
+
+        L_NODISCARD time64 averageStepTime() const noexcept
+        {
+            return stateHashes.empty() ? 0 : totalTime / stateHashes.size();
+        }
+    };
+
+    /**@class PhysicsReplay
+     * @brief Runs the physics without the engine loop. The state of the physics entities is recorded once, after which
+     * every run starts from that state and applies the same recorded forces at the same steps.
+     * The hash of the state after every step can be compared between runs to check that the physics is deterministic,
+     * and the timings of the steps make it usable as a benchmark.
+     * @note Fracturing and the fracture countdown are not part of the recorded state and should not be used in a replay.
+     */
+    class PhysicsReplay
+    {
+    public:
+        PhysicsReplay();
+
+        /**@brief Records the position, rotation, scale and rigidbody of every entity with a physicsComponent.
+         * Every run starts from this state.
+         */
+        void recordInitialState();
+
+        /**@brief Records a force that is applied at a world position to the rigidbody of an entity before the given step.
+         */
+        void recordForce(size_type step, ecs::entity_handle entity, const math::vec3& force, const math::vec3& worldPosition);
+
+        /**@brief Restores the recorded state and runs stepCount steps of timeStep seconds in deterministic mode.
+         * @param singleThreaded Runs every job of the physics on this thread instead of on the job workers.
+         */
+        replay_result run(size_type stepCount, float timeStep, bool singleThreaded = false);
+
+        /**@brief Runs the replay twice on the job workers and once on a single thread.
+         * @return True if the state hashes of all three runs are identical for every step.
+         */
+        bool verify(size_type stepCount, float timeStep);
+
+    private:
+        struct entity_state
+        {
+            ecs::entity_handle entity;
+            position pos;
+            rotation rot;
+            scale scal;
+            bool hasRigidbody = false;
+            rigidbody body;
+        };
+
+        struct recorded_force
+        {
+            size_type step;
+            ecs::entity_handle entity;
+            math::vec3 force;
+            math::vec3 worldPosition;
+        };
+
+        std::unique_ptr<PhysicsSystem> m_physicsSystem;
+        std::vector<entity_state> m_initialState;
+        std::vector<recorded_force> m_forces;
+
+        void restoreInitialState();
+
+        /**@brief FNV-1a hash of the bits of the positions, rotations and velocities of the recorded entities.
+         */
+        L_NODISCARD uint64 hashState() const;
+    };
+}
@@ -1,18 +1,35 @@
 #include <physics/systems/physicssystem.hpp>
 #include <physics/broadphasecollisionalgorithms/broadphaseuniformgridnocaching.hpp>
+#include <physics/physics_statics.hpp>
 
 namespace legion::physics
 {
     std::unique_ptr<BroadPhaseCollisionAlgorithm> PhysicsSystem::m_broadPhase = nullptr;
 
+    async::rw_spinlock PhysicsSystem::m_queryLock;
+    std::vector<query_proxy> PhysicsSystem::m_queryProxies;
+    AABBSoA PhysicsSystem::m_queryBounds;
+
     bool PhysicsSystem::IsPaused = false;
     bool PhysicsSystem::oneTimeRunActive = false;
 
 
+    size_type PhysicsSystem::substepCount = 1;
+    size_type PhysicsSystem::maxStepsPerUpdate = 4;
+    bool PhysicsSystem::isDeterministic = false;
+    bool PhysicsSystem::isSingleThreaded = false;
+    bool PhysicsSystem::interpolateTransforms = true;
+
     void PhysicsSystem::setup()
     {
-        createProcess<&PhysicsSystem::fixedUpdate>("Physics", m_timeStep);
+        //the process runs every frame, fixedUpdate decides how many steps fit in the time that passed
+        createProcess<&PhysicsSystem::fixedUpdate>("Physics");
+
+        initialize();
+    }
 
+    void PhysicsSystem::initialize()
+    {
         manifoldPrecursorQuery = createQuery<position, rotation, scale, physicsComponent>();
 
         //std::make_unique<BroadphaseUniformGrid>(math::vec3(2,2,2),1);
@@ -21,6 +38,183 @@ namespace legion::physics
 
         m_broadPhase = std::make_unique<BroadphaseUniformGridNoCaching>(math::vec3(2, 2, 2));
 
+        Fracturer::registry = m_ecs;
+        Fracturer::scheduler = m_scheduler;
+    }
+
+    void PhysicsSystem::fixedUpdate(time::time_span<fast_time> deltaTime)
+    {
+        OPTICK_EVENT();
+        m_accumulator += deltaTime;
+
+        size_type stepCount = 0;
+        while (m_accumulator >= m_timeStep)
+        {
+            if (stepCount >= maxStepsPerUpdate)
+            {
+                //the physics can't keep up, the time that is left is dropped instead of making the next frame even slower
+                m_accumulator = 0.f;
+                break;
+            }
+
+            step(m_timeStep);
+            m_accumulator -= m_timeStep;
+            stepCount++;
+        }
+    }
+
+    void PhysicsSystem::step(float timeStep)
+    {
+        OPTICK_EVENT();
+
+        //the fractures requested during the last step are swapped in before any data is fetched,
+        //so the fragments take part in this step and none of the fetched data belongs to a destroyed entity
+        Fracturer::CommitPendingFractures();
+
+        m_stepStats = physics_step_stats{};
+        time::timer stageTimer;
+
+        ecs::component_container<rigidbody> rigidbodies;
+        std::vector<byte> hasRigidBodies;
+
+        {
+            OPTICK_EVENT("Fetching data");
+            manifoldPrecursorQuery.queryEntities();
+
+            rigidbodies.resize(manifoldPrecursorQuery.size());
+            hasRigidBodies.resize(manifoldPrecursorQuery.size());
+
+            runJobs(manifoldPrecursorQuery.size(), [&]() {
+                id_type index = async::this_job::get_id();
+                auto entity = manifoldPrecursorQuery[index];
+                if (entity.has_component<rigidbody>())
+                {
+                    hasRigidBodies[index] = true;
+                    rigidbodies[index] = entity.read_component<rigidbody>();
+                }
+                else
+                    hasRigidBodies[index] = false;
+                });
+
+            m_stepStats.fetchTime = stageTimer.restart().milliseconds();
+        }
+
+        auto& positions = manifoldPrecursorQuery.get<position>();
+        auto& rotations = manifoldPrecursorQuery.get<rotation>();
+
+        std::vector<position> previousPositions;
+        std::vector<rotation> previousRotations;
+        if (interpolateTransforms)
+        {
+            previousPositions.assign(positions.begin(), positions.end());
+            previousRotations.assign(rotations.begin(), rotations.end());
+        }
+
+        if (!IsPaused)
+        {
+            runSubsteps(hasRigidBodies, rigidbodies, timeStep);
+        }
+
+        if (oneTimeRunActive)
+        {
+            oneTimeRunActive = false;
+            runSubsteps(hasRigidBodies, rigidbodies, timeStep);
+        }
+
+        {
+            OPTICK_EVENT("Writing data");
+            stageTimer.start();
+            runJobs(manifoldPrecursorQuery.size(), [&]() {
+                id_type index = async::this_job::get_id();
+                if (hasRigidBodies[index])
+                {
+                    auto entity = manifoldPrecursorQuery[index];
+                    entity.write_component(rigidbodies[index]);
+                }
+                });
+
+            manifoldPrecursorQuery.submit<physicsComponent>();
+            manifoldPrecursorQuery.submit<position>();
+            manifoldPrecursorQuery.submit<rotation>();
+        }
+
+        if (interpolateTransforms)
+        {
+            updateInterpolation(hasRigidBodies, previousPositions, previousRotations, timeStep);
+        }
+
+        m_stepStats.submitTime = stageTimer.end().milliseconds();
+    }
+
+    void PhysicsSystem::reset()
+    {
+        m_pairCaches.clear();
+        m_physicsStep = 0;
+        m_accumulator = 0.f;
+    }
+
+    void PhysicsSystem::runSubsteps(std::vector<byte>& hasRigidBodies, ecs::component_container<rigidbody>& rigidbodies, float timeStep)
+    {
+        OPTICK_EVENT();
+        auto& physComps = manifoldPrecursorQuery.get<physicsComponent>();
+        auto& positions = manifoldPrecursorQuery.get<position>();
+        auto& rotations = manifoldPrecursorQuery.get<rotation>();
+        auto& scales = manifoldPrecursorQuery.get<scale>();
+
+        const size_type substeps = math::max<size_type>(substepCount, 1);
+        const float substepTime = timeStep / static_cast<float>(substeps);
+
+        time::timer integrateTimer;
+        for (size_type substep = 0; substep < substeps; substep++)
+        {
+            integrateTimer.start();
+            integrateRigidbodies(hasRigidBodies, rigidbodies, substepTime);
+            m_stepStats.integrateTime += integrateTimer.end().milliseconds();
+
+            runPhysicsPipeline(hasRigidBodies, rigidbodies, physComps, positions, rotations, scales, substepTime);
+
+            integrateTimer.start();
+            integrateRigidbodyQueryPositionAndRotation(hasRigidBodies, positions, rotations, rigidbodies, substepTime);
+            m_stepStats.integrateTime += integrateTimer.end().milliseconds();
+        }
+    }
+
+    void PhysicsSystem::updateInterpolation(std::vector<byte>& hasRigidBodies, const std::vector<position>& previousPositions,
+        const std::vector<rotation>& previousRotations, float timeStep)
+    {
+        OPTICK_EVENT();
+        const time64 stepEnd = transform_interpolation::currentTime();
+
+        //entities that don't have the component yet can only be changed on this thread
+        std::vector<byte> isMissing(manifoldPrecursorQuery.size(), false);
+
+        auto makeInterpolation = [&](size_type index)
+        {
+            transform_interpolation interpolation;
+            interpolation.previousPosition = previousPositions[index];
+            interpolation.previousRotation = previousRotations[index];
+            interpolation.stepEnd = stepEnd;
+            interpolation.stepLength = timeStep;
+            return interpolation;
+        };
+
+        runJobs(manifoldPrecursorQuery.size(), [&]() {
+            id_type index = async::this_job::get_id();
+            if (!hasRigidBodies[index])
+                return;
+
+            auto handle = manifoldPrecursorQuery[index].get_component_handle<transform_interpolation>();
+            if (handle)
+                handle.write(makeInterpolation(index));
+            else
+                isMissing[index] = true;
+            });
+
+        for (size_type index = 0; index < isMissing.size(); index++)
+        {
+            if (isMissing[index])
+                manifoldPrecursorQuery[index].add_component(makeInterpolation(index));
+        }
     }
 
     void PhysicsSystem::runPhysicsPipeline(
@@ -33,6 +227,8 @@ namespace legion::physics
         float deltaTime)
     {
         OPTICK_EVENT();
+        m_physicsStep++;
+        time::timer stageTimer;
 
         //-------------------------------------------------Broadphase Optimization-----------------------------------------------//
 
@@ -41,8 +237,28 @@ namespace legion::physics
         bulkRetrievePreManifoldData(physComps, positions, rotations, scales, manifoldPrecursors);
 
         std::vector<std::vector<physics_manifold_precursor>> manifoldPrecursorGrouping;
-        //m_optimizeBroadPhase(manifoldPrecursors, manifoldPrecursorGrouping);
-        manifoldPrecursorGrouping = m_broadPhase->collectPairs(std::move(manifoldPrecursors));
+        {
+            //the scene queries read the broadphase and the proxies, so they are updated together
+            async::readwrite_guard guard(m_queryLock);
+            updateQueryProxies(manifoldPrecursors);
+
+            //m_optimizeBroadPhase(manifoldPrecursors, manifoldPrecursorGrouping);
+            manifoldPrecursorGrouping = m_broadPhase->collectPairs(std::move(manifoldPrecursors));
+        }
+
+        if (isDeterministic)
+        {
+            //the order of the precursors in a group depends on the broadphase, the ids of the entities don't
+            for (auto& group : manifoldPrecursorGrouping)
+            {
+                std::sort(group.begin(), group.end(), [](const physics_manifold_precursor& lhs, const physics_manifold_precursor& rhs)
+                    {
+                        return lhs.entity.get_id() < rhs.entity.get_id();
+                    });
+            }
+        }
+
+        m_stepStats.broadphaseTime += stageTimer.restart().milliseconds();
 
         //------------------------------------------------------ Narrowphase -----------------------------------------------------//
         std::vector<physics_manifold> manifoldsToSolve;
@@ -113,8 +329,27 @@ namespace legion::physics
             }
             //log::debug("groupings {}", manifoldPrecursorGrouping.size());
             //log::debug("total checks {}", totalChecks);
+            m_stepStats.pairChecks += totalChecks;
+        }
+
+        if (isDeterministic)
+        {
+            //the solver applies impulses one manifold after the other, so the result depends on the order of the manifolds
+            auto manifoldKey = [](const physics_manifold& manifold)
+            {
+                return std::make_tuple(manifold.entityA.get_id(), manifold.entityB.get_id(),
+                    manifold.colliderA->GetColliderID(), manifold.colliderB->GetColliderID());
+            };
+
+            std::sort(manifoldsToSolve.begin(), manifoldsToSolve.end(), [&](const physics_manifold& lhs, const physics_manifold& rhs)
+                {
+                    return manifoldKey(lhs) < manifoldKey(rhs);
+                });
         }
 
+        m_stepStats.manifolds += manifoldsToSolve.size();
+        m_stepStats.narrowphaseTime += stageTimer.restart().milliseconds();
+
         //------------------------------------------------ Pre Collision Solve Events --------------------------------------------//
 
 
@@ -125,7 +360,7 @@ namespace legion::physics
         for (auto ent : countdownQuery)
         {
             auto fractureCountdown = ent.read_component<FractureCountdown>();
-            fractureCountdown.fractureTime -= 0.02f;
+            fractureCountdown.fractureTime -= deltaTime;
             //log::debug(" fractureCountdown.fractureTime {}", fractureCountdown.fractureTime);
 
             if (fractureCountdown.explodeNow || fractureCountdown.fractureTime < 0.0f)
@@ -138,7 +373,10 @@ namespace legion::physics
                 log::debug("fractureCountdown.fractureStrength {} ", fractureCountdown.fractureStrength);
                 FractureParams params(fractureCountdown.explosionPoint, fractureCountdown.fractureStrength);
 
+                //the entity is replaced by its fragments at the start of a later step, it only has to be requested once
                 fracturer.ExplodeEntity(ent, params);
+                fractureCountdown.fractureTime = FLT_MAX;
+                fractureCountdown.explodeNow = false;
 
                 fracturerH.write(fracturer);
 
@@ -232,24 +470,38 @@ namespace legion::physics
             {
                 OPTICK_EVENT("Converge manifolds");
 
-                //reset convergance identifiers for all colliders
+                //using the known lambdas of this time step, replace the convergance identifiers of each collider pair
                 for (auto& manifold : manifoldsToSolve)
                 {
-                    manifold.colliderA->converganceIdentifiers.clear();
-                    manifold.colliderB->converganceIdentifiers.clear();
+                    manifold.pairCache->converganceIdentifiers.clear();
+
+                    for (auto& contact : manifold.contacts)
+                    {
+                        contact.refCollider->AddConverganceIdentifier(contact, *manifold.pairCache);
+                    }
                 }
+            }
 
-                //using the known lambdas of this time step, add it as a convergance identifier
-                for (auto& manifold : manifoldsToSolve)
+            {
+                OPTICK_EVENT("Remove unused pair caches");
+
+                //pairs that were not checked this step are no longer close to each other
+                for (auto iter = m_pairCaches.begin(); iter != m_pairCaches.end();)
                 {
-                    for (auto& contact : manifold.contacts)
+                    if (iter->second.lastStep != m_physicsStep)
+                    {
+                        iter = m_pairCaches.erase(iter);
+                    }
+                    else
                     {
-                        contact.refCollider->AddConverganceIdentifier(contact);
+                        ++iter;
                     }
                 }
             }
         }
 
+        m_stepStats.solveTime += stageTimer.end().milliseconds();
+
     }
 
     void PhysicsSystem::constructManifoldsWithPrecursors(ecs::component_container<rigidbody>& rigidbodies, std::vector<byte>& hasRigidBodies, physics_manifold_precursor& precursorA, physics_manifold_precursor& precursorB,
@@ -271,10 +523,13 @@ namespace legion::physics
 
                 if (!m.isColliding)
                 {
+                    //impulses of a pair that stopped touching should not be used when it touches again
+                    m.pairCache->converganceIdentifiers.clear();
                     continue;
                 }
 
                 colliderA->PopulateContactPoints(colliderB.get(), m);
+                m.pairCache->matchContacts(m.contacts);
 
                 if (isTriggerInvolved)
                 {
@@ -294,4 +549,317 @@ namespace legion::physics
             }
         }
     }
+
+    void PhysicsSystem::updateQueryProxies(const std::vector<physics_manifold_precursor>& manifoldPrecursors)
+    {
+        OPTICK_EVENT();
+        m_queryProxies.resize(manifoldPrecursors.size());
+        m_queryBounds.resize(manifoldPrecursors.size());
+
+        runJobs(manifoldPrecursors.size(), [&]() {
+            id_type index = async::this_job::get_id();
+            const physics_manifold_precursor& precursor = manifoldPrecursors[index];
+            query_proxy& proxy = m_queryProxies[index];
+
+            proxy.worldTransform = precursor.worldTransform;
+            proxy.entity = precursor.entity;
+            proxy.isTrigger = precursor.physicsComp->isTrigger;
+            proxy.colliders = precursor.physicsComp->colliders;
+            proxy.colliderBounds.resize(proxy.colliders.size());
+
+            //a component without colliders gets an empty box at its position, it is never tested because it has no colliders
+            const math::vec3 position = precursor.worldTransform[3];
+            std::pair<math::vec3, math::vec3> bounds = std::make_pair(position, position);
+
+            for (size_type i = 0; i < proxy.colliders.size(); i++)
+            {
+                proxy.colliderBounds[i] = proxy.colliders[i]->GetMinMaxWorldAABB();
+                bounds = i == 0 ? proxy.colliderBounds[i] : PhysicsStatics::CombineAABB(proxy.colliderBounds[i], bounds);
+            }
+
+            m_queryBounds.set(index, bounds);
+            });
+    }
+
+    void PhysicsSystem::sweepFastRigidbodies(std::vector<byte>& hasRigidBodies, ecs::component_container<rigidbody>& rigidbodies,
+        float deltaTime, std::vector<float>& motionFractions)
+    {
+        OPTICK_EVENT();
+        motionFractions.assign(hasRigidBodies.size(), 1.0f);
+
+        async::readonly_guard guard(m_queryLock);
+        if (!m_broadPhase) return;
+
+        const size_type proxyCount = math::min(m_queryProxies.size(), hasRigidBodies.size());
+
+        runJobs(proxyCount, [&]() {
+            static thread_local std::vector<id_type> candidates;
+
+            id_type index = async::this_job::get_id();
+            if (!hasRigidBodies[index]) return;
+
+            const rigidbody& rb = rigidbodies[index];
+            const query_proxy& proxy = m_queryProxies[index];
+            if (proxy.isTrigger || proxy.colliders.empty()) return;
+
+            //a body that moves less than a fraction of its size can not pass through anything, so slow bodies stop here
+            const math::vec3 motion = rb.velocity * deltaTime;
+            const float motionLength = math::length(motion);
+            const auto bounds = m_queryBounds.get(index);
+            const math::vec3 extents = bounds.second - bounds.first;
+            const float smallestExtent = math::min(extents.x, math::min(extents.y, extents.z));
+
+            if (motionLength <= math::epsilon<float>() || motionLength <= rb.ccdMotionThreshold * smallestExtent) return;
+
+            //the swept bounding box covers the body at the start and at the end of the step
+            const math::vec3 sweptMin = math::min(bounds.first, bounds.first + motion);
+            const math::vec3 sweptMax = math::max(bounds.second, bounds.second + motion);
+
+            candidates.clear();
+            m_broadPhase->collectCandidates(sweptMin, sweptMax, candidates);
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+            float fraction = 1.0f;
+
+            for (id_type candidate : candidates)
+            {
+                if (candidate == index || candidate >= proxyCount) continue;
+
+                const query_proxy& other = m_queryProxies[candidate];
+                if (other.isTrigger || !m_queryBounds.overlaps(candidate, sweptMin, sweptMax)) continue;
+
+                //the sweep is done relative to the other body so that two fast bodies moving into each other are found as well
+                math::vec3 relativeMotion = motion;
+                if (hasRigidBodies[candidate])
+                {
+                    relativeMotion -= rigidbodies[candidate].velocity * deltaTime;
+                }
+
+                const float relativeLength = math::length(relativeMotion);
+                if (relativeLength <= math::epsilon<float>()) continue;
+
+                const math::vec3 direction = relativeMotion / relativeLength;
+
+                for (size_type i = 0; i < proxy.colliders.size(); i++)
+                {
+                    const auto& colliderBounds = proxy.colliderBounds[i];
+                    const math::vec3 colliderSweptMin = math::min(colliderBounds.first, colliderBounds.first + relativeMotion);
+                    const math::vec3 colliderSweptMax = math::max(colliderBounds.second, colliderBounds.second + relativeMotion);
+
+                    for (size_type j = 0; j < other.colliders.size(); j++)
+                    {
+                        const auto& otherBounds = other.colliderBounds[j];
+                        if (!PhysicsStatics::CollideAABB(colliderSweptMin, colliderSweptMax, otherBounds.first, otherBounds.second)) continue;
+
+                        float distance;
+                        math::vec3 normal, point;
+                        if (!PhysicsStatics::ColliderCast(proxy.colliders[i].get(), proxy.worldTransform, direction, relativeLength,
+                            other.colliders[j].get(), other.worldTransform, distance, normal, point)) continue;
+
+                        //colliders that already touch are left to the narrowphase, stopping them here would keep them from ever overlapping
+                        if (distance <= 0.0f) continue;
+
+                        //the body is allowed to sink in a little so that the narrowphase creates a contact in the next step
+                        fraction = math::min(fraction, (distance + constants::ccdAllowedPenetration) / relativeLength);
+                    }
+                }
+            }
+
+            motionFractions[index] = fraction;
+            });
+    }
+
+    namespace
+    {
+        //the amount the bounding boxes are grown by so that the center of the cast shape can be tested with a ray
+
+        math::vec3 getCastExpansion(const raycast_query& query)
+        {
+            return math::vec3(0.0f);
+        }
+
+        math::vec3 getCastExpansion(const sphere_sweep_query& query)
+        {
+            return math::vec3(query.radius);
+        }
+
+        math::vec3 getCastExpansion(const box_sweep_query& query)
+        {
+            const math::mat3 rotation = math::toMat3(query.rotation);
+            return math::abs(rotation[0]) * query.halfExtents.x + math::abs(rotation[1]) * query.halfExtents.y
+                + math::abs(rotation[2]) * query.halfExtents.z;
+        }
+    }
+
+    template<typename query_type, typename cast_func>
+    void PhysicsSystem::castQueries(const std::vector<query_type>& queries, std::vector<query_hit>& results, cast_func&& castCollider)
+    {
+        OPTICK_EVENT();
+        results.assign(queries.size(), query_hit{});
+
+        async::readonly_guard guard(m_queryLock);
+        if (!m_broadPhase || m_queryProxies.empty() || queries.empty()) return;
+
+        async::for_each_range(*m_scheduler, queries.size(), m_queriesPerJob, [&](size_type firstQuery, size_type lastQuery) {
+            //scratch buffers are kept per worker so that queries do not allocate once they are warmed up
+            static thread_local std::vector<id_type> candidates;
+            static thread_local std::vector<float> entries;
+
+            for (size_type queryIndex = firstQuery; queryIndex < lastQuery; queryIndex++)
+            {
+                const query_type& query = queries[queryIndex];
+
+                const float directionLength = math::length(query.direction);
+                if (directionLength <= math::epsilon<float>()) continue;
+
+                const math::vec3 direction = query.direction / directionLength;
+                const math::vec3 expansion = getCastExpansion(query);
+
+                candidates.clear();
+                m_broadPhase->collectRayCandidates(query.origin, direction, query.maxDistance, expansion, candidates);
+                std::sort(candidates.begin(), candidates.end());
+                candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+                entries.resize(candidates.size());
+                m_queryBounds.intersectRay(query.origin, direction, query.maxDistance, expansion, candidates.data(), candidates.size(), entries.data());
+
+                query_hit& closestHit = results[queryIndex];
+                closestHit.distance = query.maxDistance;
+
+                for (size_type i = 0; i < candidates.size(); i++)
+                {
+                    //misses have an entry of float max so they are skipped here as well
+                    if (entries[i] == std::numeric_limits<float>::max() || entries[i] > closestHit.distance) continue;
+
+                    const query_proxy& proxy = m_queryProxies[candidates[i]];
+                    if (query.ignoreTriggers && proxy.isTrigger) continue;
+
+                    //a hit on this proxy can not be further away than the point where the ray leaves its grown bounding box
+                    const auto bounds = m_queryBounds.get(candidates[i]);
+                    const float exitDistance = entries[i] + math::length(bounds.second - bounds.first + expansion * 2.0f);
+
+                    for (size_type j = 0; j < proxy.colliders.size(); j++)
+                    {
+                        query_hit hit;
+                        if (castCollider(query, direction, math::min(closestHit.distance, exitDistance), proxy.colliders[j].get(), proxy.worldTransform, hit)
+                            && (!closestHit.isHit || hit.distance < closestHit.distance))
+                        {
+                            hit.entity = proxy.entity;
+                            hit.colliderID = proxy.colliders[j]->GetColliderID();
+                            hit.isHit = true;
+                            closestHit = hit;
+                        }
+                    }
+                }
+
+                if (!closestHit.isHit)
+                {
+                    closestHit.distance = std::numeric_limits<float>::max();
+                }
+            }
+            });
+    }
+
+    void PhysicsSystem::raycast(const std::vector<raycast_query>& queries, std::vector<query_hit>& results)
+    {
+        castQueries(queries, results, [](const raycast_query& query, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& transform, query_hit& hit)
+            {
+                if (!collider->Raycast(transform, query.origin, direction, maxDistance, hit.distance, hit.normal)) return false;
+
+                hit.point = query.origin + direction * hit.distance;
+                return true;
+            });
+    }
+
+    query_hit PhysicsSystem::raycast(const raycast_query& query)
+    {
+        std::vector<query_hit> results;
+        raycast(std::vector<raycast_query>{ query }, results);
+        return results[0];
+    }
+
+    void PhysicsSystem::sphereSweep(const std::vector<sphere_sweep_query>& queries, std::vector<query_hit>& results)
+    {
+        castQueries(queries, results, [](const sphere_sweep_query& query, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& transform, query_hit& hit)
+            {
+                return PhysicsStatics::SphereCast(world_sphere{ query.origin, query.radius }, direction, maxDistance,
+                    collider, transform, hit.distance, hit.normal, hit.point);
+            });
+    }
+
+    void PhysicsSystem::boxSweep(const std::vector<box_sweep_query>& queries, std::vector<query_hit>& results)
+    {
+        castQueries(queries, results, [](const box_sweep_query& query, const math::vec3& direction, float maxDistance,
+            const PhysicsCollider* collider, const math::mat4& transform, query_hit& hit)
+            {
+                const math::mat3 rotation = math::toMat3(query.rotation);
+                const world_box box{ query.origin, { rotation[0], rotation[1], rotation[2] }, query.halfExtents };
+
+                return PhysicsStatics::BoxCast(box, direction, maxDistance, collider, transform, hit.distance, hit.normal, hit.point);
+            });
+    }
+
+    void PhysicsSystem::overlapAABB(const std::vector<aabb_overlap_query>& queries, query_results<overlap_hit>& results)
+    {
+        OPTICK_EVENT();
+        results.hits.clear();
+        results.offsets.assign(queries.size() + 1, 0);
+
+        async::readonly_guard guard(m_queryLock);
+        if (!m_broadPhase || m_queryProxies.empty() || queries.empty()) return;
+
+        //the first pass counts the hits of every query so that the second pass can write them straight into the flat buffer
+        auto forEachHit = [&](auto&& onHit) {
+            async::for_each_range(*m_scheduler, queries.size(), m_queriesPerJob, [&](size_type firstQuery, size_type lastQuery) {
+                static thread_local std::vector<id_type> candidates;
+
+                for (size_type queryIndex = firstQuery; queryIndex < lastQuery; queryIndex++)
+                {
+                    const aabb_overlap_query& query = queries[queryIndex];
+
+                    candidates.clear();
+                    m_broadPhase->collectCandidates(query.min, query.max, candidates);
+                    std::sort(candidates.begin(), candidates.end());
+                    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+                    size_type hitIndex = 0;
+                    for (id_type candidate : candidates)
+                    {
+                        if (!m_queryBounds.overlaps(candidate, query.min, query.max)) continue;
+
+                        const query_proxy& proxy = m_queryProxies[candidate];
+                        if (query.ignoreTriggers && proxy.isTrigger) continue;
+
+                        for (size_type j = 0; j < proxy.colliders.size(); j++)
+                        {
+                            if (PhysicsStatics::CollideAABB(proxy.colliderBounds[j], std::make_pair(query.min, query.max)))
+                            {
+                                onHit(queryIndex, hitIndex++, proxy, j);
+                            }
+                        }
+                    }
+                }
+                });
+        };
+
+        forEachHit([&](size_type queryIndex, size_type hitIndex, const query_proxy& proxy, size_type colliderIndex)
+            {
+                results.offsets[queryIndex + 1]++;
+            });
+
+        for (size_type i = 0; i < queries.size(); i++)
+        {
+            results.offsets[i + 1] += results.offsets[i];
+        }
+
+        results.hits.resize(results.offsets.back());
+
+        forEachHit([&](size_type queryIndex, size_type hitIndex, const query_proxy& proxy, size_type colliderIndex)
+            {
+                results.hits[results.offsets[queryIndex] + hitIndex] = overlap_hit{ proxy.entity, proxy.colliders[colliderIndex]->GetColliderID() };
+            });
+    }
 }
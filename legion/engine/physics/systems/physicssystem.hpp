@@ -6,9 +6,13 @@
 #include <physics/components/rigidbody.hpp>
 #include <physics/data/physics_manifold_precursor.hpp>
 #include <physics/data/physics_manifold.hpp>
+#include <physics/data/collider_pair_cache.hpp>
 #include <physics/physics_contact.hpp>
 #include <physics/components/physics_component.hpp>
 #include <physics/data/identifier.hpp>
+#include <physics/data/scene_query.hpp>
+#include <physics/data/aabb_soa.hpp>
+#include <physics/data/physics_step_stats.hpp>
 #include <physics/events/events.hpp>
 #include <memory>
 #include <rendering/debugrendering.hpp>
@@ -37,97 +41,55 @@ namespace legion::physics
         virtual void setup();
      
 
-        void fixedUpdate(time::time_span<fast_time> deltaTime)
-        {
-            static time::timer physicsTimer;
-            //log::debug("{}ms", physicsTimer.restart().milliseconds());
-            OPTICK_EVENT();
-
-            //static time::timer pt;
-            //log::debug("frametime: {}ms", pt.restart().milliseconds());
-
-            ecs::component_container<rigidbody> rigidbodies;
-            std::vector<byte> hasRigidBodies;
-
-            {
-                OPTICK_EVENT("Fetching data");
-                manifoldPrecursorQuery.queryEntities();
-
-                rigidbodies.resize(manifoldPrecursorQuery.size());
-                hasRigidBodies.resize(manifoldPrecursorQuery.size());
-
-                m_scheduler->queueJobs(manifoldPrecursorQuery.size(), [&]() {
-                    id_type index = async::this_job::get_id();
-                    auto entity = manifoldPrecursorQuery[index];
-                    if (entity.has_component<rigidbody>())
-                    {
-                        hasRigidBodies[index] = true;
-                        rigidbodies[index] = entity.read_component<rigidbody>();
-                    }
-                    else
-                        hasRigidBodies[index] = false;
-                    }).wait();
-            }
+        /**@brief Adds the time that passed to the accumulator and runs as many fixed steps as fit in it.
+         * At most maxStepsPerUpdate steps are run, any time that is left after that is dropped so the physics can catch up.
+         */
+        void fixedUpdate(time::time_span<fast_time> deltaTime);
 
-            auto& physComps = manifoldPrecursorQuery.get<physicsComponent>();
-            auto& positions = manifoldPrecursorQuery.get<position>();
-            auto& rotations = manifoldPrecursorQuery.get<rotation>();
-            auto& scales = manifoldPrecursorQuery.get<scale>();
+        //------------------------------------------------------ Stepping -----------------------------------------------------//
+        //The physics always moves in steps of m_timeStep, every step is split into substepCount substeps.
+        //Rigidbodies get a transform_interpolation so they are rendered in between the last two steps.
 
-            if (!IsPaused)
-            {
-                integrateRigidbodies(hasRigidBodies, rigidbodies, deltaTime);
-                runPhysicsPipeline(hasRigidBodies, rigidbodies, physComps, positions, rotations, scales, deltaTime);
-                integrateRigidbodyQueryPositionAndRotation(hasRigidBodies, positions, rotations, rigidbodies, deltaTime);
-            }
-
-            if (oneTimeRunActive)
-            {
-                oneTimeRunActive = false;
+        /**@brief The number of substeps every fixed step is split into, more substeps make stacks and fast bodies more stable.
+         */
+        static size_type substepCount;
 
-                integrateRigidbodies(hasRigidBodies, rigidbodies, deltaTime);
-                runPhysicsPipeline(hasRigidBodies, rigidbodies, physComps, positions, rotations, scales, deltaTime);
-                integrateRigidbodyQueryPositionAndRotation(hasRigidBodies, positions, rotations, rigidbodies, deltaTime);
-            }
+        /**@brief The maximum number of fixed steps a single fixedUpdate is allowed to run.
+         */
+        static size_type maxStepsPerUpdate;
 
-            {
-                OPTICK_EVENT("Writing data");
-                m_scheduler->queueJobs(manifoldPrecursorQuery.size(), [&]() {
-                    id_type index = async::this_job::get_id();
-                    if (hasRigidBodies[index])
-                    {
-                        auto entity = manifoldPrecursorQuery[index];
-                        entity.write_component(rigidbodies[index]);
-                    }
-                    }).wait();
+        /**@brief When set the collision pairs and manifolds are sorted by the ids of their entities and colliders,
+         * so the solver sees them in the same order no matter in what order the broadphase and the jobs found them.
+         */
+        static bool isDeterministic;
 
-                    manifoldPrecursorQuery.submit<physicsComponent>();
-                    manifoldPrecursorQuery.submit<position>();
-                    manifoldPrecursorQuery.submit<rotation>();
-            }
+        /**@brief When set every job of a step is run on the physics thread instead of on the job workers.
+         */
+        static bool isSingleThreaded;
 
-           /* auto splitterDrawQuery = createQuery<MeshSplitter>();
-            splitterDrawQuery.queryEntities();
+        /**@brief When set rigidbodies get a transform_interpolation that is updated every step.
+         */
+        static bool interpolateTransforms;
 
-            for (auto ent : splitterDrawQuery)
-            {
-                auto splitterHandle = ent.get_component_handle<MeshSplitter>();
-   
-                if (splitterHandle )
-                {
-                    auto [posH,rotH,scaleH] = ent.get_component_handles<transform>();
-                    debug::drawLine
-                    (posH.read(), posH.read() + math::vec3(0, 5, 0), math::colors::red, 20.0f, 0.0f, true);
+        /**@brief Sets up the physics without creating the fixed update process.
+         * Used by setup, and by owners that step the physics themselves such as PhysicsReplay.
+         */
+        void initialize();
 
-                    auto splitter = splitterHandle.read();
-                    math::mat4 transform = math::compose(scaleH.read(), rotH.read(), posH.read());
+        /**@brief Runs a single fixed step of the given length, including its substeps.
+         */
+        void step(float timeStep);
 
-                    splitter.DEBUG_DrawPolygonData(transform);
-                }
-            }*/
+        /**@brief Forgets the data that is carried from one step to the next, such as the warm starting data of the contacts
+         * and the time in the accumulator.
+         */
+        void reset();
 
+        L_NODISCARD float getTimeStep() const noexcept { return m_timeStep; }
 
-        }
+        /**@brief Gets the timings and pair counts of the last step.
+         */
+        L_NODISCARD const physics_step_stats& getStepStats() const noexcept { return m_stepStats; }
 
         void bulkRetrievePreManifoldData(
             ecs::component_container<physicsComponent>& physComps,
@@ -139,7 +101,7 @@ namespace legion::physics
             OPTICK_EVENT();
             manifoldPrecursors.resize(physComps.size());
 
-            m_scheduler->queueJobs(physComps.size(), [&]() {
+            runJobs(physComps.size(), [&]() {
                 id_type index = async::this_job::get_id();
                 math::mat4 transf;
                 math::compose(transf, scales[index], rotations[index], positions[index]);
@@ -148,7 +110,7 @@ namespace legion::physics
                     collider->UpdateTransformedTightBoundingVolume(transf);
 
                 manifoldPrecursors[index] = { transf, &physComps[index], index, manifoldPrecursorQuery[index] };
-                }).wait();
+                });
         }
 
         /**@brief Sets the broad phase collision detection method
@@ -158,6 +120,7 @@ namespace legion::physics
         static void setBroadPhaseCollisionDetection(Args&& ...args)
         {
             static_assert(std::is_base_of_v<BroadPhaseCollisionAlgorithm, BroadPhaseType>, "Broadphase type did not inherit from BroadPhaseCollisionAlgorithm");
+            async::readwrite_guard guard(m_queryLock);
             m_broadPhase = std::make_unique<BroadPhaseType>(std::forward<Args>(args)...);
         }
 
@@ -166,14 +129,88 @@ namespace legion::physics
             m_broadPhase->debugDraw();
         }
 
+        //------------------------------------------------------ Scene Queries -----------------------------------------------------//
+        //Queries are done against the world as it was at the last physics step and can be called from any system.
+        //Candidates are collected with the broadphase and the bounding boxes of the physics components, after which
+        //every collider of the candidates is tested exactly. Batches are split over the job workers.
+
+        /**@brief Casts a batch of rays into the world.
+         * @param results [out] results[i] will hold the closest hit of queries[i], query_hit::isHit is false when nothing was hit.
+         */
+        static void raycast(const std::vector<raycast_query>& queries, std::vector<query_hit>& results);
+
+        /**@brief Casts a single ray into the world and returns the closest hit.
+         */
+        static query_hit raycast(const raycast_query& query);
+
+        /**@brief Sweeps a batch of spheres through the world.
+         * @param results [out] results[i] will hold the closest hit of queries[i], query_hit::isHit is false when nothing was hit.
+         */
+        static void sphereSweep(const std::vector<sphere_sweep_query>& queries, std::vector<query_hit>& results);
+
+        /**@brief Sweeps a batch of oriented boxes through the world.
+         * @param results [out] results[i] will hold the closest hit of queries[i], query_hit::isHit is false when nothing was hit.
+         */
+        static void boxSweep(const std::vector<box_sweep_query>& queries, std::vector<query_hit>& results);
+
+        /**@brief Finds every collider whose bounding box overlaps the box of a query, for a batch of queries.
+         * @param results [out] The hits of all queries in one buffer, see query_results.
+         */
+        static void overlapAABB(const std::vector<aabb_overlap_query>& queries, query_results<overlap_hit>& results);
+
     private:
 
         static std::unique_ptr<BroadPhaseCollisionAlgorithm> m_broadPhase;
+
+        //the data of the last physics step that the scene queries are done against, guarded by m_queryLock
+        static async::rw_spinlock m_queryLock;
+        static std::vector<query_proxy> m_queryProxies;
+        static AABBSoA m_queryBounds;
+        static constexpr size_type m_queriesPerJob = 16;
         const float m_timeStep = 0.02f;
+        float m_accumulator = 0.f;
+
+        //narrowphase data of every collider pair that was close enough to be checked in the last physics step
+        std::unordered_map<uint64, collider_pair_cache> m_pairCaches;
+        size_type m_physicsStep = 0;
+
+        physics_step_stats m_stepStats;
 
 
         math::ivec3 uniformGridCellSize = math::ivec3(1, 1, 1);
 
+        /** @brief Runs count jobs of func, on the job workers or on this thread when isSingleThreaded is set.
+         * Each job only touches the data of its own index, so both give the same result.
+        */
+        template<typename Func>
+        void runJobs(size_type count, const Func& func)
+        {
+            if (!count)
+                return;
+
+            if (isSingleThreaded)
+            {
+                async::job_pool<Func> jobPool(count, func);
+                while (auto* job = jobPool.pop_job())
+                {
+                    job->execute();
+                    jobPool.complete_job();
+                }
+                return;
+            }
+
+            m_scheduler->queueJobs(count, func).wait();
+        }
+
+        /** @brief Runs the physics pipeline substepCount times with an equal part of timeStep.
+        */
+        void runSubsteps(std::vector<byte>& hasRigidBodies, ecs::component_container<rigidbody>& rigidbodies, float timeStep);
+
+        /** @brief Stores the poses of the rigidbodies before a step in their transform_interpolation.
+        */
+        void updateInterpolation(std::vector<byte>& hasRigidBodies, const std::vector<position>& previousPositions,
+            const std::vector<rotation>& previousRotations, float timeStep);
+
         /** @brief Performs the entire physics pipeline (
          * Broadphase Collision Detection, Narrowphase Collision Detection, and the Collision Resolution)
         */
@@ -224,18 +261,44 @@ namespace legion::physics
             manifold.transformA = precursorA.worldTransform;
             manifold.transformB = precursorB.worldTransform;
 
+            auto& pairCache = m_pairCaches[collider_pair_cache::makeKey(colliderA->GetColliderID(), colliderB->GetColliderID())];
+            pairCache.lastStep = m_physicsStep;
+            manifold.pairCache = &pairCache;
+
             //manifold.DEBUG_checkID("floor", "problem");
 
             // log::debug("colliderA->CheckCollision(colliderB, manifold)");
             colliderA->CheckCollision(colliderB, manifold);
         }
 
+        /** @brief Copies the data of the manifold precursors that the scene queries need.
+         * @note Needs to be called while m_queryLock is write locked.
+        */
+        void updateQueryProxies(const std::vector<physics_manifold_precursor>& manifoldPrecursors);
+
+        /** @brief Finds the fraction of the motion of this step that each fast moving rigidbody can do before it hits another collider.
+         * A rigidbody is fast when it moves further than its ccdMotionThreshold times its smallest extent, the colliders in its swept
+         * bounding box are found with the broadphase and the time of impact is found with PhysicsStatics::ColliderCast.
+         * @param motionFractions [out] The fraction of the motion of every precursor, 1 for bodies that are not stopped.
+         * @note Uses the query proxies so it needs to be called after runPhysicsPipeline.
+        */
+        void sweepFastRigidbodies(std::vector<byte>& hasRigidBodies, ecs::component_container<rigidbody>& rigidbodies,
+            float deltaTime, std::vector<float>& motionFractions);
+
+        /** @brief Runs a batch of queries that only report their closest hit.
+         * @param castCollider A function that casts a query against a single collider, with the signature
+         * bool(const query_type& query, const math::vec3& direction, float maxDistance, const PhysicsCollider* collider,
+         * const math::mat4& transform, query_hit& hit). The direction is normalized.
+        */
+        template<typename query_type, typename cast_func>
+        static void castQueries(const std::vector<query_type>& queries, std::vector<query_hit>& results, cast_func&& castCollider);
+
         /** @brief gets all the entities with a rigidbody component and calls the integrate function on them
         */
         void integrateRigidbodies(std::vector<byte>& hasRigidBodies, ecs::component_container<rigidbody>& rigidbodies, float deltaTime)
         {
             OPTICK_EVENT();
-            m_scheduler->queueJobs(manifoldPrecursorQuery.size(), [&]() {
+            runJobs(manifoldPrecursorQuery.size(), [&]() {
                 if (!hasRigidBodies[async::this_job::get_id()])
                     return;
 
@@ -250,7 +313,7 @@ namespace legion::physics
                 rb.angularVelocity += (angularAcc)*deltaTime;
 
                 rb.resetAccumulators();
-                }).wait();
+                });
         }
 
         void integrateRigidbodyQueryPositionAndRotation(
@@ -261,7 +324,10 @@ namespace legion::physics
             float deltaTime)
         {
             OPTICK_EVENT();
-            m_scheduler->queueJobs(manifoldPrecursorQuery.size(), [&]() {
+            std::vector<float> motionFractions;
+            sweepFastRigidbodies(hasRigidBodies, rigidbodies, deltaTime, motionFractions);
+
+            runJobs(manifoldPrecursorQuery.size(), [&]() {
                 id_type index = async::this_job::get_id();
                 if (!hasRigidBodies[index])
                     return;
@@ -271,7 +337,8 @@ namespace legion::physics
                 auto& rot = rotations[index];
 
                 ////-------------------- update position ------------------//
-                pos += rb.velocity * deltaTime;
+                //fast bodies are stopped just after they hit something so that the narrowphase finds the contact next step
+                pos += rb.velocity * deltaTime * motionFractions[index];
 
                 ////-------------------- update rotation ------------------//
                 float angle = math::clamp(math::length(rb.angularVelocity), 0.0f, 32.0f);
@@ -290,7 +357,7 @@ namespace legion::physics
                 rb.globalCentreOfMass = pos;
 
                 rb.UpdateInertiaTensor(rot);
-                }).wait();
+                });
         }
 
         void initializeManifolds(std::vector<physics_manifold>& manifoldsToSolve, std::vector<byte>& manifoldValidity)
@@ -31,16 +31,11 @@ namespace legion::rendering
 
             void bind(material_handle& materialHandle) const
             {
-                if (materialHandle.has_param<math::mat4>(SV_VIEW))
-                    materialHandle.set_param(SV_VIEW, view);
-                if (materialHandle.has_param<math::mat4>(SV_PROJECT))
-                    materialHandle.set_param(SV_PROJECT, proj);
-                if (materialHandle.has_param<math::vec4>(SV_CAMPOS))
-                    materialHandle.set_param(SV_CAMPOS, posnearz);
-                if (materialHandle.has_param<math::vec4>(SV_VIEWDIR))
-                    materialHandle.set_param(SV_VIEWDIR, vdirfarz);
-                if (materialHandle.has_param<math::ivec2>(SV_VIEWPORT))
-                    materialHandle.set_param(SV_VIEWPORT, viewportSize);
+                materialHandle.try_set_param(SV_VIEW, view);
+                materialHandle.try_set_param(SV_PROJECT, proj);
+                materialHandle.try_set_param(SV_CAMPOS, posnearz);
+                materialHandle.try_set_param(SV_VIEWDIR, vdirfarz);
+                materialHandle.try_set_param(SV_VIEWPORT, viewportSize);
             }
 
             union
@@ -5,15 +5,25 @@ namespace legion::rendering
 {
     struct lod
     {
-        lod(int maxLevel = 8, float maxDistance = 35.0f) : MaxLod(maxLevel), m_maxDistance(maxDistance)
+        //vertical fov maxDistance is measured with
+        static constexpr float reference_fov = 60.f;
+
+        /**@param maxLevel Number of levels.
+         * @param maxDistance Distance at which the least detailed level is reached when seen through reference_fov at a scale of 1,
+         *        the distance grows with the scale of the entity and shrinks with wider fovs.
+         * @param radius Radius of the bounds of the entity at a scale of 1.
+         */
+        lod(int maxLevel = 8, float maxDistance = 35.0f, float radius = 1.f) : MaxLod(maxLevel), radius(radius),
+            minScreenSize(radius / (maxDistance * tanf(math::deg2rad(reference_fov) * 0.5f)))
         {
         }
         int MaxLod;
         int Level = 0;
         int MaxTreeLevel = 0;
 
-        bool isInitialized = false;
-        float m_maxDistance;
-        std::vector<float> m_thresholdLevels;
+        float radius;
+        //fraction of the viewport height the bounds cover from which on the least detailed level is used, in the units of lod_screen_size:
+        //the radius seen from maxDistance divided by half the height of the view, which is tan(reference_fov / 2) * maxDistance there
+        float minScreenSize;
     };
 }
@@ -0,0 +1,23 @@
+#pragma once
+#include <core/core.hpp>
+
+/**
+ * @file occluder.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct occluder
+     * @brief Marks an entity as an occluder, its mesh is rasterized on the CPU every frame and renderables that are completely behind the occluders are not drawn.
+     *        Every triangle costs CPU time, so large walls and floors are best given a simplified mesh instead of the mesh they are rendered with.
+     */
+    struct occluder
+    {
+        //mesh that is rasterized, the mesh of the mesh_filter of the entity is used when this is invalid
+        //a simplified mesh should stay inside the rendered one, or it hides parts of the entity itself
+        mesh_handle mesh = invalid_mesh_handle;
+
+        occluder() = default;
+        explicit occluder(const mesh_handle& mesh) : mesh(mesh) {}
+    };
+}
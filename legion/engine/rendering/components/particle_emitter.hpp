@@ -1,23 +1,19 @@
 #pragma once
 #include <core/core.hpp>
 #include <rendering/data/particle_system_cache.hpp>
-#include<rendering/components/point_cloud_particle_container.hpp>
+#include <rendering/data/particle_pool_cache.hpp>
 namespace legion::rendering
 {
     /**
-     * @brief Particle Emitter is the component that hold all the particles and related particle system.
+     * @brief Particle Emitter is the component that links the particle pool holding the particles of an emitter to its particle system.
+     *        The particles themselves live in the pool, so the component stays small enough to read and write every frame.
      */
     struct particle_emitter
     {
-        std::vector<ecs::entity_handle> livingParticles;
-        std::vector<ecs::entity_handle> deadParticles;
         bool playAnimation = false;
         ParticleSystemHandle particleSystemHandle;
-        bool setupCompleted;
-
-        std::vector<math::vec3> pointInput;
-        std::vector<math::vec4> colorInput;
-        point_cloud_particle_container* container;
+        particle_pool_handle pool;
+        bool setupCompleted = false;
     };
 
 
@@ -1,6 +1,9 @@
 #pragma once
 
-#include <rendering/data/Octree.hpp>
+#include <core/core.hpp>
+#include <core/data/octree.hpp>
+
+#include <memory>
 namespace legion::rendering
 {
     /**@struct point emitter
@@ -9,11 +12,9 @@ namespace legion::rendering
     struct point_emitter_data
     {
         int CurrentLOD = 0;
-        rendering::Octree<math::color>* Tree;
+        std::shared_ptr<core::octree<math::color>> Tree;
         std::vector<int> ElementsPerLOD;
-        //pos, size
+        //first slot in the particle pool, size
         std::vector<std::pair<int, int>> posRangeMap;
-        uint bufferPosition = 0;
-        uint emitterSize = 0;
     };
 }
@@ -65,6 +65,20 @@ namespace legion::rendering
         glBindBuffer(target, 0);
     }
 
+    buffer buffer::create_storage(GLenum target, size_type size, GLbitfield flags)
+    {
+        buffer result(target, GL_NONE);
+#if defined(LEGION_DEBUG)
+        if (result.m_id.value == invalid_id)
+            return result;
+#endif
+
+        glBindBuffer(target, result.m_id);
+        glBufferStorage(target, size, nullptr, flags); // Allocate immutable VRAM
+        glBindBuffer(target, 0);
+        return result;
+    }
+
     L_NODISCARD app::gl_id buffer::id() const
     {
         return m_id;
@@ -179,6 +193,55 @@ namespace legion::rendering
         glBindBuffer(m_target, 0);
     }
 
+    L_NODISCARD void* buffer::map(size_type offset, size_type size, GLbitfield access) const
+    {
+#if defined(LEGION_DEBUG)
+        if (!app::ContextHelper::getCurrentContext())
+        {
+            log::error("No current context to work with.");
+            return nullptr;
+        }
+#endif
+
+        glBindBuffer(m_target, m_id);
+        void* ptr = glMapBufferRange(m_target, offset, size, access);
+        glBindBuffer(m_target, 0);
+        return ptr;
+    }
+
+    void buffer::unmap() const
+    {
+#if defined(LEGION_DEBUG)
+        if (!app::ContextHelper::getCurrentContext())
+        {
+            log::error("No current context to work with.");
+            return;
+        }
+#endif
+
+        glBindBuffer(m_target, m_id);
+        glUnmapBuffer(m_target);
+        glBindBuffer(m_target, 0);
+    }
+
+    void buffer::bindBufferRange(uint index, size_type offset, size_type size) const
+    {
+#if defined(LEGION_DEBUG)
+        if (!app::ContextHelper::getCurrentContext())
+        {
+            log::error("No current context to work with.");
+            return;
+        }
+
+        if (m_target != GL_ATOMIC_COUNTER_BUFFER && m_target != GL_TRANSFORM_FEEDBACK_BUFFER && m_target != GL_UNIFORM_BUFFER && m_target != GL_SHADER_STORAGE_BUFFER)
+        {
+            log::error("Attempt at binding buffer range of an invalid target. Target must be GL_ATOMIC_COUNTER_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER, GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER. id: {}", m_id.value);
+            return;
+        }
+#endif
+        glBindBufferRange(m_target, index, m_id, offset, size); // Bind range to indexed buffer location.
+    }
+
     void buffer::bind() const
     {
 #if defined(LEGION_DEBUG)
@@ -53,6 +53,15 @@ namespace legion::rendering
          */
         buffer(GLenum target, GLenum usage);
 
+        /**@brief Creates a buffer with immutable storage. Created with GL_MAP_PERSISTENT_BIT the buffer can stay mapped while the GPU uses it.
+         * @note Read more at <a href="http://docs.gl/gl4/glBufferStorage">docs.gl.</a>
+         * @param target The buffer type to create. eg: GL_ARRAY_BUFFER, GL_SHADER_STORAGE_BUFFER
+         * @param size Size in bytes to allocate on VRAM.
+         * @param flags Storage flags. eg: GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+         * @note The storage can't be reallocated, so resize and bufferData calls that need more space than size will fail.
+         */
+        static buffer create_storage(GLenum target, size_type size, GLbitfield flags);
+
         /**@brief Returns the rendering API id of the buffer. Useful for low level native rendering.
          */
         L_NODISCARD app::gl_id id() const;
@@ -99,6 +108,23 @@ namespace legion::rendering
          */
         void bufferData(size_type offset, size_type size, void* data) const;
 
+        /**@brief Maps a range of the buffer into client memory.
+         * @note Read more at <a href="http://docs.gl/gl4/glMapBufferRange">docs.gl.</a>
+         * @param access Access flags. eg: GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+         * @return Pointer to the mapped memory, nullptr if the range couldn't be mapped.
+         */
+        L_NODISCARD void* map(size_type offset, size_type size, GLbitfield access) const;
+
+        /**@brief Releases the mapping created with map.
+         */
+        void unmap() const;
+
+        /**@brief Bind a range of the buffer to a set indexed buffer binding location in shaders.
+         * @note Read more at <a href="http://docs.gl/gl4/glBindBufferRange">docs.gl.</a>
+         * @note Target must be GL_ATOMIC_COUNTER_BUFFER, GL_TRANSFORM_FEEDBACK_BUFFER, GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER.
+         */
+        void bindBufferRange(uint index, size_type offset, size_type size) const;
+
         /**@brief Bind the buffer to the current context. Useful for low level native rendering.
          */
         void bind() const;
@@ -250,11 +250,76 @@ namespace legion::rendering
             m_currentVariant = 0;
     }
 
+    void material::initBlocks(id_type variantId)
+    {
+        variant_submaterial& submaterial = m_variants[variantId];
+        for (auto& blockInfo : m_shader.get_variant(variantId).uniformBlocks)
+        {
+            auto& block = submaterial.blocks.emplace_back(std::make_unique<material_uniform_block>());
+            block->binding = blockInfo.binding;
+            block->data = std140_block(static_cast<size_type>(blockInfo.size));
+
+            for (auto& member : blockInfo.members)
+            {
+                material_parameter_base* param = material_parameter_base::create_param(member.name, -1, member.type);
+                if (!param)
+                    continue;
+
+                param->m_block = &block->data;
+                param->m_blockOffset = static_cast<size_type>(member.offset);
+                submaterial.parameters.emplace(nameHash(member.name), param);
+            }
+        }
+    }
+
+    void material::initLocations(id_type variantId)
+    {
+        variant_submaterial& submaterial = m_variants[variantId];
+        submaterial.parameterOfLocation.clear();
+        for (auto& [location, id] : submaterial.idOfLocation)
+        {
+            if (location < 0 || !submaterial.parameters.count(id))
+                continue;
+
+            if (static_cast<size_type>(location) >= submaterial.parameterOfLocation.size())
+                submaterial.parameterOfLocation.resize(static_cast<size_type>(location) + 1, nullptr);
+            submaterial.parameterOfLocation[static_cast<size_type>(location)] = submaterial.parameters.at(id).get();
+        }
+    }
+
     void material::bind()
     {
+        if (m_currentVariant == 0)
+            m_currentVariant = nameHash("default");
+
         m_shader.configure_variant(m_currentVariant);
         m_shader.bind();
-        for (auto& [_, param] : m_variants[m_currentVariant].parameters)
-            param->apply(m_shader);
+
+        // When another material was bound to the program since this one, every uniform needs to be set again. Otherwise only the ones that changed.
+        shader_variant& variant = m_shader.get_variant(m_currentVariant);
+        const bool force = variant.boundMaterial != this;
+
+        variant_submaterial& submaterial = m_variants[m_currentVariant];
+        for (auto& [_, param] : submaterial.parameters)
+            param->apply(m_shader, force);
+
+        for (auto& block : submaterial.blocks)
+        {
+            std140_block& data = block->data;
+            if (block->uniformBuffer.target() != GL_UNIFORM_BUFFER)
+            {
+                block->uniformBuffer = buffer(GL_UNIFORM_BUFFER, data.size(), const_cast<byte*>(data.data()), GL_DYNAMIC_DRAW);
+                data.clear_dirty();
+            }
+            else if (data.dirty())
+            {
+                block->uniformBuffer.bufferData(data.dirty_begin(), data.dirty_end() - data.dirty_begin(), const_cast<byte*>(data.data() + data.dirty_begin()));
+                data.clear_dirty();
+            }
+
+            block->uniformBuffer.bindBufferBase(block->binding);
+        }
+
+        variant.boundMaterial = this;
     }
 }
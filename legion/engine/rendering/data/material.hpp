@@ -1,5 +1,7 @@
 #pragma once
 #include <rendering/data/shader.hpp>
+#include <rendering/data/buffer.hpp>
+#include <rendering/util/std140.hpp>
 #include <memory>
 #include <core/filesystem/filesystem.hpp>
 #include <rendering/util/matini.hpp>
@@ -25,6 +27,11 @@ namespace legion::rendering
         id_type m_id;
         id_type m_typeId;
         GLint m_location;
+        //set when the value changed since it was last applied to the shader
+        bool m_dirty = true;
+        //parameters inside of a uniform block write their value into the block instead of being applied as uniforms
+        std140_block* m_block = nullptr;
+        size_type m_blockOffset = 0;
 
         material_parameter_base(const std::string& name, GLint location, id_type typeId) : m_name(name), m_id(nameHash(name)), m_typeId(typeId), m_location(location) {}
 
@@ -38,8 +45,9 @@ namespace legion::rendering
         L_NODISCARD std::string get_name() const { return m_name; }
 
         /**@internal
+         * @brief Applies the value to the shader if it changed since it was last applied, or always if force is set.
          */
-        virtual void apply(shader_handle& shader) LEGION_PURE;
+        virtual void apply(shader_handle& shader, bool force) LEGION_PURE;
         /**@endinternal
         */
     };
@@ -54,23 +62,78 @@ namespace legion::rendering
         friend struct material;
     private:
         T m_value;
+        //the uniform is looked up once instead of on every bind
+        uniform<T> m_uniform = uniform<T>(nullptr);
+        bool m_resolved = false;
 
-        virtual void apply(shader_handle& shader) override
+        virtual void apply(shader_handle& shader, bool force) override
         {
-            shader.get_uniform<T>(m_id).set_value(m_value);
+            if (m_block)
+                return;
+
+            //texture units are shared by every program, so textures are always bound again
+            if (!m_dirty && !force && !std::is_same_v<T, texture_handle>)
+                return;
+
+            if (!m_resolved)
+            {
+                m_uniform = shader.get_uniform<T>(m_id);
+                m_resolved = true;
+            }
+
+            m_uniform.set_value(m_value);
+            m_dirty = false;
         }
     public:
         material_parameter(const std::string& name, GLint location) : material_parameter_base(name, location, typeHash<T>()) {}
 
-        void set_value(const T& value) { m_value = value; }
+        void set_value(const T& value)
+        {
+            if (m_block)
+            {
+                m_block->write(m_blockOffset, value);
+                m_value = value;
+                return;
+            }
+
+            if (!m_dirty && m_value == value)
+                return;
+
+            m_value = value;
+            m_dirty = true;
+        }
+
         T get_value() const { return m_value; }
     };
 
+    /**@struct material_uniform_block
+     * @brief Values of the parameters of a material in a single std140 uniform block of the shader.
+     *        Only the bytes that changed since the last bind get uploaded.
+     */
+    struct material_uniform_block
+    {
+        GLuint binding;
+        std140_block data;
+        buffer uniformBuffer;
+    };
+
     struct variant_submaterial
     {
         std::string name;
         std::unordered_map<id_type, std::unique_ptr<material_parameter_base>> parameters;
         std::unordered_map<GLint, id_type> idOfLocation;
+        //parameters indexed by location, so the parameters at the SV_ locations can be found without hashing
+        std::vector<material_parameter_base*> parameterOfLocation;
+        std::vector<std::unique_ptr<material_uniform_block>> blocks;
+
+        /**@brief Returns the parameter at a location, nullptr if there is none.
+         */
+        L_NODISCARD material_parameter_base* find_param(GLint location) const
+        {
+            if (location < 0 || static_cast<size_type>(location) >= parameterOfLocation.size())
+                return nullptr;
+            return parameterOfLocation[static_cast<size_type>(location)];
+        }
     };
 
     /**@class material
@@ -90,6 +153,7 @@ namespace legion::rendering
         {
             m_shader = shader;
             for (auto& [variantId, variantInfo] : m_shader.get_uniform_info())
+            {
                 for (auto& [name, location, type] : variantInfo)
                 {
                     id_type hash = nameHash(name);
@@ -97,8 +161,15 @@ namespace legion::rendering
                     m_variants[variantId].parameters.emplace(hash, material_parameter_base::create_param(name, location, type));
                     m_variants[variantId].idOfLocation[location] = hash;
                 }
+
+                initBlocks(variantId);
+                initLocations(variantId);
+            }
         }
 
+        void initBlocks(id_type variantId);
+        void initLocations(id_type variantId);
+
         std::string m_name;
         id_type m_currentVariant = 0;
         std::unordered_map<id_type, variant_submaterial> m_variants;
@@ -142,6 +213,13 @@ namespace legion::rendering
         template<typename T>
         void set_param(GLint location, const T& value);
 
+        /**@brief Set the value of a parameter by location if the material has a parameter of that type there.
+         *        Cheaper than has_param followed by set_param.
+         * @return Whether the material has the parameter.
+         */
+        template<typename T>
+        bool try_set_param(GLint location, const T& value);
+
         /**@brief Check if the material has a parameter by location.
          */
         template<typename T>
@@ -225,6 +303,13 @@ namespace legion::rendering
         template<typename T>
         void set_param(GLint location, const T& value);
 
+        /**@brief Set the value of a parameter by location if the material has a parameter of that type there.
+         *        Cheaper than has_param followed by set_param.
+         * @return Whether the material has the parameter.
+         */
+        template<typename T>
+        bool try_set_param(GLint location, const T& value);
+
         /**@brief Check if the material has a parameter by location.
          */
         template<typename T>
@@ -317,6 +402,13 @@ namespace legion::rendering
         MaterialCache::m_materials[id].set_param<T>(location, value);
     }
 
+    template<typename T>
+    bool material_handle::try_set_param(GLint location, const T& value)
+    {
+        async::readonly_guard guard(MaterialCache::m_materialLock);
+        return MaterialCache::m_materials[id].try_set_param<T>(location, value);
+    }
+
     template<typename T>
     L_NODISCARD bool material_handle::has_param(const std::string& name)
     {
@@ -388,51 +480,26 @@ namespace legion::rendering
     template<>
     inline void material::set_param<math::color>(GLint location, const math::color& value)
     {
-        if (m_currentVariant == 0)
-            m_currentVariant = nameHash("default");
-
-        variant_submaterial& submaterial = m_variants.at(m_currentVariant);
-        if (!submaterial.idOfLocation.count(location))
+        if (!try_set_param<math::vec4>(location, value))
             log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<math::color>());
+    }
 
-        id_type id = submaterial.idOfLocation[location];
-
-        if (submaterial.parameters.count(id) && submaterial.parameters[id]->type() == typeHash<math::vec4>())
-            static_cast<material_parameter<math::vec4>*>(submaterial.parameters[id].get())->set_value(value);
-        else
-            log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<math::color>());
+    template<>
+    inline bool material::try_set_param<math::color>(GLint location, const math::color& value)
+    {
+        return try_set_param<math::vec4>(location, value);
     }
 
     template<>
     L_NODISCARD inline math::color material::get_param<math::color>(GLint location)
     {
-        if (m_currentVariant == 0)
-            m_currentVariant = nameHash("default");
-
-        variant_submaterial& submaterial = m_variants.at(m_currentVariant);
-        if (!submaterial.idOfLocation.count(location))
-            log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<math::color>());
-
-        id_type id = submaterial.idOfLocation[location];
-        if (submaterial.parameters.count(id) && submaterial.parameters[id]->type() == typeHash<math::vec4>())
-            return static_cast<material_parameter<math::vec4>*>(submaterial.parameters[id].get())->get_value();
-
-        log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<math::color>());
-        return math::color();
+        return get_param<math::vec4>(location);
     }
 
     template<>
     L_NODISCARD inline bool material::has_param<math::color>(GLint location)
     {
-        if (m_currentVariant == 0)
-            m_currentVariant = nameHash("default");
-
-        variant_submaterial& submaterial = m_variants.at(m_currentVariant);
-        if (!submaterial.idOfLocation.count(location))
-            return false;
-
-        id_type id = submaterial.idOfLocation[location];
-        return submaterial.parameters.count(id) && submaterial.parameters[id]->type() == typeHash<math::vec4>();
+        return has_param<math::vec4>(location);
     }
 
     template<typename T>
@@ -477,20 +544,23 @@ namespace legion::rendering
 
     template<typename T>
     void material::set_param(GLint location, const T& value)
+    {
+        if (!try_set_param<T>(location, value))
+            log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<T>());
+    }
+
+    template<typename T>
+    bool material::try_set_param(GLint location, const T& value)
     {
         if (m_currentVariant == 0)
             m_currentVariant = nameHash("default");
 
-        variant_submaterial& submaterial = m_variants.at(m_currentVariant);
-        if (!submaterial.idOfLocation.count(location))
-            log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<T>());
-
-        id_type id = submaterial.idOfLocation[location];
+        material_parameter_base* param = m_variants.at(m_currentVariant).find_param(location);
+        if (!param || param->type() != typeHash<T>())
+            return false;
 
-        if (submaterial.parameters.count(id) && submaterial.parameters[id]->type() == typeHash<T>())
-            static_cast<material_parameter<T>*>(submaterial.parameters[id].get())->set_value(value);
-        else
-            log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<T>());
+        static_cast<material_parameter<T>*>(param)->set_value(value);
+        return true;
     }
 
     template<typename T>
@@ -499,13 +569,9 @@ namespace legion::rendering
         if (m_currentVariant == 0)
             m_currentVariant = nameHash("default");
 
-        variant_submaterial& submaterial = m_variants.at(m_currentVariant);
-        if (!submaterial.idOfLocation.count(location))
-            log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<T>());
-
-        id_type id = submaterial.idOfLocation[location];
-        if (submaterial.parameters.count(id) && submaterial.parameters[id]->type() == typeHash<T>())
-            return static_cast<material_parameter<T>*>(submaterial.parameters[id].get())->get_value();
+        material_parameter_base* param = m_variants.at(m_currentVariant).find_param(location);
+        if (param && param->type() == typeHash<T>())
+            return static_cast<material_parameter<T>*>(param)->get_value();
 
         log::warn("material {} does not have a parameter at location {} of type {}", m_name, location, nameOfType<T>());
         return T();
@@ -517,12 +583,8 @@ namespace legion::rendering
         if (m_currentVariant == 0)
             m_currentVariant = nameHash("default");
 
-        variant_submaterial& submaterial = m_variants.at(m_currentVariant);
-        if (!submaterial.idOfLocation.count(location))
-            return false;
-
-        id_type id = submaterial.idOfLocation[location];
-        return submaterial.parameters.count(id) && submaterial.parameters[id]->type() == typeHash<T>();
+        material_parameter_base* param = m_variants.at(m_currentVariant).find_param(location);
+        return param && param->type() == typeHash<T>();
     }
 #pragma endregion
 
@@ -0,0 +1,188 @@
+#include <rendering/data/mesh_megabuffer.hpp>
+#include <rendering/util/bindings.hpp>
+
+namespace legion::rendering
+{
+    namespace
+    {
+        // Creates a larger buffer with the contents of the old one.
+        buffer growBuffer(const buffer& oldBuffer, GLenum target, size_type oldSize, size_type newSize)
+        {
+            buffer newBuffer(target, newSize, nullptr, GL_STATIC_DRAW);
+            if (oldSize == 0)
+                return newBuffer;
+
+            glBindBuffer(GL_COPY_READ_BUFFER, oldBuffer.id());
+            glBindBuffer(GL_COPY_WRITE_BUFFER, newBuffer.id());
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, oldSize);
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            return newBuffer;
+        }
+
+        // Uploads the vertex attribute of a mesh, attributes the mesh doesn't have are filled with zeros.
+        template<typename T>
+        void uploadAttribute(const buffer& target, const std::vector<T>& data, size_type firstVertex, size_type vertexCount)
+        {
+            if (data.size() >= vertexCount)
+            {
+                target.bufferData(firstVertex * sizeof(T), vertexCount * sizeof(T), const_cast<T*>(data.data()));
+                return;
+            }
+
+            std::vector<T> padded(data);
+            //value initialized, so zero for every attribute type, math::color can't be made from a scalar
+            padded.resize(vertexCount, T{});
+            target.bufferData(firstVertex * sizeof(T), vertexCount * sizeof(T), padded.data());
+        }
+    }
+
+    const packed_model* mesh_megabuffer::pack(model_handle model)
+    {
+        if (auto* packed = m_layout.get(model.id))
+            return packed;
+
+        if (m_unpackable.count(model.id))
+            return nullptr;
+
+        //the version is read before the data, if the mesh changes in between it is packed again after the next evict_changed
+        const uint64 version = MeshCache::get_version(model.id);
+        auto meshHandle = MeshCache::get_handle(model.id);
+        if (!meshHandle || version == 0)
+        {
+            m_unpackable.insert(model.id);
+            return nullptr;
+        }
+
+        OPTICK_EVENT();
+        auto [lock, mesh] = meshHandle.get();
+        async::readonly_guard guard(lock);
+
+        if (mesh.filePath.empty() || mesh.vertices.empty() || mesh.indices.empty() || mesh.submeshes.empty())
+        {
+            m_unpackable.insert(model.id);
+            return nullptr;
+        }
+
+        const size_type vertexCount = mesh.vertices.size();
+        const size_type indexCount = mesh.indices.size();
+        const packed_model& packed = m_layout.add(model.id, vertexCount, indexCount, mesh.submeshes);
+        m_versions[model.id] = version;
+        reserve(m_layout.vertex_count(), m_layout.index_count());
+
+        uploadAttribute(m_vertexBuffer, mesh.vertices, packed.baseVertex, vertexCount);
+        uploadAttribute(m_colorBuffer, mesh.colors, packed.baseVertex, vertexCount);
+        uploadAttribute(m_normalBuffer, mesh.normals, packed.baseVertex, vertexCount);
+        uploadAttribute(m_uvBuffer, mesh.uvs, packed.baseVertex, vertexCount);
+        uploadAttribute(m_tangentBuffer, mesh.tangents, packed.baseVertex, vertexCount);
+        m_indexBuffer.bufferData(packed.firstIndex * sizeof(uint), indexCount * sizeof(uint), mesh.indices.data());
+
+        return &packed;
+    }
+
+    L_NODISCARD const packed_model* mesh_megabuffer::get(id_type modelId) const
+    {
+        return m_layout.get(modelId);
+    }
+
+    void mesh_megabuffer::evict_changed()
+    {
+        const uint64 generation = MeshCache::generation();
+        if (generation == m_meshGeneration)
+            return;
+
+        OPTICK_EVENT();
+        m_meshGeneration = generation;
+
+        //meshes that didn't exist yet or were replaced may be packable now
+        m_unpackable.clear();
+
+        m_changed.clear();
+        for (auto& [id, version] : m_versions)
+            if (MeshCache::get_version(id) != version)
+                m_changed.push_back(id);
+
+        for (id_type id : m_changed)
+        {
+            m_layout.remove(id);
+            m_versions.erase(id);
+        }
+    }
+
+    void mesh_megabuffer::bind_matrix_buffer(const buffer& matrixBuffer)
+    {
+        if (m_matrixBufferId == matrixBuffer.id() || m_vertexCapacity == 0)
+            return;
+
+        m_vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 0, 4, GL_FLOAT, false, sizeof(math::mat4), 0 * sizeof(math::mat4::col_type));
+        m_vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 1, 4, GL_FLOAT, false, sizeof(math::mat4), 1 * sizeof(math::mat4::col_type));
+        m_vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 2, 4, GL_FLOAT, false, sizeof(math::mat4), 2 * sizeof(math::mat4::col_type));
+        m_vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 3, 4, GL_FLOAT, false, sizeof(math::mat4), 3 * sizeof(math::mat4::col_type));
+
+        m_vertexArray.setAttribDivisor(SV_MODELMATRIX + 0, 1);
+        m_vertexArray.setAttribDivisor(SV_MODELMATRIX + 1, 1);
+        m_vertexArray.setAttribDivisor(SV_MODELMATRIX + 2, 1);
+        m_vertexArray.setAttribDivisor(SV_MODELMATRIX + 3, 1);
+
+        m_matrixBufferId = matrixBuffer.id();
+    }
+
+    void mesh_megabuffer::bind() const
+    {
+        m_vertexArray.bind();
+        m_indexBuffer.bind();
+    }
+
+    void mesh_megabuffer::release() const
+    {
+        m_indexBuffer.release();
+        m_vertexArray.release();
+    }
+
+    void mesh_megabuffer::reserve(size_type vertexCount, size_type indexCount)
+    {
+        if (vertexCount <= m_vertexCapacity && indexCount <= m_indexCapacity)
+            return;
+
+        OPTICK_EVENT();
+        if (m_vertexCapacity == 0)
+            m_vertexArray = vertexarray::generate();
+
+        if (vertexCount > m_vertexCapacity)
+        {
+            const size_type oldCapacity = m_vertexCapacity;
+            size_type newCapacity = math::max(oldCapacity, initial_vertex_capacity);
+            while (newCapacity < vertexCount)
+                newCapacity *= 2;
+
+            //the layout may already contain the model that is being packed, so the whole old buffer is copied
+            m_vertexBuffer = growBuffer(m_vertexBuffer, GL_ARRAY_BUFFER, oldCapacity * sizeof(math::vec3), newCapacity * sizeof(math::vec3));
+            m_colorBuffer = growBuffer(m_colorBuffer, GL_ARRAY_BUFFER, oldCapacity * sizeof(math::color), newCapacity * sizeof(math::color));
+            m_normalBuffer = growBuffer(m_normalBuffer, GL_ARRAY_BUFFER, oldCapacity * sizeof(math::vec3), newCapacity * sizeof(math::vec3));
+            m_uvBuffer = growBuffer(m_uvBuffer, GL_ARRAY_BUFFER, oldCapacity * sizeof(math::vec2), newCapacity * sizeof(math::vec2));
+            m_tangentBuffer = growBuffer(m_tangentBuffer, GL_ARRAY_BUFFER, oldCapacity * sizeof(math::vec3), newCapacity * sizeof(math::vec3));
+            m_vertexCapacity = newCapacity;
+
+            setVertexAttributes();
+        }
+
+        if (indexCount > m_indexCapacity)
+        {
+            size_type newCapacity = math::max(m_indexCapacity, initial_index_capacity);
+            while (newCapacity < indexCount)
+                newCapacity *= 2;
+
+            m_indexBuffer = growBuffer(m_indexBuffer, GL_ELEMENT_ARRAY_BUFFER, m_indexCapacity * sizeof(uint), newCapacity * sizeof(uint));
+            m_indexCapacity = newCapacity;
+        }
+    }
+
+    void mesh_megabuffer::setVertexAttributes()
+    {
+        m_vertexArray.setAttribPointer(m_vertexBuffer, SV_POSITION, 3, GL_FLOAT, false, 0, 0);
+        m_vertexArray.setAttribPointer(m_colorBuffer, SV_COLOR, 4, GL_FLOAT, false, 0, 0);
+        m_vertexArray.setAttribPointer(m_normalBuffer, SV_NORMAL, 3, GL_FLOAT, false, 0, 0);
+        m_vertexArray.setAttribPointer(m_uvBuffer, SV_TEXCOORD0, 2, GL_FLOAT, false, 0, 0);
+        m_vertexArray.setAttribPointer(m_tangentBuffer, SV_TANGENT, 3, GL_FLOAT, false, 0, 0);
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <application/application.hpp>
+#include <rendering/data/buffer.hpp>
+#include <rendering/data/vertexarray.hpp>
+#include <rendering/data/model.hpp>
+#include <rendering/util/indirect_commands.hpp>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @file mesh_megabuffer.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@class mesh_megabuffer
+     * @brief Shared vertex and index buffers that static meshes are packed into, so all of them can be drawn with one vertex array
+     *        and many meshes can be drawn with a single glMultiDrawElementsIndirect.
+     * @note Only meshes imported from a file are packed, meshes generated at runtime (like fracture fragments) come and go too often
+     *       and are drawn with their own vertex array, just like models of which buffers were overwritten.
+     */
+    class mesh_megabuffer
+    {
+    public:
+        static constexpr size_type initial_vertex_capacity = 1 << 16;
+        static constexpr size_type initial_index_capacity = 1 << 18;
+
+        /**@brief Copies the mesh of a model into the shared buffers, if it isn't in there yet. Needs a current context.
+         * @return The placement of the model in the shared buffers, nullptr if the model can't be packed.
+         */
+        const packed_model* pack(model_handle model);
+
+        /**@brief Returns the placement of a model, nullptr if the model wasn't packed.
+         */
+        L_NODISCARD const packed_model* get(id_type modelId) const;
+
+        /**@brief Frees the space of models of which the mesh was destroyed or replaced since it was packed, changed meshes are packed again by the next pack.
+         *        Only checks the packed models when any mesh changed, so it is cheap to call every frame.
+         */
+        void evict_changed();
+
+        /**@brief Points the per instance model matrix attributes to a buffer, only does work when the buffer changed. Needs a current context.
+         */
+        void bind_matrix_buffer(const buffer& matrixBuffer);
+
+        /**@brief Binds the shared vertex array and index buffer.
+         */
+        void bind() const;
+        void release() const;
+
+    private:
+        mesh_pack_layout m_layout;
+        std::unordered_set<id_type> m_unpackable;
+        //version of the mesh of every packed model at the time it was packed, see MeshCache::get_version
+        std::unordered_map<id_type, uint64> m_versions;
+        std::vector<id_type> m_changed;
+        uint64 m_meshGeneration = 0;
+
+        vertexarray m_vertexArray;
+        buffer m_vertexBuffer;
+        buffer m_colorBuffer;
+        buffer m_normalBuffer;
+        buffer m_uvBuffer;
+        buffer m_tangentBuffer;
+        buffer m_indexBuffer;
+
+        size_type m_vertexCapacity = 0;
+        size_type m_indexCapacity = 0;
+        app::gl_id m_matrixBufferId = invalid_id;
+
+        /**@brief Makes sure the buffers can hold at least the given number of vertices and indices, copying over what is already in them.
+         */
+        void reserve(size_type vertexCount, size_type indexCount);
+        void setVertexAttributes();
+    };
+}
@@ -20,6 +20,11 @@ namespace legion::rendering
         ModelCache::buffer_model(id, matrixBuffer);
     }
 
+    void model_handle::bind_matrix_buffer(const buffer& matrixBuffer) const
+    {
+        ModelCache::bind_matrix_buffer(id, matrixBuffer);
+    }
+
     void model_handle::overwrite_buffer(buffer& newBuffer, uint bufferID, bool perInstance) const
     {
         ModelCache::overwrite_buffer(id, newBuffer, bufferID, perInstance);
@@ -35,6 +40,19 @@ namespace legion::rendering
         return ModelCache::get_model(id);
     }
 
+    mesh_bounds model_handle::get_bounds() const
+    {
+        return ModelCache::get_bounds(id);
+    }
+
+    mesh_bounds ModelCache::get_bounds(id_type id)
+    {
+        async::readonly_guard guard(m_modelLock);
+        if (!m_models.contains(id))
+            return mesh_bounds::infinite();
+        return m_models[id].bounds;
+    }
+
     const model& ModelCache::get_model(id_type id)
     {
         async::readonly_guard guard(m_modelLock);
@@ -60,6 +78,7 @@ namespace legion::rendering
         auto [lock, mesh] = mesh_handle.get();
         async::readonly_multiguard guard(m_modelLock, lock);
         auto& model = m_models[id];
+        model.packable = false;
         if (bufferID == SV_COLOR)
         {
             model.vertexArray.setAttribPointer(newBuffer, SV_COLOR, 4, GL_FLOAT, false, 0, 0);
@@ -67,6 +86,21 @@ namespace legion::rendering
         }
     }
 
+    void ModelCache::setMatrixAttributes(model& model, const buffer& matrixBuffer)
+    {
+        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 0, 4, GL_FLOAT, false, sizeof(math::mat4), 0 * sizeof(math::mat4::col_type));
+        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 1, 4, GL_FLOAT, false, sizeof(math::mat4), 1 * sizeof(math::mat4::col_type));
+        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 2, 4, GL_FLOAT, false, sizeof(math::mat4), 2 * sizeof(math::mat4::col_type));
+        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 3, 4, GL_FLOAT, false, sizeof(math::mat4), 3 * sizeof(math::mat4::col_type));
+
+        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 0, 1);
+        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 1, 1);
+        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 2, 1);
+        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 3, 1);
+
+        model.matrixBufferId = matrixBuffer.id();
+    }
+
     void ModelCache::buffer_model(id_type id, const buffer& matrixBuffer)
     {
         if (id == invalid_id)
@@ -98,19 +132,23 @@ namespace legion::rendering
         model.uvBuffer = buffer(GL_ARRAY_BUFFER, mesh.uvs, GL_STATIC_DRAW);
         model.vertexArray.setAttribPointer(model.uvBuffer, SV_TEXCOORD0, 2, GL_FLOAT, false, 0, 0);
 
-        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 0, 4, GL_FLOAT, false, sizeof(math::mat4), 0 * sizeof(math::mat4::col_type));
-        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 1, 4, GL_FLOAT, false, sizeof(math::mat4), 1 * sizeof(math::mat4::col_type));
-        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 2, 4, GL_FLOAT, false, sizeof(math::mat4), 2 * sizeof(math::mat4::col_type));
-        model.vertexArray.setAttribPointer(matrixBuffer, SV_MODELMATRIX + 3, 4, GL_FLOAT, false, sizeof(math::mat4), 3 * sizeof(math::mat4::col_type));
-
-        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 0, 1);
-        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 1, 1);
-        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 2, 1);
-        model.vertexArray.setAttribDivisor(SV_MODELMATRIX + 3, 1);
+        setMatrixAttributes(model, matrixBuffer);
 
         model.buffered = true;
     }
 
+    void ModelCache::bind_matrix_buffer(id_type id, const buffer& matrixBuffer)
+    {
+        if (id == invalid_id)
+            return;
+
+        async::readonly_guard guard(m_modelLock);
+        if (!m_models.contains(id))
+            return;
+
+        setMatrixAttributes(m_models[id], matrixBuffer);
+    }
+
     model_handle ModelCache::create_model(const std::string& name, const fs::view& file, mesh_import_settings settings)
     {
         id_type id = nameHash(name);
@@ -148,6 +186,7 @@ namespace legion::rendering
 
         for (auto& submeshData : data.submeshes)
             model.submeshes.push_back(submeshData);
+        model.bounds = data.bounds;
 
         // The model still needs to be buffered on the rendering thread.
         model.buffered = false;
@@ -318,6 +357,7 @@ namespace legion::rendering
 
             for (auto& submeshData : data.submeshes)
                 model.submeshes.push_back(submeshData);
+            model.bounds = data.bounds;
         }
 
         // The model still needs to be buffered on the rendering thread.
@@ -366,6 +406,7 @@ namespace legion::rendering
 
             for (auto& submeshData : data.submeshes)
                 model.submeshes.push_back(submeshData);
+            model.bounds = data.bounds;
         }
 
         // The model still needs to be buffered on the rendering thread.
@@ -414,6 +455,7 @@ namespace legion::rendering
 
             for (auto& submeshData : data.submeshes)
                 model.submeshes.push_back(submeshData);
+            model.bounds = data.bounds;
         }
 
         // The model still needs to be buffered on the rendering thread.
@@ -460,6 +502,7 @@ namespace legion::rendering
 
             for (auto& submeshData : data.submeshes)
                 model.submeshes.push_back(submeshData);
+            model.bounds = data.bounds;
         }
 
         // The model still needs to be buffered on the rendering thread.
@@ -507,6 +550,7 @@ namespace legion::rendering
 
             for (auto& submeshData : data.submeshes)
                 model.submeshes.push_back(submeshData);
+            model.bounds = data.bounds;
         }
 
         // The model still needs to be buffered on the rendering thread.
@@ -554,6 +598,7 @@ namespace legion::rendering
 
             for (auto& submeshData : data.submeshes)
                 model.submeshes.push_back(submeshData);
+            model.bounds = data.bounds;
         }
 
         // The model still needs to be buffered on the rendering thread.
@@ -30,6 +30,15 @@ namespace legion::rendering
         buffer indexBuffer;
 
         std::vector<sub_mesh> submeshes;
+
+        //local space bounds of the mesh, copied when the model is created so culling doesn't need to lock the mesh
+        mesh_bounds bounds;
+
+        //the buffer the per instance model matrices are read from, the vertex array needs to be rebound when it changes
+        app::gl_id matrixBufferId = invalid_id;
+
+        //models of which buffers were overwritten can't be drawn from the shared mesh buffers
+        bool packable = true;
     };
 
     /**@class model_handle
@@ -44,8 +53,16 @@ namespace legion::rendering
         void buffer_data(const buffer& matrixBuffer) const;
         void overwrite_buffer(buffer& newBuffer, uint bufferID, bool perInstance = false) const;
 
+        /**@brief Points the per instance model matrix attributes of an already buffered model to a different buffer.
+         */
+        void bind_matrix_buffer(const buffer& matrixBuffer) const;
+
         mesh_handle get_mesh() const;
         const model& get_model() const;
+
+        /**@brief Get the local space bounds of the model, infinite bounds if the model doesn't exist.
+         */
+        mesh_bounds get_bounds() const;
     };
 
     constexpr model_handle invalid_model_handle { invalid_id };
@@ -62,12 +79,15 @@ namespace legion::rendering
         static std::unordered_map<id_type, std::string> m_modelNames;
 
         static const model& get_model(id_type id);
+        static void setMatrixAttributes(model& model, const buffer& matrixBuffer);
 
     public:
         static std::string get_model_name(id_type id);
+        static mesh_bounds get_bounds(id_type id);
 
         static void overwrite_buffer(id_type id, buffer& newBuffer, uint bufferID, bool perInstance = false);
         static void buffer_model(id_type id, const buffer& matrixBuffer);
+        static void bind_matrix_buffer(id_type id, const buffer& matrixBuffer);
         static model_handle create_model(const std::string& name, const fs::view& file, mesh_import_settings settings = default_mesh_settings);
         static model_handle create_model(const std::string& name, const fs::view& file, std::vector<material_handle>& materials, mesh_import_settings settings = default_mesh_settings);
         static model_handle create_model(const std::string& name);
@@ -0,0 +1,380 @@
+#pragma once
+#include <core/core.hpp>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
+/**
+ * @file particle_pool.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@class particle_pool
+     * @brief Fixed size pool of particles stored as a structure of arrays, so the simulation kernels can process 4 particles at a time.
+     *        Slots are handed out by bumping a high water mark and are recycled through a lock-free free list,
+     *        so particles can be spawned and killed from multiple jobs at the same time.
+     *        Dead slots have a negative lifetime, particles that never die have an infinite lifetime.
+     * @note Only uses core, so it can be run and tested without a graphics context.
+     */
+    class particle_pool
+    {
+    public:
+        static constexpr uint32 invalid_index = std::numeric_limits<uint32>::max();
+
+        explicit particle_pool(size_type capacity) :
+            m_capacity(static_cast<uint32>(capacity)),
+            m_positionX(capacity, 0.f), m_positionY(capacity, 0.f), m_positionZ(capacity, 0.f),
+            m_velocityX(capacity, 0.f), m_velocityY(capacity, 0.f), m_velocityZ(capacity, 0.f),
+            m_age(capacity, 0.f), m_lifetime(capacity, -1.f), m_colors(capacity, math::colors::white),
+            m_next(new std::atomic<uint32>[capacity])
+        {
+        }
+
+        particle_pool(const particle_pool&) = delete;
+        particle_pool& operator=(const particle_pool&) = delete;
+
+        /**@brief Takes a free slot and initializes the particle in it. Safe to call from multiple threads, and at the same time as kill.
+         * @param lifetime Time in seconds until the particle gets killed by the age kernel, infinity for particles that live until they're killed.
+         * @return Index of the particle, or invalid_index if the pool is full.
+         */
+        uint32 spawn(const math::vec3& position, const math::vec3& velocity, const math::color& color, float lifetime)
+        {
+            uint32 index = popFree();
+            if (index == invalid_index)
+            {
+                uint32 slot = m_highWater.load(std::memory_order_relaxed);
+                do
+                {
+                    if (slot >= m_capacity)
+                        return invalid_index;
+                } while (!m_highWater.compare_exchange_weak(slot, slot + 1, std::memory_order_acq_rel, std::memory_order_relaxed));
+                index = slot;
+            }
+
+            m_positionX[index] = position.x;
+            m_positionY[index] = position.y;
+            m_positionZ[index] = position.z;
+            m_velocityX[index] = velocity.x;
+            m_velocityY[index] = velocity.y;
+            m_velocityZ[index] = velocity.z;
+            m_age[index] = 0.f;
+            m_lifetime[index] = lifetime;
+            m_colors[index] = color;
+
+            m_aliveCount.fetch_add(1, std::memory_order_relaxed);
+            m_version.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+
+        /**@brief Kills a living particle and returns its slot to the free list. Safe to call from multiple threads, as long as every particle is only killed once.
+         * @return False if the particle was already dead.
+         */
+        bool kill(uint32 index)
+        {
+            if (index >= m_highWater.load(std::memory_order_relaxed) || m_lifetime[index] < 0.f)
+                return false;
+
+            //dead slots keep getting integrated, without velocity they stay put
+            m_velocityX[index] = 0.f;
+            m_velocityY[index] = 0.f;
+            m_velocityZ[index] = 0.f;
+            m_lifetime[index] = -1.f;
+
+            pushFree(index);
+            m_aliveCount.fetch_sub(1, std::memory_order_relaxed);
+            m_version.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**@brief Kills every particle and resets the slots, so the next particles are spawned in consecutive slots again. Not thread safe.
+         */
+        void clear()
+        {
+            std::fill_n(m_lifetime.begin(), m_highWater.load(std::memory_order_relaxed), -1.f);
+            m_highWater.store(0, std::memory_order_relaxed);
+            m_freeHead.store(invalid_index, std::memory_order_relaxed);
+            m_aliveCount.store(0, std::memory_order_relaxed);
+            m_version.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**@brief Moves the particles in the slots [start, end) along their velocity and then accelerates them.
+         *        Dead slots are processed too, that is cheaper than skipping them.
+         */
+        void integrate(size_type start, size_type end, float deltaTime)
+        {
+            OPTICK_EVENT();
+            end = math::min(end, static_cast<size_type>(m_highWater.load(std::memory_order_acquire)));
+            size_type i = start;
+
+#if defined(LEGION_SSE)
+            const __m128 dt = _mm_set1_ps(deltaTime);
+            const __m128 accelerationX = _mm_set1_ps(m_acceleration.x * deltaTime);
+            const __m128 accelerationY = _mm_set1_ps(m_acceleration.y * deltaTime);
+            const __m128 accelerationZ = _mm_set1_ps(m_acceleration.z * deltaTime);
+
+            for (; i + 4 <= end; i += 4)
+            {
+                //dead slots don't get accelerated, otherwise they would drift off after they were killed
+                const __m128 alive = _mm_cmpge_ps(_mm_loadu_ps(m_lifetime.data() + i), _mm_setzero_ps());
+
+                __m128 vx = _mm_loadu_ps(m_velocityX.data() + i);
+                __m128 vy = _mm_loadu_ps(m_velocityY.data() + i);
+                __m128 vz = _mm_loadu_ps(m_velocityZ.data() + i);
+
+                _mm_storeu_ps(m_positionX.data() + i, _mm_add_ps(_mm_loadu_ps(m_positionX.data() + i), _mm_mul_ps(vx, dt)));
+                _mm_storeu_ps(m_positionY.data() + i, _mm_add_ps(_mm_loadu_ps(m_positionY.data() + i), _mm_mul_ps(vy, dt)));
+                _mm_storeu_ps(m_positionZ.data() + i, _mm_add_ps(_mm_loadu_ps(m_positionZ.data() + i), _mm_mul_ps(vz, dt)));
+
+                _mm_storeu_ps(m_velocityX.data() + i, _mm_add_ps(vx, _mm_and_ps(accelerationX, alive)));
+                _mm_storeu_ps(m_velocityY.data() + i, _mm_add_ps(vy, _mm_and_ps(accelerationY, alive)));
+                _mm_storeu_ps(m_velocityZ.data() + i, _mm_add_ps(vz, _mm_and_ps(accelerationZ, alive)));
+            }
+#endif
+
+            for (; i < end; i++)
+            {
+                m_positionX[i] += m_velocityX[i] * deltaTime;
+                m_positionY[i] += m_velocityY[i] * deltaTime;
+                m_positionZ[i] += m_velocityZ[i] * deltaTime;
+
+                if (m_lifetime[i] < 0.f)
+                    continue;
+
+                m_velocityX[i] += m_acceleration.x * deltaTime;
+                m_velocityY[i] += m_acceleration.y * deltaTime;
+                m_velocityZ[i] += m_acceleration.z * deltaTime;
+            }
+        }
+
+        /**@brief Ages the particles in the slots [start, end) and kills the ones that outlived their lifetime.
+         * @return Number of particles that were killed.
+         */
+        size_type age(size_type start, size_type end, float deltaTime)
+        {
+            OPTICK_EVENT();
+            end = math::min(end, static_cast<size_type>(m_highWater.load(std::memory_order_acquire)));
+            size_type killed = 0;
+            size_type i = start;
+
+#if defined(LEGION_SSE)
+            const __m128 dt = _mm_set1_ps(deltaTime);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (; i + 4 <= end; i += 4)
+            {
+                const __m128 age = _mm_add_ps(_mm_loadu_ps(m_age.data() + i), dt);
+                const __m128 lifetime = _mm_loadu_ps(m_lifetime.data() + i);
+                _mm_storeu_ps(m_age.data() + i, age);
+
+                const int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmpge_ps(age, lifetime), _mm_cmpge_ps(lifetime, zero)));
+                if (!mask)
+                    continue;
+
+                for (int lane = 0; lane < 4; lane++)
+                    if (mask & (1 << lane))
+                        killed += kill(static_cast<uint32>(i + lane)) ? 1 : 0;
+            }
+#endif
+
+            for (; i < end; i++)
+            {
+                m_age[i] += deltaTime;
+                if (m_lifetime[i] >= 0.f && m_age[i] >= m_lifetime[i])
+                    killed += kill(static_cast<uint32>(i)) ? 1 : 0;
+            }
+
+            return killed;
+        }
+
+        /**@brief Writes the world matrix and color of every living particle in the slots [start, end), in slot order.
+         * @param instances Array that receives the world matrices, or nullptr when only the colors are needed.
+         * @param colors Array that receives the colors, or nullptr when only the world matrices are needed.
+         * @return Number of particles that were written, never more than maxCount.
+         */
+        size_type write_instances(size_type start, size_type end, math::mat4* instances, math::color* colors, size_type maxCount) const
+        {
+            OPTICK_EVENT();
+            end = math::min(end, static_cast<size_type>(m_highWater.load(std::memory_order_acquire)));
+
+            math::mat4 matrix = math::scale(math::mat4(1.f), m_scale);
+            size_type written = 0;
+            for (size_type i = start; i < end && written < maxCount; i++)
+            {
+                if (m_lifetime[i] < 0.f)
+                    continue;
+
+                if (instances)
+                {
+                    matrix[3] = math::vec4(m_positionX[i], m_positionY[i], m_positionZ[i], 1.f);
+                    instances[written] = matrix;
+                }
+                if (colors)
+                    colors[written] = m_colors[i];
+                written++;
+            }
+
+            return written;
+        }
+
+        /**@brief Writes the world matrix and color of every living particle.
+         */
+        size_type write_instances(math::mat4* instances, math::color* colors, size_type maxCount) const
+        {
+            return write_instances(0, m_capacity, instances, colors, maxCount);
+        }
+
+        L_NODISCARD bool alive(uint32 index) const noexcept { return index < m_highWater.load(std::memory_order_relaxed) && m_lifetime[index] >= 0.f; }
+
+        L_NODISCARD math::vec3 position(uint32 index) const { return math::vec3(m_positionX[index], m_positionY[index], m_positionZ[index]); }
+        L_NODISCARD math::vec3 velocity(uint32 index) const { return math::vec3(m_velocityX[index], m_velocityY[index], m_velocityZ[index]); }
+        L_NODISCARD const math::color& color(uint32 index) const { return m_colors[index]; }
+        L_NODISCARD float age(uint32 index) const { return m_age[index]; }
+        L_NODISCARD float lifetime(uint32 index) const { return m_lifetime[index]; }
+
+        void set_velocity(uint32 index, const math::vec3& velocity)
+        {
+            m_velocityX[index] = velocity.x;
+            m_velocityY[index] = velocity.y;
+            m_velocityZ[index] = velocity.z;
+        }
+
+        void set_color(uint32 index, const math::color& color)
+        {
+            m_colors[index] = color;
+            m_version.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**@brief Acceleration applied to every living particle, eg: gravity.
+         */
+        void set_acceleration(const math::vec3& acceleration) noexcept { m_acceleration = acceleration; }
+        L_NODISCARD const math::vec3& acceleration() const noexcept { return m_acceleration; }
+
+        /**@brief Material and model the particles are drawn with, and the scale of every particle.
+         */
+        void set_appearance(id_type material, id_type model, const math::vec3& scale) noexcept
+        {
+            m_material = material;
+            m_model = model;
+            m_scale = scale;
+        }
+
+        L_NODISCARD id_type material() const noexcept { return m_material; }
+        L_NODISCARD id_type model() const noexcept { return m_model; }
+
+        L_NODISCARD size_type capacity() const noexcept { return m_capacity; }
+        L_NODISCARD size_type alive_count() const noexcept { return m_aliveCount.load(std::memory_order_relaxed); }
+
+        /**@brief Number of slots that were ever used since the last clear, the kernels don't need to look past it.
+         */
+        L_NODISCARD size_type high_water() const noexcept { return m_highWater.load(std::memory_order_acquire); }
+
+        /**@brief Changes every time a particle is spawned or killed or a color changes, so the users of the colors know when to upload them again.
+         */
+        L_NODISCARD size_type version() const noexcept { return m_version.load(std::memory_order_relaxed); }
+
+        /**@brief Lock that is held for writing while the pool is simulated and for reading while it's written to the instance buffer.
+         *        The functions of the pool don't take it themselves.
+         */
+        L_NODISCARD async::rw_spinlock& get_lock() const noexcept { return m_lock; }
+
+    private:
+        uint32 m_capacity;
+
+        std::vector<float> m_positionX;
+        std::vector<float> m_positionY;
+        std::vector<float> m_positionZ;
+        std::vector<float> m_velocityX;
+        std::vector<float> m_velocityY;
+        std::vector<float> m_velocityZ;
+        std::vector<float> m_age;
+        std::vector<float> m_lifetime;
+        std::vector<math::color> m_colors;
+
+        //free list as a stack linked through m_next, the head holds a tag in the upper 32 bits against ABA
+        std::unique_ptr<std::atomic<uint32>[]> m_next;
+        std::atomic<uint64> m_freeHead = invalid_index;
+        std::atomic<uint32> m_highWater = 0;
+        std::atomic<size_type> m_aliveCount = 0;
+        std::atomic<size_type> m_version = 0;
+
+        math::vec3 m_acceleration = math::vec3(0.f);
+        math::vec3 m_scale = math::vec3(1.f);
+        id_type m_material = invalid_id;
+        id_type m_model = invalid_id;
+
+        mutable async::rw_spinlock m_lock;
+
+        uint32 popFree()
+        {
+            uint64 head = m_freeHead.load(std::memory_order_acquire);
+            while (true)
+            {
+                const uint32 index = static_cast<uint32>(head);
+                if (index == invalid_index)
+                    return invalid_index;
+
+                const uint64 next = (((head >> 32) + 1) << 32) | m_next[index].load(std::memory_order_relaxed);
+                if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire))
+                    return index;
+            }
+        }
+
+        void pushFree(uint32 index)
+        {
+            uint64 head = m_freeHead.load(std::memory_order_relaxed);
+            uint64 next;
+            do
+            {
+                m_next[index].store(static_cast<uint32>(head), std::memory_order_relaxed);
+                next = (((head >> 32) + 1) << 32) | index;
+            } while (!m_freeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed));
+        }
+    };
+
+    /**@brief Number of particle slots a single job integrates and ages.
+     */
+    constexpr size_type particles_per_job = 16384;
+
+    /**@brief Integrates and ages the particles of all pools. Every pool is split into ranges of particles_per_job slots that are simulated as separate jobs,
+     *        so a single big emitter is spread over the job system just like many small ones.
+     * @param firstJobs Scratch memory for the first job of every pool, keep it around between frames so that simulating doesn't allocate once it has grown.
+     * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+     * @note The caller needs to hold the locks of the pools for writing.
+     */
+    template<typename RunJobs>
+    void simulate_particles(particle_pool* const* pools, size_type poolCount, float deltaTime, std::vector<size_type>& firstJobs, RunJobs&& runJobs)
+    {
+        OPTICK_EVENT();
+        //first job of every pool, plus the total at the end
+        firstJobs.resize(poolCount + 1);
+
+        size_type jobCount = 0;
+        for (size_type i = 0; i < poolCount; i++)
+        {
+            firstJobs[i] = jobCount;
+            jobCount += (pools[i]->high_water() + particles_per_job - 1) / particles_per_job;
+        }
+        firstJobs[poolCount] = jobCount;
+
+        if (jobCount == 0)
+            return;
+
+        runJobs(jobCount, [&](size_type job)
+            {
+                const size_type poolIndex = static_cast<size_type>(std::upper_bound(firstJobs.begin(), firstJobs.end(), job) - firstJobs.begin()) - 1;
+                const size_type start = (job - firstJobs[poolIndex]) * particles_per_job;
+                const size_type end = start + particles_per_job;
+
+                particle_pool& pool = *pools[poolIndex];
+                pool.integrate(start, end, deltaTime);
+                pool.age(start, end, deltaTime);
+            });
+    }
+}
@@ -0,0 +1,17 @@
+#include <rendering/data/particle_pool_cache.hpp>
+
+namespace legion::rendering
+{
+    std::unordered_map<id_type, std::unique_ptr<particle_pool>> ParticlePoolCache::m_cache;
+    async::rw_spinlock ParticlePoolCache::m_poolLock;
+    std::atomic<id_type> ParticlePoolCache::m_lastId = invalid_id;
+
+    particle_pool_handle ParticlePoolCache::createPool(size_type capacity)
+    {
+        const id_type id = ++m_lastId;
+
+        async::readwrite_guard guard(m_poolLock);
+        m_cache.emplace(id, std::make_unique<particle_pool>(capacity));
+        return particle_pool_handle{ id };
+    }
+}
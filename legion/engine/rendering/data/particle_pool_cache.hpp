@@ -0,0 +1,65 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/data/particle_pool.hpp>
+
+namespace legion::rendering
+{
+    /**
+     * @struct particle_pool_handle
+     * @brief The handle for a particle pool, the only thing a particle emitter needs to store about its particles.
+     */
+    struct particle_pool_handle
+    {
+        id_type id = invalid_id;
+        particle_pool* get() const;
+        bool validate() const noexcept;
+    };
+
+    /**
+     * @class ParticlePoolCache
+     * @brief The cache class that holds all the particle pools. Pools live until the end of the program, like particle systems.
+     */
+    class ParticlePoolCache
+    {
+        friend struct particle_pool_handle;
+    public:
+        /**
+         * @brief Creates a pool with room for capacity particles.
+         */
+        static particle_pool_handle createPool(size_type capacity);
+
+        /**
+         * @brief Calls func(particle_pool&) for every pool.
+         */
+        template<typename Func>
+        static void forEachPool(Func&& func)
+        {
+            async::readonly_guard guard(m_poolLock);
+            for (auto& [id, pool] : m_cache)
+                func(*pool);
+        }
+
+    private:
+        static particle_pool* getPoolPointer(id_type id)
+        {
+            async::readonly_guard guard(m_poolLock);
+            const auto iterator = m_cache.find(id);
+            if (iterator == m_cache.end()) return nullptr;
+            return iterator->second.get();
+        }
+
+        static std::unordered_map<id_type, std::unique_ptr<particle_pool>> m_cache;
+        static async::rw_spinlock m_poolLock;
+        static std::atomic<id_type> m_lastId;
+    };
+
+    inline particle_pool* particle_pool_handle::get() const
+    {
+        return ParticlePoolCache::getPoolPointer(id);
+    }
+
+    inline bool particle_pool_handle::validate() const noexcept
+    {
+        return id != invalid_id && ParticlePoolCache::getPoolPointer(id) != nullptr;
+    }
+}
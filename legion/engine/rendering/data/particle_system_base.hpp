@@ -1,7 +1,7 @@
 #pragma once
 #include <core/core.hpp>
-#include <rendering/components/particle.hpp>
 #include <rendering/components/particle_emitter.hpp>
+#include <rendering/data/particle_pool.hpp>
 #include <rendering/data/material.hpp>
 #include <rendering/data/model.hpp>
 
@@ -21,37 +21,26 @@ namespace legion::rendering
         /**
          * @brief The function that is run to setup all the particles inside of the given emitter.
          * @param particle_emitter The particle emitter that holds the particles that you plan to iterate over.
+         * @param pool The pool of the emitter, the particle system manager holds its lock.
          */
-        virtual void setup(ecs::component_handle<particle_emitter> particle_emitter) const LEGION_IMPURE;
+        virtual void setup(ecs::component_handle<particle_emitter> particle_emitter, particle_pool& pool) const LEGION_IMPURE;
         /**
          * @brief The function that runs every frame to update all the particles inside of the given emitter.
-         * @param particle_list A list of particles to iterate over.
-         * @param particle_emitter The emitter component handle holding the particles.
+         *        The particles in the pool were already integrated and aged by the particle system manager, particles that outlived their lifeTime are dead already.
+         * @param pool The pool holding the particles of the emitter, the particle system manager holds its lock.
+         * @param particle_emitter The emitter component handle.
          */
-        virtual void update(std::vector<ecs::entity_handle>& particle_list, ecs::component_handle<particle_emitter> particle_emitter, ecs::EntityQuery& entities, time::span delta_time) const LEGION_IMPURE;
+        virtual void update(particle_pool& pool, ecs::component_handle<particle_emitter> particle_emitter, ecs::EntityQuery& entities, time::span delta_time) const LEGION_IMPURE;
 
     protected:
         /**
-         * @brief The function used to populate particles with data.
-         * @param particleHandle The particle that you want to populate.
-         * @param transformHandle The transform component of the particle.
+         * @brief Spawns a particle with the starting velocity and lifeTime of the particle system.
+         * @param pool The pool the particle is spawned in.
+         * @param position The position of the new particle.
+         * @param color The color of the new particle.
+         * @return The index of the particle in the pool, or particle_pool::invalid_index if the pool is full.
          */
-        virtual void createParticle(
-            ecs::entity_handle ent) const;
-        /**
-         * @brief The function used to clean up particles that have outlived their lifeTime.
-         * @param particleHandle The particle that is to be cleaned up.
-         * @param emitterHandle The emitter that hold that particular particle.
-         */
-        virtual void cleanUpParticle(
-            ecs::entity_handle particleHandle,
-            particle_emitter& emitterHandle) const;
-        /**
-         * @brief Checks if the given emitter has a particle ready to be used, otherwise make a new one.
-         * @param emitterHandle The emitter that is being checked for an available particle.
-         */
-        ecs::component_handle<particle> checkToRecycle(
-            particle_emitter& emitterHandle) const;
+        uint32 spawnParticle(particle_pool& pool, const math::vec3& position, const math::color& color = math::colors::white) const;
 
         bool m_looping;
 
@@ -69,6 +58,5 @@ namespace legion::rendering
 
         material_handle m_particleMaterial;
         model_handle m_particleModel;
-        static ecs::EcsRegistry* m_registry;
     };
 }
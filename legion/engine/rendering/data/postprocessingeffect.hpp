@@ -9,6 +9,7 @@
 #include <rendering/data/screen_quad.hpp>
 
 #include <rendering/pipeline/base/pipelinebase.hpp>
+#include <rendering/util/frame_graph.hpp>
 
 namespace legion::rendering
 {
@@ -27,6 +28,11 @@ namespace legion::rendering
 
         bool isInitialized() const { return m_initialized; }
 
+        /**@brief Declares the resources the effect reads, writes and creates to the frame graph of the pipeline, the pass of the effect is already added.
+         *        Effects that declare nothing are never culled.
+         */
+        virtual void declare(FrameGraph& graph) LEGION_IMPURE;
+
     protected:
         virtual void setup(app::window& context) LEGION_PURE;
         void renderQuad()
@@ -0,0 +1,57 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/components/camera.hpp>
+#include <rendering/components/light.hpp>
+
+/**
+ * @file render_snapshot.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct camera_snapshot
+     * @brief A camera and its transform at the end of a simulation frame.
+     */
+    struct camera_snapshot
+    {
+        camera cam;
+        position pos;
+        rotation rot;
+        scale scl;
+    };
+
+    /**@struct render_snapshot
+     * @brief Everything the renderer needs from the ECS for one frame, copied at the end of a simulation frame,
+     *        so the render thread doesn't need to touch the component families while the next simulation frame writes them.
+     *        The renderables are stored as a structure of arrays.
+     */
+    struct render_snapshot
+    {
+        //number of the simulation frame the snapshot was taken at
+        size_type frame = 0;
+
+        std::vector<camera_snapshot> cameras;
+
+        //world matrices of the renderables, already interpolated for entities that move in fixed steps
+        std::vector<math::mat4> worldMatrices;
+        std::vector<id_type> materials;
+        std::vector<id_type> models;
+
+        //world matrices and meshes of the occluders
+        std::vector<math::mat4> occluderMatrices;
+        std::vector<id_type> occluderMeshes;
+
+        std::vector<detail::light_data> lights;
+
+        void clear()
+        {
+            cameras.clear();
+            worldMatrices.clear();
+            materials.clear();
+            models.clear();
+            occluderMatrices.clear();
+            occluderMeshes.clear();
+            lights.clear();
+        }
+    };
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <optional>
+
+/**
+ * @file ring_allocator.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@class ring_fence_backend
+     * @brief Interface to the fences that tell the ring_allocator when the GPU is done with a region.
+     *        Implemented with GL sync objects by ring_buffer, can be replaced with a fake to drive the allocator without a graphics context.
+     */
+    class ring_fence_backend
+    {
+    public:
+        using fence_type = void*;
+
+        virtual ~ring_fence_backend() = default;
+
+        /**@brief Inserts a fence after all the commands that were issued so far.
+         */
+        virtual fence_type insert_fence() LEGION_PURE;
+
+        /**@brief Checks if the commands before a fence have finished.
+         * @param block When true waits until the fence is signaled, otherwise returns immediately.
+         * @return True if the fence was signaled.
+         */
+        virtual bool wait_fence(fence_type fence, bool block) LEGION_PURE;
+
+        virtual void delete_fence(fence_type fence) LEGION_PURE;
+    };
+
+    /**@class ring_allocator
+     * @brief Hands out ranges of a buffer that is split into a number of equally sized regions, one region per frame.
+     *        A region is fenced when its frame ends and is only reused once the fence is signaled,
+     *        so the CPU can write into a region while the GPU still reads from the others.
+     * @note Doesn't own or touch any memory, it only does the bookkeeping of offsets and fences.
+     */
+    class ring_allocator
+    {
+    public:
+        ring_allocator(ring_fence_backend* backend, size_type regionSize, size_type regionCount = 3) : m_backend(backend), m_regionSize(regionSize), m_fences(regionCount, nullptr) {}
+
+        ring_allocator(const ring_allocator&) = delete;
+        ring_allocator& operator=(const ring_allocator&) = delete;
+
+        ~ring_allocator()
+        {
+            for (auto& fence : m_fences)
+                if (fence)
+                    m_backend->delete_fence(fence);
+        }
+
+        /**@brief Moves on to the next region, waits for the GPU if it still uses that region.
+         */
+        void begin_region()
+        {
+            OPTICK_EVENT();
+            m_currentRegion = (m_currentRegion + 1) % m_fences.size();
+            m_offset = 0;
+
+            auto& fence = m_fences[m_currentRegion];
+            if (!fence)
+                return;
+
+            if (!m_backend->wait_fence(fence, false))
+            {
+                m_stallCount++;
+                m_backend->wait_fence(fence, true);
+            }
+
+            m_backend->delete_fence(fence);
+            fence = nullptr;
+        }
+
+        /**@brief Fences the current region, call after the last command that reads from it was issued.
+         */
+        void end_region()
+        {
+            auto& fence = m_fences[m_currentRegion];
+            if (fence)
+                m_backend->delete_fence(fence);
+            fence = m_backend->insert_fence();
+        }
+
+        /**@brief Allocates size bytes from the current region.
+         * @return Offset from the start of the whole buffer, or nothing if the region doesn't have enough space left.
+         */
+        L_NODISCARD std::optional<size_type> allocate(size_type size, size_type alignment = 1)
+        {
+            const size_type alignedOffset = alignment > 1 ? ((m_offset + alignment - 1) / alignment) * alignment : m_offset;
+            if (alignedOffset + size > m_regionSize)
+                return std::nullopt;
+
+            m_offset = alignedOffset + size;
+            return m_currentRegion * m_regionSize + alignedOffset;
+        }
+
+        /**@brief Waits for the GPU to finish with every region and changes the size of the regions.
+         *        The caller needs to reallocate the memory, and everything that was allocated so far is invalid.
+         */
+        void resize(size_type regionSize)
+        {
+            OPTICK_EVENT();
+            for (auto& fence : m_fences)
+            {
+                if (!fence)
+                    continue;
+
+                m_backend->wait_fence(fence, true);
+                m_backend->delete_fence(fence);
+                fence = nullptr;
+            }
+
+            m_regionSize = regionSize;
+            m_offset = 0;
+        }
+
+        L_NODISCARD size_type region_size() const noexcept { return m_regionSize; }
+        L_NODISCARD size_type region_count() const noexcept { return m_fences.size(); }
+        L_NODISCARD size_type total_size() const noexcept { return m_regionSize * m_fences.size(); }
+        L_NODISCARD size_type current_region() const noexcept { return m_currentRegion; }
+
+        /**@brief Bytes allocated from the current region so far.
+         */
+        L_NODISCARD size_type used() const noexcept { return m_offset; }
+
+        /**@brief Number of times begin_region had to wait for the GPU.
+         */
+        L_NODISCARD size_type stall_count() const noexcept { return m_stallCount; }
+
+    private:
+        ring_fence_backend* m_backend;
+        size_type m_regionSize;
+        std::vector<ring_fence_backend::fence_type> m_fences;
+        size_type m_currentRegion = 0;
+        size_type m_offset = 0;
+        size_type m_stallCount = 0;
+    };
+}
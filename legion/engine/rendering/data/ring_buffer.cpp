@@ -0,0 +1,102 @@
+#include <rendering/data/ring_buffer.hpp>
+
+namespace legion::rendering
+{
+    namespace detail
+    {
+        ring_fence_backend::fence_type gl_fence_backend::insert_fence()
+        {
+            return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        bool gl_fence_backend::wait_fence(fence_type fence, bool block)
+        {
+            // Polls once when not blocking, otherwise waits a second at a time until the GPU is done.
+            const GLuint64 timeout = block ? 1000000000 : 0;
+            GLenum result;
+            do
+            {
+                result = glClientWaitSync(static_cast<GLsync>(fence), GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            } while (block && result == GL_TIMEOUT_EXPIRED);
+
+            return result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED;
+        }
+
+        void gl_fence_backend::delete_fence(fence_type fence)
+        {
+            glDeleteSync(static_cast<GLsync>(fence));
+        }
+    }
+
+    ring_buffer::ring_buffer(GLenum target, size_type regionSize, size_type alignment, size_type regionCount)
+        : m_state(std::make_shared<ring_state>())
+    {
+        m_state->target = target;
+        m_state->alignment = alignment;
+        // Regions start at a multiple of the alignment, so offsets within a region stay aligned in the whole buffer.
+        regionSize = ((regionSize + alignment - 1) / alignment) * alignment;
+        m_state->allocator = std::make_unique<ring_allocator>(&m_state->fences, regionSize, regionCount);
+        allocateStorage(regionSize);
+    }
+
+    void ring_buffer::allocateStorage(size_type regionSize) const
+    {
+        OPTICK_EVENT();
+        auto& state = *m_state;
+        if (state.mapped)
+            state.buf.unmap();
+
+        const size_type totalSize = regionSize * state.allocator->region_count();
+        state.buf = buffer::create_storage(state.target, totalSize, storage_flags);
+        state.mapped = static_cast<byte*>(state.buf.map(0, totalSize, storage_flags));
+
+        if (!state.mapped)
+            log::error("Failed to persistently map ring buffer of {} bytes.", totalSize);
+    }
+
+    void ring_buffer::begin_frame() const
+    {
+        OPTICK_EVENT();
+        // The fence of the previous frame is inserted here, so it comes after every command of that frame that could read from its region.
+        m_state->allocator->end_region();
+        m_state->allocator->begin_region();
+    }
+
+    L_NODISCARD ring_allocation ring_buffer::allocate(size_type size) const
+    {
+        auto& state = *m_state;
+        auto offset = state.allocator->allocate(size, state.alignment);
+
+        if (!offset)
+        {
+            // Grow to fit at least twice what this frame needed, so growing is rare.
+            size_type regionSize = math::max(state.allocator->region_size() * 2, (state.allocator->used() + size + state.alignment) * 2);
+            regionSize = ((regionSize + state.alignment - 1) / state.alignment) * state.alignment;
+            log::debug("Growing ring buffer regions to {} bytes.", regionSize);
+
+            state.allocator->resize(regionSize);
+            allocateStorage(regionSize);
+            offset = state.allocator->allocate(size, state.alignment);
+        }
+
+        if (!offset || !state.mapped)
+            return {};
+
+        return { *offset, size, state.mapped + *offset };
+    }
+
+    L_NODISCARD const buffer& ring_buffer::get_buffer() const
+    {
+        return m_state->buf;
+    }
+
+    L_NODISCARD size_type ring_buffer::region_size() const
+    {
+        return m_state->allocator->region_size();
+    }
+
+    L_NODISCARD size_type ring_buffer::stall_count() const
+    {
+        return m_state->allocator->stall_count();
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <application/application.hpp>
+#include <rendering/data/buffer.hpp>
+#include <rendering/data/ring_allocator.hpp>
+
+#include <memory>
+
+/**
+ * @file ring_buffer.hpp
+ */
+
+namespace legion::rendering
+{
+    namespace detail
+    {
+        /**@class gl_fence_backend
+         * @brief ring_fence_backend that uses GL sync objects.
+         */
+        class gl_fence_backend final : public ring_fence_backend
+        {
+        public:
+            fence_type insert_fence() override;
+            bool wait_fence(fence_type fence, bool block) override;
+            void delete_fence(fence_type fence) override;
+        };
+    }
+
+    /**@struct ring_allocation
+     * @brief Range of a ring_buffer that the CPU can write to until the ring comes around to the same region again.
+     */
+    struct ring_allocation
+    {
+        //offset in bytes from the start of the buffer
+        size_type offset = 0;
+        size_type size = 0;
+        //pointer to the mapped memory of the range, nullptr if the allocation failed
+        void* data = nullptr;
+    };
+
+    /**@class ring_buffer
+     * @brief Persistently mapped buffer split into a region per frame in flight, for data that is written by the CPU every frame.
+     *        Writes go straight into the mapped memory instead of through a driver copy, and fences keep the CPU from overwriting
+     *        a region before the GPU is done reading from it.
+     * @note Copies share the same buffer and ring, just like copies of buffer share the same VRAM.
+     */
+    struct ring_buffer
+    {
+    private:
+        struct ring_state
+        {
+            buffer buf;
+            byte* mapped = nullptr;
+            GLenum target;
+            size_type alignment;
+            detail::gl_fence_backend fences;
+            std::unique_ptr<ring_allocator> allocator;
+        };
+
+        std::shared_ptr<ring_state> m_state;
+
+        void allocateStorage(size_type regionSize) const;
+
+    public:
+        static constexpr size_type default_region_count = 3;
+        static constexpr GLbitfield storage_flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        /**@brief Faux constructor, doesn't create a buffer.
+         */
+        ring_buffer() = default;
+
+        /**@brief Creates the buffer and maps it, needs a current context.
+         * @param target The buffer type to create. eg: GL_ARRAY_BUFFER, GL_SHADER_STORAGE_BUFFER
+         * @param regionSize Size in bytes of a single frame, the buffer grows when a frame needs more.
+         * @param alignment Alignment of every allocation, eg: the size of an instance or GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT.
+         */
+        ring_buffer(GLenum target, size_type regionSize, size_type alignment = 1, size_type regionCount = default_region_count);
+
+        /**@brief Fences the region of the previous frame and moves on to the next one. Call once per frame before allocating, needs a current context.
+         */
+        void begin_frame() const;
+
+        /**@brief Allocates a range of the region of the current frame.
+         *        If the region is full the buffer is recreated with larger regions, which waits for the GPU and invalidates earlier allocations of the frame.
+         *        Needs a current context.
+         */
+        L_NODISCARD ring_allocation allocate(size_type size) const;
+
+        /**@brief The buffer the ring lives in. Changes when the ring grows.
+         */
+        L_NODISCARD const buffer& get_buffer() const;
+
+        L_NODISCARD size_type region_size() const;
+
+        /**@brief Number of frames in which the CPU had to wait for the GPU to finish with a region.
+         */
+        L_NODISCARD size_type stall_count() const;
+
+        L_NODISCARD bool valid() const noexcept { return m_state != nullptr; }
+    };
+}
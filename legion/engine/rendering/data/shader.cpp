@@ -1,12 +1,16 @@
 ﻿#include <rendering/data/shader.hpp>
 #include <rendering/util/bindings.hpp>
 #include <algorithm>
+#include <thread>
 #include <rendering/shadercompiler/shadercompiler.hpp>
 
 namespace legion::rendering
 {
     sparse_map<id_type, shader> ShaderCache::m_shaders;
     async::rw_spinlock ShaderCache::m_shaderLock;
+    std::unordered_map<id_type, std::shared_ptr<ShaderCache::preprocessed_shader>> ShaderCache::m_preprocessed;
+    async::spinlock ShaderCache::m_preprocessedLock;
+    scheduling::Scheduler* ShaderCache::scheduler = nullptr;
 
     shader* ShaderCache::get_shader(id_type id)
     {
@@ -34,6 +38,7 @@ namespace legion::rendering
             GLchar* uniformNameBuffer = new GLchar[maxUniformNameLength]; // Create buffer with the right length.
 
             uint textureUnit = 1;
+            std::unordered_map<GLint, std::vector<uniform_block_member>> blockMembers;
 
             for (int uniformId = 0; uniformId < numActiveUniforms; uniformId++)
             {
@@ -47,6 +52,18 @@ namespace legion::rendering
                 if (name.find('[') != std::string_view::npos) // We don't support uniform arrays yet.
                     continue;
 
+                // Uniforms in blocks don't have a location, they get written to a uniform buffer at their offset instead.
+                GLuint activeIndex = static_cast<GLuint>(uniformId);
+                GLint blockIndex = -1;
+                glGetActiveUniformsiv(variant.programId, 1, &activeIndex, GL_UNIFORM_BLOCK_INDEX, &blockIndex);
+                if (blockIndex != -1)
+                {
+                    GLint offset = 0;
+                    glGetActiveUniformsiv(variant.programId, 1, &activeIndex, GL_UNIFORM_OFFSET, &offset);
+                    blockMembers[blockIndex].push_back({ std::string(uniformNameBuffer, nameLength), type, offset });
+                    continue;
+                }
+
                 // Get location and create uniform object.
                 app::gl_location location = glGetUniformLocation(variant.programId, uniformNameBuffer);
                 shader_parameter_base* uniform = nullptr;
@@ -116,6 +133,31 @@ namespace legion::rendering
 
             delete[] uniformNameBuffer; // Delete name buffer
 #pragma endregion
+#pragma region uniform blocks
+            variant.uniformBlocks.clear();
+            variant.boundMaterial = nullptr;
+
+            GLint numActiveBlocks = 0;
+            glGetProgramiv(variant.programId, GL_ACTIVE_UNIFORM_BLOCKS, &numActiveBlocks);
+
+            for (GLint blockIndex = 0; blockIndex < numActiveBlocks; blockIndex++)
+            {
+                GLint blockNameLength = 0;
+                glGetActiveUniformBlockiv(variant.programId, blockIndex, GL_UNIFORM_BLOCK_NAME_LENGTH, &blockNameLength);
+                std::string blockName(static_cast<size_type>(math::max(blockNameLength, 1)), '\0');
+                glGetActiveUniformBlockName(variant.programId, blockIndex, blockNameLength, nullptr, blockName.data());
+                blockName.resize(blockName.find('\0') == std::string::npos ? blockName.size() : blockName.find('\0'));
+
+                GLint blockSize = 0;
+                glGetActiveUniformBlockiv(variant.programId, blockIndex, GL_UNIFORM_BLOCK_DATA_SIZE, &blockSize);
+
+                // Every block gets its own binding so a material can keep all of its blocks bound at the same time.
+                GLuint binding = SV_MATERIALBLOCKS + static_cast<GLuint>(blockIndex);
+                glUniformBlockBinding(variant.programId, blockIndex, binding);
+
+                variant.uniformBlocks.push_back({ blockName, binding, blockSize, std::move(blockMembers[blockIndex]) });
+            }
+#pragma endregion
 #pragma region attributes
         // Find the number of active attributes.
             GLint numActiveAttribs = 0;
@@ -213,65 +255,173 @@ namespace legion::rendering
         return shaderId;
     }
 
-    bool ShaderCache::load_precompiled(const fs::view& file, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state)
+    void ShaderCache::initialize_compiler()
     {
-        log::info("Loading precompiled shader: {}", file.get_virtual_path());
-        auto result = file.get();
-        if (result != common::valid)
-            return false;
+        static bool initialized = []()
+        {
+            ShaderCompiler::setErrorCallback([](const std::string& errormsg, log::severity severity)
+                {
+                    log::println(severity, errormsg);
+                });
 
-        auto resource = result.decay();
+            ShaderCompiler::cleanCache();
+            return true;
+        }();
+        (void)initialized;
+    }
 
-        if (resource.size() <= 22)
-            return false;
+    byte ShaderCache::get_compiler_settings(shader_import_settings settings)
+    {
+        byte compilerSettings = 0;
+        compilerSettings |= settings.api;
+        if (settings.debug)
+            compilerSettings |= shader_compiler_options::debug;
+        if (settings.low_power)
+            compilerSettings |= shader_compiler_options::low_power;
+        return compilerSettings;
+    }
 
-        byte_vec data = resource.get();
+    id_type ShaderCache::get_preprocessed_key(const std::string& path, byte compilerSettings)
+    {
+        return nameHash(path) ^ (static_cast<id_type>(compilerSettings) * 0x00000100000001b3);
+    }
 
-        std::string_view magic(reinterpret_cast<char*>(data.data()), 19);
-        if (magic != "\xabLEGION SHADER\xbb\r\n\x13\n")
-            return false;
+    void ShaderCache::run_preprocess(preprocessed_shader& preprocessed)
+    {
+        uint8 expected = preprocessed_shader::queued;
+        if (!preprocessed.status.compare_exchange_strong(expected, preprocessed_shader::running, std::memory_order_acquire))
+            return;
 
-        auto start = data.cbegin() + 19;
-        auto end = data.cend();
+        bool cacheHit = false;
+        preprocessed.success = ShaderCompiler::processFile(preprocessed.path, preprocessed.compilerSettings, preprocessed.ilo, preprocessed.state, detail::get_default_defines(), {}, &cacheHit);
+        preprocessed.status.store(preprocessed_shader::done, std::memory_order_release);
 
-        while (start != end)
-        {
-            GLenum shaderType;
-            retrieveBinaryData(shaderType, start);
+        preprocess_batch& batch = *preprocessed.batch;
+        if (cacheHit)
+            batch.cacheHits.fetch_add(1, std::memory_order_relaxed);
 
-            std::string shaderVariant;
-            retrieveBinaryData(shaderVariant, start);
+        if (batch.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            const size_type cacheHits = batch.cacheHits.load(std::memory_order_relaxed);
+            log::info("Preprocessed {} shaders in {:.2f}ms, {} came from the shader cache ({:.0f}% hit rate).",
+                batch.count, batch.timer.elapsedTime().milliseconds(), cacheHits, (cacheHits * 100.f) / batch.count);
+        }
+    }
 
-            switch (shaderType)
-            {
-            case 0:
+    bool ShaderCache::preprocess(const fs::view& file, byte compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state)
+    {
+        OPTICK_EVENT();
+        std::shared_ptr<preprocessed_shader> preprocessed;
+        {
+            std::lock_guard guard(m_preprocessedLock);
+            auto iter = m_preprocessed.find(get_preprocessed_key(file.get_virtual_path(), compilerSettings));
+            if (iter != m_preprocessed.end())
             {
-                std::vector<GLenum> rawState;
-                retrieveBinaryData(rawState, start);
-                if (rawState.size() % 2 != 0)
-                    return false;
+                preprocessed = iter->second;
+                m_preprocessed.erase(iter);
+            }
+        }
+
+        if (!preprocessed)
+            return ShaderCompiler::process(file, compilerSettings, ilo, state, detail::get_default_defines());
+
+        // If no job got to the shader yet it's faster to preprocess it here than to wait for the queue.
+        run_preprocess(*preprocessed);
+        while (preprocessed->status.load(std::memory_order_acquire) != preprocessed_shader::done)
+            std::this_thread::yield();
+
+        if (!preprocessed->success)
+            return false;
+
+        ilo = std::move(preprocessed->ilo);
+        state = std::move(preprocessed->state);
+        return true;
+    }
+
+    void ShaderCache::preprocess_shaders(const std::vector<fs::view>& files, shader_import_settings settings)
+    {
+        OPTICK_EVENT();
+        initialize_compiler();
+        // The defines are built on first use, build them here before any job needs them.
+        detail::get_default_defines();
+
+        const byte compilerSettings = get_compiler_settings(settings);
+        auto batch = std::make_shared<preprocess_batch>();
+        std::vector<std::pair<id_type, std::shared_ptr<preprocessed_shader>>> pending;
+
+        for (auto& file : files)
+        {
+            auto extension = file.get_extension();
+            if (extension != common::valid || extension.decay().empty() || extension.decay() == ".shil")
+                continue;
 
-                shader_state& variantState = state[shaderVariant];
-                for (int i = 0; i < rawState.size(); i += 2)
+            // Shaders that have a precompiled file next to them get loaded from that.
+            if (settings.usePrecompiledIfAvailable)
+            {
+                auto precompiled = file / ".." / (file.get_filestem().decay() + ".shil");
+                if (precompiled.is_valid(true))
                 {
-                    variantState[rawState[i]] = rawState[i + 1];
+                    auto traits = precompiled.file_info();
+                    if (traits.is_file && traits.can_be_read)
+                        continue;
                 }
             }
-            break;
-            case GL_VERTEX_SHADER:
-            case GL_FRAGMENT_SHADER:
-            case GL_GEOMETRY_SHADER:
+
+            const id_type key = get_preprocessed_key(file.get_virtual_path(), compilerSettings);
             {
-                std::string source;
-                retrieveBinaryData(source, start);
-                ilo[shaderVariant].emplace_back(shaderType, source);
-            }
-            break;
-            default:
-                return false;
+                std::lock_guard guard(m_preprocessedLock);
+                if (m_preprocessed.count(key))
+                    continue;
             }
+
+            // Paths are resolved here, the filesystem isn't safe to use from the jobs.
+            std::string path = ShaderCompiler::resolvePath(file);
+            if (path.empty())
+                continue;
+
+            auto preprocessed = std::make_shared<preprocessed_shader>();
+            preprocessed->path = std::move(path);
+            preprocessed->compilerSettings = compilerSettings;
+            preprocessed->batch = batch;
+            pending.emplace_back(key, std::move(preprocessed));
         }
-        return true;
+
+        auto queued = std::make_shared<std::vector<std::shared_ptr<preprocessed_shader>>>();
+        {
+            // The batch is complete before the lock is released, after that create_shader can pick up the shaders.
+            std::lock_guard guard(m_preprocessedLock);
+            for (auto& [key, preprocessed] : pending)
+                if (m_preprocessed.emplace(key, preprocessed).second)
+                    queued->push_back(preprocessed);
+
+            batch->count = queued->size();
+            batch->remaining.store(queued->size(), std::memory_order_release);
+        }
+
+        if (queued->empty())
+            return;
+
+        if (!scheduler)
+        {
+            for (auto& preprocessed : *queued)
+                run_preprocess(*preprocessed);
+            return;
+        }
+
+        scheduler->queueJobs(queued->size(), [queued]()
+            {
+                run_preprocess(*(*queued)[async::this_job::get_id()]);
+            });
+    }
+
+    bool ShaderCache::load_precompiled(const fs::view& file, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state)
+    {
+        log::info("Loading precompiled shader: {}", file.get_virtual_path());
+        auto result = file.get();
+        if (result != common::valid)
+            return false;
+
+        return ShaderCompiler::deserialize(result.decay().get(), ilo, state);
     }
 
     void ShaderCache::store_precompiled(const fs::view& file, const shader_ilo& ilo, const std::unordered_map<std::string, shader_state>& state)
@@ -289,34 +439,7 @@ namespace legion::rendering
         if (precompiled.is_valid(true) && precompiled.file_info().can_be_written)
         {
             fs::basic_resource resource(nullptr);
-            byte_vec& data = resource.get();
-
-            std::string magic = "\xabLEGION SHADER\xbb\r\n\x13\n";
-            for (auto item : magic)
-                data.push_back(item);
-
-            std::vector<GLenum> rawState;
-            for (auto& [variant, variantState] : state)
-            {
-                GLenum stateType = 0;
-                appendBinaryData(&stateType, data);
-                appendBinaryData(&variant, data);
-                rawState.clear();
-                for (auto& [key, value] : variantState)
-                {
-                    rawState.push_back(key);
-                    rawState.push_back(value);
-                }
-                appendBinaryData(&rawState, data);
-            }
-
-            for (auto& [shaderVariant, variantSource] : ilo)
-                for (auto& [shaderType, source] : variantSource)
-                {
-                    appendBinaryData(&shaderType, data);
-                    appendBinaryData(&shaderVariant, data);
-                    appendBinaryData(&source, data);
-                }
+            resource.get() = ShaderCompiler::serialize(ilo, state);
 
             precompiled.set(resource).except([](fs_error err)
                 {
@@ -338,12 +461,7 @@ namespace legion::rendering
             }
         }
 
-        ShaderCompiler::setErrorCallback([](const std::string& errormsg, log::severity severity)
-            {
-                log::println(severity, errormsg);
-            });
-
-        ShaderCompiler::cleanCache();
+        initialize_compiler();
 
         std::unordered_map<std::string, shader_state> state;
         shader_ilo shaders;
@@ -380,14 +498,7 @@ namespace legion::rendering
             L_FALLTHROUGH;
             default:
             {
-                byte compilerSettings = 0;
-                compilerSettings |= settings.api;
-                if (settings.debug)
-                    compilerSettings |= shader_compiler_options::debug;
-                if (settings.low_power)
-                    compilerSettings |= shader_compiler_options::low_power;
-
-                if (!ShaderCompiler::process(file, compilerSettings, shaders, state, detail::get_default_defines()))
+                if (!preprocess(file, get_compiler_settings(settings), shaders, state))
                     return invalid_shader_handle;
 
                 compiledFromScratch = true;
@@ -671,14 +782,7 @@ namespace legion::rendering
             L_FALLTHROUGH;
             default:
             {
-                byte compilerSettings = 0;
-                compilerSettings |= settings.api;
-                if (settings.debug)
-                    compilerSettings |= shader_compiler_options::debug;
-                if (settings.low_power)
-                    compilerSettings |= shader_compiler_options::low_power;
-
-                if (!ShaderCompiler::process(file, compilerSettings, shaders, state, detail::get_default_defines()))
+                if (!preprocess(file, get_compiler_settings(settings), shaders, state))
                     return invalid_shader_handle;
 
                 compiledFromScratch = true;
@@ -12,6 +12,7 @@
 namespace legion::rendering
 {
     struct camera;
+    struct material;
     struct shader;
     struct ShaderCache;
     struct shader_handle;
@@ -240,6 +241,18 @@ namespace legion::rendering
             glVertexAttribPointer(m_location, size, type, normalized, stride, reinterpret_cast<const GLvoid*>(pointer));
         }
 
+        /**@brief Attach the currently bound array buffer to this attribute, for integer attributes that the shader reads as integers instead of floats.
+         * @param size Number of components in the data tensor (1: r, 2: rg, 3: rgb, 4: rgba).
+         * @param type Data type of the components in the tensor, eg: GL_UNSIGNED_INT.
+         * @param stride Amount of bytes in-between valid data chunks.
+         * @param pointer Amount of bytes until the first valid data chunk.
+         */
+        void set_attribute_ipointer(GLint size, GLenum type, GLsizei stride, GLsizei pointer)
+        {
+            glEnableVertexAttribArray(m_location);
+            glVertexAttribIPointer(m_location, size, type, stride, reinterpret_cast<const GLvoid*>(pointer));
+        }
+
         /**@brief Disable the attribute after you're done with it. Leaving it enabled can cause performance issues due to limiting the GPU to move and reallocate it's VRAM.
          */
         void disable_attribute_pointer()
@@ -263,16 +276,44 @@ namespace legion::rendering
 
 #pragma endregion
 
+    /**@struct uniform_block_member
+     * @brief Uniform that lives inside of a uniform block instead of at a location.
+     */
+    struct uniform_block_member
+    {
+        std::string name;
+        GLenum type;
+        GLint offset;
+    };
+
+    /**@struct uniform_block_info
+     * @brief Layout of a std140 uniform block of a shader variant, the block is bound to uniform buffer binding SV_MATERIALBLOCKS + its index.
+     */
+    struct uniform_block_info
+    {
+        std::string name;
+        GLuint binding;
+        GLint size;
+        std::vector<uniform_block_member> members;
+    };
+
     struct shader_variant
     {
         GLint programId;
         std::unordered_map<id_type, std::unique_ptr<shader_parameter_base>> uniforms;
         std::unordered_map<id_type, std::unique_ptr<attribute>> attributes;
         std::unordered_map<GLint, id_type> idOfLocation;
+        std::vector<uniform_block_info> uniformBlocks;
         std::string name;
         std::string path;
         id_type nameHash;
 
+        /**@brief Material whose parameters were the last ones to be applied to the program.
+         *        While it stays the same, binding that material only needs to upload the parameters that changed.
+         *        Reset whenever a uniform is fetched from the shader directly, since its value might be changed behind the material's back.
+         */
+        const material* boundMaterial = nullptr;
+
         /**@brief Data-structure to hold mapping of context functions and parameters.
          */
         shader_state state;
@@ -329,6 +370,8 @@ namespace legion::rendering
                 return uniform<T>(nullptr);
             }
 
+            m_currentShaderVariant->boundMaterial = nullptr;
+
             auto* ptr = dynamic_cast<uniform<T>*>(m_currentShaderVariant->uniforms[nameHash(name)].get());
             if (ptr)
                 return *ptr;
@@ -360,6 +403,8 @@ namespace legion::rendering
                 return uniform<T>(nullptr);
             }
 
+            m_currentShaderVariant->boundMaterial = nullptr;
+
             auto* ptr = dynamic_cast<uniform<T>*>(m_currentShaderVariant->uniforms[id].get());
             if (ptr)
                 return *ptr;
@@ -390,6 +435,8 @@ namespace legion::rendering
                 return uniform<T>(nullptr);
             }
 
+            m_currentShaderVariant->boundMaterial = nullptr;
+
             auto* ptr = dynamic_cast<uniform<T>*>(m_currentShaderVariant->uniforms[m_currentShaderVariant->idOfLocation[location]].get());
             if (ptr)
                 return *ptr;
@@ -490,8 +537,41 @@ namespace legion::rendering
         static sparse_map<id_type, shader> m_shaders;
         static async::rw_spinlock m_shaderLock;
 
+        struct preprocess_batch
+        {
+            time::timer timer;
+            size_type count = 0;
+            std::atomic<size_type> remaining = 0;
+            std::atomic<size_type> cacheHits = 0;
+        };
+
+        struct preprocessed_shader
+        {
+            static constexpr uint8 queued = 0;
+            static constexpr uint8 running = 1;
+            static constexpr uint8 done = 2;
+
+            std::atomic<uint8> status = queued;
+            std::string path;
+            byte compilerSettings = 0;
+            bool success = false;
+            shader_ilo ilo;
+            std::unordered_map<std::string, shader_state> state;
+            std::shared_ptr<preprocess_batch> batch;
+        };
+
+        // Shaders handed to preprocess_shaders that weren't created yet, by virtual path and compiler settings.
+        static std::unordered_map<id_type, std::shared_ptr<preprocessed_shader>> m_preprocessed;
+        static async::spinlock m_preprocessedLock;
+
         static shader* get_shader(id_type id);
 
+        static void initialize_compiler();
+        static byte get_compiler_settings(shader_import_settings settings);
+        static id_type get_preprocessed_key(const std::string& path, byte compilerSettings);
+        static void run_preprocess(preprocessed_shader& preprocessed);
+        static bool preprocess(const fs::view& file, byte compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state);
+
         static void process_io(shader& shader, id_type id);
         static app::gl_id compile_shader(GLuint shaderType, cstring source, GLint sourceLength);
 
@@ -501,6 +581,15 @@ namespace legion::rendering
         static shader_handle create_invalid_shader(const fs::view& file, shader_import_settings settings = default_shader_settings);
 
     public:
+        // When no scheduler is set the shaders passed to preprocess_shaders are preprocessed on the calling thread.
+        static scheduling::Scheduler* scheduler;
+
+        /**@brief Starts preprocessing shaders on the job system and returns without waiting for them.
+         *        Creating one of the shaders later with the same settings picks up the result, or preprocesses it right away if no job got to it yet.
+         *        Logs how long the whole list took and how many shaders came from the shader cache once the last one is done.
+         */
+        static void preprocess_shaders(const std::vector<fs::view>& files, shader_import_settings settings = default_shader_settings);
+
         static shader_handle create_shader(const std::string& name, const fs::view& file, shader_import_settings settings = default_shader_settings);
         static shader_handle create_shader(const fs::view& file, shader_import_settings settings = default_shader_settings);
         static shader_handle get_handle(const std::string& name);
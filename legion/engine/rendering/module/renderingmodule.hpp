@@ -1,6 +1,7 @@
 #pragma once
 #include <rendering/data/importers/texture_importers.hpp>
 #include <rendering/systems/renderer.hpp>
+#include <rendering/systems/render_extraction.hpp>
 #include <rendering/components/renderable.hpp>
 #include <rendering/components/light.hpp>
 #include <rendering/systems/particle_system_manager.hpp>
@@ -22,10 +23,11 @@ namespace legion::rendering
 
             reportComponentType<camera>();
             reportComponentType<mesh_renderer>();
+            reportComponentType<occluder>();
             reportComponentType<light>();
+            reportSystem<RenderExtraction>();
             reportSystem<Renderer>();
 
-            reportComponentType<particle>();
             reportComponentType<particle_emitter>();
             reportComponentType<point_emitter_data>();
 
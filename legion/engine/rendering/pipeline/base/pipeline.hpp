@@ -6,6 +6,7 @@
 #include <application/application.hpp>
 
 #include <memory>
+#include <unordered_map>
 #include <any>
 
 namespace legion::rendering
@@ -17,6 +18,13 @@ namespace legion::rendering
     protected:
         static std::multimap<priority_type, std::unique_ptr<RenderStageBase>, std::greater<>> m_stages;
 
+        //pass of every stage in the frame graph, stages that were attached after the graph was compiled aren't in here and always run
+        std::unordered_map<RenderStageBase*, size_type> m_stagePasses;
+
+        /**@brief Lets every stage declare its resources and compiles the frame graph.
+         */
+        void buildFrameGraph(app::window& context);
+
     public:
 
         template<typename StageType CNDOXY(inherits_from<StageType, RenderStage<StageType>> = 0)>
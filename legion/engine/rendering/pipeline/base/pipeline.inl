@@ -96,10 +96,27 @@ namespace legion::rendering
     {
         OPTICK_EVENT();
         setup(context);
+        buildFrameGraph(context);
         for (auto& [_, stage] : m_stages)
             stage->init(context);
     }
 
+    template<typename Self>
+    inline void RenderPipeline<Self>::buildFrameGraph(app::window& context)
+    {
+        OPTICK_EVENT();
+        m_frameGraph.clear();
+        m_stagePasses.clear();
+
+        for (auto& [_, stage] : m_stages)
+        {
+            m_stagePasses[stage.get()] = m_frameGraph.add_pass(stage->getName());
+            stage->declare(m_frameGraph);
+        }
+
+        compileFrameGraph(context.framebufferSize());
+    }
+
     template<typename Self>
     inline void RenderPipeline<Self>::render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
@@ -110,6 +127,10 @@ namespace legion::rendering
             if (m_exiting.load(std::memory_order_acquire))
                 return;
 
+            auto passIter = m_stagePasses.find(stage.get());
+            if (passIter != m_stagePasses.end() && !m_frameGraph.is_alive(passIter->second))
+                continue;
+
             if (!stage->isInitialized())
                 stage->init(context);
 
@@ -81,4 +81,65 @@ namespace legion::rendering
         return nullptr;
     }
 
+    void RenderPipelineBase::compileFrameGraph(math::ivec2 framebufferSize)
+    {
+        OPTICK_EVENT();
+        const frame_graph_report& report = m_frameGraph.compile(framebufferSize);
+        m_transientTextures.assign(m_frameGraph.physical_count(), invalid_texture_handle);
+
+        constexpr float megabyte = 1024.f * 1024.f;
+        log::info("Frame graph: {} of {} passes culled, {} transient resources in {} physical resources, {:.1f}MB instead of {:.1f}MB at {}x{}, {:.1f}MB saved.",
+            report.culledPasses, report.passes, report.transientResources, report.physicalResources,
+            report.physicalBytes / megabyte, report.virtualBytes / megabyte, framebufferSize.x, framebufferSize.y, report.savedBytes() / megabyte);
+
+        for (size_type pass = 0; pass < m_frameGraph.pass_count(); pass++)
+            if (!m_frameGraph.is_alive(pass))
+                log::debug("Frame graph culled {}, nothing it writes is used.", m_frameGraph.pass_name(pass));
+    }
+
+    L_NODISCARD texture_handle RenderPipelineBase::getTransientTexture(const std::string& name, math::ivec2 size, const texture_import_settings& settings)
+    {
+        OPTICK_EVENT();
+        const size_type physical = m_frameGraph.physical_index(name);
+        if (physical == FrameGraph::invalid_index || physical >= m_transientTextures.size())
+            return TextureCache::create_texture(name, size, settings);
+
+        texture_handle& texture = m_transientTextures[physical];
+        if (texture == invalid_texture_handle)
+            texture = TextureCache::create_texture("frame graph transient " + std::to_string(physical), size, settings);
+        return texture;
+    }
+
+    L_NODISCARD frame_resource_desc RenderPipelineBase::transientTextureDesc(const texture_import_settings& settings, float scale)
+    {
+        frame_resource_desc desc;
+        desc.type = frame_resource_type::texture;
+        desc.scale = scale;
+        desc.mipmapped = settings.generateMipmaps;
+
+        switch (settings.intendedFormat)
+        {
+        case texture_format::rgba_hdr: desc.texelSize = 16; break;
+        case texture_format::rgb_hdr: desc.texelSize = 12; break;
+        case texture_format::red:
+        case texture_format::stencil: desc.texelSize = 1; break;
+        case texture_format::rg: desc.texelSize = 2; break;
+        default: desc.texelSize = 4; break;
+        }
+
+        //only textures that would be created exactly the same can share a texture
+        const size_type fields[] = {
+            static_cast<size_type>(settings.type), static_cast<size_type>(settings.fileFormat), static_cast<size_type>(settings.intendedFormat),
+            static_cast<size_type>(settings.components), settings.flipVertical, settings.generateMipmaps,
+            static_cast<size_type>(settings.min), static_cast<size_type>(settings.mag),
+            static_cast<size_type>(settings.wrapR), static_cast<size_type>(settings.wrapS), static_cast<size_type>(settings.wrapT) };
+
+        id_type format = 14695981039346656037ull;
+        for (size_type field : fields)
+            format = (format ^ field) * 1099511628211ull;
+        desc.format = format;
+
+        return desc;
+    }
+
 }
@@ -2,6 +2,7 @@
 #include <rendering/data/framebuffer.hpp>
 #include <rendering/data/buffer.hpp>
 #include <rendering/components/camera.hpp>
+#include <rendering/util/frame_graph.hpp>
 #include <application/application.hpp>
 
 #include <memory>
@@ -16,6 +17,10 @@ namespace legion::rendering
         sparse_map<id_type, framebuffer> m_framebuffers;
         sparse_map<id_type, std::any> m_metadata;
 
+        //resources the stages declared, compiled when the pipeline is initialized, and the textures that back the transient textures of the graph
+        FrameGraph m_frameGraph;
+        std::vector<texture_handle> m_transientTextures;
+
         static ecs::EcsRegistry* m_ecs;
         static schd::Scheduler* m_scheduler;
         static events::EventBus* m_eventBus;
@@ -24,6 +29,10 @@ namespace legion::rendering
 
         static std::atomic_bool m_exiting;
 
+        /**@brief Compiles the frame graph after the stages declared their resources and logs how much memory aliasing the transient resources saves.
+         */
+        void compileFrameGraph(math::ivec2 framebufferSize);
+
     public:
         static void exit();
 
@@ -54,6 +63,19 @@ namespace legion::rendering
         L_NODISCARD bool hasFramebuffer(id_type nameHash, GLenum target = GL_FRAMEBUFFER);
         L_NODISCARD framebuffer* getFramebuffer(id_type nameHash);
 
+        L_NODISCARD const FrameGraph& getFrameGraph() const { return m_frameGraph; }
+
+        /**@brief Gets the texture that backs a transient texture of the frame graph, transient textures with disjoint lifetimes share the same texture.
+         *        The texture is created with the given size and settings by the first user, resizing it is up to the users.
+         *        Textures the frame graph doesn't know about get a texture of their own.
+         */
+        L_NODISCARD texture_handle getTransientTexture(const std::string& name, math::ivec2 size, const texture_import_settings& settings);
+
+        /**@brief Describes a texture for the frame graph, textures with the same settings and scale can share memory.
+         * @param scale Size of the texture relative to the framebuffer.
+         */
+        L_NODISCARD static frame_resource_desc transientTextureDesc(const texture_import_settings& settings, float scale = 1.f);
+
         virtual void init(app::window& context) LEGION_PURE;
 
         virtual void render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime) LEGION_PURE;
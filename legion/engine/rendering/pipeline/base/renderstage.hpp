@@ -2,6 +2,7 @@
 #include <application/application.hpp>
 #include <rendering/components/camera.hpp>
 #include <rendering/pipeline/base/pipelinebase.hpp>
+#include <rendering/util/frame_graph.hpp>
 
 #define setup_priority 64
 #define opaque_priority 32
@@ -43,6 +44,12 @@ namespace legion::rendering
 
         virtual void render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime) LEGION_PURE;
         virtual priority_type priority() LEGION_IMPURE_RETURN(default_priority);
+        virtual const std::string& getName() const LEGION_PURE;
+
+        /**@brief Declares the resources the stage reads, writes and creates to the frame graph of the pipeline, the pass of the stage is already added.
+         *        Stages that declare nothing are never culled.
+         */
+        virtual void declare(FrameGraph& graph) LEGION_IMPURE;
 
     protected:
         void abort();
@@ -76,6 +83,10 @@ namespace legion::rendering
     template<typename SelfType>
     class RenderStage : public RenderStageBase
     {
+    public:
+        virtual const std::string& getName() const override { return name; }
+        static const std::string name;
+
     protected:
         /**@brief Create a new entity and return the handle.
          */
@@ -44,4 +44,6 @@ namespace legion::rendering
         return m_pipeline->get_meta<T>(nameHash);
     }
 
+    template<typename SelfType>
+    const std::string RenderStage<SelfType>::name = nameOfType<SelfType>();
 }
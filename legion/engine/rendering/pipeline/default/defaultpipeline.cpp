@@ -11,7 +11,7 @@
 #include <rendering/pipeline/default/postfx/fxaa.hpp>
 #include <rendering/pipeline/default/postfx/bloom.hpp>
 #include <rendering/pipeline/default/postfx/depthoffield.hpp>
-#include <rendering/data/buffer.hpp>
+#include <rendering/data/ring_buffer.hpp>
 
 
 namespace legion::rendering
@@ -34,15 +34,15 @@ namespace legion::rendering
         PostProcessingStage::addEffect<FXAA>(-90);
 
 
-        buffer modelMatrixBuffer;
+        ring_buffer modelMatrixBuffer;
 
         {
             app::context_guard guard(context);
             addFramebuffer("main");
-            modelMatrixBuffer = buffer(GL_ARRAY_BUFFER, sizeof(math::mat4) * 1024, nullptr, GL_DYNAMIC_DRAW);
+            modelMatrixBuffer = ring_buffer(GL_ARRAY_BUFFER, sizeof(math::mat4) * 1024, sizeof(math::mat4));
         }
 
-        create_meta<buffer>("model matrix buffer", modelMatrixBuffer);
+        create_meta<ring_buffer>("model matrix buffer", modelMatrixBuffer);
     }
 
 }
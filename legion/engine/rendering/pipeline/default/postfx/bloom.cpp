@@ -13,16 +13,24 @@ namespace legion::rendering
         m_historyMixShader = rendering::ShaderCache::create_shader("bloom history mix", "engine://shaders/bloomhistorymix.shs"_view);
 
         // Creating 2 framebuffers to pingpong texturs with. (used for blurring)
+        // The textures are transient and get fetched from the pipeline every pass.
         for (int i = 0; i < 2; i++)
-        {
             m_pingpongFrameBuffers[i] = framebuffer(GL_FRAMEBUFFER);
-            m_pingpongTextureBuffers[i] = rendering::TextureCache::create_texture("blurTexture" + std::to_string(i), context.size(), settings);
-            m_pingpongFrameBuffers[i].attach(m_pingpongTextureBuffers[i], FRAGMENT_ATTACHMENT);
-        }
         // Adding itself to the post processing renderpass.
         addRenderPass<&Bloom::renderPass>();
     }
 
+    void Bloom::declare(FrameGraph& graph)
+    {
+        graph.read("scene color");
+        graph.read("HDR overdraw");
+        graph.read("HDR overdraw history");
+        graph.write("scene color");
+        graph.write("HDR overdraw");
+        graph.create("bloom blur 0", RenderPipelineBase::transientTextureDesc(settings));
+        graph.create("bloom blur 1", RenderPipelineBase::transientTextureDesc(settings));
+    }
+
     void Bloom::seperateOverdraw(framebuffer& fbo, texture_handle colortexture, texture_handle overdrawtexture)
     {
         // Brightness threshold stage
@@ -61,12 +69,10 @@ namespace legion::rendering
         m_gaussianBlurShader.get_uniform_with_location<math::ivec2>(SV_VIEWPORT).set_value(framebufferSize);
         m_gaussianBlurShader.get_uniform<int>("kernelsize").set_value(kernelsize);
 
-        // Resize the pingpong textures.
-        if (m_pingpongTextureBuffers[0].get_texture().size() != framebufferSize)
-        {
-            m_pingpongTextureBuffers[0].get_texture().resize(framebufferSize);
-            m_pingpongTextureBuffers[1].get_texture().resize(framebufferSize);
-        }
+        // Resize the pingpong textures, they are shared with other effects so each one is checked.
+        for (auto& texture : m_pingpongTextureBuffers)
+            if (texture.get_texture().size() != framebufferSize)
+                texture.get_texture().resize(framebufferSize);
 
         // This loop blurs the brightness threshold texture an x amount of times.
         for (uint i = 0; i < itterations * 2; i++)
@@ -167,6 +173,18 @@ namespace legion::rendering
         // Mix slight part of the previous frame overdraw into the current frame to reduce flickering and introduce slight trail when it's dark.
         historyMixOverdraw(fbo, overdrawTexture);
 
+        // Get the blur textures, they only live during this pass so the frame graph lets them share memory with textures of other effects.
+        static const std::string blurNames[2] = { "bloom blur 0", "bloom blur 1" };
+        for (int i = 0; i < 2; i++)
+        {
+            texture_handle blurTexture = pipeline->getTransientTexture(blurNames[i], framebufferSize, settings);
+            if (!(blurTexture == m_pingpongTextureBuffers[i]))
+            {
+                m_pingpongTextureBuffers[i] = blurTexture;
+                m_pingpongFrameBuffers[i].attach(blurTexture, FRAGMENT_ATTACHMENT);
+            }
+        }
+
         // Blur the overdraw buffer.
         texture_handle blurredImage = blurOverdraw(framebufferSize, overdrawTexture);
 
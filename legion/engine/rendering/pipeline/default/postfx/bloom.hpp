@@ -39,6 +39,7 @@ namespace legion::rendering
          * @param context The current context that is being used inside of the effect.
          */
         void setup(app::window& context) override;
+        void declare(FrameGraph& graph) override;
 
         void seperateOverdraw(framebuffer& fbo, texture_handle colortexture, texture_handle overdrawtexture);
 
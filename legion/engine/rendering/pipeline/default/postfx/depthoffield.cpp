@@ -16,38 +16,51 @@ namespace legion::rendering
         m_postFilterShader = ShaderCache::create_shader("postfiltershader", "engine://shaders/postfilter.shs"_view);
         m_preFilterShader = ShaderCache::create_shader("prefiltershader", "engine://shaders/prefilter.shs"_view);
 
-        // Create threshold fbo and texture.
+        // Create threshold fbo, the textures are transient and get fetched from the pipeline every pass.
         m_thresholdFbo = framebuffer(GL_FRAMEBUFFER);
-        m_thresholdTexture = rendering::TextureCache::create_texture("dofthreshold", context.size(), settings);
-        m_thresholdFbo.attach(m_thresholdTexture, FRAGMENT_ATTACHMENT);
-
-        // Create bokeh textures and resolution.
-        m_destinationTexture = rendering::TextureCache::create_texture("dofdestination", context.size(), settings);
-        m_halfres = context.size()/2;
-        m_halfres1 = rendering::TextureCache::create_texture("bokehhalfres1", m_halfres, settings);
-        m_halfres2 = rendering::TextureCache::create_texture("bokehhalfres2", m_halfres, settings);
 
         m_bokehSize = 4.0f;
 
         // Adding itself to the post processing renderpass.
         addRenderPass<&DepthOfField::renderPass>();
     }
+
+    void DepthOfField::declare(FrameGraph& graph)
+    {
+        graph.read("scene color");
+        graph.read("scene position");
+        graph.write("scene color");
+        graph.create("dof threshold", RenderPipelineBase::transientTextureDesc(settings));
+        graph.create("dof destination", RenderPipelineBase::transientTextureDesc(settings));
+        graph.create("dof bokeh 0", RenderPipelineBase::transientTextureDesc(settings, 0.5f));
+        graph.create("dof bokeh 1", RenderPipelineBase::transientTextureDesc(settings, 0.5f));
+    }
+
     void DepthOfField::renderPass(framebuffer& fbo, RenderPipelineBase* pipeline, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
         //Gets textures from framebuffer.
         auto [valid_textures, position_texture, color_texture] = getTextures(fbo);
         if (!valid_textures) return;
 
-        //Change sizes
+        //Gets the textures, they only live during this pass so the frame graph lets them share memory with textures of other effects.
         math::ivec2 textureSize = color_texture.get_texture().size();
-        if (textureSize != m_destinationTexture.get_texture().size())
+        m_halfres = textureSize / 2;
+        texture_handle thresholdTexture = pipeline->getTransientTexture("dof threshold", textureSize, settings);
+        if (!(thresholdTexture == m_thresholdTexture))
         {
-            m_destinationTexture.get_texture().resize(textureSize);
-            m_thresholdTexture.get_texture().resize(textureSize);
-            m_halfres = textureSize / 2;
-            m_halfres1.get_texture().resize(m_halfres);
-            m_halfres2.get_texture().resize(m_halfres);
+            m_thresholdTexture = thresholdTexture;
+            m_thresholdFbo.attach(m_thresholdTexture, FRAGMENT_ATTACHMENT);
         }
+        m_destinationTexture = pipeline->getTransientTexture("dof destination", textureSize, settings);
+        m_halfres1 = pipeline->getTransientTexture("dof bokeh 0", m_halfres, settings);
+        m_halfres2 = pipeline->getTransientTexture("dof bokeh 1", m_halfres, settings);
+
+        //Change sizes, shared textures might have been resized already so each one is checked.
+        const std::pair<texture_handle, math::ivec2> sizes[] = {
+            { m_thresholdTexture, textureSize }, { m_destinationTexture, textureSize }, { m_halfres1, m_halfres }, { m_halfres2, m_halfres } };
+        for (auto& [texture, size] : sizes)
+            if (texture.get_texture().size() != size)
+                texture.get_texture().resize(size);
 
         //Calculates the area of focus and outputs it onto a texture.
         areaOfFocus(color_texture, camInput, position_texture);
@@ -43,6 +43,7 @@ namespace legion::rendering
          * @param context The current context that is being used inside of the effect.
          */
         void setup(app::window& context) override;
+        void declare(FrameGraph& graph) override;
         /**
          * @brief renderPass The function that is called every frame.
          * @param fbo The framebuffer used for this particular effect.
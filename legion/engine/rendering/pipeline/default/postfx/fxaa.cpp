@@ -9,6 +9,12 @@ namespace legion::rendering
         addRenderPass<&FXAA::renderPass>();
     }
 
+    void FXAA::declare(FrameGraph& graph)
+    {
+        graph.read("scene color");
+        graph.write("scene color");
+    }
+
     void FXAA::renderPass(framebuffer& fbo, RenderPipelineBase* pipeline, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
         //Try to get color attachment.
@@ -10,6 +10,7 @@ namespace legion::rendering
         shader_handle m_fxaaShader;
     public:
         void setup(app::window& context) override;
+        void declare(FrameGraph& graph) override;
 
         void renderPass(framebuffer& fbo, RenderPipelineBase* pipeline, camera& cam, const camera::camera_input& camInput, time::span deltaTime);
     };
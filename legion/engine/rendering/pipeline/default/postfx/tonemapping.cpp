@@ -49,6 +49,12 @@ namespace legion::rendering
         exposure = 0.5f;
     }
 
+    void Tonemapping::declare(FrameGraph& graph)
+    {
+        graph.read("scene color");
+        graph.write("scene color");
+    }
+
     void Tonemapping::renderPass(framebuffer& fbo, RenderPipelineBase* pipeline, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
         //Try to get color attachment.
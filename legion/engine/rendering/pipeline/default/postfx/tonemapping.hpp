@@ -19,6 +19,7 @@ namespace legion::rendering
         static void setAlgorithm(tonemapping_type type);
 
         void setup(app::window& context) override;
+        void declare(FrameGraph& graph) override;
 
         void renderPass(framebuffer& fbo, RenderPipelineBase* pipeline, camera& cam, const camera::camera_input& camInput, time::span deltaTime);
 
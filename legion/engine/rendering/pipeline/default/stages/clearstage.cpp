@@ -56,6 +56,13 @@ namespace legion::rendering
         fbo->release();
     }
 
+    void ClearStage::declare(FrameGraph& graph)
+    {
+        //clears every attachment of the main framebuffer
+        for (cstring attachment : { "scene color", "scene normal", "scene position", "HDR overdraw", "scene depth" })
+            graph.write(attachment);
+    }
+
     priority_type ClearStage::priority()
     {
         return setup_priority;
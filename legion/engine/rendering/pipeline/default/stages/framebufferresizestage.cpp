@@ -181,6 +181,22 @@ namespace legion::rendering
         useTexture1 = !useTexture1;
     }
 
+    void FramebufferResizeStage::declare(FrameGraph& graph)
+    {
+        //the attachments of the main framebuffer are owned by this stage, the ones of the last frame are kept around for the next frame to read
+        for (cstring attachment : { "scene color", "scene normal", "scene position", "HDR overdraw", "scene depth" })
+        {
+            graph.import_resource(attachment);
+            graph.write(attachment);
+        }
+
+        for (cstring history : { "scene color history", "scene normal history", "scene position history", "HDR overdraw history", "scene depth history" })
+        {
+            graph.import_resource(history, true);
+            graph.write(history);
+        }
+    }
+
     priority_type FramebufferResizeStage::priority()
     {
         return setup_priority + 1;
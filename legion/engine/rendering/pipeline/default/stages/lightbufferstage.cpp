@@ -2,78 +2,97 @@
 
 namespace legion::rendering
 {
-   async::spinlock LightBufferStage::m_lightEntitiesLock;
-   std::unordered_set<ecs::entity_handle> LightBufferStage::m_lightEntities;
-   std::vector<detail::light_data> LightBufferStage::m_lights;
+   bool LightBufferStage::clusteredLighting = true;
 
-    void LightBufferStage::onLightCreate(events::component_creation<light>* event)
+    namespace
     {
-        OPTICK_EVENT();
-        std::lock_guard guard(m_lightEntitiesLock);
-        m_lightEntities.insert(event->entity);
-    }
-
-    void LightBufferStage::onLightDestroy(events::component_destruction<light>* event)
-    {
-        OPTICK_EVENT();
-        std::lock_guard guard(m_lightEntitiesLock);
-        m_lightEntities.erase(event->entity);
+        size_type alignUp(size_type value, size_type alignment)
+        {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
     }
 
     void LightBufferStage::setup(app::window& context)
     {
         OPTICK_EVENT();
-        buffer lightsBuffer;
+        ring_buffer lightsBuffer;
 
         {
             app::context_guard guard(context);
-            lightsBuffer = buffer(GL_SHADER_STORAGE_BUFFER, sizeof(detail::light_data) * 128, nullptr, GL_DYNAMIC_DRAW);
-            lightsBuffer.bindBufferBase(SV_LIGHTS);
+            GLint alignment;
+            glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+            m_ssboAlignment = static_cast<size_type>(alignment);
+            lightsBuffer = ring_buffer(GL_SHADER_STORAGE_BUFFER, sizeof(detail::light_data) * 128, m_ssboAlignment);
         }
 
-        create_meta<buffer>("light buffer", lightsBuffer);
+        create_meta<ring_buffer>("light buffer", lightsBuffer);
         create_meta<size_type>("light count");
-
-        bindToEvent<events::component_creation<light>, &LightBufferStage::onLightCreate>();
-        bindToEvent<events::component_destruction<light>, &LightBufferStage::onLightDestroy>();
-
-
-        static auto lightsQuery = createQuery<light>();
-        lightsQuery.queryEntities();
-
-        std::lock_guard guard(m_lightEntitiesLock);
-        for (auto ent : lightsQuery)
-            m_lightEntities.insert(ent);
     }
 
     void LightBufferStage::render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
         OPTICK_EVENT();
         (void)deltaTime;
-        (void)camInput;
         (void)cam;
 
         static id_type lightsbufferId = nameHash("light buffer");
         static id_type lightCountId = nameHash("light count");
-        buffer* lightsBuffer = get_meta<buffer>(lightsbufferId);
+        ring_buffer* lightsBuffer = get_meta<ring_buffer>(lightsbufferId);
 
-        {
-            std::lock_guard guard(m_lightEntitiesLock);
-            *get_meta<id_type>(lightCountId) = m_lightEntities.size();
-
-            m_lights.resize(m_lightEntities.size());
-            int i = 0;
-            for (auto ent : m_lightEntities)
-            {
-                light lght = ent.read_component<light>();
-                m_lights[i] = lght.get_light_data(ent.get_component_handle<position>(), ent.get_component_handle<rotation>());
-                i++;
-            }
-        }
+        //the lights were extracted at the end of the simulation frame, see RenderExtraction
+        const std::vector<detail::light_data>& lightData = RenderExtraction::currentSnapshot().lights;
+        m_lightSpheres.clear();
+        for (auto& data : lightData)
+            m_lightSpheres.push_back({ data.position, data.attenuation });
+
+        const size_type lightCount = lightData.size();
+        *get_meta<size_type>(lightCountId) = lightCount;
+
+        if (clusteredLighting)
+            m_clusterer.build(m_lightSpheres.data(), lightCount, camInput.view, camInput.proj, camInput.nearz, camInput.farz,
+                async::job_runner(*m_scheduler), m_clusters);
+        else
+            m_clusterer.build_flat(lightCount, m_clusters);
 
         app::context_guard guard(context);
-        lightsBuffer->bufferData(m_lights);
+        if (!guard.contextIsValid())
+            return;
+
+        lightsBuffer->begin_frame();
+
+        //the lights, the cluster grid and the light indices share one allocation, so growing the ring can't invalidate one of them halfway through the frame
+        //empty ranges can't be bound so there's always room for at least 1 light and 1 index
+        const size_type lightsSize = math::max<size_type>(lightCount, 1) * sizeof(detail::light_data);
+        const size_type clustersSize = sizeof(light_cluster_params) + m_clusters.clusters.size() * sizeof(light_cluster);
+        const size_type indicesSize = math::max<size_type>(m_clusters.indices.size(), 1) * sizeof(uint32);
+
+        const size_type clustersOffset = alignUp(lightsSize, m_ssboAlignment);
+        const size_type indicesOffset = clustersOffset + alignUp(clustersSize, m_ssboAlignment);
+
+        ring_allocation allocation = lightsBuffer->allocate(indicesOffset + indicesSize);
+        if (!allocation.data)
+            return;
 
+        byte* data = static_cast<byte*>(allocation.data);
+        if (lightCount)
+            std::memcpy(data, lightData.data(), lightCount * sizeof(detail::light_data));
+
+        std::memcpy(data + clustersOffset, &m_clusters.params, sizeof(light_cluster_params));
+        std::memcpy(data + clustersOffset + sizeof(light_cluster_params), m_clusters.clusters.data(), m_clusters.clusters.size() * sizeof(light_cluster));
+
+        if (!m_clusters.indices.empty())
+            std::memcpy(data + indicesOffset, m_clusters.indices.data(), m_clusters.indices.size() * sizeof(uint32));
+
+        const buffer& lightsBufferObject = lightsBuffer->get_buffer();
+        lightsBufferObject.bindBufferRange(SV_LIGHTS, allocation.offset, lightsSize);
+        lightsBufferObject.bindBufferRange(SV_LIGHTCLUSTERS, allocation.offset + clustersOffset, clustersSize);
+        lightsBufferObject.bindBufferRange(SV_LIGHTINDICES, allocation.offset + indicesOffset, indicesSize);
+    }
+
+    void LightBufferStage::declare(FrameGraph& graph)
+    {
+        graph.import_resource("light buffer");
+        graph.write("light buffer");
     }
 
     priority_type LightBufferStage::priority()
@@ -2,20 +2,29 @@
 #include <rendering/pipeline/base/renderstage.hpp>
 #include <rendering/pipeline/base/pipeline.hpp>
 #include <rendering/components/light.hpp>
+#include <rendering/systems/render_extraction.hpp>
+#include <rendering/data/ring_buffer.hpp>
+#include <rendering/util/light_clustering.hpp>
 
 namespace legion::rendering
 {
     class LightBufferStage : public RenderStage<LightBufferStage>
     {
-        static async::spinlock m_lightEntitiesLock;
-        static std::unordered_set<ecs::entity_handle> m_lightEntities;
-        static std::vector<detail::light_data> m_lights;
+        //bounds of the lights of the frame, gathered before uploading because the size of the cluster lists is only known after binning
+        std::vector<light_sphere> m_lightSpheres;
 
-        void onLightCreate(events::component_creation<light>* event);
-        void onLightDestroy(events::component_destruction<light>* event);
+        LightClusterer m_clusterer;
+        light_clusters m_clusters;
+        size_type m_ssboAlignment = 1;
 
     public:
+        /**@brief When set, lights are binned into clusters of the view frustum and every fragment only loops over the lights of its cluster.
+         *        Otherwise every fragment loops over every light.
+         */
+        static bool clusteredLighting;
+
         virtual void setup(app::window& context) override;
+        virtual void declare(FrameGraph& graph) override;
         virtual void render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime) override;
         virtual priority_type priority() override;
     };
@@ -2,47 +2,258 @@
 
 namespace  legion::rendering
 {
+    bool MeshBatchingStage::frustumCulling = true;
+    bool MeshBatchingStage::occlusionCulling = true;
+    math::ivec2 MeshBatchingStage::occlusionBufferSize = math::ivec2(256, 128);
+
     void MeshBatchingStage::setup(app::window& context)
     {
         OPTICK_EVENT();
-        create_meta<sparse_map<material_handle, sparse_map<model_handle, std::vector<math::mat4>>>>("mesh batches");
+        create_meta<instance_batches>("mesh batches");
     }
 
     void MeshBatchingStage::render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
         OPTICK_EVENT();
         (void)deltaTime;
-        (void)camInput;
         (void)cam;
-        (void)context;
 
         static id_type batchesId = nameHash("mesh batches");
-        auto* batches = get_meta<sparse_map<material_handle, sparse_map<model_handle, std::vector<math::mat4>>>>(batchesId);
+        auto* batches = get_meta<instance_batches>(batchesId);
+
+        //the renderables were extracted at the end of the simulation frame, see RenderExtraction
+        const render_snapshot& snapshot = RenderExtraction::currentSnapshot();
+        const math::mat4* worldMatrices = snapshot.worldMatrices.data();
+        const id_type* materials = snapshot.materials.data();
+        const id_type* models = snapshot.models.data();
 
-        static auto renderablesQuery = createQuery<position, rotation, scale, mesh_filter, mesh_renderer>();
-        renderablesQuery.queryEntities();
+        const size_type count = snapshot.worldMatrices.size();
 
-        auto& positions = renderablesQuery.get<position>();
-        auto& rotations = renderablesQuery.get<rotation>();
-        auto& scales = renderablesQuery.get<scale>();
-        auto& filters = renderablesQuery.get<mesh_filter>();
-        auto& renderers = renderablesQuery.get<mesh_renderer>();
+        //the versions of the cached bounds and occluder copies only need to be checked when any mesh changed
+        const uint64 meshGeneration = MeshCache::generation();
+        if (meshGeneration != m_meshGeneration)
+        {
+            OPTICK_EVENT("Drop changed meshes");
+            m_meshGeneration = meshGeneration;
+            for (auto iter = m_modelBounds.begin(); iter != m_modelBounds.end();)
+            {
+                if (MeshCache::get_version(iter->first) != iter->second.version)
+                    iter = m_modelBounds.erase(iter);
+                else
+                    ++iter;
+            }
+
+            for (auto iter = m_occluderGeometry.begin(); iter != m_occluderGeometry.end();)
+            {
+                if (MeshCache::get_version(iter->first) != iter->second.version)
+                    iter = m_occluderGeometry.erase(iter);
+                else
+                    ++iter;
+            }
+        }
 
         {
-            OPTICK_EVENT("Clear instances");
-            for (auto [_, models] : *batches)
-                for (auto [_, instances] : models)
-                    instances.clear();
+            OPTICK_EVENT("Fetch model bounds");
+            for (size_type i = 0; i < count; i++)
+            {
+                //models that don't exist yet get infinite bounds, those are fetched again until the model exists
+                //the version is read before the bounds, if the mesh changes in between they are fetched again next frame
+                const id_type modelId = models[i];
+                auto iter = m_modelBounds.find(modelId);
+                if (iter == m_modelBounds.end())
+                {
+                    const uint64 version = MeshCache::get_version(modelId);
+                    m_modelBounds.emplace(modelId, model_bounds{ model_handle{ modelId }.get_bounds(), version });
+                }
+                else if (iter->second.bounds.radius == std::numeric_limits<float>::max())
+                {
+                    iter->second.version = MeshCache::get_version(modelId);
+                    iter->second.bounds = model_handle{ modelId }.get_bounds();
+                }
+            }
         }
 
+        m_sphereX.resize(count);
+        m_sphereY.resize(count);
+        m_sphereZ.resize(count);
+        m_sphereRadius.resize(count);
+        m_visible.resize(count);
+
         {
             OPTICK_EVENT("Calculate instances");
-            for (int i = 0; i < renderablesQuery.size(); i++)
+            async::for_each_range(*m_scheduler, count, m_instancesPerJob, [&](size_type start, size_type end)
+                {
+                    for (size_type i = start; i < end; i++)
+                    {
+                        //the scale is the length of the basis vectors, the sphere grows with the largest one so it still contains the mesh when it is scaled unevenly
+                        const math::mat4& world = worldMatrices[i];
+                        const mesh_bounds& bounds = m_modelBounds.at(models[i]).bounds;
+                        const math::vec3 center(world * math::vec4(bounds.center, 1.f));
+                        const float maxScale2 = math::max(math::length2(math::vec3(world[0])), math::max(math::length2(math::vec3(world[1])), math::length2(math::vec3(world[2]))));
+
+                        m_sphereX[i] = center.x;
+                        m_sphereY[i] = center.y;
+                        m_sphereZ[i] = center.z;
+                        m_sphereRadius[i] = bounds.radius * math::sqrt(maxScale2);
+                    }
+                });
+        }
+
+        if (frustumCulling)
+        {
+            OPTICK_EVENT("Frustum culling");
+            const math::view_frustum viewFrustum = math::view_frustum::from_view_projection(camInput.proj * camInput.view);
+
+            async::for_each_range(*m_scheduler, count, m_instancesPerJob, [&](size_type start, size_type end)
+                {
+                    viewFrustum.cull_spheres(m_sphereX.data() + start, m_sphereY.data() + start, m_sphereZ.data() + start,
+                        m_sphereRadius.data() + start, end - start, m_visible.data() + start);
+                });
+        }
+        else
+        {
+            std::fill(m_visible.begin(), m_visible.end(), static_cast<byte>(1));
+        }
+
+        if (occlusionCulling && !snapshot.occluderMeshes.empty())
+        {
+            OPTICK_EVENT("Occlusion culling");
+            const math::mat4 viewProjection = camInput.proj * camInput.view;
+            if (m_occlusionBuffer.size() != occlusionBufferSize)
+                m_occlusionBuffer.resize(occlusionBufferSize);
+
+            m_occluders.clear();
+            for (size_type i = 0; i < snapshot.occluderMeshes.size(); i++)
             {
-                OPTICK_EVENT("instance");
-                (*batches)[renderers[i].material][model_handle{ filters[i].id }].push_back(math::compose(scales[i], rotations[i], positions[i]));
+                //meshes that don't exist yet are fetched again next frame
+                const id_type meshId = snapshot.occluderMeshes[i];
+                auto iter = m_occluderGeometry.find(meshId);
+                if (iter == m_occluderGeometry.end())
+                {
+                    //the version is read before the data, if the mesh changes in between it is copied again next frame
+                    const uint64 version = MeshCache::get_version(meshId);
+                    mesh_handle handle = MeshCache::get_handle(meshId);
+                    if (handle == invalid_mesh_handle || version == 0)
+                        continue;
+
+                    auto [lock, data] = handle.get();
+                    async::readonly_guard guard(lock);
+                    iter = m_occluderGeometry.emplace(meshId, occluder_geometry{ data.vertices, data.indices, version }).first;
+                }
+
+                const occluder_geometry& geometry = iter->second;
+                m_occluders.push_back(occluder_mesh{ geometry.vertices.data(), geometry.vertices.size(), geometry.indices.data(), geometry.indices.size(), snapshot.occluderMatrices[i] });
             }
+
+            m_occlusionBuffer.rasterize(viewProjection, m_occluders.data(), m_occluders.size(), async::job_runner(*m_scheduler));
+
+            async::for_each_range(*m_scheduler, count, m_instancesPerJob, [&](size_type start, size_type end)
+                {
+                    for (size_type i = start; i < end; i++)
+                    {
+                        //models of which the bounds are not known yet are always drawn
+                        const mesh_bounds& bounds = m_modelBounds.at(models[i]).bounds;
+                        if (!m_visible[i] || bounds.radius == std::numeric_limits<float>::max())
+                            continue;
+
+                        m_visible[i] = m_occlusionBuffer.is_visible(viewProjection * worldMatrices[i], bounds.min, bounds.max) ? 1 : 0;
+                    }
+                });
         }
+
+        {
+            OPTICK_EVENT("Batch instances");
+            static id_type matricesId = nameHash("model matrix buffer");
+            ring_buffer* modelMatrixBuffer = get_meta<ring_buffer>(matricesId);
+            if (!modelMatrixBuffer || !modelMatrixBuffer->valid())
+            {
+                batches->ranges.clear();
+                return;
+            }
+
+            const math::vec3 camPos = camInput.pos;
+            const math::vec3 viewDir = camInput.vdir;
+            const float inverseFar = camInput.farz > 0.f ? 1.f / camInput.farz : 0.f;
+
+            //the sorted instances are written straight into the mapped memory of this frame's region of the instance buffer
+            app::context_guard guard(context);
+            if (!guard.contextIsValid())
+            {
+                batches->ranges.clear();
+                return;
+            }
+
+            modelMatrixBuffer->begin_frame();
+
+            //particle pools are locked until their instances are written, so the particle system manager can't change their counts in between
+            m_particlePools.clear();
+            ParticlePoolCache::forEachPool([&](particle_pool& pool)
+                {
+                    if (pool.material() != invalid_id && pool.model() != invalid_id)
+                        m_particlePools.push_back(&pool);
+                });
+
+            size_type particleCount = 0;
+            m_particleOffsets.resize(m_particlePools.size());
+            m_particleCounts.resize(m_particlePools.size());
+            for (size_type i = 0; i < m_particlePools.size(); i++)
+            {
+                m_particlePools[i]->get_lock().lock_shared();
+                m_particleOffsets[i] = particleCount;
+                m_particleCounts[i] = m_particlePools[i]->alive_count();
+                particleCount += m_particleCounts[i];
+            }
+
+            //the particles go right behind the batched renderables in the same allocation, growing the ring would invalidate earlier allocations of the frame
+            math::mat4* particleInstances = nullptr;
+            m_batcher.build(count, worldMatrices, [&](size_type i)
+                {
+                    const math::vec3 center(m_sphereX[i], m_sphereY[i], m_sphereZ[i]);
+                    return batch_instance{ m_visible[i] != 0, materials[i], models[i], math::dot(center - camPos, viewDir) * inverseFar };
+                },
+                [&](size_type instanceCount, size_type& firstInstance)
+                {
+                    ring_allocation allocation = modelMatrixBuffer->allocate((instanceCount + particleCount) * sizeof(math::mat4));
+                    firstInstance = allocation.offset / sizeof(math::mat4);
+                    math::mat4* instances = static_cast<math::mat4*>(allocation.data);
+                    particleInstances = instances ? instances + instanceCount : nullptr;
+                    return instances;
+                },
+                async::job_runner(*m_scheduler), *batches);
+
+            if (particleCount > 0 && batches->instanceCount == 0)
+            {
+                ring_allocation allocation = modelMatrixBuffer->allocate(particleCount * sizeof(math::mat4));
+                batches->firstInstance = allocation.offset / sizeof(math::mat4);
+                particleInstances = static_cast<math::mat4*>(allocation.data);
+            }
+
+            if (particleInstances)
+            {
+                OPTICK_EVENT("Write particle instances");
+                async::run_jobs(*m_scheduler, m_particlePools.size(), [&](size_type i)
+                    {
+                        m_particleCounts[i] = m_particlePools[i]->write_instances(particleInstances + m_particleOffsets[i], nullptr, m_particleCounts[i]);
+                    });
+
+                for (size_type i = 0; i < m_particlePools.size(); i++)
+                    if (m_particleCounts[i] > 0)
+                        batches->ranges.push_back({ m_particlePools[i]->material(), m_particlePools[i]->model(), batches->instanceCount + m_particleOffsets[i], m_particleCounts[i] });
+
+                batches->instanceCount += particleCount;
+            }
+
+            for (auto* pool : m_particlePools)
+                pool->get_lock().unlock_shared();
+        }
+    }
+
+    void MeshBatchingStage::declare(FrameGraph& graph)
+    {
+        graph.import_resource("mesh batches");
+        graph.import_resource("model matrix buffer");
+        graph.write("mesh batches");
+        graph.write("model matrix buffer");
     }
 
     priority_type MeshBatchingStage::priority()
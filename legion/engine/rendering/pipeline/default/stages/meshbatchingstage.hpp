@@ -2,13 +2,72 @@
 #include <rendering/pipeline/base/renderstage.hpp>
 #include <rendering/pipeline/base/pipeline.hpp>
 #include <rendering/components/renderable.hpp>
+#include <rendering/systems/render_extraction.hpp>
+#include <rendering/data/ring_buffer.hpp>
+#include <rendering/util/instance_batcher.hpp>
+#include <rendering/util/occlusion_buffer.hpp>
+#include <rendering/data/particle_pool_cache.hpp>
+#include <core/math/frustum.hpp>
 
 namespace legion::rendering
 {
     class MeshBatchingStage : public RenderStage<MeshBatchingStage>
     {
+        //world space bounding sphere of every renderable in the snapshot, stored as a structure of arrays for the culling pass
+        std::vector<float> m_sphereX;
+        std::vector<float> m_sphereY;
+        std::vector<float> m_sphereZ;
+        std::vector<float> m_sphereRadius;
+        std::vector<byte> m_visible;
+
+        //local bounds of every model that was rendered so far, so the model cache only needs to be locked for new models
+        //bounds of models of which the mesh was destroyed or replaced are dropped when the mesh version changes, see MeshCache::get_version
+        struct model_bounds
+        {
+            mesh_bounds bounds;
+            uint64 version;
+        };
+
+        std::unordered_map<id_type, model_bounds> m_modelBounds;
+
+        //vertices and indices of the occluder meshes, copied once so the mesh cache doesn't need to be locked every frame
+        //copies of meshes that were destroyed or replaced are dropped when the mesh version changes, see MeshCache::get_version
+        struct occluder_geometry
+        {
+            std::vector<math::vec3> vertices;
+            std::vector<uint> indices;
+            uint64 version;
+        };
+
+        std::unordered_map<id_type, occluder_geometry> m_occluderGeometry;
+        uint64 m_meshGeneration = 0;
+        std::vector<occluder_mesh> m_occluders;
+        occlusion_buffer m_occlusionBuffer;
+
+        InstanceBatcher m_batcher;
+
+        //particle pools that are drawn this frame, with where their instances start and how many they wrote
+        std::vector<particle_pool*> m_particlePools;
+        std::vector<size_type> m_particleOffsets;
+        std::vector<size_type> m_particleCounts;
+
+        static constexpr size_type m_instancesPerJob = 256;
+
     public:
+        /**@brief When set, only the renderables of which the bounding sphere intersects the view frustum of the camera are batched.
+         */
+        static bool frustumCulling;
+
+        /**@brief When set, the occluders are rasterized on the CPU and the renderables of which the bounding box is completely behind them are not batched.
+         */
+        static bool occlusionCulling;
+
+        /**@brief Resolution of the depth buffer the occluders are rasterized into.
+         */
+        static math::ivec2 occlusionBufferSize;
+
         virtual void setup(app::window& context) override;
+        virtual void declare(FrameGraph& graph) override;
         virtual void render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime) override;
         virtual priority_type priority() override;
     };
@@ -3,12 +3,44 @@
 #include <rendering/data/buffer.hpp>
 #include <rendering/data/model.hpp>
 
+#include <cstring>
+
 namespace legion::rendering
 {
+    bool MeshRenderStage::multiDrawIndirect = true;
+
     void MeshRenderStage::setup(app::window& context)
     {
     }
 
+    void MeshRenderStage::bindMaterial(material_handle& material, const camera::camera_input& camInput, size_type lightCount, texture_handle sceneColor,
+        texture_handle sceneNormal, texture_handle scenePosition, texture_handle hdrOverdraw, texture_handle sceneDepth)
+    {
+        OPTICK_EVENT();
+        auto materialName = material.get_name();
+        OPTICK_TAG("Material", materialName.c_str());
+
+        camInput.bind(material);
+        material.try_set_param<uint>(SV_LIGHTCOUNT, static_cast<uint>(lightCount));
+
+        if (sceneColor)
+            material.try_set_param(SV_SCENECOLOR, sceneColor);
+
+        if (sceneNormal)
+            material.try_set_param(SV_SCENENORMAL, sceneNormal);
+
+        if (scenePosition)
+            material.try_set_param(SV_SCENEPOSITION, scenePosition);
+
+        if (hdrOverdraw)
+            material.try_set_param(SV_HDROVERDRAW, hdrOverdraw);
+
+        if (sceneDepth)
+            material.try_set_param(SV_SCENEDEPTH, sceneDepth);
+
+        material.bind();
+    }
+
     void MeshRenderStage::render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime)
     {
         OPTICK_EVENT();
@@ -24,21 +56,20 @@ namespace legion::rendering
         // static id_type sceneColorId = nameHash("scene color history");
         // static id_type sceneDepthId = nameHash("scene depth history");
 
-        //auto* batches = get_meta<sparse_map<material_handle, sparse_map<model_handle, std::unordered_set<ecs::entity_handle>>>>(batchesId);
-        auto* batches = get_meta<sparse_map<material_handle, sparse_map<model_handle, std::vector<math::mat4>>>>(batchesId);
+        auto* batches = get_meta<instance_batches>(batchesId);
         if (!batches)
             return;
 
-        buffer* lightsBuffer = get_meta<buffer>(lightsId);
-        if (!lightsBuffer)
+        ring_buffer* lightsBuffer = get_meta<ring_buffer>(lightsId);
+        if (!lightsBuffer || !lightsBuffer->valid())
             return;
 
         size_type* lightCount = get_meta<size_type>(lightCountId);
         if (!lightCount)
             return;
 
-        buffer* modelMatrixBuffer = get_meta<buffer>(matricesId);
-        if (!modelMatrixBuffer)
+        ring_buffer* modelMatrixBuffer = get_meta<ring_buffer>(matricesId);
+        if (!modelMatrixBuffer || !modelMatrixBuffer->valid())
             return;
 
         auto* fbo = getFramebuffer(mainId);
@@ -93,87 +124,130 @@ namespace legion::rendering
 
         fbo->bind();
 
-        for (auto [material, instancesPerMaterial] : *batches)
+        //the batching stage wrote the instances into the instance buffer already, every draw call picks its own range with the base instance
+        const buffer& instanceBuffer = modelMatrixBuffer->get_buffer();
+
         {
-            OPTICK_EVENT("Rendering material");
-            auto materialName = material.get_name();
-            OPTICK_TAG("Material", materialName.c_str());
+            OPTICK_EVENT("Build indirect commands");
+            m_megabuffer.evict_changed();
+            build_indirect_commands(*batches, [&](id_type modelId) -> const packed_model*
+                {
+                    if (!multiDrawIndirect || modelId == invalid_id)
+                        return nullptr;
 
-            camInput.bind(material);
-            if (material.has_param<uint>(SV_LIGHTCOUNT))
-                material.set_param<uint>(SV_LIGHTCOUNT, *lightCount);
+                    ModelCache::create_model(modelId);
+                    model_handle modelHandle{ modelId };
+                    if (!modelHandle.get_model().packable)
+                        return nullptr;
 
-            if (sceneColor && material.has_param<texture_handle>(SV_SCENECOLOR))
-                material.set_param<texture_handle>(SV_SCENECOLOR, sceneColor);
+                    return m_megabuffer.pack(modelHandle);
+                },
+                [](id_type materialId) { return material_handle{ materialId }.current_variant(); }, m_drawList);
+        }
 
-            if (sceneNormal && material.has_param<texture_handle>(SV_SCENENORMAL))
-                material.set_param<texture_handle>(SV_SCENENORMAL, sceneNormal);
+        if (!m_drawList.commands.empty())
+        {
+            OPTICK_EVENT("Multi draw indirect");
+            if (!m_commandBuffer.valid())
+                m_commandBuffer = ring_buffer(GL_DRAW_INDIRECT_BUFFER, sizeof(draw_elements_indirect_command) * 1024, sizeof(uint));
 
-            if (scenePosition && material.has_param<texture_handle>(SV_SCENEPOSITION))
-                material.set_param<texture_handle>(SV_SCENEPOSITION, scenePosition);
+            m_commandBuffer.begin_frame();
+            const size_type commandsSize = m_drawList.commands.size() * sizeof(draw_elements_indirect_command);
+            ring_allocation allocation = m_commandBuffer.allocate(commandsSize);
 
-            if (hdrOverdraw && material.has_param<texture_handle>(SV_HDROVERDRAW))
-                material.set_param<texture_handle>(SV_HDROVERDRAW, hdrOverdraw);
+            if (allocation.data)
+            {
+                std::memcpy(allocation.data, m_drawList.commands.data(), commandsSize);
+
+                m_megabuffer.bind_matrix_buffer(instanceBuffer);
+                m_megabuffer.bind();
+                m_commandBuffer.get_buffer().bind();
 
-            if (sceneDepth && material.has_param<texture_handle>(SV_SCENEDEPTH))
-                material.set_param<texture_handle>(SV_SCENEDEPTH, sceneDepth);
+                for (auto& group : m_drawList.groups)
+                {
+                    if (group.commandCount == 0)
+                        continue;
 
-            material.bind();
+                    material_handle material{ group.material };
+                    bindMaterial(material, camInput, *lightCount, sceneColor, sceneNormal, scenePosition, hdrOverdraw, sceneDepth);
 
-            for (auto [modelHandle, instances] : instancesPerMaterial)
+                    const size_type offset = allocation.offset + group.firstCommand * sizeof(draw_elements_indirect_command);
+                    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, reinterpret_cast<GLvoid*>(offset), (GLsizei)group.commandCount, 0);
+
+                    material.release();
+                }
+
+                m_commandBuffer.get_buffer().release();
+                m_megabuffer.release();
+            }
+        }
+
+        //models that aren't in the shared mesh buffers are drawn with their own vertex array, a draw call per sub-mesh
+        material_handle material = invalid_material_handle;
+        for (auto& range : m_drawList.unpacked)
+        {
+            if (range.material != material.id)
             {
-                if (modelHandle.id == invalid_id)
-                    return;
+                if (material.id != invalid_id)
+                    material.release();
 
-                ModelCache::create_model(modelHandle.id);
-                auto modelName = ModelCache::get_model_name(modelHandle.id);
-                OPTICK_EVENT("Rendering instances");
-                OPTICK_TAG("Model", modelName.c_str());
+                material = material_handle{ range.material };
+                bindMaterial(material, camInput, *lightCount, sceneColor, sceneNormal, scenePosition, hdrOverdraw, sceneDepth);
+            }
 
-                const model& mesh = modelHandle.get_model();
+            model_handle modelHandle{ range.model };
+            if (modelHandle.id == invalid_id)
+                continue;
 
-                if (!mesh.buffered)
-                    modelHandle.buffer_data(*modelMatrixBuffer);
+            ModelCache::create_model(modelHandle.id);
+            auto modelName = ModelCache::get_model_name(modelHandle.id);
+            OPTICK_EVENT("Rendering instances");
+            OPTICK_TAG("Model", modelName.c_str());
 
-                if (mesh.submeshes.empty())
-                {
-                    log::warn("Empty mesh found. Model name: {},  Model ID {}", modelName, modelHandle.get_mesh().id);
-                    continue;
-                }
+            const model& mesh = modelHandle.get_model();
 
-                {
-                    OPTICK_EVENT("Calculating matrices");
-                    /*m_matrices.resize(instances.size());
-                    int i = 0;
-                    for (auto& ent : instances)
-                    {
-                        m_matrices[i] = transform(ent.get_component_handles<transform>()).get_local_to_world_matrix();
-                        i++;
-                    }*/
-
-                    modelMatrixBuffer->bufferData(instances);
-                }
+            if (!mesh.buffered)
+                modelHandle.buffer_data(instanceBuffer);
+            else if (mesh.matrixBufferId != instanceBuffer.id())
+                modelHandle.bind_matrix_buffer(instanceBuffer);
 
-                {
-                    OPTICK_EVENT("Draw call");
-                    mesh.vertexArray.bind();
-                    mesh.indexBuffer.bind();
-                    lightsBuffer->bind();
-                    for (auto submesh : mesh.submeshes)
-                        glDrawElementsInstanced(GL_TRIANGLES, (GLuint)submesh.indexCount, GL_UNSIGNED_INT, (GLvoid*)(submesh.indexOffset * sizeof(uint)), (GLsizei)instances.size());
-
-                    lightsBuffer->release();
-                    mesh.indexBuffer.release();
-                    mesh.vertexArray.release();
-                }
+            if (mesh.submeshes.empty())
+            {
+                log::warn("Empty mesh found. Model name: {},  Model ID {}", modelName, modelHandle.get_mesh().id);
+                continue;
             }
 
-            material.release();
+            {
+                OPTICK_EVENT("Draw call");
+                mesh.vertexArray.bind();
+                mesh.indexBuffer.bind();
+                lightsBuffer->get_buffer().bind();
+                for (auto submesh : mesh.submeshes)
+                    glDrawElementsInstancedBaseInstance(GL_TRIANGLES, (GLuint)submesh.indexCount, GL_UNSIGNED_INT, (GLvoid*)(submesh.indexOffset * sizeof(uint)),
+                        (GLsizei)range.count, (GLuint)(batches->firstInstance + range.start));
+
+                lightsBuffer->get_buffer().release();
+                mesh.indexBuffer.release();
+                mesh.vertexArray.release();
+            }
         }
 
+        if (material.id != invalid_id)
+            material.release();
+
         fbo->release();
     }
 
+    void MeshRenderStage::declare(FrameGraph& graph)
+    {
+        graph.read("mesh batches");
+        graph.read("model matrix buffer");
+        graph.read("light buffer");
+        graph.read("scene depth");
+        for (cstring attachment : { "scene color", "scene normal", "scene position", "HDR overdraw", "scene depth" })
+            graph.write(attachment);
+    }
+
     priority_type MeshRenderStage::priority()
     {
         return opaque_priority;
@@ -1,15 +1,29 @@
 #pragma once
 #include <rendering/pipeline/base/renderstage.hpp>
 #include <rendering/pipeline/base/pipeline.hpp>
+#include <rendering/data/ring_buffer.hpp>
+#include <rendering/data/mesh_megabuffer.hpp>
+#include <rendering/util/instance_batcher.hpp>
+#include <rendering/util/indirect_commands.hpp>
 
 namespace legion::rendering
 {
     class MeshRenderStage : public RenderStage<MeshRenderStage>
     {
-        std::vector<math::mat4> m_matrices;
+        mesh_megabuffer m_megabuffer;
+        ring_buffer m_commandBuffer;
+        indirect_draw_list m_drawList;
+
+        static void bindMaterial(material_handle& material, const camera::camera_input& camInput, size_type lightCount, texture_handle sceneColor,
+            texture_handle sceneNormal, texture_handle scenePosition, texture_handle hdrOverdraw, texture_handle sceneDepth);
 
     public:
+        /**@brief When set, models that can be packed into the shared mesh buffers are drawn with glMultiDrawElementsIndirect, a draw per material.
+         */
+        static bool multiDrawIndirect;
+
         virtual void setup(app::window& context) override;
+        virtual void declare(FrameGraph& graph) override;
         virtual void render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime) override;
         virtual priority_type priority() override;
     };
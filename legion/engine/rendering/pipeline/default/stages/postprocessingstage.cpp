@@ -87,8 +87,13 @@ namespace legion::rendering
         glDrawBuffers(1, &attachment);
         fbo->release();
 
+        const FrameGraph& frameGraph = m_pipeline->getFrameGraph();
         for (auto& [_, effect] : m_effects)
         {
+            auto passIter = m_effectPasses.find(effect.get());
+            if (passIter != m_effectPasses.end() && !frameGraph.is_alive(passIter->second))
+                continue;
+
             OPTICK_EVENT("Rendering effect");
             OPTICK_TAG("Effect", effect->getName().c_str());
 
@@ -105,6 +110,20 @@ namespace legion::rendering
         glEnable(GL_DEPTH_TEST);
     }
 
+    void PostProcessingStage::declare(FrameGraph& graph)
+    {
+        graph.read("scene color");
+        graph.write("scene color");
+
+        //every effect gets a pass of its own so effects that nothing uses can be culled and their transient textures can share memory
+        m_effectPasses.clear();
+        for (auto& [_, effect] : m_effects)
+        {
+            m_effectPasses[effect.get()] = graph.add_pass(effect->getName());
+            effect->declare(graph);
+        }
+    }
+
     priority_type PostProcessingStage::priority()
     {
         return post_fx_priority;
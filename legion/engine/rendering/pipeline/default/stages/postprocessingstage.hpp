@@ -17,6 +17,10 @@ namespace legion::rendering
          * @brief A multimap with priority as key and postprocessing effect as value.
          */
         static std::multimap<priority_type, std::unique_ptr<PostProcessingEffectBase>,std::greater<>> m_effects;
+        /**
+         * @brief Pass of every effect in the frame graph, effects that were added after the graph was compiled always run.
+         */
+        std::unordered_map<PostProcessingEffectBase*, size_type> m_effectPasses;
         screen_quad m_screenQuad;
 
         framebuffer m_drawFBO;
@@ -46,6 +50,7 @@ namespace legion::rendering
         }
 
         virtual void setup(app::window& context) override;
+        virtual void declare(FrameGraph& graph) override;
         virtual void render(app::window& context, camera& cam, const camera::camera_input& camInput, time::span deltaTime) override;
         virtual priority_type priority() override;
     };
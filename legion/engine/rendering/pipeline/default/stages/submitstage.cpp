@@ -91,6 +91,13 @@ namespace legion::rendering
         cam.renderTarget.release();
     }
 
+    void SubmitStage::declare(FrameGraph& graph)
+    {
+        //presenting to the window is the reason any of the other stages run
+        graph.read("scene color");
+        graph.side_effect();
+    }
+
     priority_type SubmitStage::priority()
     {
         return submit_priority;
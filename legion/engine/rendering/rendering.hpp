@@ -6,6 +6,7 @@
 #include <rendering/pipeline/default/stages/postprocessingstage.hpp>
 #include <rendering/pipeline/default/postfx/tonemapping.hpp>
 #include <rendering/data/buffer.hpp>
+#include <rendering/data/ring_buffer.hpp>
 #include <rendering/data/framebuffer.hpp>
 #include <rendering/data/renderbuffer.hpp>
 #include <rendering/data/vertexarray.hpp>
@@ -13,6 +14,7 @@
 #include <rendering/data/postprocessingeffect.hpp>
 #include <rendering/data/particle_system_base.hpp>
 #include <rendering/data/particle_system_cache.hpp>
+#include <rendering/data/particle_pool_cache.hpp>
 
 namespace legion
 {
@@ -0,0 +1,162 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @file shader_source_hash.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct shader_include
+     * @brief Include directive found in shader source, quoted includes are looked up next to the including file first.
+     */
+    struct shader_include
+    {
+        std::string name;
+        bool quoted;
+    };
+
+    /**@brief Finds the include directives in shader source, in the order they appear.
+     */
+    inline std::vector<shader_include> find_shader_includes(std::string_view source)
+    {
+        std::vector<shader_include> includes;
+
+        size_type lineStart = 0;
+        while (lineStart < source.size())
+        {
+            size_type lineEnd = source.find('\n', lineStart);
+            if (lineEnd == std::string_view::npos)
+                lineEnd = source.size();
+
+            std::string_view line = source.substr(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+
+            const size_type directive = line.find_first_not_of(" \t");
+            if (directive == std::string_view::npos || line.substr(directive, 8) != "#include")
+                continue;
+
+            const size_type open = line.find_first_of("<\"", directive + 8);
+            if (open == std::string_view::npos)
+                continue;
+
+            const bool quoted = line[open] == '"';
+            const size_type close = line.find(quoted ? '"' : '>', open + 1);
+            if (close == std::string_view::npos)
+                continue;
+
+            includes.push_back({ std::string(line.substr(open + 1, close - open - 1)), quoted });
+        }
+
+        return includes;
+    }
+
+    /**@class shader_source_hasher
+     * @brief 64 bit FNV-1a, unlike nameHash the result is the same on every platform so it can be used to name files that outlive the process.
+     */
+    class shader_source_hasher
+    {
+    public:
+        void add(const void* data, size_type size) noexcept
+        {
+            const byte* bytes = static_cast<const byte*>(data);
+            for (size_type i = 0; i < size; i++)
+            {
+                m_hash ^= bytes[i];
+                m_hash *= 0x00000100000001b3;
+            }
+        }
+
+        void add(std::string_view str) noexcept
+        {
+            const uint64 size = str.size();
+            add(&size, sizeof(size));
+            add(str.data(), str.size());
+        }
+
+        void add(uint64 value) noexcept
+        {
+            add(&value, sizeof(value));
+        }
+
+        L_NODISCARD uint64 value() const noexcept { return m_hash; }
+
+    private:
+        uint64 m_hash = 0xcbf29ce484222325;
+    };
+
+    /**@brief Hashes everything the output of the shader preprocessor depends on: the source, the contents of everything it includes, the defines and the compiler settings.
+     *        Includes are resolved like the preprocessor does, so moving an include directory or adding a file that shadows an include also changes the hash.
+     * @param file Path of the shader source.
+     * @param includeDirectories Directories includes are searched in, in order.
+     * @param settings Anything else the output depends on, eg: compiler settings and version.
+     * @param read Callable with signature bool(const std::string& path, std::string& contents), returns false if the file doesn't exist.
+     * @param dependencies Optional output of the files that were hashed, the shader source first.
+     * @return The hash, 0 if the shader source itself couldn't be read.
+     */
+    template<typename Reader>
+    uint64 shader_source_hash(const std::string& file, const std::vector<std::string>& includeDirectories, const std::vector<std::string>& defines, uint64 settings, Reader&& read, std::vector<std::string>* dependencies = nullptr)
+    {
+        OPTICK_EVENT();
+        constexpr uint64 format_version = 1;
+
+        shader_source_hasher hasher;
+        hasher.add(format_version);
+        hasher.add(settings);
+        hasher.add(static_cast<uint64>(defines.size()));
+        for (auto& define : defines)
+            hasher.add(define);
+
+        std::string contents;
+        if (!read(file, contents))
+            return 0;
+
+        std::unordered_set<std::string> visited{ file };
+        std::vector<std::pair<std::string, std::string>> pending{ { file, std::move(contents) } };
+
+        while (!pending.empty())
+        {
+            auto [path, source] = std::move(pending.back());
+            pending.pop_back();
+
+            if (dependencies)
+                dependencies->push_back(path);
+
+            hasher.add(source);
+
+            const size_type folderEnd = path.find_last_of("\\/");
+            const std::string folder = folderEnd == std::string::npos ? std::string(".") : path.substr(0, folderEnd);
+
+            //includes are pushed in reverse so they are hashed in the order they appear
+            auto includes = find_shader_includes(source);
+            for (auto iter = includes.rbegin(); iter != includes.rend(); ++iter)
+            {
+                std::string resolved;
+                std::string includeContents;
+
+                if (iter->quoted && read(folder + "/" + iter->name, includeContents))
+                    resolved = folder + "/" + iter->name;
+
+                for (size_type i = 0; resolved.empty() && i < includeDirectories.size(); i++)
+                    if (read(includeDirectories[i] + "/" + iter->name, includeContents))
+                        resolved = includeDirectories[i] + "/" + iter->name;
+
+                //which file an include resolved to is part of the hash, a missing include hashes as just its name
+                hasher.add(iter->name);
+                hasher.add(resolved);
+
+                if (resolved.empty() || !visited.insert(resolved).second)
+                    continue;
+
+                pending.emplace_back(std::move(resolved), std::move(includeContents));
+            }
+        }
+
+        return hasher.value();
+    }
+}
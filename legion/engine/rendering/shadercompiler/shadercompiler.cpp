@@ -1,11 +1,63 @@
 #include <rendering/shadercompiler/shadercompiler.hpp>
+#include <rendering/shadercompiler/shader_source_hash.hpp>
 #include <rendering/util/settings.hpp>
 #include <lgnspre/gl_consts.hpp>
 #include <application/application.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
 namespace legion::rendering
 {
     delegate<void(const std::string&, log::severity)> ShaderCompiler::m_callback;
+    std::string ShaderCompiler::m_cachePath = "shadercache";
+    std::atomic<size_type> ShaderCompiler::m_cacheHits = 0;
+    std::atomic<size_type> ShaderCompiler::m_cacheMisses = 0;
+
+    namespace
+    {
+        bool readTextFile(const std::string& path, std::string& contents)
+        {
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream.is_open())
+                return false;
+
+            contents.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            return !stream.bad();
+        }
+
+        bool readBinaryFile(const std::string& path, byte_vec& data)
+        {
+            std::ifstream stream(path, std::ios::binary);
+            if (!stream.is_open())
+                return false;
+
+            data.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+            return !stream.bad();
+        }
+
+        //written under a name of its own first so other threads and processes never read a half written file
+        void writeBinaryFile(const std::string& path, const byte_vec& data)
+        {
+            std::ostringstream tempPath;
+            tempPath << path << '.' << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+
+            {
+                std::ofstream stream(tempPath.str(), std::ios::binary | std::ios::trunc);
+                if (!stream.is_open())
+                    return;
+                stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+            }
+
+            std::error_code error;
+            std::filesystem::rename(tempPath.str(), path, error);
+            if (error)
+                std::filesystem::remove(tempPath.str(), error);
+        }
+    }
 
 
     std::string ShaderCompiler::get_view_path(const fs::view& view, bool mustBeFile)
@@ -55,27 +107,21 @@ namespace legion::rendering
     const std::string& ShaderCompiler::get_shaderlib_path()
     {
         OPTICK_EVENT();
-        static std::string libPath;
-        if (libPath.empty())
-            libPath = get_view_path(fs::view("engine://shaderlib"), false);
+        static const std::string libPath = get_view_path(fs::view("engine://shaderlib"), false);
         return libPath;
     }
 
     const std::string& ShaderCompiler::get_compiler_path()
     {
         OPTICK_EVENT();
-        static std::string compPath;
-        if (compPath.empty())
-            compPath = get_view_path(fs::view("engine://tools"), false) + fs::strpath_manip::separator() + "lgnspre" + fs::strpath_manip::separator() + "lgnspre";
+        static const std::string compPath = get_view_path(fs::view("engine://tools"), false) + fs::strpath_manip::separator() + "lgnspre" + fs::strpath_manip::separator() + "lgnspre";
         return compPath;
     }
 
     const std::string& ShaderCompiler::get_cachecleaner_path()
     {
         OPTICK_EVENT();
-        static std::string compPath;
-        if (compPath.empty())
-            compPath = get_view_path(fs::view("engine://tools"), false) + fs::strpath_manip::separator() + "lgnspre" + fs::strpath_manip::separator() + "lgncleancache";
+        static const std::string compPath = get_view_path(fs::view("engine://tools"), false) + fs::strpath_manip::separator() + "lgnspre" + fs::strpath_manip::separator() + "lgncleancache";
         return compPath;
     }
 
@@ -108,21 +154,17 @@ namespace legion::rendering
         }
 
         // Create lookup table for the OpenGL function types that can be changed by the shader state.
-        static std::unordered_map<std::string, GLenum> funcTypes;
-        static bool funcTypesInitialized = false;
-        if (!funcTypesInitialized)
-        {
-            funcTypesInitialized = true;
-            funcTypes["DEPTH"] = GL_DEPTH_TEST;
-            funcTypes["CULL"] = GL_CULL_FACE;
-            funcTypes["ALPHA_SOURCE"] = GL_BLEND_SRC;
-            funcTypes["ALPHA_DEST"] = GL_BLEND_DST;
-            funcTypes["ALPHA"] = GL_BLEND;
-            funcTypes["BLEND_SOURCE"] = GL_BLEND_SRC;
-            funcTypes["BLEND_DEST"] = GL_BLEND_DST;
-            funcTypes["BLEND"] = GL_BLEND;
-            funcTypes["DITHER"] = GL_DITHER;
-        }
+        static const std::unordered_map<std::string, GLenum> funcTypes = {
+            { "DEPTH", GL_DEPTH_TEST },
+            { "CULL", GL_CULL_FACE },
+            { "ALPHA_SOURCE", GL_BLEND_SRC },
+            { "ALPHA_DEST", GL_BLEND_DST },
+            { "ALPHA", GL_BLEND },
+            { "BLEND_SOURCE", GL_BLEND_SRC },
+            { "BLEND_DEST", GL_BLEND_DST },
+            { "BLEND", GL_BLEND },
+            { "DITHER", GL_DITHER }
+        };
 
         for (auto& [func, par] : stateInput)
         {
@@ -136,21 +178,17 @@ namespace legion::rendering
             {
             case GL_DEPTH_TEST:
             {
-                static std::unordered_map<std::string, GLenum> params; // Initialize parameter lookup table.
-                static bool initialized = false;
-                if (!initialized)
-                {
-                    initialized = true;
-                    params["OFF"] = GL_FALSE;
-                    params["NEVER"] = GL_NEVER;
-                    params["LESS"] = GL_LESS;
-                    params["EQUAL"] = GL_EQUAL;
-                    params["LEQUAL"] = GL_LEQUAL;
-                    params["GREATER"] = GL_GREATER;
-                    params["NOTEQUAL"] = GL_NOTEQUAL;
-                    params["GEQUAL"] = GL_GEQUAL;
-                    params["ALWAYS"] = GL_ALWAYS;
-                }
+                static const std::unordered_map<std::string, GLenum> params = { // Initialize parameter lookup table.
+                    { "OFF", GL_FALSE },
+                    { "NEVER", GL_NEVER },
+                    { "LESS", GL_LESS },
+                    { "EQUAL", GL_EQUAL },
+                    { "LEQUAL", GL_LEQUAL },
+                    { "GREATER", GL_GREATER },
+                    { "NOTEQUAL", GL_NOTEQUAL },
+                    { "GEQUAL", GL_GEQUAL },
+                    { "ALWAYS", GL_ALWAYS }
+                };
 
                 if (!params.count(par))
                     continue;
@@ -160,16 +198,12 @@ namespace legion::rendering
             break;
             case GL_CULL_FACE:
             {
-                static std::unordered_map<std::string, GLenum> params; // Initialize parameter lookup table.
-                static bool initialized = false;
-                if (!initialized)
-                {
-                    initialized = true;
-                    params["FRONT"] = GL_FRONT;
-                    params["BACK"] = GL_BACK;
-                    params["FRONT_AND_BACK"] = GL_FRONT_AND_BACK;
-                    params["OFF"] = GL_FALSE;
-                }
+                static const std::unordered_map<std::string, GLenum> params = { // Initialize parameter lookup table.
+                    { "FRONT", GL_FRONT },
+                    { "BACK", GL_BACK },
+                    { "FRONT_AND_BACK", GL_FRONT_AND_BACK },
+                    { "OFF", GL_FALSE }
+                };
 
                 if (!params.count(par))
                     continue;
@@ -181,28 +215,24 @@ namespace legion::rendering
             case GL_BLEND_SRC:
             case GL_BLEND_DST:
             {
-                static std::unordered_map<std::string, GLenum> params; // Initialize parameter lookup table.
-                static bool initialized = false;
-                if (!initialized)
-                {
-                    initialized = true;
-                    params["ZERO"] = GL_ZERO;
-                    params["ONE"] = GL_ONE;
-                    params["SRC_COLOR"] = GL_SRC_COLOR;
-                    params["ONE_MINUS_SRC_COLOR"] = GL_ONE_MINUS_SRC_COLOR;
-                    params["DST_COLOR"] = GL_DST_COLOR;
-                    params["ONE_MINUS_DST_COLOR"] = GL_ONE_MINUS_DST_COLOR;
-                    params["SRC_ALPHA"] = GL_SRC_ALPHA;
-                    params["ONE_MINUS_SRC_ALPHA"] = GL_ONE_MINUS_SRC_ALPHA;
-                    params["DST_ALPHA"] = GL_DST_ALPHA;
-                    params["ONE_MINUS_DST_ALPHA"] = GL_ONE_MINUS_DST_ALPHA;
-                    params["CONSTANT_COLOR"] = GL_CONSTANT_COLOR;
-                    params["ONE_MINUS_CONSTANT_COLOR"] = GL_ONE_MINUS_CONSTANT_COLOR;
-                    params["CONSTANT_ALPHA"] = GL_CONSTANT_ALPHA;
-                    params["ONE_MINUS_CONSTANT_ALPHA"] = GL_ONE_MINUS_CONSTANT_ALPHA;
-                    params["SRC_ALPHA_SATURATE"] = GL_SRC_ALPHA_SATURATE;
-                    params["OFF"] = GL_FALSE;
-                }
+                static const std::unordered_map<std::string, GLenum> params = { // Initialize parameter lookup table.
+                    { "ZERO", GL_ZERO },
+                    { "ONE", GL_ONE },
+                    { "SRC_COLOR", GL_SRC_COLOR },
+                    { "ONE_MINUS_SRC_COLOR", GL_ONE_MINUS_SRC_COLOR },
+                    { "DST_COLOR", GL_DST_COLOR },
+                    { "ONE_MINUS_DST_COLOR", GL_ONE_MINUS_DST_COLOR },
+                    { "SRC_ALPHA", GL_SRC_ALPHA },
+                    { "ONE_MINUS_SRC_ALPHA", GL_ONE_MINUS_SRC_ALPHA },
+                    { "DST_ALPHA", GL_DST_ALPHA },
+                    { "ONE_MINUS_DST_ALPHA", GL_ONE_MINUS_DST_ALPHA },
+                    { "CONSTANT_COLOR", GL_CONSTANT_COLOR },
+                    { "ONE_MINUS_CONSTANT_COLOR", GL_ONE_MINUS_CONSTANT_COLOR },
+                    { "CONSTANT_ALPHA", GL_CONSTANT_ALPHA },
+                    { "ONE_MINUS_CONSTANT_ALPHA", GL_ONE_MINUS_CONSTANT_ALPHA },
+                    { "SRC_ALPHA_SATURATE", GL_SRC_ALPHA_SATURATE },
+                    { "OFF", GL_FALSE }
+                };
 
                 if (!params.count(par))
                     continue;
@@ -212,16 +242,12 @@ namespace legion::rendering
             break;
             case GL_DITHER:
             {
-                static std::unordered_map<std::string, GLenum> params; // Initialize parameter lookup table.
-                static bool initialized = false;
-                if (!initialized)
-                {
-                    initialized = true;
-                    params["OFF"] = GL_FALSE;
-                    params["ON"] = GL_TRUE;
-                    params["FALSE"] = GL_FALSE;
-                    params["TRUE"] = GL_TRUE;
-                }
+                static const std::unordered_map<std::string, GLenum> params = { // Initialize parameter lookup table.
+                    { "OFF", GL_FALSE },
+                    { "ON", GL_TRUE },
+                    { "FALSE", GL_FALSE },
+                    { "TRUE", GL_TRUE }
+                };
 
                 if (!params.count(par))
                     continue;
@@ -280,15 +306,37 @@ namespace legion::rendering
         return true;
     }
 
-    std::string ShaderCompiler::invoke_compiler(const fs::view& file, bitfield8 compilerSettings, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes)
+    uint64 ShaderCompiler::get_compiler_version()
+    {
+        //a rebuilt preprocessor can produce different output, so its size and write time are part of the cache key
+        static const uint64 version = []()
+        {
+            shader_source_hasher hasher;
+            for (auto& path : { get_compiler_path(), get_compiler_path() + ".exe" })
+            {
+                std::error_code error;
+                const auto size = std::filesystem::file_size(path, error);
+                if (error)
+                    continue;
+
+                const auto writeTime = std::filesystem::last_write_time(path, error);
+                if (error)
+                    continue;
+
+                hasher.add(static_cast<uint64>(size));
+                hasher.add(static_cast<uint64>(writeTime.time_since_epoch().count()));
+            }
+            return hasher.value();
+        }();
+
+        return version;
+    }
+
+    std::string ShaderCompiler::invoke_compiler(const std::string& filepath, bitfield8 compilerSettings, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes)
     {
         OPTICK_EVENT();
         using severity = log::severity;
 
-        std::string filepath = get_view_path(file, true);
-        if (filepath.empty())
-            return "";
-
         auto folderEnd = filepath.find_last_of("\\/");
         std::string folderPath(filepath.c_str(), folderEnd);
 
@@ -374,6 +422,117 @@ namespace legion::rendering
         }
     }
 
+    void ShaderCompiler::setCachePath(const std::string& path)
+    {
+        m_cachePath = path;
+    }
+
+    const std::string& ShaderCompiler::getCachePath()
+    {
+        return m_cachePath;
+    }
+
+    shader_cache_statistics ShaderCompiler::getCacheStatistics()
+    {
+        return { m_cacheHits.load(std::memory_order_relaxed), m_cacheMisses.load(std::memory_order_relaxed) };
+    }
+
+    std::string ShaderCompiler::resolvePath(const fs::view& file)
+    {
+        OPTICK_EVENT();
+        // The tool paths are resolved here as well so the jobs that use them only ever read them.
+        get_shaderlib_path();
+        get_compiler_path();
+        get_compiler_version();
+        return get_view_path(file, true);
+    }
+
+    byte_vec ShaderCompiler::serialize(const shader_ilo& ilo, const std::unordered_map<std::string, shader_state>& state)
+    {
+        byte_vec data;
+
+        std::string magic = "\xabLEGION SHADER\xbb\r\n\x13\n";
+        for (auto item : magic)
+            data.push_back(item);
+
+        std::vector<GLenum> rawState;
+        for (auto& [variant, variantState] : state)
+        {
+            GLenum stateType = 0;
+            appendBinaryData(&stateType, data);
+            appendBinaryData(&variant, data);
+            rawState.clear();
+            for (auto& [key, value] : variantState)
+            {
+                rawState.push_back(key);
+                rawState.push_back(value);
+            }
+            appendBinaryData(&rawState, data);
+        }
+
+        for (auto& [shaderVariant, variantSource] : ilo)
+            for (auto& [shaderType, source] : variantSource)
+            {
+                appendBinaryData(&shaderType, data);
+                appendBinaryData(&shaderVariant, data);
+                appendBinaryData(&source, data);
+            }
+
+        return data;
+    }
+
+    bool ShaderCompiler::deserialize(const byte_vec& data, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state)
+    {
+        if (data.size() <= 22)
+            return false;
+
+        std::string_view magic(reinterpret_cast<const char*>(data.data()), 19);
+        if (magic != "\xabLEGION SHADER\xbb\r\n\x13\n")
+            return false;
+
+        auto start = data.cbegin() + 19;
+        auto end = data.cend();
+
+        while (start != end)
+        {
+            GLenum shaderType;
+            retrieveBinaryData(shaderType, start);
+
+            std::string shaderVariant;
+            retrieveBinaryData(shaderVariant, start);
+
+            switch (shaderType)
+            {
+            case 0:
+            {
+                std::vector<GLenum> rawState;
+                retrieveBinaryData(rawState, start);
+                if (rawState.size() % 2 != 0)
+                    return false;
+
+                shader_state& variantState = state[shaderVariant];
+                for (int i = 0; i < rawState.size(); i += 2)
+                {
+                    variantState[rawState[i]] = rawState[i + 1];
+                }
+            }
+            break;
+            case GL_VERTEX_SHADER:
+            case GL_FRAGMENT_SHADER:
+            case GL_GEOMETRY_SHADER:
+            {
+                std::string source;
+                retrieveBinaryData(source, start);
+                ilo[shaderVariant].emplace_back(shaderType, source);
+            }
+            break;
+            default:
+                return false;
+            }
+        }
+        return true;
+    }
+
     bool ShaderCompiler::process(const fs::view& file, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state)
     {
         std::vector<std::string> temp;
@@ -389,15 +548,76 @@ namespace legion::rendering
     bool ShaderCompiler::process(const fs::view& file, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes)
     {
         OPTICK_EVENT();
-        using severity = log::severity;
-
         log::info("Compiling shader: {}", file.get_virtual_path());
 
-        auto result = invoke_compiler(file, compilerSettings, defines, additionalIncludes);
+        std::string filepath = resolvePath(file);
+        if (filepath.empty())
+            return false;
+
+        return processFile(filepath, compilerSettings, ilo, state, defines, additionalIncludes);
+    }
+
+    bool ShaderCompiler::processFile(const std::string& filepath, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes, bool* cacheHit)
+    {
+        OPTICK_EVENT();
+        if (cacheHit)
+            *cacheHit = false;
+
+        // Everything the output of the preprocessor depends on goes into the name of the cached file.
+        std::string cacheFile;
+        if (!m_cachePath.empty())
+        {
+            auto folderEnd = filepath.find_last_of("\\/");
+            std::vector<std::string> includeDirectories{ std::string(filepath.c_str(), folderEnd), get_shaderlib_path() };
+            includeDirectories.insert(includeDirectories.end(), additionalIncludes.begin(), additionalIncludes.end());
+
+            const uint64 settings = (get_compiler_version() * 0x00000100000001b3) ^ compilerSettings;
+            const uint64 key = shader_source_hash(filepath, includeDirectories, defines, settings, &readTextFile);
+
+            if (key)
+            {
+                std::ostringstream name;
+                name << m_cachePath << '/' << std::hex << std::setw(16) << std::setfill('0') << key << ".shcache";
+                cacheFile = name.str();
+
+                byte_vec data;
+                if (readBinaryFile(cacheFile, data) && deserialize(data, ilo, state) && !ilo.empty())
+                {
+                    m_cacheHits.fetch_add(1, std::memory_order_relaxed);
+                    if (cacheHit)
+                        *cacheHit = true;
+                    return true;
+                }
+
+                ilo.clear();
+                state.clear();
+            }
+        }
+
+        m_cacheMisses.fetch_add(1, std::memory_order_relaxed);
 
+        auto result = invoke_compiler(filepath, compilerSettings, defines, additionalIncludes);
         if (result.empty())
             return false;
 
+        if (!parse_output(result, ilo, state))
+            return false;
+
+        if (!cacheFile.empty())
+        {
+            std::error_code error;
+            std::filesystem::create_directories(m_cachePath, error);
+            writeBinaryFile(cacheFile, serialize(ilo, state));
+        }
+
+        return true;
+    }
+
+    bool ShaderCompiler::parse_output(const std::string& result, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state)
+    {
+        OPTICK_EVENT();
+        using severity = log::severity;
+
         auto start = result.find("=========== BEGIN SHADER CODE ===========\n") + 42;
         start = result.find_first_not_of('\n', start);
         auto end = result.find("============ END SHADER CODE ============");
@@ -2,12 +2,26 @@
 #include <rendering/data/shader.hpp>
 #include <core/core.hpp>
 
+#include <atomic>
+
 namespace legion::rendering
 {
+    /**@struct shader_cache_statistics
+     * @brief How many shaders were loaded from the shader cache and how many had to be preprocessed.
+     */
+    struct shader_cache_statistics
+    {
+        size_type hits;
+        size_type misses;
+    };
+
     class ShaderCompiler
     {
     private:
         static delegate<void(const std::string&, log::severity)> m_callback;
+        static std::string m_cachePath;
+        static std::atomic<size_type> m_cacheHits;
+        static std::atomic<size_type> m_cacheMisses;
 
         static std::string get_view_path(const fs::view& view, bool mustBeFile = false);
         static const std::string& get_shaderlib_path();
@@ -16,7 +30,9 @@ namespace legion::rendering
 
         static void extract_state(std::string_view source, shader_state& state);
         static bool extract_ilo(const std::string& variant, std::string_view source, uint64 shaderType, shader_ilo& ilo);
-        static std::string invoke_compiler(const fs::view& file, bitfield8 compilerSettings, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes);
+        static uint64 get_compiler_version();
+        static std::string invoke_compiler(const std::string& filepath, bitfield8 compilerSettings, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes);
+        static bool parse_output(const std::string& result, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state);
 
     public:
         template<class owner_type, void(owner_type::* func_type)(const std::string&, log::severity)>
@@ -50,8 +66,36 @@ namespace legion::rendering
 
         static void cleanCache();
 
+        /**@brief Sets the directory preprocessed shaders are cached in, an empty path disables the cache.
+         *        Cached shaders are named after a hash of their source, the files they include, the defines and the compiler settings, so they never go stale.
+         */
+        static void setCachePath(const std::string& path);
+        L_NODISCARD static const std::string& getCachePath();
+
+        L_NODISCARD static shader_cache_statistics getCacheStatistics();
+
+        /**@brief Resolves a view to the path on disk processFile needs.
+         * @note Not thread safe, resolve on the thread that owns the filesystem and hand the path to the jobs.
+         */
+        L_NODISCARD static std::string resolvePath(const fs::view& file);
+
+        /**@brief Serializes preprocessed shaders into the format of precompiled shader files.
+         */
+        L_NODISCARD static byte_vec serialize(const shader_ilo& ilo, const std::unordered_map<std::string, shader_state>& state);
+
+        /**@brief Reads preprocessed shaders from the format of precompiled shader files.
+         * @return False if the data isn't a valid precompiled shader.
+         */
+        static bool deserialize(const byte_vec& data, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state);
+
         static bool process(const fs::view& file, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state);
         static bool process(const fs::view& file, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state, const std::vector<std::string>& defines);
         static bool process(const fs::view& file, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes);
+
+        /**@brief Preprocesses a shader from a resolved path, loads it from the shader cache if it was preprocessed before with the same inputs.
+         *        Safe to call from multiple threads at once.
+         * @param cacheHit Optional output of whether the shader came from the cache.
+         */
+        static bool processFile(const std::string& filepath, bitfield8 compilerSettings, shader_ilo& ilo, std::unordered_map<std::string, shader_state>& state, const std::vector<std::string>& defines, const std::vector<std::string>& additionalIncludes = {}, bool* cacheHit = nullptr);
     };
 }
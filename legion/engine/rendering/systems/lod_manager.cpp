@@ -0,0 +1,100 @@
+#include <rendering/systems/lod_manager.hpp>
+
+namespace legion::rendering
+{
+    async::spinlock LODManager::m_viewLock;
+    lod_view LODManager::m_view;
+    bool LODManager::m_hasView = false;
+    float LODManager::hysteresis = 0.15f;
+
+    void LODManager::setView(const lod_view& view)
+    {
+        std::lock_guard guard(m_viewLock);
+        m_view = view;
+        m_hasView = true;
+    }
+
+    bool LODManager::getView(lod_view& view)
+    {
+        {
+            std::lock_guard guard(m_viewLock);
+            if (m_hasView)
+            {
+                view = m_view;
+                return true;
+            }
+        }
+
+        m_camQuery.queryEntities();
+        for (ecs::entity_handle entity : m_camQuery)
+        {
+            auto positionHandle = entity.get_component_handle<position>();
+            if (!positionHandle)
+                continue;
+
+            view = lod_view::from_fov(positionHandle.read(), entity.get_component_handle<camera>().read().fov);
+            return true;
+        }
+        return false;
+    }
+
+    void LODManager::setup()
+    {
+        createProcess<&LODManager::update>("Update");
+    }
+
+    void LODManager::update(time::span deltaTime)
+    {
+        OPTICK_EVENT();
+        (void)deltaTime;
+
+        lod_view view;
+        if (!getView(view))
+            return;
+
+        m_query.queryEntities();
+        const size_type count = m_query.size();
+        if (count == 0)
+            return;
+
+        auto& positions = m_query.get<position>();
+        auto& scales = m_query.get<scale>();
+        auto& lods = m_query.get<lod>();
+
+        m_levels.resize(count);
+
+        {
+            OPTICK_EVENT("Select levels");
+            const float levelHysteresis = hysteresis;
+            async::for_each_range(*m_scheduler, count, m_entitiesPerJob, [&](size_type start, size_type end) {
+                for (size_type i = start; i < end; i++)
+                {
+                    const lod& lodComponent = lods[i];
+                    m_levels[i] = lodComponent.Level;
+
+                    //the bounds grow with the largest axis of the scale so they still contain the object when it is scaled unevenly
+                    const math::vec3& scl = scales[i];
+                    const float radius = lodComponent.radius * math::max(math::abs(scl.x), math::max(math::abs(scl.y), math::abs(scl.z)));
+                    const math::vec3& center = positions[i];
+
+                    if (view.cull && !view.frustum.intersects_sphere(center, radius))
+                        continue;
+
+                    m_levels[i] = select_lod_level(lodComponent.Level, lodComponent.MaxLod, lod_screen_size(center, radius, view), lodComponent.minScreenSize, levelHysteresis);
+                }
+                });
+        }
+
+        {
+            OPTICK_EVENT("Write changed levels");
+            for (size_type i = 0; i < count; i++)
+            {
+                if (m_levels[i] == lods[i].Level)
+                    continue;
+
+                const int level = m_levels[i];
+                m_query[i].get_component_handle<lod>().read_modify_write([level](lod& value) { value.Level = level; });
+            }
+        }
+    }
+}
@@ -1,94 +1,49 @@
 #pragma once
 #include <core/core.hpp>
-#include<rendering/components/lod.hpp>
-#include<rendering/components/camera.hpp>
-#include<math.h>
+#include <rendering/components/lod.hpp>
+#include <rendering/components/camera.hpp>
+#include <rendering/util/lod_selection.hpp>
+
 namespace legion::rendering
 {
     /**@class LODManager
-     * @brief system that updates the LOD component
+     * @brief System that selects the level of every LOD component from the screen-space size of its bounds.
+     *        The selection is done in parallel on the job system, only the levels that changed are written back.
      */
     class LODManager : public System<LODManager>
     {
-        void setup()
-        {
-            createProcess<&LODManager::update>("Update");
-        }
-        /** @brief Update queries all entities with LOD components, caclulates their distance and updates the LOD
-          */
-        void update(time::span deltaTime)
-        {
-            //update camera position first
-            UpdateCam();
+        static async::spinlock m_viewLock;
+        static lod_view m_view;
+        static bool m_hasView;
 
-            //iterate all entities with an LOD
-            m_query.queryEntities();
-            for (ecs::entity_handle entity : m_query)
-            {
-                //get distance for current entity
-                float distance = CalculateDistance(entity.get_component_handle<position>());
-                //read the LOD
-                auto currentLOD = entity.get_component_handle<lod>().read();
-                //make sure it is initialized
-                if (!currentLOD.isInitialized) UpdateThresholdLinear(currentLOD);
-                //update LOD with calculated distance
-                UpdateLOD(currentLOD, distance);
-                //write any LOD changes
-                entity.get_component_handle<lod>().write(currentLOD);
-            }
-        }
+        //level selected for each queried entity, kept between frames
+        std::vector<int> m_levels;
 
-    private:
-        //checks if current distance should display a different LOD than the current LOD
-        void UpdateLOD(lod& lodComponent, float distance)
-        {
-            int currentLevel = 0;
-            for (float threshold : lodComponent.m_thresholdLevels)
-            {
-                if (threshold > distance)
-                {
-                    lodComponent.Level = currentLevel;
-                    return;
-                }
-                currentLevel++;
-            }
-        }
-        //based on the max lod level and the max lod distance calculate the stepping points to update the LOD
-        void UpdateThresholdLinear(lod& lodComponent)
-        {
-            float distance = lodComponent.m_maxDistance / (float)lodComponent.MaxLod;
-            float currentDist = distance;
-            lodComponent.m_thresholdLevels = std::vector<float>(lodComponent.MaxLod);
-            for (size_t i = 0; i < lodComponent.MaxLod; i++)
-            {
-                lodComponent.m_thresholdLevels.at(i) = currentDist;
-                currentDist += distance;
-            }
-            lodComponent.isInitialized = true;
-        }
+        static constexpr size_type m_entitiesPerJob = 256;
 
-        //updates camera posiiton
-        void UpdateCam()
-        {
-            m_CamQuery.queryEntities();
-            for (ecs::entity_handle entity : m_CamQuery)
-            {
-                if (entity.has_component<position>())
-                {
-                    m_camPosition = entity.get_component_handle<position>().read();
-                }
-            }
-        }
-        //calculates distince between cam and input positon
-        float CalculateDistance(ecs::component_handle<position> pos)
-        {
-            return math::distance(pos.read(), m_camPosition);
-        }
-        math::vec3 m_camPosition;
         //query for the lod components
-        ecs::EntityQuery m_query = createQuery<transform, lod>();
-        //query for the cam
-        ecs::EntityQuery m_CamQuery = createQuery<camera>();
+        ecs::EntityQuery m_query = createQuery<position, scale, lod>();
+        //query for the cam, only used until the renderer provided a view
+        ecs::EntityQuery m_camQuery = createQuery<camera>();
+
+        /**@brief The view the renderer last rendered, or the first camera with its fov and without culling if nothing was rendered yet.
+         */
+        bool getView(lod_view& view);
+
+    public:
+        /**@brief Fraction of a level an object needs to move past the boundary of its level before the level changes.
+         */
+        static float hysteresis;
+
+        /**@brief Sets the camera the levels are selected for, the renderer calls this with the main camera every frame.
+         *        Objects outside its frustum keep their level, so the culling of the renderer also saves the LOD work of those objects.
+         */
+        static void setView(const lod_view& view);
+
+        void setup();
 
+        /**@brief Selects the levels of all entities with an LOD component for the current view.
+         */
+        void update(time::span deltaTime);
     };
 }
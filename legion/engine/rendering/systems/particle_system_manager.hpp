@@ -1,6 +1,7 @@
 #pragma once
 #include <core/core.hpp>
 #include <rendering/data/particle_system_base.hpp>
+#include <rendering/data/particle_pool_cache.hpp>
 #include <rendering/components/point_emitter_data.hpp>
 namespace legion::rendering
 {
@@ -10,11 +11,17 @@ namespace legion::rendering
      */
     class ParticleSystemManager : public System<ParticleSystemManager>
     {
+        //emitters that are updated this frame, with their pool and particle system
+        std::vector<particle_pool*> m_pools;
+        std::vector<ecs::component_handle<particle_emitter>> m_emitterHandles;
+        std::vector<const ParticleSystemBase*> m_particleSystems;
+        //scratch memory of simulate_particles
+        std::vector<size_type> m_firstJobs;
+
+        std::vector<math::color> m_colors;
+        size_type m_colorVersion = 0;
+
     public:
-        ParticleSystemManager()
-        {
-            ParticleSystemBase::m_registry = m_ecs;
-        }
         /**
          * @brief Sets up the particle system manager.
          */
@@ -23,7 +30,7 @@ namespace legion::rendering
             createProcess<&ParticleSystemManager::update>("Update");
         }
         /**
-         * @brief Every frame, goes through every emitter and updates their particles with their respective particle systems.
+         * @brief Every frame, simulates the particle pools of all emitters in parallel and then updates them with their respective particle systems.
          * @param deltaTime The delta time to be used inside of the update.
          */
         void update(time::span deltaTime)
@@ -31,59 +38,101 @@ namespace legion::rendering
             OPTICK_EVENT();
             static auto emitters = createQuery<particle_emitter>();
             emitters.queryEntities();
+
+            m_pools.clear();
+            m_emitterHandles.clear();
+            m_particleSystems.clear();
+
             for (auto entity : emitters)
             {
-                //Gets emitter handle and emitter.
+                //Gets emitter handle and emitter, the emitter only holds handles so reading it is cheap.
                 auto emitterHandle = entity.get_component_handle<particle_emitter>();
                 auto emit = emitterHandle.read();
+
+                const ParticleSystemBase* particleSystem = emit.particleSystemHandle.get();
+                if (!particleSystem)
+                    continue;
+
                 //Checks if emitter was already initialized.
                 if (!emit.setupCompleted)
                 {
-                    //If NOT then it goes through the particle system setup.
+                    //If NOT then it gets a pool if it doesn't have one yet and goes through the particle system setup.
                     emit.setupCompleted = true;
+                    if (!emit.pool.validate())
+                        emit.pool = ParticlePoolCache::createPool(math::max(particleSystem->m_maxParticles, 1u));
                     emitterHandle.write(emit);
 
-                    const ParticleSystemBase* particleSystem = emit.particleSystemHandle.get();
-                    particleSystem->setup(emitterHandle);
+                    particle_pool* pool = emit.pool.get();
+                    pool->set_appearance(particleSystem->m_particleMaterial.id, particleSystem->m_particleModel.id, particleSystem->m_startingSize);
+
+                    async::readwrite_guard guard(pool->get_lock());
+                    particleSystem->setup(emitterHandle, *pool);
                 }
-                else
+                else if (particle_pool* pool = emit.pool.get())
                 {
-                    //If it IS then it runs the emitter through the particle system update.
-                    const ParticleSystemBase* particleSystem = emit.particleSystemHandle.get();
-                    particleSystem->update(emit.livingParticles, emitterHandle, emitters, deltaTime);
+                    //If it IS then it gets simulated and run through the particle system update.
+                    m_pools.push_back(pool);
+                    m_emitterHandles.push_back(emitterHandle);
+                    m_particleSystems.push_back(particleSystem);
                 }
             }
 
+            //the renderer reads the pools while it batches, so they are locked for the rest of the update
+            for (auto* pool : m_pools)
+                pool->get_lock().lock();
+
+            simulate_particles(m_pools.data(), m_pools.size(), deltaTime.seconds(), m_firstJobs, async::job_runner(*m_scheduler));
+
+            for (size_type i = 0; i < m_pools.size(); i++)
+                m_particleSystems[i]->update(*m_pools[i], m_emitterHandles[i], emitters, deltaTime);
 
+            for (auto* pool : m_pools)
+                pool->get_lock().unlock();
 
             //update point cloud buffer data
             static auto pointCloudQuery = createQuery<particle_emitter, rendering::point_emitter_data>();
             pointCloudQuery.queryEntities();
-            std::vector<math::vec4> colorData;
-            int index = 0;
+
+            //the colors only need to be uploaded again when particles were spawned or killed
+            size_type colorVersion = 0;
+            size_type colorCount = 0;
+            const ParticleSystemBase* lastParticleSystem = nullptr;
             for (auto pointEntities : pointCloudQuery)
             {
-                auto emitterHandle = pointEntities.get_component_handle<particle_emitter>();
-                auto emitter = emitterHandle.read();
-                const ParticleSystemBase* particleSystem = emitter.particleSystemHandle.get();
+                auto emitter = pointEntities.get_component_handle<particle_emitter>().read();
+                particle_pool* pool = emitter.pool.get();
+                if (!pool || !emitter.particleSystemHandle.get())
+                    continue;
 
-                auto dataHandle = pointEntities.get_component_handle<rendering::point_emitter_data>();
-                auto data = dataHandle.read();
+                colorVersion += pool->version();
+                colorCount += pool->alive_count();
+                lastParticleSystem = emitter.particleSystemHandle.get();
+            }
 
-                index++;
-                if (index == pointCloudQuery.size())
-                {
-                    auto window = ecs::EcsRegistry::world.read_component<app::window>();
-                    app::context_guard guard(window);
-                    if (guard.contextIsValid())
-                    {
-                        ////create buffer
-                        rendering::buffer colorBuffer = rendering::buffer(GL_ARRAY_BUFFER, emitter.container->colorBufferData, GL_STREAM_DRAW);
-                        particleSystem->m_particleModel.overwrite_buffer(colorBuffer, SV_COLOR, true);
-                        log::debug(std::to_string(emitter.container->colorBufferData.size()));
-
-                    }
-                }
+            if (!lastParticleSystem || colorVersion == m_colorVersion)
+                return;
+
+            m_colors.resize(colorCount);
+            size_type written = 0;
+            for (auto pointEntities : pointCloudQuery)
+            {
+                particle_pool* pool = pointEntities.get_component_handle<particle_emitter>().read().pool.get();
+                if (!pool)
+                    continue;
+
+                async::readonly_guard guard(pool->get_lock());
+                written += pool->write_instances(nullptr, m_colors.data() + written, colorCount - written);
+            }
+            m_colors.resize(written);
+
+            auto window = ecs::EcsRegistry::world.read_component<app::window>();
+            app::context_guard guard(window);
+            if (guard.contextIsValid())
+            {
+                ////create buffer
+                rendering::buffer colorBuffer = rendering::buffer(GL_ARRAY_BUFFER, m_colors, GL_STREAM_DRAW);
+                lastParticleSystem->m_particleModel.overwrite_buffer(colorBuffer, SV_COLOR, true);
+                m_colorVersion = colorVersion;
             }
         }
     };
@@ -11,6 +11,8 @@
 #include <rendering/components/point_cloud.hpp>
 #include <rendering/components/particle_emitter.hpp>
 #include <rendering/components/lod.hpp>
+#include <rendering/util/point_cloud_sampler.hpp>
+#include <rendering/util/point_cloud_cache.hpp>
 using namespace legion;
 
 
@@ -19,6 +21,7 @@ namespace legion::rendering
 
     /**@class PointCloudGeneration
      * @brief A system that iterates all queried entities containing point_cloud and generates a particle system for them.
+     *        Points are sampled with OpenCL when there is a device, otherwise on the job workers, and cached on disk by PointCloudCache.
      */
     class PointCloudGeneration : public System<PointCloudGeneration>
     {
@@ -67,10 +70,15 @@ namespace legion::rendering
                 GeneratePointCloud(ent.get_component_handle<point_cloud>());
             }
         }
+        //the kernels are only used when there is an OpenCL device to run them on
+        bool HasComputeDevice() const
+        {
+            return compute::Context::initialized() && pointCloudGeneratorCS.isValid() && preProcessPointCloudCS.isValid();
+        }
+
         //generates point clouds
         void GeneratePointCloud(ecs::component_handle<point_cloud> pointCloud)
         {
-            using compute::in, compute::out, compute::karg;
             auto realPointCloud = pointCloud.read();
 
             //exit early if point cloud has already been generated
@@ -83,15 +91,78 @@ namespace legion::rendering
             auto indices = m.second.indices;
             auto uvs = m.second.uvs;
             uint triangle_count = indices.size() / 3;
+            if (triangle_count == 0)
+            {
+                log::warn("Point cloud mesh has no triangles, nothing to generate");
+                realPointCloud.m_hasBeenGenerated = true;
+                pointCloud.write(realPointCloud);
+                return;
+            }
+
+            point_cloud_sample_settings settings
+            {
+                realPointCloud.m_maxPoints / triangle_count,
+                realPointCloud.m_heightStrength,
+                static_cast<uint>(realPointCloud.m_AlbedoMap.size().x)
+            };
+
+            uint64 cacheKey;
+            {
+                auto [lock, height] = realPointCloud.m_heightMap.get_raw_image();
+                auto [lock2, albedo] = realPointCloud.m_AlbedoMap.get_raw_image();
+                async::readonly_multiguard guard(lock, lock2);
+                cacheKey = PointCloudCache::key(vertices, indices, uvs, albedo, height, settings);
+            }
+
+            //sample the point cloud if it wasn't generated with the same mesh, textures and settings before
+            point_cloud_samples samples;
+            if (!PointCloudCache::load(cacheKey, samples))
+            {
+                if (HasComputeDevice())
+                    GenerateOnDevice(realPointCloud, vertices, indices, uvs, settings, samples);
+                else
+                    GenerateOnHost(realPointCloud, vertices, indices, uvs, settings, samples);
+
+                PointCloudCache::store(cacheKey, samples);
+            }
+            log::debug(samples.points.size());
+
+            //translate vec4 into vec3
+            const size_type totalSampleCount = samples.points.size();
+            std::vector<math::vec3> particleInput(totalSampleCount);
+            for (size_t i = 0; i < totalSampleCount; i++)
+            {
+                particleInput.at(i) = samples.points.at(i).xyz() + posiitonOffset;
+            }
+            //generate particle params
+            pointCloudParameters params
+            {
+               math::vec3(realPointCloud.m_pointRadius),
+               realPointCloud.m_Material,
+               ModelCache::get_handle("billboard")
+            };
+            GenerateParticles(params, particleInput, samples.colors, realPointCloud.m_trans);
+
+
+            //write that pc has been generated
+            realPointCloud.m_hasBeenGenerated = true;
+            pointCloud.write(realPointCloud);
+        }
+
+        //samples the point cloud with the OpenCL kernels
+        void GenerateOnDevice(point_cloud& realPointCloud, const std::vector<math::vec3>& vertices, const std::vector<uint>& indices, const std::vector<math::vec2>& uvs, const point_cloud_sample_settings& settings, point_cloud_samples& samples)
+        {
+            OPTICK_EVENT();
+            using compute::in, compute::out, compute::karg;
+            uint triangle_count = indices.size() / 3;
             //compute process size
             uint process_Size = triangle_count;
 
             //generate initial buffers from triangle info
-            std::vector<uint> samplesPerTri(triangle_count);
             auto vertexBuffer = compute::Context::createBuffer(vertices, compute::buffer_type::READ_BUFFER, "vertices");
             auto indexBuffer = compute::Context::createBuffer(indices, compute::buffer_type::READ_BUFFER, "indices");
             uint totalSampleCount = 0;
-            uint samplesPerTriangle = realPointCloud.m_maxPoints / triangle_count;
+            uint samplesPerTriangle = settings.samplesPerTriangle;
 
 
 
@@ -113,15 +184,14 @@ namespace legion::rendering
             {
                 totalSampleCount += output.at(i);
             }
-            log::debug(totalSampleCount);
 
 
 
 
             ///Generate Point cloud
             //Generate points result vector
-            std::vector<math::vec4> result(totalSampleCount);
-            std::vector<math::vec4> resultColor(totalSampleCount);
+            samples.points.resize(totalSampleCount);
+            samples.colors.resize(totalSampleCount);
             //Get normal map
             auto [lock, normal] = realPointCloud.m_heightMap.get_raw_image();
             {
@@ -138,10 +208,11 @@ namespace legion::rendering
                     auto sampleBuffer = compute::Context::createBuffer(output, compute::buffer_type::READ_BUFFER, "samples");
                     auto uvBuffer = compute::Context::createBuffer(uvs, compute::buffer_type::READ_BUFFER, "uvs");
 
-                    auto outBuffer = compute::Context::createBuffer(result, compute::buffer_type::WRITE_BUFFER, "points");
-                    auto colorBuffer = compute::Context::createBuffer(resultColor, compute::buffer_type::WRITE_BUFFER, "colors");
+                    auto outBuffer = compute::Context::createBuffer(samples.points, compute::buffer_type::WRITE_BUFFER, "points");
+                    auto colorBuffer = compute::Context::createBuffer(samples.colors, compute::buffer_type::WRITE_BUFFER, "colors");
 
-                    uint size = realPointCloud.m_AlbedoMap.size().x;
+                    uint size = settings.textureSize;
+                    float heightStrength = settings.heightStrength;
                     auto computeResult = pointCloudGeneratorCS
                     (
                         process_Size,
@@ -151,32 +222,24 @@ namespace legion::rendering
                         sampleBuffer,
                         albedoMapBuffer,
                         normalMapBuffer,
-                        karg(realPointCloud.m_heightStrength, "normalStrength"),
+                        karg(heightStrength, "normalStrength"),
                         karg(size, "textureSize"),
                         outBuffer,
                         colorBuffer
                     );
                 }
             }
-            //translate vec4 into vec3
-            std::vector<math::vec3> particleInput(totalSampleCount);
-            for (size_t i = 0; i < totalSampleCount; i++)
-            {
-                particleInput.at(i) = result.at(i).xyz() + posiitonOffset;
-            }
-            //generate particle params
-            pointCloudParameters params
-            {
-               math::vec3(realPointCloud.m_pointRadius),
-               realPointCloud.m_Material,
-               ModelCache::get_handle("billboard")
-            };
-            GenerateParticles(params, particleInput, resultColor, realPointCloud.m_trans);
+        }
 
+        //samples the point cloud on the job workers, gives the same points as the kernels
+        void GenerateOnHost(point_cloud& realPointCloud, const std::vector<math::vec3>& vertices, const std::vector<uint>& indices, const std::vector<math::vec2>& uvs, const point_cloud_sample_settings& settings, point_cloud_samples& samples)
+        {
+            OPTICK_EVENT();
+            //read_colors locks the images itself
+            const point_cloud_texture albedo{ realPointCloud.m_AlbedoMap.read_colors().data(), realPointCloud.m_AlbedoMap.size() };
+            const point_cloud_texture height{ realPointCloud.m_heightMap.read_colors().data(), realPointCloud.m_heightMap.size() };
 
-            //write that pc has been generated
-            realPointCloud.m_hasBeenGenerated = true;
-            pointCloud.write(realPointCloud);
+            sample_point_cloud(vertices, indices, uvs, albedo, height, settings, samples, async::job_runner(*m_scheduler));
         }
 
         void GenerateParticles(pointCloudParameters params, std::vector<math::vec3> input, std::vector<math::vec4> inputColor, transform trans)
@@ -193,11 +256,16 @@ namespace legion::rendering
             //  newEnt.add_component <rendering::lod>();
             newEnt.add_components<transform>(trans.get<position>().read(), trans.get<rotation>().read(), trans.get<scale>().read());
 
+            //the points are handed to the particle system through the pool of the emitter, the particle system sorts them by level of detail during its setup
+            auto pool = ParticlePoolCache::createPool(input.size());
+            particle_pool* points = pool.get();
+            for (size_t i = 0; i < input.size(); i++)
+                points->spawn(input[i], math::vec3(0.f), math::color(inputColor.at(i)), std::numeric_limits<float>::infinity());
+
             auto emitterHandle = newEnt.add_component<rendering::particle_emitter>();
             auto emitter = emitterHandle.read();
             emitter.particleSystemHandle = newPointCloud;
-            emitter.pointInput = input;
-            emitter.colorInput = inputColor;
+            emitter.pool = pool;
             newEnt.get_component_handle<rendering::particle_emitter>().write(emitter);
             //newPointCloud.get()->setup(emitterHandle, input, inputColor);
 
@@ -0,0 +1,142 @@
+#include <rendering/systems/render_extraction.hpp>
+
+namespace legion::rendering
+{
+    async::snapshot_buffer<render_snapshot> RenderExtraction::m_snapshots;
+    RenderExtraction* RenderExtraction::m_instance = nullptr;
+
+    RenderExtraction::~RenderExtraction()
+    {
+        scheduling::ProcessChain::unsubscribeFromChainEnd<&RenderExtraction::onChainEnd>();
+        if (m_instance == this)
+            m_instance = nullptr;
+    }
+
+    void RenderExtraction::setup()
+    {
+        m_instance = this;
+        scheduling::ProcessChain::subscribeToChainEnd<&RenderExtraction::onChainEnd>();
+    }
+
+    void RenderExtraction::onChainEnd()
+    {
+        //the chain end callbacks are called for every chain, only the end of the simulation frame is extracted
+        static const id_type updateChainId = nameHash("Update");
+        scheduling::ProcessChain* chain = scheduling::ProcessChain::current();
+        if (!m_instance || !chain || chain->id() != updateChainId)
+            return;
+
+        m_instance->extract();
+    }
+
+    void RenderExtraction::extract()
+    {
+        OPTICK_EVENT();
+        render_snapshot& snapshot = m_snapshots.write_buffer();
+        snapshot.clear();
+        snapshot.frame = m_frame++;
+
+        {
+            OPTICK_EVENT("Extract cameras");
+            static auto cameraQuery = createQuery<camera>();
+            cameraQuery.queryEntities();
+            for (auto ent : cameraQuery)
+            {
+                snapshot.cameras.push_back({
+                    ent.get_component_handle<camera>().read(),
+                    ent.get_component_handle<position>().read(),
+                    ent.get_component_handle<rotation>().read(),
+                    ent.get_component_handle<scale>().read() });
+            }
+        }
+
+        {
+            OPTICK_EVENT("Extract renderables");
+            static auto renderablesQuery = createQuery<position, rotation, scale, mesh_filter, mesh_renderer>();
+            renderablesQuery.queryEntities();
+
+            auto& positions = renderablesQuery.get<position>();
+            auto& rotations = renderablesQuery.get<rotation>();
+            auto& scales = renderablesQuery.get<scale>();
+            auto& filters = renderablesQuery.get<mesh_filter>();
+            auto& renderers = renderablesQuery.get<mesh_renderer>();
+
+            const size_type count = renderablesQuery.size();
+            snapshot.worldMatrices.resize(count);
+            snapshot.materials.resize(count);
+            snapshot.models.resize(count);
+
+            const time64 frameTime = transform_interpolation::currentTime();
+
+            async::for_each_range(*m_scheduler, count, m_renderablesPerJob, [&](size_type start, size_type end)
+                {
+                    for (size_type i = start; i < end; i++)
+                    {
+                        //entities that are moved in fixed steps are drawn between their last 2 steps
+                        auto interpolationHandle = renderablesQuery[i].get_component_handle<transform_interpolation>();
+                        if (interpolationHandle)
+                            snapshot.worldMatrices[i] = interpolationHandle.read().interpolate(frameTime, positions[i], rotations[i], scales[i]);
+                        else
+                            snapshot.worldMatrices[i] = math::compose(scales[i], rotations[i], positions[i]);
+
+                        snapshot.materials[i] = renderers[i].material.id;
+                        snapshot.models[i] = filters[i].id;
+                    }
+                });
+        }
+
+        {
+            OPTICK_EVENT("Extract occluders");
+            static auto occludersQuery = createQuery<position, rotation, scale, occluder>();
+            occludersQuery.queryEntities();
+
+            const time64 frameTime = transform_interpolation::currentTime();
+            for (auto ent : occludersQuery)
+            {
+                mesh_handle mesh = ent.read_component<occluder>().mesh;
+                if (mesh == invalid_mesh_handle)
+                {
+                    auto filterHandle = ent.get_component_handle<mesh_filter>();
+                    if (!filterHandle)
+                        continue;
+                    mesh = filterHandle.read();
+                }
+
+                //interpolated like the renderables, so moving occluders don't hide renderables they are not in front of anymore
+                const position pos = ent.read_component<position>();
+                const rotation rot = ent.read_component<rotation>();
+                const scale scl = ent.read_component<scale>();
+                auto interpolationHandle = ent.get_component_handle<transform_interpolation>();
+                if (interpolationHandle)
+                    snapshot.occluderMatrices.push_back(interpolationHandle.read().interpolate(frameTime, pos, rot, scl));
+                else
+                    snapshot.occluderMatrices.push_back(math::compose(scl, rot, pos));
+                snapshot.occluderMeshes.push_back(mesh.id);
+            }
+        }
+
+        {
+            OPTICK_EVENT("Extract lights");
+            static auto lightsQuery = createQuery<light>();
+            lightsQuery.queryEntities();
+            for (auto ent : lightsQuery)
+            {
+                light lght = ent.read_component<light>();
+                snapshot.lights.push_back(lght.get_light_data(ent.get_component_handle<position>(), ent.get_component_handle<rotation>()));
+            }
+        }
+
+        m_snapshots.publish();
+    }
+
+    const render_snapshot& RenderExtraction::acquireSnapshot()
+    {
+        m_snapshots.acquire();
+        return m_snapshots.read_buffer();
+    }
+
+    const render_snapshot& RenderExtraction::currentSnapshot()
+    {
+        return m_snapshots.read_buffer();
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/components/renderable.hpp>
+#include <rendering/components/occluder.hpp>
+#include <rendering/data/render_snapshot.hpp>
+
+namespace legion::rendering
+{
+    /**@class RenderExtraction
+     * @brief Copies everything the renderer needs out of the ECS into a render snapshot at the end of every iteration of the "Update" chain.
+     *        The render thread picks up the newest snapshot at the start of its frame instead of querying the ECS,
+     *        so rendering one frame overlaps with simulating the next without either of them waiting on the locks of the other.
+     */
+    class RenderExtraction final : public System<RenderExtraction>
+    {
+        static async::snapshot_buffer<render_snapshot> m_snapshots;
+        static RenderExtraction* m_instance;
+
+        size_type m_frame = 0;
+
+        static constexpr size_type m_renderablesPerJob = 256;
+
+        /**@brief Chain end callback, extracts a snapshot when the chain that ended is the "Update" chain.
+         */
+        static void onChainEnd();
+
+        void extract();
+
+    public:
+        ~RenderExtraction();
+
+        virtual void setup();
+
+        /**@brief Makes the newest extracted snapshot the current one, if there is a new one. Only call from the render thread.
+         * @return The current snapshot.
+         */
+        static const render_snapshot& acquireSnapshot();
+
+        /**@brief The snapshot the render thread is currently rendering, only call from the render thread.
+         */
+        static const render_snapshot& currentSnapshot();
+    };
+}
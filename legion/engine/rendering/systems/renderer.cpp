@@ -1,11 +1,13 @@
 #include <rendering/systems/renderer.hpp>
 #include <rendering/debugrendering.hpp>
+#include <rendering/systems/lod_manager.hpp>
 #include <Optick/optick.h>
 
 namespace legion::rendering
 {
     delegate<RenderPipelineBase* (app::window&)> Renderer::m_pipelineProvider;
     RenderPipelineBase* Renderer::m_currentPipeline;
+    debug_line_frame Renderer::m_debugLines;
 
     void Renderer::debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, L_MAYBEUNUSED const void* userParam)
     {
@@ -315,6 +317,29 @@ namespace legion::rendering
 
         bindToEvent<events::exit, &Renderer::onExit>();
 
+        //the shaders of the default pipeline get preprocessed on the job system while the rest of the engine initializes, the pipeline picks them up when it creates them
+        ShaderCache::scheduler = m_scheduler;
+        ShaderCache::preprocess_shaders({
+            fs::view("engine://shaders/invalid.shs"),
+            fs::view("engine://shaders/default_lit.shs"),
+            fs::view("engine://shaders/screenshader.shs"),
+            fs::view("engine://shaders/aces.shs"),
+            fs::view("engine://shaders/reinhard.shs"),
+            fs::view("engine://shaders/reinhardjodie.shs"),
+            fs::view("engine://shaders/legiontonemap.shs"),
+            fs::view("engine://shaders/unreal3.shs"),
+            fs::view("engine://shaders/fxaa.shs"),
+            fs::view("engine://shaders/bloombrightnessthreshold.shs"),
+            fs::view("engine://shaders/gaussianblur.shs"),
+            fs::view("engine://shaders/bloomcombine.shs"),
+            fs::view("engine://shaders/bloomhistorymix.shs"),
+            fs::view("engine://shaders/depththreshold.shs"),
+            fs::view("engine://shaders/dofbokeh.shs"),
+            fs::view("engine://shaders/dofcombine.shs"),
+            fs::view("engine://shaders/postfilter.shs"),
+            fs::view("engine://shaders/prefilter.shs")
+            });
+
         createProcess<&Renderer::render>("Rendering");
 
         m_scheduler->sendCommand(m_scheduler->getChainThreadId("Rendering"), [&]()
@@ -361,11 +386,13 @@ namespace legion::rendering
         if (m_pipelineProvider.isNull())
             return;
 
-        static auto cameraQuery = createQuery<camera>();
-        cameraQuery.queryEntities();
-        for (auto ent : cameraQuery)
+        //the cameras and everything the stages draw come from the newest snapshot the update chain extracted, only the windows are still read from the ECS
+        const render_snapshot& snapshot = RenderExtraction::acquireSnapshot();
+        DebugLineBuffer::merge(deltatime, m_debugLines);
+
+        for (auto& camSnapshot : snapshot.cameras)
         {
-            auto cam = ent.get_component_handle<camera>().read();
+            camera cam = camSnapshot.cam;
             app::window win = cam.targetWindow.read();
             if (!win)
                 win = m_ecs->world.get_component_handle<app::window>().read();
@@ -386,9 +413,9 @@ namespace legion::rendering
             if (viewportSize.x == 0 || viewportSize.y == 0)
                 continue;
 
-            position camPos = ent.get_component_handle<position>().read();
-            rotation camRot = ent.get_component_handle<rotation>().read();
-            scale camScale = ent.get_component_handle<scale>().read();
+            const position& camPos = camSnapshot.pos;
+            const rotation& camRot = camSnapshot.rot;
+            const scale& camScale = camSnapshot.scl;
 
             math::mat4 view(1.f);
             math::compose(view, camScale, camRot, camPos);
@@ -398,6 +425,10 @@ namespace legion::rendering
 
             camera::camera_input cam_input_data(view, projection, camPos, camRot.forward(), cam.nearz, cam.farz, viewportSize);
 
+            //levels of detail are selected for the first camera, with the same frustum the batching stage culls with
+            if (&camSnapshot == &snapshot.cameras.front())
+                LODManager::setView(lod_view::from_camera(camPos, view, projection));
+
             if (!m_exiting.load(std::memory_order_relaxed))
             {
                 m_currentPipeline = m_pipelineProvider(win);
@@ -423,6 +454,11 @@ namespace legion::rendering
         return m_currentPipeline;
     }
 
+    L_NODISCARD const debug_line_frame& Renderer::getDebugLines()
+    {
+        return m_debugLines;
+    }
+
     L_NODISCARD RenderPipelineBase* Renderer::getMainPipeline()
     {
         OPTICK_EVENT();
@@ -1,6 +1,7 @@
 #pragma once
 #include <rendering/pipeline/base/pipeline.hpp>
 #include <rendering/pipeline/default/defaultpipeline.hpp>
+#include <rendering/systems/render_extraction.hpp>
 
 #include <unordered_map>
 
@@ -20,6 +21,7 @@ namespace legion::rendering
         void setThreadPriority();
 
         static RenderPipelineBase* m_currentPipeline;
+        static debug_line_frame m_debugLines;
 
     public:
         Renderer() : System<Renderer>()
@@ -39,6 +41,11 @@ namespace legion::rendering
         L_NODISCARD static RenderPipelineBase* getPipeline(app::window& context);
         L_NODISCARD static RenderPipelineBase* getCurrentPipeline();
         L_NODISCARD static RenderPipelineBase* getMainPipeline();
+
+        /**@brief Debug lines of the frame that is being rendered, merged once at the start of the frame so every camera draws the same lines.
+         *        Only call from the render thread.
+         */
+        L_NODISCARD static const debug_line_frame& getDebugLines();
     };
 }
 
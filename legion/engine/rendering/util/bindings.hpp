@@ -26,6 +26,8 @@
 
 /* uniform 14 */  #define SV_LIGHTCOUNT     SV_VIEWPORT + 1
 /* buffer  0  */  #define SV_LIGHTS         SV_START
+/* buffer  1  */  #define SV_LIGHTCLUSTERS  SV_LIGHTS + 1
+/* buffer  2  */  #define SV_LIGHTINDICES   SV_LIGHTCLUSTERS + 1
 
 /* uniform 15 */  #define SV_SCENECOLOR     SV_LIGHTCOUNT + 1
 /* uniform 16 */  #define SV_SCENEDEPTH     SV_SCENECOLOR + 1
@@ -41,6 +43,8 @@
 
 /* uniform 23 */  #define SV_MATERIAL       SV_ALBEDO
 
+/* uniform buffer 0 */  #define SV_MATERIALBLOCKS SV_START
+
 /* attachment 0 */ #define FRAGMENT_ATTACHMENT  GL_COLOR_ATTACHMENT0
 /* attachment 1 */ #define NORMAL_ATTACHMENT    FRAGMENT_ATTACHMENT + 1
 /* attachment 2 */ #define POSITION_ATTACHMENT  NORMAL_ATTACHMENT + 1
@@ -74,6 +78,8 @@ namespace legion::rendering::detail
 
             defines.push_back("SV_LIGHTCOUNT=" +   std::to_string(SV_LIGHTCOUNT));
             defines.push_back("SV_LIGHTS=" +       std::to_string(SV_LIGHTS));
+            defines.push_back("SV_LIGHTCLUSTERS=" +std::to_string(SV_LIGHTCLUSTERS));
+            defines.push_back("SV_LIGHTINDICES=" + std::to_string(SV_LIGHTINDICES));
 
             defines.push_back("SV_SCENECOLOR=" +   std::to_string(SV_SCENECOLOR));
             defines.push_back("SV_SCENEDEPTH=" +   std::to_string(SV_SCENEDEPTH));
@@ -88,6 +94,7 @@ namespace legion::rendering::detail
             defines.push_back("SV_HEIGHTSCALE=" +  std::to_string(SV_HEIGHTSCALE));
 
             defines.push_back("SV_MATERIAL=" +     std::to_string(SV_MATERIAL));
+            defines.push_back("SV_MATERIALBLOCKS=" + std::to_string(SV_MATERIALBLOCKS));
 
             defines.push_back("SV_FRAGMENTOUT=" +    std::to_string(FRAGMENT_ATTACHMENT - GL_COLOR_ATTACHMENT0));
             defines.push_back("SV_NORMALOUT=" +      std::to_string(NORMAL_ATTACHMENT - GL_COLOR_ATTACHMENT0));
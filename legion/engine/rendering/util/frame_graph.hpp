@@ -0,0 +1,386 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file frame_graph.hpp
+ */
+
+namespace legion::rendering
+{
+    enum struct frame_resource_type
+    {
+        texture,
+        buffer
+    };
+
+    /**@struct frame_resource_desc
+     * @brief Description of a resource in the frame graph, enough to know how much memory it takes and which other resources it can share memory with.
+     */
+    struct frame_resource_desc
+    {
+        frame_resource_type type = frame_resource_type::texture;
+
+        //textures: size relative to the framebuffer, bytes per texel and whether the texture has a full mip chain
+        float scale = 1.f;
+        size_type texelSize = 0;
+        bool mipmapped = false;
+
+        //buffers: size in bytes
+        size_type bufferSize = 0;
+
+        //textures can only share memory with textures of the same format and scale, the format is whatever key the user of the graph uses for that
+        id_type format = invalid_id;
+
+        /**@brief Size of the texture for a framebuffer of the given size.
+         */
+        L_NODISCARD math::ivec2 size(math::ivec2 framebufferSize) const noexcept
+        {
+            return math::ivec2(
+                math::max(static_cast<int>(framebufferSize.x * scale), 1),
+                math::max(static_cast<int>(framebufferSize.y * scale), 1));
+        }
+
+        /**@brief Memory the resource takes for a framebuffer of the given size, mip chains add a third.
+         */
+        L_NODISCARD size_type bytes(math::ivec2 framebufferSize) const noexcept
+        {
+            if (type == frame_resource_type::buffer)
+                return bufferSize;
+
+            const math::ivec2 texels = size(framebufferSize);
+            const size_type base = static_cast<size_type>(texels.x) * static_cast<size_type>(texels.y) * texelSize;
+            return mipmapped ? base + base / 3 : base;
+        }
+
+        /**@brief Whether a physical resource made for this description can be used for the other.
+         */
+        L_NODISCARD bool compatible(const frame_resource_desc& other) const noexcept
+        {
+            if (type != other.type)
+                return false;
+
+            if (type == frame_resource_type::buffer)
+                return true;
+
+            return format == other.format && scale == other.scale && texelSize == other.texelSize && mipmapped == other.mipmapped;
+        }
+    };
+
+    /**@struct frame_graph_report
+     * @brief Result of compiling a frame graph.
+     */
+    struct frame_graph_report
+    {
+        size_type passes = 0;
+        size_type culledPasses = 0;
+        size_type transientResources = 0;
+        size_type physicalResources = 0;
+        //memory the transient resources would take if every one of them had its own memory, and the memory they take after aliasing
+        size_type virtualBytes = 0;
+        size_type physicalBytes = 0;
+
+        L_NODISCARD size_type savedBytes() const noexcept { return virtualBytes - physicalBytes; }
+    };
+
+    /**@class FrameGraph
+     * @brief Passes declare the resources they read, write and create, in the order they execute.
+     *        Compiling culls the passes of which the output is never used and gives transient resources that are never alive at the same time the same physical resource.
+     *        Passes that declare nothing at all are never culled, since nothing is known about them.
+     * @note Only uses core, creating the physical resources is up to the user of the graph.
+     */
+    class FrameGraph
+    {
+    public:
+        static constexpr size_type invalid_index = std::numeric_limits<size_type>::max();
+
+        /**@brief Removes all passes and resources.
+         */
+        void clear()
+        {
+            m_passes.clear();
+            m_resources.clear();
+            m_resourceIndices.clear();
+            m_physical.clear();
+            m_report = frame_graph_report{};
+        }
+
+        /**@brief Starts declaring a new pass, the other declarations are for the last added pass.
+         * @return Index of the pass.
+         */
+        size_type add_pass(const std::string& name)
+        {
+            m_passes.push_back({ name });
+            return m_passes.size() - 1;
+        }
+
+        /**@brief Marks the current pass as having an effect outside of the graph, eg: presenting to the screen. Those passes are never culled.
+         */
+        void side_effect()
+        {
+            if (!m_passes.empty())
+                m_passes.back().sideEffect = true;
+        }
+
+        /**@brief Declares a transient resource that is created and written by the current pass. Transient resources only live within a frame.
+         */
+        void create(const std::string& name, const frame_resource_desc& desc)
+        {
+            resource& res = m_resources[getResource(name)];
+            res.desc = desc;
+            res.imported = false;
+            write(name);
+        }
+
+        /**@brief Declares a resource that is owned outside of the graph, those never share memory.
+         * @param persistent Whether the contents are used after the frame, passes that write persistent resources are never culled.
+         */
+        void import_resource(const std::string& name, bool persistent = false)
+        {
+            resource& res = m_resources[getResource(name)];
+            res.imported = true;
+            res.persistent = res.persistent || persistent;
+        }
+
+        /**@brief Declares that the current pass reads a resource. Resources that weren't created or imported are treated as imported.
+         */
+        void read(const std::string& name)
+        {
+            if (!m_passes.empty())
+                m_passes.back().reads.push_back(getResource(name));
+        }
+
+        /**@brief Declares that the current pass writes a resource. Resources that weren't created or imported are treated as imported.
+         */
+        void write(const std::string& name)
+        {
+            if (!m_passes.empty())
+                m_passes.back().writes.push_back(getResource(name));
+        }
+
+        /**@brief Culls unused passes, calculates the lifetimes of the transient resources and assigns them to physical resources.
+         * @param framebufferSize Size the texture sizes are relative to, only used for the report.
+         */
+        const frame_graph_report& compile(math::ivec2 framebufferSize)
+        {
+            OPTICK_EVENT();
+            cullPasses();
+            calculateLifetimes();
+            assignPhysical(framebufferSize);
+            return m_report;
+        }
+
+        L_NODISCARD const frame_graph_report& report() const noexcept { return m_report; }
+
+        L_NODISCARD size_type pass_count() const noexcept { return m_passes.size(); }
+
+        L_NODISCARD const std::string& pass_name(size_type pass) const { return m_passes[pass].name; }
+
+        /**@brief Whether the pass survived culling, only valid after compile.
+         */
+        L_NODISCARD bool is_alive(size_type pass) const noexcept { return pass < m_passes.size() && m_passes[pass].alive; }
+
+        /**@brief Index of the physical resource a transient resource was assigned to.
+         * @return invalid_index if the resource is imported, unknown or only used by culled passes.
+         */
+        L_NODISCARD size_type physical_index(const std::string& name) const
+        {
+            auto iter = m_resourceIndices.find(nameHash(name));
+            if (iter == m_resourceIndices.end())
+                return invalid_index;
+            return m_resources[iter->second].physical;
+        }
+
+        L_NODISCARD size_type physical_count() const noexcept { return m_physical.size(); }
+
+        /**@brief Description of a physical resource, buffers are as large as the largest buffer assigned to them.
+         */
+        L_NODISCARD const frame_resource_desc& physical_desc(size_type physical) const { return m_physical[physical].desc; }
+
+        /**@brief First and last pass that use a resource, invalid_index for both if it isn't used by any pass that survived culling.
+         */
+        L_NODISCARD std::pair<size_type, size_type> lifetime(const std::string& name) const
+        {
+            auto iter = m_resourceIndices.find(nameHash(name));
+            if (iter == m_resourceIndices.end())
+                return { invalid_index, invalid_index };
+            const resource& res = m_resources[iter->second];
+            return { res.first, res.last };
+        }
+
+    private:
+        struct pass
+        {
+            std::string name;
+            bool sideEffect = false;
+            bool alive = true;
+            std::vector<size_type> reads;
+            std::vector<size_type> writes;
+        };
+
+        struct resource
+        {
+            std::string name;
+            frame_resource_desc desc;
+            bool imported = true;
+            bool persistent = false;
+            size_type first = invalid_index;
+            size_type last = invalid_index;
+            size_type physical = invalid_index;
+        };
+
+        struct physical_resource
+        {
+            frame_resource_desc desc;
+            size_type lastUse;
+        };
+
+        std::vector<pass> m_passes;
+        std::vector<resource> m_resources;
+        std::unordered_map<id_type, size_type> m_resourceIndices;
+        std::vector<physical_resource> m_physical;
+        frame_graph_report m_report;
+
+        size_type getResource(const std::string& name)
+        {
+            const id_type id = nameHash(name);
+            auto iter = m_resourceIndices.find(id);
+            if (iter != m_resourceIndices.end())
+                return iter->second;
+
+            m_resources.push_back({ name });
+            m_resourceIndices.emplace(id, m_resources.size() - 1);
+            return m_resources.size() - 1;
+        }
+
+        //walks back from the passes with side effects and the persistent resources, a pass is needed when a later needed pass reads something it writes
+        void cullPasses()
+        {
+            std::vector<bool> needed(m_resources.size());
+            for (size_type i = 0; i < m_resources.size(); i++)
+                needed[i] = m_resources[i].persistent;
+
+            m_report = frame_graph_report{};
+            m_report.passes = m_passes.size();
+
+            for (size_type i = m_passes.size(); i-- > 0;)
+            {
+                pass& p = m_passes[i];
+                p.alive = p.sideEffect || (p.reads.empty() && p.writes.empty());
+                for (size_type write : p.writes)
+                    p.alive = p.alive || needed[write];
+
+                if (!p.alive)
+                {
+                    m_report.culledPasses++;
+                    continue;
+                }
+
+                for (size_type read : p.reads)
+                    needed[read] = true;
+            }
+        }
+
+        void calculateLifetimes()
+        {
+            for (auto& res : m_resources)
+            {
+                res.first = invalid_index;
+                res.last = invalid_index;
+                res.physical = invalid_index;
+            }
+
+            auto use = [&](size_type resourceIndex, size_type passIndex)
+            {
+                resource& res = m_resources[resourceIndex];
+                if (res.first == invalid_index)
+                    res.first = passIndex;
+                res.last = passIndex;
+            };
+
+            for (size_type i = 0; i < m_passes.size(); i++)
+            {
+                if (!m_passes[i].alive)
+                    continue;
+
+                for (size_type read : m_passes[i].reads)
+                    use(read, i);
+                for (size_type write : m_passes[i].writes)
+                    use(write, i);
+            }
+        }
+
+        //greedy interval assignment in order of first use, a resource goes to a compatible physical resource that is free by the time it's first used
+        void assignPhysical(math::ivec2 framebufferSize)
+        {
+            m_physical.clear();
+
+            std::vector<size_type> order;
+            for (size_type i = 0; i < m_resources.size(); i++)
+                if (!m_resources[i].imported && m_resources[i].first != invalid_index)
+                    order.push_back(i);
+
+            std::stable_sort(order.begin(), order.end(), [&](size_type lhs, size_type rhs)
+                {
+                    const resource& a = m_resources[lhs];
+                    const resource& b = m_resources[rhs];
+                    if (a.first != b.first)
+                        return a.first < b.first;
+                    return a.desc.bytes(framebufferSize) > b.desc.bytes(framebufferSize);
+                });
+
+            for (size_type index : order)
+            {
+                resource& res = m_resources[index];
+                const size_type bytes = res.desc.bytes(framebufferSize);
+
+                //the best fit is the smallest free resource that is large enough, otherwise the largest free one which then grows
+                size_type best = invalid_index;
+                for (size_type i = 0; i < m_physical.size(); i++)
+                {
+                    const physical_resource& candidate = m_physical[i];
+                    if (candidate.lastUse >= res.first || !candidate.desc.compatible(res.desc))
+                        continue;
+
+                    if (best == invalid_index)
+                    {
+                        best = i;
+                        continue;
+                    }
+
+                    const size_type candidateBytes = candidate.desc.bytes(framebufferSize);
+                    const size_type bestBytes = m_physical[best].desc.bytes(framebufferSize);
+                    const bool candidateFits = candidateBytes >= bytes;
+                    const bool bestFits = bestBytes >= bytes;
+                    if ((candidateFits && (!bestFits || candidateBytes < bestBytes)) || (!candidateFits && !bestFits && candidateBytes > bestBytes))
+                        best = i;
+                }
+
+                if (best == invalid_index)
+                {
+                    m_physical.push_back({ res.desc, res.last });
+                    best = m_physical.size() - 1;
+                }
+                else
+                {
+                    physical_resource& physical = m_physical[best];
+                    physical.lastUse = res.last;
+                    physical.desc.bufferSize = math::max(physical.desc.bufferSize, res.desc.bufferSize);
+                }
+
+                res.physical = best;
+                m_report.transientResources++;
+                m_report.virtualBytes += bytes;
+            }
+
+            m_report.physicalResources = m_physical.size();
+            for (auto& physical : m_physical)
+                m_report.physicalBytes += physical.desc.bytes(framebufferSize);
+        }
+    };
+}
@@ -0,0 +1,250 @@
+#pragma once
+#include <core/core.hpp>
+#include <rendering/util/instance_batcher.hpp>
+
+#include <algorithm>
+#include <unordered_map>
+
+/**
+ * @file indirect_commands.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct draw_elements_indirect_command
+     * @brief Layout of a single command in a GL_DRAW_INDIRECT_BUFFER for glMultiDrawElementsIndirect.
+     */
+    struct draw_elements_indirect_command
+    {
+        uint32 count;
+        uint32 instanceCount;
+        uint32 firstIndex;
+        int32 baseVertex;
+        uint32 baseInstance;
+    };
+
+    static_assert(sizeof(draw_elements_indirect_command) == 5 * sizeof(uint32), "Indirect commands need to be tightly packed.");
+
+    /**@struct packed_submesh
+     * @brief Range of a sub-mesh in the shared index buffer.
+     */
+    struct packed_submesh
+    {
+        uint32 indexCount;
+        uint32 firstIndex;
+    };
+
+    /**@struct packed_model
+     * @brief Where the vertices and indices of a model were placed in the shared vertex and index buffers.
+     *        The indices stay relative to the first vertex of the model, draws add baseVertex to them.
+     */
+    struct packed_model
+    {
+        int32 baseVertex;
+        uint32 vertexCount;
+        uint32 firstIndex;
+        uint32 indexCount;
+        std::vector<packed_submesh> submeshes;
+    };
+
+    /**@class mesh_pack_layout
+     * @brief Places models in shared vertex and index buffers. Only does the bookkeeping, the data is copied by the owner of the buffers.
+     *        Space of removed models is reused by models that fit in it, otherwise models are placed at the end of the buffers.
+     */
+    class mesh_pack_layout
+    {
+    public:
+        /**@brief Reserves space for a model, replacing the placement it had before.
+         * @param submeshes The sub-meshes of the model, with offsets relative to the first index of the model.
+         */
+        const packed_model& add(id_type id, size_type vertexCount, size_type indexCount, const std::vector<sub_mesh>& submeshes)
+        {
+            remove(id);
+
+            packed_model& model = m_models[id];
+            model.baseVertex = static_cast<int32>(allocate(m_freeVertices, m_vertexCount, vertexCount));
+            model.vertexCount = static_cast<uint32>(vertexCount);
+            model.firstIndex = static_cast<uint32>(allocate(m_freeIndices, m_indexCount, indexCount));
+            model.indexCount = static_cast<uint32>(indexCount);
+
+            model.submeshes.clear();
+            for (auto& submesh : submeshes)
+                model.submeshes.push_back({ static_cast<uint32>(submesh.indexCount), static_cast<uint32>(model.firstIndex + submesh.indexOffset) });
+
+            return model;
+        }
+
+        /**@brief Frees the space of a model so other models can be placed there, does nothing if the model wasn't added.
+         */
+        void remove(id_type id)
+        {
+            auto iter = m_models.find(id);
+            if (iter == m_models.end())
+                return;
+
+            release(m_freeVertices, m_vertexCount, static_cast<size_type>(iter->second.baseVertex), iter->second.vertexCount);
+            release(m_freeIndices, m_indexCount, iter->second.firstIndex, iter->second.indexCount);
+            m_models.erase(iter);
+        }
+
+        /**@brief Returns the placement of a model, nullptr if the model wasn't added.
+         */
+        L_NODISCARD const packed_model* get(id_type id) const
+        {
+            auto iter = m_models.find(id);
+            return iter == m_models.end() ? nullptr : &iter->second;
+        }
+
+        //number of vertices and indices up to the end of the last placed model, the buffers need to be at least this large
+        L_NODISCARD size_type vertex_count() const noexcept { return m_vertexCount; }
+        L_NODISCARD size_type index_count() const noexcept { return m_indexCount; }
+
+        //number of vertices and indices in the gaps left by removed models
+        L_NODISCARD size_type free_vertex_count() const noexcept { return countFree(m_freeVertices); }
+        L_NODISCARD size_type free_index_count() const noexcept { return countFree(m_freeIndices); }
+
+    private:
+        struct free_range
+        {
+            size_type first;
+            size_type count;
+        };
+
+        std::unordered_map<id_type, packed_model> m_models;
+        //gaps sorted on their start, neighbouring gaps are merged and a gap at the end shrinks the used space instead
+        std::vector<free_range> m_freeVertices;
+        std::vector<free_range> m_freeIndices;
+        size_type m_vertexCount = 0;
+        size_type m_indexCount = 0;
+
+        // Takes the first gap that is large enough, or grows the used space.
+        static size_type allocate(std::vector<free_range>& freeRanges, size_type& end, size_type count)
+        {
+            for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter)
+            {
+                if (iter->count < count)
+                    continue;
+
+                const size_type first = iter->first;
+                iter->first += count;
+                iter->count -= count;
+                if (iter->count == 0)
+                    freeRanges.erase(iter);
+                return first;
+            }
+
+            const size_type first = end;
+            end += count;
+            return first;
+        }
+
+        static void release(std::vector<free_range>& freeRanges, size_type& end, size_type first, size_type count)
+        {
+            if (count == 0)
+                return;
+
+            auto iter = std::lower_bound(freeRanges.begin(), freeRanges.end(), first, [](const free_range& range, size_type value) { return range.first < value; });
+            iter = freeRanges.insert(iter, free_range{ first, count });
+
+            auto next = iter + 1;
+            if (next != freeRanges.end() && iter->first + iter->count == next->first)
+            {
+                iter->count += next->count;
+                freeRanges.erase(next);
+            }
+
+            if (iter != freeRanges.begin())
+            {
+                auto previous = iter - 1;
+                if (previous->first + previous->count == iter->first)
+                {
+                    previous->count += iter->count;
+                    freeRanges.erase(iter);
+                }
+            }
+
+            if (!freeRanges.empty() && freeRanges.back().first + freeRanges.back().count == end)
+            {
+                end = freeRanges.back().first;
+                freeRanges.pop_back();
+            }
+        }
+
+        static size_type countFree(const std::vector<free_range>& freeRanges) noexcept
+        {
+            size_type total = 0;
+            for (auto& range : freeRanges)
+                total += range.count;
+            return total;
+        }
+    };
+
+    /**@struct indirect_draw_group
+     * @brief Consecutive commands that use the same material and shader variant, drawn with a single glMultiDrawElementsIndirect.
+     */
+    struct indirect_draw_group
+    {
+        id_type material;
+        id_type variant;
+        size_type firstCommand;
+        size_type commandCount;
+    };
+
+    /**@struct indirect_draw_list
+     * @brief The draws of a frame, as indirect commands for packed models and as plain ranges for models that couldn't be packed.
+     */
+    struct indirect_draw_list
+    {
+        std::vector<draw_elements_indirect_command> commands;
+        std::vector<indirect_draw_group> groups;
+        //ranges of models that aren't in the shared buffers, these still need a draw call per sub-mesh
+        std::vector<instance_batch_range> unpacked;
+
+        void clear()
+        {
+            commands.clear();
+            groups.clear();
+            unpacked.clear();
+        }
+    };
+
+    /**@brief Turns the ranges of the instance batcher into indirect commands, one per sub-mesh of every range.
+     * @param getPackedModel Function with the signature const packed_model*(id_type model), returns nullptr for models that aren't packed.
+     * @param getVariant Function with the signature id_type(id_type material), returns the shader variant the material currently uses.
+     * @param output [out] Cleared and then filled with the draws of the batches, keeps its memory between frames.
+     */
+    template<typename GetPackedModel, typename GetVariant>
+    void build_indirect_commands(const instance_batches& batches, GetPackedModel&& getPackedModel, GetVariant&& getVariant, indirect_draw_list& output)
+    {
+        OPTICK_EVENT();
+        output.clear();
+
+        id_type lastMaterial = invalid_id;
+        id_type lastVariant = invalid_id;
+
+        for (auto& range : batches.ranges)
+        {
+            const packed_model* model = getPackedModel(range.model);
+            if (!model)
+            {
+                output.unpacked.push_back(range);
+                continue;
+            }
+
+            if (range.material != lastMaterial)
+            {
+                lastMaterial = range.material;
+                lastVariant = getVariant(range.material);
+                output.groups.push_back({ lastMaterial, lastVariant, output.commands.size(), 0 });
+            }
+
+            for (auto& submesh : model->submeshes)
+            {
+                output.commands.push_back({ submesh.indexCount, static_cast<uint32>(range.count), submesh.firstIndex,
+                    model->baseVertex, static_cast<uint32>(batches.firstInstance + range.start) });
+            }
+
+            output.groups.back().commandCount += model->submeshes.size();
+        }
+    }
+}
@@ -0,0 +1,260 @@
+#pragma once
+#include <core/core.hpp>
+#include <core/async/parallel_radix_sort.hpp>
+
+#include <unordered_map>
+
+/**
+ * @file instance_batcher.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct instance_batch_range
+     * @brief A range of instances that share a material and a model, and can be drawn with one instanced draw call.
+     *        The start is relative to instance_batches::firstInstance.
+     */
+    struct instance_batch_range
+    {
+        id_type material;
+        id_type model;
+        size_type start;
+        size_type count;
+    };
+
+    /**@struct instance_batches
+     * @brief The batches of a frame. The world matrices of the instances are written in sorted order to memory given by the user of the batcher,
+     *        usually the mapped memory of the instance buffer.
+     */
+    struct instance_batches
+    {
+        //index of the first instance in the memory the instances were written to
+        size_type firstInstance = 0;
+        size_type instanceCount = 0;
+        std::vector<instance_batch_range> ranges;
+    };
+
+    /**@struct batch_instance
+     * @brief What the instance batcher needs to know about a single renderable.
+     */
+    struct batch_instance
+    {
+        bool visible;
+        id_type material;
+        id_type model;
+        //distance from the camera along the view direction, divided by the far plane distance
+        float depth;
+    };
+
+    /**@class InstanceBatcher
+     * @brief Sorts renderables into instance batches in parallel. Every job writes a 64 bit sort key (material, model, depth bucket)
+     *        for each visible renderable of its own range, the keys are then compacted and radix sorted, and the world matrices gathered in sorted order.
+     *        All buffers are kept between frames, so once it has seen the largest frame and every material and model it doesn't allocate anymore.
+     * @note Only uses core, so it can be run and tested without a graphics context.
+     */
+    class InstanceBatcher
+    {
+    public:
+        static constexpr size_type instancesPerJob = 1024;
+
+        static constexpr size_type depthBits = 20;
+        static constexpr size_type modelBits = 24;
+        static constexpr size_type materialBits = 20;
+
+        /**@brief Batches count renderables.
+         * @param worldMatrices Array with the world matrix of every renderable.
+         * @param describe Function with the signature batch_instance(size_type index), called once for every renderable from multiple threads.
+         * @param allocate Function with the signature math::mat4*(size_type instanceCount, size_type& firstInstance) that returns where to write the sorted instances.
+         *                 The instances are written from multiple threads. When it returns nullptr nothing is batched.
+         * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+         * @param output [out] Instances and ranges of the frame, ranges are sorted by material and then by model.
+         */
+        template<typename Describe, typename Allocate, typename RunJobs>
+        void build(size_type count, const math::mat4* worldMatrices, Describe&& describe, Allocate&& allocate, RunJobs&& runJobs, instance_batches& output)
+        {
+            OPTICK_EVENT();
+            const size_type jobCount = (count + instancesPerJob - 1) / instancesPerJob;
+
+            m_chunkKeys.resize(count);
+            m_chunkIndices.resize(count);
+            m_chunkCounts.resize(jobCount);
+            m_chunkOffsets.resize(jobCount);
+
+            {
+                OPTICK_EVENT("Emit sort keys");
+                runJobs(jobCount, [&](size_type job)
+                    {
+                        const size_type start = job * instancesPerJob;
+                        const size_type end = std::min(start + instancesPerJob, count);
+
+                        //small per job caches of the last slots that were looked up, so most renderables don't need to lock the slot maps
+                        slot_cache materialCache;
+                        slot_cache modelCache;
+
+                        size_type written = 0;
+                        for (size_type i = start; i < end; i++)
+                        {
+                            const batch_instance instance = describe(i);
+                            if (!instance.visible)
+                                continue;
+
+                            const uint64 materialSlot = materialCache.get_slot(instance.material, m_materialSlots);
+                            const uint64 modelSlot = modelCache.get_slot(instance.model, m_modelSlots);
+
+                            m_chunkKeys[start + written] = make_key(materialSlot, modelSlot, instance.depth);
+                            m_chunkIndices[start + written] = static_cast<uint32>(i);
+                            written++;
+                        }
+
+                        m_chunkCounts[job] = written;
+                    });
+            }
+
+            size_type visibleCount = 0;
+            for (size_type job = 0; job < jobCount; job++)
+            {
+                m_chunkOffsets[job] = visibleCount;
+                visibleCount += m_chunkCounts[job];
+            }
+
+            m_keys.resize(visibleCount);
+            m_indices.resize(visibleCount);
+
+            {
+                OPTICK_EVENT("Compact sort keys");
+                runJobs(jobCount, [&](size_type job)
+                    {
+                        const size_type start = job * instancesPerJob;
+                        std::copy_n(m_chunkKeys.begin() + start, m_chunkCounts[job], m_keys.begin() + m_chunkOffsets[job]);
+                        std::copy_n(m_chunkIndices.begin() + start, m_chunkCounts[job], m_indices.begin() + m_chunkOffsets[job]);
+                    });
+            }
+
+            {
+                OPTICK_EVENT("Sort keys");
+                async::parallel_radix_sort(m_keys, m_indices, m_sortBuffers, jobCount, runJobs);
+            }
+
+            output.ranges.clear();
+            output.firstInstance = 0;
+            output.instanceCount = 0;
+            if (visibleCount == 0)
+                return;
+
+            math::mat4* instances = allocate(visibleCount, output.firstInstance);
+            if (!instances)
+                return;
+
+            output.instanceCount = visibleCount;
+
+            {
+                OPTICK_EVENT("Gather instances");
+                runJobs(jobCount, [&](size_type job)
+                    {
+                        const size_type start = job * instancesPerJob;
+                        const size_type end = std::min(start + instancesPerJob, visibleCount);
+                        for (size_type i = start; i < end; i++)
+                            instances[i] = worldMatrices[m_indices[i]];
+                    });
+            }
+
+            {
+                OPTICK_EVENT("Build ranges");
+                for (size_type i = 0; i < visibleCount; i++)
+                {
+                    const uint64 batch = m_keys[i] >> depthBits;
+                    if (i != 0 && batch == (m_keys[i - 1] >> depthBits))
+                    {
+                        output.ranges.back().count++;
+                        continue;
+                    }
+
+                    const size_type materialSlot = static_cast<size_type>(batch >> modelBits);
+                    const size_type modelSlot = static_cast<size_type>(batch & ((uint64(1) << modelBits) - 1));
+                    output.ranges.push_back({ m_materialSlots.get_id(materialSlot), m_modelSlots.get_id(modelSlot), i, 1 });
+                }
+            }
+        }
+
+        /**@brief Creates the sort key of a renderable, renderables are sorted by material, then model, and then front to back.
+         */
+        L_NODISCARD static uint64 make_key(uint64 materialSlot, uint64 modelSlot, float depth) noexcept
+        {
+            constexpr uint64 maxDepth = (uint64(1) << depthBits) - 1;
+            const uint64 depthBucket = static_cast<uint64>(math::clamp(depth, 0.f, 1.f) * maxDepth);
+            return (materialSlot << (modelBits + depthBits)) | (modelSlot << depthBits) | depthBucket;
+        }
+
+    private:
+        /**@struct slot_map
+         * @brief Hands out small consecutive slots for ids, so they fit in a sort key. Slots are never released.
+         * @note Supports up to 2^materialBits materials and 2^modelBits models, beyond that batches of different ids would be merged.
+         */
+        struct slot_map
+        {
+            std::unordered_map<id_type, size_type> slots;
+            std::vector<id_type> ids;
+            async::rw_spinlock lock;
+
+            size_type get_slot(id_type id)
+            {
+                {
+                    async::readonly_guard guard(lock);
+                    auto iter = slots.find(id);
+                    if (iter != slots.end())
+                        return iter->second;
+                }
+
+                async::readwrite_guard guard(lock);
+                auto [iter, inserted] = slots.emplace(id, ids.size());
+                if (inserted)
+                    ids.push_back(id);
+                return iter->second;
+            }
+
+            id_type get_id(size_type slot) const
+            {
+                return ids[slot];
+            }
+        };
+
+        /**@struct slot_cache
+         * @brief Direct mapped cache in front of a slot_map, only used by a single job.
+         */
+        struct slot_cache
+        {
+            static constexpr size_type size = 16;
+            id_type ids[size];
+            size_type slots[size];
+
+            slot_cache()
+            {
+                std::fill(std::begin(ids), std::end(ids), invalid_id);
+            }
+
+            size_type get_slot(id_type id, slot_map& map)
+            {
+                const size_type index = static_cast<size_type>(id ^ (id >> 17)) & (size - 1);
+                if (ids[index] != id)
+                {
+                    ids[index] = id;
+                    slots[index] = map.get_slot(id);
+                }
+                return slots[index];
+            }
+        };
+
+        slot_map m_materialSlots;
+        slot_map m_modelSlots;
+
+        //every job writes the keys of its visible renderables to the start of its own range in these
+        std::vector<uint64> m_chunkKeys;
+        std::vector<uint32> m_chunkIndices;
+        std::vector<size_type> m_chunkCounts;
+        std::vector<size_type> m_chunkOffsets;
+
+        std::vector<uint64> m_keys;
+        std::vector<uint32> m_indices;
+        async::radix_sort_buffers m_sortBuffers;
+    };
+}
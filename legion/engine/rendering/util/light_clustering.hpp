@@ -0,0 +1,398 @@
+#pragma once
+#include <core/core.hpp>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/**
+ * @file light_clustering.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct light_cluster_params
+     * @brief Header of the cluster buffer, tells the shaders how to find the cluster of a fragment.
+     *        Matches the std430 layout of LightClustersBuffer in lighting_input.shinc.
+     */
+    struct light_cluster_params
+    {
+        //tiles on x, tiles on y, depth slices and the number of global lights at the start of the index list
+        math::uvec4 grid;
+        //depth where the slices start, far plane, and the scale and bias that turn log(view depth) into a slice
+        math::vec4 depth;
+    };
+
+    static_assert(sizeof(light_cluster_params) == 8 * sizeof(uint32), "The cluster header needs to match the shader layout.");
+
+    /**@struct light_cluster
+     * @brief Range of a single cluster in the light index list.
+     */
+    struct light_cluster
+    {
+        uint32 offset;
+        uint32 count;
+    };
+
+    /**@struct light_sphere
+     * @brief World space bounds of a light. Lights with an infinite radius, like directional lights, affect every cluster.
+     */
+    struct light_sphere
+    {
+        math::vec3 position;
+        float radius;
+    };
+
+    /**@struct light_clusters
+     * @brief Result of the light assignment of a frame, laid out the way it gets uploaded.
+     */
+    struct light_clusters
+    {
+        light_cluster_params params;
+        //one range per cluster, ordered by slice, then tile row, then tile column
+        std::vector<light_cluster> clusters;
+        //indices into the light buffer, the first params.grid.w of them are the global lights
+        std::vector<uint32> indices;
+    };
+
+    /**@class LightClusterer
+     * @brief Bins lights into a grid of froxels (screen tiles split into exponential depth slices) so that shaders only loop over the lights of their own cluster.
+     *        The view space bounds of the clusters are only recalculated when the projection changes. Each depth slice is a job that first gathers the lights
+     *        that overlap its depth range and then tests them 4 at a time against the bounding box of each of its clusters.
+     *        All buffers are kept between frames.
+     * @note Only uses core, so it can be run and tested without a graphics context.
+     */
+    class LightClusterer
+    {
+    public:
+        static constexpr uint32 default_tiles_x = 16;
+        static constexpr uint32 default_tiles_y = 9;
+        static constexpr uint32 default_slices = 24;
+
+        //the slices start at this depth at the least, so a tiny near plane doesn't spend half the slices on the first few centimeters
+        static constexpr float min_slice_depth = 0.1f;
+
+        LightClusterer(uint32 tilesX = default_tiles_x, uint32 tilesY = default_tiles_y, uint32 slices = default_slices)
+            : m_tilesX(tilesX), m_tilesY(tilesY), m_slices(slices)
+        {
+            m_sliceCandidates.resize(slices);
+            m_sliceIndices.resize(slices);
+        }
+
+        /**@brief Assigns count lights to the clusters of the view frustum.
+         * @param view View matrix of the camera.
+         * @param proj Projection matrix of the camera, needs to be a symmetric perspective projection.
+         * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+         * @param output [out] Cluster ranges and light indices of the frame.
+         */
+        template<typename RunJobs>
+        void build(const light_sphere* lights, size_type count, const math::mat4& view, const math::mat4& proj, float nearz, float farz, RunJobs&& runJobs, light_clusters& output)
+        {
+            OPTICK_EVENT();
+            updateBounds(proj, nearz, farz);
+
+            const size_type tileCount = m_tilesX * m_tilesY;
+            output.params.grid = math::uvec4(m_tilesX, m_tilesY, m_slices, 0);
+            output.params.depth = math::vec4(m_sliceNear, m_farz, m_sliceScale, m_sliceBias);
+            output.clusters.resize(cluster_count());
+            output.indices.clear();
+
+            //transform the lights into view space and find the slices they overlap, global lights go straight to the index list
+            m_x.clear();
+            m_y.clear();
+            m_w.clear();
+            m_radius.clear();
+            m_firstSlice.clear();
+            m_lastSlice.clear();
+            m_lightIndices.clear();
+
+            for (size_type i = 0; i < count; i++)
+            {
+                const light_sphere& light = lights[i];
+                if (!(light.radius < std::numeric_limits<float>::max()))
+                {
+                    output.indices.push_back(static_cast<uint32>(i));
+                    continue;
+                }
+
+                if (light.radius <= 0.f)
+                    continue;
+
+                const math::vec3 viewPosition = math::vec3(view * math::vec4(light.position, 1.f));
+                const float w = viewPosition.z * m_depthSign;
+                if (w + light.radius < m_nearz || w - light.radius > m_farz)
+                    continue;
+
+                m_x.push_back(viewPosition.x);
+                m_y.push_back(viewPosition.y);
+                m_w.push_back(w);
+                m_radius.push_back(light.radius);
+                m_firstSlice.push_back(find_slice(w - light.radius));
+                m_lastSlice.push_back(find_slice(w + light.radius));
+                m_lightIndices.push_back(static_cast<uint32>(i));
+            }
+
+            const uint32 globalCount = static_cast<uint32>(output.indices.size());
+            output.params.grid.w = globalCount;
+
+            runJobs(m_slices, [&](size_type slice) { buildSlice(static_cast<uint32>(slice), output.clusters.data() + slice * tileCount); });
+
+            //concatenate the index lists of the slices after the global lights
+            size_type offset = globalCount;
+            m_sliceOffsets.resize(m_slices);
+            for (size_type slice = 0; slice < m_slices; slice++)
+            {
+                m_sliceOffsets[slice] = offset;
+                offset += m_sliceIndices[slice].size();
+            }
+            output.indices.resize(offset);
+
+            runJobs(m_slices, [&](size_type slice) {
+                auto& indices = m_sliceIndices[slice];
+                if (!indices.empty())
+                    std::memcpy(output.indices.data() + m_sliceOffsets[slice], indices.data(), indices.size() * sizeof(uint32));
+
+                light_cluster* clusters = output.clusters.data() + slice * tileCount;
+                for (size_type tile = 0; tile < tileCount; tile++)
+                    clusters[tile].offset += static_cast<uint32>(m_sliceOffsets[slice]);
+                });
+        }
+
+        /**@brief Fills the output with a single cluster in which every light is global, so every fragment loops over every light.
+         */
+        void build_flat(size_type count, light_clusters& output) const
+        {
+            output.params.grid = math::uvec4(1, 1, 1, static_cast<uint32>(count));
+            //a scale of zero puts every depth in the first slice
+            output.params.depth = math::vec4(1.f, 1.f, 0.f, 0.f);
+            output.clusters.assign(1, light_cluster{ static_cast<uint32>(count), 0 });
+            output.indices.resize(count);
+            for (size_type i = 0; i < count; i++)
+                output.indices[i] = static_cast<uint32>(i);
+        }
+
+        /**@brief Returns the depth slice that a view depth falls in, the same way the shaders do.
+         */
+        L_NODISCARD uint32 find_slice(float depth) const
+        {
+            const float slice = std::log(math::max(depth, m_sliceNear)) * m_sliceScale + m_sliceBias;
+            return static_cast<uint32>(math::clamp(slice, 0.f, static_cast<float>(m_slices - 1)));
+        }
+
+        /**@brief Returns the cluster that a point in view space falls in, the same way the shaders do. Only valid after build.
+         */
+        L_NODISCARD size_type find_cluster(const math::vec3& viewPosition) const
+        {
+            const float w = viewPosition.z * m_depthSign;
+            const math::vec2 ndc = math::vec2(viewPosition.x * m_projX, viewPosition.y * m_projY) / w;
+            const uint32 tileX = static_cast<uint32>(math::clamp((ndc.x * 0.5f + 0.5f) * m_tilesX, 0.f, static_cast<float>(m_tilesX - 1)));
+            const uint32 tileY = static_cast<uint32>(math::clamp((ndc.y * 0.5f + 0.5f) * m_tilesY, 0.f, static_cast<float>(m_tilesY - 1)));
+            return (find_slice(w) * m_tilesY + tileY) * m_tilesX + tileX;
+        }
+
+        /**@brief View space bounding box of a cluster, with z being the distance along the view direction. Only valid after build.
+         */
+        void cluster_bounds(size_type cluster, math::vec3& min, math::vec3& max) const
+        {
+            min = math::vec3(m_minX[cluster], m_minY[cluster], m_minZ[cluster]);
+            max = math::vec3(m_maxX[cluster], m_maxY[cluster], m_maxZ[cluster]);
+        }
+
+        L_NODISCARD size_type cluster_count() const noexcept { return static_cast<size_type>(m_tilesX) * m_tilesY * m_slices; }
+
+    private:
+        //a slice gathers its candidates in a structure of arrays, padded to a multiple of 4 with lights that never intersect
+        struct slice_candidates
+        {
+            std::vector<float> x;
+            std::vector<float> y;
+            std::vector<float> w;
+            std::vector<float> radius2;
+            std::vector<uint32> index;
+
+            void clear()
+            {
+                x.clear();
+                y.clear();
+                w.clear();
+                radius2.clear();
+                index.clear();
+            }
+
+            void push(float px, float py, float pw, float r2, uint32 i)
+            {
+                x.push_back(px);
+                y.push_back(py);
+                w.push_back(pw);
+                radius2.push_back(r2);
+                index.push_back(i);
+            }
+        };
+
+        uint32 m_tilesX;
+        uint32 m_tilesY;
+        uint32 m_slices;
+
+        //projection the cluster bounds were calculated for
+        float m_projX = 0.f;
+        float m_projY = 0.f;
+        float m_depthSign = 1.f;
+        float m_nearz = 0.f;
+        float m_farz = 0.f;
+        float m_sliceNear = 0.f;
+        float m_sliceScale = 0.f;
+        float m_sliceBias = 0.f;
+
+        std::vector<float> m_minX;
+        std::vector<float> m_minY;
+        std::vector<float> m_minZ;
+        std::vector<float> m_maxX;
+        std::vector<float> m_maxY;
+        std::vector<float> m_maxZ;
+
+        //view space spheres of the lights that are in the frustum depth range
+        std::vector<float> m_x;
+        std::vector<float> m_y;
+        std::vector<float> m_w;
+        std::vector<float> m_radius;
+        std::vector<uint32> m_firstSlice;
+        std::vector<uint32> m_lastSlice;
+        std::vector<uint32> m_lightIndices;
+
+        std::vector<slice_candidates> m_sliceCandidates;
+        std::vector<std::vector<uint32>> m_sliceIndices;
+        std::vector<size_type> m_sliceOffsets;
+
+        void updateBounds(const math::mat4& proj, float nearz, float farz)
+        {
+            const float depthSign = proj[2][3] < 0.f ? -1.f : 1.f;
+            if (proj[0][0] == m_projX && proj[1][1] == m_projY && depthSign == m_depthSign && nearz == m_nearz && farz == m_farz && !m_minX.empty())
+                return;
+
+            OPTICK_EVENT();
+            m_projX = proj[0][0];
+            m_projY = proj[1][1];
+            m_depthSign = depthSign;
+            m_nearz = nearz;
+            m_farz = farz;
+
+            m_sliceNear = math::min(math::max(nearz, min_slice_depth), farz * 0.5f);
+            m_sliceScale = static_cast<float>(m_slices) / std::log(farz / m_sliceNear);
+            m_sliceBias = -std::log(m_sliceNear) * m_sliceScale;
+
+            const size_type clusterCount = cluster_count();
+            m_minX.resize(clusterCount);
+            m_minY.resize(clusterCount);
+            m_minZ.resize(clusterCount);
+            m_maxX.resize(clusterCount);
+            m_maxY.resize(clusterCount);
+            m_maxZ.resize(clusterCount);
+
+            const float depthRatio = farz / m_sliceNear;
+            for (uint32 slice = 0; slice < m_slices; slice++)
+            {
+                //the first slice reaches back to the camera and the last one to the far plane, so that clamped lookups are still covered
+                const float z0 = slice == 0 ? 0.f : m_sliceNear * std::pow(depthRatio, static_cast<float>(slice) / m_slices);
+                const float z1 = slice == m_slices - 1 ? farz : m_sliceNear * std::pow(depthRatio, static_cast<float>(slice + 1) / m_slices);
+
+                for (uint32 tileY = 0; tileY < m_tilesY; tileY++)
+                {
+                    const float y0 = (-1.f + 2.f * tileY / m_tilesY) / m_projY;
+                    const float y1 = (-1.f + 2.f * (tileY + 1) / m_tilesY) / m_projY;
+
+                    for (uint32 tileX = 0; tileX < m_tilesX; tileX++)
+                    {
+                        const float x0 = (-1.f + 2.f * tileX / m_tilesX) / m_projX;
+                        const float x1 = (-1.f + 2.f * (tileX + 1) / m_tilesX) / m_projX;
+
+                        //the sides of a tile are planes through the camera, so the box spans the tile at both ends of the slice
+                        const size_type cluster = (slice * m_tilesY + tileY) * m_tilesX + tileX;
+                        m_minX[cluster] = math::min(math::min(x0 * z0, x0 * z1), math::min(x1 * z0, x1 * z1));
+                        m_maxX[cluster] = math::max(math::max(x0 * z0, x0 * z1), math::max(x1 * z0, x1 * z1));
+                        m_minY[cluster] = math::min(math::min(y0 * z0, y0 * z1), math::min(y1 * z0, y1 * z1));
+                        m_maxY[cluster] = math::max(math::max(y0 * z0, y0 * z1), math::max(y1 * z0, y1 * z1));
+                        m_minZ[cluster] = z0;
+                        m_maxZ[cluster] = z1;
+                    }
+                }
+            }
+        }
+
+        void buildSlice(uint32 slice, light_cluster* clusters)
+        {
+            auto& candidates = m_sliceCandidates[slice];
+            auto& indices = m_sliceIndices[slice];
+            candidates.clear();
+            indices.clear();
+
+            for (size_type i = 0; i < m_lightIndices.size(); i++)
+                if (m_firstSlice[i] <= slice && slice <= m_lastSlice[i])
+                    candidates.push(m_x[i], m_y[i], m_w[i], m_radius[i] * m_radius[i], m_lightIndices[i]);
+
+            const size_type candidateCount = candidates.index.size();
+            while (candidates.index.size() % 4 != 0)
+                candidates.push(0.f, 0.f, 0.f, -1.f, 0);
+
+            const size_type tileCount = m_tilesX * m_tilesY;
+            for (size_type tile = 0; tile < tileCount; tile++)
+            {
+                const size_type cluster = slice * tileCount + tile;
+                clusters[tile].offset = static_cast<uint32>(indices.size());
+
+                if (candidateCount != 0)
+                    testCluster(cluster, candidates, indices);
+
+                clusters[tile].count = static_cast<uint32>(indices.size() - clusters[tile].offset);
+            }
+        }
+
+        void testCluster(size_type cluster, const slice_candidates& candidates, std::vector<uint32>& indices) const
+        {
+            const size_type count = candidates.index.size();
+            size_type i = 0;
+
+#if defined(LEGION_SSE)
+            const __m128 minX = _mm_set1_ps(m_minX[cluster]);
+            const __m128 minY = _mm_set1_ps(m_minY[cluster]);
+            const __m128 minZ = _mm_set1_ps(m_minZ[cluster]);
+            const __m128 maxX = _mm_set1_ps(m_maxX[cluster]);
+            const __m128 maxY = _mm_set1_ps(m_maxY[cluster]);
+            const __m128 maxZ = _mm_set1_ps(m_maxZ[cluster]);
+            const __m128 zero = _mm_setzero_ps();
+
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(candidates.x.data() + i);
+                const __m128 y = _mm_loadu_ps(candidates.y.data() + i);
+                const __m128 w = _mm_loadu_ps(candidates.w.data() + i);
+
+                //distance from the sphere center to the box along each axis, zero when the center is within the slab
+                const __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minX, x), _mm_sub_ps(x, maxX)), zero);
+                const __m128 dy = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minY, y), _mm_sub_ps(y, maxY)), zero);
+                const __m128 dz = _mm_max_ps(_mm_max_ps(_mm_sub_ps(minZ, w), _mm_sub_ps(w, maxZ)), zero);
+                const __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+                const int mask = _mm_movemask_ps(_mm_cmple_ps(distance2, _mm_loadu_ps(candidates.radius2.data() + i)));
+                if (mask == 0)
+                    continue;
+
+                for (size_type lane = 0; lane < 4; lane++)
+                    if (mask & (1 << lane))
+                        indices.push_back(candidates.index[i + lane]);
+            }
+#endif
+            for (; i < count; i++)
+            {
+                const float dx = math::max(math::max(m_minX[cluster] - candidates.x[i], candidates.x[i] - m_maxX[cluster]), 0.f);
+                const float dy = math::max(math::max(m_minY[cluster] - candidates.y[i], candidates.y[i] - m_maxY[cluster]), 0.f);
+                const float dz = math::max(math::max(m_minZ[cluster] - candidates.w[i], candidates.w[i] - m_maxZ[cluster]), 0.f);
+                if (dx * dx + dy * dy + dz * dz <= candidates.radius2[i])
+                    indices.push_back(candidates.index[i]);
+            }
+        }
+    };
+}
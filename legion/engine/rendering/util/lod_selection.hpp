@@ -0,0 +1,91 @@
+#pragma once
+#include <core/core.hpp>
+#include <core/math/frustum.hpp>
+
+#include <cmath>
+#include <limits>
+
+/**
+ * @file lod_selection.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct lod_view
+     * @brief The camera levels of detail are selected for.
+     */
+    struct lod_view
+    {
+        math::vec3 position = math::vec3(0.f);
+        //1 / tan(vertical fov / 2), the factor the projection scales view space heights with
+        float projectionScale = 1.f;
+        math::view_frustum frustum;
+        //objects outside the frustum keep the level they have when set
+        bool cull = false;
+
+        /**@brief Creates the view from the matrices the camera was rendered with, culling with the view frustum.
+         */
+        L_NODISCARD static lod_view from_camera(const math::vec3& position, const math::mat4& view, const math::mat4& proj) noexcept
+        {
+            lod_view result;
+            result.position = position;
+            result.projectionScale = math::abs(proj[1][1]);
+            result.frustum = math::view_frustum::from_view_projection(proj * view);
+            result.cull = true;
+            return result;
+        }
+
+        /**@brief Creates a view from just a position and a vertical fov, without culling.
+         * @param fov Vertical field of view in degrees.
+         */
+        L_NODISCARD static lod_view from_fov(const math::vec3& position, float fov) noexcept
+        {
+            lod_view result;
+            result.position = position;
+            result.projectionScale = 1.f / std::tan(math::deg2rad(fov) * 0.5f);
+            return result;
+        }
+    };
+
+    /**@brief Fraction of the viewport height the bounding sphere covers, 1 when it exactly fills the height.
+     *        This is the projected radius divided by half the viewport height, which is the same as the projected diameter divided by the full height.
+     *        Uses the exact angle the sphere subtends, a camera inside the sphere gets the largest possible size.
+     */
+    L_NODISCARD inline float lod_screen_size(const math::vec3& center, float radius, const lod_view& view) noexcept
+    {
+        const float distance2 = math::length2(center - view.position);
+        const float radius2 = radius * radius;
+        if (distance2 <= radius2)
+            return std::numeric_limits<float>::max();
+
+        return radius * view.projectionScale / std::sqrt(distance2 - radius2);
+    }
+
+    /**@brief Selects a level of detail from the screen-space size of an object, level 0 being the most detailed.
+     *        The levels are spread evenly over the distance at which the object reaches minScreenSize, so at a fixed fov they behave like linear distance thresholds.
+     *        The current level is kept until the size is more than hysteresis levels past either of its boundaries, so objects near a boundary don't flicker between two levels.
+     * @param currentLevel Level the object has now, levels outside of the range are always replaced.
+     * @param levelCount Number of levels the object has.
+     * @param screenSize Size of the object, see lod_screen_size.
+     * @param minScreenSize Size from which on the least detailed level is used.
+     * @param hysteresis Fraction of a level the size needs to pass a boundary by before the level changes.
+     */
+    L_NODISCARD inline int select_lod_level(int currentLevel, int levelCount, float screenSize, float minScreenSize, float hysteresis) noexcept
+    {
+        if (levelCount <= 1)
+            return 0;
+
+        //the level as a continuous value, grows linearly with the distance
+        const float maxCoordinate = static_cast<float>(levelCount);
+        const float coordinate = screenSize > 0.f ? math::min(maxCoordinate * minScreenSize / screenSize, maxCoordinate) : maxCoordinate;
+
+        if (currentLevel >= 0 && currentLevel < levelCount)
+        {
+            const float current = static_cast<float>(currentLevel);
+            if (coordinate >= current - hysteresis && coordinate < current + 1.f + hysteresis)
+                return currentLevel;
+        }
+
+        return math::min(static_cast<int>(coordinate), levelCount - 1);
+    }
+}
@@ -0,0 +1,475 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file occlusion_buffer.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct occluder_mesh
+     * @brief Triangles of a mesh that hides what is behind it, and where it is in the world.
+     */
+    struct occluder_mesh
+    {
+        const math::vec3* vertices = nullptr;
+        size_type vertexCount = 0;
+        const uint* indices = nullptr;
+        size_type indexCount = 0;
+        math::mat4 worldMatrix = math::mat4(1.f);
+    };
+
+    /**@class occlusion_buffer
+     * @brief Low resolution depth buffer that occluders are rasterized into on the CPU, with a hierarchical-Z of it to test bounding boxes against.
+     *        Uses the reversed 0 to 1 depth range of the renderer, 1 is at the near plane, 0 at the far plane and the cleared buffer.
+     *        The rows are split into bands that are rasterized on different jobs, every row is rasterized 8 pixels at a time with AVX and 4 at a time with SSE.
+     */
+    class occlusion_buffer
+    {
+    public:
+        static constexpr size_type items_per_job = 256;
+        static constexpr int rows_per_job = 16;
+        //rows of the depth buffer are padded to a multiple of this, so the simd loads and stores never leave the row
+        static constexpr int row_alignment = 8;
+
+    private:
+        struct screen_triangle
+        {
+            //pixels of which the centers may be covered
+            int minX, minY, maxX, maxY;
+            //edge functions edge.x * x + edge.y * y + edge.z of the 3 edges, not negative inside the triangle
+            math::vec3 edges[3];
+            //depth plane depth.x * x + depth.y * y + depth.z
+            math::vec3 depth;
+            bool valid;
+        };
+
+        math::ivec2 m_size = math::ivec2(0);
+        int m_stride = 0;
+
+        //the first level is the depth buffer itself, every texel of the next levels holds the farthest depth of 2x2 texels of the level before
+        std::vector<std::vector<float>> m_levels;
+        std::vector<math::ivec2> m_levelSizes;
+
+        //first vertex and triangle of every occluder, the vertices of all occluders are transformed to clip space once
+        std::vector<size_type> m_vertexOffsets;
+        std::vector<size_type> m_triangleOffsets;
+        std::vector<math::vec4> m_clipVertices;
+        //every triangle gets 2 slots because clipping it by the near plane can split it in 2
+        std::vector<screen_triangle> m_triangles;
+
+        /**@brief Splits the items of all occluders, numbered after each other by offsets, into ranges of items_per_job items.
+         *        Calls func(occluder, first, end) on the jobs for the part of every range that belongs to an occluder.
+         */
+        template<typename RunJobs, typename Func>
+        static void for_each_range(const std::vector<size_type>& offsets, RunJobs&& runJobs, Func&& func)
+        {
+            const size_type count = offsets.back();
+            runJobs((count + items_per_job - 1) / items_per_job, [&](size_type job)
+                {
+                    const size_type start = job * items_per_job;
+                    const size_type end = math::min(start + items_per_job, count);
+
+                    size_type occluder = static_cast<size_type>(std::upper_bound(offsets.begin(), offsets.end(), start) - offsets.begin()) - 1;
+                    for (size_type first = start; first < end; occluder++)
+                    {
+                        const size_type last = math::min(end, offsets[occluder + 1]);
+                        if (last > first)
+                            func(occluder, first, last);
+                        first = math::max(first, last);
+                    }
+                });
+        }
+
+        /**@brief Sets up the edge functions and depth plane of a triangle with its vertices in pixel coordinates and depth in z.
+         */
+        L_NODISCARD screen_triangle setup_triangle(const math::vec3& v0, const math::vec3& v1, const math::vec3& v2) const noexcept
+        {
+            screen_triangle result;
+            result.valid = false;
+
+            const float minX = math::min(v0.x, math::min(v1.x, v2.x));
+            const float maxX = math::max(v0.x, math::max(v1.x, v2.x));
+            const float minY = math::min(v0.y, math::min(v1.y, v2.y));
+            const float maxY = math::max(v0.y, math::max(v1.y, v2.y));
+
+            //pixels are sampled at their centers, clamped in floats first so vertices far outside of the screen don't overflow the ints
+            const float width = static_cast<float>(m_size.x);
+            const float height = static_cast<float>(m_size.y);
+            result.minX = static_cast<int>(std::ceil(math::clamp(minX - 0.5f, 0.f, width)));
+            result.maxX = static_cast<int>(std::floor(math::clamp(maxX - 0.5f, -1.f, width - 1.f)));
+            result.minY = static_cast<int>(std::ceil(math::clamp(minY - 0.5f, 0.f, height)));
+            result.maxY = static_cast<int>(std::floor(math::clamp(maxY - 0.5f, -1.f, height - 1.f)));
+            if (result.minX > result.maxX || result.minY > result.maxY)
+                return result;
+
+            //the edge opposite of every vertex, which is the weight of that vertex times twice the area
+            const math::vec3* vertices[3] = { &v0, &v1, &v2 };
+            for (int i = 0; i < 3; i++)
+            {
+                const math::vec3& a = *vertices[(i + 1) % 3];
+                const math::vec3& b = *vertices[(i + 2) % 3];
+                result.edges[i] = math::vec3(a.y - b.y, b.x - a.x, a.x * b.y - a.y * b.x);
+            }
+
+            //both windings are rasterized, single sided walls and floors can be occluders too
+            float area = result.edges[2].x * v2.x + result.edges[2].y * v2.y + result.edges[2].z;
+            if (math::abs(area) < 1e-6f)
+                return result;
+
+            if (area < 0.f)
+            {
+                area = -area;
+                for (auto& edge : result.edges)
+                    edge = -edge;
+            }
+
+            result.depth = (result.edges[0] * v0.z + result.edges[1] * v1.z + result.edges[2] * v2.z) / area;
+            result.valid = true;
+            return result;
+        }
+
+        /**@brief Clips a triangle in clip space by the near plane and sets up the 1 or 2 triangles that are left in the 2 slots.
+         */
+        void setup_clipped_triangle(const math::vec4& c0, const math::vec4& c1, const math::vec4& c2, screen_triangle* slots) const noexcept
+        {
+            slots[0].valid = false;
+            slots[1].valid = false;
+
+            //triangles that are completely outside of one of the side planes are skipped before they are clipped and projected
+            for (int axis = 0; axis < 2; axis++)
+            {
+                if ((c0[axis] > c0.w && c1[axis] > c1.w && c2[axis] > c2.w) || (c0[axis] < -c0.w && c1[axis] < -c1.w && c2[axis] < -c2.w))
+                    return;
+            }
+
+            //with reversed depth the near plane is at z == w, everything behind the camera is in front of it as well
+            const math::vec4 clip[3] = { c0, c1, c2 };
+            float distances[3];
+            int insideCount = 0;
+            for (int i = 0; i < 3; i++)
+            {
+                distances[i] = clip[i].w - clip[i].z;
+                if (distances[i] >= 0.f)
+                    insideCount++;
+            }
+
+            if (insideCount == 0)
+                return;
+
+            math::vec4 polygon[4];
+            int polygonSize = 0;
+            if (insideCount == 3)
+            {
+                polygon[0] = c0;
+                polygon[1] = c1;
+                polygon[2] = c2;
+                polygonSize = 3;
+            }
+            else
+            {
+                for (int i = 0; i < 3; i++)
+                {
+                    const int next = (i + 1) % 3;
+                    if (distances[i] >= 0.f)
+                        polygon[polygonSize++] = clip[i];
+                    if ((distances[i] >= 0.f) != (distances[next] >= 0.f))
+                        polygon[polygonSize++] = math::mix(clip[i], clip[next], distances[i] / (distances[i] - distances[next]));
+                }
+            }
+
+            math::vec3 screen[4];
+            for (int i = 0; i < polygonSize; i++)
+            {
+                const float w = polygon[i].w;
+                if (w <= 1e-6f)
+                    return;
+
+                screen[i] = math::vec3((polygon[i].x / w * 0.5f + 0.5f) * static_cast<float>(m_size.x),
+                    (polygon[i].y / w * 0.5f + 0.5f) * static_cast<float>(m_size.y), polygon[i].z / w);
+            }
+
+            slots[0] = setup_triangle(screen[0], screen[1], screen[2]);
+            if (polygonSize == 4)
+                slots[1] = setup_triangle(screen[0], screen[2], screen[3]);
+        }
+
+        /**@brief Rasterizes the part of a triangle that lies in the rows [firstRow, endRow).
+         */
+        void rasterize_triangle(const screen_triangle& triangle, int firstRow, int endRow) noexcept
+        {
+            const int firstY = math::max(triangle.minY, firstRow);
+            const int lastY = math::min(triangle.maxY, endRow - 1);
+
+            //starts at an aligned pixel, the pixels before the triangle fail the edge tests
+            const int firstX = triangle.minX - triangle.minX % row_alignment;
+            const math::vec3* edges = triangle.edges;
+            const math::vec3& depth = triangle.depth;
+
+            for (int y = firstY; y <= lastY; y++)
+            {
+                float* row = m_levels[0].data() + static_cast<size_type>(y) * static_cast<size_type>(m_stride);
+                const float centerY = static_cast<float>(y) + 0.5f;
+                const float rowEdges[3] = { edges[0].y * centerY + edges[0].z, edges[1].y * centerY + edges[1].z, edges[2].y * centerY + edges[2].z };
+                const float rowDepth = depth.y * centerY + depth.z;
+
+                int x = firstX;
+#if defined(LEGION_AVX)
+                const __m256 laneOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+                for (; x <= triangle.maxX; x += 8)
+                {
+                    const __m256 centerX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), laneOffsets);
+                    const __m256 weight0 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[0].x), centerX), _mm256_set1_ps(rowEdges[0]));
+                    const __m256 weight1 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[1].x), centerX), _mm256_set1_ps(rowEdges[1]));
+                    const __m256 weight2 = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(edges[2].x), centerX), _mm256_set1_ps(rowEdges[2]));
+                    const __m256 inside = _mm256_cmp_ps(_mm256_min_ps(weight0, _mm256_min_ps(weight1, weight2)), _mm256_setzero_ps(), _CMP_GE_OQ);
+
+                    const __m256 pixelDepth = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(depth.x), centerX), _mm256_set1_ps(rowDepth));
+                    const __m256 previous = _mm256_loadu_ps(row + x);
+                    _mm256_storeu_ps(row + x, _mm256_blendv_ps(previous, _mm256_max_ps(previous, pixelDepth), inside));
+                }
+#elif defined(LEGION_SSE)
+                const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+                for (; x <= triangle.maxX; x += 4)
+                {
+                    const __m128 centerX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                    const __m128 weight0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[0].x), centerX), _mm_set1_ps(rowEdges[0]));
+                    const __m128 weight1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[1].x), centerX), _mm_set1_ps(rowEdges[1]));
+                    const __m128 weight2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(edges[2].x), centerX), _mm_set1_ps(rowEdges[2]));
+                    const __m128 inside = _mm_cmpge_ps(_mm_min_ps(weight0, _mm_min_ps(weight1, weight2)), _mm_setzero_ps());
+
+                    //SSE2 has no blend, the mask selects between the old and new depth
+                    const __m128 pixelDepth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(depth.x), centerX), _mm_set1_ps(rowDepth));
+                    const __m128 previous = _mm_loadu_ps(row + x);
+                    const __m128 closest = _mm_max_ps(previous, pixelDepth);
+                    _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, closest), _mm_andnot_ps(inside, previous)));
+                }
+#endif
+
+                for (; x <= triangle.maxX; x++)
+                {
+                    const float centerX = static_cast<float>(x) + 0.5f;
+                    const float weight0 = edges[0].x * centerX + rowEdges[0];
+                    const float weight1 = edges[1].x * centerX + rowEdges[1];
+                    const float weight2 = edges[2].x * centerX + rowEdges[2];
+                    if (math::min(weight0, math::min(weight1, weight2)) >= 0.f)
+                        row[x] = math::max(row[x], depth.x * centerX + rowDepth);
+                }
+            }
+        }
+
+        /**@brief Builds the levels of the hierarchical-Z from the depth buffer.
+         */
+        void build_hierarchy() noexcept
+        {
+            OPTICK_EVENT();
+            for (size_type level = 1; level < m_levels.size(); level++)
+            {
+                const std::vector<float>& source = m_levels[level - 1];
+                const math::ivec2 sourceSize = m_levelSizes[level - 1];
+                const size_type sourceStride = level == 1 ? static_cast<size_type>(m_stride) : static_cast<size_type>(sourceSize.x);
+                const math::ivec2 size = m_levelSizes[level];
+                std::vector<float>& target = m_levels[level];
+
+                for (int y = 0; y < size.y; y++)
+                {
+                    //levels with an odd size take the last row or column of the level before twice
+                    const size_type row0 = static_cast<size_type>(y * 2) * sourceStride;
+                    const size_type row1 = static_cast<size_type>(math::min(y * 2 + 1, sourceSize.y - 1)) * sourceStride;
+                    for (int x = 0; x < size.x; x++)
+                    {
+                        const size_type x0 = static_cast<size_type>(x * 2);
+                        const size_type x1 = static_cast<size_type>(math::min(x * 2 + 1, sourceSize.x - 1));
+                        target[static_cast<size_type>(y) * static_cast<size_type>(size.x) + static_cast<size_type>(x)] =
+                            math::min(math::min(source[row0 + x0], source[row0 + x1]), math::min(source[row1 + x0], source[row1 + x1]));
+                    }
+                }
+            }
+        }
+
+    public:
+        occlusion_buffer() = default;
+        explicit occlusion_buffer(const math::ivec2& size) { resize(size); }
+
+        /**@brief Changes the resolution of the buffer and clears it.
+         */
+        void resize(const math::ivec2& size)
+        {
+            m_size = math::max(size, math::ivec2(1));
+            m_stride = (m_size.x + row_alignment - 1) / row_alignment * row_alignment;
+
+            m_levelSizes.clear();
+            m_levelSizes.push_back(m_size);
+            while (m_levelSizes.back().x > 1 || m_levelSizes.back().y > 1)
+                m_levelSizes.push_back((m_levelSizes.back() + 1) / 2);
+
+            m_levels.resize(m_levelSizes.size());
+            m_levels[0].assign(static_cast<size_type>(m_stride) * static_cast<size_type>(m_size.y), 0.f);
+            for (size_type level = 1; level < m_levels.size(); level++)
+                m_levels[level].assign(static_cast<size_type>(m_levelSizes[level].x) * static_cast<size_type>(m_levelSizes[level].y), 0.f);
+        }
+
+        /**@brief Clears the buffer to the far plane, so nothing is occluded.
+         */
+        void clear() noexcept
+        {
+            for (auto& level : m_levels)
+                std::fill(level.begin(), level.end(), 0.f);
+        }
+
+        L_NODISCARD const math::ivec2& size() const noexcept { return m_size; }
+        L_NODISCARD size_type level_count() const noexcept { return m_levels.size(); }
+        L_NODISCARD math::ivec2 level_size(size_type level) const noexcept { return m_levelSizes[level]; }
+
+        /**@brief Depth of a texel of a level of the hierarchical-Z, level 0 is the depth of the pixel at the center of the pixel.
+         */
+        L_NODISCARD float depth(size_type level, int x, int y) const noexcept
+        {
+            const size_type stride = level == 0 ? static_cast<size_type>(m_stride) : static_cast<size_type>(m_levelSizes[level].x);
+            return m_levels[level][static_cast<size_type>(y) * stride + static_cast<size_type>(x)];
+        }
+
+        /**@brief Clears the buffer, rasterizes the occluders into it and builds the hierarchical-Z.
+         * @param viewProjection Projection times view matrix of the camera, with reversed depth.
+         * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+         */
+        template<typename RunJobs>
+        void rasterize(const math::mat4& viewProjection, const occluder_mesh* occluders, size_type occluderCount, RunJobs&& runJobs)
+        {
+            OPTICK_EVENT();
+            if (m_levels.empty())
+                return;
+
+            std::fill(m_levels[0].begin(), m_levels[0].end(), 0.f);
+
+            m_vertexOffsets.resize(occluderCount + 1);
+            m_triangleOffsets.resize(occluderCount + 1);
+            m_vertexOffsets[0] = 0;
+            m_triangleOffsets[0] = 0;
+            for (size_type i = 0; i < occluderCount; i++)
+            {
+                const bool hasMesh = occluders[i].vertices && occluders[i].indices;
+                m_vertexOffsets[i + 1] = m_vertexOffsets[i] + (hasMesh ? occluders[i].vertexCount : 0);
+                m_triangleOffsets[i + 1] = m_triangleOffsets[i] + (hasMesh ? occluders[i].indexCount / 3 : 0);
+            }
+
+            m_clipVertices.resize(m_vertexOffsets.back());
+            m_triangles.resize(m_triangleOffsets.back() * 2);
+
+            {
+                OPTICK_EVENT("Transform vertices");
+                for_each_range(m_vertexOffsets, runJobs, [&](size_type occluder, size_type first, size_type end)
+                    {
+                        const occluder_mesh& mesh = occluders[occluder];
+                        const math::mat4 worldViewProjection = viewProjection * mesh.worldMatrix;
+                        for (size_type i = first; i < end; i++)
+                            m_clipVertices[i] = worldViewProjection * math::vec4(mesh.vertices[i - m_vertexOffsets[occluder]], 1.f);
+                    });
+            }
+
+            {
+                OPTICK_EVENT("Setup triangles");
+                for_each_range(m_triangleOffsets, runJobs, [&](size_type occluder, size_type first, size_type end)
+                    {
+                        const math::vec4* vertices = m_clipVertices.data() + m_vertexOffsets[occluder];
+                        const uint* indices = occluders[occluder].indices;
+                        for (size_type triangle = first; triangle < end; triangle++)
+                        {
+                            const uint* triangleIndices = indices + (triangle - m_triangleOffsets[occluder]) * 3;
+                            setup_clipped_triangle(vertices[triangleIndices[0]], vertices[triangleIndices[1]], vertices[triangleIndices[2]], m_triangles.data() + triangle * 2);
+                        }
+                    });
+            }
+
+            {
+                OPTICK_EVENT("Rasterize bands");
+                //every band of rows is only written by its own job, so the jobs don't need to synchronize
+                runJobs(static_cast<size_type>((m_size.y + rows_per_job - 1) / rows_per_job), [&](size_type job)
+                    {
+                        const int firstRow = static_cast<int>(job) * rows_per_job;
+                        const int endRow = math::min(firstRow + rows_per_job, m_size.y);
+                        for (auto& triangle : m_triangles)
+                            if (triangle.valid && triangle.minY < endRow && triangle.maxY >= firstRow)
+                                rasterize_triangle(triangle, firstRow, endRow);
+                    });
+            }
+
+            build_hierarchy();
+        }
+
+        /**@brief Rasterizes the occluders on the calling thread.
+         */
+        void rasterize(const math::mat4& viewProjection, const occluder_mesh* occluders, size_type occluderCount)
+        {
+            rasterize(viewProjection, occluders, occluderCount, [](size_type jobCount, auto&& func)
+                {
+                    for (size_type i = 0; i < jobCount; i++)
+                        func(i);
+                });
+        }
+
+        /**@brief Checks if any part of a box could be in front of the occluders, boxes that are not completely behind them are visible.
+         *        The rectangle the box covers on the screen grows by a pixel on every side, so boxes that peek out between the pixel centers the occluders
+         *        were sampled at stay visible.
+         * @param worldViewProjection Matrix that transforms the box to clip space, with reversed depth.
+         * @param min Minimum corner of the box.
+         * @param max Maximum corner of the box.
+         */
+        L_NODISCARD bool is_visible(const math::mat4& worldViewProjection, const math::vec3& min, const math::vec3& max) const noexcept
+        {
+            if (m_levels.empty())
+                return true;
+
+            math::vec2 screenMin(std::numeric_limits<float>::max());
+            math::vec2 screenMax(-std::numeric_limits<float>::max());
+            float nearest = 0.f;
+
+            //the corners are the center plus or minus the half extents along every axis, which only needs 1 full transform
+            const math::vec3 halfSize = (max - min) * 0.5f;
+            const math::vec4 center = worldViewProjection * math::vec4(min + halfSize, 1.f);
+            const math::vec4 axes[3] = { worldViewProjection[0] * halfSize.x, worldViewProjection[1] * halfSize.y, worldViewProjection[2] * halfSize.z };
+
+            for (int corner = 0; corner < 8; corner++)
+            {
+                const math::vec4 clip = center + (corner & 1 ? axes[0] : -axes[0]) + (corner & 2 ? axes[1] : -axes[1]) + (corner & 4 ? axes[2] : -axes[2]);
+
+                //boxes that cross the near plane are too close to test
+                if (clip.w - clip.z < 0.f || clip.w <= 1e-6f)
+                    return true;
+
+                const math::vec2 screen = (math::vec2(clip) / clip.w * 0.5f + 0.5f) * math::vec2(m_size);
+                screenMin = math::min(screenMin, screen);
+                screenMax = math::max(screenMax, screen);
+                nearest = math::max(nearest, clip.z / clip.w);
+            }
+
+            //the far plane of the buffer hides nothing, and boxes outside of the screen are left to frustum culling
+            if (nearest <= 0.f || screenMax.x < 0.f || screenMax.y < 0.f || screenMin.x > static_cast<float>(m_size.x) || screenMin.y > static_cast<float>(m_size.y))
+                return true;
+
+            const math::ivec2 first = math::clamp(math::ivec2(math::floor(screenMin)) - 1, math::ivec2(0), m_size - 1);
+            const math::ivec2 last = math::clamp(math::ivec2(math::floor(screenMax)) + 1, math::ivec2(0), m_size - 1);
+
+            //the smallest level in which the rectangle covers at most 4x4 texels
+            size_type level = 0;
+            while (level + 1 < m_levels.size() && ((last.x >> level) - (first.x >> level) >= 4 || (last.y >> level) - (first.y >> level) >= 4))
+                level++;
+
+            for (int y = first.y >> level; y <= last.y >> level; y++)
+                for (int x = first.x >> level; x <= last.x >> level; x++)
+                    if (depth(level, x, y) <= nearest)
+                        return true;
+
+            return false;
+        }
+    };
+}
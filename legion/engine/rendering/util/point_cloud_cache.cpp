@@ -0,0 +1,141 @@
+#include <rendering/util/point_cloud_cache.hpp>
+#include <rendering/shadercompiler/shader_source_hash.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+namespace legion::rendering
+{
+    std::string PointCloudCache::m_cachePath = "pointcloudcache";
+
+    namespace
+    {
+        constexpr uint32 cache_magic = 0x4350474c; // "LGPC"
+        constexpr uint32 cache_version = 1;
+
+        struct cache_header
+        {
+            uint32 magic;
+            uint32 version;
+            uint64 sampleCount;
+        };
+
+        template<typename T>
+        void hashVector(shader_source_hasher& hasher, const std::vector<T>& values)
+        {
+            hasher.add(static_cast<uint64>(values.size()));
+            hasher.add(values.data(), values.size() * sizeof(T));
+        }
+
+        void hashImage(shader_source_hasher& hasher, const image& img)
+        {
+            hasher.add(static_cast<uint64>(static_cast<uint32>(img.size.x)) | (static_cast<uint64>(static_cast<uint32>(img.size.y)) << 32));
+            hasher.add(static_cast<uint64>(img.format));
+            hasher.add(static_cast<uint64>(img.components));
+            hasher.add(static_cast<uint64>(img.data ? img.dataSize : 0));
+            if (img.data)
+                hasher.add(img.data, img.dataSize);
+        }
+    }
+
+    uint64 PointCloudCache::key(const std::vector<math::vec3>& vertices, const std::vector<uint>& indices, const std::vector<math::vec2>& uvs, const image& albedo, const image& height, const point_cloud_sample_settings& settings)
+    {
+        OPTICK_EVENT();
+        shader_source_hasher hasher;
+        hasher.add(static_cast<uint64>(cache_version));
+        hashVector(hasher, vertices);
+        hashVector(hasher, indices);
+        hashVector(hasher, uvs);
+        hashImage(hasher, albedo);
+        hashImage(hasher, height);
+        hasher.add(static_cast<uint64>(settings.samplesPerTriangle));
+        hasher.add(&settings.heightStrength, sizeof(settings.heightStrength));
+        hasher.add(static_cast<uint64>(settings.textureSize));
+        return hasher.value();
+    }
+
+    bool PointCloudCache::load(uint64 key, point_cloud_samples& output)
+    {
+        OPTICK_EVENT();
+        output.clear();
+        if (m_cachePath.empty())
+            return false;
+
+        std::ifstream stream(cacheFile(key), std::ios::binary);
+        if (!stream.is_open())
+            return false;
+
+        cache_header header;
+        if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)) || header.magic != cache_magic || header.version != cache_version)
+            return false;
+
+        //a truncated file fails the reads, the size is checked against the file first so a corrupt count can't cause a huge allocation
+        const std::streamoff dataStart = stream.tellg();
+        stream.seekg(0, std::ios::end);
+        const uint64 dataSize = static_cast<uint64>(stream.tellg() - dataStart);
+        if (dataSize != header.sampleCount * sizeof(math::vec4) * 2)
+            return false;
+        stream.seekg(dataStart);
+
+        output.points.resize(header.sampleCount);
+        output.colors.resize(header.sampleCount);
+        const std::streamsize size = static_cast<std::streamsize>(header.sampleCount * sizeof(math::vec4));
+        if (!stream.read(reinterpret_cast<char*>(output.points.data()), size) || !stream.read(reinterpret_cast<char*>(output.colors.data()), size))
+        {
+            output.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+    void PointCloudCache::store(uint64 key, const point_cloud_samples& samples)
+    {
+        OPTICK_EVENT();
+        if (m_cachePath.empty())
+            return;
+
+        std::error_code error;
+        std::filesystem::create_directories(m_cachePath, error);
+
+        //written under a name of its own first so other threads and processes never read a half written file
+        const std::string path = cacheFile(key);
+        std::ostringstream tempPath;
+        tempPath << path << '.' << std::hash<std::thread::id>{}(std::this_thread::get_id()) << ".tmp";
+
+        {
+            std::ofstream stream(tempPath.str(), std::ios::binary | std::ios::trunc);
+            if (!stream.is_open())
+                return;
+
+            const cache_header header{ cache_magic, cache_version, static_cast<uint64>(samples.points.size()) };
+            stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            stream.write(reinterpret_cast<const char*>(samples.points.data()), static_cast<std::streamsize>(samples.points.size() * sizeof(math::vec4)));
+            stream.write(reinterpret_cast<const char*>(samples.colors.data()), static_cast<std::streamsize>(samples.colors.size() * sizeof(math::vec4)));
+        }
+
+        std::filesystem::rename(tempPath.str(), path, error);
+        if (error)
+            std::filesystem::remove(tempPath.str(), error);
+    }
+
+    void PointCloudCache::setCachePath(const std::string& path)
+    {
+        m_cachePath = path;
+    }
+
+    const std::string& PointCloudCache::getCachePath()
+    {
+        return m_cachePath;
+    }
+
+    std::string PointCloudCache::cacheFile(uint64 key)
+    {
+        std::ostringstream name;
+        name << m_cachePath << '/' << std::hex << std::setw(16) << std::setfill('0') << key << ".pccache";
+        return name.str();
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <core/core.hpp>
+#include <core/data/image.hpp>
+#include <rendering/util/point_cloud_sampler.hpp>
+
+#include <string>
+#include <vector>
+
+/**
+ * @file point_cloud_cache.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@class PointCloudCache
+     * @brief Stores generated point clouds on disk, so a point cloud is only sampled again when its mesh, textures or settings change.
+     */
+    class PointCloudCache
+    {
+    public:
+        /**@brief Hashes everything the samples of a point cloud depend on: the mesh, the raw data of both textures and the settings.
+         *        The hash is the same on every platform and run, the samples are in mesh space so the placement of the cloud doesn't matter.
+         */
+        L_NODISCARD static uint64 key(const std::vector<math::vec3>& vertices, const std::vector<uint>& indices, const std::vector<math::vec2>& uvs, const image& albedo, const image& height, const point_cloud_sample_settings& settings);
+
+        /**@brief Loads the samples stored under a key.
+         * @return False if the cache is disabled or doesn't hold valid samples for the key, the output is left empty in that case.
+         */
+        static bool load(uint64 key, point_cloud_samples& output);
+
+        /**@brief Stores samples under a key, replaces whatever was stored under it before.
+         */
+        static void store(uint64 key, const point_cloud_samples& samples);
+
+        /**@brief Sets the directory point clouds are cached in, an empty path disables the cache.
+         */
+        static void setCachePath(const std::string& path);
+        L_NODISCARD static const std::string& getCachePath();
+
+    private:
+        static std::string m_cachePath;
+
+        static std::string cacheFile(uint64 key);
+    };
+}
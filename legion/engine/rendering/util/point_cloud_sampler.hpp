@@ -0,0 +1,227 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#if defined(LEGION_SSE)
+#include <immintrin.h>
+#endif
+
+/**
+ * @file point_cloud_sampler.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct point_cloud_texture
+     * @brief Colors of a texture the point cloud sampler reads, row by row.
+     */
+    struct point_cloud_texture
+    {
+        const math::color* colors = nullptr;
+        math::ivec2 size = math::ivec2(0);
+
+        /**@brief Nearest texel, coordinates outside of the texture are clamped to the edge like the sampler of the point cloud kernel.
+         */
+        L_NODISCARD math::color fetch(int x, int y) const noexcept
+        {
+            if (!colors || size.x <= 0 || size.y <= 0)
+                return math::color(0.f, 0.f, 0.f, 0.f);
+
+            x = std::clamp(x, 0, size.x - 1);
+            y = std::clamp(y, 0, size.y - 1);
+            return colors[static_cast<size_type>(y) * static_cast<size_type>(size.x) + static_cast<size_type>(x)];
+        }
+    };
+
+    /**@struct point_cloud_sample_settings
+     * @brief Everything besides the mesh and textures that the generated points depend on.
+     */
+    struct point_cloud_sample_settings
+    {
+        //density of the samples, a triangle gets this many samples per unit of its circumference
+        uint samplesPerTriangle;
+        //distance points are moved along the normal of their triangle for a height of 1
+        float heightStrength;
+        //uvs are scaled by this to get texel coordinates in both textures
+        uint textureSize;
+    };
+
+    /**@struct point_cloud_samples
+     * @brief Generated points in mesh space and their colors, ordered by triangle.
+     */
+    struct point_cloud_samples
+    {
+        std::vector<math::vec4> points;
+        std::vector<math::vec4> colors;
+
+        void clear() noexcept
+        {
+            points.clear();
+            colors.clear();
+        }
+    };
+
+    /**@brief Amount of samples a triangle gets, larger triangles get more samples.
+     */
+    L_NODISCARD inline uint point_cloud_triangle_samples(const math::vec3& a, const math::vec3& b, const math::vec3& c, uint samplesPerTriangle) noexcept
+    {
+        const float size = math::length(c - a) + math::length(b - a) + math::length(c - b);
+        return static_cast<uint>(std::ceil(size * static_cast<float>(samplesPerTriangle)));
+    }
+
+    /**@brief Width of the triangular grid of barycentric coordinates that holds at least sampleCount samples.
+     */
+    L_NODISCARD inline uint point_cloud_sample_width(uint sampleCount) noexcept
+    {
+        //smallest width for which width * (width + 1) / 2 >= sampleCount
+        uint width = static_cast<uint>(std::sqrt(2.0 * static_cast<double>(sampleCount)));
+        while (width > 0 && static_cast<uint64>(width) * (width - 1) / 2 >= sampleCount)
+            width--;
+        while (static_cast<uint64>(width) * (width + 1) / 2 < sampleCount)
+            width++;
+        return width;
+    }
+
+    /**@brief Samples points on the triangles of a mesh, displaced along the triangle normal by a height map and colored by an albedo map.
+     *        Gives the same points as the pointRasterizer and calculatePoints kernels so it can stand in for them when there is no OpenCL device.
+     *        The barycentric coordinates of a triangle are taken in order from a uniform triangular grid, positions and texel coordinates are calculated 4 samples at a time.
+     * @param runJobs Function with the signature void(size_type jobCount, func) that calls func(jobIndex) for every job and waits for them to finish.
+     */
+    template<typename RunJobs>
+    void sample_point_cloud(const std::vector<math::vec3>& vertices, const std::vector<uint>& indices, const std::vector<math::vec2>& uvs,
+        const point_cloud_texture& albedo, const point_cloud_texture& height, const point_cloud_sample_settings& settings, point_cloud_samples& output, RunJobs&& runJobs)
+    {
+        OPTICK_EVENT();
+        constexpr size_type triangles_per_job = 256;
+
+        output.clear();
+        const size_type triangleCount = indices.size() / 3;
+        if (triangleCount == 0)
+            return;
+
+        const size_type jobCount = (triangleCount + triangles_per_job - 1) / triangles_per_job;
+
+        //first pass counts the samples so every triangle knows where its samples go
+        std::vector<size_type> offsets(triangleCount + 1);
+        runJobs(jobCount, [&](size_type job)
+            {
+                const size_type end = std::min(triangleCount, (job + 1) * triangles_per_job);
+                for (size_type i = job * triangles_per_job; i < end; i++)
+                    offsets[i + 1] = point_cloud_triangle_samples(vertices[indices[i * 3]], vertices[indices[i * 3 + 1]], vertices[indices[i * 3 + 2]], settings.samplesPerTriangle);
+            });
+
+        for (size_type i = 0; i < triangleCount; i++)
+            offsets[i + 1] += offsets[i];
+
+        const size_type sampleCount = offsets[triangleCount];
+        output.points.resize(sampleCount);
+        output.colors.resize(sampleCount);
+
+        const float texelScale = static_cast<float>(settings.textureSize);
+
+        runJobs(jobCount, [&](size_type job)
+            {
+                //barycentric coordinates, and the positions and texel coordinates of the current triangle in structure of arrays form
+                std::vector<float> coordU;
+                std::vector<float> coordV;
+                std::vector<float> positions[3];
+                std::vector<int> texels[2];
+
+                const size_type end = std::min(triangleCount, (job + 1) * triangles_per_job);
+                for (size_type triangle = job * triangles_per_job; triangle < end; triangle++)
+                {
+                    const size_type first = offsets[triangle];
+                    const size_type count = offsets[triangle + 1] - first;
+                    if (count == 0)
+                        continue;
+
+                    const uint ia = indices[triangle * 3];
+                    const uint ib = indices[triangle * 3 + 1];
+                    const uint ic = indices[triangle * 3 + 2];
+
+                    const math::vec3 a = vertices[ia];
+                    const math::vec3 ab = vertices[ib] - a;
+                    const math::vec3 ac = vertices[ic] - a;
+                    const math::vec2 uvA = uvs[ia];
+                    const math::vec2 uvAB = uvs[ib] - uvA;
+                    const math::vec2 uvAC = uvs[ic] - uvA;
+
+                    const uint width = point_cloud_sample_width(static_cast<uint>(count));
+                    const float step = 1.f / static_cast<float>(width + 1);
+
+                    coordU.resize(count);
+                    coordV.resize(count);
+                    for (auto& axis : positions)
+                        axis.resize(count);
+                    for (auto& axis : texels)
+                        axis.resize(count);
+
+                    size_type index = 0;
+                    for (uint x = 0; x < width && index < count; x++)
+                        for (uint y = 0; y < width - x && index < count; y++, index++)
+                        {
+                            coordU[index] = step * static_cast<float>(x);
+                            coordV[index] = step * static_cast<float>(y);
+                        }
+
+                    size_type i = 0;
+#if defined(LEGION_SSE)
+                    const __m128 scale = _mm_set1_ps(texelScale);
+                    for (; i + 4 <= count; i += 4)
+                    {
+                        const __m128 u = _mm_loadu_ps(coordU.data() + i);
+                        const __m128 v = _mm_loadu_ps(coordV.data() + i);
+
+                        for (int axis = 0; axis < 3; axis++)
+                        {
+                            __m128 position = _mm_add_ps(_mm_set1_ps(a[axis]), _mm_mul_ps(u, _mm_set1_ps(ab[axis])));
+                            position = _mm_add_ps(position, _mm_mul_ps(v, _mm_set1_ps(ac[axis])));
+                            _mm_storeu_ps(positions[axis].data() + i, position);
+                        }
+
+                        for (int axis = 0; axis < 2; axis++)
+                        {
+                            __m128 uv = _mm_add_ps(_mm_set1_ps(uvA[axis]), _mm_mul_ps(u, _mm_set1_ps(uvAB[axis])));
+                            uv = _mm_add_ps(uv, _mm_mul_ps(v, _mm_set1_ps(uvAC[axis])));
+                            //truncates towards zero like the conversion in the kernel
+                            _mm_storeu_si128(reinterpret_cast<__m128i*>(texels[axis].data() + i), _mm_cvttps_epi32(_mm_mul_ps(uv, scale)));
+                        }
+                    }
+#endif
+
+                    for (; i < count; i++)
+                    {
+                        for (int axis = 0; axis < 3; axis++)
+                            positions[axis][i] = (a[axis] + coordU[i] * ab[axis]) + coordV[i] * ac[axis];
+
+                        for (int axis = 0; axis < 2; axis++)
+                            texels[axis][i] = static_cast<int>(((uvA[axis] + coordU[i] * uvAB[axis]) + coordV[i] * uvAC[axis]) * texelScale);
+                    }
+
+                    //the texture fetches are scattered, so they stay scalar
+                    const math::vec3 normal = math::normalize(math::cross(ab, ac)) * settings.heightStrength;
+                    for (i = 0; i < count; i++)
+                    {
+                        const float offset = height.fetch(texels[0][i], texels[1][i]).r;
+                        output.points[first + i] = math::vec4(positions[0][i] + normal.x * offset, positions[1][i] + normal.y * offset, positions[2][i] + normal.z * offset, 1.f);
+                        output.colors[first + i] = albedo.fetch(texels[0][i], texels[1][i]);
+                    }
+                }
+            });
+    }
+
+    /**@brief Samples the point cloud on the calling thread.
+     */
+    inline void sample_point_cloud(const std::vector<math::vec3>& vertices, const std::vector<uint>& indices, const std::vector<math::vec2>& uvs,
+        const point_cloud_texture& albedo, const point_cloud_texture& height, const point_cloud_sample_settings& settings, point_cloud_samples& output)
+    {
+        sample_point_cloud(vertices, indices, uvs, albedo, height, settings, output, [](size_type jobCount, auto&& func)
+            {
+                for (size_type i = 0; i < jobCount; i++)
+                    func(i);
+            });
+    }
+}
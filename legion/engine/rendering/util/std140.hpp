@@ -0,0 +1,224 @@
+#pragma once
+#include <core/core.hpp>
+
+#include <cstring>
+
+/**
+ * @file std140.hpp
+ */
+
+namespace legion::rendering
+{
+    /**@struct std140_traits
+     * @brief Alignment and size of a type inside a std140 uniform block.
+     *        Vectors of 3 components align like vectors of 4 and matrices are stored as arrays of columns that each align like a vec4.
+     */
+    template<typename T>
+    struct std140_traits;
+
+#if !defined(DOXY_EXCLUDE)
+    template<size_type Alignment, size_type Size, size_type Columns = 1>
+    struct std140_basic_traits
+    {
+        static constexpr size_type alignment = Alignment;
+        static constexpr size_type size = Size;
+        static constexpr size_type columns = Columns;
+    };
+
+    template<> struct std140_traits<float> : std140_basic_traits<4, 4> {};
+    template<> struct std140_traits<int> : std140_basic_traits<4, 4> {};
+    template<> struct std140_traits<uint> : std140_basic_traits<4, 4> {};
+    template<> struct std140_traits<bool> : std140_basic_traits<4, 4> {};
+    template<> struct std140_traits<math::vec2> : std140_basic_traits<8, 8> {};
+    template<> struct std140_traits<math::vec3> : std140_basic_traits<16, 12> {};
+    template<> struct std140_traits<math::vec4> : std140_basic_traits<16, 16> {};
+    template<> struct std140_traits<math::ivec2> : std140_basic_traits<8, 8> {};
+    template<> struct std140_traits<math::ivec3> : std140_basic_traits<16, 12> {};
+    template<> struct std140_traits<math::ivec4> : std140_basic_traits<16, 16> {};
+    template<> struct std140_traits<math::bvec2> : std140_basic_traits<8, 8> {};
+    template<> struct std140_traits<math::bvec3> : std140_basic_traits<16, 12> {};
+    template<> struct std140_traits<math::bvec4> : std140_basic_traits<16, 16> {};
+    template<> struct std140_traits<math::mat2> : std140_basic_traits<16, 32, 2> {};
+    template<> struct std140_traits<math::mat3> : std140_basic_traits<16, 48, 3> {};
+    template<> struct std140_traits<math::mat4> : std140_basic_traits<16, 64, 4> {};
+#endif
+
+    /**@class std140_layout
+     * @brief Calculates the offsets of the members of a std140 uniform block, in declaration order.
+     */
+    class std140_layout
+    {
+    public:
+        /**@brief Appends a member to the block.
+         * @return Offset of the member in bytes.
+         */
+        template<typename T>
+        size_type add()
+        {
+            const size_type offset = align(m_size, std140_traits<T>::alignment);
+            m_size = offset + std140_traits<T>::size;
+            return offset;
+        }
+
+        /**@brief Size of the block, rounded up to the alignment of a vec4 like blocks are in buffers.
+         */
+        L_NODISCARD size_type size() const noexcept { return align(m_size, 16); }
+
+    private:
+        size_type m_size = 0;
+
+        static constexpr size_type align(size_type value, size_type alignment)
+        {
+            return ((value + alignment - 1) / alignment) * alignment;
+        }
+    };
+
+    /**@class std140_block
+     * @brief CPU copy of the contents of a std140 uniform block. Remembers which bytes changed since the last upload,
+     *        so that writing the same value again costs a compare and unchanged blocks don't need to be uploaded at all.
+     * @note Only uses core, the buffer the block gets uploaded to is owned by the user of the block.
+     */
+    class std140_block
+    {
+    public:
+        std140_block() = default;
+        explicit std140_block(size_type size) : m_data(size, 0), m_dirtyBegin(0), m_dirtyEnd(size) {}
+
+        /**@brief Packs a value at an offset.
+         * @return Whether the contents of the block changed.
+         */
+        template<typename T>
+        bool write(size_type offset, const T& value)
+        {
+            constexpr size_type size = std140_traits<T>::size;
+            if (offset + size > m_data.size())
+            {
+                log::error("Write of {} bytes at offset {} is outside of a std140 block of {} bytes.", size, offset, m_data.size());
+                return false;
+            }
+
+            byte packed[size];
+            std::memset(packed, 0, size);
+            pack(value, packed);
+
+            if (std::memcmp(m_data.data() + offset, packed, size) == 0)
+                return false;
+
+            std::memcpy(m_data.data() + offset, packed, size);
+            markDirty(offset, size);
+            return true;
+        }
+
+        /**@brief Unpacks the value at an offset.
+         */
+        template<typename T>
+        L_NODISCARD T read(size_type offset) const
+        {
+            T value{};
+            if (offset + std140_traits<T>::size > m_data.size())
+                return value;
+
+            unpack(m_data.data() + offset, value);
+            return value;
+        }
+
+        /**@brief Whether anything changed since the last call to clear_dirty.
+         */
+        L_NODISCARD bool dirty() const noexcept { return m_dirtyBegin < m_dirtyEnd; }
+
+        /**@brief Start of the range of bytes that changed.
+         */
+        L_NODISCARD size_type dirty_begin() const noexcept { return m_dirtyBegin; }
+
+        /**@brief End of the range of bytes that changed.
+         */
+        L_NODISCARD size_type dirty_end() const noexcept { return m_dirtyEnd; }
+
+        /**@brief Call after uploading the dirty range.
+         */
+        void clear_dirty() noexcept
+        {
+            m_dirtyBegin = m_data.size();
+            m_dirtyEnd = 0;
+        }
+
+        /**@brief Marks the whole block as changed, eg: when the buffer it's uploaded to was recreated.
+         */
+        void mark_all_dirty() noexcept
+        {
+            m_dirtyBegin = 0;
+            m_dirtyEnd = m_data.size();
+        }
+
+        L_NODISCARD const byte* data() const noexcept { return m_data.data(); }
+        L_NODISCARD size_type size() const noexcept { return m_data.size(); }
+
+    private:
+        std::vector<byte> m_data;
+        size_type m_dirtyBegin = 0;
+        size_type m_dirtyEnd = 0;
+
+        void markDirty(size_type offset, size_type size)
+        {
+            m_dirtyBegin = m_dirtyBegin < offset ? m_dirtyBegin : offset;
+            m_dirtyEnd = m_dirtyEnd > offset + size ? m_dirtyEnd : offset + size;
+        }
+
+        //bools are 4 byte integers in blocks, matrices are padded to a vec4 per column
+        template<typename T>
+        static void pack(const T& value, byte* dst)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                const uint32 converted = value ? 1u : 0u;
+                std::memcpy(dst, &converted, sizeof(converted));
+            }
+            else if constexpr (std::is_same_v<T, math::bvec2> || std::is_same_v<T, math::bvec3> || std::is_same_v<T, math::bvec4>)
+            {
+                for (int i = 0; i < T::length(); i++)
+                {
+                    const uint32 converted = value[i] ? 1u : 0u;
+                    std::memcpy(dst + i * sizeof(uint32), &converted, sizeof(converted));
+                }
+            }
+            else if constexpr (std140_traits<T>::columns > 1)
+            {
+                for (int column = 0; column < T::length(); column++)
+                    std::memcpy(dst + column * 16, &value[column], sizeof(value[column]));
+            }
+            else
+            {
+                std::memcpy(dst, &value, sizeof(T));
+            }
+        }
+
+        template<typename T>
+        static void unpack(const byte* src, T& value)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                uint32 converted;
+                std::memcpy(&converted, src, sizeof(converted));
+                value = converted != 0;
+            }
+            else if constexpr (std::is_same_v<T, math::bvec2> || std::is_same_v<T, math::bvec3> || std::is_same_v<T, math::bvec4>)
+            {
+                for (int i = 0; i < T::length(); i++)
+                {
+                    uint32 converted;
+                    std::memcpy(&converted, src + i * sizeof(uint32), sizeof(converted));
+                    value[i] = converted != 0;
+                }
+            }
+            else if constexpr (std140_traits<T>::columns > 1)
+            {
+                for (int column = 0; column < T::length(); column++)
+                    std::memcpy(&value[column], src + column * 16, sizeof(value[column]));
+            }
+            else
+            {
+                std::memcpy(&value, src, sizeof(T));
+            }
+        }
+    };
+}